@@ -0,0 +1,524 @@
+/**
+ * @file ColdStartBenchmark.cpp
+ * @brief Measures launch to first composed poe://home frame, and idle memory.
+ *
+ * Run without --scenario, this executable relaunches itself once per run so
+ * every sample is a cold process, then aggregates the samples into JSON:
+ *
+ *     PoEOverlayColdStart [--runs N] [--output cold_start.json]
+ *                         [--history cold_start_history.jsonl]
+ *                         [--baseline baseline.json] [--tolerance 0.10]
+ *                         [--url poe://home] [--timeout-ms 30000] [--idle-ms 3000]
+ *
+ * In --scenario mode it brings up the overlay the way the app does (through
+ * startup stages), opens one browser view on the URL, and records the
+ * StartupTimeline milestones. Once the first frame is committed it idles
+ * for --idle-ms and samples the working set of itself and every CEF child.
+ * With --baseline, any median more than --tolerance above the baseline's
+ * exits with code 2.
+ */
+
+#include "core/Application.h"
+#include "core/Logger.h"
+#include "core/StartupGraph.h"
+#include "core/StartupTimeline.h"
+#include "browser/BrowserInterface.h"
+#include "browser/BrowserView.h"
+#include "window/overlay_window.h"
+#include "rendering/composite_renderer.h"
+
+#include <Windows.h>
+#include <psapi.h>
+#include <TlHelp32.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#ifndef POEOVERLAY_VERSION
+#define POEOVERLAY_VERSION "unknown"
+#endif
+
+namespace {
+
+constexpr int kSchemaVersion = 1;
+constexpr int kRegressionExitCode = 2;
+
+/**
+ * @brief Command-line options.
+ */
+struct Options {
+    bool scenario = false;                          ///< Run one cold start instead of the harness
+    int runs = 5;                                   ///< Number of cold starts to sample
+    std::filesystem::path output = "cold_start.json"; ///< Results file
+    std::filesystem::path history;                  ///< JSON Lines file to append medians to
+    std::filesystem::path baseline;                 ///< Results file to compare against
+    double tolerance = 0.10;                        ///< Allowed median increase over the baseline
+    std::string url = "poe://home";                 ///< Page to load
+    int timeoutMs = 30000;                          ///< Give up on the first frame after this long
+    int idleMs = 3000;                              ///< Idle time before sampling memory
+};
+
+/**
+ * @brief Memory of one process in the overlay's process tree.
+ */
+struct ProcessMemory {
+    DWORD processId = 0;            ///< Process ID
+    std::string name;               ///< Executable name
+    uint64_t workingSet = 0;        ///< Current working set in bytes
+    uint64_t peakWorkingSet = 0;    ///< Peak working set in bytes
+    uint64_t privateBytes = 0;      ///< Committed private bytes
+};
+
+/**
+ * @brief Parses the command line; unknown arguments are ignored with a warning.
+ */
+Options ParseOptions(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--scenario") {
+            options.scenario = true;
+        }
+        else if (arg == "--runs" && hasValue) {
+            options.runs = (std::max)(std::atoi(argv[++i]), 1);
+        }
+        else if (arg == "--output" && hasValue) {
+            options.output = argv[++i];
+        }
+        else if (arg == "--history" && hasValue) {
+            options.history = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue) {
+            options.baseline = argv[++i];
+        }
+        else if (arg == "--tolerance" && hasValue) {
+            options.tolerance = std::atof(argv[++i]);
+        }
+        else if (arg == "--url" && hasValue) {
+            options.url = argv[++i];
+        }
+        else if (arg == "--timeout-ms" && hasValue) {
+            options.timeoutMs = (std::max)(std::atoi(argv[++i]), 1000);
+        }
+        else if (arg == "--idle-ms" && hasValue) {
+            options.idleMs = (std::max)(std::atoi(argv[++i]), 0);
+        }
+        else {
+            std::fprintf(stderr, "Ignoring unknown argument: %s\n", arg.c_str());
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Samples the memory of a process and all of its descendants.
+ */
+std::vector<ProcessMemory> SampleProcessTree(DWORD rootProcessId)
+{
+    std::vector<ProcessMemory> processes;
+
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        return processes;
+    }
+
+    struct Entry {
+        DWORD processId;
+        DWORD parentId;
+        std::wstring name;
+    };
+    std::vector<Entry> entries;
+
+    PROCESSENTRY32W processEntry = {};
+    processEntry.dwSize = sizeof(processEntry);
+    if (Process32FirstW(snapshot, &processEntry)) {
+        do {
+            entries.push_back({ processEntry.th32ProcessID, processEntry.th32ParentProcessID, processEntry.szExeFile });
+        } while (Process32NextW(snapshot, &processEntry));
+    }
+    CloseHandle(snapshot);
+
+    // Breadth-first from the root: CEF's GPU, renderer and utility processes are its children
+    std::vector<DWORD> tree = { rootProcessId };
+    for (size_t i = 0; i < tree.size(); ++i) {
+        for (const auto& entry : entries) {
+            if (entry.parentId == tree[i] && entry.processId != rootProcessId &&
+                std::find(tree.begin(), tree.end(), entry.processId) == tree.end()) {
+                tree.push_back(entry.processId);
+            }
+        }
+    }
+
+    for (DWORD processId : tree) {
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+        if (!process) {
+            continue;
+        }
+
+        PROCESS_MEMORY_COUNTERS_EX counters = {};
+        counters.cb = sizeof(counters);
+        if (GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+            ProcessMemory memory;
+            memory.processId = processId;
+            memory.workingSet = counters.WorkingSetSize;
+            memory.peakWorkingSet = counters.PeakWorkingSetSize;
+            memory.privateBytes = counters.PrivateUsage;
+
+            auto it = std::find_if(entries.begin(), entries.end(),
+                [processId](const Entry& entry) { return entry.processId == processId; });
+            if (it != entries.end()) {
+                memory.name = std::filesystem::path(it->name).string();
+            }
+            processes.push_back(std::move(memory));
+        }
+        CloseHandle(process);
+    }
+
+    return processes;
+}
+
+/**
+ * @brief Runs one cold start in this process and writes its sample.
+ * @return 0 if the first frame was committed, 1 otherwise.
+ */
+int RunScenario(const Options& options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    poe::Application app("PoEOverlay");
+
+    std::unique_ptr<poe::OverlayWindow> window;
+    std::unique_ptr<poe::BrowserInterface> browser;
+
+    // Same shape as the app: the window and CEF both need the main thread
+    app.AddStartupStage("window", {}, poe::StartupThread::Main, [&]() {
+        poe::OverlayWindow::WindowConfig config;
+        config.title = L"PoEOverlay cold start";
+        config.width = 1280;
+        config.height = 720;
+        config.showOnStartup = true;
+        window = std::make_unique<poe::OverlayWindow>(app, config);
+        return window->Create();
+    });
+    app.AddStartupStage("browser", { "errors" }, poe::StartupThread::Main, [&]() {
+        browser = std::make_unique<poe::BrowserInterface>(app);
+        return browser->Initialize();
+    });
+
+    bool completed = false;
+    nlohmann::json sample;
+
+    if (app.Initialize()) {
+        auto view = browser->CreateBrowserView(1280, 720, options.url);
+        if (view) {
+            poe::OverlayWindow* target = window.get();
+            view->SetPaintCallback([target](const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects) {
+                if (auto* renderer = target->GetRenderer()) {
+                    renderer->UpdateContent(buffer, width, height, dirtyRects);
+                }
+            });
+            view->SetAcceleratedPaintCallback([target](HANDLE sharedHandle) {
+                if (auto* renderer = target->GetRenderer()) {
+                    renderer->UpdateSharedContent(sharedHandle);
+                }
+            });
+            view->SetVisible(true);
+
+            auto pump = [&]() {
+                window->ProcessMessages();
+                browser->Update();
+                window->Update();
+                MsgWaitForMultipleObjectsEx(0, nullptr, 5, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            };
+
+            auto deadline = Clock::now() + std::chrono::milliseconds(options.timeoutMs);
+            while (!poe::StartupTimeline::HasReached(poe::StartupMilestone::FirstCommit) && Clock::now() < deadline) {
+                pump();
+            }
+            completed = poe::StartupTimeline::HasReached(poe::StartupMilestone::FirstCommit);
+
+            // Let the page and its subprocesses settle before reading idle memory
+            auto idleEnd = Clock::now() + std::chrono::milliseconds(options.idleMs);
+            while (Clock::now() < idleEnd) {
+                pump();
+            }
+
+            browser->ReleaseBrowserView(view);
+        }
+    }
+
+    nlohmann::json milestones = nlohmann::json::object();
+    for (size_t i = 0; i < static_cast<size_t>(poe::StartupMilestone::Count); ++i) {
+        auto milestone = static_cast<poe::StartupMilestone>(i);
+        double ms = poe::StartupTimeline::GetMilliseconds(milestone);
+        milestones[poe::StartupTimeline::GetName(milestone)] = ms >= 0.0 ? nlohmann::json(ms) : nlohmann::json();
+    }
+
+    DWORD selfId = GetCurrentProcessId();
+    uint64_t workingSet = 0;
+    uint64_t privateBytes = 0;
+    uint64_t childPeakSum = 0;
+    uint64_t childPeakMax = 0;
+    uint64_t browserPeak = 0;
+    nlohmann::json processes = nlohmann::json::array();
+    for (const auto& memory : SampleProcessTree(selfId)) {
+        workingSet += memory.workingSet;
+        privateBytes += memory.privateBytes;
+        if (memory.processId == selfId) {
+            browserPeak = memory.peakWorkingSet;
+        }
+        else {
+            childPeakSum += memory.peakWorkingSet;
+            childPeakMax = (std::max)(childPeakMax, memory.peakWorkingSet);
+        }
+        processes.push_back({
+            { "pid", memory.processId },
+            { "name", memory.name },
+            { "workingSetBytes", memory.workingSet },
+            { "peakWorkingSetBytes", memory.peakWorkingSet },
+            { "privateBytes", memory.privateBytes }
+        });
+    }
+
+    sample["completed"] = completed;
+    sample["url"] = options.url;
+    sample["milestonesMs"] = milestones;
+    sample["memory"] = {
+        { "idleWorkingSetBytes", workingSet },
+        { "idlePrivateBytes", privateBytes },
+        { "browserPeakWorkingSetBytes", browserPeak },
+        { "subprocessPeakWorkingSetBytes", childPeakSum },
+        { "largestSubprocessPeakWorkingSetBytes", childPeakMax },
+        { "processCount", processes.size() }
+    };
+    sample["processes"] = processes;
+
+    if (browser) {
+        browser->Shutdown();
+    }
+    window.reset();
+    app.Shutdown();
+
+    std::ofstream file(options.output, std::ios::out | std::ios::trunc);
+    file << sample.dump(2) << "\n";
+    return completed ? 0 : 1;
+}
+
+/**
+ * @brief Launches this executable in scenario mode and reads its sample.
+ * @return The sample, or null if the run failed to produce one.
+ */
+nlohmann::json LaunchScenario(const Options& options, const std::filesystem::path& samplePath)
+{
+    wchar_t modulePath[MAX_PATH] = {};
+    GetModuleFileNameW(nullptr, modulePath, MAX_PATH);
+
+    std::wstring commandLine = L"\"" + std::wstring(modulePath) + L"\" --scenario" +
+        L" --output \"" + samplePath.wstring() + L"\"" +
+        L" --url \"" + std::filesystem::path(options.url).wstring() + L"\"" +
+        L" --timeout-ms " + std::to_wstring(options.timeoutMs) +
+        L" --idle-ms " + std::to_wstring(options.idleMs);
+
+    STARTUPINFOW startupInfo = {};
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo = {};
+    if (!CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr,
+                        &startupInfo, &processInfo)) {
+        std::fprintf(stderr, "Failed to launch scenario: error %lu\n", GetLastError());
+        return nullptr;
+    }
+
+    // Generous: startup, idle, and CEF's own shutdown
+    DWORD waitMs = static_cast<DWORD>(options.timeoutMs + options.idleMs + 30000);
+    if (WaitForSingleObject(processInfo.hProcess, waitMs) == WAIT_TIMEOUT) {
+        std::fprintf(stderr, "Scenario did not exit, terminating it\n");
+        TerminateProcess(processInfo.hProcess, 1);
+        WaitForSingleObject(processInfo.hProcess, INFINITE);
+    }
+    CloseHandle(processInfo.hThread);
+    CloseHandle(processInfo.hProcess);
+
+    std::ifstream file(samplePath);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    nlohmann::json sample = nlohmann::json::parse(file, nullptr, false);
+    file.close();
+
+    std::error_code error;
+    std::filesystem::remove(samplePath, error);
+    return sample.is_discarded() ? nlohmann::json() : sample;
+}
+
+/**
+ * @brief Gets the current UTC time in ISO 8601 form.
+ */
+std::string CurrentTimestamp()
+{
+    std::time_t now = std::time(nullptr);
+    std::tm utc = {};
+    gmtime_s(&utc, &now);
+
+    char buffer[32] = {};
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+/**
+ * @brief Runs the scenario repeatedly and aggregates, records and checks the results.
+ * @return 0 on success, 1 if no run completed, kRegressionExitCode on a regression.
+ */
+int RunBenchmark(const Options& options)
+{
+    std::vector<nlohmann::json> samples;
+    std::map<std::string, std::vector<double>> values;
+
+    for (int run = 0; run < options.runs; ++run) {
+        auto samplePath = std::filesystem::absolute(options.output).parent_path() /
+            ("cold_start_run" + std::to_string(run) + ".json");
+
+        nlohmann::json sample = LaunchScenario(options, samplePath);
+        if (sample.is_null()) {
+            std::fprintf(stderr, "Run %d produced no sample\n", run + 1);
+            continue;
+        }
+
+        bool completed = sample.value("completed", false);
+        double firstCommit = completed ? sample["milestonesMs"].value("firstCommit", -1.0) : -1.0;
+        std::printf("Run %d/%d: %s, first commit at %.1f ms\n", run + 1, options.runs,
+            completed ? "completed" : "timed out", firstCommit);
+
+        if (completed) {
+            for (const auto& [name, value] : sample["milestonesMs"].items()) {
+                if (value.is_number()) {
+                    values[name + "Ms"].push_back(value.get<double>());
+                }
+            }
+            for (const auto& [name, value] : sample["memory"].items()) {
+                values[name].push_back(value.get<double>());
+            }
+        }
+        samples.push_back(std::move(sample));
+    }
+
+    nlohmann::json metrics = nlohmann::json::object();
+    for (auto& [name, series] : values) {
+        std::sort(series.begin(), series.end());
+        size_t middle = series.size() / 2;
+        double median = series.size() % 2 ? series[middle] : (series[middle - 1] + series[middle]) / 2.0;
+        metrics[name] = {
+            { "median", median },
+            { "min", series.front() },
+            { "max", series.back() },
+            { "samples", series.size() }
+        };
+    }
+
+    nlohmann::json results = {
+        { "schema", kSchemaVersion },
+        { "benchmark", "coldStart" },
+        { "version", POEOVERLAY_VERSION },
+        { "timestamp", CurrentTimestamp() },
+        { "url", options.url },
+        { "runs", options.runs },
+        { "metrics", metrics },
+        { "samples", samples }
+    };
+
+    std::ofstream output(options.output, std::ios::out | std::ios::trunc);
+    output << results.dump(2) << "\n";
+    output.close();
+
+    for (const auto& [name, metric] : metrics.items()) {
+        std::printf("%-40s median %14.1f  min %14.1f  max %14.1f\n", name.c_str(),
+            metric["median"].get<double>(), metric["min"].get<double>(), metric["max"].get<double>());
+    }
+    std::printf("Results written to %s\n", options.output.string().c_str());
+
+    // One compact line per invocation, for tracking over time
+    if (!options.history.empty()) {
+        nlohmann::json medians = nlohmann::json::object();
+        for (const auto& [name, metric] : metrics.items()) {
+            medians[name] = metric["median"];
+        }
+
+        std::ofstream history(options.history, std::ios::out | std::ios::app);
+        history << nlohmann::json({
+            { "schema", kSchemaVersion },
+            { "benchmark", "coldStart" },
+            { "version", POEOVERLAY_VERSION },
+            { "timestamp", results["timestamp"] },
+            { "medians", medians }
+        }).dump() << "\n";
+    }
+
+    if (metrics.empty()) {
+        std::fprintf(stderr, "No run reached the first commit\n");
+        return 1;
+    }
+
+    if (options.baseline.empty()) {
+        return 0;
+    }
+
+    std::ifstream baselineFile(options.baseline);
+    nlohmann::json baseline = nlohmann::json::parse(baselineFile, nullptr, false);
+    if (baseline.is_discarded() || !baseline.contains("metrics")) {
+        std::fprintf(stderr, "Could not read baseline %s\n", options.baseline.string().c_str());
+        return 1;
+    }
+
+    bool regressed = false;
+    for (const auto& [name, metric] : metrics.items()) {
+        if (!baseline["metrics"].contains(name)) {
+            continue;
+        }
+
+        double previous = baseline["metrics"][name].value("median", 0.0);
+        double current = metric["median"].get<double>();
+        if (previous > 0.0 && current > previous * (1.0 + options.tolerance)) {
+            std::printf("REGRESSION %s: %.1f -> %.1f (+%.1f%%)\n", name.c_str(), previous, current,
+                (current / previous - 1.0) * 100.0);
+            regressed = true;
+        }
+    }
+
+    return regressed ? kRegressionExitCode : 0;
+}
+
+} // namespace
+
+/**
+ * @brief Entry point for the cold-start benchmark.
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit code; see the file comment.
+ */
+int main(int argc, char* argv[])
+{
+    // Match the app: DPI awareness must be set before any window exists
+    SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+
+    Options options = ParseOptions(argc, argv);
+
+    try {
+        return options.scenario ? RunScenario(options) : RunBenchmark(options);
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,703 @@
+/**
+ * @file InputLatencyBenchmark.cpp
+ * @brief Replays an input trace through the overlay and measures input-to-photon latency.
+ *
+ *     PoEOverlayInputLatency [--trace input.jsonl] [--output input_latency.json]
+ *                            [--history input_latency_history.jsonl]
+ *                            [--baseline baseline.json] [--tolerance 0.10]
+ *                            [--url <page>] [--timeout-ms 30000] [--frame-timeout-ms 500]
+ *
+ * The trace is JSON Lines, one input per line, replayed at its offset from
+ * the start of the trace:
+ *
+ *     {"atMs": 0,   "type": "move",   "x": 100, "y": 200}
+ *     {"atMs": 16,  "type": "button", "x": 100, "y": 200, "button": 0, "down": true}
+ *     {"atMs": 40,  "type": "wheel",  "x": 100, "y": 200, "dx": 0, "dy": -120}
+ *     {"atMs": 60,  "type": "key",    "key": 65, "down": true}
+ *     {"atMs": 90,  "type": "hotkey", "key": 68, "modifiers": 1}
+ *
+ * Without --trace a built-in trace of moves, clicks, wheel turns, keys and
+ * hotkeys is used. Pointer and key input goes to BrowserView the way the
+ * window forwards it; hotkeys are published as the HotkeyEvent the input
+ * thread would publish, and their callback forwards the key to the view.
+ *
+ * Each input is timestamped through the trace ring at every stage: receipt,
+ * EventSystem dispatch (hotkeys), the send to CEF, RenderHandler::OnPaint,
+ * the DirectComposition commit, and the estimated vblank it reaches the
+ * screen at, taken from DwmGetCompositionTimingInfo as the first vblank after
+ * the first DWM composition that started after the commit. An input is
+ * replayed only once the previous one was presented (or --frame-timeout-ms
+ * passed), so every frame belongs to exactly one input. The default page
+ * repaints on every kind of input.
+ *
+ * Results hold the p50/p90/p99 of every stage per input type. With
+ * --baseline, any p50 more than --tolerance above the baseline's exits with
+ * code 2.
+ */
+
+#include "core/Application.h"
+#include "core/EventSystem.h"
+#include "core/StartupGraph.h"
+#include "core/StartupTimeline.h"
+#include "core/TraceRing.h"
+#include "browser/BrowserInterface.h"
+#include "browser/BrowserView.h"
+#include "window/input_handler.h"
+#include "window/overlay_window.h"
+#include "rendering/composite_renderer.h"
+
+#include <Windows.h>
+#include <dwmapi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#ifndef POEOVERLAY_VERSION
+#define POEOVERLAY_VERSION "unknown"
+#endif
+
+namespace {
+
+constexpr int kSchemaVersion = 1;
+constexpr int kRegressionExitCode = 2;
+constexpr int kViewWidth = 1280;
+constexpr int kViewHeight = 720;
+
+/// Moves a box to the pointer and flips its colour on every other input
+constexpr const char* kDefaultPage =
+    "<html><body style='margin:0;background:#000'>"
+    "<div id='b' style='position:absolute;width:64px;height:64px;background:#fff'></div>"
+    "<script>"
+    "var b=document.getElementById('b'),n=0;"
+    "function f(){b.style.background=(++n%2)?'#f00':'#0f0';}"
+    "onmousemove=function(e){b.style.left=e.clientX+'px';b.style.top=e.clientY+'px';};"
+    "onmousedown=f;onmouseup=f;onwheel=f;onkeydown=f;onkeyup=f;"
+    "</script></body></html>";
+
+/**
+ * @brief Command-line options.
+ */
+struct Options {
+    std::filesystem::path trace;                            ///< Input trace, or empty for the built-in one
+    std::filesystem::path output = "input_latency.json";    ///< Results file
+    std::filesystem::path history;                          ///< JSON Lines file to append p50s to
+    std::filesystem::path baseline;                         ///< Results file to compare against
+    double tolerance = 0.10;                                ///< Allowed p50 increase over the baseline
+    std::string url;                                        ///< Page to load, or empty for kDefaultPage
+    int timeoutMs = 30000;                                  ///< Give up on the page loading after this long
+    int frameTimeoutMs = 500;                               ///< Give up on an input's frame after this long
+};
+
+/**
+ * @brief One recorded input.
+ */
+struct TraceInput {
+    double atMs = 0.0;          ///< Offset from the start of the trace
+    std::string type;           ///< "move", "button", "wheel", "key" or "hotkey"
+    int x = 0;                  ///< Pointer position in view pixels
+    int y = 0;
+    int button = 0;             ///< 0 left, 1 middle, 2 right
+    bool down = true;           ///< Press or release, for buttons and keys
+    int dx = 0;                 ///< Wheel deltas
+    int dy = 0;
+    int key = 0;                ///< Virtual key code
+    int modifiers = 0;          ///< MOD_* for hotkeys, EVENTFLAG_* otherwise
+};
+
+/**
+ * @brief Ring timestamps of one replayed input; -1 for stages not reached.
+ */
+struct InputSample {
+    std::string type;           ///< Input type
+    int64_t receivedUs = -1;    ///< Input injected
+    int64_t dispatchedUs = -1;  ///< HotkeyEvent handlers started (hotkeys only)
+    int64_t sentUs = -1;        ///< Input sent to CEF
+    int64_t paintUs = -1;       ///< OnPaint started
+    int64_t committedUs = -1;   ///< Content committed
+    int64_t presentedUs = -1;   ///< Estimated vblank showing the commit
+};
+
+/**
+ * @brief Parses the command line; unknown arguments are ignored with a warning.
+ */
+Options ParseOptions(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--trace" && hasValue) {
+            options.trace = argv[++i];
+        }
+        else if (arg == "--output" && hasValue) {
+            options.output = argv[++i];
+        }
+        else if (arg == "--history" && hasValue) {
+            options.history = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue) {
+            options.baseline = argv[++i];
+        }
+        else if (arg == "--tolerance" && hasValue) {
+            options.tolerance = std::atof(argv[++i]);
+        }
+        else if (arg == "--url" && hasValue) {
+            options.url = argv[++i];
+        }
+        else if (arg == "--timeout-ms" && hasValue) {
+            options.timeoutMs = (std::max)(std::atoi(argv[++i]), 1000);
+        }
+        else if (arg == "--frame-timeout-ms" && hasValue) {
+            options.frameTimeoutMs = (std::max)(std::atoi(argv[++i]), 50);
+        }
+        else {
+            std::fprintf(stderr, "Ignoring unknown argument: %s\n", arg.c_str());
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Reads a JSON Lines trace; malformed lines are skipped with a warning.
+ */
+std::vector<TraceInput> LoadTrace(const std::filesystem::path& path)
+{
+    std::vector<TraceInput> inputs;
+    std::ifstream file(path);
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+
+        nlohmann::json entry = nlohmann::json::parse(line, nullptr, false);
+        if (entry.is_discarded() || !entry.is_object() || !entry.contains("type")) {
+            std::fprintf(stderr, "Skipping malformed trace line %d\n", lineNumber);
+            continue;
+        }
+
+        TraceInput input;
+        input.atMs = entry.value("atMs", 0.0);
+        input.type = entry.value("type", "");
+        input.x = entry.value("x", 0);
+        input.y = entry.value("y", 0);
+        input.button = entry.value("button", 0);
+        input.down = entry.value("down", true);
+        input.dx = entry.value("dx", 0);
+        input.dy = entry.value("dy", 0);
+        input.key = entry.value("key", 0);
+        input.modifiers = entry.value("modifiers", 0);
+        inputs.push_back(std::move(input));
+    }
+
+    std::stable_sort(inputs.begin(), inputs.end(),
+        [](const TraceInput& a, const TraceInput& b) { return a.atMs < b.atMs; });
+    return inputs;
+}
+
+/**
+ * @brief Builds a trace of a few seconds of mixed input at 60 Hz.
+ */
+std::vector<TraceInput> BuiltInTrace()
+{
+    std::vector<TraceInput> inputs;
+    for (int i = 0; i < 240; ++i) {
+        double atMs = i * 1000.0 / 60.0;
+        int x = 100 + (i * 7) % (kViewWidth - 200);
+        int y = 100 + (i * 3) % (kViewHeight - 200);
+
+        TraceInput input;
+        input.atMs = atMs;
+        input.x = x;
+        input.y = y;
+
+        if (i % 30 == 10) {
+            input.type = "button";
+            input.down = (i / 30) % 2 == 0;
+        }
+        else if (i % 30 == 20) {
+            input.type = "key";
+            input.key = 'A' + (i / 30) % 26;
+        }
+        else if (i % 60 == 25) {
+            input.type = "wheel";
+            input.dy = -120;
+        }
+        else if (i % 60 == 55) {
+            input.type = "hotkey";
+            input.key = VK_F9;
+        }
+        else {
+            input.type = "move";
+        }
+        inputs.push_back(std::move(input));
+    }
+    return inputs;
+}
+
+/**
+ * @brief Percent-encodes a string for a data: URL.
+ */
+std::string PercentEncode(const std::string& text)
+{
+    static const char kHex[] = "0123456789ABCDEF";
+    std::string encoded;
+    for (unsigned char c : text) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded += static_cast<char>(c);
+        }
+        else {
+            encoded += '%';
+            encoded += kHex[c >> 4];
+            encoded += kHex[c & 0xF];
+        }
+    }
+    return encoded;
+}
+
+/**
+ * @brief Finds the first record of an event at or after a ring timestamp.
+ * @param start Returns the start of the record's scope for events with a duration.
+ * @return The ring timestamp, or -1 if there is none.
+ */
+int64_t FindAfter(const std::vector<poe::TraceRecord>& records, int64_t afterUs,
+    std::initializer_list<poe::TraceEvent> events, bool start = false,
+    std::optional<int64_t> arg0 = std::nullopt)
+{
+    if (afterUs < 0) {
+        return -1;
+    }
+
+    for (const auto& record : records) {
+        if (std::find(events.begin(), events.end(), record.event) == events.end()) {
+            continue;
+        }
+        if (arg0 && record.args[0] != *arg0) {
+            continue;
+        }
+
+        int64_t timestamp = static_cast<int64_t>(record.timestampUs);
+        if (start) {
+            timestamp -= (std::max<int64_t>)(record.args[2], 0);
+        }
+        if (timestamp >= afterUs) {
+            return timestamp;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Gets the current UTC time in ISO 8601 form.
+ */
+std::string CurrentTimestamp()
+{
+    std::time_t now = std::time(nullptr);
+    std::tm utc = {};
+    gmtime_s(&utc, &now);
+
+    char buffer[32] = {};
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+/**
+ * @brief Summarizes stage latencies per input type.
+ * @return Metrics named "<type>.<stage>Ms", each with p50, p90, p99, max, mean and samples.
+ */
+nlohmann::json ComputeMetrics(const std::vector<InputSample>& samples)
+{
+    std::map<std::string, std::vector<double>> values;
+    auto add = [&values](const std::string& type, const char* stage, int64_t fromUs, int64_t toUs) {
+        if (fromUs < 0 || toUs < fromUs) {
+            return;
+        }
+        double ms = (toUs - fromUs) / 1000.0;
+        values[type + "." + stage + "Ms"].push_back(ms);
+        values[std::string("all.") + stage + "Ms"].push_back(ms);
+    };
+
+    for (const auto& sample : samples) {
+        // Hotkeys pass through the EventSystem on their way to CEF
+        int64_t beforeSend = sample.dispatchedUs >= 0 ? sample.dispatchedUs : sample.receivedUs;
+        if (sample.dispatchedUs >= 0) {
+            add(sample.type, "dispatch", sample.receivedUs, sample.dispatchedUs);
+        }
+        add(sample.type, "send", beforeSend, sample.sentUs);
+        add(sample.type, "paint", sample.sentUs, sample.paintUs);
+        add(sample.type, "commit", sample.paintUs, sample.committedUs);
+        add(sample.type, "present", sample.committedUs, sample.presentedUs);
+        if (sample.presentedUs >= 0 && sample.sentUs >= 0) {
+            add(sample.type, "total", sample.receivedUs, sample.presentedUs);
+        }
+    }
+
+    nlohmann::json metrics = nlohmann::json::object();
+    for (auto& [name, series] : values) {
+        std::sort(series.begin(), series.end());
+        auto percentile = [&series](double p) {
+            size_t rank = static_cast<size_t>(p * (series.size() - 1) + 0.5);
+            return series[(std::min)(rank, series.size() - 1)];
+        };
+        double sum = 0.0;
+        for (double value : series) {
+            sum += value;
+        }
+        metrics[name] = {
+            { "p50", percentile(0.50) },
+            { "p90", percentile(0.90) },
+            { "p99", percentile(0.99) },
+            { "max", series.back() },
+            { "mean", sum / series.size() },
+            { "samples", series.size() }
+        };
+    }
+    return metrics;
+}
+
+/**
+ * @brief Brings up the overlay, replays the trace and writes the results.
+ * @return 0 on success, 1 if nothing was presented, kRegressionExitCode on a regression.
+ */
+int RunBenchmark(const Options& options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<TraceInput> inputs = options.trace.empty() ? BuiltInTrace() : LoadTrace(options.trace);
+    if (inputs.empty()) {
+        std::fprintf(stderr, "The trace has no inputs\n");
+        return 1;
+    }
+
+    std::string url = options.url.empty()
+        ? "data:text/html;charset=utf-8," + PercentEncode(kDefaultPage)
+        : options.url;
+
+    poe::Application app("PoEOverlay");
+
+    std::unique_ptr<poe::OverlayWindow> window;
+    std::unique_ptr<poe::BrowserInterface> browser;
+
+    // Same shape as the app: the window and CEF both need the main thread
+    app.AddStartupStage("window", {}, poe::StartupThread::Main, [&]() {
+        poe::OverlayWindow::WindowConfig config;
+        config.title = L"PoEOverlay input latency";
+        config.width = kViewWidth;
+        config.height = kViewHeight;
+        config.showOnStartup = true;
+        window = std::make_unique<poe::OverlayWindow>(app, config);
+        return window->Create();
+    });
+    app.AddStartupStage("browser", { "errors" }, poe::StartupThread::Main, [&]() {
+        browser = std::make_unique<poe::BrowserInterface>(app);
+        return browser->Initialize();
+    });
+
+    if (!app.Initialize()) {
+        std::fprintf(stderr, "Failed to initialize the overlay\n");
+        return 1;
+    }
+
+    poe::TraceRing& ring = app.GetTraceRing();
+    if (!ring.IsEnabled()) {
+        std::fprintf(stderr, "The trace ring is disabled (trace.enabled); nothing can be timestamped\n");
+        return 1;
+    }
+
+    std::vector<InputSample> samples;
+    size_t missedFrames = 0;
+
+    auto view = browser->CreateBrowserView(kViewWidth, kViewHeight, url);
+    if (view) {
+        // Commits are picked up by the next DWM composition; remember when each happened
+        std::atomic<int64_t> lastCommitQpc{0};
+        poe::OverlayWindow* target = window.get();
+        view->SetPaintCallback([target, &lastCommitQpc](const void* buffer, int width, int height,
+                                                        const std::vector<RECT>& dirtyRects) {
+            auto* renderer = target->GetRenderer();
+            if (renderer && renderer->UpdateContent(buffer, width, height, dirtyRects)) {
+                LARGE_INTEGER now;
+                QueryPerformanceCounter(&now);
+                lastCommitQpc.store(now.QuadPart, std::memory_order_release);
+            }
+        });
+        view->SetAcceleratedPaintCallback([target, &lastCommitQpc](HANDLE sharedHandle) {
+            auto* renderer = target->GetRenderer();
+            if (renderer && renderer->UpdateSharedContent(sharedHandle)) {
+                LARGE_INTEGER now;
+                QueryPerformanceCounter(&now);
+                lastCommitQpc.store(now.QuadPart, std::memory_order_release);
+            }
+        });
+        view->SetVisible(true);
+        view->SetFocused(true);
+
+        // Hotkeys end in a browser update, like the app's own hotkey actions
+        poe::InputHandler inputHandler(app, window->GetHandle());
+        std::map<uint64_t, int> hotkeyIds;
+        poe::BrowserView* hotkeyView = view.get();
+        for (const auto& input : inputs) {
+            uint64_t combo = (static_cast<uint64_t>(input.modifiers) << 32) | static_cast<uint32_t>(input.key);
+            if (input.type == "hotkey" && !hotkeyIds.count(combo)) {
+                int key = input.key;
+                hotkeyIds[combo] = inputHandler.RegisterHotkey(input.modifiers, input.key,
+                    "Input latency benchmark", false, [hotkeyView, key]() {
+                        hotkeyView->OnKey(key, 0, true);
+                        hotkeyView->OnKey(key, 0, false);
+                    });
+            }
+        }
+
+        auto pump = [&](DWORD waitMs) {
+            app.GetEventSystem().ProcessEvents();
+            window->ProcessMessages();
+            browser->Update();
+            window->Update();
+            MsgWaitForMultipleObjectsEx(0, nullptr, waitMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        };
+
+        auto deadline = Clock::now() + std::chrono::milliseconds(options.timeoutMs);
+        while ((!poe::StartupTimeline::HasReached(poe::StartupMilestone::FirstCommit) || view->IsLoading()) &&
+               Clock::now() < deadline) {
+            pump(5);
+        }
+
+        // Let the first frames and the page's own startup settle
+        auto settleEnd = Clock::now() + std::chrono::milliseconds(500);
+        while (Clock::now() < settleEnd) {
+            pump(5);
+        }
+
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        uint64_t hotkeyTypeId = poe::GetEventTypeId<poe::HotkeyEvent>();
+
+        auto replayStart = Clock::now();
+        for (const auto& input : inputs) {
+            auto due = replayStart + std::chrono::microseconds(static_cast<int64_t>(input.atMs * 1000.0));
+            while (Clock::now() < due) {
+                pump(1);
+            }
+
+            InputSample sample;
+            sample.type = input.type;
+            lastCommitQpc.store(0, std::memory_order_release);
+
+            auto receivedAt = Clock::now();
+            sample.receivedUs = static_cast<int64_t>(ring.ToTimestampUs(receivedAt));
+
+            if (input.type == "move") {
+                view->OnMouseMove(input.x, input.y, input.modifiers);
+            }
+            else if (input.type == "button") {
+                view->OnMouseButton(input.x, input.y, input.button, input.modifiers, input.down);
+            }
+            else if (input.type == "wheel") {
+                view->OnMouseWheel(input.x, input.y, input.dx, input.dy);
+            }
+            else if (input.type == "key") {
+                view->OnKey(input.key, input.modifiers, input.down);
+            }
+            else if (input.type == "hotkey") {
+                // Exactly what the input thread does on a matching key press
+                uint64_t combo = (static_cast<uint64_t>(input.modifiers) << 32) | static_cast<uint32_t>(input.key);
+                int hotkeyId = hotkeyIds[combo];
+                ring.Emit(poe::TraceEvent::HotkeyPressed, hotkeyId, input.key, input.modifiers);
+                app.GetEventSystem().Publish(poe::HotkeyEvent(window->GetHandle(), hotkeyId,
+                    static_cast<UINT>(input.modifiers), static_cast<UINT>(input.key), receivedAt));
+            }
+            else {
+                std::fprintf(stderr, "Skipping input of unknown type '%s'\n", input.type.c_str());
+                continue;
+            }
+
+            // Wait for DWM to compose a frame that started after the commit
+            auto frameDeadline = receivedAt + std::chrono::milliseconds(options.frameTimeoutMs);
+            while (sample.presentedUs < 0 && Clock::now() < frameDeadline) {
+                pump(1);
+
+                int64_t commitQpc = lastCommitQpc.load(std::memory_order_acquire);
+                if (!commitQpc) {
+                    continue;
+                }
+
+                DWM_TIMING_INFO timing = {};
+                timing.cbSize = sizeof(timing);
+                if (FAILED(DwmGetCompositionTimingInfo(nullptr, &timing)) ||
+                    static_cast<int64_t>(timing.qpcCompose) <= commitQpc) {
+                    continue;
+                }
+
+                // The composed frame is scanned out at the first vblank after the compose
+                int64_t vblank = static_cast<int64_t>(timing.qpcVBlank);
+                int64_t period = (std::max<int64_t>)(static_cast<int64_t>(timing.qpcRefreshPeriod), 1);
+                while (vblank <= static_cast<int64_t>(timing.qpcCompose)) {
+                    vblank += period;
+                }
+
+                LARGE_INTEGER now;
+                QueryPerformanceCounter(&now);
+                int64_t nowUs = static_cast<int64_t>(ring.ToTimestampUs(Clock::now()));
+                sample.presentedUs = nowUs + (vblank - now.QuadPart) * 1000000 / frequency.QuadPart;
+            }
+
+            // Outside the measured window: copying the ring is not free
+            auto records = ring.Snapshot();
+            if (input.type == "hotkey") {
+                sample.dispatchedUs = FindAfter(records, sample.receivedUs,
+                    { poe::TraceEvent::EventDispatched }, true, static_cast<int64_t>(hotkeyTypeId));
+            }
+            sample.sentUs = FindAfter(records, sample.dispatchedUs >= 0 ? sample.dispatchedUs : sample.receivedUs,
+                { poe::TraceEvent::BrowserInputSent });
+            sample.paintUs = FindAfter(records, sample.sentUs,
+                { poe::TraceEvent::CefPaint, poe::TraceEvent::CefAcceleratedPaint }, true);
+            sample.committedUs = FindAfter(records, sample.paintUs, { poe::TraceEvent::ContentCommitted });
+
+            if (sample.presentedUs < 0 || sample.committedUs < 0) {
+                ++missedFrames;
+            }
+            samples.push_back(std::move(sample));
+        }
+
+        for (const auto& [combo, hotkeyId] : hotkeyIds) {
+            inputHandler.UnregisterHotkey(hotkeyId);
+        }
+        browser->ReleaseBrowserView(view);
+    }
+
+    browser->Shutdown();
+    window.reset();
+    app.Shutdown();
+
+    nlohmann::json sampleList = nlohmann::json::array();
+    for (const auto& sample : samples) {
+        auto stage = [&sample](int64_t us) {
+            return us >= 0 ? nlohmann::json((us - sample.receivedUs) / 1000.0) : nlohmann::json();
+        };
+        sampleList.push_back({
+            { "type", sample.type },
+            { "dispatchedMs", stage(sample.dispatchedUs) },
+            { "sentMs", stage(sample.sentUs) },
+            { "paintMs", stage(sample.paintUs) },
+            { "committedMs", stage(sample.committedUs) },
+            { "presentedMs", stage(sample.presentedUs) }
+        });
+    }
+
+    nlohmann::json metrics = ComputeMetrics(samples);
+    nlohmann::json results = {
+        { "schema", kSchemaVersion },
+        { "benchmark", "inputLatency" },
+        { "version", POEOVERLAY_VERSION },
+        { "timestamp", CurrentTimestamp() },
+        { "url", options.url.empty() ? "builtin" : options.url },
+        { "trace", options.trace.empty() ? "builtin" : options.trace.string() },
+        { "inputs", samples.size() },
+        { "missedFrames", missedFrames },
+        { "metrics", metrics },
+        { "samples", sampleList }
+    };
+
+    std::ofstream output(options.output, std::ios::out | std::ios::trunc);
+    output << results.dump(2) << "\n";
+    output.close();
+
+    for (const auto& [name, metric] : metrics.items()) {
+        std::printf("%-24s p50 %8.2f  p90 %8.2f  p99 %8.2f  max %8.2f  (%zu)\n", name.c_str(),
+            metric["p50"].get<double>(), metric["p90"].get<double>(), metric["p99"].get<double>(),
+            metric["max"].get<double>(), metric["samples"].get<size_t>());
+    }
+    std::printf("%zu of %zu inputs produced no presented frame\n", missedFrames, samples.size());
+    std::printf("Results written to %s\n", options.output.string().c_str());
+
+    // One compact line per invocation, for tracking over time
+    if (!options.history.empty()) {
+        nlohmann::json p50s = nlohmann::json::object();
+        for (const auto& [name, metric] : metrics.items()) {
+            p50s[name] = metric["p50"];
+        }
+
+        std::ofstream history(options.history, std::ios::out | std::ios::app);
+        history << nlohmann::json({
+            { "schema", kSchemaVersion },
+            { "benchmark", "inputLatency" },
+            { "version", POEOVERLAY_VERSION },
+            { "timestamp", results["timestamp"] },
+            { "p50", p50s }
+        }).dump() << "\n";
+    }
+
+    if (!metrics.contains("all.totalMs")) {
+        std::fprintf(stderr, "No input reached the screen\n");
+        return 1;
+    }
+
+    if (options.baseline.empty()) {
+        return 0;
+    }
+
+    std::ifstream baselineFile(options.baseline);
+    nlohmann::json baseline = nlohmann::json::parse(baselineFile, nullptr, false);
+    if (baseline.is_discarded() || !baseline.contains("metrics")) {
+        std::fprintf(stderr, "Could not read baseline %s\n", options.baseline.string().c_str());
+        return 1;
+    }
+
+    bool regressed = false;
+    for (const auto& [name, metric] : metrics.items()) {
+        if (!baseline["metrics"].contains(name)) {
+            continue;
+        }
+
+        double previous = baseline["metrics"][name].value("p50", 0.0);
+        double current = metric["p50"].get<double>();
+        if (previous > 0.0 && current > previous * (1.0 + options.tolerance)) {
+            std::printf("REGRESSION %s: %.2f -> %.2f (+%.1f%%)\n", name.c_str(), previous, current,
+                (current / previous - 1.0) * 100.0);
+            regressed = true;
+        }
+    }
+
+    return regressed ? kRegressionExitCode : 0;
+}
+
+} // namespace
+
+/**
+ * @brief Entry point for the input latency benchmark.
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit code; see the file comment.
+ */
+int main(int argc, char* argv[])
+{
+    // Match the app: DPI awareness must be set before any window exists
+    SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+
+    Options options = ParseOptions(argc, argv);
+
+    try {
+        return RunBenchmark(options);
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,101 @@
+#include "BenchmarkApplication.h"
+
+#include "core/Application.h"
+#include "core/Settings.h"
+#include "core/Logger.h"
+#include "core/EventSystem.h"
+#include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
+#include "core/MemoryTracker.h"
+#include "core/WorkerPool.h"
+#include "core/TraceRing.h"
+#include "core/StartupGraph.h"
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+
+// Stand-in for src/core/Application.cpp: the rest of Application comes from
+// src/core/ApplicationSubsystems.cpp, and only Initialize() differs. The core
+// subsystems are brought up directly and pointed at a scratch directory.
+
+namespace poe {
+
+bool Application::Initialize()
+{
+    if (!CreateSubsystems()) {
+        return false;
+    }
+
+    // Start from defaults every time so results do not depend on a previous run
+    std::filesystem::path scratch = bench::GetScratchDirectory();
+    std::error_code error;
+    std::filesystem::remove_all(scratch, error);
+
+    m_settings->SetSettingsFilePath(scratch / "settings.json");
+    m_logger->SetLogFilePath(scratch / "logs" / "benchmark.log");
+    m_logger->EnableConsoleLogging(false);
+
+    bool succeeded = m_logger->Initialize() &&
+        m_workerPool->Initialize() &&
+        m_settings->Initialize();
+    if (!succeeded) {
+        return false;
+    }
+
+    m_logger->ApplySettings();
+
+    succeeded = m_traceRing->Initialize() &&
+        m_eventSystem->Initialize() &&
+        m_errorHandler->Initialize() &&
+        m_frameProfiler->Initialize() &&
+        m_memoryTracker->Initialize();
+
+    // No stages run here; stages added later are refused like after a real start
+    m_startupGraph.reset();
+
+    m_isRunning.store(succeeded);
+    return succeeded;
+}
+
+namespace bench {
+
+namespace {
+
+std::unique_ptr<Application> g_application;
+std::once_flag g_applicationOnce;
+
+} // namespace
+
+Application& GetApplication()
+{
+    // Benchmarks with Threads(n) reach this from several threads at once
+    std::call_once(g_applicationOnce, []() {
+        auto application = std::make_unique<Application>("PoEOverlayBenchmarks");
+        if (!application->Initialize()) {
+            throw std::runtime_error("Benchmark application failed to initialize");
+        }
+        g_application = std::move(application);
+    });
+
+    if (!g_application) {
+        throw std::runtime_error("Benchmark application failed to initialize");
+    }
+    return *g_application;
+}
+
+void ShutdownApplication()
+{
+    // Explicit, so the logger is gone before spdlog's own statics are destroyed
+    g_application.reset();
+}
+
+std::filesystem::path GetScratchDirectory()
+{
+    return std::filesystem::temp_directory_path() / "PoEOverlayBenchmarks";
+}
+
+} // namespace bench
+
+} // namespace poe
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+
+namespace poe {
+    class Application;
+}
+
+namespace poe::bench {
+
+/**
+ * @brief Gets the Application shared by every micro-benchmark.
+ *
+ * The benchmark executable links BenchmarkApplication.cpp in place of
+ * src/core/Application.cpp. Its Application::Initialize() brings up only
+ * the core subsystems, against a scratch directory instead of the user's
+ * settings and logs, with no window, no CEF and no startup graph, so the
+ * core benchmarks build and run without Windows. Created on first use.
+ * @return Reference to the initialized application.
+ * @throws std::runtime_error if the application failed to initialize.
+ */
+Application& GetApplication();
+
+/**
+ * @brief Shuts the shared application down; call once, after the last benchmark.
+ */
+void ShutdownApplication();
+
+/**
+ * @brief Gets the directory holding the benchmark settings and logs.
+ * @return The scratch directory, emptied when the application is created.
+ */
+std::filesystem::path GetScratchDirectory();
+
+} // namespace poe::bench
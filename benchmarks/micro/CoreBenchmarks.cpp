@@ -0,0 +1,188 @@
+/**
+ * @file CoreBenchmarks.cpp
+ * @brief Benchmarks for EventSystem, Settings and Logger. Platform-independent.
+ */
+
+#include "BenchmarkApplication.h"
+
+#include "core/Application.h"
+#include "core/Settings.h"
+#include "core/Logger.h"
+#include "core/EventSystem.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Small event, about the size of the window and input events.
+ */
+struct BenchmarkEvent : poe::Event {
+    explicit BenchmarkEvent(int value) : value(value) {}
+
+    std::string GetTypeName() const override { return "BenchmarkEvent"; }
+
+    int value;  ///< Payload read by every handler
+};
+
+/**
+ * @brief Subscribes a number of counting handlers and removes them on destruction.
+ */
+class ScopedHandlers {
+public:
+    ScopedHandlers(poe::EventSystem& events, int count)
+        : m_events(events)
+    {
+        for (int i = 0; i < count; ++i) {
+            m_ids.push_back(m_events.Subscribe<BenchmarkEvent>([this](const BenchmarkEvent& event) {
+                m_sum += event.value;
+            }));
+        }
+    }
+
+    ~ScopedHandlers()
+    {
+        for (size_t id : m_ids) {
+            m_events.Unsubscribe(id);
+        }
+    }
+
+    int64_t GetSum() const { return m_sum; }
+
+private:
+    poe::EventSystem& m_events;     ///< Event system the handlers live in
+    std::vector<size_t> m_ids;      ///< Subscription IDs
+    int64_t m_sum = 0;              ///< Accumulated payloads, so dispatch cannot be elided
+};
+
+/**
+ * @brief Publish() a batch of events, then ProcessEvents() to dispatch them.
+ * @param range(0) Number of handlers.
+ * @param range(1) Events per batch.
+ */
+void BM_EventPublishDispatch(benchmark::State& state)
+{
+    poe::EventSystem& events = poe::bench::GetApplication().GetEventSystem();
+    ScopedHandlers handlers(events, static_cast<int>(state.range(0)));
+    const int batch = static_cast<int>(state.range(1));
+
+    for (auto _ : state) {
+        for (int i = 0; i < batch; ++i) {
+            events.Publish(BenchmarkEvent(i));
+        }
+        events.ProcessEvents();
+    }
+
+    benchmark::DoNotOptimize(handlers.GetSum());
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_EventPublishDispatch)->ArgNames({ "handlers", "batch" })
+    ->Args({ 1, 1 })->Args({ 1, 64 })->Args({ 8, 64 });
+
+/**
+ * @brief PublishImmediate(), dispatching on the calling thread.
+ * @param range(0) Number of handlers.
+ */
+void BM_EventPublishImmediate(benchmark::State& state)
+{
+    poe::EventSystem& events = poe::bench::GetApplication().GetEventSystem();
+    ScopedHandlers handlers(events, static_cast<int>(state.range(0)));
+
+    int value = 0;
+    for (auto _ : state) {
+        events.PublishImmediate(BenchmarkEvent(value++));
+    }
+
+    benchmark::DoNotOptimize(handlers.GetSum());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventPublishImmediate)->ArgName("handlers")->Arg(1)->Arg(8);
+
+/**
+ * @brief Keyed Settings::Get<int>(), contended when run on several threads.
+ */
+void BM_SettingsGetInt(benchmark::State& state)
+{
+    poe::Settings& settings = poe::bench::GetApplication().GetSettings();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(settings.Get<int>("window.width", 800));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SettingsGetInt)->Threads(1)->Threads(4);
+
+/**
+ * @brief Keyed Settings::Get<std::string>(), which also copies the value out.
+ */
+void BM_SettingsGetString(benchmark::State& state)
+{
+    poe::Settings& settings = poe::bench::GetApplication().GetSettings();
+    const std::string fallback = "Alt+B";
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(settings.Get<std::string>("hotkey.toggle", fallback));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SettingsGetString)->Threads(1)->Threads(4);
+
+/**
+ * @brief Settings::GetSnapshot(), the lock-free path for per-frame reads.
+ */
+void BM_SettingsSnapshot(benchmark::State& state)
+{
+    poe::Settings& settings = poe::bench::GetApplication().GetSettings();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(settings.GetSnapshot()->windowWidth);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SettingsSnapshot)->Threads(1)->Threads(4);
+
+/**
+ * @brief A debug message below the active level: the cost of a disabled call site.
+ */
+void BM_LoggerDisabled(benchmark::State& state)
+{
+    poe::Logger& logger = poe::bench::GetApplication().GetLogger();
+
+    int value = 0;
+    for (auto _ : state) {
+        logger.Log(1, "Disabled message {} {}", value++, "argument");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerDisabled);
+
+/**
+ * @brief An info message through the file backend.
+ * @param range(0) 1 for the asynchronous backend, 0 for the synchronous one.
+ */
+void BM_LoggerInfo(benchmark::State& state)
+{
+    poe::Logger& logger = poe::bench::GetApplication().GetLogger();
+    logger.SetAsyncMode(state.range(0) != 0, 8192, false);
+
+    int value = 0;
+    for (auto _ : state) {
+        logger.Info("Benchmark message {} {}", value++, "argument");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    // Back to whatever the settings ask for
+    logger.ApplySettings();
+}
+BENCHMARK(BM_LoggerInfo)->ArgName("async")->Arg(0)->Arg(1);
+
+} // namespace
@@ -0,0 +1,37 @@
+/**
+ * @file Main.cpp
+ * @brief Entry point for the micro-benchmark suite.
+ *
+ * Accepts the usual Google Benchmark flags. To keep a baseline and compare
+ * against it:
+ *
+ *     PoEOverlayMicroBenchmarks --benchmark_out=baseline.json --benchmark_out_format=json
+ *     PoEOverlayMicroBenchmarks --benchmark_out=current.json --benchmark_out_format=json
+ *     compare.py benchmarks baseline.json current.json
+ *
+ * where compare.py is the script shipped in Google Benchmark's tools/.
+ */
+
+#include "BenchmarkApplication.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * @brief Runs the registered benchmarks.
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return 0 on success, 1 on unrecognized arguments.
+ */
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    poe::bench::ShutdownApplication();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file RenderingBenchmarks.cpp
+ * @brief Benchmarks for ZOrderManager and AnimationManager. Windows only.
+ */
+
+#include "BenchmarkApplication.h"
+
+#include "core/Application.h"
+#include "rendering/z_order_manager.h"
+#include "rendering/animation_manager.h"
+
+#include <benchmark/benchmark.h>
+
+#include <d3d11.h>
+#include <dcomp.h>
+#include <wrl/client.h>
+
+#include <memory>
+#include <vector>
+
+#pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "dcomp.lib")
+
+namespace {
+
+using Microsoft::WRL::ComPtr;
+
+/**
+ * @brief Creates a composition device the way GraphicsDevice does, without a window.
+ * @return The device, or nullptr if Direct3D or DirectComposition is unavailable.
+ */
+ComPtr<IDCompositionDevice> CreateCompositionDevice()
+{
+    ComPtr<ID3D11Device> d3dDevice;
+    HRESULT hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+                                   nullptr, 0, D3D11_SDK_VERSION, &d3dDevice, nullptr, nullptr);
+    if (FAILED(hr)) {
+        // WARP keeps the benchmark runnable on machines without a usable GPU
+        hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+                               nullptr, 0, D3D11_SDK_VERSION, &d3dDevice, nullptr, nullptr);
+    }
+    if (FAILED(hr)) {
+        return nullptr;
+    }
+
+    ComPtr<IDXGIDevice> dxgiDevice;
+    if (FAILED(d3dDevice.As(&dxgiDevice))) {
+        return nullptr;
+    }
+
+    ComPtr<IDCompositionDevice> dcompDevice;
+    if (FAILED(DCompositionCreateDevice(dxgiDevice.Get(), IID_PPV_ARGS(&dcompDevice)))) {
+        return nullptr;
+    }
+
+    return dcompDevice;
+}
+
+/**
+ * @brief Gets the composition device shared by the Z-order benchmarks.
+ */
+IDCompositionDevice* GetCompositionDevice()
+{
+    static ComPtr<IDCompositionDevice> device = CreateCompositionDevice();
+    return device.Get();
+}
+
+/**
+ * @brief Brings up a ZOrderManager holding a number of committed Content visuals.
+ * @param state The benchmark; skipped if no composition device is available.
+ * @param count Number of visuals, with Z-orders 0 to count - 1.
+ * @param handles Receives the visual handles, bottom to top.
+ * @return The manager, or nullptr if the benchmark was skipped.
+ */
+std::unique_ptr<poe::ZOrderManager> CreatePopulatedZOrder(
+    benchmark::State& state, int count, std::vector<poe::ZOrderManager::VisualHandle>& handles)
+{
+    IDCompositionDevice* device = GetCompositionDevice();
+    if (!device) {
+        state.SkipWithError("Could not create a composition device");
+        return nullptr;
+    }
+
+    auto zorder = std::make_unique<poe::ZOrderManager>(poe::bench::GetApplication(), device);
+    zorder->Initialize();
+
+    for (int i = 0; i < count; ++i) {
+        handles.push_back(zorder->CreateVisual(poe::ZOrderManager::LayerType::Content, i));
+    }
+    zorder->Commit();
+
+    return zorder;
+}
+
+/**
+ * @brief Moves one visual to the other end of a populated tree and commits.
+ *
+ * Commit() is where the tree is rebuilt, so this is the incremental patch
+ * of a single reorder plus the device commit.
+ * @param range(0) Number of visuals.
+ */
+void BM_ZOrderCommitMove(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    std::vector<poe::ZOrderManager::VisualHandle> handles;
+    auto zorder = CreatePopulatedZOrder(state, count, handles);
+    if (!zorder) {
+        return;
+    }
+
+    bool toTop = true;
+    for (auto _ : state) {
+        zorder->SetVisualZOrder(handles.front(), poe::ZOrderManager::LayerType::Content, toTop ? count : -1);
+        zorder->Commit();
+        toTop = !toTop;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ZOrderCommitMove)->ArgName("visuals")->Arg(16)->Arg(256);
+
+/**
+ * @brief Hides or shows every visual and commits: the full rebuild.
+ * @param range(0) Number of visuals.
+ */
+void BM_ZOrderCommitAll(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    std::vector<poe::ZOrderManager::VisualHandle> handles;
+    auto zorder = CreatePopulatedZOrder(state, count, handles);
+    if (!zorder) {
+        return;
+    }
+
+    bool visible = false;
+    for (auto _ : state) {
+        for (auto handle : handles) {
+            zorder->SetVisualVisibility(handle, visible);
+        }
+        zorder->Commit();
+        visible = !visible;
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ZOrderCommitAll)->ArgName("visuals")->Arg(16)->Arg(256);
+
+/**
+ * @brief AnimationManager::Update() over running CPU-driven animations.
+ * @param range(0) Number of animations.
+ */
+void BM_AnimationUpdate(benchmark::State& state)
+{
+    poe::AnimationManager animations(poe::bench::GetApplication());
+    animations.Initialize();
+
+    // Long enough that none of them finishes during the run
+    constexpr uint32_t kDurationMs = 60 * 60 * 1000;
+
+    const int count = static_cast<int>(state.range(0));
+    float sink = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        auto handle = animations.CreateFloatAnimation(kDurationMs, 0.0f, 1.0f, [&sink](float value) { sink += value; });
+        animations.StartAnimation(handle);
+    }
+
+    for (auto _ : state) {
+        animations.Update();
+    }
+
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AnimationUpdate)->ArgName("animations")->Arg(4)->Arg(64);
+
+/**
+ * @brief Reverses a running CPU fade back and forth, the way border hover does.
+ *
+ * Each retarget reuses the pooled slot, so this is the cost of a hover
+ * change without any allocation.
+ */
+void BM_AnimationRetarget(benchmark::State& state)
+{
+    poe::AnimationManager animations(poe::bench::GetApplication());
+    animations.Initialize();
+
+    float sink = 0.0f;
+    auto handle = animations.CreateFloatAnimation(200, 0.0f, 0.0f, [&sink](float value) { sink += value; });
+
+    bool show = true;
+    for (auto _ : state) {
+        animations.RetargetAnimation(handle, show ? 1.0f : 0.0f);
+        animations.Update();
+        show = !show;
+    }
+
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AnimationRetarget);
+
+} // namespace
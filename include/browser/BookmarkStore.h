@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace poe {
+
+/**
+ * @struct Bookmark
+ * @brief Represents a browser bookmark.
+ */
+struct Bookmark {
+    std::string name;      ///< Bookmark name
+    std::string url;       ///< Bookmark URL
+    std::string folder;    ///< Folder containing the bookmark
+    std::string icon;      ///< Icon URL or path
+};
+
+/**
+ * @class BookmarkStore
+ * @brief Bookmarks grouped by folder, with a hash index on URL.
+ *
+ * Each folder keeps its bookmarks contiguous and in insertion order, so a
+ * folder query is a span over existing storage rather than a filtered copy.
+ * URL lookups, inserts and updates are O(1); removing a bookmark shifts the
+ * rest of its folder only. Spans stay valid until the next mutation.
+ */
+class BookmarkStore {
+public:
+    /**
+     * @brief Adds a bookmark, or updates the one with the same URL.
+     * @param bookmark The bookmark to add.
+     * @return True if a new bookmark was added, false if an existing one was updated.
+     */
+    bool Add(const Bookmark& bookmark);
+
+    /**
+     * @brief Adds many bookmarks at once, e.g. from an import.
+     * @param bookmarks The bookmarks to add; later duplicates update earlier ones.
+     * @return Number of new bookmarks added.
+     */
+    size_t AddRange(std::span<const Bookmark> bookmarks);
+
+    /**
+     * @brief Removes the bookmark with a URL.
+     * @param url The URL of the bookmark to remove.
+     * @return True if a bookmark was removed, false if none had the URL.
+     */
+    bool Remove(const std::string& url);
+
+    /**
+     * @brief Removes all bookmarks.
+     */
+    void Clear();
+
+    /**
+     * @brief Finds the bookmark with a URL.
+     * @param url The URL to look up.
+     * @return Pointer to the bookmark, or nullptr if not found.
+     */
+    const Bookmark* Find(const std::string& url) const;
+
+    /**
+     * @brief Checks whether a URL is bookmarked.
+     * @param url The URL to check.
+     * @return True if the URL is bookmarked, false otherwise.
+     */
+    bool Contains(const std::string& url) const { return m_urlIndex.count(url) != 0; }
+
+    /**
+     * @brief Gets the bookmarks in a folder.
+     * @param folder The folder name.
+     * @return The folder's bookmarks in insertion order; empty if the folder does not exist.
+     */
+    std::span<const Bookmark> GetFolder(const std::string& folder) const;
+
+    /**
+     * @brief Gets the names of all non-empty folders, in order of creation.
+     * @return The folder names.
+     */
+    std::span<const std::string> GetFolderNames() const { return m_folderNames; }
+
+    /**
+     * @brief Gets the total number of bookmarks.
+     * @return The bookmark count.
+     */
+    size_t GetCount() const { return m_urlIndex.size(); }
+
+    /**
+     * @brief Copies all bookmarks, folder by folder.
+     * @return The bookmarks.
+     */
+    std::vector<Bookmark> ToVector() const;
+
+private:
+    /**
+     * @brief Where a bookmark lives.
+     */
+    struct Location {
+        size_t folder;      ///< Index into m_folders
+        size_t position;    ///< Index within the folder
+    };
+
+    /**
+     * @brief Gets a folder's index, creating the folder if needed.
+     * @param folder The folder name.
+     * @return Index into m_folders.
+     */
+    size_t GetOrCreateFolder(const std::string& folder);
+
+    /**
+     * @brief Removes the bookmark at a location and fixes up the indexes.
+     * @param location The bookmark's location.
+     */
+    void RemoveAt(Location location);
+
+    std::vector<std::vector<Bookmark>> m_folders;            ///< Bookmarks per folder
+    std::vector<std::string> m_folderNames;                  ///< Folder names, parallel to m_folders
+    std::unordered_map<std::string, size_t> m_folderIndex;   ///< Folder name to index into m_folders
+    std::unordered_map<std::string, Location> m_urlIndex;    ///< URL to bookmark location
+};
+
+} // namespace poe
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <include/wrapper/cef_message_router.h>
+
+namespace poe {
+
+/**
+ * @brief Names shared by the browser and renderer halves of the JS bridge.
+ *
+ * The renderer half lives in CefSubProcess, which does not link the rest of
+ * the overlay, so everything both sides must agree on is kept here.
+ */
+namespace bridge {
+
+/// Function the message router installs on window; poe.call() wraps it
+constexpr const char* kQueryFunction = "poeQuery";
+
+/// Function the message router installs on window to cancel a query
+constexpr const char* kCancelFunction = "poeQueryCancel";
+
+/// Browser to renderer: [int token, binary payload], sent just before the query reply naming the token
+constexpr const char* kBufferMessage = "poe.bridge.buffer";
+
+/**
+ * @brief Router configuration used on both sides.
+ * @return The configuration.
+ */
+inline CefMessageRouterConfig GetRouterConfig()
+{
+    CefMessageRouterConfig config;
+    config.js_query_function = kQueryFunction;
+    config.js_cancel_function = kCancelFunction;
+    return config;
+}
+
+/**
+ * @brief JavaScript installed in every renderer as the "poe" object.
+ *
+ * poe.call(method, params) resolves with the method's JSON value, or with
+ * an ArrayBuffer for binary results. poe.batch([{method, params}, ...])
+ * sends all calls in one query and resolves with an array of results, in
+ * which failed calls are Error objects. poe.subscribe(topic, callback)
+ * calls back with every value MessageBridge::Publish sends to the topic
+ * and returns a function that unsubscribes. TakeBuffer hands over a
+ * payload that arrived in a kBufferMessage without copying it again.
+ */
+constexpr const char* kExtensionCode = R"JS(
+    var poe = poe || {};
+    (function() {
+        native function TakeBuffer(token);
+
+        function decode(result) {
+            if (result.error !== undefined) {
+                return new Error(result.error);
+            }
+            return result.buffer !== undefined ? TakeBuffer(result.buffer) : result.value;
+        }
+
+        function query(request) {
+            return new Promise(function(resolve, reject) {
+                window.poeQuery({
+                    request: JSON.stringify(request),
+                    persistent: false,
+                    onSuccess: function(response) { resolve(JSON.parse(response)); },
+                    onFailure: function(code, message) { reject(new Error(message)); }
+                });
+            });
+        }
+
+        poe.call = function(method, params) {
+            return query({ method: method, params: params || {} }).then(function(result) {
+                var value = decode(result);
+                if (value instanceof Error) {
+                    throw value;
+                }
+                return value;
+            });
+        };
+
+        poe.batch = function(calls) {
+            return query({ batch: calls }).then(function(response) {
+                return response.results.map(decode);
+            });
+        };
+
+        poe.subscribe = function(topic, callback) {
+            var id = window.poeQuery({
+                request: JSON.stringify({ subscribe: topic }),
+                persistent: true,
+                onSuccess: function(response) { callback(JSON.parse(response).value); },
+                onFailure: function(code, message) { console.error('poe.subscribe(' + topic + '): ' + message); }
+            });
+            return function() { window.poeQueryCancel(id); };
+        };
+    })();
+)JS";
+
+} // namespace bridge
+
+} // namespace poe
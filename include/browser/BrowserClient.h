@@ -2,6 +2,7 @@
 
 #include <include/cef_client.h>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
@@ -40,6 +41,7 @@ public:
     CefRefPtr<CefDisplayHandler> GetDisplayHandler() override;
     CefRefPtr<CefContextMenuHandler> GetContextMenuHandler() override;
     CefRefPtr<CefRenderHandler> GetRenderHandler() override;
+    CefRefPtr<CefRequestHandler> GetRequestHandler() override;
     bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
         CefRefPtr<CefFrame> frame, CefProcessId source_process,
         CefRefPtr<CefProcessMessage> message) override;
@@ -53,7 +55,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     // Required for IMPLEMENT_REFCOUNTING
     IMPLEMENT_REFCOUNTING(BrowserClient);
@@ -10,53 +10,33 @@
 #include <include/cef_load_handler.h>
 #include <include/cef_display_handler.h>
 #include <include/cef_context_menu_handler.h>
+#include <include/cef_request_handler.h>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
 // Forward declarations
 class Application;
 class CefManager;
+class BrowserView;
 
 /**
  * @class BrowserHandler
  * @brief Handles browser-related events and callbacks.
  * 
  * This class implements various CEF handler interfaces to handle
- * browser lifecycle, loading, display, and context menu events.
+ * browser lifecycle, loading, display, context menu and navigation events.
+ * Resource requests are left to an optional inner request handler.
  */
 class BrowserHandler : 
     public CefLifeSpanHandler,
     public CefLoadHandler,
     public CefDisplayHandler,
-    public CefContextMenuHandler
+    public CefContextMenuHandler,
+    public CefRequestHandler
 {
 public:
-    /**
-     * @brief Type definition for browser creation callback.
-     */
-    using BrowserCreatedCallback = std::function<void(CefRefPtr<CefBrowser>)>;
-
-    /**
-     * @brief Type definition for browser close callback.
-     */
-    using BrowserCloseCallback = std::function<void(CefRefPtr<CefBrowser>)>;
-
-    /**
-     * @brief Type definition for browser load state change callback.
-     */
-    using LoadStateCallback = std::function<void(CefRefPtr<CefBrowser>, bool isLoading, bool canGoBack, bool canGoForward)>;
-
-    /**
-     * @brief Type definition for browser title change callback.
-     */
-    using TitleChangeCallback = std::function<void(CefRefPtr<CefBrowser>, const std::string& title)>;
-
-    /**
-     * @brief Type definition for browser address change callback.
-     */
-    using AddressChangeCallback = std::function<void(CefRefPtr<CefBrowser>, const std::string& url)>;
-
     /**
      * @brief Type definition for browser status message callback.
      */
@@ -70,40 +50,43 @@ public:
     BrowserHandler(Application& app, CefManager& cefManager);
 
     /**
-     * @brief Sets the callback for browser creation events.
-     * @param callback The callback function.
-     */
-    void SetBrowserCreatedCallback(BrowserCreatedCallback callback) { m_browserCreatedCallback = callback; }
-
-    /**
-     * @brief Sets the callback for browser close events.
+     * @brief Sets the callback for status message events.
      * @param callback The callback function.
      */
-    void SetBrowserCloseCallback(BrowserCloseCallback callback) { m_browserCloseCallback = callback; }
+    void SetStatusMessageCallback(StatusMessageCallback callback) { m_statusMessageCallback = callback; }
 
     /**
-     * @brief Sets the callback for load state change events.
-     * @param callback The callback function.
+     * @brief Sets the handler that resource requests are delegated to.
+     *
+     * Must be set before the first browser is created; resource requests
+     * are looked up on the IO thread without locking.
+     * @param handler The request handler, or nullptr for CEF's default handling.
      */
-    void SetLoadStateCallback(LoadStateCallback callback) { m_loadStateCallback = callback; }
+    void SetResourceRequestHandler(CefRefPtr<CefRequestHandler> handler) { m_resourceRequestHandler = handler; }
 
     /**
-     * @brief Sets the callback for title change events.
-     * @param callback The callback function.
+     * @brief Routes load, title, address and close events of a browser to its view.
+     *
+     * Every browser shares this handler, so events are dispatched by browser
+     * ID; browsers without a registered view only update the handler's own data.
+     * @param browserId The browser ID.
+     * @param view The view; must unregister before it is destroyed.
      */
-    void SetTitleChangeCallback(TitleChangeCallback callback) { m_titleChangeCallback = callback; }
+    void RegisterView(int browserId, BrowserView* view);
 
     /**
-     * @brief Sets the callback for address change events.
-     * @param callback The callback function.
+     * @brief Stops routing events of a browser to its view.
+     * @param browserId The browser ID.
      */
-    void SetAddressChangeCallback(AddressChangeCallback callback) { m_addressChangeCallback = callback; }
+    void UnregisterView(int browserId);
 
     /**
-     * @brief Sets the callback for status message events.
-     * @param callback The callback function.
+     * @brief Handles a scroll position reported by the renderer process.
+     * @param browser The browser the position belongs to.
+     * @param x Horizontal scroll offset in CSS pixels.
+     * @param y Vertical scroll offset in CSS pixels.
      */
-    void SetStatusMessageCallback(StatusMessageCallback callback) { m_statusMessageCallback = callback; }
+    void OnScrollPosition(CefRefPtr<CefBrowser> browser, int x, int y);
 
     // CefLifeSpanHandler methods
     CefRefPtr<CefLifeSpanHandler> GetLifeSpanHandler() override { return this; }
@@ -140,6 +123,14 @@ public:
     bool OnContextMenuCommand(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
         CefRefPtr<CefContextMenuParams> params, int command_id, EventFlags event_flags) override;
 
+    // CefRequestHandler methods
+    bool OnBeforeBrowse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+        CefRefPtr<CefRequest> request, bool user_gesture, bool is_redirect) override;
+    CefRefPtr<CefResourceRequestHandler> GetResourceRequestHandler(CefRefPtr<CefBrowser> browser,
+        CefRefPtr<CefFrame> frame, CefRefPtr<CefRequest> request, bool is_navigation,
+        bool is_download, const CefString& request_initiator, bool& disable_default_handling) override;
+    void OnRenderProcessTerminated(CefRefPtr<CefBrowser> browser, TerminationStatus status) override;
+
 private:
     /**
      * @brief Stores browser-specific data.
@@ -152,6 +143,13 @@ private:
         bool canGoForward = false;
     };
 
+    /**
+     * @brief Finds the view registered for a browser.
+     * @param browserId The browser ID.
+     * @return The view, or nullptr if none is registered.
+     */
+    BrowserView* FindView(int browserId);
+
     /**
      * @brief Log a message using the application logger.
      * @tparam Args Variadic template for format arguments.
@@ -160,7 +158,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     // Required for IMPLEMENT_REFCOUNTING
     IMPLEMENT_REFCOUNTING(BrowserHandler);
@@ -171,12 +171,11 @@ private:
     std::unordered_map<int, BrowserData> m_browserData; ///< Map of browser ID to browser data
     std::mutex m_browserDataMutex;                 ///< Mutex for thread-safe access to browser data
     
-    BrowserCreatedCallback m_browserCreatedCallback; ///< Callback for browser creation events
-    BrowserCloseCallback m_browserCloseCallback;    ///< Callback for browser close events
-    LoadStateCallback m_loadStateCallback;          ///< Callback for load state change events
-    TitleChangeCallback m_titleChangeCallback;      ///< Callback for title change events
-    AddressChangeCallback m_addressChangeCallback;  ///< Callback for address change events
+    std::unordered_map<int, BrowserView*> m_views;  ///< Map of browser ID to the view showing it
+    std::mutex m_viewsMutex;                        ///< Mutex for thread-safe access to views
+    
     StatusMessageCallback m_statusMessageCallback;  ///< Callback for status message events
+    CefRefPtr<CefRequestHandler> m_resourceRequestHandler; ///< Handler for resource requests, or nullptr
 };
 
 } // namespace poe
\ No newline at end of file
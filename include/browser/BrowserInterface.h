@@ -1,27 +1,31 @@
 #pragma once
 
+#include <Windows.h>
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <functional>
+#include <unordered_map>
 #include <vector>
 #include "core/Application.h"
+#include "core/Logger.h"
+#include "browser/BookmarkStore.h"
+#include "browser/OmniboxIndex.h"
 
 namespace poe {
 
 // Forward declarations
 class CefManager;
 class BrowserView;
-
-/**
- * @struct Bookmark
- * @brief Represents a browser bookmark.
- */
-struct Bookmark {
-    std::string name;      ///< Bookmark name
-    std::string url;       ///< Bookmark URL
-    std::string folder;    ///< Folder containing the bookmark
-    std::string icon;      ///< Icon URL or path
-};
+class CompositeRenderer;
+class InputHandler;
+class PriceChecker;
+class FocusTracker;
+class PriorityManager;
 
 /**
  * @class BrowserInterface
@@ -57,6 +61,9 @@ public:
 
     /**
      * @brief Creates a new browser view.
+     *
+     * Hands out a pre-warmed browser when one is pooled, so the caller does
+     * not wait for a renderer process to start; otherwise creates one.
      * @param width Initial width of the browser view.
      * @param height Initial height of the browser view.
      * @param url Initial URL to navigate to.
@@ -68,6 +75,77 @@ public:
         const std::string& url = "about:blank"
     );
 
+    /**
+     * @brief Releases a browser view created by CreateBrowserView.
+     *
+     * The view is reset and kept warm for the next CreateBrowserView call
+     * while the pool is below its configured size, and closed otherwise.
+     * @param view The browser view to release.
+     */
+    void ReleaseBrowserView(const std::shared_ptr<BrowserView>& view);
+
+    /**
+     * @brief Hosts every visible browser view as a panel of a window's compositor.
+     *
+     * Each visible view gets its own panel, fed from the view's frame
+     * mailbox; the panel goes away when the view is hidden, discarded or
+     * released, and comes back with the same bounds and stacking when it
+     * is shown again.
+     * @param compositor The compositor (not owned), or nullptr to stop hosting;
+     *        must be cleared before the compositor is destroyed.
+     */
+    void SetCompositor(CompositeRenderer* compositor);
+
+    /**
+     * @brief Places a view's panel and resizes the view to match.
+     * @param view The browser view.
+     * @param bounds Panel rectangle in window coordinates (device pixels).
+     * @return True if the view is one of the active views, false otherwise.
+     */
+    bool SetViewBounds(const std::shared_ptr<BrowserView>& view, const RECT& bounds);
+
+    /**
+     * @brief Changes the stacking order of a view's panel.
+     * @param view The browser view.
+     * @param zOrder Stacking order among panels (higher values are on top).
+     * @return True if the view is one of the active views, false otherwise.
+     */
+    bool SetViewZOrder(const std::shared_ptr<BrowserView>& view, int zOrder);
+
+    /**
+     * @brief Starts the price checker, with its hotkey on an input handler.
+     *
+     * The league and refresh interval come from the priceCheck settings.
+     * The checker is updated from Update() and shut down before CEF.
+     * @param inputHandler Input handler owning the hotkey; must outlive the checker.
+     * @return True if the price checker is running, false otherwise.
+     */
+    bool EnablePriceCheck(InputHandler& inputHandler);
+
+    /**
+     * @brief Starts lowering the overlay's and CEF's scheduling while the game has focus.
+     *
+     * The profile comes from the priority settings. CEF children are picked
+     * up as they launch, and the manager is updated from Update() and shut
+     * down before CEF.
+     * @param focusTracker Focus tracker to follow; must outlive the manager.
+     * @return True if the priority manager is running, false otherwise.
+     */
+    bool EnablePriorityManagement(FocusTracker& focusTracker);
+
+    /**
+     * @brief Gets the priority manager, e.g. to tell it the game process.
+     * @return Pointer to the priority manager, or nullptr if not enabled.
+     */
+    PriorityManager* GetPriorityManager() const { return m_priorityManager.get(); }
+
+    /**
+     * @brief Discards hidden browser views until renderer memory is back under budget.
+     * @param aggressive Discard every hidden view and the warm pool, as on a
+     *        system low-memory notification.
+     */
+    void TrimMemory(bool aggressive = false);
+
     /**
      * @brief Updates the browser interface.
      * This should be called periodically to process browser events.
@@ -75,12 +153,21 @@ public:
     void Update();
 
     /**
-     * @brief Adds a bookmark.
+     * @brief Adds a bookmark, or updates the one with the same URL.
+     *
+     * Saving is deferred; changes made in quick succession are written once.
      * @param bookmark The bookmark to add.
      * @return True if the bookmark was added, false otherwise.
      */
     bool AddBookmark(const Bookmark& bookmark);
 
+    /**
+     * @brief Adds many bookmarks at once, e.g. from a build guide or trade search export.
+     * @param bookmarks The bookmarks to add.
+     * @return Number of new bookmarks added.
+     */
+    size_t ImportBookmarks(std::span<const Bookmark> bookmarks);
+
     /**
      * @brief Removes a bookmark.
      * @param url The URL of the bookmark to remove.
@@ -90,22 +177,22 @@ public:
 
     /**
      * @brief Gets all bookmarks.
-     * @return Vector of all bookmarks.
+     * @return Copy of all bookmarks, folder by folder.
      */
     std::vector<Bookmark> GetBookmarks() const;
 
     /**
      * @brief Gets bookmarks in a specific folder.
      * @param folder The folder to get bookmarks from.
-     * @return Vector of bookmarks in the specified folder.
+     * @return The folder's bookmarks; valid until bookmarks next change.
      */
-    std::vector<Bookmark> GetBookmarksInFolder(const std::string& folder) const;
+    std::span<const Bookmark> GetBookmarksInFolder(const std::string& folder) const;
 
     /**
      * @brief Gets all bookmark folders.
-     * @return Vector of folder names.
+     * @return Folder names; valid until bookmarks next change.
      */
-    std::vector<std::string> GetBookmarkFolders() const;
+    std::span<const std::string> GetBookmarkFolders() const;
 
     /**
      * @brief Checks if a URL is bookmarked.
@@ -145,6 +232,19 @@ public:
      */
     std::string GetSearchUrl(const std::string& query) const;
 
+    /**
+     * @brief Gets ranked bookmark and history matches for omnibox text.
+     * @param text The text typed so far.
+     * @param maxResults Maximum number of matches to return.
+     * @return Matches, best first.
+     */
+    std::vector<OmniboxMatch> GetSuggestions(const std::string& text, size_t maxResults = 8) const;
+
+    /**
+     * @brief Forgets visited pages; bookmarks stay suggestible.
+     */
+    void ClearHistory();
+
     /**
      * @brief Sets the search engine URL.
      * @param url The search engine URL (with {} placeholder for query).
@@ -152,6 +252,27 @@ public:
     void SetSearchEngine(const std::string& url);
 
 private:
+    /**
+     * @struct ViewPanel
+     * @brief Where a view is composited; kept while the view has no panel.
+     */
+    struct ViewPanel {
+        RECT bounds = {};       ///< Panel rectangle in window coordinates
+        int zOrder = 0;         ///< Stacking order among panels
+        uint32_t panel = 0;     ///< CompositeRenderer::PanelId, 0 while the view has no panel
+    };
+
+    /**
+     * @brief Gives every visible view a panel and takes it from hidden ones.
+     */
+    void SyncPanels();
+
+    /**
+     * @brief Destroys a view's panel, keeping its bounds and stacking.
+     * @param viewPanel The view's panel record.
+     */
+    void DestroyPanel(ViewPanel& viewPanel);
+
     /**
      * @brief Loads bookmarks from storage.
      */
@@ -162,6 +283,46 @@ private:
      */
     void SaveBookmarks();
 
+    /**
+     * @brief Feeds a view's visits and page titles into the omnibox index.
+     * @param view The browser view.
+     */
+    void TrackHistory(BrowserView& view);
+
+    /**
+     * @brief Exposes bookmarks and omnibox suggestions to pages through the message bridge.
+     */
+    void RegisterBridgeMethods();
+
+    /**
+     * @brief Records a bookmark change; the save happens in a later Update().
+     */
+    void MarkBookmarksDirty();
+
+    /**
+     * @brief Writes the binary bookmarks cache.
+     * @param cachePath The cache file to write.
+     * @param sourcePath The JSON file the cache must match.
+     */
+    void WriteBookmarksCache(const std::filesystem::path& cachePath, const std::filesystem::path& sourcePath);
+
+    /**
+     * @brief Creates hidden browsers until the warm pool is full.
+     * @param maxCreate Maximum number of browsers to create in this call.
+     */
+    void RefillWarmPool(size_t maxCreate);
+
+    /**
+     * @brief Runs the periodic idle, budget and low-memory discard checks.
+     */
+    void CheckMemoryPressure();
+
+    /**
+     * @brief Gets the private bytes of all CEF child processes.
+     * @return Committed bytes across the renderer, GPU and utility processes.
+     */
+    static uint64_t GetRendererMemoryUsage();
+
     /**
      * @brief Log a message using the application logger.
      * @tparam Args Variadic template for format arguments.
@@ -170,14 +331,35 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                           ///< Reference to the main application
     
     std::unique_ptr<CefManager> m_cefManager;     ///< CEF manager instance
+    std::unique_ptr<PriceChecker> m_priceChecker; ///< Hotkey price checker, once enabled
+    std::unique_ptr<PriorityManager> m_priorityManager; ///< Process priority manager, once enabled
+    std::mutex m_priorityMutex;                   ///< Guards m_priorityManager against CEF's launch notifications
     std::vector<std::shared_ptr<BrowserView>> m_browserViews; ///< Active browser views
+    std::vector<std::shared_ptr<BrowserView>> m_warmViews; ///< Hidden, pre-created browser views
+    size_t m_warmPoolSize;                        ///< Number of browser views to keep warm
+    
+    // Composition
+    CompositeRenderer* m_compositor;              ///< Compositor hosting the views (not owned), or nullptr
+    std::unordered_map<const BrowserView*, ViewPanel> m_viewPanels; ///< Panel of each active view
+    
+    // Discarding
+    uint64_t m_memoryBudget;                      ///< Renderer private bytes allowed, 0 for no limit
+    std::chrono::seconds m_discardAfter;          ///< Hidden time after which a view is discarded, 0 to never
+    HANDLE m_lowMemoryNotification;               ///< System low-memory resource notification
+    bool m_lowMemory;                             ///< Whether the system reported low memory at the last check
+    std::chrono::steady_clock::time_point m_lastMemoryCheck; ///< Time of the last discard check
     
-    std::vector<Bookmark> m_bookmarks;            ///< List of bookmarks
+    BookmarkStore m_bookmarks;                    ///< Bookmarks, indexed by URL and folder
+    bool m_bookmarksDirty;                        ///< Whether bookmarks changed since the last save
+    std::chrono::steady_clock::time_point m_bookmarksChangedAt; ///< Time of the first unsaved change
+    OmniboxIndex m_omnibox;                       ///< Search index over bookmarks and history
     std::string m_homePage;                       ///< Home page URL
     std::string m_newTabPage;                     ///< New tab page URL
     std::string m_searchEngine;                   ///< Search engine URL pattern
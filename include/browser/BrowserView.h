@@ -1,15 +1,30 @@
 #pragma once
 
 #include <Windows.h>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <functional>
+#include <vector>
 #include <include/cef_browser.h>
+#include <include/cef_render_handler.h>
 #include "core/Application.h"
+#include "core/Logger.h"
 #include "browser/CefManager.h"
+#include "rendering/frame_mailbox.h"
 
 namespace poe {
 
+/**
+ * @struct FrameRatePolicy
+ * @brief Windowless frame rates a BrowserView renders at in each state.
+ */
+struct FrameRatePolicy {
+    int focused = 60;       ///< Frame rate while the view has input focus
+    int idle = 5;           ///< Frame rate while visible without focus
+    int hidden = 0;         ///< Frame rate while hidden; 0 stops rendering entirely
+};
+
 /**
  * @class BrowserView
  * @brief Integrates a CEF browser into the overlay window.
@@ -19,6 +34,27 @@ namespace poe {
  */
 class BrowserView {
 public:
+    /**
+     * @brief Type definition for paint callback function.
+     *
+     * Receives the full BGRA buffer, its dimensions, and the rectangles that
+     * changed since the previous paint, clamped to the buffer bounds.
+     */
+    using PaintCallback = std::function<void(const void*, int, int, const std::vector<RECT>&)>;
+
+    /**
+     * @brief Type definition for accelerated paint callback function.
+     *
+     * Receives the shared D3D11 texture handle produced by CEF when shared
+     * textures are enabled. The handle stays owned by CEF.
+     */
+    using AcceleratedPaintCallback = std::function<void(HANDLE)>;
+
+    /**
+     * @brief Callback type for history updates: URL, title, and whether the address changed.
+     */
+    using HistoryCallback = std::function<void(const std::string&, const std::string&, bool)>;
+
     /**
      * @brief Constructor for the BrowserView class.
      * @param app Reference to the main application instance.
@@ -42,9 +78,116 @@ public:
 
     /**
      * @brief Initializes the browser view.
+     * @param registerView Whether the shared CEF handlers route this view's
+     *        browser events to it; pre-warmed views register when handed out.
      * @return True if initialization succeeded, false otherwise.
      */
-    bool Initialize();
+    bool Initialize(bool registerView = true);
+
+    /**
+     * @brief Prepares a pooled view for a new owner.
+     * @param width Width of the browser view.
+     * @param height Height of the browser view.
+     * @param url URL to navigate to.
+     * @return True if the view has a live browser, false otherwise.
+     */
+    bool Acquire(int width, int height, const std::string& url);
+
+    /**
+     * @brief Returns the view to a blank, hidden state so it can be pooled.
+     */
+    void Reset();
+
+    /**
+     * @brief Checks if the view has a live browser.
+     * @return True if the browser exists, false otherwise.
+     */
+    bool IsInitialized() const { return m_browser != nullptr; }
+
+    /**
+     * @brief Asks the renderer for the scroll offset and discards once it arrives.
+     *
+     * Call Discard() directly if the reply does not come back in time.
+     */
+    void RequestDiscard();
+
+    /**
+     * @brief Closes the underlying browser, keeping URL, title and scroll offset.
+     *
+     * The browser is recreated on the next SetVisible(true) or Navigate().
+     */
+    void Discard();
+
+    /**
+     * @brief Handles the scroll offset reported by the renderer.
+     * @param x Horizontal scroll offset in CSS pixels.
+     * @param y Vertical scroll offset in CSS pixels.
+     */
+    void OnScrollPosition(int x, int y);
+
+    /**
+     * @brief Handles the close of this view's browser.
+     */
+    void OnBrowserClose();
+
+    /**
+     * @brief Handles loading state changes.
+     * @param isLoading Whether the browser is loading.
+     * @param canGoBack Whether the browser can go back.
+     * @param canGoForward Whether the browser can go forward.
+     */
+    void OnLoadingStateChange(bool isLoading, bool canGoBack, bool canGoForward);
+
+    /**
+     * @brief Handles title changes.
+     * @param title The new title.
+     */
+    void OnTitleChange(const std::string& title);
+
+    /**
+     * @brief Handles address changes.
+     * @param url The new URL.
+     */
+    void OnAddressChange(const std::string& url);
+
+    /**
+     * @brief Handles paint events of the view (not its popups).
+     * @param dirtyRects The rectangles that changed since the previous paint.
+     * @param buffer The pixel buffer.
+     * @param width The width of the buffer.
+     * @param height The height of the buffer.
+     */
+    void OnPaint(const CefRenderHandler::RectList& dirtyRects, const void* buffer, int width, int height);
+
+    /**
+     * @brief Handles shared-texture paint events of the view (not its popups).
+     * @param sharedHandle Shared handle of the texture produced by CEF.
+     */
+    void OnAcceleratedPaint(HANDLE sharedHandle);
+
+    /**
+     * @brief Checks if the view has been discarded.
+     * @return True if discarded, false otherwise.
+     */
+    bool IsDiscarded() const { return m_discarded; }
+
+    /**
+     * @brief Checks if a discard is waiting for the scroll offset.
+     * @return True if pending, false otherwise.
+     */
+    bool IsDiscardPending() const { return m_discardPending; }
+
+    /**
+     * @brief Gets when the pending discard was requested.
+     * @return Time of the last RequestDiscard() call.
+     */
+    std::chrono::steady_clock::time_point GetDiscardRequestTime() const { return m_discardRequestTime; }
+
+    /**
+     * @brief Gets when the view was last shown, focused or given input.
+     * @return Time of the last activity.
+     */
+    std::chrono::steady_clock::time_point GetLastActiveTime() const { return m_lastActiveTime; }
 
     /**
      * @brief Shuts down the browser view.
@@ -79,31 +222,96 @@ public:
      */
     void StopLoad();
 
+    /**
+     * @brief Asks for a full repaint, e.g. for a new or rebuilt surface.
+     */
+    void Invalidate();
+
     /**
      * @brief Resizes the browser view.
-     * @param width New width.
-     * @param height New height.
+     * @param width New width in device pixels.
+     * @param height New height in device pixels.
      */
     void Resize(int width, int height);
 
+    /**
+     * @brief Sets the device scale factor of the monitor showing the view.
+     *
+     * The page is laid out in DIPs and painted at the view's pixel size,
+     * so it stays sharp at any DPI. Mouse coordinates stay in device pixels.
+     * @param scaleFactor Device pixels per DIP (1.0 at 96 DPI).
+     */
+    void SetScaleFactor(float scaleFactor);
+
+    /**
+     * @brief Gets the device scale factor the view renders at.
+     * @return Device pixels per DIP.
+     */
+    float GetScaleFactor() const { return m_scaleFactor; }
+
     /**
      * @brief Sets the visibility of the browser view.
+     *
+     * Hidden views are throttled by Chromium itself, not just skipped at paint.
      * @param visible Whether the view should be visible.
      */
     void SetVisible(bool visible);
 
+    /**
+     * @brief Checks if the browser view is visible.
+     * @return True if visible, false otherwise.
+     */
+    bool IsVisible() const { return m_visible; }
+
+    /**
+     * @brief Sets whether the browser view has input focus.
+     *
+     * A visible view without focus renders at the policy's idle rate.
+     * @param focused Whether the view is focused.
+     */
+    void SetFocused(bool focused);
+
+    /**
+     * @brief Checks if the browser view has input focus.
+     * @return True if focused, false otherwise.
+     */
+    bool IsFocused() const { return m_focused; }
+
+    /**
+     * @brief Sets the frame rates used for each visibility and focus state.
+     * @param policy The frame-rate policy.
+     */
+    void SetFrameRatePolicy(const FrameRatePolicy& policy);
+
+    /**
+     * @brief Gets the frame-rate policy.
+     * @return The frame-rate policy.
+     */
+    const FrameRatePolicy& GetFrameRatePolicy() const { return m_frameRatePolicy; }
+
+    /**
+     * @brief Gets the frame rate for the current state.
+     * @return Frames per second, 0 if rendering is stopped.
+     */
+    int GetFrameRate() const;
+
     /**
      * @brief Handles a mouse move event.
-     * @param x X coordinate.
-     * @param y Y coordinate.
+     *
+     * Moves are coalesced: the first move after an idle interval is sent at
+     * once, and after that only the latest position within each interval
+     * (one frame, at most 16 ms) is sent, when the interval ends or before
+     * the next button or key event.
+     * @param x X coordinate in device pixels.
+     * @param y Y coordinate in device pixels.
      * @param modifiers Key modifiers.
      */
     void OnMouseMove(int x, int y, uint32_t modifiers);
 
     /**
      * @brief Handles a mouse click event.
-     * @param x X coordinate.
-     * @param y Y coordinate.
+     * @param x X coordinate in device pixels.
+     * @param y Y coordinate in device pixels.
      * @param button Button that was clicked.
      * @param modifiers Key modifiers.
      * @param isDown Whether the button is down.
@@ -112,8 +320,11 @@ public:
 
     /**
      * @brief Handles a mouse wheel event.
-     * @param x X coordinate.
-     * @param y Y coordinate.
+     *
+     * Coalesced like mouse moves: deltas arriving within one interval are
+     * summed into one event.
+     * @param x X coordinate in device pixels.
+     * @param y Y coordinate in device pixels.
      * @param deltaX Horizontal scroll amount.
      * @param deltaY Vertical scroll amount.
      */
@@ -134,6 +345,11 @@ public:
      */
     void OnChar(unsigned int character, uint32_t modifiers);
 
+    /**
+     * @brief Sends any coalesced mouse move and wheel input now.
+     */
+    void FlushInput();
+
     /**
      * @brief Gets the width of the browser view.
      * @return The width.
@@ -200,56 +416,95 @@ public:
         m_addressChangeCallback = callback; 
     }
 
+    /**
+     * @brief Sets the callback that records browsing history.
+     *
+     * Owned by BrowserInterface rather than the view's current user, so it
+     * survives Reset() when the view goes back to the warm pool.
+     * @param callback Called with the URL and title; the flag is true (and the title empty) for a new address.
+     */
+    void SetHistoryCallback(HistoryCallback callback) {
+        m_historyCallback = callback;
+    }
+
     /**
      * @brief Sets the callback for paint events.
+     *
+     * The callback runs synchronously on the CEF UI thread; prefer
+     * GetFrameMailbox() for anything that may be slow.
      * @param callback The callback function.
      */
-    void SetPaintCallback(std::function<void(const void*, int, int)> callback) { 
+    void SetPaintCallback(PaintCallback callback) { 
         m_paintCallback = callback; 
     }
 
+    /**
+     * @brief Gets the mailbox holding the newest painted frame.
+     *
+     * The compositor acquires frames from here on its own thread instead of
+     * consuming the paint callback on the CEF UI thread.
+     * @return Reference to the frame mailbox.
+     */
+    FrameMailbox& GetFrameMailbox() { return m_frameMailbox; }
+
+    /**
+     * @brief Sets the callback for shared-texture paint events.
+     * @param callback The callback function.
+     */
+    void SetAcceleratedPaintCallback(AcceleratedPaintCallback callback) { 
+        m_acceleratedPaintCallback = callback; 
+    }
+
 private:
     /**
-     * @brief Handles browser creation.
-     * @param browser The created browser.
+     * @brief Sends pending input now if no interval is running, otherwise
+     * leaves it for the flush at the end of the interval.
      */
-    void OnBrowserCreated(CefRefPtr<CefBrowser> browser);
+    void ScheduleInputFlush();
 
     /**
-     * @brief Handles browser close.
-     * @param browser The browser being closed.
+     * @brief Posts the flush that ends the current input interval.
      */
-    void OnBrowserClose(CefRefPtr<CefBrowser> browser);
+    void PostInputFlush();
 
     /**
-     * @brief Handles loading state changes.
-     * @param isLoading Whether the browser is loading.
-     * @param canGoBack Whether the browser can go back.
-     * @param canGoForward Whether the browser can go forward.
+     * @brief Recreates the browser of a discarded view at its saved URL.
+     * @return True if the browser was recreated, false otherwise.
      */
-    void OnLoadingStateChange(bool isLoading, bool canGoBack, bool canGoForward);
+    bool Restore();
 
     /**
-     * @brief Handles title changes.
-     * @param title The new title.
+     * @brief Records user-visible activity for the discard LRU.
      */
-    void OnTitleChange(const std::string& title);
+    void Touch() { m_lastActiveTime = std::chrono::steady_clock::now(); }
 
     /**
-     * @brief Handles address changes.
-     * @param url The new URL.
+     * @brief Reads the default frame-rate policy from settings.
+     * @return The frame-rate policy.
      */
-    void OnAddressChange(const std::string& url);
+    FrameRatePolicy LoadFrameRatePolicy() const;
 
     /**
-     * @brief Handles paint events.
-     * @param buffer The pixel buffer.
-     * @param width The width of the buffer.
-     * @param height The height of the buffer.
-     * @param x The x coordinate of the painted area.
-     * @param y The y coordinate of the painted area.
+     * @brief Pushes the current frame rate and hidden state to the browser host.
+     */
+    void ApplyFrameRate();
+
+    /**
+     * @brief Registers this view's browser with the shared CEF handlers.
+     */
+    void RegisterWithHandlers();
+
+    /**
+     * @brief Stops the shared CEF handlers from routing events to this view.
+     */
+    void UnregisterFromHandlers();
+
+    /**
+     * @brief Converts a device pixel coordinate to the DIPs CEF expects.
+     * @param pixels Coordinate in device pixels.
+     * @return Coordinate in DIPs.
      */
-    void OnPaint(const void* buffer, int width, int height, int x, int y);
+    int ToDips(int pixels) const;
 
     /**
      * @brief Log a message using the application logger.
@@ -259,7 +514,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                            ///< Reference to the main application
     CefManager& m_cefManager;                      ///< Reference to the CEF manager
@@ -268,7 +525,21 @@ private:
     
     int m_width;                                   ///< Width of the browser view
     int m_height;                                  ///< Height of the browser view
+    float m_scaleFactor;                           ///< Device pixels per DIP
     bool m_visible;                                ///< Whether the browser view is visible
+    bool m_focused;                                ///< Whether the browser view has input focus
+    FrameRatePolicy m_frameRatePolicy;             ///< Frame rates per visibility and focus state
+    int m_appliedFrameRate;                        ///< Frame rate last set on the host, -1 if none
+    bool m_hostHidden;                             ///< Hidden state last set on the host
+    
+    // Discard state
+    bool m_discarded;                              ///< Whether the browser was closed to save memory
+    bool m_discardPending;                         ///< Whether a discard waits for the scroll offset
+    bool m_restoreScroll;                          ///< Whether to reapply the scroll offset after loading
+    int m_scrollX;                                 ///< Saved horizontal scroll offset
+    int m_scrollY;                                 ///< Saved vertical scroll offset
+    std::chrono::steady_clock::time_point m_discardRequestTime; ///< When the pending discard was requested
+    std::chrono::steady_clock::time_point m_lastActiveTime;     ///< Last activity, for the discard LRU
     
     // Current browser state
     std::string m_currentUrl;                      ///< Current URL
@@ -281,7 +552,22 @@ private:
     std::function<void(bool, bool, bool)> m_navigationStateCallback; ///< Callback for navigation state changes
     std::function<void(const std::string&)> m_titleChangeCallback;   ///< Callback for title changes
     std::function<void(const std::string&)> m_addressChangeCallback; ///< Callback for address changes
-    std::function<void(const void*, int, int)> m_paintCallback;      ///< Callback for paint events
+    PaintCallback m_paintCallback;                                   ///< Callback for paint events
+    AcceleratedPaintCallback m_acceleratedPaintCallback;             ///< Callback for shared-texture paint events
+    HistoryCallback m_historyCallback;                               ///< Callback recording visits and titles
+    
+    // Coalesced input
+    CefMouseEvent m_pendingMove;                                     ///< Latest mouse move not yet sent
+    CefMouseEvent m_pendingWheel;                                    ///< Position of the wheel events not yet sent
+    int m_pendingWheelX;                                             ///< Summed horizontal wheel delta not yet sent
+    int m_pendingWheelY;                                             ///< Summed vertical wheel delta not yet sent
+    bool m_hasPendingMove;                                           ///< Whether m_pendingMove holds a move
+    bool m_hasPendingWheel;                                          ///< Whether wheel deltas are pending
+    bool m_inputFlushScheduled;                                      ///< Whether a flush task is posted
+    std::shared_ptr<int> m_inputToken;                               ///< Lets posted flush tasks detect a destroyed view
+    
+    std::vector<RECT> m_dirtyRects;                                  ///< Reused dirty rect list passed to the paint callback
+    FrameMailbox m_frameMailbox;                                     ///< Latest frame handed to the compositor
 };
 
 } // namespace poe
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <include/cef_request_handler.h>
+#include "core/Application.h"
+#include "browser/HttpCache.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @struct CachedHostPolicy
+ * @brief Remote endpoint whose GET responses go through the HTTP cache.
+ */
+struct CachedHostPolicy {
+    std::string_view host;              ///< Host name, matched exactly
+    std::string_view pathPrefix;        ///< Only paths starting with this are cached
+    int64_t defaultMaxAge;              ///< Freshness used when the response has no max-age
+    int64_t defaultStaleWhileRevalidate; ///< Stale window used when the response has none
+};
+
+/**
+ * @class CachingRequestHandler
+ * @brief Request handler that serves repeated API traffic from the HttpCache.
+ *
+ * Only GET requests to the hosts in the policy table are intercepted.
+ * Fresh entries are answered locally, stale ones within their
+ * stale-while-revalidate window are answered locally while a conditional
+ * request refreshes them in the background, and expired ones with an ETag
+ * or Last-Modified are revalidated before being served from the cache on
+ * a 304. Everything else goes to the network with the response teed into
+ * the cache on the way through.
+ */
+class CachingRequestHandler : public CefRequestHandler {
+public:
+    /**
+     * @brief Constructor for the CachingRequestHandler class.
+     * @param app Reference to the main application instance.
+     * @param cache The response cache; shared so queued cache writes can outlive the handler.
+     */
+    CachingRequestHandler(Application& app, std::shared_ptr<HttpCache> cache);
+
+    // CefRequestHandler methods
+    CefRefPtr<CefResourceRequestHandler> GetResourceRequestHandler(
+        CefRefPtr<CefBrowser> browser,
+        CefRefPtr<CefFrame> frame,
+        CefRefPtr<CefRequest> request,
+        bool is_navigation,
+        bool is_download,
+        const CefString& request_initiator,
+        bool& disable_default_handling) override;
+
+    /**
+     * @brief Finds the cache policy for a URL.
+     * @param url The request URL.
+     * @return The matching policy, or nullptr if the URL is not cached.
+     */
+    static const CachedHostPolicy* FindPolicy(const std::string& url);
+
+private:
+    // Required for IMPLEMENT_REFCOUNTING
+    IMPLEMENT_REFCOUNTING(CachingRequestHandler);
+
+    Application& m_app;                       ///< Reference to the main application
+    std::shared_ptr<HttpCache> m_cache;       ///< Response cache
+};
+
+} // namespace poe
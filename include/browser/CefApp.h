@@ -38,6 +38,7 @@ public:
     // CefBrowserProcessHandler methods
     void OnContextInitialized() override;
     void OnBeforeChildProcessLaunch(CefRefPtr<CefCommandLine> command_line) override;
+    void OnScheduleMessagePumpWork(int64 delay_ms) override;
 
     // CefRenderProcessHandler methods
     void OnContextCreated(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefV8Context> context) override;
@@ -10,6 +10,7 @@
 #include <include/cef_app.h>
 #include <include/cef_client.h>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
@@ -17,6 +18,10 @@ namespace poe {
 class BrowserHandler;
 class BrowserClient;
 class RenderHandler;
+class HttpCache;
+class CachingRequestHandler;
+class CefMessagePump;
+class MessageBridge;
 
 /**
  * @class CefManager
@@ -39,11 +44,26 @@ public:
         bool persistSessionCookies = true; ///< Whether to persist session cookies
         bool persistUserPreferences = true; ///< Whether to persist user preferences
         bool enableOffscreenRendering = true; ///< Whether to enable offscreen rendering
-        int backgroundProcessPriority = 0; ///< Priority for background processes
+        bool enableSharedTextures = false; ///< Whether to render into shared D3D11 textures (OnAcceleratedPaint)
+        int backgroundProcessPriority = 0; ///< Scheduling class of CEF child processes (0=normal, 1=below normal, 2=background mode)
+        bool lowFootprint = false;       ///< Whether unset process limits below take the low-footprint profile
+        int rendererProcessLimit = 0;    ///< Maximum number of renderer processes (0=Chromium default)
+        int v8HeapLimitMB = 0;           ///< V8 old-space limit per renderer in MB (0=V8 default)
+        bool processPerSite = false;     ///< Whether all pages of a site share one renderer process
         std::string logFile;             ///< Path to the log file
         int logSeverity = 0;             ///< Log severity (0=default, 1=verbose, 2=info, 3=warning, 4=error, 5=fatal)
+        bool enableHttpCache = true;     ///< Whether to cache trade/poe.ninja API responses
+        std::string httpCachePath;       ///< Directory of the API response cache
+        int httpCacheMemoryMB = 16;      ///< In-memory budget of the API response cache
+        int httpCacheDiskMB = 256;       ///< On-disk budget of the API response cache
+        bool externalMessagePump = true; ///< Whether CEF schedules its own work instead of being pumped per update
     };
 
+    /**
+     * @brief Callback invoked just before CEF launches a child process.
+     */
+    using ChildProcessLaunchCallback = std::function<void()>;
+
     /**
      * @brief Constructor for the CefManager class.
      * @param app Reference to the main application instance.
@@ -97,10 +117,19 @@ public:
 
     /**
      * @brief Processes CEF events.
-     * @param blocking Whether to block until there are no pending events.
+     *
+     * Does nothing with the external message pump, where CEF work is run
+     * from the Win32 message loop whenever CEF schedules it.
+     * @param blocking Whether to run the CEF message loop until CefQuitMessageLoop().
      */
     void ProcessEvents(bool blocking = false);
 
+    /**
+     * @brief Forwards a CEF work request to the external message pump. Thread-safe.
+     * @param delayMs Delay in milliseconds before the work should run.
+     */
+    void ScheduleMessagePumpWork(int64_t delayMs);
+
     /**
      * @brief Gets the browser handler.
      * @return Reference to the browser handler.
@@ -119,19 +148,43 @@ public:
      */
     RenderHandler* GetRenderHandler() const { return m_renderHandler.get(); }
 
+    /**
+     * @brief Gets the JS to native message bridge.
+     * @return Pointer to the bridge, or nullptr before Initialize().
+     */
+    MessageBridge* GetMessageBridge() const { return m_messageBridge.get(); }
+
     /**
      * @brief Gets the CEF configuration.
      * @return Reference to the CEF configuration.
      */
     const CefConfig& GetConfig() const { return m_config; }
 
-private:
+    /**
+     * @brief Sets the callback told about child process launches, e.g. PriorityManager::NotifyChildProcessLaunch.
+     *
+     * Must be set before Initialize(). It is invoked on the CEF UI thread for renderers
+     * and on the IO thread for other children, so it must be thread-safe.
+     * @param callback The callback, or nullptr to clear it.
+     */
+    void SetChildProcessLaunchCallback(ChildProcessLaunchCallback callback) { m_childProcessLaunchCallback = std::move(callback); }
+
+    /**
+     * @brief Called by CefApp::OnBeforeChildProcessLaunch.
+     */
+    void NotifyChildProcessLaunch();
+
     /**
      * @brief Initializes CEF command line arguments.
+     *
+     * Called from CefApp::OnBeforeCommandLineProcessing for the browser
+     * process; Chromium forwards the relevant switches to its children.
      * @param args Command line arguments to initialize.
      */
     void InitCommandLineArgs(CefRefPtr<CefCommandLine> args);
 
+private:
+
     /**
      * @brief Log a message using the application logger.
      * @tparam Args Variadic template for format arguments.
@@ -140,7 +193,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                             ///< Reference to the main application
     CefConfig m_config;                             ///< CEF configuration parameters
@@ -150,6 +205,11 @@ private:
     std::unique_ptr<BrowserHandler> m_browserHandler; ///< Handler for browser events
     std::unique_ptr<BrowserClient> m_browserClient;   ///< CEF client implementation
     std::unique_ptr<RenderHandler> m_renderHandler;   ///< Handler for rendering
+    std::unique_ptr<MessageBridge> m_messageBridge;   ///< JS to native bridge shared by all browsers
+    std::shared_ptr<HttpCache> m_httpCache;           ///< API response cache, or null if disabled
+    CefRefPtr<CachingRequestHandler> m_requestHandler; ///< Request handler serving from m_httpCache
+    std::unique_ptr<CefMessagePump> m_messagePump;    ///< External message pump, or null when pumped per update
+    ChildProcessLaunchCallback m_childProcessLaunchCallback; ///< Told about child process launches
     
     mutable std::mutex m_browsersMutex;             ///< Mutex for thread-safe access to browsers
     std::vector<CefRefPtr<CefBrowser>> m_browsers;  ///< List of active browsers
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Windows.h>
+#include <atomic>
+#include <cstdint>
+
+namespace poe {
+
+/**
+ * @class CefMessagePump
+ * @brief Drives CEF's external message pump from the overlay's Win32 message loop.
+ *
+ * CEF asks for work through CefBrowserProcessHandler::OnScheduleMessagePumpWork,
+ * from any thread. The request is posted to a message-only window owned by
+ * the CEF UI thread, which runs CefDoMessageLoopWork() either immediately or
+ * when a non-coalescing timer for the requested delay fires. CEF work then
+ * runs when Chromium needs it instead of once per overlay frame.
+ */
+class CefMessagePump {
+public:
+    /**
+     * @brief Constructor for the CefMessagePump class.
+     */
+    CefMessagePump();
+
+    /**
+     * @brief Destructor for the CefMessagePump class.
+     */
+    ~CefMessagePump();
+
+    // Non-copyable
+    CefMessagePump(const CefMessagePump&) = delete;
+    CefMessagePump& operator=(const CefMessagePump&) = delete;
+
+    /**
+     * @brief Creates the pump window on the calling thread.
+     *
+     * Must be called on the thread that calls CefInitialize, before it does.
+     * @return True if the window was created, false otherwise.
+     */
+    bool Initialize();
+
+    /**
+     * @brief Destroys the pump window; later work requests are dropped.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Schedules a call to CefDoMessageLoopWork(). Thread-safe.
+     * @param delayMs Delay in milliseconds; 0 or less runs the work as soon as possible.
+     */
+    void ScheduleWork(int64_t delayMs);
+
+private:
+    /**
+     * @brief Window procedure of the pump window.
+     */
+    static LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
+
+    /**
+     * @brief Handles a work request on the UI thread.
+     * @param delayMs Delay in milliseconds.
+     */
+    void HandleScheduleWork(int64_t delayMs);
+
+    /**
+     * @brief Runs CEF work and arms the fallback timer.
+     */
+    void DoWork();
+
+    /**
+     * @brief Calls CefDoMessageLoopWork() unless it is already on the stack.
+     * @return True if CEF re-entered the pump and asked for more work meanwhile.
+     */
+    bool PerformMessageLoopWork();
+
+    /**
+     * @brief Arms the work timer, replacing any pending one.
+     * @param delayMs Delay in milliseconds.
+     */
+    void SetTimer(int64_t delayMs);
+
+    /**
+     * @brief Cancels the work timer.
+     */
+    void KillTimer();
+
+    std::atomic<HWND> m_window;      ///< Message-only window receiving work requests
+    bool m_timerPending;             ///< Whether the work timer is armed
+    bool m_isActive;                 ///< Whether CefDoMessageLoopWork() is on the stack
+    bool m_reentrancyDetected;       ///< Whether work was requested while active
+};
+
+} // namespace poe
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "core/Application.h"
+#include "core/Logger.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @struct HttpCachePolicy
+ * @brief Freshness rules for a cached response.
+ */
+struct HttpCachePolicy {
+    bool noStore = false;               ///< Whether the response must not be stored
+    int64_t maxAge = 0;                 ///< Seconds the response stays fresh
+    int64_t staleWhileRevalidate = 0;   ///< Seconds past maxAge it may be served while revalidating
+};
+
+/**
+ * @enum HttpCacheFreshness
+ * @brief How a cached response may be used.
+ */
+enum class HttpCacheFreshness {
+    Fresh,      ///< Serve from the cache
+    Stale,      ///< Serve from the cache and revalidate in the background
+    Expired     ///< Go to the network
+};
+
+/**
+ * @struct HttpCacheEntry
+ * @brief Metadata of a cached response; the body lives in a content-addressed blob.
+ */
+struct HttpCacheEntry {
+    std::string url;                    ///< Request URL, the cache key
+    int status = 200;                   ///< HTTP status code
+    std::string statusText;             ///< HTTP status text
+    std::string mimeType;               ///< MIME type of the body
+    std::string charset;                ///< Character set of the body
+    std::string etag;                   ///< ETag validator, if any
+    std::string lastModified;           ///< Last-Modified validator, if any
+    std::vector<std::pair<std::string, std::string>> headers; ///< Replayed response headers
+    uint64_t bodyHash = 0;              ///< Content address of the body
+    uint64_t bodySize = 0;              ///< Body size in bytes
+    int64_t storedAt = 0;               ///< Unix time the response was stored or last revalidated
+    int64_t lastUsed = 0;               ///< Unix time the entry was last served
+    HttpCachePolicy policy;             ///< Freshness rules
+};
+
+/**
+ * @class HttpCache
+ * @brief On-disk HTTP response store with an in-memory LRU front.
+ *
+ * Bodies are written once per distinct content under blobs/, named by
+ * their hash, so identical responses from different URLs share storage.
+ * The URL index is kept in memory and persisted as JSON. Recently used
+ * bodies are held in memory up to a byte budget; older ones are read back
+ * from disk on demand. All methods are thread-safe; LoadBody and Store
+ * may touch the disk and belong on a worker thread.
+ */
+class HttpCache {
+public:
+    /**
+     * @brief Constructor for the HttpCache class.
+     * @param app Reference to the main application instance.
+     */
+    explicit HttpCache(Application& app);
+
+    /**
+     * @brief Destructor for the HttpCache class.
+     */
+    ~HttpCache();
+
+    // Non-copyable
+    HttpCache(const HttpCache&) = delete;
+    HttpCache& operator=(const HttpCache&) = delete;
+
+    /**
+     * @brief Opens the cache directory and loads its index.
+     * @param directory Directory holding the index and blobs.
+     * @param memoryBudget Maximum bytes of bodies kept in memory.
+     * @param diskBudget Maximum bytes of bodies kept on disk.
+     * @return True if initialization succeeded, false otherwise.
+     */
+    bool Initialize(const std::filesystem::path& directory, uint64_t memoryBudget, uint64_t diskBudget);
+
+    /**
+     * @brief Persists the index and releases the in-memory bodies.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Looks up the metadata for a URL without touching the disk.
+     * @param url The request URL.
+     * @return The entry, or std::nullopt if the URL is not cached.
+     */
+    std::optional<HttpCacheEntry> Find(const std::string& url);
+
+    /**
+     * @brief Gets the body of an entry, from memory or from disk.
+     * @param entry The entry returned by Find.
+     * @return The body, or nullptr if the blob is missing.
+     */
+    std::shared_ptr<const std::string> LoadBody(const HttpCacheEntry& entry);
+
+    /**
+     * @brief Stores a response, replacing any previous entry for its URL.
+     * @param entry The response metadata; bodyHash and bodySize are filled in.
+     * @param body The response body.
+     */
+    void Store(HttpCacheEntry entry, std::string body);
+
+    /**
+     * @brief Marks an entry as revalidated (HTTP 304).
+     * @param url The request URL.
+     * @param policy Freshness rules from the revalidation response.
+     * @param headers Headers of the revalidation response, merged into the stored ones.
+     * @return The refreshed entry, or std::nullopt if the URL is no longer cached.
+     */
+    std::optional<HttpCacheEntry> Refresh(
+        const std::string& url,
+        const HttpCachePolicy& policy,
+        const std::vector<std::pair<std::string, std::string>>& headers);
+
+    /**
+     * @brief Drops the entry for a URL.
+     * @param url The request URL.
+     */
+    void Remove(const std::string& url);
+
+    /**
+     * @brief Claims the background revalidation of a URL.
+     * @param url The request URL.
+     * @return True if the caller should revalidate, false if one is already running.
+     */
+    bool BeginRevalidation(const std::string& url);
+
+    /**
+     * @brief Releases a claim taken with BeginRevalidation.
+     * @param url The request URL.
+     */
+    void EndRevalidation(const std::string& url);
+
+    /**
+     * @brief Classifies an entry against the current time.
+     * @param entry The entry.
+     * @return How the entry may be used.
+     */
+    static HttpCacheFreshness GetFreshness(const HttpCacheEntry& entry);
+
+    /**
+     * @brief Parses a Cache-Control header value.
+     * @param header The header value.
+     * @return The parsed policy; fields not present stay at their defaults.
+     */
+    static HttpCachePolicy ParseCacheControl(std::string_view header);
+
+private:
+    /**
+     * @struct MemoryEntry
+     * @brief A body held in the in-memory LRU.
+     */
+    struct MemoryEntry {
+        std::shared_ptr<const std::string> body;    ///< The body
+        std::list<uint64_t>::iterator position;     ///< Position in m_memoryOrder
+    };
+
+    /**
+     * @brief Gets the current Unix time.
+     * @return Seconds since the epoch.
+     */
+    static int64_t Now();
+
+    /**
+     * @brief Hashes a body to its content address.
+     * @param body The body.
+     * @return 64-bit FNV-1a hash.
+     */
+    static uint64_t HashBody(std::string_view body);
+
+    /**
+     * @brief Gets the blob file for a content address.
+     * @param hash The body hash.
+     * @return Path below the blobs directory.
+     */
+    std::filesystem::path GetBlobPath(uint64_t hash) const;
+
+    /**
+     * @brief Inserts a body at the front of the memory LRU, evicting as needed.
+     * Caller must hold m_mutex.
+     * @param hash The body hash.
+     * @param body The body.
+     */
+    void Remember(uint64_t hash, std::shared_ptr<const std::string> body);
+
+    /**
+     * @brief Removes an entry, deleting its blob once no entry refers to it.
+     * Caller must hold m_mutex.
+     * @param it The entry to remove.
+     */
+    void EraseEntry(std::unordered_map<std::string, HttpCacheEntry>::iterator it);
+
+    /**
+     * @brief Evicts least recently used entries until the disk budget is met.
+     * Caller must hold m_mutex.
+     */
+    void EnforceDiskBudget();
+
+    /**
+     * @brief Loads the index from disk.
+     */
+    void LoadIndex();
+
+    /**
+     * @brief Writes the index to disk. Caller must hold m_mutex.
+     */
+    void SaveIndex();
+
+    /**
+     * @brief Log a message using the application logger.
+     * @tparam Args Variadic template for format arguments.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string.
+     * @param args Format arguments.
+     */
+    template<typename... Args>
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    Application& m_app;                         ///< Reference to the main application
+    std::filesystem::path m_directory;          ///< Cache directory
+    uint64_t m_memoryBudget;                    ///< Byte budget of the memory LRU
+    uint64_t m_diskBudget;                      ///< Byte budget of the blobs on disk
+    bool m_initialized;                         ///< Whether the cache is initialized
+
+    mutable std::mutex m_mutex;                 ///< Guards everything below
+    std::unordered_map<std::string, HttpCacheEntry> m_entries; ///< URL index
+    std::unordered_map<uint64_t, uint32_t> m_blobRefs; ///< Entries referring to each blob
+    uint64_t m_diskBytes;                       ///< Bytes of distinct blobs on disk
+    std::unordered_map<uint64_t, MemoryEntry> m_memory; ///< Bodies held in memory
+    std::list<uint64_t> m_memoryOrder;          ///< Memory LRU order, most recent first
+    uint64_t m_memoryBytes;                     ///< Bytes of bodies held in memory
+    std::unordered_set<std::string> m_revalidating; ///< URLs being revalidated
+    int64_t m_lastIndexSave;                    ///< Unix time of the last index write
+};
+
+} // namespace poe
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace poe {
+
+/**
+ * @enum ItemRarity
+ * @brief Rarity line of a copied item, which also tells the kind of item.
+ */
+enum class ItemRarity : uint8_t {
+    Unknown,         ///< Missing or unrecognized rarity
+    Normal,          ///< White item
+    Magic,           ///< Blue item
+    Rare,            ///< Yellow item
+    Unique,          ///< Unique item
+    Gem,             ///< Skill or support gem
+    Currency,        ///< Stackable currency, fragments, oils, essences, ...
+    DivinationCard   ///< Divination card
+};
+
+/**
+ * @struct ParsedItem
+ * @brief The parts of a copied item that decide its price.
+ */
+struct ParsedItem {
+    ItemRarity rarity = ItemRarity::Unknown; ///< Rarity or kind of the item
+    std::string itemClass;                   ///< "Item Class:" value, empty on clients that do not print it
+    std::string name;                        ///< Unique or rare name; the base type for items without one
+    std::string baseType;                    ///< Base type, without the "Superior" prefix
+    uint16_t itemLevel = 0;                  ///< Item level, or 0 if not shown
+    uint16_t stackSize = 0;                  ///< Items in the stack, or 0 if not stackable
+    uint8_t gemLevel = 0;                    ///< Gem level, or 0 for other items
+    uint8_t quality = 0;                     ///< Quality in percent
+    uint8_t sockets = 0;                     ///< Number of sockets
+    uint8_t links = 0;                       ///< Size of the largest linked group
+    bool corrupted = false;                  ///< Whether the item is corrupted
+    bool identified = true;                  ///< Whether the item is identified
+};
+
+/**
+ * @class ItemParser
+ * @brief Parses the text the game puts on the clipboard for Ctrl+C on an item.
+ *
+ * The text is a list of sections separated by "--------" lines. The first
+ * one holds the item class, the rarity and one or two name lines; the
+ * properties used for pricing are "key: value" lines or bare flags
+ * ("Corrupted", "Unidentified") in the sections after it.
+ */
+class ItemParser {
+public:
+    /**
+     * @brief Parses copied item text.
+     * @param text Clipboard text, with either line ending.
+     * @param item Receives the parsed item.
+     * @return False if the text is not an item.
+     */
+    static bool Parse(std::string_view text, ParsedItem& item);
+
+    /**
+     * @brief Gets the name of a rarity as the game prints it.
+     * @param rarity The rarity.
+     * @return The name, e.g. "Divination Card".
+     */
+    static const char* RarityToString(ItemRarity rarity);
+};
+
+} // namespace poe
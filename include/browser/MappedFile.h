@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Windows.h>
+#include <filesystem>
+#include <string_view>
+#include "core/MemoryTracker.h"
+
+namespace poe {
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a file on disk.
+ * 
+ * The file contents are paged in by the OS as they are touched, so large
+ * files can be served without first copying them onto the heap.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Constructor for the MappedFile class.
+     */
+    MappedFile();
+
+    /**
+     * @brief Destructor for the MappedFile class.
+     */
+    ~MappedFile();
+
+    // Non-copyable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Movable
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Maps a file for reading, replacing any existing mapping.
+     * @param path The file to map.
+     * @return True if the file was mapped, false otherwise.
+     */
+    bool Open(const std::filesystem::path& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void Close();
+
+    /**
+     * @brief Checks whether a file is mapped.
+     * @return True if a file is mapped, false otherwise.
+     */
+    bool IsOpen() const { return m_fileHandle != INVALID_HANDLE_VALUE; }
+
+    /**
+     * @brief Gets a view over the mapped bytes.
+     * @return The file contents; empty for empty or unmapped files.
+     */
+    std::string_view GetView() const { return std::string_view(m_view, m_size); }
+
+private:
+    HANDLE m_fileHandle;     ///< Handle of the mapped file
+    HANDLE m_mappingHandle;  ///< File mapping object, or nullptr for empty files
+    const char* m_view;      ///< Start of the mapped view
+    size_t m_size;           ///< Size of the mapped view in bytes
+    MemoryCharge m_charge;   ///< m_size, charged to the resources
+};
+
+} // namespace poe
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <include/cef_browser.h>
+#include <include/wrapper/cef_message_router.h>
+#include <nlohmann/json.hpp>
+#include "core/Application.h"
+#include "core/Logger.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @struct BridgeReply
+ * @brief Result of a native method called from a page.
+ */
+struct BridgeReply {
+    nlohmann::json value;          ///< Result handed to the page as a JSON value
+    std::vector<uint8_t> buffer;   ///< Raw result, handed to the page as an ArrayBuffer instead of value when non-empty
+    std::string error;             ///< Failure message; the call fails if non-empty
+};
+
+/**
+ * @class MessageBridge
+ * @brief Browser half of the JS to native bridge, built on CefMessageRouter.
+ *
+ * Pages call poe.call(method, params) or poe.batch(calls), see
+ * bridge::kExtensionCode. Each query carries either one call or a batch of
+ * them, which are dispatched to the registered methods in order and
+ * answered with a single reply. Binary results skip JSON entirely: the
+ * bytes travel to the renderer as a CefBinaryValue and are exposed to the
+ * page as an ArrayBuffer over the received memory.
+ *
+ * Native code pushes to pages with Publish(); pages listen with
+ * poe.subscribe(topic, callback), which holds a persistent query open
+ * until the page unsubscribes, navigates away or closes.
+ *
+ * All methods are called on the CEF UI thread.
+ */
+class MessageBridge : public CefMessageRouterBrowserSide::Handler {
+public:
+    /**
+     * @brief Native method callable from pages.
+     */
+    using MethodHandler = std::function<BridgeReply(const nlohmann::json& params)>;
+
+    /**
+     * @brief Constructor for the MessageBridge class.
+     * @param app Reference to the main application instance.
+     */
+    explicit MessageBridge(Application& app);
+
+    /**
+     * @brief Destructor for the MessageBridge class.
+     */
+    ~MessageBridge() override;
+
+    // Non-copyable
+    MessageBridge(const MessageBridge&) = delete;
+    MessageBridge& operator=(const MessageBridge&) = delete;
+
+    /**
+     * @brief Registers a method, replacing any with the same name.
+     * @param name Name pages call the method by, e.g. "prices.table".
+     * @param handler The method.
+     */
+    void RegisterMethod(const std::string& name, MethodHandler handler);
+
+    /**
+     * @brief Unregisters a method.
+     * @param name Name of the method.
+     */
+    void UnregisterMethod(const std::string& name);
+
+    /**
+     * @brief Sends a value to every page subscribed to a topic.
+     * @param topic The topic, e.g. "priceCheck".
+     * @param value The value the subscribers' callbacks receive.
+     */
+    void Publish(const std::string& topic, const nlohmann::json& value);
+
+    /**
+     * @brief Offers a renderer message to the router.
+     * @return True if the message was a bridge message.
+     */
+    bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+        CefProcessId source_process, CefRefPtr<CefProcessMessage> message);
+
+    /**
+     * @brief Cancels the queries of a closing browser.
+     * @param browser The browser.
+     */
+    void OnBeforeClose(CefRefPtr<CefBrowser> browser);
+
+    /**
+     * @brief Cancels the queries of a frame that navigates away.
+     * @param browser The browser.
+     * @param frame The frame.
+     */
+    void OnBeforeBrowse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame);
+
+    /**
+     * @brief Cancels the queries and subscriptions of a browser whose renderer died.
+     * @param browser The browser.
+     */
+    void OnRenderProcessTerminated(CefRefPtr<CefBrowser> browser);
+
+    // CefMessageRouterBrowserSide::Handler methods
+    bool OnQuery(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, int64 query_id,
+        const CefString& request, bool persistent, CefRefPtr<Callback> callback) override;
+    void OnQueryCanceled(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, int64 query_id) override;
+
+private:
+    /**
+     * @brief A page listening to a topic through a persistent query.
+     */
+    struct Subscription {
+        int64 queryId;                   ///< Router query ID, unique across browsers
+        int browserId;                   ///< Browser that subscribed
+        std::string topic;               ///< Topic listened to
+        CefRefPtr<Callback> callback;    ///< Callback answering the query, once per published value
+    };
+
+    /**
+     * @brief Drops every subscription of a browser.
+     * @param browserId The browser ID.
+     */
+    void DropSubscriptions(int browserId);
+
+    /**
+     * @brief Runs one call.
+     * @param call Object with "method" and optional "params".
+     * @return The method's reply, or an error reply.
+     */
+    BridgeReply Dispatch(const nlohmann::json& call);
+
+    /**
+     * @brief Turns a reply into its JSON form, sending any binary result ahead of it.
+     * @param reply The reply; its buffer is consumed.
+     * @param frame The frame the reply goes to.
+     * @return {"value": ...}, {"buffer": token} or {"error": ...}.
+     */
+    nlohmann::json EncodeReply(BridgeReply& reply, CefRefPtr<CefFrame> frame);
+
+    /**
+     * @brief Log a message using the application logger.
+     * @tparam Args Variadic template for format arguments.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string.
+     * @param args Format arguments.
+     */
+    template<typename... Args>
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    Application& m_app;                                       ///< Reference to the main application
+    CefRefPtr<CefMessageRouterBrowserSide> m_router;          ///< Router delivering queries to OnQuery
+    std::unordered_map<std::string, MethodHandler> m_methods; ///< Registered methods by name
+    std::vector<Subscription> m_subscriptions;                ///< Open subscriptions
+    int m_nextBufferToken;                                    ///< Token of the next binary result
+};
+
+} // namespace poe
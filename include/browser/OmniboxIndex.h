@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "browser/BookmarkStore.h"
+
+namespace poe {
+
+/**
+ * @struct OmniboxMatch
+ * @brief One suggestion for typed omnibox text.
+ */
+struct OmniboxMatch {
+    std::string title;     ///< Bookmark name, or page title for history
+    std::string url;       ///< URL to navigate to
+    std::string folder;    ///< Bookmark folder; empty for history
+    bool bookmarked;       ///< Whether the URL is bookmarked
+    int score;             ///< Ranking score; higher is better
+};
+
+/**
+ * @class OmniboxIndex
+ * @brief In-memory search index over bookmarks and visited pages.
+ *
+ * Every URL is one entry, whether it came from a bookmark, a visit or both.
+ * Its name, title, URL and folder are lowercased and indexed by trigram and
+ * by the first one and two characters of each word. A query looks up the
+ * rarest gram among its terms, verifies and scores only those candidates and
+ * keeps the top results, so the cost follows the number of plausible matches
+ * rather than the size of the history. Updates touch only the changed entry.
+ *
+ * Not thread-safe; BrowserInterface uses it from the UI thread only.
+ */
+class OmniboxIndex {
+public:
+    /**
+     * @brief Constructor for the OmniboxIndex class.
+     * @param historyLimit Maximum number of visited pages kept besides bookmarks.
+     */
+    explicit OmniboxIndex(size_t historyLimit = 2000);
+
+    /**
+     * @brief Sets the number of visited pages kept besides bookmarks.
+     * @param historyLimit The new limit; the least recently visited pages are evicted first.
+     */
+    void SetHistoryLimit(size_t historyLimit);
+
+    /**
+     * @brief Adds a bookmark, or updates the entry for its URL.
+     * @param bookmark The bookmark.
+     */
+    void AddBookmark(const Bookmark& bookmark);
+
+    /**
+     * @brief Removes the bookmark for a URL; its history is kept.
+     * @param url The bookmark URL.
+     */
+    void RemoveBookmark(const std::string& url);
+
+    /**
+     * @brief Records a visit to a URL.
+     * @param url The visited URL.
+     */
+    void RecordVisit(const std::string& url);
+
+    /**
+     * @brief Sets the page title of a visited URL.
+     * @param url The URL.
+     * @param title The page title.
+     */
+    void UpdateTitle(const std::string& url, const std::string& title);
+
+    /**
+     * @brief Forgets all visited pages that are not bookmarked.
+     */
+    void ClearHistory();
+
+    /**
+     * @brief Finds the best matches for typed text.
+     *
+     * Every whitespace-separated term must match: terms of three or more
+     * characters anywhere in a field, shorter terms at the start of a word.
+     * @param text The typed text.
+     * @param maxResults Maximum number of matches to return.
+     * @return Matches, best first.
+     */
+    std::vector<OmniboxMatch> Query(std::string_view text, size_t maxResults) const;
+
+    /**
+     * @brief Gets the number of indexed URLs.
+     * @return The entry count.
+     */
+    size_t GetCount() const { return m_urlIndex.size(); }
+
+private:
+    /**
+     * @brief One indexed URL.
+     */
+    struct Entry {
+        std::string url;            ///< URL as first seen
+        std::string name;           ///< Bookmark name
+        std::string pageTitle;      ///< Last page title
+        std::string folder;         ///< Bookmark folder
+        std::string searchName;     ///< Lowercased name
+        std::string searchTitle;    ///< Lowercased page title
+        std::string searchUrl;      ///< Lowercased URL without scheme, "www." or trailing slash
+        std::string searchFolder;   ///< Lowercased folder
+        uint32_t visitCount = 0;    ///< Number of recorded visits
+        uint64_t lastVisit = 0;     ///< Visit clock at the last visit; 0 if never visited
+        bool bookmarked = false;    ///< Whether the URL is bookmarked
+        bool live = false;          ///< Whether the slot is in use
+    };
+
+    /**
+     * @brief Gets the entry for a URL, creating it if needed.
+     * @param url The URL.
+     * @return Index into m_entries.
+     */
+    uint32_t GetOrCreateEntry(const std::string& url);
+
+    /**
+     * @brief Frees an entry and removes it from the index.
+     * @param id The entry index.
+     */
+    void RemoveEntry(uint32_t id);
+
+    /**
+     * @brief Evicts the least recently visited pages beyond the history limit.
+     */
+    void EnforceHistoryLimit();
+
+    /**
+     * @brief Adds or removes an entry's grams in the posting lists.
+     * @param id The entry index.
+     * @param add True to add, false to remove.
+     */
+    void UpdatePostings(uint32_t id, bool add);
+
+    /**
+     * @brief Scores an entry against query terms.
+     * @return The score, or 0 if any term does not match.
+     */
+    int ScoreEntry(const Entry& entry, const std::vector<std::string>& terms) const;
+
+    /**
+     * @brief Lowercases ASCII characters.
+     */
+    static std::string Normalize(std::string_view text);
+
+    /**
+     * @brief Normalizes a URL for matching and de-duplication.
+     */
+    static std::string NormalizeUrl(std::string_view url);
+
+    /**
+     * @brief Appends the trigrams and word-prefix grams of a field.
+     */
+    static void CollectGrams(std::string_view field, std::vector<uint32_t>& grams);
+
+    std::vector<Entry> m_entries;                                   ///< Entries by ID
+    std::vector<uint32_t> m_freeEntries;                            ///< IDs of unused slots
+    std::unordered_map<std::string, uint32_t> m_urlIndex;           ///< Normalized URL to entry ID
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_postings; ///< Gram to sorted entry IDs
+    size_t m_historyLimit;                                          ///< Unbookmarked pages to keep
+    size_t m_historyCount;                                          ///< Unbookmarked pages kept now
+    uint64_t m_visitClock;                                          ///< Increments on every visit
+};
+
+} // namespace poe
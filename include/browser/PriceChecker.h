@@ -0,0 +1,179 @@
+#pragma once
+
+#include <Windows.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "browser/ItemParser.h"
+#include "browser/PriceIndex.h"
+#include "core/Application.h"
+#include "core/Logger.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+class CefManager;
+class InputHandler;
+struct PriceRefreshState;
+
+/**
+ * @struct PriceCheckConfig
+ * @brief Configuration for the PriceChecker.
+ */
+struct PriceCheckConfig {
+    UINT hotkeyModifiers = MOD_CONTROL;           ///< Modifiers of the price check hotkey
+    UINT hotkeyKey = 'D';                         ///< Virtual key of the price check hotkey
+    std::string league = "Standard";              ///< poe.ninja league to price against
+    std::filesystem::path indexDirectory;         ///< Directory of the price index files
+    std::chrono::minutes refreshInterval{30};     ///< How old the prices may get before they are fetched again
+};
+
+/**
+ * @struct PriceCheckResult
+ * @brief Outcome of one price check.
+ */
+struct PriceCheckResult {
+    ParsedItem item;                 ///< The item checked
+    bool found = false;              ///< Whether the index has a price for it
+    PriceQuote quote;                ///< The price, if found
+    int64_t pricesFrom = 0;          ///< Unix time the prices were fetched, or 0 without an index
+    double elapsedMs = 0.0;          ///< Time from the hotkey press (or call) to the result
+};
+
+/**
+ * @class PriceChecker
+ * @brief Prices the item under the cursor from a local poe.ninja index.
+ *
+ * Pressing the hotkey makes the game copy the hovered item by sending it
+ * Ctrl+C. A worker then waits for the clipboard to change, parses the item
+ * text and looks it up in a memory-mapped PriceIndex, and Update() pushes
+ * the result to pages subscribed to the "priceCheck" bridge topic. No page
+ * load is involved, so a check takes milliseconds.
+ *
+ * The index is rebuilt from the poe.ninja overview API in the background
+ * whenever it is older than PriceCheckConfig::refreshInterval. Two index
+ * files are used in turn, so the one in use is never overwritten on disk.
+ *
+ * Initialize, Shutdown and Update run on the CEF UI thread, after the
+ * CefManager is initialized.
+ */
+class PriceChecker {
+public:
+    /**
+     * @brief Constructor for the PriceChecker class.
+     * @param app Reference to the main application instance.
+     * @param inputHandler Input handler to register the hotkey with.
+     * @param cefManager CEF manager providing the message bridge.
+     * @param config Configuration for the checker.
+     */
+    PriceChecker(Application& app, InputHandler& inputHandler, CefManager& cefManager,
+        const PriceCheckConfig& config = PriceCheckConfig());
+
+    /**
+     * @brief Destructor for the PriceChecker class.
+     */
+    ~PriceChecker();
+
+    // Non-copyable, non-movable: the hotkey and worker tasks refer to this instance
+    PriceChecker(const PriceChecker&) = delete;
+    PriceChecker& operator=(const PriceChecker&) = delete;
+
+    /**
+     * @brief Opens the newest index on disk, registers the hotkey and the bridge method.
+     * @return True if initialization succeeded, false otherwise.
+     */
+    bool Initialize();
+
+    /**
+     * @brief Unregisters the hotkey and waits for a running check.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Publishes finished checks and starts a price refresh when one is due.
+     * This should be called periodically.
+     */
+    void Update();
+
+    /**
+     * @brief Parses item text and looks it up. Thread-safe.
+     * @param text Item text as the game copies it.
+     * @param result Receives the outcome.
+     * @return False if the text is not an item.
+     */
+    bool CheckItemText(const std::string& text, PriceCheckResult& result) const;
+
+    /**
+     * @brief Converts a result to the JSON pages receive.
+     * @param result The result.
+     * @return The JSON value.
+     */
+    static nlohmann::json ToJson(const PriceCheckResult& result);
+
+private:
+    /**
+     * @brief Hotkey callback: starts a clipboard check unless one is running.
+     */
+    void OnHotkey();
+
+    /**
+     * @brief Copies the hovered item, then parses and prices it. Runs on the worker pool.
+     * @param pressedAt When the hotkey was pressed.
+     */
+    void RunClipboardCheck(std::chrono::steady_clock::time_point pressedAt);
+
+    /**
+     * @brief Requests every poe.ninja overview.
+     */
+    void StartRefresh();
+
+    /**
+     * @brief Takes over the index built by a finished refresh.
+     */
+    void FinishRefresh();
+
+    /**
+     * @brief Path of one of the two index files.
+     * @param slot 0 or 1.
+     * @return The path.
+     */
+    std::filesystem::path GetIndexPath(int slot) const;
+
+    /**
+     * @brief Log a message using the application logger.
+     * @tparam Args Variadic template for format arguments.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string.
+     * @param args Format arguments.
+     */
+    template<typename... Args>
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) const {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    Application& m_app;                            ///< Reference to the main application
+    InputHandler& m_inputHandler;                  ///< Input handler owning the hotkey
+    CefManager& m_cefManager;                      ///< CEF manager providing the bridge
+    PriceCheckConfig m_config;                     ///< Checker configuration
+    bool m_initialized;                            ///< Whether the checker is initialized
+    int m_hotkeyId;                                ///< Price check hotkey, or -1
+
+    std::atomic<std::shared_ptr<const PriceIndex>> m_index; ///< Index in use, or null; read by workers
+    int m_indexSlot;                               ///< Slot of m_index, -1 without one
+    std::future<void> m_check;                     ///< Clipboard check in flight, if any
+
+    std::mutex m_resultsMutex;                     ///< Guards m_results
+    std::vector<PriceCheckResult> m_results;       ///< Finished checks not yet published
+
+    std::shared_ptr<PriceRefreshState> m_refresh;  ///< Refresh in flight, or null
+    std::chrono::steady_clock::time_point m_nextRefresh; ///< When to fetch prices next
+};
+
+} // namespace poe
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "browser/MappedFile.h"
+
+namespace poe {
+
+/**
+ * @struct PriceQuote
+ * @brief Price of one item variant.
+ */
+struct PriceQuote {
+    float chaosValue = 0.0f;    ///< Price in Chaos Orbs
+    float divineValue = 0.0f;   ///< Price in Divine Orbs, or 0 if not listed
+    uint32_t listings = 0;      ///< Number of listings the price is based on
+};
+
+/**
+ * @class PriceIndexWriter
+ * @brief Builds a price index file from poe.ninja overview lines.
+ *
+ * Layout, all little-endian and offset-addressed so PriceIndex can use the
+ * file in place:
+ *
+ *     header | bucketCount entries (32 bytes each) | name blob
+ *
+ * Entries form an open-addressed hash table with linear probing, keyed by
+ * the hash of the item name and its variant; a zero key marks an empty
+ * bucket. The bucket count is a power of two at least twice the number of
+ * items, so a probe rarely goes past the first bucket.
+ */
+class PriceIndexWriter {
+public:
+    /**
+     * @brief Adds an item; of duplicate variants, the one with more listings is kept.
+     * @param name Item name as the game prints it.
+     * @param variant PriceIndex::MakeVariant of the item.
+     * @param quote The price.
+     */
+    void Add(std::string_view name, uint32_t variant, const PriceQuote& quote);
+
+    /**
+     * @brief Gets the number of distinct items added.
+     * @return The number of items.
+     */
+    size_t GetCount() const { return m_items.size(); }
+
+    /**
+     * @brief Writes the index, replacing any previous file atomically.
+     * @param path The index file to write.
+     * @param builtAt Unix time the prices were fetched.
+     * @return True if the file was written, false otherwise.
+     */
+    bool Write(const std::filesystem::path& path, int64_t builtAt) const;
+
+private:
+    /**
+     * @brief An item waiting to be written.
+     */
+    struct Item {
+        uint64_t key;       ///< PriceIndex::MakeKey of the item
+        uint32_t variant;   ///< Variant of the item
+        std::string name;   ///< Item name
+        PriceQuote quote;   ///< Price of the item
+    };
+
+    std::vector<Item> m_items;                       ///< Distinct items, in the order added
+    std::unordered_map<uint64_t, size_t> m_positions; ///< Key -> index in m_items
+};
+
+/**
+ * @class PriceIndex
+ * @brief Maps a price index written by PriceIndexWriter and looks prices up in place.
+ *
+ * Lookups touch one or two hash buckets and the name they point at, so the
+ * OS only pages in what price checks actually use. A loaded index is
+ * immutable; all methods are safe to call from any thread.
+ */
+class PriceIndex {
+public:
+    PriceIndex() = default;
+
+    // Non-copyable
+    PriceIndex(const PriceIndex&) = delete;
+    PriceIndex& operator=(const PriceIndex&) = delete;
+
+    /**
+     * @brief Maps and validates an index file.
+     * @param path The index file.
+     * @return True if the file is a valid index, false otherwise.
+     */
+    bool Open(const std::filesystem::path& path);
+
+    /**
+     * @brief Looks up the price of an item variant.
+     * @param name Item name as the game prints it.
+     * @param variant MakeVariant of the item.
+     * @return The price, or std::nullopt if the variant is not listed.
+     */
+    std::optional<PriceQuote> Find(std::string_view name, uint32_t variant) const;
+
+    /**
+     * @brief Gets the number of items in the index.
+     * @return The number of items.
+     */
+    uint32_t GetCount() const { return m_count; }
+
+    /**
+     * @brief Gets when the prices were fetched.
+     * @return Unix time, or 0 if no index is open.
+     */
+    int64_t GetBuiltAt() const { return m_builtAt; }
+
+    /**
+     * @brief Packs the properties poe.ninja prices separately into one value.
+     * @param links Linked sockets; poe.ninja only tells 5 and 6 links apart from the rest.
+     * @param gemLevel Gem level, or 0 for other items.
+     * @param gemQuality Gem quality, or 0 for other items.
+     * @param corrupted Whether the item is corrupted; pass false where poe.ninja does not price it separately.
+     * @return The variant.
+     */
+    static uint32_t MakeVariant(unsigned links, unsigned gemLevel, unsigned gemQuality, bool corrupted);
+
+    /**
+     * @brief Computes the hash key of an item variant.
+     * @param name Item name.
+     * @param variant Variant of the item.
+     * @return The key; never 0.
+     */
+    static uint64_t MakeKey(std::string_view name, uint32_t variant);
+
+private:
+    MappedFile m_file;                  ///< Mapped index file
+    const uint8_t* m_entries = nullptr; ///< Start of the hash table
+    const char* m_names = nullptr;      ///< Start of the name blob
+    uint32_t m_namesSize = 0;           ///< Size of the name blob in bytes
+    uint32_t m_bucketMask = 0;          ///< Bucket count - 1
+    uint32_t m_count = 0;               ///< Number of items
+    int64_t m_builtAt = 0;              ///< Unix time the prices were fetched
+};
+
+} // namespace poe
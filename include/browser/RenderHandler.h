@@ -6,12 +6,14 @@
 #include <unordered_map>
 #include <include/cef_render_handler.h>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
 // Forward declarations
 class Application;
 class CefManager;
+class BrowserView;
 
 /**
  * @class RenderHandler
@@ -23,11 +25,6 @@ class CefManager;
  */
 class RenderHandler : public CefRenderHandler {
 public:
-    /**
-     * @brief Type definition for paint callback function.
-     */
-    using PaintCallback = std::function<void(CefRefPtr<CefBrowser>, const void*, int, int, int, int)>;
-
     /**
      * @brief Type definition for cursor change callback function.
      */
@@ -41,10 +38,20 @@ public:
     RenderHandler(Application& app, CefManager& cefManager);
 
     /**
-     * @brief Sets the callback function for paint events.
-     * @param callback The callback function.
+     * @brief Routes paints of a browser to the view that owns it.
+     *
+     * Every browser shares this handler, so paints are dispatched by browser
+     * ID; browsers without a registered view are not composited.
+     * @param browserId The browser ID.
+     * @param view The view; must unregister before it is destroyed.
+     */
+    void RegisterView(int browserId, BrowserView* view);
+
+    /**
+     * @brief Stops routing paints of a browser to its view.
+     * @param browserId The browser ID.
      */
-    void SetPaintCallback(PaintCallback callback) { m_paintCallback = callback; }
+    void UnregisterView(int browserId);
 
     /**
      * @brief Sets the callback function for cursor change events.
@@ -55,16 +62,26 @@ public:
     /**
      * @brief Resizes the browser view.
      * @param browser The browser to resize.
-     * @param width The new width.
-     * @param height The new height.
+     * @param width The new width in device pixels.
+     * @param height The new height in device pixels.
      */
     void Resize(CefRefPtr<CefBrowser> browser, int width, int height);
 
+    /**
+     * @brief Sets the device scale factor a browser renders at.
+     *
+     * CEF lays out in DIPs and paints at width x height device pixels, so
+     * text stays sharp on high-DPI monitors. Re-rasterizes only on change.
+     * @param browser The browser to update.
+     * @param scaleFactor Device pixels per DIP (1.0 at 96 DPI).
+     */
+    void SetScaleFactor(CefRefPtr<CefBrowser> browser, float scaleFactor);
+
     /**
      * @brief Gets the viewport size for a browser.
      * @param browserId The browser ID.
-     * @param width Output parameter for the viewport width.
-     * @param height Output parameter for the viewport height.
+     * @param width Output parameter for the viewport width in device pixels.
+     * @param height Output parameter for the viewport height in device pixels.
      * @return True if the viewport size was retrieved, false otherwise.
      */
     bool GetViewportSize(int browserId, int& width, int& height);
@@ -78,6 +95,8 @@ public:
     void OnPopupSize(CefRefPtr<CefBrowser> browser, const CefRect& rect) override;
     void OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type, const RectList& dirtyRects,
         const void* buffer, int width, int height) override;
+    void OnAcceleratedPaint(CefRefPtr<CefBrowser> browser, PaintElementType type, const RectList& dirtyRects,
+        void* shared_handle) override;
     void OnCursorChange(CefRefPtr<CefBrowser> browser, CefCursorHandle cursor, 
         CursorType type, const CefCursorInfo& custom_cursor_info) override;
     bool StartDragging(CefRefPtr<CefBrowser> browser, CefRefPtr<CefDragData> drag_data,
@@ -91,12 +110,35 @@ private:
      * @brief Stores information about a browser viewport.
      */
     struct ViewportInfo {
-        int width = 800;     ///< Viewport width
-        int height = 600;    ///< Viewport height
+        int width = 800;     ///< Viewport width in device pixels
+        int height = 600;    ///< Viewport height in device pixels
+        float scaleFactor = 1.0f; ///< Device pixels per DIP
         bool popupVisible = false; ///< Whether a popup is visible
         CefRect popupRect;   ///< Popup rectangle
     };
 
+    /**
+     * @brief Gets a copy of a browser's viewport.
+     * @param browserId The browser ID.
+     * @param info Output parameter for the viewport.
+     * @return True if the browser has a viewport, false otherwise.
+     */
+    bool GetViewport(int browserId, ViewportInfo& info);
+
+    /**
+     * @brief Gets a viewport's size in DIPs, as CEF lays it out.
+     * @param info The viewport.
+     * @return The view rectangle, rounded up to whole DIPs.
+     */
+    static CefRect GetViewRectInDips(const ViewportInfo& info);
+
+    /**
+     * @brief Finds the view registered for a browser.
+     * @param browserId The browser ID.
+     * @return The view, or nullptr if none is registered.
+     */
+    BrowserView* FindView(int browserId);
+
     /**
      * @brief Log a message using the application logger.
      * @tparam Args Variadic template for format arguments.
@@ -105,7 +147,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     // Required for IMPLEMENT_REFCOUNTING
     IMPLEMENT_REFCOUNTING(RenderHandler);
@@ -113,11 +157,13 @@ private:
     Application& m_app;                             ///< Reference to the main application
     CefManager& m_cefManager;                       ///< Reference to the CEF manager
     
-    PaintCallback m_paintCallback;                  ///< Callback for paint events
     CursorChangeCallback m_cursorChangeCallback;    ///< Callback for cursor change events
     
     std::unordered_map<int, ViewportInfo> m_viewports; ///< Map of browser ID to viewport info
     std::mutex m_viewportsMutex;                    ///< Mutex for thread-safe access to viewports
+    
+    std::unordered_map<int, BrowserView*> m_views;  ///< Map of browser ID to the view painting it
+    std::mutex m_viewsMutex;                        ///< Mutex for thread-safe access to views
 };
 
 } // namespace poe
\ No newline at end of file
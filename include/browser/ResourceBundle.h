@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string_view>
+
+namespace poe {
+
+/**
+ * @struct BundledResource
+ * @brief An immutable resource compiled into the executable.
+ */
+struct BundledResource {
+    std::string_view path;      ///< Path below the poe:// scheme (e.g. "home")
+    std::string_view mimeType;  ///< MIME type served with the resource
+    std::string_view data;      ///< Resource bytes, in static storage
+};
+
+/**
+ * @class ResourceBundle
+ * @brief Index over the static pages served by the poe:// scheme.
+ *
+ * The pages live in read-only static storage and are handed out as views,
+ * so serving one never copies or allocates. Pages that depend on the
+ * request (such as poe://error) are still generated by ResourceHandler.
+ */
+class ResourceBundle {
+public:
+    /**
+     * @brief Looks up a bundled resource.
+     * @param path The path below the scheme, without query string.
+     * @return The resource, or nullptr if the path is not bundled.
+     */
+    static const BundledResource* Find(std::string_view path);
+};
+
+} // namespace poe
@@ -1,10 +1,17 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <filesystem>
+#include <vector>
 #include <include/cef_resource_handler.h>
 #include "core/Application.h"
+#include "core/Logger.h"
+#include "browser/MappedFile.h"
 
 namespace poe {
 
@@ -18,6 +25,13 @@ class CefManager;
  * 
  * This class allows the application to intercept and handle resource
  * requests made by the browser, such as custom protocols or local resources.
+ * Routes that may block (file I/O) are produced on the application's
+ * worker pool and the request is continued through its CefCallback, so
+ * the CEF IO thread never waits on them.
+ *
+ * Every response advertises byte ranges. CEF answers a Range request
+ * from the full response through Skip() and a bounded read, so large
+ * assets can be seeked without the handler slicing them.
  */
 class ResourceHandler : public CefResourceHandler {
 public:
@@ -53,33 +67,105 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     /**
      * @struct ResourceData
      * @brief Stores data for a resource request.
      */
     struct ResourceData {
-        std::string mimeType;       ///< MIME type of the resource
-        std::string data;           ///< Resource data
+        std::string_view mimeType;  ///< MIME type of the resource (static storage)
+        std::string storage;        ///< Backing store for generated pages
+        std::string_view data;      ///< Resource data (bundle, storage or file)
+        MappedFile file;            ///< Backing mapping for local assets
         size_t offset = 0;          ///< Current offset in the data
     };
 
+    /**
+     * @brief Produces the data for a generated poe:// page.
+     * @param mainPath The requested path, without query string.
+     * @param queryParams The query string, without the leading '?'.
+     * @return The resource, or nullptr if it could not be produced.
+     */
+    using RouteHandler = std::unique_ptr<ResourceData> (ResourceHandler::*)(
+        std::string_view mainPath, std::string_view queryParams);
+
+    /**
+     * @brief A route handler bound to its arguments, ready to run on a worker.
+     */
+    using ResourceProducer = std::function<std::unique_ptr<ResourceData>()>;
+
+    /**
+     * @struct Route
+     * @brief Maps a poe:// path to the handler that generates it.
+     */
+    struct Route {
+        std::string_view path;      ///< Path below the scheme
+        RouteHandler handler;       ///< Page generator
+        bool async;                 ///< Whether the handler runs on the worker pool
+    };
+
     /**
      * @brief Handles a request for a custom scheme.
-     * @param request The request to handle.
      * @param scheme The scheme being requested.
      * @param path The path being requested.
+     * @param callback Callback to continue an asynchronous request with.
+     * @param handleRequest Set to false when the response will be continued through callback.
      * @return True if the request was handled, false otherwise.
      */
-    bool HandleCustomScheme(CefRefPtr<CefRequest> request, const std::string& scheme, const std::string& path);
+    bool HandleCustomScheme(
+        std::string_view scheme,
+        std::string_view path,
+        CefRefPtr<CefCallback> callback,
+        bool& handleRequest);
+
+    /**
+     * @brief Runs a producer on the worker pool and continues the request when it finishes.
+     * @param producer The producer to run.
+     * @param callback Callback to continue or cancel the request with.
+     */
+    void StartAsync(ResourceProducer producer, CefRefPtr<CefCallback> callback);
+
+    /**
+     * @brief Builds the poe://error page from the code, message and url query parameters.
+     * @param mainPath "error".
+     * @param queryParams The query string.
+     * @return The page.
+     */
+    std::unique_ptr<ResourceData> HandleErrorPage(std::string_view mainPath, std::string_view queryParams);
+
+    /**
+     * @brief Builds the poe://perf page from the frame profiler and the memory tracker.
+     * @param mainPath "perf", or "perf/reset" / "perf/dump" to act before rendering the page.
+     * @param queryParams The query string (unused).
+     * @return The page.
+     */
+    std::unique_ptr<ResourceData> HandlePerfPage(std::string_view mainPath, std::string_view queryParams);
+
+    /**
+     * @brief Serves a file below the assets directory through a memory mapping.
+     * @param mainPath "assets/" followed by the path below the assets directory.
+     * @param queryParams The query string (unused).
+     * @return The mapped file, or nullptr if it could not be opened.
+     */
+    std::unique_ptr<ResourceData> HandleAssetRequest(std::string_view mainPath, std::string_view queryParams);
 
     /**
      * @brief Gets the MIME type for a file extension.
      * @param extension The file extension.
      * @return The MIME type, or "application/octet-stream" if unknown.
      */
-    std::string GetMimeType(const std::string& extension);
+    static std::string_view GetMimeType(std::string_view extension);
+
+    /**
+     * @brief Extracts a query parameter, decoding '+' as a space.
+     * @param query The query string, without the leading '?'.
+     * @param name The parameter name.
+     * @return The parameter value, or an empty string if absent.
+     */
+    static std::string GetQueryParameter(std::string_view query, std::string_view name);
 
     // Required for IMPLEMENT_REFCOUNTING
     IMPLEMENT_REFCOUNTING(ResourceHandler);
@@ -87,10 +173,14 @@ private:
     Application& m_app;                       ///< Reference to the main application
     CefManager& m_cefManager;                 ///< Reference to the CEF manager
     
-    std::unordered_map<std::string, bool> m_registeredSchemes; ///< Map of registered schemes
+    std::vector<std::string> m_registeredSchemes; ///< Registered schemes, sorted
+    std::filesystem::path m_assetsRoot;       ///< Directory served under poe://assets/
     
     // Current request state
     std::unique_ptr<ResourceData> m_resourceData; ///< Data for the current resource request
+    std::unique_ptr<ResourceData> m_pendingData;  ///< Result handed over by an asynchronous producer
+    std::mutex m_pendingMutex;                ///< Guards m_pendingData
+    std::atomic<bool> m_cancelled{false};     ///< Set once CEF cancels the request
     bool m_requestComplete = false;           ///< Whether the request is complete
 };
 
@@ -3,6 +3,8 @@
 #include <memory>
 #include <string>
 #include <atomic>
+#include <functional>
+#include <vector>
 
 // Forward declarations
 namespace poe {
@@ -10,6 +12,12 @@ namespace poe {
     class Logger;
     class EventSystem;
     class ErrorHandler;
+    class FrameProfiler;
+    class MemoryTracker;
+    class WorkerPool;
+    class TraceRing;
+    class StartupGraph;
+    enum class StartupThread;
 }
 
 namespace poe {
@@ -60,6 +68,23 @@ public:
      */
     bool Initialize();
 
+    /**
+     * @brief Adds a stage to the startup graph run by Initialize().
+     *
+     * Call before Initialize(). Stages may depend on each other and on the
+     * core stages "trace", "events", "errors" and "profiler"; the logger,
+     * worker pool and settings are always up before any stage runs. Components
+     * that need the main thread (the overlay window, CefInitialize) register
+     * Main stages, slow independent work (device creation, bookmark loading)
+     * registers Worker stages, and Initialize() overlaps whatever it can.
+     * @param name Unique stage name.
+     * @param dependencies Names of the stages that must succeed first.
+     * @param thread Where the stage runs.
+     * @param task The stage body; returns false on failure.
+     */
+    void AddStartupStage(const std::string& name, std::vector<std::string> dependencies,
+                         StartupThread thread, std::function<bool()> task);
+
     /**
      * @brief Runs the main application loop.
      * @return Exit code of the application.
@@ -95,6 +120,12 @@ public:
      */
     Logger& GetLogger() const;
 
+    /**
+     * @brief Gets the logger without throwing.
+     * @return Pointer to the logger, or nullptr if it does not exist.
+     */
+    Logger* TryGetLogger() const noexcept { return m_logger.get(); }
+
     /**
      * @brief Gets the event system.
      * @return Reference to the event system.
@@ -107,6 +138,30 @@ public:
      */
     ErrorHandler& GetErrorHandler() const;
 
+    /**
+     * @brief Gets the frame profiler.
+     * @return Reference to the frame profiler.
+     */
+    FrameProfiler& GetFrameProfiler() const;
+
+    /**
+     * @brief Gets the memory tracker.
+     * @return Reference to the memory tracker.
+     */
+    MemoryTracker& GetMemoryTracker() const;
+
+    /**
+     * @brief Gets the background worker pool.
+     * @return Reference to the worker pool.
+     */
+    WorkerPool& GetWorkerPool() const;
+
+    /**
+     * @brief Gets the binary event trace ring.
+     * @return Reference to the trace ring.
+     */
+    TraceRing& GetTraceRing() const;
+
     /**
      * @brief Gets the instance of the application.
      * @return Reference to the singleton instance.
@@ -160,6 +215,31 @@ private:
      * @brief Error handler subsystem.
      */
     std::unique_ptr<ErrorHandler> m_errorHandler;
+
+    /**
+     * @brief Frame profiler subsystem.
+     */
+    std::unique_ptr<FrameProfiler> m_frameProfiler;
+
+    /**
+     * @brief Memory accounting subsystem.
+     */
+    std::unique_ptr<MemoryTracker> m_memoryTracker;
+
+    /**
+     * @brief Background worker pool subsystem.
+     */
+    std::unique_ptr<WorkerPool> m_workerPool;
+
+    /**
+     * @brief Binary event trace subsystem.
+     */
+    std::unique_ptr<TraceRing> m_traceRing;
+
+    /**
+     * @brief Startup stages, run and released by Initialize().
+     */
+    std::unique_ptr<StartupGraph> m_startupGraph;
 };
 
 } // namespace poe
\ No newline at end of file
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace poe {
+
+/**
+ * @enum CacheValueType
+ * @brief Type of one field in a binary cache record.
+ */
+enum class CacheValueType : uint32_t {
+    None,       ///< Missing or out-of-range field
+    Int,        ///< 64-bit signed integer
+    Double,     ///< 64-bit floating point
+    Bool,       ///< Boolean
+    String      ///< UTF-8 string in the string blob
+};
+
+/**
+ * @class BinaryCacheWriter
+ * @brief Builds a binary cache of fixed-width records derived from a JSON source file.
+ *
+ * Layout, all little-endian and offset-addressed so a reader can use the
+ * file in place:
+ *
+ *     header | recordCount * fieldsPerRecord fields (16 bytes each) | string blob
+ *
+ * Each field stores its type and either the value itself or the offset and
+ * length of a string in the blob. The header records the format version,
+ * a schema tag and the size and modification time of the source file, so a
+ * cache that no longer matches its source is ignored.
+ */
+class BinaryCacheWriter {
+public:
+    /**
+     * @brief Constructor for the BinaryCacheWriter class.
+     * @param schema Tag identifying what the cache holds (e.g. settings or bookmarks).
+     * @param fieldsPerRecord Number of fields in every record.
+     */
+    BinaryCacheWriter(uint32_t schema, uint32_t fieldsPerRecord);
+
+    /**
+     * @brief Appends an integer field to the current record.
+     * @param value The value.
+     */
+    void AddInt(int64_t value);
+
+    /**
+     * @brief Appends a floating-point field to the current record.
+     * @param value The value.
+     */
+    void AddDouble(double value);
+
+    /**
+     * @brief Appends a boolean field to the current record.
+     * @param value The value.
+     */
+    void AddBool(bool value);
+
+    /**
+     * @brief Appends a string field to the current record.
+     * @param value The value.
+     */
+    void AddString(std::string_view value);
+
+    /**
+     * @brief Appends an empty field to the current record.
+     */
+    void AddNone();
+
+    /**
+     * @brief Writes the cache to disk, replacing any previous file atomically.
+     * @param path The cache file to write.
+     * @param sourcePath The JSON file the cache was built from.
+     * @return True if the file was written, false otherwise.
+     */
+    bool WriteFile(const std::filesystem::path& path, const std::filesystem::path& sourcePath) const;
+
+private:
+    /**
+     * @brief Appends a field with a numeric payload.
+     * @param type The field type.
+     * @param payload The raw 64-bit payload.
+     */
+    void AddField(CacheValueType type, uint64_t payload);
+
+    uint32_t m_schema;              ///< Schema tag stored in the header
+    uint32_t m_fieldsPerRecord;     ///< Fields in every record
+    std::vector<uint8_t> m_fields;  ///< Encoded fields
+    std::string m_strings;          ///< String blob
+};
+
+/**
+ * @class BinaryCacheReader
+ * @brief Maps a binary cache written by BinaryCacheWriter and reads it in place.
+ *
+ * Open() checks the header, the bounds of every section and that the source
+ * file still has the recorded size and modification time; strings are
+ * returned as views into the mapping and stay valid while the reader is open.
+ */
+class BinaryCacheReader {
+public:
+    /**
+     * @brief Constructor for the BinaryCacheReader class.
+     */
+    BinaryCacheReader();
+
+    /**
+     * @brief Destructor for the BinaryCacheReader class.
+     */
+    ~BinaryCacheReader();
+
+    // Non-copyable
+    BinaryCacheReader(const BinaryCacheReader&) = delete;
+    BinaryCacheReader& operator=(const BinaryCacheReader&) = delete;
+
+    /**
+     * @brief Maps and validates a cache file.
+     * @param path The cache file.
+     * @param sourcePath The JSON file the cache must match.
+     * @param schema Expected schema tag.
+     * @param fieldsPerRecord Expected number of fields per record.
+     * @return True if the cache is present, well-formed and current, false otherwise.
+     */
+    bool Open(const std::filesystem::path& path, const std::filesystem::path& sourcePath,
+              uint32_t schema, uint32_t fieldsPerRecord);
+
+    /**
+     * @brief Unmaps the cache file.
+     */
+    void Close();
+
+    /**
+     * @brief Gets the number of records.
+     * @return The record count, or 0 if not open.
+     */
+    uint32_t GetRecordCount() const { return m_recordCount; }
+
+    /**
+     * @brief Gets the type of a field.
+     * @param record Record index.
+     * @param field Field index within the record.
+     * @return The field type, or None if out of range.
+     */
+    CacheValueType GetType(uint32_t record, uint32_t field) const;
+
+    /**
+     * @brief Gets an integer field.
+     * @return The value, or 0 if the field is not an integer.
+     */
+    int64_t GetInt(uint32_t record, uint32_t field) const;
+
+    /**
+     * @brief Gets a floating-point field.
+     * @return The value, or 0.0 if the field is not a double.
+     */
+    double GetDouble(uint32_t record, uint32_t field) const;
+
+    /**
+     * @brief Gets a boolean field.
+     * @return The value, or false if the field is not a boolean.
+     */
+    bool GetBool(uint32_t record, uint32_t field) const;
+
+    /**
+     * @brief Gets a string field.
+     * @return View into the mapping, or an empty view if the field is not a string.
+     */
+    std::string_view GetString(uint32_t record, uint32_t field) const;
+
+private:
+    /**
+     * @brief Locates a field.
+     * @return Pointer to the encoded field, or nullptr if out of range.
+     */
+    const uint8_t* FieldAt(uint32_t record, uint32_t field) const;
+
+    void* m_file;                   ///< Open file handle
+    void* m_mapping;                ///< File mapping handle
+    const uint8_t* m_view;          ///< Mapped view of the file
+    size_t m_size;                  ///< Size of the mapped view
+    uint32_t m_recordCount;         ///< Records in the cache
+    uint32_t m_fieldsPerRecord;     ///< Fields per record
+    const uint8_t* m_fields;        ///< Start of the field table
+    const char* m_strings;          ///< Start of the string blob
+    uint32_t m_stringsSize;         ///< Size of the string blob
+};
+
+} // namespace poe
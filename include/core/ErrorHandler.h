@@ -1,10 +1,15 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <exception>
+#include <filesystem>
 
 namespace poe {
 
@@ -33,6 +38,19 @@ struct ErrorInfo {
     std::string component;     ///< Component that generated the error
     std::string details;       ///< Additional error details
     std::exception_ptr exception; ///< Exception pointer if available
+    uint64_t suppressedCount = 0; ///< Identical reports dropped by rate limiting since the last delivered one
+};
+
+/**
+ * @struct ErrorCount
+ * @brief How often one (component, message) pair was reported.
+ */
+struct ErrorCount {
+    std::string component;     ///< Component that reported the error
+    std::string message;       ///< Error message
+    ErrorSeverity severity;    ///< Severity of the latest report
+    uint64_t count;            ///< Reports in total
+    uint64_t suppressed;       ///< Reports dropped by rate limiting
 };
 
 /**
@@ -41,6 +59,14 @@ struct ErrorInfo {
  * 
  * This class provides centralized error handling, allowing components to
  * report errors and register handlers for different types of errors.
+ *
+ * Reports are counted per (component, message) and rate limited with a
+ * token bucket per pair, so a failure repeating every frame reaches the
+ * callbacks a few times and is then only counted; the next report let
+ * through carries the number dropped before it. Callbacks run in report
+ * order on a worker of the WorkerPool, off the reporting thread. Critical
+ * and fatal reports are never dropped and are handled before ReportError
+ * returns.
  */
 class ErrorHandler {
 public:
@@ -113,6 +139,18 @@ public:
      */
     bool UnregisterErrorCallback(size_t callbackId);
 
+    /**
+     * @brief Runs the callbacks for every queued report on the calling thread.
+     * Waits for a batch a worker is already delivering.
+     */
+    void Flush();
+
+    /**
+     * @brief Gets the report counters of every tracked (component, message) pair.
+     * @return One entry per pair.
+     */
+    std::vector<ErrorCount> GetErrorCounts() const;
+
     /**
      * @brief Handles an error info object through the registered callbacks.
      * @param errorInfo The error info to handle.
@@ -130,6 +168,15 @@ public:
      */
     void ClearLastError();
 
+    /**
+     * @brief Writes the event trace ring next to the log file.
+     *
+     * Called for critical and fatal reports and from the crash handler.
+     * @param reason Short tag included in the file name (e.g. "crash").
+     * @return Path of the written file, or an empty path on failure.
+     */
+    std::filesystem::path DumpTrace(const std::string& reason);
+
 private:
     /**
      * @brief Internal structure for storing callbacks with their IDs.
@@ -139,6 +186,36 @@ private:
         ErrorCallback callback;
     };
 
+    /**
+     * @brief Counters and rate limit of one (component, message) pair.
+     */
+    struct ErrorState {
+        ErrorCount counts;                                  ///< Public counters
+        double tokens;                                      ///< Reports that may pass right now
+        uint64_t pendingSuppressed;                         ///< Dropped since the last report let through
+        std::chrono::steady_clock::time_point lastRefill;   ///< When tokens was last topped up
+        std::chrono::steady_clock::time_point lastSeen;     ///< When the pair was last reported
+    };
+
+    /**
+     * @brief Counts a report and applies its pair's rate limit.
+     * @param errorInfo The report; receives the number of reports dropped before it.
+     * @param force Let the report through even without a token.
+     * @return True if the report should reach the callbacks.
+     */
+    bool Admit(ErrorInfo& errorInfo, bool force);
+
+    /**
+     * @brief Queues a report and makes sure a worker is draining the queue.
+     * @param errorInfo The report.
+     */
+    void Enqueue(ErrorInfo errorInfo);
+
+    /**
+     * @brief Worker task: runs the callbacks for queued reports until the queue is empty.
+     */
+    void DispatchPending();
+
     /**
      * @brief Reference to the main application instance.
      */
@@ -164,6 +241,38 @@ private:
      */
     mutable std::mutex m_lastErrorMutex;
 
+    /**
+     * @brief Counters and rate limits by "component\x1fmessage".
+     */
+    std::unordered_map<std::string, ErrorState> m_errorStates;
+
+    /**
+     * @brief Mutex for thread-safe access to the error states.
+     */
+    mutable std::mutex m_errorStatesMutex;
+
+    /**
+     * @brief Reports waiting for the callbacks.
+     */
+    std::deque<ErrorInfo> m_pending;
+
+    /**
+     * @brief Whether a worker task is draining m_pending.
+     */
+    bool m_dispatchScheduled;
+
+    /**
+     * @brief Mutex for thread-safe access to the queue.
+     */
+    std::mutex m_pendingMutex;
+
+    /**
+     * @brief Held while reports are taken off the queue and delivered, so
+     * callbacks never run on two threads at once and keep report order.
+     * Recursive because a callback may itself report an error.
+     */
+    std::recursive_mutex m_dispatchMutex;
+
     /**
      * @brief Counter for generating unique callback IDs.
      */
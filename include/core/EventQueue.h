@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+#include "core/MemoryTracker.h"
+
+namespace poe {
+
+// Forward declarations
+class Event;
+class EventSystem;
+
+/**
+ * @class EventQueue
+ * @brief Arena-backed queue of pending events.
+ *
+ * Events are copy-constructed in place into fixed-size memory chunks rather
+ * than individually heap allocated. Draining the queue dispatches and destroys
+ * every event but keeps the chunks, so a queue that has warmed up to its
+ * steady-state size publishes without allocating.
+ */
+class EventQueue {
+public:
+    /**
+     * @brief Signature of the typed dispatcher stored with each queued event.
+     */
+    using Dispatcher = void (*)(EventSystem&, const Event&);
+
+    /**
+     * @brief Constructor for the EventQueue class.
+     */
+    EventQueue();
+
+    /**
+     * @brief Destructor for the EventQueue class.
+     */
+    ~EventQueue();
+
+    // Non-copyable
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    /**
+     * @brief Copies an event into the queue.
+     * @tparam EventType The concrete event type.
+     * @param event The event to copy.
+     * @param dispatch Dispatcher that restores EventType and delivers the event.
+     */
+    template<typename EventType>
+    void Push(const EventType& event, Dispatcher dispatch) {
+        void* memory = Allocate(sizeof(EventType), alignof(EventType));
+
+        // Grow the entry list before constructing, so a throwing push_back
+        // cannot leave a live event that nothing will destroy
+        m_entries.push_back({nullptr, dispatch, &EventQueue::Destroy<EventType>});
+        try {
+            m_entries.back().event = new (memory) EventType(event);
+        }
+        catch (...) {
+            m_entries.pop_back();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Dispatches every queued event in order, then empties the queue.
+     * @param system The event system to dispatch through.
+     */
+    void Drain(EventSystem& system);
+
+    /**
+     * @brief Destroys every queued event without dispatching it.
+     */
+    void Clear();
+
+    /**
+     * @brief Exchanges the contents of two queues without copying events.
+     * @param other The queue to swap with.
+     */
+    void Swap(EventQueue& other) noexcept;
+
+    /**
+     * @brief Checks whether the queue holds any events.
+     * @return True if the queue is empty, false otherwise.
+     */
+    bool Empty() const { return m_entries.empty(); }
+
+    /**
+     * @brief Gets the number of queued events.
+     * @return The number of events.
+     */
+    size_t Size() const { return m_entries.size(); }
+
+private:
+    /**
+     * @brief Signature of the destructor thunk stored with each queued event.
+     */
+    using Destroyer = void (*)(Event*);
+
+    /**
+     * @brief A queued event and the functions that know its concrete type.
+     */
+    struct Entry {
+        Event* event;
+        Dispatcher dispatch;
+        Destroyer destroy;
+    };
+
+    /**
+     * @brief A block of raw storage that events are constructed into.
+     */
+    struct Chunk {
+        std::unique_ptr<std::byte[]> data;
+        size_t capacity = 0;
+        size_t used = 0;
+        MemoryCharge charge{MemoryTag::Events};
+    };
+
+    /**
+     * @brief Reserves aligned storage for one event.
+     * @param size Size of the event in bytes.
+     * @param alignment Required alignment of the event.
+     * @return Pointer to uninitialized storage.
+     */
+    void* Allocate(size_t size, size_t alignment);
+
+    /**
+     * @brief Destroys every event and rewinds the chunks for reuse.
+     */
+    void Reset();
+
+    /**
+     * @brief Runs the destructor of a queued event.
+     * @tparam EventType The concrete event type.
+     * @param event The event to destroy.
+     */
+    template<typename EventType>
+    static void Destroy(Event* event) {
+        static_cast<EventType*>(event)->~EventType();
+    }
+
+    static constexpr size_t kChunkSize = 64 * 1024;  ///< Default chunk size in bytes
+
+    std::vector<Chunk> m_chunks;       ///< Storage chunks, retained across drains
+    size_t m_currentChunk;             ///< Index of the chunk being filled
+    std::vector<Entry> m_entries;      ///< Queued events in publication order
+};
+
+} // namespace poe
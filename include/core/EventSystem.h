@@ -6,7 +6,11 @@
 #include <unordered_map>
 #include <vector>
 #include <mutex>
-#include <any>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+#include "core/EventQueue.h"
+#include "core/TraceRing.h"
 
 namespace poe {
 
@@ -45,6 +49,35 @@ public:
 template<typename EventType>
 using EventHandler = std::function<void(const EventType&)>;
 
+/**
+ * @brief Dense, process-wide identifier for an event type.
+ *
+ * IDs are handed out on first use, starting at zero, so they can index a
+ * plain vector of channels instead of a string-keyed map.
+ */
+using EventTypeId = size_t;
+
+namespace detail {
+
+/**
+ * @brief Allocates the next free event type ID.
+ * @return A new, unique event type ID.
+ */
+EventTypeId AllocateEventTypeId();
+
+} // namespace detail
+
+/**
+ * @brief Gets the dense type ID for an event type.
+ * @tparam EventType The event type.
+ * @return The ID shared by every publication and subscription of EventType.
+ */
+template<typename EventType>
+EventTypeId GetEventTypeId() {
+    static const EventTypeId id = detail::AllocateEventTypeId();
+    return id;
+}
+
 /**
  * @class EventSystem
  * @brief Manages event subscriptions and dispatching.
@@ -82,6 +115,30 @@ public:
      */
     void ProcessEvents();
 
+    /**
+     * @brief Blocks until an event is queued or Wake() is called.
+     *
+     * Returns immediately if events are already pending. Lets a main loop
+     * sleep for as long as nothing happens instead of polling.
+     */
+    void WaitForEvents();
+
+    /**
+     * @brief Releases a thread blocked in WaitForEvents() and runs the wake handler. Thread-safe.
+     */
+    void Wake();
+
+    /**
+     * @brief Sets a function to run whenever the queue stops being empty.
+     *
+     * For loops that block on something other than WaitForEvents(), such
+     * as a Win32 message wait; the handler typically signals an event
+     * object. It runs on the publishing thread with the queue locked, so it
+     * must be short and must not publish.
+     * @param handler The handler, or an empty function to remove it.
+     */
+    void SetWakeHandler(std::function<void()> handler);
+
     /**
      * @brief Publishes an event to subscribers.
      * @tparam EventType The type of event to publish.
@@ -91,16 +148,24 @@ public:
     void Publish(const EventType& event) {
         static_assert(std::is_base_of<Event, EventType>::value, "EventType must derive from Event");
         
-        const auto typeName = event.GetTypeName();
-        
-        // Log the event
-        m_app.GetLogger().Debug("Publishing event: {}", event.ToString());
+        // Log the event, only formatting it if debug output is enabled
+        if (m_app.GetLogger().IsEnabled(1)) {
+            m_app.GetLogger().Debug("Publishing event: {}", event.ToString());
+        }
         
-        // Store event in queue for deferred processing
+        // Copy the event into the queue arena, together with its typed dispatcher
         {
             std::lock_guard<std::mutex> lock(m_queueMutex);
-            m_eventQueue.push_back(std::make_shared<EventType>(event));
+            bool wasEmpty = m_eventQueue.Empty();
+            m_eventQueue.Push(event, &EventSystem::DispatchErased<EventType>);
+            
+            // Only the first event of a batch needs to wake the consumer
+            if (wasEmpty) {
+                NotifyQueued();
+            }
         }
+        
+        m_app.GetTraceRing().Emit(TraceEvent::EventPublished, static_cast<int64_t>(GetEventTypeId<EventType>()));
     }
 
     /**
@@ -112,10 +177,10 @@ public:
     void PublishImmediate(const EventType& event) {
         static_assert(std::is_base_of<Event, EventType>::value, "EventType must derive from Event");
         
-        const auto typeName = event.GetTypeName();
-        
-        // Log the event
-        m_app.GetLogger().Debug("Publishing immediate event: {}", event.ToString());
+        // Log the event, only formatting it if debug output is enabled
+        if (m_app.GetLogger().IsEnabled(1)) {
+            m_app.GetLogger().Debug("Publishing immediate event: {}", event.ToString());
+        }
         
         // Dispatch event immediately
         DispatchEvent<EventType>(event);
@@ -131,20 +196,21 @@ public:
     size_t Subscribe(const EventHandler<EventType>& handler) {
         static_assert(std::is_base_of<Event, EventType>::value, "EventType must derive from Event");
         
-        const auto typeName = EventType().GetTypeName();
+        const EventTypeId typeId = GetEventTypeId<EventType>();
         
         std::lock_guard<std::mutex> lock(m_handlersMutex);
         
-        // Get or create handler vector for this event type
-        auto& handlers = m_handlers[typeName];
+        // Get or create the typed channel for this event type
+        auto& channel = GetOrCreateChannel<EventType>(typeId);
         
         // Generate a unique handler ID
         size_t handlerId = m_nextHandlerId++;
         
-        // Store handler with its ID
-        handlers.push_back({handlerId, std::any(handler)});
+        // Publish a new handler list with the handler appended, and remember its channel for unsubscribing
+        channel.Add(handlerId, handler);
+        m_handlerChannels[handlerId] = typeId;
         
-        m_app.GetLogger().Debug("Subscribed to event: {} (Handler ID: {})", typeName, handlerId);
+        m_app.GetLogger().Debug("Subscribed to event type {} (Handler ID: {})", typeId, handlerId);
         
         return handlerId;
     }
@@ -158,13 +224,96 @@ public:
 
 private:
     /**
-     * @brief Internal structure for storing event handlers with their IDs.
+     * @brief Type-erased base for per-type handler channels.
      */
-    struct HandlerEntry {
-        size_t id;
-        std::any handler;
+    struct ChannelBase {
+        virtual ~ChannelBase() = default;
+
+        /**
+         * @brief Removes a handler from this channel.
+         * @param handlerId The ID of the handler to remove.
+         * @return True if the handler was found and removed, false otherwise.
+         */
+        virtual bool Remove(size_t handlerId) = 0;
     };
 
+    /**
+     * @brief Handler list for a single event type, stored without type erasure.
+     *
+     * The list is copy-on-write: dispatch loads an immutable snapshot without
+     * locking, while Add and Remove (called with m_handlersMutex held) publish
+     * a modified copy. A dispatch in flight keeps its snapshot alive.
+     * @tparam EventType The event type handled by this channel.
+     */
+    template<typename EventType>
+    struct Channel : ChannelBase {
+        struct Entry {
+            size_t id;
+            EventHandler<EventType> handler;
+        };
+
+        using HandlerList = std::vector<Entry>;
+
+        std::atomic<std::shared_ptr<const HandlerList>> handlers{std::make_shared<const HandlerList>()};
+
+        void Add(size_t handlerId, const EventHandler<EventType>& handler) {
+            auto updated = std::make_shared<HandlerList>(*handlers.load(std::memory_order_acquire));
+            updated->push_back({handlerId, handler});
+            handlers.store(std::move(updated), std::memory_order_release);
+        }
+
+        bool Remove(size_t handlerId) override {
+            auto current = handlers.load(std::memory_order_acquire);
+            auto updated = std::make_shared<HandlerList>();
+            updated->reserve(current->size());
+            
+            for (const auto& entry : *current) {
+                if (entry.id != handlerId) {
+                    updated->push_back(entry);
+                }
+            }
+            
+            if (updated->size() == current->size()) {
+                return false;
+            }
+            
+            handlers.store(std::move(updated), std::memory_order_release);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Channel table indexed by event type ID; replaced as a whole when it grows.
+     */
+    using ChannelTable = std::vector<std::shared_ptr<ChannelBase>>;
+
+    /**
+     * @brief Gets the channel for an event type, creating it if needed.
+     * @tparam EventType The event type.
+     * @param typeId The dense type ID of EventType.
+     * @return Reference to the channel. Must be called with m_handlersMutex held.
+     */
+    template<typename EventType>
+    Channel<EventType>& GetOrCreateChannel(EventTypeId typeId) {
+        auto table = m_channels.load(std::memory_order_acquire);
+        
+        if (typeId < table->size() && (*table)[typeId]) {
+            return static_cast<Channel<EventType>&>(*(*table)[typeId]);
+        }
+        
+        // Publish a new table containing the new channel
+        auto updated = std::make_shared<ChannelTable>(*table);
+        if (typeId >= updated->size()) {
+            updated->resize(typeId + 1);
+        }
+        
+        auto channel = std::make_shared<Channel<EventType>>();
+        (*updated)[typeId] = channel;
+        m_channels.store(std::move(updated), std::memory_order_release);
+        
+        return *channel;
+    }
+
     /**
      * @brief Dispatches an event to its subscribers.
      * @tparam EventType The type of event to dispatch.
@@ -172,35 +321,41 @@ private:
      */
     template<typename EventType>
     void DispatchEvent(const EventType& event) {
-        const auto typeName = event.GetTypeName();
+        const EventTypeId typeId = GetEventTypeId<EventType>();
         
-        std::lock_guard<std::mutex> lock(m_handlersMutex);
-        
-        auto it = m_handlers.find(typeName);
-        if (it == m_handlers.end()) {
+        // Lock-free snapshot reads; handlers may freely (un)subscribe or publish
+        auto table = m_channels.load(std::memory_order_acquire);
+        if (typeId >= table->size() || !(*table)[typeId]) {
             return; // No handlers for this event type
         }
         
+        auto& channel = static_cast<Channel<EventType>&>(*(*table)[typeId]);
+        auto handlers = channel.handlers.load(std::memory_order_acquire);
+        
+        ScopedTraceEvent trace(m_app.GetTraceRing(), TraceEvent::EventDispatched,
+            static_cast<int64_t>(typeId), static_cast<int64_t>(handlers->size()));
+        
         // Call each handler
-        for (const auto& entry : it->second) {
+        for (const auto& entry : *handlers) {
             try {
-                const auto& handler = std::any_cast<EventHandler<EventType>>(entry.handler);
-                handler(event);
-            }
-            catch (const std::bad_any_cast&) {
-                m_app.GetLogger().Error("Failed to cast event handler for type: {}", typeName);
+                entry.handler(event);
             }
             catch (const std::exception& e) {
-                m_app.GetLogger().Error("Exception in event handler for {}: {}", typeName, e.what());
+                m_app.GetLogger().Error("Exception in event handler for {}: {}", event.GetTypeName(), e.what());
             }
         }
     }
 
     /**
-     * @brief Dispatches an event from the queue.
-     * @param event The event to dispatch.
+     * @brief Restores the concrete type of a queued event and dispatches it.
+     * @tparam EventType The concrete type the event was published as.
+     * @param system The event system to dispatch through.
+     * @param event The queued event.
      */
-    void DispatchQueuedEvent(const std::shared_ptr<Event>& event);
+    template<typename EventType>
+    static void DispatchErased(EventSystem& system, const Event& event) {
+        system.DispatchEvent<EventType>(static_cast<const EventType&>(event));
+    }
 
     /**
      * @brief Reference to the main application instance.
@@ -208,25 +363,60 @@ private:
     Application& m_app;
 
     /**
-     * @brief Map of event type names to their handlers.
+     * @brief Current channel table snapshot, indexed by event type ID.
      */
-    std::unordered_map<std::string, std::vector<HandlerEntry>> m_handlers;
+    std::atomic<std::shared_ptr<const ChannelTable>> m_channels;
 
     /**
-     * @brief Mutex for thread-safe access to handlers.
+     * @brief Map of handler IDs to the type ID of the channel they live in.
+     */
+    std::unordered_map<size_t, EventTypeId> m_handlerChannels;
+
+    /**
+     * @brief Mutex serializing subscription changes; dispatch never takes it.
      */
     std::mutex m_handlersMutex;
 
+    /**
+     * @brief Wakes the consumer of the queue. Must be called with m_queueMutex held.
+     */
+    void NotifyQueued();
+
     /**
      * @brief Queue of pending events to be processed.
      */
-    std::vector<std::shared_ptr<Event>> m_eventQueue;
+    EventQueue m_eventQueue;
+
+    /**
+     * @brief Batch currently being dispatched; swapped with m_eventQueue by ProcessEvents.
+     */
+    EventQueue m_processingQueue;
+
+    /**
+     * @brief Whether ProcessEvents is currently draining a batch.
+     */
+    bool m_processing;
 
     /**
      * @brief Mutex for thread-safe access to the event queue.
      */
     std::mutex m_queueMutex;
 
+    /**
+     * @brief Signalled when the queue stops being empty or Wake() is called.
+     */
+    std::condition_variable m_queueCondition;
+
+    /**
+     * @brief Whether Wake() was called since the last WaitForEvents() returned.
+     */
+    bool m_wakeRequested;
+
+    /**
+     * @brief Called by NotifyQueued(); guarded by m_queueMutex.
+     */
+    std::function<void()> m_wakeHandler;
+
     /**
      * @brief Counter for generating unique handler IDs.
      */
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @enum PerfStage
+ * @brief Render pipeline stages that are timed by the frame profiler.
+ */
+enum class PerfStage : size_t {
+    CefPaint,           ///< CEF OnPaint callback, end to end
+    BrowserViewPaint,   ///< BrowserView::OnPaint (rect conversion and mailbox publish)
+    ContentUpload,      ///< Uploading browser pixels into the content texture and presenting
+    CompositeRender,    ///< CompositeRenderer::Render, end to end
+    BorderRender,       ///< BorderRenderer::Render
+    CompositionCommit,  ///< IDCompositionDevice::Commit
+    HotkeyLatency,      ///< Raw key press on the input thread to the hotkey callback
+    Count
+};
+
+/**
+ * @struct PerfStageStats
+ * @brief Summary of the samples recorded for one stage.
+ */
+struct PerfStageStats {
+    const char* name = "";      ///< Stage name
+    uint64_t count = 0;         ///< Number of samples
+    double meanUs = 0.0;        ///< Mean duration in microseconds
+    uint64_t p50Us = 0;         ///< Median duration in microseconds
+    uint64_t p95Us = 0;         ///< 95th percentile duration in microseconds
+    uint64_t p99Us = 0;         ///< 99th percentile duration in microseconds
+    uint64_t maxUs = 0;         ///< Longest duration in microseconds
+};
+
+/**
+ * @class FrameProfiler
+ * @brief Collects per-stage timing histograms for the render pipeline.
+ *
+ * Recording is lock-free and allocation-free: each sample increments one
+ * atomic counter in a log-linear histogram (8 sub-buckets per power of two,
+ * so percentiles are accurate to within 12.5%). Stages may be recorded from
+ * any thread, which matters because CEF paints on its UI thread while the
+ * compositor renders on ours.
+ */
+class FrameProfiler {
+public:
+    /**
+     * @brief Constructor for the FrameProfiler class.
+     * @param app Reference to the main application instance.
+     */
+    explicit FrameProfiler(Application& app);
+
+    /**
+     * @brief Destructor for the FrameProfiler class.
+     */
+    ~FrameProfiler();
+
+    /**
+     * @brief Initializes the profiler.
+     * @return True if initialization was successful, false otherwise.
+     */
+    bool Initialize();
+
+    /**
+     * @brief Shuts down the profiler.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Records one sample for a stage.
+     * @param stage The pipeline stage.
+     * @param microseconds The measured duration.
+     */
+    void Record(PerfStage stage, uint64_t microseconds);
+
+    /**
+     * @brief Counts one presented frame.
+     */
+    void MarkFrame();
+
+    /**
+     * @brief Gets the number of frames counted since the last reset.
+     * @return The frame count.
+     */
+    uint64_t GetFrameCount() const;
+
+    /**
+     * @brief Computes summary statistics for every stage.
+     * @return One entry per stage, in PerfStage order.
+     */
+    std::vector<PerfStageStats> GetStats() const;
+
+    /**
+     * @brief Formats the current statistics as a plain-text table.
+     * @return The report.
+     */
+    std::string FormatReport() const;
+
+    /**
+     * @brief Writes the current report to a file.
+     * @param path The file to write.
+     * @return True if the file was written, false otherwise.
+     */
+    bool DumpToFile(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Clears all samples and counters.
+     */
+    void Reset();
+
+    /**
+     * @brief Gets the display name of a stage.
+     * @param stage The pipeline stage.
+     * @return The stage name.
+     */
+    static const char* GetStageName(PerfStage stage);
+
+private:
+    static constexpr size_t kStageCount = static_cast<size_t>(PerfStage::Count);
+    static constexpr size_t kLinearBuckets = 16;   ///< Exact buckets for 0-15 us
+    static constexpr size_t kSubBuckets = 8;       ///< Sub-buckets per power of two above that
+    static constexpr size_t kBucketCount = kLinearBuckets + (64 - 4) * kSubBuckets;
+
+    /**
+     * @brief Histogram and running totals for one stage.
+     */
+    struct StageHistogram {
+        std::array<std::atomic<uint32_t>, kBucketCount> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> totalUs{0};
+        std::atomic<uint64_t> maxUs{0};
+    };
+
+    /**
+     * @brief Maps a duration to its histogram bucket.
+     * @param microseconds The duration.
+     * @return The bucket index.
+     */
+    static size_t BucketIndex(uint64_t microseconds);
+
+    /**
+     * @brief Gets the upper bound of a histogram bucket.
+     * @param index The bucket index.
+     * @return The largest duration, in microseconds, that maps to the bucket.
+     */
+    static uint64_t BucketUpperBound(size_t index);
+
+    Application& m_app;                                ///< Reference to the main application
+    std::array<StageHistogram, kStageCount> m_stages;  ///< Per-stage histograms
+    std::atomic<uint64_t> m_frameCount{0};             ///< Frames counted since the last reset
+    std::chrono::steady_clock::time_point m_startTime; ///< Time of the last reset
+};
+
+/**
+ * @class ScopedPerfTimer
+ * @brief Records the lifetime of a scope as one sample of a stage.
+ */
+class ScopedPerfTimer {
+public:
+    /**
+     * @brief Starts timing a stage.
+     * @param profiler The profiler to record into.
+     * @param stage The pipeline stage being timed.
+     */
+    ScopedPerfTimer(FrameProfiler& profiler, PerfStage stage)
+        : m_profiler(profiler), m_stage(stage), m_start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Stops timing and records the sample.
+     */
+    ~ScopedPerfTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_profiler.Record(m_stage, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    // Non-copyable
+    ScopedPerfTimer(const ScopedPerfTimer&) = delete;
+    ScopedPerfTimer& operator=(const ScopedPerfTimer&) = delete;
+
+private:
+    FrameProfiler& m_profiler;                       ///< Profiler receiving the sample
+    PerfStage m_stage;                               ///< Stage being timed
+    std::chrono::steady_clock::time_point m_start;   ///< Start of the scope
+};
+
+} // namespace poe
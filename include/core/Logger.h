@@ -1,13 +1,33 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <filesystem>
+#include <utility>
+#include <spdlog/fmt/fmt.h>
+#include "core/MemoryTracker.h"
+
+/**
+ * Lowest level compiled into the binary (0=trace ... 6=off). Calls below it
+ * are removed at compile time. Release builds keep info and above; debug
+ * builds keep everything.
+ */
+#ifndef POE_LOG_COMPILED_LEVEL
+#ifdef NDEBUG
+#define POE_LOG_COMPILED_LEVEL 2
+#else
+#define POE_LOG_COMPILED_LEVEL 0
+#endif
+#endif
 
 // Forward declarations for spdlog classes
 namespace spdlog {
     class logger;
+    namespace details {
+        class thread_pool;
+    }
 }
 
 namespace poe {
@@ -15,12 +35,19 @@ namespace poe {
 // Forward declarations
 class Application;
 
+/// Lowest level compiled in; see POE_LOG_COMPILED_LEVEL
+inline constexpr int kCompiledLogLevel = POE_LOG_COMPILED_LEVEL;
+
 /**
  * @class Logger
  * @brief Provides logging functionality for the application.
  * 
  * This class is a wrapper around spdlog providing formatted logging
  * at various levels with file and console output capabilities.
+ *
+ * By default messages are formatted on the calling thread and queued to a
+ * bounded ring drained by one background thread, which alone touches the
+ * sinks, so file and console I/O never runs on the render or CEF threads.
  */
 class Logger {
 public:
@@ -46,12 +73,32 @@ public:
      */
     void Shutdown();
 
+    /**
+     * @brief Applies the "logging.*" settings.
+     *
+     * Called once the settings are loaded; rebuilds the backend if the
+     * async mode, queue size or overflow policy changed.
+     */
+    void ApplySettings();
+
     /**
      * @brief Sets the log level.
      * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical, 6=off).
      */
     void SetLevel(int level);
 
+    /**
+     * @brief Checks whether a message at the given level would reach any sink.
+     *
+     * Callers use this to skip building expensive arguments (such as
+     * ToString() output) for messages that would be discarded anyway.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @return True if the message would be logged, false otherwise.
+     */
+    bool IsEnabled(int level) const {
+        return level >= kCompiledLogLevel && level >= m_activeLevel.load(std::memory_order_relaxed);
+    }
+
     /**
      * @brief Sets the log file path.
      * @param path The path to the log file.
@@ -70,15 +117,25 @@ public:
      */
     void EnableConsoleLogging(bool enable);
 
+    /**
+     * @brief Switches between the asynchronous and synchronous backends.
+     * @param enable Whether to queue messages to the background thread.
+     * @param queueSize Capacity of the message queue, in messages.
+     * @param dropOnOverflow Whether a full queue drops its oldest message instead of blocking the caller.
+     */
+    void SetAsyncMode(bool enable, size_t queueSize, bool dropOnOverflow);
+
     /**
      * @brief Logs a message at trace level.
      * @tparam Args Variadic template for format arguments.
-     * @param fmt Format string.
+     * @param fmt Format string, checked against the arguments at compile time.
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Trace(std::string_view fmt, const Args&... args) {
-        Log(0, fmt, args...);
+    void Trace(fmt::format_string<Args...> fmt, Args&&... args) {
+        if constexpr (0 >= kCompiledLogLevel) {
+            Log(0, fmt, std::forward<Args>(args)...);
+        }
     }
 
     /**
@@ -88,8 +145,10 @@ public:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Debug(std::string_view fmt, const Args&... args) {
-        Log(1, fmt, args...);
+    void Debug(fmt::format_string<Args...> fmt, Args&&... args) {
+        if constexpr (1 >= kCompiledLogLevel) {
+            Log(1, fmt, std::forward<Args>(args)...);
+        }
     }
 
     /**
@@ -99,8 +158,8 @@ public:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Info(std::string_view fmt, const Args&... args) {
-        Log(2, fmt, args...);
+    void Info(fmt::format_string<Args...> fmt, Args&&... args) {
+        Log(2, fmt, std::forward<Args>(args)...);
     }
 
     /**
@@ -110,8 +169,8 @@ public:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Warning(std::string_view fmt, const Args&... args) {
-        Log(3, fmt, args...);
+    void Warning(fmt::format_string<Args...> fmt, Args&&... args) {
+        Log(3, fmt, std::forward<Args>(args)...);
     }
 
     /**
@@ -121,8 +180,8 @@ public:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Error(std::string_view fmt, const Args&... args) {
-        Log(4, fmt, args...);
+    void Error(fmt::format_string<Args...> fmt, Args&&... args) {
+        Log(4, fmt, std::forward<Args>(args)...);
     }
 
     /**
@@ -132,20 +191,35 @@ public:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Critical(std::string_view fmt, const Args&... args) {
-        Log(5, fmt, args...);
+    void Critical(fmt::format_string<Args...> fmt, Args&&... args) {
+        Log(5, fmt, std::forward<Args>(args)...);
     }
 
-private:
     /**
-     * @brief Internal logging function.
+     * @brief Logs a message at a level chosen at run time.
+     *
+     * The level is checked before any formatting happens; a disabled call
+     * costs one relaxed load and a compare.
      * @tparam Args Variadic template for format arguments.
-     * @param level The log level.
-     * @param fmt Format string.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string, checked against the arguments at compile time.
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, std::string_view fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        if (IsEnabled(level)) {
+            Write(level, fmt.get(), fmt::make_format_args(args...));
+        }
+    }
+
+private:
+    /**
+     * @brief Formats a message and hands it to the backend.
+     * @param level The log level.
+     * @param fmt Format string.
+     * @param args Type-erased format arguments.
+     */
+    void Write(int level, fmt::string_view fmt, fmt::format_args args);
 
     /**
      * @brief Creates the logger backends.
@@ -171,6 +245,60 @@ private:
      * @brief Whether console logging is enabled.
      */
     bool m_consoleLoggingEnabled;
+
+    /**
+     * @brief Whether messages go through the background thread.
+     */
+    bool m_asyncEnabled;
+
+    /**
+     * @brief Capacity of the async message queue.
+     */
+    size_t m_queueSize;
+
+    /**
+     * @brief Whether a full queue drops its oldest message instead of blocking.
+     */
+    bool m_dropOnOverflow;
+
+    /**
+     * @brief Current log level, kept across backend rebuilds.
+     */
+    int m_level;
+
+    /**
+     * @brief Level checked inline by IsEnabled(); off (6) while there is no backend.
+     */
+    std::atomic<int> m_activeLevel;
+
+    /**
+     * @brief Queue and worker thread of the async backend.
+     */
+    std::shared_ptr<spdlog::details::thread_pool> m_threadPool;
+
+    /**
+     * @brief Preallocated message slots of m_threadPool.
+     */
+    MemoryCharge m_queueCharge;
 };
 
+/**
+ * @brief Logs through a logger that may not exist yet or any more.
+ *
+ * Backs the private Log() helper each component declares, so the level
+ * check and the compile-time format check live in one place.
+ * @tparam Args Variadic template for format arguments.
+ * @param logger The logger, or nullptr to drop the message.
+ * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+ * @param fmt Format string, checked against the arguments at compile time.
+ * @param args Format arguments.
+ */
+template<typename... Args>
+void LogTo(Logger* logger, int level, fmt::format_string<Args...> fmt, Args&&... args)
+{
+    if (level >= kCompiledLogLevel && logger) {
+        logger->Log(level, fmt, std::forward<Args>(args)...);
+    }
+}
+
 } // namespace poe
\ No newline at end of file
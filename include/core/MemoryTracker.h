@@ -0,0 +1,256 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @enum MemoryTag
+ * @brief Subsystems whose memory is accounted separately.
+ */
+enum class MemoryTag : size_t {
+    Events,         ///< Event queue storage
+    Logs,           ///< Async log queue and event trace ring
+    Resources,      ///< Mapped bundles, assets and caches
+    FrameBuffers,   ///< Browser frames waiting for the compositor
+    GpuSurfaces,    ///< Composition surfaces (estimated from their size)
+    Count
+};
+
+/**
+ * @struct MemoryTagStats
+ * @brief Current accounting of one tag.
+ */
+struct MemoryTagStats {
+    const char* name = "";      ///< Tag name
+    uint64_t bytes = 0;         ///< Bytes currently charged
+    uint64_t peakBytes = 0;     ///< Most bytes charged at once since the last reset
+    uint64_t charges = 0;       ///< Live charges (allocations) carrying bytes
+    uint64_t budgetBytes = 0;   ///< Budget, or 0 for none
+};
+
+/**
+ * @struct ProcessMemoryStats
+ * @brief One sample of a process's memory counters.
+ */
+struct ProcessMemoryStats {
+    uint32_t processId = 0;         ///< Process ID
+    std::string name;               ///< Executable name
+    bool self = false;              ///< Whether this is the overlay process itself
+    uint64_t privateBytes = 0;      ///< Committed private memory
+    uint64_t workingSetBytes = 0;   ///< Resident memory
+    uint64_t peakWorkingSetBytes = 0; ///< Largest working set so far
+};
+
+/**
+ * @class MemoryTracker
+ * @brief Accounts the overlay's memory by subsystem and watches the CEF processes.
+ *
+ * Subsystems charge what they hold through MemoryCharge; the counters are
+ * process-wide relaxed atomics, so charging is lock-free, works from any
+ * thread and before Application exists (frame mailboxes are created long
+ * before anything could hold a reference). Charges are sizes of the big
+ * buffers, not of every allocation; what is left over shows as the gap to
+ * the process's private bytes.
+ *
+ * A sampler thread reads GetProcessMemoryInfo of the overlay and of every
+ * child process (the CEF renderer, GPU and utility processes) every
+ * "memory.sampleIntervalMs". Budgets are read from "memory.budgetMB.<tag>"
+ * and "memory.budgetMB.processes" (private bytes of all sampled processes);
+ * crossing one reports a warning through the ErrorHandler, once until it
+ * drops below again. Everything is shown on poe://perf.
+ */
+class MemoryTracker {
+public:
+    /**
+     * @brief Constructor for the MemoryTracker class.
+     * @param app Reference to the main application instance.
+     */
+    explicit MemoryTracker(Application& app);
+
+    /**
+     * @brief Destructor for the MemoryTracker class.
+     */
+    ~MemoryTracker();
+
+    // Non-copyable
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    /**
+     * @brief Reads the budgets and starts the sampler thread.
+     * @return True if initialization was successful, false otherwise.
+     */
+    bool Initialize();
+
+    /**
+     * @brief Stops the sampler thread.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Charges one allocation to a tag.
+     * @param tag The tag.
+     * @param bytes Size of the allocation.
+     */
+    static void Charge(MemoryTag tag, size_t bytes) noexcept;
+
+    /**
+     * @brief Releases an allocation charged with Charge().
+     * @param tag The tag.
+     * @param bytes Size the allocation was charged with.
+     */
+    static void Release(MemoryTag tag, size_t bytes) noexcept;
+
+    /**
+     * @brief Gets the accounting of every tag.
+     * @return One entry per tag, in MemoryTag order.
+     */
+    std::vector<MemoryTagStats> GetTagStats() const;
+
+    /**
+     * @brief Gets the latest process sample.
+     * @return The overlay process first, then its children.
+     */
+    std::vector<ProcessMemoryStats> GetProcessStats() const;
+
+    /**
+     * @brief Samples the processes and checks the budgets now.
+     */
+    void Sample();
+
+    /**
+     * @brief Formats the current accounting and the latest sample as plain text.
+     * @return The report.
+     */
+    std::string FormatReport() const;
+
+    /**
+     * @brief Restarts the peaks from the current values.
+     */
+    void ResetPeaks();
+
+    /**
+     * @brief Gets the display name of a tag.
+     * @param tag The tag.
+     * @return The tag name.
+     */
+    static const char* GetTagName(MemoryTag tag);
+
+private:
+    static constexpr size_t kTagCount = static_cast<size_t>(MemoryTag::Count);
+
+    /**
+     * @brief Main loop of the sampler thread.
+     */
+    void SamplerThread();
+
+    /**
+     * @brief Reads the memory counters of the overlay and its children.
+     * @return The overlay process first, then its children.
+     */
+    static std::vector<ProcessMemoryStats> SampleProcesses();
+
+    /**
+     * @brief Reports a budget crossing once, and re-arms once back under it.
+     * @param index Which budget: a tag index, or kTagCount for the processes.
+     * @param name Name of what is measured.
+     * @param bytes Current bytes.
+     * @param budgetBytes The budget, or 0 for none.
+     */
+    void CheckBudget(size_t index, const char* name, uint64_t bytes, uint64_t budgetBytes);
+
+    Application& m_app;                                 ///< Reference to the main application
+    std::array<uint64_t, kTagCount> m_budgets{};        ///< Per-tag budgets in bytes, 0 for none
+    uint64_t m_processBudget;                           ///< Budget for all sampled processes, 0 for none
+    std::array<bool, kTagCount + 1> m_overBudget{};     ///< Which budgets were reported as exceeded
+    std::chrono::milliseconds m_sampleInterval;         ///< Time between process samples
+
+    mutable std::mutex m_sampleMutex;                   ///< Guards m_processes and m_overBudget
+    std::vector<ProcessMemoryStats> m_processes;        ///< Latest process sample
+
+    std::thread m_samplerThread;                        ///< Thread sampling the processes
+    std::mutex m_threadMutex;                           ///< Guards m_running
+    std::condition_variable m_threadCondition;          ///< Signalled when the sampler thread stops
+    bool m_running;                                     ///< Whether the sampler thread should keep running
+};
+
+/**
+ * @class MemoryCharge
+ * @brief Keeps one buffer's size charged to a tag for as long as it lives.
+ *
+ * Owners call Set() whenever the buffer grows or shrinks; moving the
+ * charge moves it with the buffer, and destroying it releases it.
+ */
+class MemoryCharge {
+public:
+    /**
+     * @brief Creates an empty charge.
+     * @param tag The tag to charge.
+     */
+    explicit MemoryCharge(MemoryTag tag) noexcept : m_tag(tag), m_bytes(0) {}
+
+    /**
+     * @brief Releases the charge.
+     */
+    ~MemoryCharge() { Set(0); }
+
+    MemoryCharge(MemoryCharge&& other) noexcept : m_tag(other.m_tag), m_bytes(other.m_bytes) {
+        other.m_bytes = 0;
+    }
+
+    MemoryCharge& operator=(MemoryCharge&& other) noexcept {
+        if (this != &other) {
+            Set(0);
+            m_tag = other.m_tag;
+            m_bytes = other.m_bytes;
+            other.m_bytes = 0;
+        }
+        return *this;
+    }
+
+    // Non-copyable: a copy would release the bytes twice
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+    /**
+     * @brief Changes the bytes charged.
+     * @param bytes Bytes now held.
+     */
+    void Set(size_t bytes) noexcept {
+        if (bytes == m_bytes) {
+            return;
+        }
+        if (m_bytes) {
+            MemoryTracker::Release(m_tag, m_bytes);
+        }
+        if (bytes) {
+            MemoryTracker::Charge(m_tag, bytes);
+        }
+        m_bytes = bytes;
+    }
+
+    /**
+     * @brief Gets the bytes charged.
+     * @return The bytes.
+     */
+    size_t Get() const noexcept { return m_bytes; }
+
+private:
+    MemoryTag m_tag;    ///< Tag charged
+    size_t m_bytes;     ///< Bytes charged
+};
+
+} // namespace poe
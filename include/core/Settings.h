@@ -3,9 +3,17 @@
 #include <string>
 #include <unordered_map>
 #include <any>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <filesystem>
+#include <thread>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace poe {
@@ -13,6 +21,33 @@ namespace poe {
 // Forward declarations
 class Application;
 
+/**
+ * @struct SettingsSnapshot
+ * @brief Immutable, typed copy of the settings read outside of startup.
+ *
+ * Published as a whole after every change, so readers get a consistent set
+ * of values with one atomic load and no lock, key lookup or any_cast.
+ */
+struct SettingsSnapshot {
+    uint64_t revision = 0;                  ///< Increases with every published change
+
+    int windowX = 100;                      ///< "window.x"
+    int windowY = 100;                      ///< "window.y"
+    int windowWidth = 800;                  ///< "window.width"
+    int windowHeight = 600;                 ///< "window.height"
+    double windowOpacity = 0.9;             ///< "window.opacity"
+
+    std::string toggleHotkey = "Alt+B";     ///< "hotkey.toggle"
+    std::string interactiveHotkey = "Alt+I"; ///< "hotkey.interactive"
+
+    int focusedFrameRate = 60;              ///< "browser.focusedFrameRate"
+    int idleFrameRate = 5;                  ///< "browser.idleFrameRate"
+    int hiddenFrameRate = 0;                ///< "browser.hiddenFrameRate"
+
+    bool suspendWhenHidden = true;          ///< "performance.suspendWhenHidden"
+    bool throttleWhenGameActive = true;     ///< "performance.throttleWhenGameActive"
+};
+
 /**
  * @class Settings
  * @brief Manages application settings and configuration.
@@ -20,9 +55,21 @@ class Application;
  * This class provides a thread-safe interface for storing, retrieving, and
  * persisting application settings. It supports various data types and
  * automatic serialization/deserialization to/from JSON.
+ *
+ * Keyed access goes through the map under a mutex and suits startup code.
+ * Anything read repeatedly should use GetSnapshot() instead.
+ *
+ * Changes are written behind: a background thread waits out a short
+ * debounce window so a burst of changes costs one write, serializes a copy
+ * of the map outside the lock and replaces the file atomically.
  */
 class Settings {
 public:
+    /**
+     * @brief Callback invoked after a new snapshot has been published.
+     */
+    using ChangeCallback = std::function<void(const SettingsSnapshot&)>;
+
     /**
      * @brief Constructor for the Settings class.
      * @param app Reference to the main application instance.
@@ -55,16 +102,15 @@ public:
     template<typename T>
     T Get(const std::string& key, const T& defaultValue) const {
         std::lock_guard<std::mutex> lock(m_mutex);
-        auto it = m_settings.find(key);
-        if (it != m_settings.end()) {
-            try {
-                return std::any_cast<T>(it->second);
-            }
-            catch (const std::bad_any_cast&) {
-                return defaultValue;
-            }
-        }
-        return defaultValue;
+        return Lookup(key, defaultValue);
+    }
+
+    /**
+     * @brief Gets the current typed snapshot. Lock-free.
+     * @return The snapshot; stays valid for as long as the caller holds it.
+     */
+    std::shared_ptr<const SettingsSnapshot> GetSnapshot() const {
+        return m_snapshot.load(std::memory_order_acquire);
     }
 
     /**
@@ -75,11 +121,43 @@ public:
      */
     template<typename T>
     void Set(const std::string& key, const T& value) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_settings[key] = value;
-        m_dirty = true;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_settings[key] = value;
+            m_dirty = true;
+        }
+        PublishSnapshot();
+        ScheduleSave();
+    }
+
+    /**
+     * @brief Sets a string setting from a C string.
+     *
+     * Stores a std::string, so the value reads back with Get<std::string>.
+     * @param key The key identifying the setting.
+     * @param value The value to set.
+     */
+    void Set(const std::string& key, const char* value) {
+        Set<std::string>(key, std::string(value));
     }
 
+    /**
+     * @brief Registers a callback for settings changes.
+     *
+     * Callbacks run on the thread that made the change, after the new
+     * snapshot is visible to GetSnapshot().
+     * @param callback The callback to invoke.
+     * @return ID that can be used to unregister the callback.
+     */
+    size_t RegisterChangeCallback(const ChangeCallback& callback);
+
+    /**
+     * @brief Unregisters a change callback.
+     * @param callbackId ID returned by RegisterChangeCallback().
+     * @return True if the callback was unregistered, false if not found.
+     */
+    bool UnregisterChangeCallback(size_t callbackId);
+
     /**
      * @brief Checks if a setting exists.
      * @param key The key identifying the setting.
@@ -95,7 +173,10 @@ public:
     bool RemoveSetting(const std::string& key);
 
     /**
-     * @brief Saves the current settings to disk.
+     * @brief Saves the current settings to disk now, on the calling thread.
+     *
+     * Changes are saved in the background anyway; this is for when the
+     * file must be current before returning.
      * @return True if the settings were saved successfully, false otherwise.
      */
     bool Save();
@@ -126,9 +207,10 @@ public:
 private:
     /**
      * @brief Converts settings to JSON for serialization.
+     * @param settings The settings to convert.
      * @return JSON object containing all settings.
      */
-    nlohmann::json SettingsToJson() const;
+    static nlohmann::json SettingsToJson(const std::unordered_map<std::string, std::any>& settings);
 
     /**
      * @brief Loads settings from JSON after deserialization.
@@ -137,10 +219,74 @@ private:
     void JsonToSettings(const nlohmann::json& json);
 
     /**
-     * @brief Creates default settings if none exist.
+     * @brief Creates default settings if none exist. Must be called with m_mutex held.
      */
     void CreateDefaultSettings();
 
+    /**
+     * @brief Reads a setting from the map. Must be called with m_mutex held.
+     * @tparam T The type of the setting value.
+     * @param key The key identifying the setting.
+     * @param defaultValue The value to return if the key is missing or has another type.
+     * @return The setting value, or the default value.
+     */
+    template<typename T>
+    T Lookup(const std::string& key, const T& defaultValue) const {
+        auto it = m_settings.find(key);
+        if (it != m_settings.end()) {
+            if (const T* value = std::any_cast<T>(&it->second)) {
+                return *value;
+            }
+        }
+        return defaultValue;
+    }
+
+    /**
+     * @brief Rebuilds the snapshot from the map, publishes it and notifies callbacks.
+     */
+    void PublishSnapshot();
+
+    /**
+     * @brief Loads the settings from the binary cache, if it matches the JSON file.
+     * @return True if the cache was current and loaded, false if the JSON must be parsed.
+     */
+    bool LoadCache();
+
+    /**
+     * @brief Writes the binary cache for a settings file.
+     * @param settings The settings to cache.
+     * @param filePath The JSON file the settings were loaded from or saved to.
+     */
+    static void WriteCache(const std::unordered_map<std::string, std::any>& settings, const std::filesystem::path& filePath);
+
+    /**
+     * @brief Asks the save thread to write the settings after the debounce window.
+     */
+    void ScheduleSave();
+
+    /**
+     * @brief Save thread: waits for requests, debounces them and writes.
+     */
+    void SaveThread();
+
+    /**
+     * @brief Starts the save thread.
+     */
+    void StartSaveThread();
+
+    /**
+     * @brief Stops the save thread, writing any pending change first.
+     */
+    void StopSaveThread();
+
+    /**
+     * @brief Structure to store callback information.
+     */
+    struct CallbackEntry {
+        size_t id;                  ///< Unique callback ID
+        ChangeCallback callback;    ///< Callback function
+    };
+
     /**
      * @brief Reference to the main application instance.
      */
@@ -165,6 +311,61 @@ private:
      * @brief Path to the settings file.
      */
     std::filesystem::path m_settingsFilePath;
+
+    /**
+     * @brief Current typed snapshot, replaced as a whole on every change.
+     */
+    std::atomic<std::shared_ptr<const SettingsSnapshot>> m_snapshot;
+
+    /**
+     * @brief Registered change callbacks.
+     */
+    std::vector<CallbackEntry> m_callbacks;
+
+    /**
+     * @brief Mutex for thread-safe access to callbacks.
+     */
+    mutable std::mutex m_callbacksMutex;
+
+    /**
+     * @brief Next callback ID to assign.
+     */
+    size_t m_nextCallbackId;
+
+    /**
+     * @brief Serializes writers of the settings file.
+     */
+    std::mutex m_fileMutex;
+
+    /**
+     * @brief Background thread writing changes.
+     */
+    std::thread m_saveThread;
+
+    /**
+     * @brief Guards m_savePending and m_saveThreadRunning.
+     */
+    std::mutex m_saveMutex;
+
+    /**
+     * @brief Signalled when a save is requested or the save thread stops.
+     */
+    std::condition_variable m_saveCondition;
+
+    /**
+     * @brief Whether a change is waiting to be written.
+     */
+    bool m_savePending;
+
+    /**
+     * @brief Whether the save thread should keep running.
+     */
+    bool m_saveThreadRunning;
+
+    /**
+     * @brief How long the save thread waits for further changes before writing.
+     */
+    std::chrono::milliseconds m_saveDelay;
 };
 
 } // namespace poe
\ No newline at end of file
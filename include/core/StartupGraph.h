@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @enum StartupThread
+ * @brief Where a startup stage runs.
+ */
+enum class StartupThread {
+    Main,       ///< The thread that calls Run(); for windows, COM apartments and CefInitialize
+    Worker      ///< Any WorkerPool thread; for file I/O and device creation
+};
+
+/**
+ * @class StartupGraph
+ * @brief Runs startup stages as a dependency graph, overlapping independent ones.
+ *
+ * Each stage names the stages it depends on and runs once all of them have
+ * succeeded: Worker stages on the application WorkerPool, Main stages on the
+ * caller of Run(), in the order they become ready. A stage that fails or
+ * throws skips everything that depends on it. Per-stage timings are kept for
+ * the startup breakdown.
+ */
+class StartupGraph {
+public:
+    /**
+     * @brief Type of a stage body; returns false on failure.
+     */
+    using Task = std::function<bool()>;
+
+    /**
+     * @brief Timing of one stage, relative to the start of Run().
+     */
+    struct StageTiming {
+        std::string name;           ///< Stage name
+        StartupThread thread;       ///< Where it ran
+        double startMs;             ///< When it started
+        double durationMs;          ///< How long it ran
+        bool succeeded;             ///< Whether it ran and returned true
+        bool skipped;               ///< Whether it was skipped because a dependency failed
+    };
+
+    /**
+     * @brief Constructor for the StartupGraph class.
+     * @param app Reference to the main application instance.
+     */
+    explicit StartupGraph(Application& app);
+
+    // Non-copyable
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    /**
+     * @brief Adds a stage.
+     * @param name Unique stage name.
+     * @param dependencies Names of the stages that must succeed first.
+     * @param thread Where the stage runs.
+     * @param task The stage body.
+     */
+    void AddStage(const std::string& name, std::vector<std::string> dependencies,
+                  StartupThread thread, Task task);
+
+    /**
+     * @brief Runs every stage and waits for all of them.
+     * @return True if every stage succeeded, false otherwise.
+     * @throws std::runtime_error if a dependency names an unknown stage.
+     */
+    bool Run();
+
+    /**
+     * @brief Logs the per-stage timings and how much of the startup overlapped.
+     */
+    void LogBreakdown() const;
+
+    /**
+     * @brief Gets the timings recorded by Run(), in completion order.
+     * @return The stage timings.
+     */
+    const std::vector<StageTiming>& GetTimings() const { return m_timings; }
+
+private:
+    /**
+     * @brief One registered stage.
+     */
+    struct Stage {
+        std::string name;                       ///< Stage name
+        std::vector<std::string> dependencies;  ///< Names of prerequisite stages
+        StartupThread thread;                   ///< Where it runs
+        Task task;                              ///< Stage body
+        std::vector<size_t> dependents;         ///< Stages waiting on this one
+        size_t pending = 0;                     ///< Prerequisites not yet finished
+        bool blocked = false;                   ///< Whether a prerequisite failed
+    };
+
+    /**
+     * @brief Runs a stage body, catching anything it throws.
+     * @return The stage's timing and result.
+     */
+    StageTiming Execute(size_t index);
+
+    /**
+     * @brief Records a finished stage and releases its dependents; m_mutex must be held.
+     * @param index The finished stage.
+     * @param timing Its timing and result.
+     * @param toPost Receives Worker stages that became ready.
+     */
+    void Complete(size_t index, StageTiming timing, std::vector<size_t>& toPost);
+
+    /**
+     * @brief Queues a stage that became ready; m_mutex must be held.
+     */
+    void Schedule(size_t index, std::vector<size_t>& toPost);
+
+    /**
+     * @brief Posts ready Worker stages; m_mutex must not be held.
+     */
+    void Post(const std::vector<size_t>& toPost);
+
+    Application& m_app;                                 ///< Reference to the main application
+    std::vector<Stage> m_stages;                        ///< Registered stages
+    std::vector<size_t> m_mainReady;                    ///< Main stages ready to run
+    std::vector<StageTiming> m_timings;                 ///< Recorded timings
+    std::mutex m_mutex;                                 ///< Guards the run state
+    std::condition_variable m_condition;                ///< Signalled when a Worker stage finishes
+    size_t m_finished;                                  ///< Stages finished or skipped
+    size_t m_inFlight;                                  ///< Worker stages posted but not finished
+    bool m_failed;                                      ///< Whether any stage failed
+    std::chrono::steady_clock::time_point m_startTime;  ///< When Run() started
+    double m_totalMs;                                   ///< Wall time of Run()
+};
+
+} // namespace poe
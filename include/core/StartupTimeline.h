@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace poe {
+
+/**
+ * @enum StartupMilestone
+ * @brief Points on the way from launch to the first composed browser frame.
+ */
+enum class StartupMilestone : size_t {
+    InitializeBegin,    ///< Application::Initialize entered
+    InitializeEnd,      ///< Application::Initialize finished
+    CefInitialized,     ///< CefInitialize returned
+    FirstPaint,         ///< First CEF paint from any browser
+    FirstCommit,        ///< First composition commit carrying browser content
+    Count
+};
+
+/**
+ * @class StartupTimeline
+ * @brief Process-wide record of when each startup milestone was first reached.
+ *
+ * Times are measured from process creation, so they include loader and
+ * static initialization time. Only the first Mark() of each milestone
+ * counts; later ones are a single relaxed load, cheap enough for per-frame
+ * paths. Safe to use from any thread and before Application exists.
+ */
+class StartupTimeline {
+public:
+    /**
+     * @brief Records a milestone if it has not been reached yet.
+     * @param milestone The milestone.
+     */
+    static void Mark(StartupMilestone milestone) noexcept;
+
+    /**
+     * @brief Checks whether a milestone has been reached.
+     * @param milestone The milestone.
+     * @return True if Mark() was called for it.
+     */
+    static bool HasReached(StartupMilestone milestone) noexcept;
+
+    /**
+     * @brief Gets when a milestone was reached.
+     * @param milestone The milestone.
+     * @return Milliseconds since process creation, or -1.0 if not reached.
+     */
+    static double GetMilliseconds(StartupMilestone milestone) noexcept;
+
+    /**
+     * @brief Gets the time since process creation.
+     * @return Milliseconds since process creation.
+     */
+    static double GetProcessAgeMilliseconds() noexcept;
+
+    /**
+     * @brief Gets the name of a milestone, as used in reports.
+     * @param milestone The milestone.
+     * @return Static milestone name.
+     */
+    static const char* GetName(StartupMilestone milestone) noexcept;
+
+    StartupTimeline() = delete;
+};
+
+} // namespace poe
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/MemoryTracker.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @enum TraceEvent
+ * @brief Events recorded in the trace ring.
+ */
+enum class TraceEvent : uint16_t {
+    EventPublished,       ///< EventSystem queued an event; args: type ID
+    EventDispatched,      ///< EventSystem ran an event's handlers; args: type ID, handler count, duration us
+    FocusChanged,         ///< FocusTracker saw a new foreground window; args: window, process ID, previous process ID
+    InputStateChanged,    ///< InputStateManager changed state; args: mode, keyboard state, mouse state
+    CefPaint,             ///< RenderHandler::OnPaint; args: element type, dirty rect count, duration us
+    CefAcceleratedPaint,  ///< RenderHandler::OnAcceleratedPaint; args: element type, dirty rect count, duration us
+    ErrorReported,        ///< ErrorHandler received a report; args: severity
+    HotkeyPressed,        ///< InputHandler input thread matched a hotkey; args: hotkey ID, virtual key, modifiers
+    BrowserInputSent,     ///< BrowserView forwarded input to CEF; args: BrowserInputKind, x or key code, y
+    ContentCommitted,     ///< OverlayRenderer committed browser content; args: shared texture (0/1), dirty rect count
+    Count
+};
+
+/**
+ * @enum BrowserInputKind
+ * @brief First argument of TraceEvent::BrowserInputSent.
+ */
+enum class BrowserInputKind : int64_t {
+    MouseMove,
+    MouseButton,
+    MouseWheel,
+    Key,
+    Char
+};
+
+/**
+ * @struct TraceRecord
+ * @brief One fixed-size entry of the trace ring.
+ */
+struct TraceRecord {
+    uint64_t timestampUs = 0;                 ///< Microseconds since the ring was initialized
+    uint32_t threadId = 0;                    ///< OS thread that recorded the event
+    TraceEvent event = TraceEvent::Count;     ///< Event ID
+    int64_t args[3] = {};                     ///< Event-specific integer arguments
+};
+
+/**
+ * @class TraceRing
+ * @brief Fixed-size, in-memory binary trace of recent events.
+ *
+ * Recording claims a slot with one atomic increment and writes a 40-byte
+ * record; nothing is formatted, allocated or locked, so it is cheap enough
+ * to leave on in the render and input paths. The newest records overwrite
+ * the oldest. Each slot carries a sequence number so a reader never returns
+ * a record that was being overwritten while it was copied.
+ *
+ * The ring is exported as Chrome trace-event JSON, which chrome://tracing
+ * and Perfetto open directly.
+ */
+class TraceRing {
+public:
+    /**
+     * @brief Constructor for the TraceRing class.
+     * @param app Reference to the main application instance.
+     */
+    explicit TraceRing(Application& app);
+
+    /**
+     * @brief Destructor for the TraceRing class.
+     */
+    ~TraceRing();
+
+    /**
+     * @brief Allocates the ring; recording starts once this returns.
+     *
+     * Reads "trace.enabled" and "trace.capacity" (rounded up to a power of two).
+     * @return True if initialization was successful, false otherwise.
+     */
+    bool Initialize();
+
+    /**
+     * @brief Stops recording. The records stay readable until destruction.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Records one event. Safe to call from any thread.
+     * @param event The event ID.
+     * @param arg0 First argument.
+     * @param arg1 Second argument.
+     * @param arg2 Third argument.
+     */
+    void Emit(TraceEvent event, int64_t arg0 = 0, int64_t arg1 = 0, int64_t arg2 = 0);
+
+    /**
+     * @brief Checks whether events are being recorded.
+     * @return True if Emit() records, false otherwise.
+     */
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Converts a time to the ring's timestamp scale.
+     * @param time The time.
+     * @return Microseconds since the ring was initialized, 0 for earlier times.
+     */
+    uint64_t ToTimestampUs(std::chrono::steady_clock::time_point time) const;
+
+    /**
+     * @brief Copies the records currently in the ring.
+     * @return Records from oldest to newest.
+     */
+    std::vector<TraceRecord> Snapshot() const;
+
+    /**
+     * @brief Formats the ring as Chrome trace-event JSON.
+     * @return The JSON document.
+     */
+    std::string ExportChromeTrace() const;
+
+    /**
+     * @brief Writes the Chrome trace export to a file.
+     * @param path The file to write.
+     * @return True if the file was written, false otherwise.
+     */
+    bool DumpToFile(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Gets the display name of an event.
+     * @param event The event ID.
+     * @return The event name.
+     */
+    static const char* GetEventName(TraceEvent event);
+
+private:
+    /**
+     * @brief A record and the sequence number guarding it.
+     */
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};    ///< Index + 1 of the record held, 0 while being written
+        TraceRecord record;                   ///< The record
+    };
+
+    Application& m_app;                                ///< Reference to the main application
+    std::unique_ptr<Slot[]> m_slots;                   ///< Ring storage
+    MemoryCharge m_slotCharge;                         ///< Size of m_slots
+    uint64_t m_mask;                                   ///< Capacity - 1
+    std::atomic<uint64_t> m_head;                      ///< Index of the next record to write
+    std::atomic<bool> m_enabled;                       ///< Whether Emit() records
+    std::chrono::steady_clock::time_point m_startTime; ///< Time zero of the timestamps
+};
+
+/**
+ * @class ScopedTraceEvent
+ * @brief Records an event when a scope ends, with the scope's duration as its third argument.
+ */
+class ScopedTraceEvent {
+public:
+    /**
+     * @brief Starts timing an event.
+     * @param ring The ring to record into.
+     * @param event The event ID.
+     * @param arg0 First argument.
+     * @param arg1 Second argument.
+     */
+    ScopedTraceEvent(TraceRing& ring, TraceEvent event, int64_t arg0 = 0, int64_t arg1 = 0)
+        : m_ring(ring), m_event(event), m_arg0(arg0), m_arg1(arg1), m_start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Records the event with its duration.
+     */
+    ~ScopedTraceEvent() {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_ring.Emit(m_event, m_arg0, m_arg1,
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+    // Non-copyable
+    ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+    ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+private:
+    TraceRing& m_ring;                               ///< Ring receiving the record
+    TraceEvent m_event;                              ///< Event ID
+    int64_t m_arg0;                                  ///< First argument
+    int64_t m_arg1;                                  ///< Second argument
+    std::chrono::steady_clock::time_point m_start;   ///< Start of the scope
+};
+
+} // namespace poe
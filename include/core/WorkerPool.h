@@ -0,0 +1,102 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @class WorkerPool
+ * @brief Small fixed-size thread pool for blocking background work.
+ *
+ * Intended for file I/O and other slow producers that must stay off the
+ * CEF and window threads. Tasks run in submission order across the
+ * workers; once the pool is shut down, new tasks run inline on the
+ * caller so no work is ever dropped.
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief Type of a queued task.
+     */
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Constructor for the WorkerPool class.
+     * @param app Reference to the main application instance.
+     */
+    explicit WorkerPool(Application& app);
+
+    /**
+     * @brief Destructor for the WorkerPool class.
+     */
+    ~WorkerPool();
+
+    // Non-copyable
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount Number of workers; 0 picks one per spare core, up to 4.
+     * @return True if initialization was successful, false otherwise.
+     */
+    bool Initialize(size_t threadCount = 0);
+
+    /**
+     * @brief Runs the queued tasks to completion and joins the workers.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Queues a task without a result.
+     * @param task The task to run.
+     */
+    void Post(Task task);
+
+    /**
+     * @brief Queues a task and returns a future for its result.
+     * @tparam Func Callable type.
+     * @param func The callable to run.
+     * @return Future that becomes ready when the task has run.
+     */
+    template<typename Func>
+    std::future<std::invoke_result_t<Func>> Submit(Func&& func) {
+        using Result = std::invoke_result_t<Func>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        std::future<Result> result = task->get_future();
+        Post([task]() { (*task)(); });
+        return result;
+    }
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The worker count, or 0 if the pool is not running.
+     */
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+private:
+    /**
+     * @brief Worker thread body.
+     */
+    void WorkerThread();
+
+    Application& m_app;                    ///< Reference to the main application
+    std::vector<std::thread> m_workers;    ///< Worker threads
+    std::deque<Task> m_tasks;              ///< Pending tasks
+    std::mutex m_mutex;                    ///< Guards m_tasks and m_running
+    std::condition_variable m_condition;   ///< Signalled when tasks arrive or the pool stops
+    bool m_running;                        ///< Whether workers accept tasks
+};
+
+} // namespace poe
@@ -7,6 +7,8 @@
 #include <mutex>
 #include <memory>
 #include "core/Application.h"
+#include "core/Logger.h"
+#include "process/win_event_hook_service.h"
 
 namespace poe {
 
@@ -33,6 +35,8 @@ struct FocusChangeInfo {
  * 
  * This class is responsible for monitoring focus changes between
  * windows and notifying registered callbacks when focus changes.
+ * Foreground changes are pushed by the WinEventHookService; Update()
+ * only polls when the hooks are unavailable.
  */
 class FocusTracker {
 public:
@@ -44,8 +48,9 @@ public:
     /**
      * @brief Constructor for the FocusTracker class.
      * @param app Reference to the main application instance.
+     * @param hookService Reference to the shared window event hook service.
      */
-    explicit FocusTracker(Application& app);
+    FocusTracker(Application& app, WinEventHookService& hookService);
 
     /**
      * @brief Destructor for the FocusTracker class.
@@ -105,7 +110,8 @@ public:
 
     /**
      * @brief Update the focus state.
-     * This should be called periodically to check for focus changes.
+     * This should be called periodically; it is a no-op while the
+     * hook service is delivering foreground events.
      */
     void Update();
 
@@ -139,6 +145,11 @@ private:
      */
     bool UpdateFocusInfo(HWND currentWindow);
 
+    /**
+     * @brief Subscribes this instance to foreground events from the hook service.
+     */
+    void SubscribeToHookService();
+
     /**
      * @brief Gets information about a window.
      * @param windowHandle The window handle to get info for.
@@ -162,10 +173,14 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                            ///< Reference to the main application
+    WinEventHookService& m_hookService;            ///< Shared window event hook service
     bool m_initialized;                            ///< Whether the tracker is initialized
+    size_t m_hookSubscriptionId;                   ///< Foreground event subscription, or 0
     
     FocusChangeInfo m_lastFocusInfo;               ///< Information about the last focus change
     mutable std::mutex m_focusInfoMutex;           ///< Mutex for thread-safe access to focus info
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <Windows.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "core/Application.h"
+#include "core/EventSystem.h"
+#include "core/Logger.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @enum ChatChannel
+ * @brief Chat channel a logged message was sent on.
+ */
+enum class ChatChannel {
+    WhisperFrom,    ///< Whisper received ("@From")
+    WhisperTo,      ///< Whisper sent ("@To")
+    Global,         ///< Global chat ('#')
+    Trade,          ///< Trade chat ('$')
+    Party,          ///< Party chat ('%')
+    Guild           ///< Guild chat ('&')
+};
+
+/**
+ * @class ZoneChangedEvent
+ * @brief Published when the log reports that the player entered an area.
+ */
+class ZoneChangedEvent : public Event {
+public:
+    /**
+     * @brief Constructor for the ZoneChangedEvent class.
+     * @param zone Name of the area entered.
+     * @param logTime Timestamp of the log line, as printed.
+     */
+    ZoneChangedEvent(std::string zone, std::string logTime)
+        : zone(std::move(zone)), logTime(std::move(logTime)) {}
+
+    std::string GetTypeName() const override { return "ZoneChangedEvent"; }
+    std::string ToString() const override;
+
+    std::string zone;       ///< Name of the area entered
+    std::string logTime;    ///< "YYYY/MM/DD HH:MM:SS" of the log line
+};
+
+/**
+ * @class ChatMessageEvent
+ * @brief Published for every whisper and channel message in the log.
+ */
+class ChatMessageEvent : public Event {
+public:
+    /**
+     * @brief Constructor for the ChatMessageEvent class.
+     * @param channel Channel of the message.
+     * @param sender Character name of the sender (the recipient for WhisperTo).
+     * @param message Message text.
+     * @param logTime Timestamp of the log line, as printed.
+     */
+    ChatMessageEvent(ChatChannel channel, std::string sender, std::string message, std::string logTime)
+        : channel(channel), sender(std::move(sender)), message(std::move(message)), logTime(std::move(logTime)) {}
+
+    std::string GetTypeName() const override { return "ChatMessageEvent"; }
+    std::string ToString() const override;
+
+    ChatChannel channel;    ///< Channel of the message
+    std::string sender;     ///< Other party of the message, without guild tag
+    std::string message;    ///< Message text
+    std::string logTime;    ///< "YYYY/MM/DD HH:MM:SS" of the log line
+};
+
+/**
+ * @class TradeRequestEvent
+ * @brief Published for whispers in the trade site's "I would like to buy" format.
+ *
+ * The whisper itself is published as a ChatMessageEvent as well.
+ */
+class TradeRequestEvent : public Event {
+public:
+    std::string GetTypeName() const override { return "TradeRequestEvent"; }
+    std::string ToString() const override;
+
+    bool incoming = true;   ///< True if someone wants to buy from us, false if we sent the request
+    std::string player;     ///< The other party
+    std::string item;       ///< Item as named in the whisper
+    std::string price;      ///< Price as written, e.g. "5 divine", or empty if none was listed
+    std::string league;     ///< League of the listing
+    std::string stashTab;   ///< Stash tab of the item, or empty
+    int left = 0;           ///< Stash column of the item (1-based), or 0
+    int top = 0;            ///< Stash row of the item (1-based), or 0
+    std::string logTime;    ///< "YYYY/MM/DD HH:MM:SS" of the log line
+};
+
+/**
+ * @struct GameLogConfig
+ * @brief Configuration for the GameLogReader.
+ */
+struct GameLogConfig {
+    std::filesystem::path logPath;                ///< Path of Client.txt
+    std::filesystem::path offsetPath;             ///< Where the read position is kept between sessions
+    std::chrono::milliseconds pollInterval{1000}; ///< Fallback check while no change notification arrives
+    std::chrono::seconds saveInterval{5};         ///< How often a moved read position is saved
+    size_t readChunkSize = 64 * 1024;             ///< Bytes read per ReadFile call
+};
+
+/**
+ * @class GameLogReader
+ * @brief Tails the game's Client.txt and publishes what it reads as events.
+ *
+ * A reader thread watches the log directory with ReadDirectoryChangesW and
+ * reads only the bytes appended since the last read. Complete lines are
+ * scanned in place in the read buffer; only matched lines allocate, and
+ * only for the event published through EventSystem (ZoneChangedEvent,
+ * ChatMessageEvent, TradeRequestEvent). An unfinished last line is kept
+ * for the next read.
+ *
+ * The read position is saved to GameLogConfig::offsetPath together with
+ * the file's identity, so a restart resumes where the last session
+ * stopped instead of re-reading a log that grows to gigabytes. Without a
+ * saved position (or if it belongs to another file) reading starts at the
+ * current end; a log that shrank below the position is read from the
+ * start.
+ *
+ * NTFS updates a file's directory entry lazily while the game holds it
+ * open, so notifications can lag behind writes; the thread also checks
+ * the file every GameLogConfig::pollInterval.
+ */
+class GameLogReader {
+public:
+    /**
+     * @brief Constructor for the GameLogReader class.
+     * @param app Reference to the main application instance.
+     * @param config Configuration for the reader.
+     */
+    GameLogReader(Application& app, const GameLogConfig& config = GameLogConfig());
+
+    /**
+     * @brief Destructor for the GameLogReader class.
+     */
+    ~GameLogReader();
+
+    // Non-copyable, non-movable: the reader thread refers to this instance
+    GameLogReader(const GameLogReader&) = delete;
+    GameLogReader& operator=(const GameLogReader&) = delete;
+
+    /**
+     * @brief Starts the reader thread.
+     * @return True if initialization succeeded, false otherwise.
+     */
+    bool Initialize();
+
+    /**
+     * @brief Stops the reader thread and saves the read position.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Gets the offset of the first byte not yet parsed.
+     * @return The offset into Client.txt.
+     */
+    uint64_t GetOffset() const { return m_offset.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Parses one log line and publishes its event, if any.
+     * @param line The line, without line break.
+     * @return True if the line produced an event.
+     */
+    bool ParseLine(std::string_view line);
+
+private:
+    /**
+     * @brief Identity of a log file, to tell a saved position applies to it.
+     */
+    struct FileIdentity {
+        uint32_t volumeSerial = 0;  ///< Serial number of the volume
+        uint64_t fileIndex = 0;     ///< NTFS file index within the volume
+    };
+
+    /**
+     * @brief Main loop of the reader thread.
+     */
+    void ReaderThread();
+
+    /**
+     * @brief Opens the log and picks the offset to read from.
+     * @return True if the log is open.
+     */
+    bool OpenLog();
+
+    /**
+     * @brief Closes the log, keeping the offset for a reopen.
+     */
+    void CloseLog();
+
+    /**
+     * @brief Reads and parses everything appended since the last call.
+     */
+    void ReadAppended();
+
+    /**
+     * @brief Starts the next overlapped directory change notification.
+     * @return True if a notification is pending.
+     */
+    bool WatchDirectory();
+
+    /**
+     * @brief Checks the notifications for changes to the log itself.
+     * @return True if the log was removed or renamed and must be reopened.
+     */
+    bool LogReplaced() const;
+
+    /**
+     * @brief Loads the saved position.
+     * @param identity Receives the identity of the file it belongs to.
+     * @param offset Receives the position.
+     * @return True if a position was saved.
+     */
+    bool LoadOffset(FileIdentity& identity, uint64_t& offset) const;
+
+    /**
+     * @brief Saves the read position if it moved since the last save.
+     */
+    void SaveOffset();
+
+    /**
+     * @brief Log a message using the application logger.
+     * @tparam Args Variadic template for format arguments.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string.
+     * @param args Format arguments.
+     */
+    template<typename... Args>
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) const {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    Application& m_app;                            ///< Reference to the main application
+    GameLogConfig m_config;                        ///< Reader configuration
+    bool m_initialized;                            ///< Whether the reader is initialized
+
+    std::unique_ptr<std::thread> m_readerThread;   ///< Thread tailing the log
+    HANDLE m_stopEvent;                            ///< Signalled to stop the reader thread
+
+    // Reader thread state
+    HANDLE m_file;                                 ///< Open log, or INVALID_HANDLE_VALUE
+    FileIdentity m_identity;                       ///< Identity of the open log
+    HANDLE m_directory;                            ///< Watched log directory, or INVALID_HANDLE_VALUE
+    OVERLAPPED m_directoryOverlapped;              ///< Pending directory notification
+    std::vector<uint8_t> m_notifyBuffer;           ///< FILE_NOTIFY_INFORMATION records (DWORD aligned)
+    std::vector<char> m_buffer;                    ///< Unfinished line, followed by newly read bytes
+    size_t m_pendingSize;                          ///< Bytes of the unfinished line at the start of m_buffer
+    std::atomic<uint64_t> m_offset;                ///< Offset of the first byte not parsed yet
+    uint64_t m_savedOffset;                        ///< Offset last written to the offset file
+    bool m_hasIdentity;                            ///< Whether m_identity names a log opened this session
+    std::chrono::steady_clock::time_point m_nextSave; ///< When a moved offset is saved next
+};
+
+} // namespace poe
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Windows.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <functional>
@@ -9,6 +11,7 @@
 #include <chrono>
 #include <unordered_map>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
@@ -60,6 +63,11 @@ struct InputStateInfo {
  * This class is responsible for tracking and managing input states,
  * determining how input should be handled based on which window
  * has focus and the configured input mode.
+ *
+ * Writers serialize on m_stateMutex and publish the fields the
+ * per-message queries need as one packed atomic word, so ShouldBlockInput,
+ * ShouldPassthroughMouse, ShouldPassthroughKeyboard and GetInputMode are
+ * single lock-free loads.
  */
 class InputStateManager {
 public:
@@ -181,6 +189,33 @@ private:
         InputStateCallback callback;
     };
 
+    /**
+     * @brief The part of InputStateInfo the per-message queries read, small enough for one atomic word.
+     */
+    struct PackedState {
+        uint8_t mode;           ///< InputMode
+        uint8_t keyboardState;  ///< InputState of the keyboard
+        uint8_t mouseState;     ///< InputState of the mouse
+        uint8_t flags;          ///< kGameHasFocus | kOverlayHasFocus
+    };
+
+    static constexpr uint8_t kGameHasFocus = 1 << 0;      ///< PackedState::flags bit
+    static constexpr uint8_t kOverlayHasFocus = 1 << 1;   ///< PackedState::flags bit
+
+    static_assert(std::atomic<PackedState>::is_always_lock_free, "PackedState must fit one lock-free atomic");
+
+    /**
+     * @brief Packs the query fields of a state.
+     * @param state The full state.
+     * @return The packed representation.
+     */
+    static PackedState Pack(const InputStateInfo& state);
+
+    /**
+     * @brief Publishes m_currentState to the lock-free readers. Call with m_stateMutex held.
+     */
+    void PublishState();
+
     /**
      * @brief Updates input state based on focus and window state.
      */
@@ -206,7 +241,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                            ///< Reference to the main application
     ProcessDetector& m_processDetector;            ///< Reference to the process detector
@@ -217,7 +254,8 @@ private:
     HWND m_overlayWindowHandle;                    ///< Overlay window handle
     
     InputStateInfo m_currentState;                 ///< Current input state
-    mutable std::mutex m_stateMutex;               ///< Mutex for thread-safe access to state
+    mutable std::mutex m_stateMutex;               ///< Serializes writers and GetInputState()
+    std::atomic<PackedState> m_packedState;        ///< Published copy of m_currentState for the per-message queries
     
     std::vector<CallbackEntry> m_callbacks;        ///< Registered state callbacks
     std::mutex m_callbacksMutex;                   ///< Mutex for thread-safe access to callbacks
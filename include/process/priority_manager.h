@@ -0,0 +1,194 @@
+#pragma once
+
+#include <Windows.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include "core/Application.h"
+#include "core/Logger.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+class FocusTracker;
+struct FocusChangeInfo;
+
+/**
+ * @enum PriorityProfile
+ * @brief Scheduling profile applied to the overlay and its CEF children.
+ */
+enum class PriorityProfile {
+    Foreground,  ///< Original priority and affinity
+    Background   ///< Lowered priority, optional affinity and EcoQoS while the game has focus
+};
+
+/**
+ * @struct PriorityConfig
+ * @brief Configuration for the PriorityManager.
+ */
+struct PriorityConfig {
+    bool enabled = true;                                     ///< Whether the background profile is ever applied
+    DWORD backgroundPriorityClass = BELOW_NORMAL_PRIORITY_CLASS; ///< Priority class while the game has focus
+    bool efficiencyCoresOnly = false;                        ///< Whether to pin to the most efficient cores while the game has focus
+    DWORD_PTR backgroundAffinityMask = 0;                    ///< Explicit affinity while the game has focus, 0 for none; wins over efficiencyCoresOnly
+    bool powerThrottling = true;                             ///< Whether to opt into EcoQoS while the game has focus
+};
+
+/**
+ * @class PriorityManager
+ * @brief Lowers the scheduling class of the overlay and its CEF children while the game has focus.
+ *
+ * Switches to PriorityProfile::Background when the game process gains
+ * focus and back to Foreground when focus leaves it or the overlay turns
+ * interactive. Managed processes are this process and its direct children,
+ * which are the CEF subprocesses; each one's original priority class and
+ * affinity are recorded the first time it is seen and restored on
+ * Foreground and on shutdown.
+ */
+class PriorityManager {
+public:
+    /**
+     * @brief Constructor for the PriorityManager class.
+     * @param app Reference to the main application instance.
+     * @param focusTracker Reference to the focus tracker.
+     * @param config Configuration for the manager.
+     */
+    PriorityManager(Application& app, FocusTracker& focusTracker, const PriorityConfig& config = PriorityConfig());
+
+    /**
+     * @brief Destructor for the PriorityManager class.
+     */
+    ~PriorityManager();
+
+    // Non-copyable, non-movable: registered with the focus tracker by address
+    PriorityManager(const PriorityManager&) = delete;
+    PriorityManager& operator=(const PriorityManager&) = delete;
+
+    /**
+     * @brief Initializes the manager and starts following focus changes.
+     * @return True if initialization succeeded, false otherwise.
+     */
+    bool Initialize();
+
+    /**
+     * @brief Restores every managed process and stops following focus changes.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Sets the game process whose focus selects the background profile.
+     * @param processId Process ID of the game, or 0 if it is not running.
+     */
+    void SetGameProcess(DWORD processId);
+
+    /**
+     * @brief Sets whether the overlay is interactive; interactive always means Foreground.
+     * @param interactive Whether the overlay takes input.
+     */
+    void SetOverlayInteractive(bool interactive);
+
+    /**
+     * @brief Notes that CEF is about to launch a child process. Thread-safe.
+     *
+     * The child does not exist yet, so the next Update() calls pick it up.
+     */
+    void NotifyChildProcessLaunch();
+
+    /**
+     * @brief Picks up newly launched CEF children.
+     * This should be called periodically; it does nothing unless a launch was notified.
+     */
+    void Update();
+
+    /**
+     * @brief Gets the profile currently applied.
+     * @return The current profile.
+     */
+    PriorityProfile GetProfile() const;
+
+private:
+    /**
+     * @brief A process whose scheduling is managed.
+     */
+    struct ManagedProcess {
+        DWORD processId = 0;              ///< Process ID
+        HANDLE handle = nullptr;          ///< Handle with set, query and synchronize access
+        DWORD originalPriorityClass = 0;  ///< Priority class restored by the Foreground profile
+        DWORD_PTR originalAffinity = 0;   ///< Affinity mask when first seen
+    };
+
+    /**
+     * @brief Reacts to a focus change from the focus tracker.
+     * @param info The focus change information.
+     */
+    void OnFocusChanged(const FocusChangeInfo& info);
+
+    /**
+     * @brief Recomputes the wanted profile and applies it if it changed.
+     * Must be called with m_mutex held.
+     */
+    void UpdateProfile();
+
+    /**
+     * @brief Starts managing a process unless it is already managed.
+     * Must be called with m_mutex held.
+     * @param processId The process to manage.
+     * @return True if the process was added.
+     */
+    bool AddProcess(DWORD processId);
+
+    /**
+     * @brief Adds direct children of this process that are not managed yet.
+     * Must be called with m_mutex held.
+     * @return Number of processes added.
+     */
+    size_t ScanChildProcesses();
+
+    /**
+     * @brief Applies a profile to one process.
+     * @param process The process.
+     * @param profile The profile to apply.
+     * @return False if the process has exited.
+     */
+    bool ApplyProfile(const ManagedProcess& process, PriorityProfile profile) const;
+
+    /**
+     * @brief Works out the affinity mask of the background profile.
+     * @return The mask, or 0 to leave affinity untouched.
+     */
+    DWORD_PTR ComputeBackgroundAffinity() const;
+
+    /**
+     * @brief Log a message using the application logger.
+     * @tparam Args Variadic template for format arguments.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string.
+     * @param args Format arguments.
+     */
+    template<typename... Args>
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) const {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    Application& m_app;                            ///< Reference to the main application
+    FocusTracker& m_focusTracker;                  ///< Reference to the focus tracker
+    PriorityConfig m_config;                       ///< Manager configuration
+    bool m_initialized;                            ///< Whether the manager is initialized
+    size_t m_focusCallbackId;                      ///< Focus change subscription, or 0
+    DWORD_PTR m_backgroundAffinity;                ///< Affinity of the background profile, 0 for none
+
+    mutable std::mutex m_mutex;                    ///< Guards the state below; focus callbacks arrive on other threads
+    std::vector<ManagedProcess> m_processes;       ///< This process first, then CEF children
+    PriorityProfile m_profile;                     ///< Profile currently applied
+    DWORD m_gameProcessId;                         ///< Process ID of the game, or 0
+    DWORD m_focusedProcessId;                      ///< Process ID owning the foreground window
+    bool m_overlayInteractive;                     ///< Whether the overlay takes input
+
+    std::atomic<bool> m_launchPending;             ///< Whether a child launch was notified
+    std::chrono::steady_clock::time_point m_scanUntil; ///< Keep scanning for the launched child until then
+    std::chrono::steady_clock::time_point m_nextScan;  ///< Earliest time of the next child scan
+};
+
+} // namespace poe
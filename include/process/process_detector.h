@@ -8,8 +8,10 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <future>
 #include <mutex>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
@@ -42,12 +44,37 @@ struct ProcessInfo {
     RECT windowRect = {0};        ///< Window rectangle
 };
 
+/**
+ * @struct ProcessSnapshot
+ * @brief Immutable copy of the target process state, as last seen by the monitor.
+ *
+ * Published as a whole after every change, so queries get a consistent
+ * state with one atomic load instead of a lock or a window scan.
+ */
+struct ProcessSnapshot {
+    uint64_t revision = 0;              ///< Increases with every published change
+    std::wstring targetProcessName;     ///< Process name the target was set with
+    std::wstring targetWindowTitle;     ///< Window title the target was set with
+    ProcessInfo info;                   ///< State of the target process
+};
+
 /**
  * @class ProcessDetector
  * @brief Detects and monitors game processes.
  * 
  * This class is responsible for detecting the game process,
  * monitoring its state, and tracking window focus changes.
+ *
+ * Detection is push-based: the monitor thread installs WinEvent hooks for
+ * window creation, destruction, renaming, focus and minimize changes, and
+ * waits on the game's process handle for exit. The game's HWND and PID are
+ * cached, so a full window/process scan only runs when that cache is empty
+ * or invalidated. If the hooks cannot be installed, the thread falls back
+ * to polling at the monitor interval.
+ *
+ * Every change is published as a ProcessSnapshot. Queries about the
+ * target are answered from it without scanning; only queries for some
+ * other process, or an explicit Refresh(), scan on the calling thread.
  */
 class ProcessDetector {
 public:
@@ -88,6 +115,7 @@ public:
 
     /**
      * @brief Finds a process by name or window title.
+     * The target process is answered from the current snapshot; anything else is scanned for.
      * @param processName Name of the process to find (can be empty).
      * @param windowTitle Title or partial title of the window to find (can be empty).
      * @return Process information, with state NotFound if not found.
@@ -146,9 +174,25 @@ public:
 
     /**
      * @brief Gets information about the current target process.
-     * @return Process information for the target process.
+     * @return Copy of the target's state from the current snapshot.
      */
-    const ProcessInfo& GetTargetProcessInfo() const;
+    ProcessInfo GetTargetProcessInfo() const;
+
+    /**
+     * @brief Gets the current snapshot of the target process. Lock-free.
+     * @return The snapshot; stays valid for as long as the caller holds it.
+     */
+    std::shared_ptr<const ProcessSnapshot> GetSnapshot() const {
+        return m_snapshot.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Scans for the target right away and publishes the result.
+     * For the rare caller that cannot wait for the monitor thread, e.g. right
+     * after the game was launched. Does nothing before Initialize().
+     * @return The new snapshot.
+     */
+    std::shared_ptr<const ProcessSnapshot> Refresh();
 
 private:
     /**
@@ -161,8 +205,44 @@ private:
 
     /**
      * @brief Background thread function for monitoring processes.
+     * @param started Fulfilled with the thread ID once the thread has a message queue.
      */
-    void MonitorThread();
+    void MonitorThread(std::promise<DWORD>& started);
+
+    /**
+     * @brief WinEvent hook callback, delivered on the monitor thread.
+     */
+    static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd,
+        LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime);
+
+    /**
+     * @brief Reacts to a window event for a top-level window.
+     * @param event The WinEvent constant.
+     * @param hwnd The window the event refers to.
+     */
+    void HandleWinEvent(DWORD event, HWND hwnd);
+
+    /**
+     * @brief Checks whether a single window belongs to the target process.
+     * Must be called with m_processMutex held.
+     * @param hwnd The window to check.
+     * @return True if the window matches the target title or process name.
+     */
+    bool WindowMatchesTarget(HWND hwnd) const;
+
+    /**
+     * @brief Refreshes focus, minimize and bounds from the cached window only.
+     * @param info The process information to refresh in place.
+     * @return False if the cached window is gone and a full scan is needed.
+     */
+    bool RefreshCachedState(ProcessInfo& info) const;
+
+    /**
+     * @brief Opens a waitable handle for the target process so its exit wakes the monitor thread.
+     * Only called from the monitor thread (and from Shutdown after it has joined).
+     * @param processId The process to watch, or 0 to stop watching.
+     */
+    void WatchProcess(DWORD processId);
 
     /**
      * @brief Updates the internal process info.
@@ -172,6 +252,12 @@ private:
      */
     ProcessInfo UpdateProcessInfo(const std::wstring& processName, const std::wstring& windowTitle);
 
+    /**
+     * @brief Publishes m_targetProcessInfo as a new snapshot.
+     * Must be called with m_processMutex held.
+     */
+    void PublishSnapshot();
+
     /**
      * @brief Notifies all registered callbacks about a state change.
      * @param info The process information to notify about.
@@ -186,7 +272,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                            ///< Reference to the main application
     bool m_initialized;                            ///< Whether the detector is initialized
@@ -194,7 +282,8 @@ private:
     
     std::wstring m_targetProcessName;              ///< Name of the target process
     std::wstring m_targetWindowTitle;              ///< Title of the target window
-    ProcessInfo m_targetProcessInfo;               ///< Information about the target process
+    ProcessInfo m_targetProcessInfo;               ///< Information about the target process; monitor side
+    std::atomic<std::shared_ptr<const ProcessSnapshot>> m_snapshot; ///< Last published state, read lock-free
     
     std::vector<CallbackEntry> m_callbacks;        ///< Registered state callbacks
     std::mutex m_callbacksMutex;                   ///< Mutex for thread-safe access to callbacks
@@ -203,6 +292,12 @@ private:
     std::unique_ptr<std::thread> m_monitorThread;  ///< Background thread for monitoring
     std::chrono::milliseconds m_monitorInterval;   ///< Interval for monitoring checks
     std::mutex m_processMutex;                     ///< Mutex for thread-safe access to process info
+    
+    std::atomic<DWORD> m_monitorThreadId;          ///< Thread ID of the monitor thread (for wake-ups)
+    HANDLE m_processHandle;                        ///< Waitable handle of the target process, if found
+    DWORD m_watchedProcessId;                      ///< Process ID m_processHandle refers to
+    std::atomic<bool> m_rescanPending;             ///< Whether a full scan was requested by an event
+    bool m_hooksActive;                            ///< Whether WinEvent hooks are installed
 };
 
 } // namespace poe
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Windows.h>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "core/Application.h"
+#include "core/Logger.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @struct WinEventInfo
+ * @brief A window event delivered by the hook service.
+ */
+struct WinEventInfo {
+    DWORD event = 0;              ///< WinEvent constant (EVENT_SYSTEM_FOREGROUND, ...)
+    HWND windowHandle = nullptr;  ///< Top-level window the event refers to
+    DWORD eventTime = 0;          ///< Time the event was generated, in milliseconds
+};
+
+/**
+ * @class WinEventHookService
+ * @brief Owns a single thread that receives system window events.
+ * 
+ * The service installs out-of-context WinEvent hooks for foreground changes,
+ * minimize/restore, location changes and window destruction, and forwards
+ * window-level events to subscribers. Trackers subscribe instead of polling,
+ * so idle frames cost nothing and moves are seen as soon as they happen.
+ * Callbacks run on the hook thread and must be short.
+ */
+class WinEventHookService {
+public:
+    /**
+     * @brief Type definition for window event callbacks.
+     */
+    using WinEventCallback = std::function<void(const WinEventInfo&)>;
+
+    /**
+     * @brief Constructor for the WinEventHookService class.
+     * @param app Reference to the main application instance.
+     */
+    explicit WinEventHookService(Application& app);
+
+    /**
+     * @brief Destructor for the WinEventHookService class.
+     */
+    ~WinEventHookService();
+
+    // Non-copyable, non-movable (the hook thread refers to this instance)
+    WinEventHookService(const WinEventHookService&) = delete;
+    WinEventHookService& operator=(const WinEventHookService&) = delete;
+
+    /**
+     * @brief Starts the hook thread and installs the hooks.
+     * @return True if the service is running, false otherwise.
+     */
+    bool Initialize();
+
+    /**
+     * @brief Removes the hooks and stops the hook thread.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Checks whether the hooks are installed and delivering events.
+     * @return True if subscribers will receive events, false if they should poll.
+     */
+    bool IsActive() const;
+
+    /**
+     * @brief Subscribes to a range of window events.
+     * @param eventMin Lowest WinEvent constant of interest.
+     * @param eventMax Highest WinEvent constant of interest.
+     * @param callback The callback to invoke on the hook thread.
+     * @return ID of the subscription for later removal.
+     */
+    size_t Subscribe(DWORD eventMin, DWORD eventMax, const WinEventCallback& callback);
+
+    /**
+     * @brief Removes a subscription.
+     * @param subscriptionId ID returned by Subscribe.
+     * @return True if the subscription was found and removed, false otherwise.
+     */
+    bool Unsubscribe(size_t subscriptionId);
+
+private:
+    /**
+     * @brief Internal structure for storing subscriptions with their IDs.
+     */
+    struct Subscription {
+        size_t id;
+        DWORD eventMin;
+        DWORD eventMax;
+        WinEventCallback callback;
+    };
+
+    using SubscriptionList = std::vector<Subscription>;
+
+    /**
+     * @brief Hook thread function: installs the hooks and pumps messages.
+     * @param started Fulfilled with the thread ID once the hooks are installed (or failed).
+     */
+    void HookThread(std::promise<DWORD>& started);
+
+    /**
+     * @brief WinEvent hook callback, delivered on the hook thread.
+     */
+    static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd,
+        LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime);
+
+    /**
+     * @brief Forwards an event to every matching subscriber.
+     * @param info The event to deliver.
+     */
+    void Dispatch(const WinEventInfo& info);
+
+    /**
+     * @brief Log a message using the application logger.
+     * @tparam Args Variadic template for format arguments.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string.
+     * @param args Format arguments.
+     */
+    template<typename... Args>
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    Application& m_app;                            ///< Reference to the main application
+    bool m_initialized;                            ///< Whether the service is initialized
+    std::atomic<bool> m_active;                    ///< Whether the hooks are installed
+    
+    std::unique_ptr<std::thread> m_hookThread;     ///< Thread that owns the hooks
+    DWORD m_hookThreadId;                          ///< Thread ID of the hook thread (for WM_QUIT)
+    
+    std::atomic<std::shared_ptr<const SubscriptionList>> m_subscriptions; ///< Copy-on-write subscriber snapshot
+    std::mutex m_subscriptionsMutex;               ///< Serializes subscription changes
+    size_t m_nextSubscriptionId;                   ///< Counter for generating subscription IDs
+};
+
+} // namespace poe
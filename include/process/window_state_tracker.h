@@ -7,6 +7,8 @@
 #include <mutex>
 #include <unordered_map>
 #include "core/Application.h"
+#include "core/Logger.h"
+#include "process/win_event_hook_service.h"
 
 namespace poe {
 
@@ -45,6 +47,9 @@ struct WindowStateInfo {
  * 
  * This class is responsible for tracking window states, detecting
  * position and size changes, and monitoring window order changes.
+ * Changes are pushed by the WinEventHookService, so only the window an
+ * event refers to is re-read; Update() only polls when the hooks are
+ * unavailable.
  */
 class WindowStateTracker {
 public:
@@ -56,8 +61,9 @@ public:
     /**
      * @brief Constructor for the WindowStateTracker class.
      * @param app Reference to the main application instance.
+     * @param hookService Reference to the shared window event hook service.
      */
-    explicit WindowStateTracker(Application& app);
+    WindowStateTracker(Application& app, WinEventHookService& hookService);
 
     /**
      * @brief Destructor for the WindowStateTracker class.
@@ -113,7 +119,8 @@ public:
 
     /**
      * @brief Updates the state of all tracked windows.
-     * This should be called periodically to update window states.
+     * This should be called periodically; it is a no-op while the
+     * hook service is delivering window events.
      */
     void Update();
 
@@ -147,6 +154,17 @@ private:
      */
     bool UpdateWindowState(HWND handle);
 
+    /**
+     * @brief Applies a window event from the hook service.
+     * @param info The event; only tracked windows are re-read.
+     */
+    void OnWinEvent(const WinEventInfo& info);
+
+    /**
+     * @brief Subscribes this instance to window events from the hook service.
+     */
+    void SubscribeToHookService();
+
     /**
      * @brief Retrieves current information for a window.
      * @param handle The window handle to get info for.
@@ -169,10 +187,15 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                            ///< Reference to the main application
+    WinEventHookService& m_hookService;            ///< Shared window event hook service
     bool m_initialized;                            ///< Whether the tracker is initialized
+    size_t m_hookSubscriptionId;                   ///< Window event subscription, or 0
+    HWND m_foregroundWindow;                       ///< Last foreground window seen by OnWinEvent
     
     std::unordered_map<HWND, WindowStateInfo> m_windowStates; ///< Map of tracked window states
     mutable std::mutex m_windowStatesMutex;        ///< Mutex for thread-safe access to window states
@@ -1,201 +1,328 @@
 #pragma once
 
 #include <Windows.h>
+#include <dcomp.h>
+#include <wrl/client.h>
 #include <chrono>
+#include <cstdint>
 #include <functional>
-#include <memory>
-#include <string>
-#include <unordered_map>
 #include <vector>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
 /**
- * @class Animation
- * @brief Base class for animations.
+ * @enum Easing
+ * @brief Easing curves an animation can follow.
+ *
+ * All of them are polynomials of degree three or less, so composition
+ * animations submit them exactly as one IDCompositionAnimation cubic.
  */
-class Animation {
+enum class Easing : uint8_t {
+    Linear,     ///< Constant speed
+    EaseOut,    ///< Fast start, slow finish (quadratic)
+    EaseInOut   ///< Slow start and finish (smoothstep)
+};
+
+/**
+ * @enum CompositionProperty
+ * @brief Properties a composition animation can drive.
+ */
+enum class CompositionProperty {
+    Opacity,    ///< CompositionTarget::effect opacity
+    OffsetX,    ///< CompositionTarget::visual horizontal offset
+    OffsetY,    ///< CompositionTarget::visual vertical offset
+    Scale       ///< CompositionTarget::scale, both axes
+};
+
+/**
+ * @struct CompositionTarget
+ * @brief DirectComposition objects a composition animation is bound to.
+ *
+ * Only the member matching the animated property needs to be set.
+ */
+struct CompositionTarget {
+    Microsoft::WRL::ComPtr<IDCompositionVisual> visual;         ///< Visual for offset animations
+    Microsoft::WRL::ComPtr<IDCompositionEffectGroup> effect;    ///< Effect group for opacity animations
+    Microsoft::WRL::ComPtr<IDCompositionScaleTransform> scale;  ///< Transform for scale animations
+};
+
+/**
+ * @class AnimationManager
+ * @brief Manages animations for the application.
+ *
+ * Animations live in a pool of slots addressed by handle; a handle also
+ * carries the slot's generation, so it stops working once its animation
+ * is destroyed, even after the slot is reused. A caller creates its
+ * animations once and then starts or retargets them as often as it likes;
+ * neither allocates. Slot state is kept as parallel arrays so
+ * Update() walks only the running slots and touches only the values it
+ * needs. CPU-driven animations are stepped by Update(); composition-driven
+ * ones are compiled into a curve that DWM evaluates on its own clock, and
+ * Update() only detects their completion.
+ */
+class AnimationManager {
 public:
     /**
-     * @brief Constructor for the Animation class.
-     * @param name The name of the animation.
-     * @param durationMs The duration of the animation in milliseconds.
+     * @brief Opaque identifier of a pooled animation.
      */
-    Animation(const std::string& name, uint32_t durationMs);
-    
+    using AnimationHandle = uint32_t;
+
     /**
-     * @brief Virtual destructor for proper polymorphic destruction.
+     * @brief Handle value that never refers to an animation.
      */
-    virtual ~Animation() = default;
-    
+    static constexpr AnimationHandle kInvalidHandle = 0;
+
     /**
-     * @brief Starts the animation.
+     * @brief Constructor for the AnimationManager class.
+     * @param app Reference to the main application instance.
      */
-    void Start();
-    
+    explicit AnimationManager(Application& app);
+
     /**
-     * @brief Stops the animation.
+     * @brief Destructor for the AnimationManager class.
      */
-    void Stop();
-    
+    ~AnimationManager();
+
     /**
-     * @brief Updates the animation.
-     * @return True if the animation is still running, false if it has finished.
+     * @brief Initializes the animation manager.
+     * @param compositionDevice Device used for CreateCompositionAnimation, or
+     *        nullptr to run every animation on the CPU.
+     * @return True if initialization was successful, false otherwise.
      */
-    bool Update();
-    
+    bool Initialize(IDCompositionDevice* compositionDevice = nullptr);
+
     /**
-     * @brief Gets the name of the animation.
-     * @return The animation name.
+     * @brief Shuts down the animation manager and releases every slot.
      */
-    const std::string& GetName() const { return m_name; }
-    
+    void Shutdown();
+
     /**
-     * @brief Checks if the animation is running.
-     * @return True if the animation is running, false otherwise.
+     * @brief Steps running CPU animations and fires completion callbacks.
      */
-    bool IsRunning() const { return m_running; }
-    
+    void Update();
+
     /**
-     * @brief Gets the current progress of the animation (0.0-1.0).
-     * @return The animation progress.
+     * @brief Checks whether any CPU-driven animation is running.
+     *
+     * Composition-driven animations do not count; they need no frames.
+     * @return True if Update() has per-frame work to do, false otherwise.
      */
-    float GetProgress() const { return m_progress; }
-    
+    bool HasActiveAnimations() const;
+
     /**
-     * @brief Sets a callback function to call when the animation completes.
-     * @param callback The callback function.
+     * @brief Gets the time until the next composition-driven animation completes.
+     *
+     * Update() must run by then for its completion callback to fire.
+     * @return Milliseconds until the next completion, or INFINITE if none is running.
      */
-    void SetCompletionCallback(std::function<void()> callback) { m_completionCallback = callback; }
+    DWORD GetTimeToNextCompletion() const;
 
-protected:
     /**
-     * @brief Updates the animation value based on the current progress.
-     * Must be implemented by derived classes.
+     * @brief Checks whether animations can be compiled for the compositor.
+     * @return True if a composition device is available.
      */
-    virtual void UpdateValue() = 0;
-
-    std::string m_name;                        ///< Animation name
-    uint32_t m_durationMs;                     ///< Animation duration in milliseconds
-    bool m_running;                            ///< Whether the animation is running
-    float m_progress;                          ///< Current animation progress (0.0-1.0)
-    std::chrono::steady_clock::time_point m_startTime; ///< Animation start time
-    std::function<void()> m_completionCallback; ///< Callback for animation completion
-};
+    bool SupportsCompositionAnimations() const { return m_compositionDevice != nullptr; }
 
-/**
- * @class FloatAnimation
- * @brief Animation for float values.
- */
-class FloatAnimation : public Animation {
-public:
     /**
-     * @brief Constructor for the FloatAnimation class.
-     * @param name The name of the animation.
+     * @brief Creates a float animation stepped by Update().
      * @param durationMs The duration of the animation in milliseconds.
      * @param startValue The starting value.
      * @param endValue The ending value.
-     * @param valueCallback The callback to call with the updated value.
+     * @param valueCallback Called with the value on start and on every step.
+     * @param easing The curve to follow.
+     * @return Handle of the animation, or kInvalidHandle if the manager is not initialized.
      */
-    FloatAnimation(
-        const std::string& name,
+    AnimationHandle CreateFloatAnimation(
         uint32_t durationMs,
         float startValue,
         float endValue,
-        std::function<void(float)> valueCallback
+        std::function<void(float)> valueCallback,
+        Easing easing = Easing::Linear
     );
 
-protected:
     /**
-     * @brief Updates the animated value and calls the callback.
+     * @brief Creates an animation that DirectComposition runs on its own clock.
+     * @param durationMs The duration of the animation in milliseconds.
+     * @param startValue The starting value.
+     * @param endValue The ending value.
+     * @param property The property to animate.
+     * @param target The objects carrying the property.
+     * @param easing The curve to follow.
+     * @return Handle of the animation, or kInvalidHandle if no composition device is set.
      */
-    void UpdateValue() override;
+    AnimationHandle CreateCompositionAnimation(
+        uint32_t durationMs,
+        float startValue,
+        float endValue,
+        CompositionProperty property,
+        const CompositionTarget& target,
+        Easing easing = Easing::Linear
+    );
 
-private:
-    float m_startValue;                       ///< Starting value
-    float m_endValue;                         ///< Ending value
-    float m_currentValue;                     ///< Current value
-    std::function<void(float)> m_valueCallback; ///< Callback for value updates
-};
+    /**
+     * @brief Releases an animation's slot for reuse.
+     *
+     * Must not be called from the animation's own callbacks.
+     * @param handle The animation; kInvalidHandle is ignored.
+     */
+    void DestroyAnimation(AnimationHandle handle);
 
-/**
- * @class AnimationManager
- * @brief Manages animations for the application.
- */
-class AnimationManager {
-public:
     /**
-     * @brief Constructor for the AnimationManager class.
-     * @param app Reference to the main application instance.
+     * @brief Sets the callback to call when the animation completes.
+     *
+     * Completion callbacks run from Update() after all animations have been
+     * stepped, so they may start or retarget any animation, including their own.
+     * @param handle The animation.
+     * @param callback The callback function.
      */
-    explicit AnimationManager(Application& app);
-    
+    void SetCompletionCallback(AnimationHandle handle, std::function<void()> callback);
+
     /**
-     * @brief Destructor for the AnimationManager class.
+     * @brief Starts an animation from the beginning.
+     * @param handle The animation.
+     * @return True if the animation exists and was started, false otherwise.
      */
-    ~AnimationManager();
-    
+    bool StartAnimation(AnimationHandle handle);
+
     /**
-     * @brief Initializes the animation manager.
-     * @return True if initialization was successful, false otherwise.
+     * @brief Starts an animation between new values.
+     * @param handle The animation.
+     * @param startValue The starting value.
+     * @param endValue The ending value.
+     * @return True if the animation exists and was started, false otherwise.
      */
-    bool Initialize();
-    
+    bool StartAnimation(AnimationHandle handle, float startValue, float endValue);
+
     /**
-     * @brief Shuts down the animation manager.
+     * @brief Heads for a new end value from wherever the animation is now.
+     *
+     * Restarts the clock from the current value, so a fade that reverses
+     * halfway does not jump. A finished animation starts from its last end value.
+     * @param handle The animation.
+     * @param endValue The new ending value.
+     * @return True if the animation exists and was restarted, false otherwise.
      */
-    void Shutdown();
-    
+    bool RetargetAnimation(AnimationHandle handle, float endValue);
+
     /**
-     * @brief Updates all running animations.
+     * @brief Stops an animation where it is, without its completion callback.
+     * @param handle The animation.
+     * @return True if the animation exists and was running, false otherwise.
      */
-    void Update();
-    
+    bool StopAnimation(AnimationHandle handle);
+
     /**
-     * @brief Creates a float animation.
-     * @param name The name of the animation.
-     * @param durationMs The duration of the animation in milliseconds.
-     * @param startValue The starting value.
-     * @param endValue The ending value.
-     * @param valueCallback The callback to call with the updated value.
-     * @return Shared pointer to the created animation.
+     * @brief Stops all animations.
      */
-    std::shared_ptr<FloatAnimation> CreateFloatAnimation(
-        const std::string& name,
-        uint32_t durationMs,
-        float startValue,
-        float endValue,
-        std::function<void(float)> valueCallback
-    );
-    
+    void StopAllAnimations();
+
     /**
-     * @brief Starts an animation by name.
-     * @param name The name of the animation.
-     * @return True if the animation was found and started, false otherwise.
+     * @brief Checks if an animation is running.
+     * @param handle The animation.
+     * @return True if the animation exists and is running.
      */
-    bool StartAnimation(const std::string& name);
-    
+    bool IsRunning(AnimationHandle handle) const;
+
     /**
-     * @brief Stops an animation by name.
-     * @param name The name of the animation.
-     * @return True if the animation was found and stopped, false otherwise.
+     * @brief Gets the value the animation shows now.
+     *
+     * Composition curves are evaluated at the current time.
+     * @param handle The animation.
+     * @return The current value, or 0 if the handle is invalid.
      */
-    bool StopAnimation(const std::string& name);
-    
+    float GetCurrentValue(AnimationHandle handle) const;
+
     /**
-     * @brief Stops all animations.
+     * @brief Gets the value the animation holds once it completes.
+     * @param handle The animation.
+     * @return The ending value, or 0 if the handle is invalid.
      */
-    void StopAllAnimations();
-    
+    float GetEndValue(AnimationHandle handle) const;
+
     /**
-     * @brief Gets an animation by name.
-     * @param name The name of the animation.
-     * @return Shared pointer to the animation, or nullptr if not found.
+     * @brief Checks whether an animation runs on the compositor's clock.
+     * @param handle The animation.
+     * @return True for composition animations, false otherwise.
      */
-    std::shared_ptr<Animation> GetAnimation(const std::string& name);
+    bool IsCompositionDriven(AnimationHandle handle) const;
 
 private:
+    /**
+     * @brief Slot state bits kept in m_flags.
+     */
+    enum SlotFlags : uint8_t {
+        kSlotInUse = 1 << 0,        ///< Slot holds an animation
+        kSlotRunning = 1 << 1,      ///< Animation is in m_active
+        kSlotComposition = 1 << 2   ///< Animation is a composition curve
+    };
+
+    /**
+     * @brief Takes a slot from the free list, growing the pool if it is empty.
+     * @return Index of the slot.
+     */
+    uint32_t AllocateSlot();
+
+    /**
+     * @brief Builds the handle of a slot's current animation.
+     * @param index The slot.
+     * @return Slot index plus one in the low bits, the slot's generation above.
+     */
+    AnimationHandle MakeHandle(uint32_t index) const;
+
+    /**
+     * @brief Resolves a handle to a slot index.
+     * @param handle The handle.
+     * @param index Receives the slot index.
+     * @return True if the handle refers to a live animation; false for a
+     * destroyed one, even if its slot was reused since.
+     */
+    bool FindSlot(AnimationHandle handle, uint32_t& index) const;
+
+    /**
+     * @brief Fraction of the duration elapsed at a point in time, clamped to 0-1.
+     * @param index The slot.
+     * @param now The point in time.
+     * @return The progress.
+     */
+    float GetProgress(uint32_t index, std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Value of a slot's curve at some progress.
+     * @param index The slot.
+     * @param progress Progress (0.0-1.0).
+     * @return The eased value.
+     */
+    float Evaluate(uint32_t index, float progress) const;
+
+    /**
+     * @brief Restarts a slot's clock between its stored values and activates it.
+     * @param index The slot.
+     */
+    void Play(uint32_t index);
+
+    /**
+     * @brief Removes a slot from the running list.
+     * @param index The slot.
+     */
+    void Deactivate(uint32_t index);
+
+    /**
+     * @brief Builds a slot's curve, binds it to the target and commits once.
+     * @param index The slot.
+     */
+    void SubmitCurve(uint32_t index);
+
+    /**
+     * @brief Binds an animation or a static value to a slot's target property.
+     * @param index The slot.
+     * @param animation The curve, or nullptr to apply value.
+     * @param value Static value used when animation is null.
+     * @return Result of the DirectComposition call.
+     */
+    HRESULT ApplyComposition(uint32_t index, IDCompositionAnimation* animation, float value);
+
     /**
      * @brief Log a message using the application logger.
      * @tparam Args Variadic template for format arguments.
@@ -204,12 +331,41 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @struct CompositionBinding
+     * @brief What a composition slot drives; empty for CPU slots.
+     */
+    struct CompositionBinding {
+        CompositionProperty property = CompositionProperty::Opacity; ///< Animated property
+        CompositionTarget target;                                    ///< Objects carrying the property
+    };
 
     Application& m_app;                       ///< Reference to the main application
     bool m_initialized;                       ///< Whether the manager is initialized
-    std::unordered_map<std::string, std::shared_ptr<Animation>> m_animations; ///< Registered animations
-    std::vector<std::shared_ptr<Animation>> m_activeAnimations; ///< Currently active animations
+    Microsoft::WRL::ComPtr<IDCompositionDevice> m_compositionDevice; ///< Device for composition animations
+
+    // Per-slot state, indexed by slot; read by the Update() loop
+    std::vector<float> m_startValues;         ///< Starting values
+    std::vector<float> m_endValues;           ///< Ending values
+    std::vector<float> m_currentValues;       ///< Last stepped (or settled) values
+    std::vector<uint32_t> m_durationsMs;      ///< Durations in milliseconds
+    std::vector<Easing> m_easings;            ///< Easing curves
+    std::vector<uint8_t> m_flags;             ///< SlotFlags bits
+    std::vector<std::chrono::steady_clock::time_point> m_startTimes; ///< When each slot last started
+
+    // Per-slot state touched only on start, step callbacks and completion
+    std::vector<std::function<void(float)>> m_valueCallbacks;   ///< Step callbacks (CPU slots)
+    std::vector<std::function<void()>> m_completionCallbacks;   ///< Completion callbacks
+    std::vector<CompositionBinding> m_bindings;                 ///< Targets (composition slots)
+
+    std::vector<uint32_t> m_generations;      ///< Bumped whenever a slot is freed, so stale handles miss
+    std::vector<uint32_t> m_freeSlots;        ///< Indices of unused slots
+    std::vector<uint32_t> m_active;           ///< Indices of running slots, unordered
+    std::vector<AnimationHandle> m_completed; ///< Scratch list for Update(), kept for its capacity
 };
 
-} // namespace poe
\ No newline at end of file
+} // namespace poe
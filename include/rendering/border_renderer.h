@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 #pragma comment(lib, "d2d1.lib")
 #pragma comment(lib, "dwrite.lib")
@@ -22,7 +23,10 @@ class OverlayWindow;
  * @brief Renders customizable borders around the overlay window.
  * 
  * This class provides rendering of smart borders that highlight
- * when the cursor approaches the window edges.
+ * when the cursor approaches the window edges. The border shapes are
+ * built once per Resize/SetStyle as device-independent geometries; the
+ * compositor rasterizes them into a surface only when they change and
+ * fades the border through the visual's opacity.
  */
 class BorderRenderer {
 public:
@@ -54,9 +58,12 @@ public:
     
     /**
      * @brief Initializes the renderer.
+     * @param factory Factory of the render targets the border will be drawn
+     *        on; geometries only draw on targets from the same factory. A
+     *        private factory is created if null.
      * @return True if initialization succeeded, false otherwise.
      */
-    bool Initialize();
+    bool Initialize(ID2D1Factory* factory = nullptr);
     
     /**
      * @brief Shuts down the renderer and releases resources.
@@ -65,10 +72,26 @@ public:
     
     /**
      * @brief Renders the border.
+     *
+     * Draws into a render target the caller has already begun drawing on;
+     * no BeginDraw/EndDraw is issued here.
      * @param rt The render target to draw on.
-     * @param opacity The opacity of the border (0.0-1.0).
+     * @param deviceGeneration GraphicsDevice generation the target belongs to;
+     *        brushes from an earlier generation are recreated.
+     * @param opacity The opacity of the border (0.0-1.0), applied to the brushes.
      */
-    void Render(ID2D1RenderTarget* rt, float opacity);
+    void Render(ID2D1RenderTarget* rt, uint64_t deviceGeneration, float opacity = 1.0f);
+
+    /**
+     * @brief Checks whether the border changed since it was last rendered.
+     * @return True if the cached rasterization is out of date.
+     */
+    bool IsContentDirty() const { return m_contentDirty; }
+
+    /**
+     * @brief Releases the brushes, e.g. after their render target was lost.
+     */
+    void ReleaseDeviceResources();
     
     /**
      * @brief Resize the border for the new window dimensions.
@@ -91,15 +114,10 @@ public:
 
 private:
     /**
-     * @brief Creates Direct2D resources for rendering.
-     * @return True if creation succeeded, false otherwise.
+     * @brief Rebuilds the border and shadow geometries for the current size and style.
+     * @return True if the geometries were built, false otherwise.
      */
-    bool CreateDeviceResources();
-    
-    /**
-     * @brief Releases Direct2D resources.
-     */
-    void ReleaseDeviceResources();
+    bool BuildGeometry();
     
     /**
      * @brief Log a message using the application logger.
@@ -109,7 +127,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                           ///< Reference to the main application
     OverlayWindow& m_overlayWindow;               ///< Reference to the overlay window
@@ -121,11 +141,15 @@ private:
     Microsoft::WRL::ComPtr<ID2D1Factory> m_d2dFactory; ///< Direct2D factory
     Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> m_borderBrush; ///< Border brush
     Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> m_shadowBrush; ///< Shadow brush
+    Microsoft::WRL::ComPtr<ID2D1RoundedRectangleGeometry> m_borderGeometry; ///< Border outline
+    Microsoft::WRL::ComPtr<ID2D1RoundedRectangleGeometry> m_shadowGeometry; ///< Offset shadow outline
+    uint64_t m_brushGeneration;                   ///< Device generation the brushes were created on
     
     // State variables
     bool m_initialized;                           ///< Whether the renderer is initialized
     int m_width;                                  ///< Current width
     int m_height;                                 ///< Current height
+    bool m_contentDirty;                          ///< Whether the border changed since the last Render
 };
 
 } // namespace poe
\ No newline at end of file
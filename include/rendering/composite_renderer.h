@@ -9,9 +9,15 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <unordered_map>
 #include "core/Application.h"
+#include "core/Logger.h"
 #include "rendering/overlay_renderer.h"
 #include "rendering/border_renderer.h"
+#include "rendering/content_surface.h"
+#include "rendering/frame_mailbox.h"
+#include "rendering/graphics_device.h"
+#include "rendering/z_order_manager.h"
 
 namespace poe {
 
@@ -25,15 +31,31 @@ class AnimationManager;
  * 
  * This class coordinates the rendering pipeline, combining DirectComposition,
  * Direct2D, and CEF browser rendering into a cohesive output.
+ *
+ * Besides the main content, any number of browser panels (price check, map
+ * mods, timers) can be hosted in the same window. Each panel is its own
+ * visual with its own surface and clip, ordered through a ZOrderManager, so
+ * extra views cost no extra layered window and move without re-rendering.
  */
 class CompositeRenderer {
 public:
+    /**
+     * @brief Identifies a panel created with CreatePanel(); stays valid across device loss.
+     */
+    using PanelId = uint32_t;
+
+    /**
+     * @brief PanelId value that never refers to a panel.
+     */
+    static constexpr PanelId kInvalidPanel = 0;
+
     /**
      * @brief Constructor for the CompositeRenderer class.
      * @param app Reference to the main application instance.
      * @param overlayWindow Reference to the overlay window.
+     * @param device Devices to render with; must outlive the renderer.
      */
-    CompositeRenderer(Application& app, OverlayWindow& overlayWindow);
+    CompositeRenderer(Application& app, OverlayWindow& overlayWindow, GraphicsDevice& device);
     
     /**
      * @brief Destructor for the CompositeRenderer class.
@@ -53,9 +75,31 @@ public:
     
     /**
      * @brief Render a frame.
+     *
+     * Checks the shared devices first. When they were lost, the pipeline
+     * was released on the spot; once they are recreated it is rebuilt here
+     * in a single step, once per device generation, instead of every
+     * failing call logging and retrying on its own.
      */
     void Render();
     
+    /**
+     * @brief Upload browser content, limited to the changed regions.
+     * @param buffer BGRA pixel buffer of the full view.
+     * @param width Width of the buffer in pixels.
+     * @param height Height of the buffer in pixels.
+     * @param dirtyRects Regions of the buffer that changed since the last update.
+     * @return True if the content was uploaded and presented, false otherwise.
+     */
+    bool UpdateContent(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects);
+    
+    /**
+     * @brief Present browser content from a CEF shared texture.
+     * @param sharedHandle Shared handle of the texture produced by CEF.
+     * @return True if the frame was presented, false otherwise.
+     */
+    bool UpdateSharedContent(HANDLE sharedHandle);
+    
     /**
      * @brief Resize the rendering surface.
      * @param width The new width.
@@ -83,10 +127,36 @@ public:
     void SetPosition(int x, int y);
     
     /**
-     * @brief Get the overlay renderer.
-     * @return Reference to the overlay renderer.
+     * @brief Get the DirectComposition device, for compiling animations.
+     * @return The device, or nullptr while the pipeline is not built.
+     */
+    IDCompositionDevice* GetCompositionDevice() const {
+        return m_overlayRenderer ? m_overlayRenderer->GetCompositionDevice() : nullptr;
+    }
+    
+    /**
+     * @brief Get the device generation the pipeline was built on.
+     * @return The generation, or 0 while the pipeline is not built.
+     */
+    uint64_t GetDeviceGeneration() const {
+        return m_overlayRenderer ? m_overlayRenderer->GetDeviceGeneration() : 0;
+    }
+    
+    /**
+     * @brief Get the effect group carrying the content opacity.
+     * @return The effect group, or nullptr while the pipeline is not built.
      */
-    OverlayRenderer& GetOverlayRenderer() { return *m_overlayRenderer; }
+    IDCompositionEffectGroup* GetContentEffect() const {
+        return m_overlayRenderer ? m_overlayRenderer->GetContentEffect() : nullptr;
+    }
+    
+    /**
+     * @brief Get the effect group carrying the border opacity.
+     * @return The effect group, or nullptr while the pipeline is not built.
+     */
+    IDCompositionEffectGroup* GetBorderEffect() const {
+        return m_overlayRenderer ? m_overlayRenderer->GetBorderEffect() : nullptr;
+    }
     
     /**
      * @brief Get the border renderer.
@@ -99,19 +169,145 @@ public:
      * @param animationManager Pointer to the animation manager.
      */
     void SetAnimationManager(AnimationManager* animationManager) { m_animationManager = animationManager; }
-
-private:
+    
+    /**
+     * @brief Set the mailbox that browser frames are picked up from on each render.
+     * @param frameMailbox Pointer to the frame mailbox, or nullptr to detach.
+     */
+    void SetFrameMailbox(FrameMailbox* frameMailbox) { m_frameMailbox = frameMailbox; }
+    
+    /**
+     * @brief Set the callback run after the pipeline was rebuilt for a lost device.
+     * Panels keep their identifiers, bounds, stacking and visibility, but
+     * their surfaces and the content surface start out empty; owners request
+     * a full frame from it.
+     * @param callback The callback, or nullptr to clear it.
+     */
+    void SetDeviceRecreatedCallback(std::function<void()> callback) { m_deviceRecreatedCallback = std::move(callback); }
+    
+    /**
+     * @brief Create a browser panel composited above the main content.
+     *
+     * While the device is lost only the panel record is created; its
+     * surface is built with the others when the pipeline is rebuilt.
+     * @param frameMailbox Mailbox the panel's frames are picked up from (not owned), or nullptr.
+     * @param bounds Panel rectangle in window coordinates.
+     * @param zOrder Stacking order among panels (higher values are on top).
+     * @return Identifier of the panel, or kInvalidPanel if creation failed.
+     */
+    PanelId CreatePanel(FrameMailbox* frameMailbox, const RECT& bounds, int zOrder = 0);
+    
+    /**
+     * @brief Destroy a panel and release its surface.
+     * @param panel The panel to destroy.
+     */
+    void DestroyPanel(PanelId panel);
+    
     /**
-     * @brief Create the render target for drawing.
-     * @return True if creation succeeded, false otherwise.
+     * @brief Move a panel; only its transform changes, nothing is re-rendered.
+     * @param panel The panel to move.
+     * @param x New left edge in window coordinates.
+     * @param y New top edge in window coordinates.
+     * @return True if the panel exists, false otherwise.
      */
-    bool CreateRenderTarget();
+    bool SetPanelPosition(PanelId panel, int x, int y);
     
     /**
-     * @brief Release the render target.
+     * @brief Move and resize a panel.
+     *
+     * The surface is resized in place and re-clipped; a move without a size
+     * change only updates the transform.
+     * @param panel The panel to update.
+     * @param bounds New rectangle in window coordinates.
+     * @return True if the panel was updated, false otherwise.
      */
-    void ReleaseRenderTarget();
+    bool SetPanelBounds(PanelId panel, const RECT& bounds);
     
+    /**
+     * @brief Show or hide a panel.
+     * @param panel The panel to update.
+     * @param visible Whether the panel should be visible.
+     * @return True if the panel exists, false otherwise.
+     */
+    bool SetPanelVisible(PanelId panel, bool visible);
+    
+    /**
+     * @brief Change a panel's stacking order.
+     * @param panel The panel to update.
+     * @param zOrder New stacking order (higher values are on top).
+     * @return True if the panel exists, false otherwise.
+     */
+    bool SetPanelZOrder(PanelId panel, int zOrder);
+    
+    /**
+     * @brief Present a panel's content from a CEF shared texture.
+     * @param panel The panel to update.
+     * @param sharedHandle Shared handle of the texture produced by CEF.
+     */
+    void UpdatePanelSharedContent(PanelId panel, HANDLE sharedHandle);
+
+private:
+    /**
+     * @struct Panel
+     * @brief One browser view composited as its own visual.
+     *
+     * The record outlives the device; the visual, clip, surface and shared
+     * texture are released on device loss and rebuilt from the record.
+     */
+    struct Panel {
+        ZOrderManager::VisualHandle visualHandle = ZOrderManager::kInvalidHandle; ///< Visual in m_zOrderManager, if built
+        Microsoft::WRL::ComPtr<IDCompositionVisual> visual;       ///< Visual positioned by offset
+        Microsoft::WRL::ComPtr<IDCompositionRectangleClip> clip;  ///< Clip to the panel size
+        std::unique_ptr<ContentSurface> surface;                  ///< Panel content
+        FrameMailbox* frameMailbox = nullptr;                     ///< Source of frames (not owned)
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> sharedTexture;    ///< Last opened CEF texture
+        HANDLE sharedHandle = nullptr;                            ///< Handle sharedTexture was opened from
+        RECT bounds = {};                                         ///< Rectangle in window coordinates
+        int zOrder = 0;                                           ///< Stacking order among panels
+        bool visible = true;                                      ///< Whether the panel is shown
+    };
+
+    /**
+     * @brief Builds the device-dependent parts of a panel from its record.
+     * @param panel The panel; left untouched on failure.
+     * @return True if the panel has a visual and surface.
+     */
+    bool CreatePanelResources(Panel& panel);
+
+    /**
+     * @brief Releases the device-dependent parts of a panel, keeping its record.
+     * @param panel The panel.
+     */
+    void ReleasePanelResources(Panel& panel);
+
+    /**
+     * @brief Releases every device-dependent component; panel records are kept.
+     */
+    void ReleasePipeline();
+
+    /**
+     * @brief Uploads the newest frame of every panel that has one.
+     * @return True if any panel surface was drawn.
+     */
+    bool UpdatePanels();
+
+    /**
+     * @brief Hands the rectangles of the visible panels to the window's hit testing.
+     */
+    void UpdatePanelHitRects();
+
+    /**
+     * @brief Handles device loss and recreation.
+     * @param event What happened to the devices.
+     */
+    void OnDeviceEvent(GraphicsDeviceEvent event);
+
+    /**
+     * @brief Rebuilds every device-dependent component after a device loss.
+     * @return True if the pipeline is usable again.
+     */
+    bool RecoverDevice();
+
     /**
      * @brief Log a message using the application logger.
      * @tparam Args Variadic template for format arguments.
@@ -120,19 +316,22 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     Application& m_app;                                 ///< Reference to the main application
     OverlayWindow& m_overlayWindow;                     ///< Reference to the overlay window
+    GraphicsDevice& m_device;                           ///< Shared devices
+    size_t m_deviceCallbackId;                          ///< Registration with m_device
     
     // Rendering components
     std::unique_ptr<OverlayRenderer> m_overlayRenderer; ///< Overlay renderer
     std::unique_ptr<BorderRenderer> m_borderRenderer;   ///< Border renderer
+    std::unique_ptr<ZOrderManager> m_zOrderManager;     ///< Orders the panel visuals
     AnimationManager* m_animationManager;               ///< Animation manager (not owned)
-    
-    // Direct2D resources
-    Microsoft::WRL::ComPtr<ID2D1Factory> m_d2dFactory;  ///< Direct2D factory
-    Microsoft::WRL::ComPtr<ID2D1RenderTarget> m_renderTarget; ///< Direct2D render target
+    FrameMailbox* m_frameMailbox;                       ///< Source of browser frames (not owned)
+    std::unordered_map<PanelId, Panel> m_panels;        ///< Panels by identifier
     
     // State variables
     bool m_initialized;                                 ///< Whether the renderer is initialized
@@ -140,6 +339,11 @@ private:
     int m_height;                                       ///< Current height
     float m_opacity;                                    ///< Current opacity
     bool m_showBorder;                                  ///< Whether to show the border
+    bool m_panelsDirty;                                 ///< Whether panel visuals changed since the last commit
+    bool m_deviceLost;                                  ///< Whether a rebuild for a lost device is outstanding
+    PanelId m_nextPanelId;                              ///< Next panel identifier to give out
+    uint64_t m_recoveryGeneration;                      ///< Device generation the last rebuild was tried on
+    std::function<void()> m_deviceRecreatedCallback;    ///< Run after a successful rebuild
 };
 
 } // namespace poe
\ No newline at end of file
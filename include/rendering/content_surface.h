@@ -0,0 +1,133 @@
+#pragma once
+
+#include <Windows.h>
+#include <d3d11.h>
+#include <dcomp.h>
+#include <wrl/client.h>
+#include <vector>
+#include "core/Application.h"
+#include "core/Logger.h"
+#include "core/MemoryTracker.h"
+
+namespace poe {
+
+/**
+ * @class ContentSurface
+ * @brief Browser content held in a DirectComposition virtual surface.
+ *
+ * Updates go through one BeginDraw(updateRect) per dirty rectangle, so only
+ * the changed tiles are touched. Resizing keeps the tiles that still fit,
+ * and content that shrinks trims the tiles it no longer covers.
+ *
+ * Drawing does not commit; the owner commits the device once per frame.
+ */
+class ContentSurface {
+public:
+    /**
+     * @brief Constructor for the ContentSurface class.
+     * @param app Reference to the main application instance.
+     */
+    explicit ContentSurface(Application& app);
+
+    /**
+     * @brief Creates the virtual surface.
+     * @param dcompDevice Device that creates the surface.
+     * @param d3dDevice Device whose immediate context uploads the pixels.
+     * @param width Initial width of the surface.
+     * @param height Initial height of the surface.
+     * @return True if creation succeeded, false otherwise.
+     */
+    bool Initialize(IDCompositionDevice* dcompDevice, ID3D11Device* d3dDevice, int width, int height);
+
+    /**
+     * @brief Releases the surface.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Uploads the changed regions of a CPU frame.
+     * @param buffer BGRA pixel buffer of the full view (width * 4 bytes per row).
+     * @param width Width of the buffer in pixels.
+     * @param height Height of the buffer in pixels.
+     * @param dirtyRects Regions of the buffer that changed since the last update.
+     * @param drawn Output parameter, set if any region was drawn and a commit is needed.
+     * @return True on success, false if drawing failed.
+     */
+    bool Update(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects, bool& drawn);
+
+    /**
+     * @brief Copies a GPU texture into the surface.
+     * @param texture Texture on the same device, typically opened from a CEF shared handle.
+     * @return True if the texture was copied and a commit is needed, false otherwise.
+     */
+    bool CopyFrom(ID3D11Texture2D* texture);
+
+    /**
+     * @brief Resizes the surface without reallocating the tiles that still fit.
+     * @param width New width.
+     * @param height New height.
+     * @return True if the surface was resized, false otherwise.
+     */
+    bool Resize(int width, int height);
+
+    /**
+     * @brief Gets the surface, to set as a visual's content.
+     * @return The surface, or nullptr if not initialized.
+     */
+    IDCompositionVirtualSurface* GetSurface() const { return m_surface.Get(); }
+
+    /**
+     * @brief Gets the surface width.
+     * @return The width in pixels.
+     */
+    int GetWidth() const { return m_width; }
+
+    /**
+     * @brief Gets the surface height.
+     * @return The height in pixels.
+     */
+    int GetHeight() const { return m_height; }
+
+private:
+    /**
+     * @brief Records the content size, trimming the surface when it shrinks.
+     * @param width Width of the content.
+     * @param height Height of the content.
+     * @return True if the size changed and the content must be uploaded in full.
+     */
+    bool SetContentSize(int width, int height);
+
+    /**
+     * @brief Starts an update of one region of the surface.
+     *
+     * The caller must call m_surface->EndDraw() after a successful call.
+     * @param updateRect The region to redraw, in surface coordinates.
+     * @param texture Output parameter for the texture to write into.
+     * @param offset Output parameter for the region's origin within texture.
+     * @return True if drawing began, false otherwise.
+     */
+    bool BeginDraw(const RECT& updateRect, Microsoft::WRL::ComPtr<ID3D11Texture2D>& texture, POINT& offset);
+
+    /**
+     * @brief Log a message using the application logger.
+     * @tparam Args Variadic template for format arguments.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string.
+     * @param args Format arguments.
+     */
+    template<typename... Args>
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    Application& m_app;                                       ///< Reference to the main application
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_d3dContext; ///< Context uploading the pixels
+    Microsoft::WRL::ComPtr<IDCompositionVirtualSurface> m_surface; ///< Backing virtual surface
+    int m_width;                                              ///< Surface width
+    int m_height;                                             ///< Surface height
+    int m_contentWidth;                                       ///< Width of the last uploaded content
+    int m_contentHeight;                                      ///< Height of the last uploaded content
+    MemoryCharge m_memoryCharge;                              ///< Full size of the surface, an upper bound of its tiles
+};
+
+} // namespace poe
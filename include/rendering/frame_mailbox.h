@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Windows.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "core/MemoryTracker.h"
+
+namespace poe {
+
+/**
+ * @struct FrameBuffer
+ * @brief A CPU-side copy of one browser frame.
+ */
+struct FrameBuffer {
+    std::vector<uint8_t> pixels;      ///< BGRA pixel data, width * 4 bytes per row
+    int width = 0;                    ///< Frame width in pixels
+    int height = 0;                   ///< Frame height in pixels
+    std::vector<RECT> dirtyRects;     ///< Regions changed since the previously consumed frame
+    uint64_t sequence = 0;            ///< Monotonic frame number assigned by the producer
+};
+
+/**
+ * @class FrameMailbox
+ * @brief Lock-free triple buffer between the CEF paint thread and the compositor.
+ *
+ * The producer always owns one buffer, the consumer owns another, and the
+ * third sits in the shared "mailbox" slot. Publishing swaps the producer's
+ * buffer into the slot; acquiring swaps the slot into the consumer. Neither
+ * side ever blocks, and a frame that is overwritten before the consumer sees
+ * it is dropped, with its dirty regions merged into the next published frame.
+ *
+ * Exactly one producer thread and one consumer thread may use an instance.
+ */
+class FrameMailbox {
+public:
+    /**
+     * @brief Constructor for the FrameMailbox class.
+     */
+    FrameMailbox();
+
+    // Non-copyable, non-movable (shared between threads by address)
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    /**
+     * @brief Publishes a new frame (producer thread only).
+     *
+     * Only the dirty regions, plus any regions the target buffer missed while
+     * it was owned by someone else, are copied out of the source buffer.
+     * @param buffer Full BGRA source buffer owned by the caller.
+     * @param width Width of the source buffer in pixels.
+     * @param height Height of the source buffer in pixels.
+     * @param dirtyRects Regions of the source that changed since the last publish.
+     */
+    void Publish(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects);
+
+    /**
+     * @brief Acquires the newest published frame (consumer thread only).
+     * @return Pointer to the newest frame, or nullptr if nothing new was
+     *         published since the last call. The pointer stays valid until
+     *         the next call to Acquire.
+     */
+    const FrameBuffer* Acquire();
+
+    /**
+     * @brief Gets the number of frames overwritten before they were consumed.
+     * @return The dropped frame count.
+     */
+    uint64_t GetDroppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kIndexMask = 0x3;   ///< Bits holding the buffer index
+    static constexpr uint32_t kFreshBit = 0x4;    ///< Set while the slot holds an unconsumed frame
+    static constexpr size_t kMaxDirtyRects = 16;  ///< Above this, rect lists collapse into their bounds
+
+    /**
+     * @brief Appends rectangles to a list, collapsing it to a bounding box when it grows too long.
+     * @param target The list to append to.
+     * @param rects The rectangles to append.
+     */
+    static void MergeRects(std::vector<RECT>& target, const std::vector<RECT>& rects);
+
+    std::array<FrameBuffer, 3> m_buffers;         ///< The three frame buffers
+    std::atomic<uint32_t> m_slot;                 ///< Mailbox slot: buffer index plus fresh bit
+
+    // Producer-only state
+    uint32_t m_backIndex;                         ///< Buffer currently owned by the producer
+    std::array<std::vector<RECT>, 3> m_staleRects; ///< Per buffer, regions it has not received yet
+    std::array<bool, 3> m_staleAll;               ///< Per buffer, whether it must be fully rewritten
+    std::vector<RECT> m_carriedRects;             ///< Dirty regions of dropped frames
+    std::vector<RECT> m_publishedRects;           ///< Damage of the most recently published frame
+    uint64_t m_sequence;                          ///< Last assigned frame number
+    int m_width;                                  ///< Size of the most recently published frame
+    int m_height;                                 ///< Size of the most recently published frame
+
+    // Consumer-only state
+    uint32_t m_frontIndex;                        ///< Buffer currently owned by the consumer
+
+    std::atomic<uint64_t> m_droppedFrames;        ///< Frames overwritten before consumption
+    MemoryCharge m_pixelCharge;                   ///< Pixel storage of the three buffers
+};
+
+} // namespace poe
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <Windows.h>
+#include <d3d11.h>
+#include <dxgi1_2.h>
+#include <dcomp.h>
+#include <d2d1_1.h>
+#include <wrl/client.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "core/Application.h"
+#include "core/Logger.h"
+
+namespace poe {
+
+// Forward declarations
+class Application;
+
+/**
+ * @enum GraphicsDeviceEvent
+ * @brief What happened to the shared graphics devices.
+ */
+enum class GraphicsDeviceEvent {
+    Lost,       ///< The devices were removed; release everything created on them now
+    Recreated   ///< New devices are available; rebuild on next use
+};
+
+/**
+ * @class GraphicsDevice
+ * @brief Owns the D3D11, Direct2D and DirectComposition devices the renderers share.
+ *
+ * Renderers take their devices from here instead of creating their own,
+ * so a driver reset is handled in one place. CheckDevice(), called once
+ * per frame by whoever drives rendering, notices a removed device, tells
+ * every registered callback to release its device resources, and creates
+ * new devices, at most once per second while that keeps failing. Callbacks
+ * then hear Recreated and rebuild lazily, on their next use, instead of
+ * each failing call retrying on its own every frame.
+ *
+ * The Direct2D factory does not depend on a device and survives
+ * recreation, so geometries made from it stay valid.
+ *
+ * Create() may run on a worker before the window exists; everything else,
+ * callbacks included, belongs to the render thread.
+ */
+class GraphicsDevice {
+public:
+    /**
+     * @brief Type definition for device event callbacks.
+     */
+    using DeviceCallback = std::function<void(GraphicsDeviceEvent)>;
+
+    /**
+     * @brief Constructor for the GraphicsDevice class.
+     * @param app Reference to the main application instance.
+     */
+    explicit GraphicsDevice(Application& app);
+
+    /**
+     * @brief Destructor for the GraphicsDevice class.
+     */
+    ~GraphicsDevice();
+
+    // Non-copyable
+    GraphicsDevice(const GraphicsDevice&) = delete;
+    GraphicsDevice& operator=(const GraphicsDevice&) = delete;
+
+    /**
+     * @brief Creates the devices, unless they already exist.
+     *
+     * Needs no window, so it may run on a worker while the window is created;
+     * the caller must join it before any renderer is initialized.
+     * @return True if the D3D11 and DirectComposition devices exist.
+     */
+    bool Create();
+
+    /**
+     * @brief Releases the devices and the Direct2D factory.
+     */
+    void Shutdown();
+
+    /**
+     * @brief Detects a lost device and recreates it.
+     * This should be called once per frame, before rendering; further
+     * calls in the same frame cost one GetDeviceRemovedReason().
+     * @return True if the devices are usable.
+     */
+    bool CheckDevice();
+
+    /**
+     * @brief Checks whether the devices exist.
+     * @return True if the devices were created and not lost since.
+     */
+    bool IsAvailable() const { return m_d3dDevice && m_dcompDevice; }
+
+    /**
+     * @brief Gets the generation of the current devices.
+     * @return A number that increases with every successful creation; 0 before the first.
+     */
+    uint64_t GetGeneration() const { return m_generation; }
+
+    /**
+     * @brief Gets the Direct3D device surfaces are drawn with.
+     * @return The device, or nullptr if unavailable.
+     */
+    ID3D11Device* GetD3DDevice() const { return m_d3dDevice.Get(); }
+
+    /**
+     * @brief Gets the DirectComposition device.
+     * @return The device, or nullptr if unavailable.
+     */
+    IDCompositionDevice* GetCompositionDevice() const { return m_dcompDevice.Get(); }
+
+    /**
+     * @brief Gets the Direct2D factory that border geometries must come from.
+     * @return The factory, or nullptr if Direct2D is unavailable.
+     */
+    ID2D1Factory1* GetD2DFactory() const { return m_d2dFactory.Get(); }
+
+    /**
+     * @brief Gets the Direct2D context drawing into composition surfaces.
+     * @return The context, or nullptr if Direct2D is unavailable.
+     */
+    ID2D1DeviceContext* GetD2DContext() const { return m_d2dContext.Get(); }
+
+    /**
+     * @brief Registers a callback for device loss and recreation.
+     * @param callback The callback function to register.
+     * @return ID of the callback for later removal.
+     */
+    size_t RegisterDeviceCallback(const DeviceCallback& callback);
+
+    /**
+     * @brief Unregisters a device callback.
+     * @param callbackId ID of the callback to unregister.
+     * @return True if the callback was found and removed, false otherwise.
+     */
+    bool UnregisterDeviceCallback(size_t callbackId);
+
+private:
+    /**
+     * @brief Internal structure for storing callbacks with their IDs.
+     */
+    struct CallbackEntry {
+        size_t id;
+        DeviceCallback callback;
+    };
+
+    /**
+     * @brief Releases the devices, keeping the Direct2D factory.
+     */
+    void ReleaseDevices();
+
+    /**
+     * @brief Runs every registered callback.
+     * @param event The event to deliver.
+     */
+    void Broadcast(GraphicsDeviceEvent event);
+
+    /**
+     * @brief Log a message using the application logger.
+     * @tparam Args Variadic template for format arguments.
+     * @param level The log level (0=trace, 1=debug, 2=info, 3=warning, 4=error, 5=critical).
+     * @param fmt Format string.
+     * @param args Format arguments.
+     */
+    template<typename... Args>
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
+
+    Application& m_app;                                     ///< Reference to the main application
+
+    Microsoft::WRL::ComPtr<ID3D11Device> m_d3dDevice;       ///< Direct3D device
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_d3dContext; ///< Immediate context of m_d3dDevice
+    Microsoft::WRL::ComPtr<IDXGIDevice> m_dxgiDevice;       ///< DXGI view of m_d3dDevice
+    Microsoft::WRL::ComPtr<IDCompositionDevice> m_dcompDevice; ///< DirectComposition device
+    Microsoft::WRL::ComPtr<ID2D1Factory1> m_d2dFactory;     ///< Direct2D factory, kept across recreation
+    Microsoft::WRL::ComPtr<ID2D1Device> m_d2dDevice;        ///< Direct2D device on m_dxgiDevice
+    Microsoft::WRL::ComPtr<ID2D1DeviceContext> m_d2dContext; ///< Direct2D context
+
+    std::vector<CallbackEntry> m_callbacks;                 ///< Registered device callbacks
+    size_t m_nextCallbackId;                                ///< Counter for generating callback IDs
+    uint64_t m_generation;                                  ///< Increases with every creation
+    bool m_lost;                                            ///< Whether the devices were lost and not yet recreated
+    std::chrono::steady_clock::time_point m_nextRecreateAttempt; ///< Earliest time of the next recreation
+};
+
+} // namespace poe
@@ -4,16 +4,22 @@
 #include <d3d11.h>
 #include <dxgi1_2.h>
 #include <dcomp.h>
+#include <d2d1_1.h>
 #include <wrl/client.h>
 #include <memory>
 #include <vector>
 #include <functional>
 #include "core/Application.h"
+#include "core/Logger.h"
+#include "core/MemoryTracker.h"
+#include "rendering/graphics_device.h"
 
 namespace poe {
 
 // Forward declarations
 class OverlayWindow;
+class BorderRenderer;
+class ContentSurface;
 
 /**
  * @class OverlayRenderer
@@ -22,6 +28,11 @@ class OverlayWindow;
  * This class provides advanced rendering capabilities for the overlay window,
  * including hardware-accelerated transparency, smooth animations, and efficient
  * composition with the desktop.
+ *
+ * The devices come from a GraphicsDevice. When it reports them lost, every
+ * resource created on them is released at once, and the next Render() after
+ * they were recreated builds the composition tree again, once per device
+ * generation.
  */
 class OverlayRenderer {
 public:
@@ -29,8 +40,9 @@ public:
      * @brief Constructor for the OverlayRenderer class.
      * @param app Reference to the main application instance.
      * @param overlayWindow Reference to the overlay window to render.
+     * @param device Devices to render with; must outlive the renderer.
      */
-    OverlayRenderer(Application& app, OverlayWindow& overlayWindow);
+    OverlayRenderer(Application& app, OverlayWindow& overlayWindow, GraphicsDevice& device);
     
     /**
      * @brief Destructor for the OverlayRenderer class.
@@ -39,6 +51,9 @@ public:
 
     /**
      * @brief Initializes the renderer.
+     *
+     * Creates the devices itself if GraphicsDevice::Create() was not called
+     * or failed.
      * @return True if initialization succeeded, false otherwise.
      */
     bool Initialize();
@@ -49,17 +64,93 @@ public:
     void Shutdown();
 
     /**
-     * @brief Updates the opacity of the overlay.
+     * @brief Sets the opacity of the overlay immediately.
+     *
+     * Replaces any composition animation running on the content opacity.
+     * Fades are submitted through AnimationManager::CreateCompositionAnimation
+     * against GetContentEffect() instead.
      * @param opacity New opacity value (0.0-1.0).
-     * @param animate Whether to animate the transition.
      */
-    void SetOpacity(float opacity, bool animate = false);
+    void SetOpacity(float opacity);
     
     /**
      * @brief Renders a frame.
+     *
+     * Rebuilds the composition tree first if the devices were recreated
+     * since it was released.
      */
     void Render();
     
+    /**
+     * @brief Gets the DirectComposition device, for compiling animations.
+     * @return The device, or nullptr if not initialized.
+     */
+    IDCompositionDevice* GetCompositionDevice() const { return m_dcompDevice.Get(); }
+    
+    /**
+     * @brief Gets the Direct3D device surfaces are drawn with.
+     * @return The device, or nullptr if not initialized.
+     */
+    ID3D11Device* GetD3DDevice() const { return m_d3dDevice.Get(); }
+    
+    /**
+     * @brief Gets the device generation the composition tree was built on.
+     *
+     * Changes whenever the tree was rebuilt after a device loss; anything
+     * holding the effect groups or the composition device must fetch them again.
+     * @return The generation, or 0 if not initialized.
+     */
+    uint64_t GetDeviceGeneration() const { return m_initialized ? m_deviceGeneration : 0; }
+    
+    /**
+     * @brief Adds a visual subtree between the main content and the border.
+     * @param visual The visual to attach.
+     * @return True if the visual was attached, false otherwise.
+     */
+    bool AttachVisual(IDCompositionVisual* visual);
+    
+    /**
+     * @brief Removes a visual attached with AttachVisual().
+     * @param visual The visual to detach.
+     */
+    void DetachVisual(IDCompositionVisual* visual);
+    
+    /**
+     * @brief Gets the effect group carrying the content opacity.
+     * @return The effect group, or nullptr if not initialized.
+     */
+    IDCompositionEffectGroup* GetContentEffect() const { return m_contentEffect.Get(); }
+    
+    /**
+     * @brief Gets the effect group carrying the border opacity.
+     * @return The effect group, or nullptr if not initialized.
+     */
+    IDCompositionEffectGroup* GetBorderEffect() const { return m_borderEffect.Get(); }
+    
+    /**
+     * @brief Uploads new browser content, touching only the changed regions.
+     *
+     * Each dirty rect is drawn into the content virtual surface with its own
+     * BeginDraw update rect, so untouched tiles never see GPU traffic.
+     * @param buffer BGRA pixel buffer of the full view (width * 4 bytes per row).
+     * @param width Width of the buffer in pixels.
+     * @param height Height of the buffer in pixels.
+     * @param dirtyRects Regions of the buffer that changed since the last update.
+     * @return True if the content was uploaded and presented, false otherwise.
+     */
+    bool UpdateContent(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects);
+    
+    /**
+     * @brief Presents browser content from a shared GPU texture.
+     *
+     * Used in accelerated mode, where CEF renders into a shared D3D11 texture.
+     * The texture is opened on this device and copied GPU-side into the
+     * content surface, so no pixels travel through system memory.
+     * @param sharedHandle Legacy shared handle of the CEF texture.
+     * @return True if the frame was presented, false otherwise.
+     */
+    bool PresentSharedTexture(HANDLE sharedHandle);
+    
     /**
      * @brief Handles window size changes.
      * @param width New width of the window.
@@ -73,6 +164,28 @@ public:
      */
     void ShowBorders(bool show);
     
+    /**
+     * @brief Opacity of the border visual while the border is shown.
+     */
+    static constexpr float kBorderOpacity = 0.7f;
+    
+    /**
+     * @brief Rasterizes the border into the border visual's surface.
+     *
+     * Only needed when the border's shape or style changed; showing, hiding
+     * and fading the border afterwards only touch the visual's opacity.
+     * Does not commit; the new content shows with the caller's next commit.
+     * @param border The border to draw.
+     * @return True if the surface was updated, false otherwise.
+     */
+    bool RasterizeBorder(BorderRenderer& border);
+
+    /**
+     * @brief Gets the Direct2D factory that border geometries must come from.
+     * @return The factory, or nullptr if Direct2D is unavailable.
+     */
+    ID2D1Factory* GetD2DFactory() const { return m_device.GetD2DFactory(); }
+    
     /**
      * @brief Sets a callback to be notified when border state changes.
      * @param callback The callback function.
@@ -88,13 +201,18 @@ public:
 
 private:
     /**
-     * @brief Creates Direct3D and DirectComposition resources.
-     * @return True if creation succeeded, false otherwise.
+     * @brief Releases everything created on the devices.
      */
-    bool CreateDeviceResources();
+    void ReleaseResources();
     
     /**
-     * @brief Creates Direct2D resources for rendering.
+     * @brief Handles device loss and recreation.
+     * @param event What happened to the devices.
+     */
+    void OnDeviceEvent(GraphicsDeviceEvent event);
+    
+    /**
+     * @brief Creates the virtual surface that holds the browser content.
      * @return True if creation succeeded, false otherwise.
      */
     bool CreateRenderResources();
@@ -113,7 +231,9 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     // Application reference
     Application& m_app;
@@ -121,24 +241,35 @@ private:
     // Overlay window reference
     OverlayWindow& m_overlayWindow;
     
+    // Shared devices
+    GraphicsDevice& m_device;
+    size_t m_deviceCallbackId;
+    uint64_t m_deviceGeneration;
+    bool m_needsRebuild;
+    
     // DirectX resources
     Microsoft::WRL::ComPtr<ID3D11Device> m_d3dDevice;
-    Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_d3dContext;
-    Microsoft::WRL::ComPtr<IDXGIDevice> m_dxgiDevice;
-    Microsoft::WRL::ComPtr<IDXGIFactory2> m_dxgiFactory;
-    Microsoft::WRL::ComPtr<IDXGISwapChain1> m_swapChain;
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> m_sharedTexture;
+    HANDLE m_sharedHandle;
     
     // DirectComposition resources
     Microsoft::WRL::ComPtr<IDCompositionDevice> m_dcompDevice;
     Microsoft::WRL::ComPtr<IDCompositionTarget> m_dcompTarget;
     Microsoft::WRL::ComPtr<IDCompositionVisual> m_rootVisual;
     Microsoft::WRL::ComPtr<IDCompositionVisual> m_contentVisual;
+    std::unique_ptr<ContentSurface> m_content;
     Microsoft::WRL::ComPtr<IDCompositionVisual> m_borderVisual;
+    Microsoft::WRL::ComPtr<IDCompositionEffectGroup> m_contentEffect;
+    Microsoft::WRL::ComPtr<IDCompositionEffectGroup> m_borderEffect;
+    Microsoft::WRL::ComPtr<IDCompositionSurface> m_borderSurface;
+    MemoryCharge m_borderSurfaceCharge;
+    
+    // Direct2D context for drawing into composition surfaces
+    Microsoft::WRL::ComPtr<ID2D1DeviceContext> m_d2dContext;
     
     // State variables
     bool m_initialized;
     float m_currentOpacity;
-    float m_targetOpacity;
     bool m_showBorders;
     int m_width;
     int m_height;
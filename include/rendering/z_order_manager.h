@@ -3,11 +3,12 @@
 #include <Windows.h>
 #include <dcomp.h>
 #include <wrl/client.h>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
-#include <unordered_map>
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
@@ -17,6 +18,9 @@ namespace poe {
  * 
  * This class provides management of composition visual elements,
  * including their relative ordering, visibility, and updates.
+ *
+ * Mutations are only recorded; Commit() patches the tree in one pass,
+ * moving just the visuals that changed, and commits the device once.
  */
 class ZOrderManager {
 public:
@@ -57,29 +61,32 @@ public:
      */
     void Shutdown();
     
+    /**
+     * @brief Stable integer handle identifying a managed visual.
+     */
+    using VisualHandle = uint32_t;
+
+    /**
+     * @brief Handle value that never refers to a visual.
+     */
+    static constexpr VisualHandle kInvalidHandle = 0;
+
     /**
      * @brief Creates a visual element.
-     * @param name Name of the visual.
      * @param layerType Layer type for the visual.
-     * @param zOrder Z-order value (higher values are on top, used for Custom layer type).
-     * @return Visual element or nullptr if creation failed.
+     * @param zOrder Z-order value within the layer (higher values are on top).
+     * @return Handle of the new visual, or kInvalidHandle if creation failed.
      */
-    Microsoft::WRL::ComPtr<IDCompositionVisual> CreateVisual(
-        const std::string& name,
-        LayerType layerType = LayerType::Content,
-        int zOrder = 0
-    );
+    VisualHandle CreateVisual(LayerType layerType = LayerType::Content, int zOrder = 0);
     
     /**
-     * @brief Adds a visual element to the composition tree.
-     * @param name Name of the visual.
+     * @brief Adds an existing visual element to the composition tree.
      * @param visual Visual element to add.
      * @param layerType Layer type for the visual.
-     * @param zOrder Z-order value (higher values are on top, used for Custom layer type).
-     * @return True if addition succeeded, false otherwise.
+     * @param zOrder Z-order value within the layer (higher values are on top).
+     * @return Handle of the visual, or kInvalidHandle if the visual is null.
      */
-    bool AddVisual(
-        const std::string& name,
+    VisualHandle AddVisual(
         Microsoft::WRL::ComPtr<IDCompositionVisual> visual,
         LayerType layerType = LayerType::Content,
         int zOrder = 0
@@ -87,35 +94,37 @@ public:
     
     /**
      * @brief Removes a visual element.
-     * @param name Name of the visual to remove.
-     * @return True if removal succeeded, false otherwise.
+     * @param handle Handle of the visual to remove.
+     * @return True if removal was recorded, false if the handle is unknown.
      */
-    bool RemoveVisual(const std::string& name);
+    bool RemoveVisual(VisualHandle handle);
     
     /**
-     * @brief Gets a visual element by name.
-     * @param name Name of the visual.
+     * @brief Gets a visual element by handle.
+     * @param handle Handle of the visual.
      * @return Visual element or nullptr if not found.
      */
-    Microsoft::WRL::ComPtr<IDCompositionVisual> GetVisual(const std::string& name);
+    Microsoft::WRL::ComPtr<IDCompositionVisual> GetVisual(VisualHandle handle) const;
     
     /**
      * @brief Sets the visibility of a visual element.
-     * @param name Name of the visual.
+     *
+     * Hidden visuals are detached from the tree on the next Commit().
+     * @param handle Handle of the visual.
      * @param visible Whether the visual should be visible.
      * @return True if visibility was set, false otherwise.
      */
-    bool SetVisualVisibility(const std::string& name, bool visible);
+    bool SetVisualVisibility(VisualHandle handle, bool visible);
     
     /**
      * @brief Sets the Z-order of a visual element.
-     * @param name Name of the visual.
+     * @param handle Handle of the visual.
      * @param layerType New layer type for the visual.
-     * @param zOrder New Z-order value (higher values are on top, used for Custom layer type).
+     * @param zOrder New Z-order value within the layer (higher values are on top).
      * @return True if Z-order was set, false otherwise.
      */
     bool SetVisualZOrder(
-        const std::string& name,
+        VisualHandle handle,
         LayerType layerType = LayerType::Content,
         int zOrder = 0
     );
@@ -127,23 +136,79 @@ public:
     Microsoft::WRL::ComPtr<IDCompositionVisual> GetRootVisual() const { return m_rootVisual; }
     
     /**
-     * @brief Applies pending changes to the composition.
-     * @return True if commit succeeded, false otherwise.
+     * @brief Checks whether mutations are waiting for Commit().
+     * @return True if the tree differs from what was last committed.
+     */
+    bool HasPendingChanges() const { return m_pendingChanges; }
+    
+    /**
+     * @brief Patches the tree with all recorded mutations and commits once.
+     *
+     * Meant to be called once per frame; does nothing when no mutation
+     * was recorded since the last call.
+     * @return True if commit succeeded or was not needed, false otherwise.
      */
     bool Commit();
 
 private:
     /**
-     * @brief Rebuilds the composition tree based on current Z-ordering.
+     * @struct VisualInfo
+     * @brief Information about a visual element.
+     */
+    struct VisualInfo {
+        Microsoft::WRL::ComPtr<IDCompositionVisual> visual; ///< Visual element
+        VisualHandle handle;                               ///< Handle given out for the visual
+        LayerType layerType;                               ///< Layer type
+        int layerBase;                                     ///< Cached GetLayerBaseZOrder(layerType)
+        int zOrder;                                        ///< Z-order value
+        bool visible;                                      ///< Visibility state
+        bool inTree;                                       ///< Whether the visual is attached to the root
+        bool dirty;                                        ///< Whether the visual must be re-placed on commit
+    };
+
+    /**
+     * @brief Registers a visual and records its insertion.
+     * @param visual Visual element.
+     * @param layerType Layer type.
+     * @param zOrder Z-order value.
+     * @return Handle of the visual.
      */
-    void RebuildTree();
+    VisualHandle Insert(Microsoft::WRL::ComPtr<IDCompositionVisual> visual, LayerType layerType, int zOrder);
+
+    /**
+     * @brief Finds a visual by handle.
+     * @param handle Handle of the visual.
+     * @return Pointer into m_visuals, or nullptr if not found.
+     */
+    VisualInfo* Find(VisualHandle handle);
+
+    /**
+     * @brief Const overload of Find().
+     */
+    const VisualInfo* Find(VisualHandle handle) const;
+
+    /**
+     * @brief Ordering of m_visuals: layer, then Z-order, then creation.
+     * @return True if a is drawn below b.
+     */
+    static bool SortsBefore(const VisualInfo& a, const VisualInfo& b);
+
+    /**
+     * @brief Sorts m_visuals and refreshes m_handleIndex.
+     */
+    void SortVisuals();
+
+    /**
+     * @brief Applies recorded mutations to the composition tree.
+     */
+    void PatchTree();
     
     /**
      * @brief Gets the Z-order value for a layer type.
      * @param layerType Layer type.
      * @return Z-order value.
      */
-    int GetLayerBaseZOrder(LayerType layerType) const;
+    static int GetLayerBaseZOrder(LayerType layerType);
     
     /**
      * @brief Log a message using the application logger.
@@ -153,26 +218,23 @@ private:
      * @param args Format arguments.
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
-    /**
-     * @struct VisualInfo
-     * @brief Information about a visual element.
-     */
-    struct VisualInfo {
-        Microsoft::WRL::ComPtr<IDCompositionVisual> visual; ///< Visual element
-        LayerType layerType;                               ///< Layer type
-        int zOrder;                                        ///< Z-order value
-        bool visible;                                      ///< Visibility state
-    };
+    static constexpr uint32_t kNoIndex = UINT32_MAX; ///< m_handleIndex value of a free handle
 
     Application& m_app;                                    ///< Reference to the main application
     Microsoft::WRL::ComPtr<IDCompositionDevice> m_dcompDevice; ///< DirectComposition device
     Microsoft::WRL::ComPtr<IDCompositionVisual> m_rootVisual; ///< Root visual element
     
-    std::unordered_map<std::string, VisualInfo> m_visuals; ///< Map of visual elements by name
+    std::vector<VisualInfo> m_visuals;                     ///< Visuals sorted bottom to top
+    std::vector<uint32_t> m_handleIndex;                   ///< Position in m_visuals by handle
+    std::vector<Microsoft::WRL::ComPtr<IDCompositionVisual>> m_detached; ///< Removed visuals still attached to the root
+    VisualHandle m_nextHandle;                             ///< Next handle to give out
     bool m_initialized;                                    ///< Whether the manager is initialized
-    bool m_treeNeedsRebuild;                              ///< Whether the tree needs rebuilding
+    bool m_orderDirty;                                     ///< Whether m_visuals needs re-sorting
+    bool m_pendingChanges;                                 ///< Whether Commit() has work to do
 };
 
 } // namespace poe
\ No newline at end of file
@@ -0,0 +1,107 @@
+/**
+ * @file hit_test_mask.h
+ * @brief Defines the HitTestMask class that decides which overlay pixels take the mouse
+ *
+ * This header provides a coarse opacity mask of the composited content plus
+ * a set of solid rectangles (panels), from which the overlay builds the
+ * window region that routes clicks either to itself or to the game below.
+ */
+
+ #pragma once
+
+ #include <Windows.h>
+ #include <cstdint>
+ #include <span>
+ #include <vector>
+
+ namespace poe {
+
+ /**
+  * @class HitTestMask
+  * @brief Tracks the parts of the overlay that should capture mouse input
+  *
+  * Content is reduced to a grid of kCellSize cells; a cell is solid if any
+  * pixel in it has non-zero alpha, so nothing visible ever falls outside the
+  * mask. Only cells under the dirty rectangles of an update are rescanned.
+  */
+ class HitTestMask {
+ public:
+     static constexpr int kCellSize = 8;  ///< Cell edge length in pixels
+
+     /**
+      * @brief Rescan the content cells under the changed regions
+      *
+      * A size change rescans the whole buffer, whatever the dirty rectangles say.
+      *
+      * @param buffer Premultiplied BGRA pixels of the full content, tightly packed
+      * @param width Width of the buffer in pixels
+      * @param height Height of the buffer in pixels
+      * @param dirtyRects Regions of the buffer that changed since the last update
+      * @return true If any cell changed
+      * @return false If the mask is unchanged
+      */
+     bool Update(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects);
+
+     /**
+      * @brief Mark the whole content solid
+      *
+      * For content whose pixels never reach the CPU (shared textures).
+      *
+      * @param width Content width in pixels
+      * @param height Content height in pixels
+      * @return true If any cell changed
+      * @return false If the mask is unchanged
+      */
+     bool Fill(int width, int height);
+
+     /**
+      * @brief Replace the solid rectangles that are hit-testable regardless of content
+      *
+      * @param rects Rectangles in content coordinates
+      * @return true If the set changed
+      * @return false If it is the same set
+      */
+     bool SetRects(const std::vector<RECT>& rects);
+
+     /**
+      * @brief Check whether a point is covered by solid content or a rectangle
+      *
+      * @param x X coordinate in content pixels
+      * @param y Y coordinate in content pixels
+      * @return true If the point should capture the mouse
+      * @return false If it should pass through
+      */
+     bool Contains(int x, int y) const;
+
+     /**
+      * @brief Build a region covering the mask, the rectangles and any extra rectangles
+      *
+      * Runs of solid cells become one rectangle per row, and identical
+      * consecutive rows are merged into one band, so the region stays small
+      * for typical panel-shaped content.
+      *
+      * @param extra Additional rectangles to include
+      * @return HRGN The region (caller owns it), or nullptr on failure
+      */
+     HRGN CreateRegion(std::span<const RECT> extra = {}) const;
+
+ private:
+     /**
+      * @brief Rescan one cell
+      *
+      * @param pixels Start of the buffer
+      * @param column Cell column
+      * @param row Cell row
+      * @return true If the cell changed
+      */
+     bool ScanCell(const uint8_t* pixels, int column, int row);
+
+     int m_width = 0;                 ///< Content width in pixels
+     int m_height = 0;                ///< Content height in pixels
+     int m_columns = 0;               ///< Cells per row
+     int m_rows = 0;                  ///< Rows of cells
+     std::vector<uint8_t> m_cells;    ///< 1 for solid cells, row-major
+     std::vector<RECT> m_rects;       ///< Always-solid rectangles
+ };
+
+ } // namespace poe
@@ -9,21 +9,65 @@
  #pragma once
 
  #include <Windows.h>
+ #include <atomic>
+ #include <bitset>
+ #include <chrono>
+ #include <future>
+ #include <thread>
  #include <vector>
  #include <functional>
+ #include <span>
  #include <string>
- #include <unordered_map>
  #include <memory>
  #include "core/Application.h"
+ #include "core/EventSystem.h"
  
  namespace poe {
  
  // Forward declarations
  class Application;
  
+ /**
+  * @class HotkeyEvent
+  * @brief Published by the low-latency input thread when a global hotkey goes down
+  */
+ class HotkeyEvent : public Event {
+ public:
+     /**
+      * @brief Construct a new Hotkey Event object
+      * 
+      * @param window Window of the InputHandler the hotkey belongs to
+      * @param hotkeyId ID returned by RegisterHotkey
+      * @param modifiers Modifier keys held when the key went down
+      * @param virtualKey Virtual key code
+      * @param pressedAt When the input thread received the key press
+      */
+     HotkeyEvent(HWND window, int hotkeyId, UINT modifiers, UINT virtualKey,
+                 std::chrono::steady_clock::time_point pressedAt)
+         : window(window), hotkeyId(hotkeyId), modifiers(modifiers), virtualKey(virtualKey), pressedAt(pressedAt) {}
+ 
+     std::string GetTypeName() const override { return "HotkeyEvent"; }
+     std::string ToString() const override;
+ 
+     HWND window;                                    ///< Window of the owning InputHandler
+     int hotkeyId;                                   ///< Hotkey ID
+     UINT modifiers;                                 ///< Modifier keys (MOD_*)
+     UINT virtualKey;                                ///< Virtual key code
+     std::chrono::steady_clock::time_point pressedAt; ///< When the key press was received
+ };
+ 
  /**
   * @class InputHandler
   * @brief Manages hotkeys and input for the overlay
+  * 
+  * Global hotkeys normally go through RegisterHotKey and arrive as WM_HOTKEY
+  * on the window's message loop, behind whatever that loop is busy with.
+  * With low-latency input enabled ("input.lowLatencyHotkeys"), a dedicated
+  * high-priority thread reads the keyboard through Raw Input instead,
+  * matches each key press against a prebuilt (modifiers, key) table and
+  * publishes a timestamped HotkeyEvent; the callback still runs on the
+  * thread that processes events. Unlike RegisterHotKey, Raw Input does not
+  * consume the key, so the game sees the press as well.
   */
  class InputHandler {
  public:
@@ -37,6 +81,7 @@
          UINT virtualKey;        ///< Virtual key code
          std::string description; ///< Human-readable description
          bool global;            ///< Whether the hotkey is global (works outside the app)
+         std::string displayName; ///< HotkeyToString(modifiers, virtualKey), computed once at registration
      };
  
      /**
@@ -52,14 +97,10 @@
       */
      ~InputHandler();
  
-     // Non-copyable
+     // Non-copyable, non-movable (the input thread and event subscription refer to this instance)
      InputHandler(const InputHandler&) = delete;
      InputHandler& operator=(const InputHandler&) = delete;
  
-     // Movable
-     InputHandler(InputHandler&&) noexcept;
-     InputHandler& operator=(InputHandler&&) noexcept;
- 
      /**
       * @brief Register a hotkey
       * 
@@ -87,6 +128,23 @@
       */
      bool UnregisterHotkey(int id);
  
+     /**
+      * @brief Switch global hotkeys between RegisterHotKey and the Raw Input thread
+      * 
+      * @param enable Whether to start (true) or stop (false) the input thread
+      * @return true If the input thread is running after the call
+      * @return false If it is not, and global hotkeys use RegisterHotKey
+      */
+     bool EnableLowLatencyInput(bool enable);
+ 
+     /**
+      * @brief Check whether global hotkeys are read by the Raw Input thread
+      * 
+      * @return true If the input thread is running and registered for keyboard input
+      * @return false Otherwise
+      */
+     bool IsLowLatencyInputActive() const { return m_lowLatencyActive.load(std::memory_order_acquire); }
+ 
      /**
       * @brief Handle window messages related to input
       * 
@@ -100,11 +158,22 @@
      bool HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
  
      /**
-      * @brief Get a list of all registered hotkeys
+      * @brief Get all registered hotkeys, sorted by ID
+      * 
+      * The view refers to the handler's own table and stays valid until the
+      * next RegisterHotkey or UnregisterHotkey call.
+      * 
+      * @return std::span<const Hotkey> The registered hotkeys
+      */
+     std::span<const Hotkey> GetHotkeys() const { return m_hotkeys; }
+
+     /**
+      * @brief Look up a registered hotkey by ID
       * 
-      * @return std::vector<Hotkey> List of hotkeys
+      * @param id Hotkey ID
+      * @return const Hotkey* The hotkey, or nullptr if no hotkey has this ID; valid until the next registration change
       */
-     std::vector<Hotkey> GetHotkeys() const;
+     const Hotkey* FindHotkey(int id) const;
  
      /**
       * @brief Check if a key is currently pressed
@@ -125,23 +194,92 @@
      static std::string HotkeyToString(UINT modifiers, UINT virtualKey);
  
  private:
+     /**
+      * @brief One entry of the (modifiers, key) lookup table used by the input thread
+      */
+     struct HotkeyLookupEntry {
+         uint32_t key;   ///< MakeLookupKey(modifiers, virtualKey)
+         int id;         ///< Hotkey ID
+     };
+ 
+     /// Lookup table sorted by key
+     using HotkeyLookup = std::vector<HotkeyLookupEntry>;
+ 
      /**
       * @brief Generate a unique ID for a new hotkey
       * 
       * @return int Unique ID
       */
      int GenerateHotkeyId() const;
+
+     /**
+      * @brief Find the position of a hotkey in m_hotkeys in constant time
+      * 
+      * @param id Hotkey ID
+      * @return int Index into m_hotkeys and m_callbacks, or -1 if not registered
+      */
+     int FindIndex(int id) const;
+
+     /**
+      * @brief Recompute m_indexById after m_hotkeys changed
+      */
+     void RebuildIdIndex();
+ 
+     /**
+      * @brief Pack modifiers and a virtual key into one lookup key
+      * 
+      * @param modifiers Modifier keys; flags other than MOD_ALT/CONTROL/SHIFT/WIN are ignored
+      * @param virtualKey Virtual key code
+      * @return uint32_t The lookup key
+      */
+     static uint32_t MakeLookupKey(UINT modifiers, UINT virtualKey);
+ 
+     /**
+      * @brief Publish a new lookup table of the global hotkeys to the input thread
+      */
+     void RebuildHotkeyLookup();
+ 
+     /**
+      * @brief Input thread function: registers for Raw Input and pumps messages
+      * 
+      * @param started Fulfilled with the thread ID once registration succeeded (or failed)
+      */
+     void InputThread(std::promise<DWORD>& started);
+ 
+     /**
+      * @brief Window procedure of the input thread's message-only window
+      */
+     static LRESULT CALLBACK RawInputWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+ 
+     /**
+      * @brief Track modifier state and match a key press, on the input thread
+      * 
+      * @param keyboard The raw keyboard input
+      * @param receivedAt When the input thread received it
+      */
+     void OnRawKeyboard(const RAWKEYBOARD& keyboard, std::chrono::steady_clock::time_point receivedAt);
+ 
+     /**
+      * @brief Run the callback of a hotkey reported by the input thread
+      * 
+      * @param event The hotkey event
+      */
+     void OnHotkeyEvent(const HotkeyEvent& event);
  
      Application& m_app;           ///< Reference to the main application
      HWND m_hwnd;                 ///< Window handle
-     int m_nextHotkeyId;          ///< Next available hotkey ID
+     int m_nextHotkeyId;          ///< Lowest hotkey ID handed out
      
-     struct HotkeyData {
-         Hotkey hotkey;
-         std::function<void()> callback;
-     };
-     
-     std::unordered_map<int, HotkeyData> m_hotkeys;  ///< Registered hotkeys
+     std::vector<Hotkey> m_hotkeys;                  ///< Registered hotkeys, sorted by ID
+     std::vector<std::shared_ptr<const std::function<void()>>> m_callbacks; ///< Callback of m_hotkeys[i]; shared so a callback may unregister itself
+     std::vector<uint32_t> m_indexById;              ///< Hotkey ID -> index in m_hotkeys + 1, or 0 if unused
+ 
+     std::unique_ptr<std::thread> m_inputThread;     ///< Raw Input thread, if enabled
+     DWORD m_inputThreadId;                          ///< Thread ID of the input thread (for WM_QUIT)
+     std::atomic<bool> m_lowLatencyActive;           ///< Whether the input thread receives keyboard input
+     std::atomic<std::shared_ptr<const HotkeyLookup>> m_hotkeyLookup; ///< Global hotkeys, read by the input thread
+     std::bitset<256> m_keysDown;                    ///< Keys held down, input thread only
+     size_t m_hotkeyEventSubscription;               ///< Subscription to HotkeyEvent
  };
  
  } // namespace poe
\ No newline at end of file
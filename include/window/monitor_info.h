@@ -9,6 +9,7 @@
  #pragma once
 
  #include <Windows.h>
+ #include <cstdint>
  #include <vector>
  
  namespace poe {
@@ -55,19 +56,56 @@
       */
      float GetScaleFactor() const;
  
+     /**
+      * @brief Get the monitor handle
+      * 
+      * @return HMONITOR The monitor handle
+      */
+     HMONITOR GetHandle() const;
+ 
  private:
      HMONITOR m_monitor;   ///< Monitor handle
-     RECT m_workArea;      ///< Monitor work area
-     RECT m_fullArea;      ///< Monitor full area
-     bool m_isPrimary;     ///< Whether this is the primary monitor
-     float m_scaleFactor;  ///< DPI scaling factor
+     RECT m_workArea = {};      ///< Monitor work area
+     RECT m_fullArea = {};      ///< Monitor full area
+     bool m_isPrimary = false;  ///< Whether this is the primary monitor
+     float m_scaleFactor = 1.0f; ///< DPI scaling factor
  };
  
  /**
   * @brief Get information about all connected monitors
   * 
+  * Served from a cached topology; the first call enumerates the monitors
+  * and later calls only copy the cache until RefreshMonitorTopology().
+  * 
   * @return std::vector<MonitorInfo> Vector of monitor information
   */
  std::vector<MonitorInfo> GetAllMonitors();
  
+ /**
+  * @brief Re-enumerate the monitors into the cached topology
+  * 
+  * Call on WM_DISPLAYCHANGE and WM_DPICHANGED. Thread-safe.
+  * 
+  * @return uint32_t The new topology revision
+  */
+ uint32_t RefreshMonitorTopology();
+ 
+ /**
+  * @brief Get the revision of the cached topology
+  * 
+  * The revision changes whenever RefreshMonitorTopology() runs, so a cached
+  * MonitorInfo can be checked for staleness without comparing fields.
+  * 
+  * @return uint32_t The topology revision
+  */
+ uint32_t GetMonitorTopologyRevision();
+ 
+ /**
+  * @brief Get the cached information of the monitor showing most of a window
+  * 
+  * @param window The window to locate
+  * @return MonitorInfo Information about the nearest monitor
+  */
+ MonitorInfo GetMonitorForWindow(HWND window);
+ 
  } // namespace poe
\ No newline at end of file
@@ -5,16 +5,21 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <span>
 #include <vector>
+#include <atomic>
 #include "window/monitor_info.h"
+#include "window/hit_test_mask.h"
 #include "core/Application.h"
+#include "core/Logger.h"
 
 namespace poe {
 
 // Forward declarations
 class Application;
-class OverlayRenderer;
+class CompositeRenderer;
 class AnimationManager;
+class GraphicsDevice;
 
 /**
  * @class OverlayWindow
@@ -147,6 +152,24 @@ public:
     using WindowEventCallback = std::function<LRESULT(HWND, UINT, WPARAM, LPARAM)>;
     void SetEventCallback(WindowEventCallback callback);
 
+    /**
+     * @brief Set a callback for when the window lands on a monitor with a different scale
+     * 
+     * Fires only when the monitor under the overlay or its DPI changes, so
+     * consumers (browser views, surfaces) reallocate at most once per move.
+     * 
+     * @param callback Function receiving the new scale factor
+     */
+    using ScaleFactorCallback = std::function<void(float)>;
+    void SetScaleFactorCallback(ScaleFactorCallback callback);
+
+    /**
+     * @brief Get the DPI scale factor of the monitor under the overlay
+     * 
+     * @return float Device pixels per DIP (1.0 at 96 DPI)
+     */
+    float GetScaleFactor() const;
+
     /**
      * @brief Get the native window handle
      * 
@@ -154,6 +177,20 @@ public:
      */
     HWND GetHandle() const;
 
+    /**
+     * @brief Get the renderer that composes the window content and its browser panels
+     * 
+     * @return CompositeRenderer* The renderer, or nullptr before Create() succeeds
+     */
+    CompositeRenderer* GetRenderer() const { return m_renderer.get(); }
+
+    /**
+     * @brief Get the devices every renderer in this window shares
+     * 
+     * @return GraphicsDevice* The devices, or nullptr before Create() is called
+     */
+    GraphicsDevice* GetGraphicsDevice() const { return m_graphicsDevice.get(); }
+
     /**
      * @brief Process window messages
      * 
@@ -182,9 +219,71 @@ public:
 
     /**
      * @brief Update the window state and animations
+     * 
+     * Only steps animations and renders when something changed since the
+     * last frame; an idle overlay does no work here.
      */
     void Update();
 
+    /**
+     * @brief Request that the next Update() renders a frame
+     * 
+     * Safe to call from any thread (e.g. when a browser frame is published);
+     * wakes a thread blocked in WaitForNextFrame().
+     */
+    void RequestFrame();
+
+    /**
+     * @brief Check whether the overlay needs to keep producing frames
+     * 
+     * @return true If an animation is running, a frame is pending, or the mouse is near an edge
+     * @return false If the overlay is idle
+     */
+    bool IsFrameActive() const;
+
+    /**
+     * @brief Block until the next frame should be produced
+     * 
+     * While active, waits for the next DWM composition pass so updates line
+     * up with vblank. While idle, sleeps until a window message arrives,
+     * RequestFrame() is called, one of the wake handles is signalled, or
+     * the timeout elapses.
+     * 
+     * @param idleTimeoutMs Maximum time to sleep while idle, in milliseconds
+     * @param wakeHandles Additional handles that end the wait when signalled (at most MAXIMUM_WAIT_OBJECTS - 1)
+     */
+    void WaitForNextFrame(DWORD idleTimeoutMs = INFINITE, std::span<const HANDLE> wakeHandles = {});
+
+    /**
+     * @brief Update the hit-test mask from browser content the renderer just uploaded
+     * 
+     * Transparent parts of the content pass clicks to the game; the window
+     * region is rebuilt on the next Update() only if the mask changed.
+     * 
+     * @param buffer Premultiplied BGRA pixels of the full content
+     * @param width Width of the buffer in pixels
+     * @param height Height of the buffer in pixels
+     * @param dirtyRects Regions of the buffer that changed
+     */
+    void UpdateHitTestContent(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects);
+
+    /**
+     * @brief Treat the whole content as hit-testable
+     * 
+     * For content presented from a GPU texture, whose pixels cannot be inspected.
+     * 
+     * @param width Content width in pixels
+     * @param height Content height in pixels
+     */
+    void UpdateHitTestContent(int width, int height);
+
+    /**
+     * @brief Set the rectangles (panels) that capture the mouse regardless of their content
+     * 
+     * @param rects Rectangles in client coordinates
+     */
+    void SetHitTestRects(const std::vector<RECT>& rects);
+
     /**
      * @brief Check if the mouse cursor is near the window edge
      * 
@@ -214,7 +313,9 @@ private:
      * @param args Format arguments
      */
     template<typename... Args>
-    void Log(int level, const std::string& fmt, const Args&... args);
+    void Log(int level, fmt::format_string<Args...> fmt, Args&&... args) {
+        LogTo(m_app.TryGetLogger(), level, fmt, std::forward<Args>(args)...);
+    }
 
     /**
      * @brief Apply window styles to enable proper overlay behavior
@@ -230,17 +331,57 @@ private:
      * @brief Update the window's click-through status based on current mode
      */
     void UpdateClickThrough();
+
+    /**
+     * @brief Rebuild the window region from the hit-test mask if it changed
+     * 
+     * The region holds the solid content cells, the panels and the edge
+     * strip used as drag handle; everywhere else, clicks reach the game.
+     */
+    void ApplyHitRegion();
     
     /**
-     * @brief Handles border highlighting based on mouse position
+     * @brief Fades the border in or out when the cursor crosses the edge strip
+     * @param nearEdge Whether the cursor is now within the edge strip
+     */
+    void UpdateBorderHighlight(bool nearEdge);
+
+    /**
+     * @brief Arm a WM_MOUSELEAVE / WM_NCMOUSELEAVE notification if not already armed
+     * @param nonClient Whether to track the non-client (edge strip) area
      */
-    void UpdateBorderHighlight();
+    void TrackMouseLeave(bool nonClient);
 
     /**
      * @brief Sets up animations
      */
     void SetupAnimations();
 
+    /**
+     * @brief Rebinds the animations after the renderer rebuilt on new devices
+     */
+    void SyncAnimationsWithDevice();
+
+    /**
+     * @brief Re-read the monitor under the window from the cached topology
+     * 
+     * Notifies the scale factor callback only if the monitor or its scale changed.
+     */
+    void UpdateMonitor();
+
+    /**
+     * @brief Fades the overlay to an opacity, on the compositor when possible
+     * @param target Opacity to reach
+     * @param hideWhenDone Whether to hide the window once the fade reaches zero
+     */
+    void AnimateOpacity(float target, bool hideWhenDone);
+
+    /**
+     * @brief Fades the border highlight in or out, on the compositor when possible
+     * @param show Whether the border should end up visible
+     */
+    void AnimateBorders(bool show);
+
     /**
      * @brief Internal window procedure to handle window messages
      */
@@ -256,17 +397,36 @@ private:
     RECT m_bounds = {};                   ///< Current window bounds
     WindowEventCallback m_eventCallback;  ///< Custom event callback
     
+    // Monitor tracking
+    HMONITOR m_monitor = nullptr;         ///< Monitor the window is on
+    float m_scaleFactor = 1.0f;           ///< DPI scale factor of m_monitor
+    ScaleFactorCallback m_scaleFactorCallback; ///< Notified when m_scaleFactor changes
+    
     // Mouse tracking
-    bool m_mouseTracking = false;         ///< Whether mouse tracking is active
+    bool m_mouseTracking = false;         ///< Whether client-area leave tracking is armed
+    bool m_ncMouseTracking = false;       ///< Whether non-client leave tracking is armed
     bool m_mouseNearEdge = false;         ///< Whether mouse is near window edge
     POINT m_lastMousePos = {0, 0};        ///< Last known mouse position
+    RECT m_clientRect = {};               ///< Client rect, cached on WM_SIZE
     
     // Advanced rendering
-    std::unique_ptr<OverlayRenderer> m_renderer; ///< Overlay renderer
+    std::unique_ptr<GraphicsDevice> m_graphicsDevice; ///< Devices shared by the renderers; outlives them
+    std::unique_ptr<CompositeRenderer> m_renderer; ///< Content, panels and border in one composition tree
     std::unique_ptr<AnimationManager> m_animationManager; ///< Animation manager
+    uint64_t m_animationDeviceGeneration = 0; ///< Device generation the animations were set up on
+    uint32_t m_opacityAnimation = 0;      ///< Handle of the opacity fade in m_animationManager
+    uint32_t m_borderAnimation = 0;       ///< Handle of the border fade in m_animationManager
+    bool m_hideWhenFaded = false;         ///< Whether the running opacity fade hides the window at zero
     
     // DWM composition related fields
     bool m_compositionEnabled = false;    ///< Whether DWM composition is enabled
+    
+    // Hit testing
+    HitTestMask m_hitTestMask;            ///< Which parts of the content capture the mouse
+    bool m_hitRegionDirty = true;         ///< Whether the window region must be rebuilt
+    
+    // Frame scheduling
+    std::atomic<bool> m_framePending{true}; ///< Whether the next Update() must render
 };
 
 } // namespace poe
\ No newline at end of file
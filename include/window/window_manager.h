@@ -10,6 +10,7 @@
  #pragma once
 
  #include <Windows.h>
+ #include <chrono>
  #include <string>
  #include <memory>
  #include <functional>
@@ -68,6 +69,11 @@
      /**
       * @brief Run the main message loop
       * 
+      * Takes the place of Application::Run() on the UI thread: it dispatches
+      * queued events itself and blocks in one wait on window messages (which
+      * also carry CEF pump work and frame requests) and the event queue, so
+      * every source wakes it immediately and an idle overlay does not spin.
+      * 
       * @return int Exit code
       */
      int Run();
@@ -151,6 +157,22 @@
       */
      void UpdateOverlayPosition();
 
+     /**
+      * @brief Look for the game window once the search interval has passed
+      * 
+      * @return DWORD Milliseconds until the next search is due
+      */
+     DWORD SearchForGameWindow();
+ 
+     /**
+      * @brief WinEvent callback for the attached game window
+      * 
+      * Delivered while messages are pumped on the UI thread, so a move
+      * wakes the frame wait immediately instead of being polled.
+      */
+     static void CALLBACK GameWindowEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd,
+         LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime);
+
      /**
      * @brief Toggle the overlay visibility
      * @param animate Whether to animate the transition
@@ -166,7 +188,11 @@
      WindowManagerConfig m_config;                 ///< Window manager configuration
      OverlayWindow m_overlayWindow;                ///< The overlay window
      HWND m_gameWindowHandle = nullptr;            ///< Handle to the attached game window
+     HWINEVENTHOOK m_gameWindowHook = nullptr;     ///< Location/destroy hook on the game window
+     bool m_gameWindowMoved = false;               ///< Whether the game window moved since the last reposition
      bool m_running = false;                       ///< Whether the main loop is running
+     HANDLE m_eventsQueued = nullptr;              ///< Auto-reset event set when the event system has work
+     std::chrono::steady_clock::time_point m_nextGameSearch; ///< When SearchForGameWindow() looks again
  };
  
  } // namespace poe
\ No newline at end of file
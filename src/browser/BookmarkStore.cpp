@@ -0,0 +1,149 @@
+#include "browser/BookmarkStore.h"
+
+namespace poe {
+
+bool BookmarkStore::Add(const Bookmark& bookmark)
+{
+    auto it = m_urlIndex.find(bookmark.url);
+    if (it != m_urlIndex.end())
+    {
+        Location location = it->second;
+        Bookmark& existing = m_folders[location.folder][location.position];
+
+        // Same folder: update in place and keep its position
+        if (existing.folder == bookmark.folder)
+        {
+            existing.name = bookmark.name;
+            existing.icon = bookmark.icon;
+            return false;
+        }
+
+        RemoveAt(location);
+        Add(bookmark);
+        return false;
+    }
+
+    size_t folder = GetOrCreateFolder(bookmark.folder);
+    m_folders[folder].push_back(bookmark);
+    m_urlIndex.emplace(bookmark.url, Location{ folder, m_folders[folder].size() - 1 });
+    return true;
+}
+
+size_t BookmarkStore::AddRange(std::span<const Bookmark> bookmarks)
+{
+    m_urlIndex.reserve(m_urlIndex.size() + bookmarks.size());
+
+    size_t added = 0;
+    for (const auto& bookmark : bookmarks)
+    {
+        if (Add(bookmark))
+        {
+            ++added;
+        }
+    }
+
+    return added;
+}
+
+bool BookmarkStore::Remove(const std::string& url)
+{
+    auto it = m_urlIndex.find(url);
+    if (it == m_urlIndex.end())
+    {
+        return false;
+    }
+
+    RemoveAt(it->second);
+    return true;
+}
+
+void BookmarkStore::Clear()
+{
+    m_folders.clear();
+    m_folderNames.clear();
+    m_folderIndex.clear();
+    m_urlIndex.clear();
+}
+
+const Bookmark* BookmarkStore::Find(const std::string& url) const
+{
+    auto it = m_urlIndex.find(url);
+    if (it == m_urlIndex.end())
+    {
+        return nullptr;
+    }
+
+    return &m_folders[it->second.folder][it->second.position];
+}
+
+std::span<const Bookmark> BookmarkStore::GetFolder(const std::string& folder) const
+{
+    auto it = m_folderIndex.find(folder);
+    if (it == m_folderIndex.end())
+    {
+        return {};
+    }
+
+    return m_folders[it->second];
+}
+
+std::vector<Bookmark> BookmarkStore::ToVector() const
+{
+    std::vector<Bookmark> result;
+    result.reserve(m_urlIndex.size());
+
+    for (const auto& folder : m_folders)
+    {
+        result.insert(result.end(), folder.begin(), folder.end());
+    }
+
+    return result;
+}
+
+size_t BookmarkStore::GetOrCreateFolder(const std::string& folder)
+{
+    auto it = m_folderIndex.find(folder);
+    if (it != m_folderIndex.end())
+    {
+        return it->second;
+    }
+
+    m_folders.emplace_back();
+    m_folderNames.push_back(folder);
+    m_folderIndex.emplace(folder, m_folders.size() - 1);
+    return m_folders.size() - 1;
+}
+
+void BookmarkStore::RemoveAt(Location location)
+{
+    auto& bookmarks = m_folders[location.folder];
+    m_urlIndex.erase(bookmarks[location.position].url);
+    bookmarks.erase(bookmarks.begin() + static_cast<std::ptrdiff_t>(location.position));
+
+    // Keep folder order: later bookmarks move up by one
+    for (size_t i = location.position; i < bookmarks.size(); ++i)
+    {
+        m_urlIndex[bookmarks[i].url].position = i;
+    }
+
+    if (!bookmarks.empty())
+    {
+        return;
+    }
+
+    // Drop the empty folder; folders after it move up by one
+    m_folderIndex.erase(m_folderNames[location.folder]);
+    m_folders.erase(m_folders.begin() + static_cast<std::ptrdiff_t>(location.folder));
+    m_folderNames.erase(m_folderNames.begin() + static_cast<std::ptrdiff_t>(location.folder));
+
+    for (size_t folder = location.folder; folder < m_folders.size(); ++folder)
+    {
+        m_folderIndex[m_folderNames[folder]] = folder;
+        for (const auto& bookmark : m_folders[folder])
+        {
+            m_urlIndex[bookmark.url].folder = folder;
+        }
+    }
+}
+
+} // namespace poe
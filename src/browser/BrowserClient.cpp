@@ -2,6 +2,7 @@
 #include "browser/BrowserHandler.h"
 #include "browser/RenderHandler.h"
 #include "browser/CefManager.h"
+#include "browser/MessageBridge.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
 
@@ -47,12 +48,24 @@ CefRefPtr<CefRenderHandler> BrowserClient::GetRenderHandler()
     return m_renderHandler;
 }
 
+CefRefPtr<CefRequestHandler> BrowserClient::GetRequestHandler()
+{
+    return m_browserHandler;
+}
+
 bool BrowserClient::OnProcessMessageReceived(
     CefRefPtr<CefBrowser> browser,
     CefRefPtr<CefFrame> frame,
     CefProcessId source_process,
     CefRefPtr<CefProcessMessage> message)
 {
+    // Bridge queries are the bulk of renderer traffic, so they go first
+    MessageBridge* bridge = m_cefManager.GetMessageBridge();
+    if (bridge && bridge->OnProcessMessageReceived(browser, frame, source_process, message))
+    {
+        return true;
+    }
+    
     // Handle messages from the renderer process
     std::string messageName = message->GetName().ToString();
     Log(1, "Received process message: {} from process: {}", 
@@ -67,32 +80,18 @@ bool BrowserClient::OnProcessMessageReceived(
         return true;
     }
     
-    return false;
-}
-
-template<typename... Args>
-void BrowserClient::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try
+    // Scroll offset captured before a view is discarded
+    if (messageName == "poe.scrollPosition")
     {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
+        if (m_browserHandler)
         {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
+            CefRefPtr<CefListValue> args = message->GetArgumentList();
+            m_browserHandler->OnScrollPosition(browser, args->GetInt(0), args->GetInt(1));
         }
+        return true;
     }
-    catch (const std::exception& e)
-    {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "BrowserClient log error: " << e.what() << std::endl;
-    }
+    
+    return false;
 }
 
 } // namespace poe
\ No newline at end of file
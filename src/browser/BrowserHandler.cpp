@@ -1,5 +1,7 @@
 #include "browser/BrowserHandler.h"
 #include "browser/CefManager.h"
+#include "browser/BrowserView.h"
+#include "browser/MessageBridge.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
 
@@ -14,6 +16,26 @@ BrowserHandler::BrowserHandler(Application& app, CefManager& cefManager)
     Log(2, "BrowserHandler created");
 }
 
+void BrowserHandler::RegisterView(int browserId, BrowserView* view)
+{
+    std::lock_guard<std::mutex> lock(m_viewsMutex);
+    m_views[browserId] = view;
+}
+
+void BrowserHandler::UnregisterView(int browserId)
+{
+    std::lock_guard<std::mutex> lock(m_viewsMutex);
+    m_views.erase(browserId);
+}
+
+BrowserView* BrowserHandler::FindView(int browserId)
+{
+    std::lock_guard<std::mutex> lock(m_viewsMutex);
+    
+    auto it = m_views.find(browserId);
+    return it != m_views.end() ? it->second : nullptr;
+}
+
 bool BrowserHandler::OnBeforePopup(
     CefRefPtr<CefBrowser> browser,
     CefRefPtr<CefFrame> frame,
@@ -47,12 +69,6 @@ void BrowserHandler::OnAfterCreated(CefRefPtr<CefBrowser> browser)
         int browserId = browser->GetIdentifier();
         m_browserData[browserId] = BrowserData();
     }
-    
-    // Notify callback if set
-    if (m_browserCreatedCallback)
-    {
-        m_browserCreatedCallback(browser);
-    }
 }
 
 bool BrowserHandler::DoClose(CefRefPtr<CefBrowser> browser)
@@ -68,16 +84,25 @@ void BrowserHandler::OnBeforeClose(CefRefPtr<CefBrowser> browser)
     int browserId = browser->GetIdentifier();
     Log(2, "Browser closed: ID={}", browserId);
     
+    // Drop the browser's pending bridge queries
+    if (MessageBridge* bridge = m_cefManager.GetMessageBridge())
+    {
+        bridge->OnBeforeClose(browser);
+    }
+    
     // Remove browser data
     {
         std::lock_guard<std::mutex> lock(m_browserDataMutex);
         m_browserData.erase(browserId);
     }
     
-    // Notify callback if set
-    if (m_browserCloseCallback)
+    // The view must not outlive its registration; drop it before telling it
+    BrowserView* view = FindView(browserId);
+    UnregisterView(browserId);
+    
+    if (view)
     {
-        m_browserCloseCallback(browser);
+        view->OnBrowserClose();
     }
 }
 
@@ -103,10 +128,9 @@ void BrowserHandler::OnLoadingStateChange(
         }
     }
     
-    // Notify callback if set
-    if (m_loadStateCallback)
+    if (BrowserView* view = FindView(browserId))
     {
-        m_loadStateCallback(browser, isLoading, canGoBack, canGoForward);
+        view->OnLoadingStateChange(isLoading, canGoBack, canGoForward);
     }
 }
 
@@ -156,10 +180,9 @@ void BrowserHandler::OnTitleChange(
         }
     }
     
-    // Notify callback if set
-    if (m_titleChangeCallback)
+    if (BrowserView* view = FindView(browserId))
     {
-        m_titleChangeCallback(browser, titleStr);
+        view->OnTitleChange(titleStr);
     }
 }
 
@@ -185,10 +208,9 @@ void BrowserHandler::OnAddressChange(
             }
         }
         
-        // Notify callback if set
-        if (m_addressChangeCallback)
+        if (BrowserView* view = FindView(browserId))
         {
-            m_addressChangeCallback(browser, urlStr);
+            view->OnAddressChange(urlStr);
         }
     }
 }
@@ -210,6 +232,19 @@ void BrowserHandler::OnStatusMessage(
     }
 }
 
+void BrowserHandler::OnScrollPosition(
+    CefRefPtr<CefBrowser> browser,
+    int x,
+    int y)
+{
+    Log(1, "Browser scroll position: ID={}, x={}, y={}", browser->GetIdentifier(), x, y);
+    
+    if (BrowserView* view = FindView(browser->GetIdentifier()))
+    {
+        view->OnScrollPosition(x, y);
+    }
+}
+
 bool BrowserHandler::OnConsoleMessage(
     CefRefPtr<CefBrowser> browser,
     cef_log_severity_t level,
@@ -325,28 +360,49 @@ bool BrowserHandler::OnContextMenuCommand(
     return false;
 }
 
-template<typename... Args>
-void BrowserHandler::Log(int level, const std::string& fmt, const Args&... args)
+bool BrowserHandler::OnBeforeBrowse(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefRefPtr<CefRequest> request,
+    bool user_gesture,
+    bool is_redirect)
 {
-    try
+    // Queries of the document being replaced can no longer be answered
+    if (MessageBridge* bridge = m_cefManager.GetMessageBridge())
     {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
+        bridge->OnBeforeBrowse(browser, frame);
+    }
+    
+    // Return false to allow the navigation
+    return false;
+}
+
+CefRefPtr<CefResourceRequestHandler> BrowserHandler::GetResourceRequestHandler(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefRefPtr<CefRequest> request,
+    bool is_navigation,
+    bool is_download,
+    const CefString& request_initiator,
+    bool& disable_default_handling)
+{
+    if (!m_resourceRequestHandler)
+    {
+        return nullptr;
     }
-    catch (const std::exception& e)
+    
+    return m_resourceRequestHandler->GetResourceRequestHandler(browser, frame, request,
+        is_navigation, is_download, request_initiator, disable_default_handling);
+}
+
+void BrowserHandler::OnRenderProcessTerminated(CefRefPtr<CefBrowser> browser, TerminationStatus status)
+{
+    Log(3, "Render process terminated: ID={}, status={}", browser->GetIdentifier(), static_cast<int>(status));
+    
+    // None of the browser's queries or subscriptions can be answered any more
+    if (MessageBridge* bridge = m_cefManager.GetMessageBridge())
     {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "BrowserHandler log error: " << e.what() << std::endl;
+        bridge->OnRenderProcessTerminated(browser);
     }
 }
 
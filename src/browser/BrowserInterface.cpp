@@ -1,23 +1,50 @@
 #include "browser/BrowserInterface.h"
 #include "browser/CefManager.h"
 #include "browser/BrowserView.h"
+#include "browser/MessageBridge.h"
+#include "browser/PriceChecker.h"
+#include "process/priority_manager.h"
+#include "rendering/composite_renderer.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
 #include "core/Settings.h"
+#include "core/BinaryCache.h"
+#include "core/WorkerPool.h"
 
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <psapi.h>
+#include <TlHelp32.h>
 #include <nlohmann/json.hpp>
 
 namespace poe {
 
+namespace {
+
+// Binary cache of bookmarks.json: one record per bookmark (name, url, folder, icon)
+constexpr uint32_t kBookmarksCacheSchema = 2;
+constexpr uint32_t kBookmarksCacheFields = 4;
+
+// Bookmark changes are written this long after the first unsaved one
+constexpr auto kBookmarkSaveDelay = std::chrono::seconds(2);
+
+} // namespace
+
 BrowserInterface::BrowserInterface(Application& app)
     : m_app(app)
     , m_homePage("poe://home")
     , m_newTabPage("poe://home")
     , m_searchEngine("https://www.google.com/search?q={}")
+    , m_warmPoolSize(0)
+    , m_compositor(nullptr)
+    , m_memoryBudget(0)
+    , m_discardAfter(0)
+    , m_lowMemoryNotification(nullptr)
+    , m_lowMemory(false)
+    , m_bookmarksDirty(false)
 {
     Log(2, "BrowserInterface created");
 }
@@ -29,10 +56,15 @@ BrowserInterface::~BrowserInterface()
 
 bool BrowserInterface::Initialize()
 {
+    // Bookmarks only touch the disk and m_bookmarks; read them while CEF starts
+    std::future<void> bookmarksLoaded;
+    
     try
     {
         Log(2, "Initializing BrowserInterface");
         
+        bookmarksLoaded = m_app.GetWorkerPool().Submit([this]() { LoadBookmarks(); });
+        
         // Initialize CEF
         CefManager::CefConfig cefConfig;
         
@@ -51,35 +83,97 @@ bool BrowserInterface::Initialize()
         // Enable offscreen rendering
         cefConfig.enableOffscreenRendering = true;
         
+        // Opt-in GPU shared-texture rendering
+        cefConfig.enableSharedTextures = m_app.GetSettings().Get<bool>("browser.gpuAcceleration", false);
+        
         // Disable persistent session cookies
         cefConfig.persistSessionCookies = m_app.GetSettings().Get<bool>("browser.persistCookies", true);
         
         // Background process priority
         cefConfig.backgroundProcessPriority = m_app.GetSettings().Get<int>("browser.backgroundPriority", 0);
         
+        // Renderer process model; the low-footprint profile fills whatever is left at 0
+        cefConfig.lowFootprint = m_app.GetSettings().Get<bool>("browser.lowFootprint", false);
+        cefConfig.rendererProcessLimit = m_app.GetSettings().Get<int>("browser.rendererProcessLimit", 0);
+        cefConfig.v8HeapLimitMB = m_app.GetSettings().Get<int>("browser.v8HeapLimitMB", 0);
+        cefConfig.processPerSite = m_app.GetSettings().Get<bool>("browser.processPerSite", false);
+        
+        // Cache for trade and poe.ninja API responses
+        cefConfig.enableHttpCache = m_app.GetSettings().Get<bool>("cache.enabled", true);
+        cefConfig.httpCachePath = (appDataPath / "http_cache").string();
+        cefConfig.httpCacheMemoryMB = m_app.GetSettings().Get<int>("cache.memoryMB", 16);
+        cefConfig.httpCacheDiskMB = m_app.GetSettings().Get<int>("cache.diskMB", 256);
+        
+        // Let CEF schedule its own work on the overlay's message loop
+        cefConfig.externalMessagePump = m_app.GetSettings().Get<bool>("browser.externalMessagePump", true);
+        
         // Create CEF manager
         m_cefManager = std::make_unique<CefManager>(m_app, cefConfig);
         
+        // Launches are reported on CEF's UI and IO threads, possibly before priorities are managed
+        m_cefManager->SetChildProcessLaunchCallback([this]() {
+            std::lock_guard<std::mutex> lock(m_priorityMutex);
+            if (m_priorityManager)
+            {
+                m_priorityManager->NotifyChildProcessLaunch();
+            }
+        });
+        
         // Initialize CEF
+        auto cefStart = std::chrono::steady_clock::now();
         if (!m_cefManager->Initialize())
         {
             Log(4, "Failed to initialize CEF");
+            bookmarksLoaded.wait();
             return false;
         }
+        Log(2, "CEF initialized in {:.1f} ms", std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - cefStart).count());
         
         // Load home page and search settings from settings
         m_homePage = m_app.GetSettings().Get<std::string>("browser.homePage", "poe://home");
         m_newTabPage = m_app.GetSettings().Get<std::string>("browser.newTabPage", "poe://home");
         m_searchEngine = m_app.GetSettings().Get<std::string>("browser.searchEngine", "https://www.google.com/search?q={}");
         
-        // Load bookmarks
-        LoadBookmarks();
+        // Hidden browsers kept ready for new panels; filled from Update()
+        m_warmPoolSize = static_cast<size_t>(std::clamp(
+            m_app.GetSettings().Get<int>("browser.warmPoolSize", 1), 0, 4));
+        
+        // Discard long-hidden views, and least recently used ones when renderers outgrow the budget
+        m_memoryBudget = static_cast<uint64_t>(std::max(
+            m_app.GetSettings().Get<int>("browser.memoryBudgetMB", 1024), 0)) * 1024 * 1024;
+        m_discardAfter = std::chrono::seconds(std::max(
+            m_app.GetSettings().Get<int>("browser.discardAfterSeconds", 900), 0));
+        m_lowMemoryNotification = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+        m_lastMemoryCheck = std::chrono::steady_clock::now();
+        
+        // Bookmarks have usually finished loading by now
+        bookmarksLoaded.get();
+        
+        // Index bookmarks for omnibox suggestions; history joins as pages are visited
+        m_omnibox.SetHistoryLimit(static_cast<size_t>((std::max)(
+            m_app.GetSettings().Get<int>("browser.historySize", 2000), 0)));
+        for (const auto& folder : m_bookmarks.GetFolderNames())
+        {
+            for (const auto& bookmark : m_bookmarks.GetFolder(folder))
+            {
+                m_omnibox.AddBookmark(bookmark);
+            }
+        }
+        
+        RegisterBridgeMethods();
         
         Log(2, "BrowserInterface initialized successfully");
         return true;
     }
     catch (const std::exception& ex)
     {
+        // The loader still holds this; let it finish before anything is torn down
+        if (bookmarksLoaded.valid())
+        {
+            bookmarksLoaded.wait();
+        }
+        
         m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "BrowserInterface");
         return false;
     }
@@ -88,11 +182,42 @@ bool BrowserInterface::Initialize()
 void BrowserInterface::Shutdown()
 {
     // Save bookmarks
-    SaveBookmarks();
+    if (m_bookmarksDirty)
+    {
+        SaveBookmarks();
+    }
+    
+    // Its hotkey and pending checks need CEF still running
+    if (m_priceChecker)
+    {
+        m_priceChecker->Shutdown();
+        m_priceChecker.reset();
+    }
     
-    // Close all browser views
+    // Give the CEF children their priority back while they still run
+    if (m_priorityManager)
+    {
+        m_priorityManager->Shutdown();
+        
+        std::lock_guard<std::mutex> lock(m_priorityMutex);
+        m_priorityManager.reset();
+    }
+    
+    // Close all browser views, taking their panels out of the window first
+    for (auto& pair : m_viewPanels)
+    {
+        DestroyPanel(pair.second);
+    }
+    m_viewPanels.clear();
+    m_warmViews.clear();
     m_browserViews.clear();
     
+    if (m_lowMemoryNotification)
+    {
+        CloseHandle(m_lowMemoryNotification);
+        m_lowMemoryNotification = nullptr;
+    }
+    
     // Shutdown CEF
     if (m_cefManager)
     {
@@ -118,6 +243,19 @@ std::shared_ptr<BrowserView> BrowserInterface::CreateBrowserView(
     {
         Log(2, "Creating browser view: {}x{}, URL: {}", width, height, url);
         
+        // Prefer a pre-warmed browser; its renderer process is already running
+        while (!m_warmViews.empty())
+        {
+            auto browserView = std::move(m_warmViews.back());
+            m_warmViews.pop_back();
+            
+            if (browserView->Acquire(width, height, url))
+            {
+                m_browserViews.push_back(browserView);
+                return browserView;
+            }
+        }
+        
         // Create browser view
         auto browserView = std::make_shared<BrowserView>(
             m_app,
@@ -126,6 +264,7 @@ std::shared_ptr<BrowserView> BrowserInterface::CreateBrowserView(
             height,
             url
         );
+        TrackHistory(*browserView);
         
         // Initialize browser view
         if (!browserView->Initialize())
@@ -146,6 +285,64 @@ std::shared_ptr<BrowserView> BrowserInterface::CreateBrowserView(
     }
 }
 
+void BrowserInterface::ReleaseBrowserView(const std::shared_ptr<BrowserView>& view)
+{
+    auto it = std::find(m_browserViews.begin(), m_browserViews.end(), view);
+    if (it == m_browserViews.end())
+    {
+        return;
+    }
+
+    std::shared_ptr<BrowserView> released = std::move(*it);
+    m_browserViews.erase(it);
+    
+    auto panelIt = m_viewPanels.find(released.get());
+    if (panelIt != m_viewPanels.end())
+    {
+        DestroyPanel(panelIt->second);
+        m_viewPanels.erase(panelIt);
+    }
+    
+    // Keep the browser warm while the pool has room
+    if (m_warmViews.size() < m_warmPoolSize && released->IsInitialized())
+    {
+        released->Reset();
+        m_warmViews.push_back(std::move(released));
+        Log(1, "Browser view returned to warm pool ({}/{})", m_warmViews.size(), m_warmPoolSize);
+    }
+}
+
+void BrowserInterface::RefillWarmPool(size_t maxCreate)
+{
+    // Drop warm views whose browser was closed underneath them
+    m_warmViews.erase(
+        std::remove_if(m_warmViews.begin(), m_warmViews.end(),
+            [](const std::shared_ptr<BrowserView>& view) {
+                return !view->IsInitialized();
+            }),
+        m_warmViews.end()
+    );
+    
+    while (maxCreate > 0 && m_warmViews.size() < m_warmPoolSize)
+    {
+        --maxCreate;
+        
+        auto browserView = std::make_shared<BrowserView>(m_app, *m_cefManager);
+        TrackHistory(*browserView);
+        
+        // Unregistered until handed out, so its blank page reaches no owner
+        if (!browserView->Initialize(false))
+        {
+            Log(3, "Failed to pre-warm browser view");
+            return;
+        }
+        
+        browserView->SetVisible(false);
+        m_warmViews.push_back(std::move(browserView));
+        Log(1, "Pre-warmed browser view ({}/{})", m_warmViews.size(), m_warmPoolSize);
+    }
+}
+
 void BrowserInterface::Update()
 {
     if (!m_cefManager)
@@ -156,6 +353,33 @@ void BrowserInterface::Update()
     // Process CEF message loop
     m_cefManager->ProcessEvents();
     
+    // Publish finished price checks and refresh prices when due
+    if (m_priceChecker)
+    {
+        m_priceChecker->Update();
+    }
+    
+    // Pick up CEF children launched since the last update
+    if (m_priorityManager)
+    {
+        m_priorityManager->Update();
+    }
+    
+    // Release memory held by views nobody is looking at
+    CheckMemoryPressure();
+    
+    // Top up the warm pool one browser at a time so no single update stalls
+    if (!m_lowMemory)
+    {
+        RefillWarmPool(1);
+    }
+    
+    // Write bookmark changes once they have had time to batch up
+    if (m_bookmarksDirty && std::chrono::steady_clock::now() - m_bookmarksChangedAt >= kBookmarkSaveDelay)
+    {
+        SaveBookmarks();
+    }
+    
     // Remove closed browser views
     m_browserViews.erase(
         std::remove_if(m_browserViews.begin(), m_browserViews.end(),
@@ -164,98 +388,379 @@ void BrowserInterface::Update()
             }),
         m_browserViews.end()
     );
+    
+    // Follow visibility and discards of this update with the panels
+    SyncPanels();
 }
 
-bool BrowserInterface::AddBookmark(const Bookmark& bookmark)
+bool BrowserInterface::EnablePriceCheck(InputHandler& inputHandler)
 {
-    // Check if URL already exists
-    auto it = std::find_if(m_bookmarks.begin(), m_bookmarks.end(),
-        [&bookmark](const Bookmark& b) {
-            return b.url == bookmark.url;
-        });
+    if (m_priceChecker)
+    {
+        return true;
+    }
+
+    if (!m_cefManager)
+    {
+        Log(4, "Cannot enable price check: CEF not initialized");
+        return false;
+    }
+
+    PriceCheckConfig config;
+    config.league = m_app.GetSettings().Get<std::string>("priceCheck.league", config.league);
+    config.refreshInterval = std::chrono::minutes(std::max(
+        m_app.GetSettings().Get<int>("priceCheck.refreshMinutes", static_cast<int>(config.refreshInterval.count())), 1));
     
-    if (it != m_bookmarks.end())
+    auto priceChecker = std::make_unique<PriceChecker>(m_app, inputHandler, *m_cefManager, config);
+    if (!priceChecker->Initialize())
     {
-        // Update existing bookmark
-        it->name = bookmark.name;
-        it->folder = bookmark.folder;
-        it->icon = bookmark.icon;
+        Log(4, "Failed to initialize price checker");
+        return false;
     }
-    else
+    
+    m_priceChecker = std::move(priceChecker);
+    return true;
+}
+
+bool BrowserInterface::EnablePriorityManagement(FocusTracker& focusTracker)
+{
+    if (m_priorityManager)
     {
-        // Add new bookmark
-        m_bookmarks.push_back(bookmark);
+        return true;
     }
+
+    if (!m_cefManager)
+    {
+        Log(4, "Cannot enable priority management: CEF not initialized");
+        return false;
+    }
+
+    PriorityConfig config;
+    config.enabled = m_app.GetSettings().Get<bool>("priority.enabled", config.enabled);
+    config.efficiencyCoresOnly = m_app.GetSettings().Get<bool>("priority.efficiencyCoresOnly", config.efficiencyCoresOnly);
+    config.powerThrottling = m_app.GetSettings().Get<bool>("priority.powerThrottling", config.powerThrottling);
     
-    // Save bookmarks
-    SaveBookmarks();
+    // Initialize() adopts the children CEF has launched so far
+    auto priorityManager = std::make_unique<PriorityManager>(m_app, focusTracker, config);
+    if (!priorityManager->Initialize())
+    {
+        Log(4, "Failed to initialize priority manager");
+        return false;
+    }
     
+    std::lock_guard<std::mutex> lock(m_priorityMutex);
+    m_priorityManager = std::move(priorityManager);
     return true;
 }
 
-bool BrowserInterface::RemoveBookmark(const std::string& url)
+void BrowserInterface::SetCompositor(CompositeRenderer* compositor)
 {
-    auto it = std::find_if(m_bookmarks.begin(), m_bookmarks.end(),
-        [&url](const Bookmark& b) {
-            return b.url == url;
-        });
+    if (compositor == m_compositor)
+    {
+        return;
+    }
+
+    // Panels belong to the compositor that created them
+    for (auto& pair : m_viewPanels)
+    {
+        DestroyPanel(pair.second);
+    }
+    if (m_compositor)
+    {
+        m_compositor->SetDeviceRecreatedCallback(nullptr);
+    }
     
-    if (it == m_bookmarks.end())
+    m_compositor = compositor;
+    if (m_compositor)
+    {
+        // Rebuilt panel surfaces start out empty
+        m_compositor->SetDeviceRecreatedCallback([this]() {
+            for (const auto& view : m_browserViews)
+            {
+                view->Invalidate();
+            }
+        });
+    }
+    SyncPanels();
+}
+
+bool BrowserInterface::SetViewBounds(const std::shared_ptr<BrowserView>& view, const RECT& bounds)
+{
+    if (std::find(m_browserViews.begin(), m_browserViews.end(), view) == m_browserViews.end())
     {
         return false;
     }
+
+    ViewPanel& viewPanel = m_viewPanels[view.get()];
+    viewPanel.bounds = bounds;
     
-    // Remove bookmark
-    m_bookmarks.erase(it);
+    // The view paints at the panel's size, so the surface is never stretched
+    view->Resize(bounds.right - bounds.left, bounds.bottom - bounds.top);
     
-    // Save bookmarks
-    SaveBookmarks();
+    if (m_compositor && viewPanel.panel != CompositeRenderer::kInvalidPanel)
+    {
+        m_compositor->SetPanelBounds(viewPanel.panel, bounds);
+    }
     
     return true;
 }
 
-std::vector<Bookmark> BrowserInterface::GetBookmarks() const
+bool BrowserInterface::SetViewZOrder(const std::shared_ptr<BrowserView>& view, int zOrder)
+{
+    if (std::find(m_browserViews.begin(), m_browserViews.end(), view) == m_browserViews.end())
+    {
+        return false;
+    }
+
+    ViewPanel& viewPanel = m_viewPanels[view.get()];
+    viewPanel.zOrder = zOrder;
+    
+    if (m_compositor && viewPanel.panel != CompositeRenderer::kInvalidPanel)
+    {
+        m_compositor->SetPanelZOrder(viewPanel.panel, zOrder);
+    }
+    
+    return true;
+}
+
+void BrowserInterface::SyncPanels()
+{
+    if (!m_compositor)
+    {
+        return;
+    }
+
+    for (const auto& view : m_browserViews)
+    {
+        // Views nobody placed yet start at the window origin at their own size
+        auto [it, added] = m_viewPanels.try_emplace(view.get());
+        ViewPanel& viewPanel = it->second;
+        if (added || viewPanel.bounds.right <= viewPanel.bounds.left)
+        {
+            viewPanel.bounds = { 0, 0, view->GetWidth(), view->GetHeight() };
+        }
+        
+        // Hidden and discarded views paint nothing; their surface is freed
+        bool shown = view->IsVisible() && view->IsInitialized();
+        if (!shown)
+        {
+            DestroyPanel(viewPanel);
+            continue;
+        }
+        
+        // Owners may resize the view directly; the panel follows, keeping its origin
+        RECT& bounds = viewPanel.bounds;
+        if (bounds.right - bounds.left != view->GetWidth() || bounds.bottom - bounds.top != view->GetHeight())
+        {
+            bounds.right = bounds.left + view->GetWidth();
+            bounds.bottom = bounds.top + view->GetHeight();
+            if (viewPanel.panel != CompositeRenderer::kInvalidPanel)
+            {
+                m_compositor->SetPanelBounds(viewPanel.panel, bounds);
+            }
+        }
+        
+        if (viewPanel.panel == CompositeRenderer::kInvalidPanel)
+        {
+            // The mailbox only hands out frames newer than the last one taken,
+            // so the new surface needs a full paint of its own
+            viewPanel.panel = m_compositor->CreatePanel(&view->GetFrameMailbox(), bounds, viewPanel.zOrder);
+            if (viewPanel.panel != CompositeRenderer::kInvalidPanel)
+            {
+                view->Invalidate();
+            }
+        }
+    }
+}
+
+void BrowserInterface::DestroyPanel(ViewPanel& viewPanel)
 {
-    return m_bookmarks;
+    if (m_compositor && viewPanel.panel != CompositeRenderer::kInvalidPanel)
+    {
+        m_compositor->DestroyPanel(viewPanel.panel);
+    }
+    
+    viewPanel.panel = CompositeRenderer::kInvalidPanel;
 }
 
-std::vector<Bookmark> BrowserInterface::GetBookmarksInFolder(const std::string& folder) const
+void BrowserInterface::TrimMemory(bool aggressive)
 {
-    std::vector<Bookmark> result;
+    if (aggressive)
+    {
+        // Warm browsers are cheap to recreate later; drop them first
+        m_warmViews.clear();
+    }
     
-    for (const auto& bookmark : m_bookmarks)
+    // Hidden, live views, least recently used first
+    std::vector<BrowserView*> candidates;
+    for (const auto& view : m_browserViews)
     {
-        if (bookmark.folder == folder)
+        if (!view->IsVisible() && view->IsInitialized() && !view->IsDiscardPending())
         {
-            result.push_back(bookmark);
+            candidates.push_back(view.get());
         }
     }
     
-    return result;
+    std::sort(candidates.begin(), candidates.end(),
+        [](const BrowserView* a, const BrowserView* b) {
+            return a->GetLastActiveTime() < b->GetLastActiveTime();
+        });
+    
+    if (aggressive)
+    {
+        for (BrowserView* view : candidates)
+        {
+            view->RequestDiscard();
+        }
+        return;
+    }
+    
+    // Renderer memory is only released once the browser has closed, so
+    // discard one view per check and measure again on the next one
+    if (!candidates.empty() && m_memoryBudget > 0 && GetRendererMemoryUsage() > m_memoryBudget)
+    {
+        candidates.front()->RequestDiscard();
+    }
 }
 
-std::vector<std::string> BrowserInterface::GetBookmarkFolders() const
+void BrowserInterface::CheckMemoryPressure()
 {
-    std::vector<std::string> folders;
+    auto now = std::chrono::steady_clock::now();
     
-    for (const auto& bookmark : m_bookmarks)
+    // Finish discards whose scroll offset never arrived, e.g. a hung renderer
+    for (const auto& view : m_browserViews)
     {
-        // Check if folder already exists in the list
-        if (std::find(folders.begin(), folders.end(), bookmark.folder) == folders.end())
+        if (view->IsDiscardPending() && now - view->GetDiscardRequestTime() > std::chrono::milliseconds(500))
         {
-            folders.push_back(bookmark.folder);
+            view->Discard();
         }
     }
     
-    return folders;
+    if (now - m_lastMemoryCheck < std::chrono::seconds(2))
+    {
+        return;
+    }
+    m_lastMemoryCheck = now;
+    
+    // Views hidden for longer than the idle limit go regardless of the budget
+    if (m_discardAfter.count() > 0)
+    {
+        for (const auto& view : m_browserViews)
+        {
+            if (!view->IsVisible() && view->IsInitialized() && now - view->GetLastActiveTime() > m_discardAfter)
+            {
+                view->RequestDiscard();
+            }
+        }
+    }
+    
+    BOOL lowMemory = FALSE;
+    if (m_lowMemoryNotification)
+    {
+        QueryMemoryResourceNotification(m_lowMemoryNotification, &lowMemory);
+    }
+    
+    if (lowMemory && !m_lowMemory)
+    {
+        Log(3, "System memory is low, discarding hidden browser views");
+    }
+    m_lowMemory = lowMemory != FALSE;
+    
+    TrimMemory(m_lowMemory);
+}
+
+uint64_t BrowserInterface::GetRendererMemoryUsage()
+{
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE)
+    {
+        return 0;
+    }
+
+    // CEF launches its renderer, GPU and utility processes as our children
+    DWORD selfId = GetCurrentProcessId();
+    uint64_t total = 0;
+    
+    PROCESSENTRY32W entry = {};
+    entry.dwSize = sizeof(entry);
+    for (BOOL more = Process32FirstW(snapshot, &entry); more; more = Process32NextW(snapshot, &entry))
+    {
+        if (entry.th32ParentProcessID != selfId)
+        {
+            continue;
+        }
+        
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, entry.th32ProcessID);
+        if (!process)
+        {
+            continue;
+        }
+        
+        PROCESS_MEMORY_COUNTERS_EX counters = {};
+        if (GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+        {
+            total += counters.PrivateUsage;
+        }
+        CloseHandle(process);
+    }
+    
+    CloseHandle(snapshot);
+    return total;
+}
+
+bool BrowserInterface::AddBookmark(const Bookmark& bookmark)
+{
+    m_bookmarks.Add(bookmark);
+    m_omnibox.AddBookmark(bookmark);
+    MarkBookmarksDirty();
+    
+    return true;
+}
+
+size_t BrowserInterface::ImportBookmarks(std::span<const Bookmark> bookmarks)
+{
+    size_t added = m_bookmarks.AddRange(bookmarks);
+    for (const auto& bookmark : bookmarks)
+    {
+        m_omnibox.AddBookmark(bookmark);
+    }
+    MarkBookmarksDirty();
+    
+    Log(2, "Imported {} bookmarks ({} new)", bookmarks.size(), added);
+    return added;
+}
+
+bool BrowserInterface::RemoveBookmark(const std::string& url)
+{
+    if (!m_bookmarks.Remove(url))
+    {
+        return false;
+    }
+    
+    m_omnibox.RemoveBookmark(url);
+    MarkBookmarksDirty();
+    
+    return true;
+}
+
+std::vector<Bookmark> BrowserInterface::GetBookmarks() const
+{
+    return m_bookmarks.ToVector();
+}
+
+std::span<const Bookmark> BrowserInterface::GetBookmarksInFolder(const std::string& folder) const
+{
+    return m_bookmarks.GetFolder(folder);
+}
+
+std::span<const std::string> BrowserInterface::GetBookmarkFolders() const
+{
+    return m_bookmarks.GetFolderNames();
 }
 
 bool BrowserInterface::IsBookmarked(const std::string& url) const
 {
-    return std::find_if(m_bookmarks.begin(), m_bookmarks.end(),
-        [&url](const Bookmark& b) {
-            return b.url == url;
-        }) != m_bookmarks.end();
+    return m_bookmarks.Contains(url);
 }
 
 std::string BrowserInterface::GetHomePage() const
@@ -318,6 +823,17 @@ std::string BrowserInterface::GetSearchUrl(const std::string& query) const
     return result;
 }
 
+std::vector<OmniboxMatch> BrowserInterface::GetSuggestions(const std::string& text, size_t maxResults) const
+{
+    return m_omnibox.Query(text, maxResults);
+}
+
+void BrowserInterface::ClearHistory()
+{
+    m_omnibox.ClearHistory();
+    Log(2, "Browsing history cleared");
+}
+
 void BrowserInterface::SetSearchEngine(const std::string& url)
 {
     m_searchEngine = url;
@@ -331,7 +847,7 @@ void BrowserInterface::LoadBookmarks()
     try
     {
         // Clear existing bookmarks
-        m_bookmarks.clear();
+        m_bookmarks.Clear();
         
         // Get bookmarks file path
         auto appDataPath = std::filesystem::temp_directory_path() / "PoEOverlay";
@@ -341,7 +857,7 @@ void BrowserInterface::LoadBookmarks()
         if (!std::filesystem::exists(bookmarksPath))
         {
             // Create default bookmarks
-            m_bookmarks = {
+            const Bookmark defaults[] = {
                 {"Path of Exile", "https://www.pathofexile.com", "Official", ""},
                 {"POE Wiki", "https://www.poewiki.net", "Official", ""},
                 {"POE Trade", "https://www.pathofexile.com/trade", "Official", ""},
@@ -349,12 +865,31 @@ void BrowserInterface::LoadBookmarks()
                 {"POE DB", "https://poedb.tw", "Tools", ""},
                 {"Craft of Exile", "https://www.craftofexile.com", "Tools", ""}
             };
+            m_bookmarks.AddRange(defaults);
             
             // Save default bookmarks
             SaveBookmarks();
             return;
         }
         
+        // Read the binary cache in place while the JSON is unchanged since it was written
+        BinaryCacheReader cache;
+        if (cache.Open(appDataPath / "bookmarks.cache", bookmarksPath, kBookmarksCacheSchema, kBookmarksCacheFields))
+        {
+            for (uint32_t i = 0; i < cache.GetRecordCount(); ++i)
+            {
+                m_bookmarks.Add({
+                    std::string(cache.GetString(i, 0)),
+                    std::string(cache.GetString(i, 1)),
+                    std::string(cache.GetString(i, 2)),
+                    std::string(cache.GetString(i, 3))
+                });
+            }
+            
+            Log(2, "Loaded {} bookmarks from cache", m_bookmarks.GetCount());
+            return;
+        }
+        
         // Open file
         std::ifstream file(bookmarksPath);
         if (!file.is_open())
@@ -381,10 +916,14 @@ void BrowserInterface::LoadBookmarks()
                 bookmark.icon = item["icon"].get<std::string>();
             }
             
-            m_bookmarks.push_back(bookmark);
+            m_bookmarks.Add(bookmark);
         }
         
-        Log(2, "Loaded {} bookmarks", m_bookmarks.size());
+        Log(2, "Loaded {} bookmarks", m_bookmarks.GetCount());
+        
+        // Re-import done; the next start reads the cache instead
+        file.close();
+        WriteBookmarksCache(appDataPath / "bookmarks.cache", bookmarksPath);
     }
     catch (const std::exception& ex)
     {
@@ -407,7 +946,8 @@ void BrowserInterface::SaveBookmarks()
         nlohmann::json json = nlohmann::json::array();
         
         // Add bookmarks to JSON
-        for (const auto& bookmark : m_bookmarks)
+        std::vector<Bookmark> bookmarks = m_bookmarks.ToVector();
+        for (const auto& bookmark : bookmarks)
         {
             nlohmann::json item;
             item["name"] = bookmark.name;
@@ -424,17 +964,23 @@ void BrowserInterface::SaveBookmarks()
         }
         
         // Open file
-        std::ofstream file(bookmarksPath);
-        if (!file.is_open())
         {
-            Log(3, "Failed to open bookmarks file for writing: {}", bookmarksPath.string());
-            return;
+            std::ofstream file(bookmarksPath);
+            if (!file.is_open())
+            {
+                Log(3, "Failed to open bookmarks file for writing: {}", bookmarksPath.string());
+                return;
+            }
+            
+            // Write JSON to file
+            file << json.dump(4);
         }
         
-        // Write JSON to file
-        file << json.dump(4);
+        // Stamp the cache with the file just closed
+        WriteBookmarksCache(appDataPath / "bookmarks.cache", bookmarksPath);
         
-        Log(2, "Saved {} bookmarks", m_bookmarks.size());
+        m_bookmarksDirty = false;
+        Log(2, "Saved {} bookmarks", bookmarks.size());
     }
     catch (const std::exception& ex)
     {
@@ -442,28 +988,108 @@ void BrowserInterface::SaveBookmarks()
     }
 }
 
-template<typename... Args>
-void BrowserInterface::Log(int level, const std::string& fmt, const Args&... args)
+void BrowserInterface::TrackHistory(BrowserView& view)
 {
-    try
+    view.SetHistoryCallback(
+        [this](const std::string& url, const std::string& title, bool navigated) {
+            // Internal and blank pages are not worth suggesting
+            if (url.empty() || url.rfind("about:", 0) == 0 || url.rfind("data:", 0) == 0 ||
+                url.rfind("devtools:", 0) == 0 || url.rfind("chrome:", 0) == 0)
+            {
+                return;
+            }
+            
+            if (navigated)
+            {
+                m_omnibox.RecordVisit(url);
+            }
+            else
+            {
+                m_omnibox.UpdateTitle(url, title);
+            }
+        });
+}
+
+void BrowserInterface::RegisterBridgeMethods()
+{
+    MessageBridge* bridge = m_cefManager->GetMessageBridge();
+    if (!bridge)
     {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
+        return;
+    }
+
+    // poe.call("bookmarks.list", {folder}) lists one folder, or all of them without a folder
+    bridge->RegisterMethod("bookmarks.list", [this](const nlohmann::json& params) {
+        BridgeReply reply;
+        reply.value = nlohmann::json::array();
+        auto addFolder = [&](const std::string& folder) {
+            for (const auto& bookmark : m_bookmarks.GetFolder(folder))
+            {
+                reply.value.push_back({
+                    { "name", bookmark.name },
+                    { "url", bookmark.url },
+                    { "folder", bookmark.folder },
+                    { "icon", bookmark.icon }
+                });
+            }
+        };
+
+        if (params.contains("folder"))
+        {
+            addFolder(params["folder"].get<std::string>());
+        }
+        else
+        {
+            for (const auto& folder : m_bookmarks.GetFolderNames())
+            {
+                addFolder(folder);
+            }
+        }
+        return reply;
+    });
+
+    // poe.call("omnibox.suggest", {text, max}) ranks bookmarks and history for typed text
+    bridge->RegisterMethod("omnibox.suggest", [this](const nlohmann::json& params) {
+        BridgeReply reply;
+        reply.value = nlohmann::json::array();
+        size_t maxResults = static_cast<size_t>(std::clamp(params.value("max", 8), 1, 50));
+        for (const auto& match : GetSuggestions(params.value("text", std::string()), maxResults))
         {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
+            reply.value.push_back({
+                { "title", match.title },
+                { "url", match.url },
+                { "folder", match.folder },
+                { "bookmarked", match.bookmarked }
+            });
         }
+        return reply;
+    });
+}
+
+void BrowserInterface::MarkBookmarksDirty()
+{
+    if (!m_bookmarksDirty)
+    {
+        m_bookmarksDirty = true;
+        m_bookmarksChangedAt = std::chrono::steady_clock::now();
     }
-    catch (const std::exception& e)
+}
+
+void BrowserInterface::WriteBookmarksCache(const std::filesystem::path& cachePath, const std::filesystem::path& sourcePath)
+{
+    BinaryCacheWriter cache(kBookmarksCacheSchema, kBookmarksCacheFields);
+    
+    for (const auto& bookmark : m_bookmarks.ToVector())
+    {
+        cache.AddString(bookmark.name);
+        cache.AddString(bookmark.url);
+        cache.AddString(bookmark.folder);
+        cache.AddString(bookmark.icon);
+    }
+    
+    if (!cache.WriteFile(cachePath, sourcePath))
     {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "BrowserInterface log error: " << e.what() << std::endl;
+        Log(3, "Failed to write bookmarks cache: {}", cachePath.string());
     }
 }
 
@@ -3,11 +3,48 @@
 #include "browser/RenderHandler.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
+#include "core/Settings.h"
+#include "core/TraceRing.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <spdlog/fmt/fmt.h>
+#include <include/cef_task.h>
 
 namespace poe {
 
+namespace {
+
+/// Longest coalescing interval for mouse moves and wheel input, about one 60 Hz frame
+constexpr int kMaxInputFlushIntervalMs = 16;
+
+/**
+ * @class InputFlushTask
+ * @brief Runs a BrowserView's coalesced input flush on the CEF UI thread.
+ */
+class InputFlushTask : public CefTask
+{
+public:
+    explicit InputFlushTask(std::function<void()> callback)
+        : m_callback(std::move(callback))
+    {
+    }
+    
+    void Execute() override
+    {
+        m_callback();
+    }
+    
+private:
+    IMPLEMENT_REFCOUNTING(InputFlushTask);
+    
+    std::function<void()> m_callback;
+};
+
+} // namespace
+
 BrowserView::BrowserView(
     Application& app,
     CefManager& cefManager,
@@ -19,13 +56,31 @@ BrowserView::BrowserView(
     , m_browser(nullptr)
     , m_width(width)
     , m_height(height)
+    , m_scaleFactor(1.0f)
     , m_visible(true)
+    , m_focused(true)
+    , m_appliedFrameRate(-1)
+    , m_hostHidden(false)
+    , m_discarded(false)
+    , m_discardPending(false)
+    , m_restoreScroll(false)
+    , m_scrollX(0)
+    , m_scrollY(0)
+    , m_lastActiveTime(std::chrono::steady_clock::now())
+    , m_pendingWheelX(0)
+    , m_pendingWheelY(0)
+    , m_hasPendingMove(false)
+    , m_hasPendingWheel(false)
+    , m_inputFlushScheduled(false)
+    , m_inputToken(std::make_shared<int>(0))
     , m_currentUrl(url)
     , m_currentTitle("")
     , m_isLoading(false)
     , m_canGoBack(false)
     , m_canGoForward(false)
 {
+    m_frameRatePolicy = LoadFrameRatePolicy();
+    
     Log(2, "BrowserView created with size {}x{}", width, height);
 }
 
@@ -34,7 +89,7 @@ BrowserView::~BrowserView()
     Shutdown();
 }
 
-bool BrowserView::Initialize()
+bool BrowserView::Initialize(bool registerView)
 {
     if (m_browser)
     {
@@ -46,42 +101,6 @@ bool BrowserView::Initialize()
     {
         Log(2, "Initializing BrowserView");
         
-        // Setup browser handler callbacks
-        auto browserHandler = m_cefManager.GetBrowserHandler();
-        if (browserHandler)
-        {
-            browserHandler->SetBrowserCreatedCallback(
-                [this](CefRefPtr<CefBrowser> browser) { OnBrowserCreated(browser); });
-            
-            browserHandler->SetBrowserCloseCallback(
-                [this](CefRefPtr<CefBrowser> browser) { OnBrowserClose(browser); });
-            
-            browserHandler->SetLoadStateCallback(
-                [this](CefRefPtr<CefBrowser> browser, bool isLoading, bool canGoBack, bool canGoForward) {
-                    OnLoadingStateChange(isLoading, canGoBack, canGoForward);
-                });
-            
-            browserHandler->SetTitleChangeCallback(
-                [this](CefRefPtr<CefBrowser> browser, const std::string& title) {
-                    OnTitleChange(title);
-                });
-            
-            browserHandler->SetAddressChangeCallback(
-                [this](CefRefPtr<CefBrowser> browser, const std::string& url) {
-                    OnAddressChange(url);
-                });
-        }
-        
-        // Setup render handler callbacks
-        auto renderHandler = m_cefManager.GetRenderHandler();
-        if (renderHandler)
-        {
-            renderHandler->SetPaintCallback(
-                [this](CefRefPtr<CefBrowser> browser, const void* buffer, int width, int height, int x, int y) {
-                    OnPaint(buffer, width, height, x, y);
-                });
-        }
-        
         // Create browser
         m_browser = m_cefManager.CreateBrowser(
             m_currentUrl,
@@ -96,6 +115,23 @@ bool BrowserView::Initialize()
             return false;
         }
         
+        if (registerView)
+        {
+            RegisterWithHandlers();
+        }
+        
+        // Views created after a DPI change must not start at 1x
+        auto renderHandler = m_cefManager.GetRenderHandler();
+        if (renderHandler && m_scaleFactor != 1.0f)
+        {
+            renderHandler->SetScaleFactor(m_browser, m_scaleFactor);
+        }
+        
+        // The browser starts at the creation frame rate; bring it in line with the policy
+        m_appliedFrameRate = -1;
+        m_hostHidden = false;
+        ApplyFrameRate();
+        
         Log(2, "BrowserView initialized successfully");
         return true;
     }
@@ -106,6 +142,100 @@ bool BrowserView::Initialize()
     }
 }
 
+void BrowserView::RegisterWithHandlers()
+{
+    if (!m_browser)
+    {
+        return;
+    }
+
+    // The handlers are shared by every browser; they dispatch by browser ID
+    int browserId = m_browser->GetIdentifier();
+    
+    if (auto browserHandler = m_cefManager.GetBrowserHandler())
+    {
+        browserHandler->RegisterView(browserId, this);
+    }
+    
+    if (auto renderHandler = m_cefManager.GetRenderHandler())
+    {
+        renderHandler->RegisterView(browserId, this);
+    }
+}
+
+void BrowserView::UnregisterFromHandlers()
+{
+    if (!m_browser)
+    {
+        return;
+    }
+
+    int browserId = m_browser->GetIdentifier();
+    
+    if (auto browserHandler = m_cefManager.GetBrowserHandler())
+    {
+        browserHandler->UnregisterView(browserId);
+    }
+    
+    if (auto renderHandler = m_cefManager.GetRenderHandler())
+    {
+        renderHandler->UnregisterView(browserId);
+    }
+}
+
+bool BrowserView::Acquire(int width, int height, const std::string& url)
+{
+    if (!m_browser)
+    {
+        return false;
+    }
+
+    Log(2, "Reusing pre-warmed browser {} for: {}", m_browser->GetIdentifier(), url);
+    
+    RegisterWithHandlers();
+    Resize(width, height);
+    SetVisible(true);
+    
+    m_currentUrl = url;
+    Navigate(url);
+    return true;
+}
+
+void BrowserView::Reset()
+{
+    // Drop the previous owner's callbacks before anything else can fire them;
+    // the pooled browser's events go nowhere until it is acquired again
+    UnregisterFromHandlers();
+    m_navigationStateCallback = nullptr;
+    m_titleChangeCallback = nullptr;
+    m_addressChangeCallback = nullptr;
+    m_paintCallback = nullptr;
+    m_acceleratedPaintCallback = nullptr;
+    
+    m_focused = true;
+    m_frameRatePolicy = LoadFrameRatePolicy();
+    
+    m_discardPending = false;
+    m_restoreScroll = false;
+    m_scrollX = 0;
+    m_scrollY = 0;
+    
+    m_currentUrl = "about:blank";
+    m_currentTitle.clear();
+    m_isLoading = false;
+    m_canGoBack = false;
+    m_canGoForward = false;
+    
+    if (!m_browser)
+    {
+        return;
+    }
+
+    SetVisible(false);
+    m_browser->StopLoad();
+    Navigate(m_currentUrl);
+}
+
 void BrowserView::Shutdown()
 {
     if (!m_browser)
@@ -116,12 +246,92 @@ void BrowserView::Shutdown()
     Log(2, "Shutting down BrowserView");
     
     // Close browser
+    m_discardPending = false;
+    m_hasPendingMove = false;
+    m_hasPendingWheel = false;
+    UnregisterFromHandlers();
     m_cefManager.CloseBrowser(m_browser, true);
     m_browser = nullptr;
 }
 
+void BrowserView::RequestDiscard()
+{
+    if (!m_browser || m_discardPending)
+    {
+        return;
+    }
+
+    m_discardPending = true;
+    m_discardRequestTime = std::chrono::steady_clock::now();
+    
+    CefRefPtr<CefFrame> mainFrame = m_browser->GetMainFrame();
+    if (mainFrame)
+    {
+        mainFrame->SendProcessMessage(PID_RENDERER, CefProcessMessage::Create("poe.captureScroll"));
+    }
+    else
+    {
+        Discard();
+    }
+}
+
+void BrowserView::Discard()
+{
+    if (!m_browser)
+    {
+        return;
+    }
+
+    Log(2, "Discarding browser {} ({})", m_browser->GetIdentifier(), m_currentUrl);
+    
+    Shutdown();
+    
+    m_discarded = true;
+    m_isLoading = false;
+    m_appliedFrameRate = -1;
+    m_hostHidden = false;
+}
+
+void BrowserView::OnScrollPosition(int x, int y)
+{
+    m_scrollX = x;
+    m_scrollY = y;
+    
+    if (m_discardPending)
+    {
+        Discard();
+    }
+}
+
+bool BrowserView::Restore()
+{
+    Log(2, "Restoring discarded browser view: {}", m_currentUrl);
+    
+    m_discarded = false;
+    m_restoreScroll = m_scrollX != 0 || m_scrollY != 0;
+    
+    if (!Initialize())
+    {
+        m_discarded = true;
+        m_restoreScroll = false;
+        return false;
+    }
+    
+    return true;
+}
+
 void BrowserView::Navigate(const std::string& url)
 {
+    if (m_discarded)
+    {
+        // A new page starts at the top; no need to bring the old one back first
+        m_currentUrl = url;
+        m_scrollX = 0;
+        m_scrollY = 0;
+        Restore();
+        return;
+    }
+
     if (!m_browser)
     {
         Log(3, "Cannot navigate: browser not initialized");
@@ -129,6 +339,7 @@ void BrowserView::Navigate(const std::string& url)
     }
 
     Log(2, "Navigating to: {}", url);
+    Touch();
     
     // Get the main frame and load the URL
     CefRefPtr<CefFrame> mainFrame = m_browser->GetMainFrame();
@@ -180,6 +391,16 @@ void BrowserView::StopLoad()
     m_browser->StopLoad();
 }
 
+void BrowserView::Invalidate()
+{
+    if (!m_browser)
+    {
+        return;
+    }
+
+    m_browser->GetHost()->Invalidate(PET_VIEW);
+}
+
 void BrowserView::Resize(int width, int height)
 {
     if (m_width == width && m_height == height)
@@ -203,6 +424,32 @@ void BrowserView::Resize(int width, int height)
     }
 }
 
+void BrowserView::SetScaleFactor(float scaleFactor)
+{
+    if (scaleFactor <= 0.0f || m_scaleFactor == scaleFactor)
+    {
+        return;
+    }
+
+    Log(2, "Browser view scale factor: {}", scaleFactor);
+    
+    m_scaleFactor = scaleFactor;
+    
+    if (m_browser)
+    {
+        auto renderHandler = m_cefManager.GetRenderHandler();
+        if (renderHandler)
+        {
+            renderHandler->SetScaleFactor(m_browser, scaleFactor);
+        }
+    }
+}
+
+int BrowserView::ToDips(int pixels) const
+{
+    return static_cast<int>(std::lround(pixels / m_scaleFactor));
+}
+
 void BrowserView::SetVisible(bool visible)
 {
     if (m_visible == visible)
@@ -212,10 +459,92 @@ void BrowserView::SetVisible(bool visible)
 
     m_visible = visible;
     
-    // Update browser visibility state
+    if (visible)
+    {
+        Touch();
+        
+        // Bring a discarded view back lazily, the first time it is shown again
+        if (m_discarded)
+        {
+            Restore();
+            return;
+        }
+    }
+    
+    ApplyFrameRate();
+}
+
+void BrowserView::SetFocused(bool focused)
+{
+    if (m_focused == focused)
+    {
+        return;
+    }
+
+    m_focused = focused;
+    Touch();
+    
     if (m_browser)
     {
-        m_browser->GetHost()->WasHidden(!visible);
+        m_browser->GetHost()->SetFocus(focused);
+    }
+    
+    ApplyFrameRate();
+}
+
+void BrowserView::SetFrameRatePolicy(const FrameRatePolicy& policy)
+{
+    m_frameRatePolicy = policy;
+    ApplyFrameRate();
+}
+
+int BrowserView::GetFrameRate() const
+{
+    if (!m_visible)
+    {
+        return m_frameRatePolicy.hidden;
+    }
+    
+    return m_focused ? m_frameRatePolicy.focused : m_frameRatePolicy.idle;
+}
+
+FrameRatePolicy BrowserView::LoadFrameRatePolicy() const
+{
+    auto settings = m_app.GetSettings().GetSnapshot();
+    
+    FrameRatePolicy policy;
+    policy.focused = settings->focusedFrameRate;
+    policy.idle = settings->idleFrameRate;
+    policy.hidden = settings->hiddenFrameRate;
+    return policy;
+}
+
+void BrowserView::ApplyFrameRate()
+{
+    if (!m_browser)
+    {
+        return;
+    }
+
+    auto host = m_browser->GetHost();
+    int frameRate = GetFrameRate();
+    
+    // A rate of 0 hides the view from Chromium, which stops rasterizing and
+    // compositing altogether; anything else keeps it live at that rate
+    bool hidden = frameRate <= 0;
+    if (hidden != m_hostHidden)
+    {
+        m_hostHidden = hidden;
+        host->WasHidden(hidden);
+    }
+    
+    // CEF accepts 1-60 fps for windowless browsers
+    frameRate = std::clamp(frameRate, 1, 60);
+    if (!hidden && frameRate != m_appliedFrameRate)
+    {
+        m_appliedFrameRate = frameRate;
+        host->SetWindowlessFrameRate(m_appliedFrameRate);
+        Log(1, "Browser {} frame rate set to {} fps", m_browser->GetIdentifier(), m_appliedFrameRate);
     }
 }
 
@@ -226,14 +555,13 @@ void BrowserView::OnMouseMove(int x, int y, uint32_t modifiers)
         return;
     }
 
-    // Convert mouse coordinates to browser coordinates
-    CefMouseEvent event;
-    event.x = x;
-    event.y = y;
-    event.modifiers = modifiers;
+    // Keep only the latest position until the frame interval ends
+    m_pendingMove.x = ToDips(x);
+    m_pendingMove.y = ToDips(y);
+    m_pendingMove.modifiers = modifiers;
+    m_hasPendingMove = true;
     
-    // Send mouse move event
-    m_browser->GetHost()->SendMouseMoveEvent(event, false);
+    ScheduleInputFlush();
 }
 
 void BrowserView::OnMouseButton(int x, int y, int button, uint32_t modifiers, bool isDown)
@@ -243,10 +571,12 @@ void BrowserView::OnMouseButton(int x, int y, int button, uint32_t modifiers, bo
         return;
     }
 
+    Touch();
+    
     // Convert mouse coordinates to browser coordinates
     CefMouseEvent event;
-    event.x = x;
-    event.y = y;
+    event.x = ToDips(x);
+    event.y = ToDips(y);
     event.modifiers = modifiers;
     
     // Map button to CEF button type
@@ -259,8 +589,13 @@ void BrowserView::OnMouseButton(int x, int y, int button, uint32_t modifiers, bo
         default: return; // Unsupported button
     }
     
+    // The click must land after the moves that led to it
+    FlushInput();
+    
     // Send mouse button event
     m_browser->GetHost()->SendMouseClickEvent(event, cefButton, !isDown, 1);
+    m_app.GetTraceRing().Emit(TraceEvent::BrowserInputSent,
+        static_cast<int64_t>(BrowserInputKind::MouseButton), event.x, event.y);
 }
 
 void BrowserView::OnMouseWheel(int x, int y, int deltaX, int deltaY)
@@ -270,14 +605,17 @@ void BrowserView::OnMouseWheel(int x, int y, int deltaX, int deltaY)
         return;
     }
 
-    // Convert mouse coordinates to browser coordinates
-    CefMouseEvent event;
-    event.x = x;
-    event.y = y;
-    event.modifiers = 0;
+    Touch();
+    
+    // Sum the deltas at the latest position until the frame interval ends
+    m_pendingWheel.x = ToDips(x);
+    m_pendingWheel.y = ToDips(y);
+    m_pendingWheel.modifiers = 0;
+    m_pendingWheelX += deltaX;
+    m_pendingWheelY += deltaY;
+    m_hasPendingWheel = true;
     
-    // Send mouse wheel event
-    m_browser->GetHost()->SendMouseWheelEvent(event, deltaX, deltaY);
+    ScheduleInputFlush();
 }
 
 void BrowserView::OnKey(int key, uint32_t modifiers, bool isDown)
@@ -287,6 +625,8 @@ void BrowserView::OnKey(int key, uint32_t modifiers, bool isDown)
         return;
     }
 
+    Touch();
+    
     // Create key event
     CefKeyEvent event;
     event.windows_key_code = key;
@@ -294,8 +634,12 @@ void BrowserView::OnKey(int key, uint32_t modifiers, bool isDown)
     event.modifiers = modifiers;
     event.type = isDown ? KEYEVENT_KEYDOWN : KEYEVENT_KEYUP;
     
+    // Keep keys ordered after the pointer input that preceded them
+    FlushInput();
+    
     // Send key event
     m_browser->GetHost()->SendKeyEvent(event);
+    m_app.GetTraceRing().Emit(TraceEvent::BrowserInputSent, static_cast<int64_t>(BrowserInputKind::Key), key);
 }
 
 void BrowserView::OnChar(unsigned int character, uint32_t modifiers)
@@ -305,6 +649,8 @@ void BrowserView::OnChar(unsigned int character, uint32_t modifiers)
         return;
     }
 
+    Touch();
+    
     // Create key event
     CefKeyEvent event;
     event.windows_key_code = character;
@@ -312,8 +658,82 @@ void BrowserView::OnChar(unsigned int character, uint32_t modifiers)
     event.modifiers = modifiers;
     event.type = KEYEVENT_CHAR;
     
+    // Keep keys ordered after the pointer input that preceded them
+    FlushInput();
+    
     // Send key event
     m_browser->GetHost()->SendKeyEvent(event);
+    m_app.GetTraceRing().Emit(TraceEvent::BrowserInputSent, static_cast<int64_t>(BrowserInputKind::Char), character);
+}
+
+void BrowserView::FlushInput()
+{
+    if (!m_browser)
+    {
+        m_hasPendingMove = false;
+        m_hasPendingWheel = false;
+        return;
+    }
+
+    auto host = m_browser->GetHost();
+    
+    if (m_hasPendingMove)
+    {
+        m_hasPendingMove = false;
+        host->SendMouseMoveEvent(m_pendingMove, false);
+        m_app.GetTraceRing().Emit(TraceEvent::BrowserInputSent,
+            static_cast<int64_t>(BrowserInputKind::MouseMove), m_pendingMove.x, m_pendingMove.y);
+    }
+    
+    if (m_hasPendingWheel)
+    {
+        m_hasPendingWheel = false;
+        host->SendMouseWheelEvent(m_pendingWheel, m_pendingWheelX, m_pendingWheelY);
+        m_app.GetTraceRing().Emit(TraceEvent::BrowserInputSent,
+            static_cast<int64_t>(BrowserInputKind::MouseWheel), m_pendingWheel.x, m_pendingWheel.y);
+        m_pendingWheelX = 0;
+        m_pendingWheelY = 0;
+    }
+}
+
+void BrowserView::ScheduleInputFlush()
+{
+    if (m_inputFlushScheduled)
+    {
+        return;
+    }
+
+    // Nothing went out within the last interval: send this event now and
+    // coalesce only what follows it
+    FlushInput();
+    PostInputFlush();
+}
+
+void BrowserView::PostInputFlush()
+{
+    m_inputFlushScheduled = true;
+    
+    // One flush per frame the browser is rendering at, but never slower than
+    // a 60 Hz frame so idle and hidden views still track the pointer
+    int intervalMs = std::min(1000 / std::max(GetFrameRate(), 1), kMaxInputFlushIntervalMs);
+    
+    // The view may be gone by then
+    std::weak_ptr<int> token = m_inputToken;
+    CefPostDelayedTask(TID_UI, new InputFlushTask([this, token]() {
+        if (!token.lock())
+        {
+            return;
+        }
+        
+        m_inputFlushScheduled = false;
+        
+        // Keep the window open while input keeps arriving; an idle interval closes it
+        if (m_hasPendingMove || m_hasPendingWheel)
+        {
+            FlushInput();
+            PostInputFlush();
+        }
+    }), intervalMs);
 }
 
 std::string BrowserView::GetCurrentUrl() const
@@ -341,25 +761,8 @@ bool BrowserView::CanGoForward() const
     return m_canGoForward;
 }
 
-void BrowserView::OnBrowserCreated(CefRefPtr<CefBrowser> browser)
+void BrowserView::OnBrowserClose()
 {
-    // Only handle our browser
-    if (!m_browser || browser->GetIdentifier() != m_browser->GetIdentifier())
-    {
-        return;
-    }
-
-    Log(2, "Browser created successfully");
-}
-
-void BrowserView::OnBrowserClose(CefRefPtr<CefBrowser> browser)
-{
-    // Only handle our browser
-    if (!m_browser || browser->GetIdentifier() != m_browser->GetIdentifier())
-    {
-        return;
-    }
-
     Log(2, "Browser closed");
     m_browser = nullptr;
 }
@@ -371,6 +774,20 @@ void BrowserView::OnLoadingStateChange(bool isLoading, bool canGoBack, bool canG
     m_canGoBack = canGoBack;
     m_canGoForward = canGoForward;
     
+    // Put a restored page back where the user left it once it has loaded
+    if (!isLoading && m_restoreScroll && m_browser)
+    {
+        m_restoreScroll = false;
+        
+        CefRefPtr<CefFrame> mainFrame = m_browser->GetMainFrame();
+        if (mainFrame)
+        {
+            mainFrame->ExecuteJavaScript(
+                fmt::format("window.scrollTo({}, {});", m_scrollX, m_scrollY),
+                mainFrame->GetURL(), 0);
+        }
+    }
+    
     Log(1, "Loading state changed: isLoading={}, canGoBack={}, canGoForward={}",
         isLoading, canGoBack, canGoForward);
     
@@ -388,6 +805,11 @@ void BrowserView::OnTitleChange(const std::string& title)
     
     Log(1, "Title changed: {}", title);
     
+    if (m_historyCallback)
+    {
+        m_historyCallback(m_currentUrl, title, false);
+    }
+    
     // Notify callback if set
     if (m_titleChangeCallback)
     {
@@ -402,6 +824,11 @@ void BrowserView::OnAddressChange(const std::string& url)
     
     Log(1, "Address changed: {}", url);
     
+    if (m_historyCallback)
+    {
+        m_historyCallback(url, std::string(), true);
+    }
+    
     // Notify callback if set
     if (m_addressChangeCallback)
     {
@@ -409,7 +836,7 @@ void BrowserView::OnAddressChange(const std::string& url)
     }
 }
 
-void BrowserView::OnPaint(const void* buffer, int width, int height, int x, int y)
+void BrowserView::OnPaint(const CefRenderHandler::RectList& dirtyRects, const void* buffer, int width, int height)
 {
     // Ignore if not visible
     if (!m_visible)
@@ -417,35 +844,48 @@ void BrowserView::OnPaint(const void* buffer, int width, int height, int x, int
         return;
     }
     
-    // Notify callback if set
+    ScopedPerfTimer timer(m_app.GetFrameProfiler(), PerfStage::BrowserViewPaint);
+    
+    // Convert to Win32 rectangles, clamped to the buffer, reusing the same storage
+    m_dirtyRects.clear();
+    for (const auto& rect : dirtyRects)
+    {
+        RECT clamped;
+        clamped.left = std::max(rect.x, 0);
+        clamped.top = std::max(rect.y, 0);
+        clamped.right = std::min(rect.x + rect.width, width);
+        clamped.bottom = std::min(rect.y + rect.height, height);
+        
+        if (clamped.right > clamped.left && clamped.bottom > clamped.top)
+        {
+            m_dirtyRects.push_back(clamped);
+        }
+    }
+    
+    // CEF normally reports at least one rect; treat an empty list as a full repaint
+    if (dirtyRects.empty())
+    {
+        m_dirtyRects.push_back({ 0, 0, width, height });
+    }
+    else if (m_dirtyRects.empty())
+    {
+        return; // Every rect fell outside the buffer
+    }
+    
+    // Hand the frame to the compositor without waiting for it
+    m_frameMailbox.Publish(buffer, width, height, m_dirtyRects);
+    
     if (m_paintCallback)
     {
-        m_paintCallback(buffer, width, height);
+        m_paintCallback(buffer, width, height, m_dirtyRects);
     }
 }
 
-template<typename... Args>
-void BrowserView::Log(int level, const std::string& fmt, const Args&... args)
+void BrowserView::OnAcceleratedPaint(HANDLE sharedHandle)
 {
-    try
-    {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e)
+    if (m_visible && m_acceleratedPaintCallback)
     {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "BrowserView log error: " << e.what() << std::endl;
+        m_acceleratedPaintCallback(sharedHandle);
     }
 }
 
@@ -0,0 +1,721 @@
+#include "browser/CachingRequestHandler.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+#include "core/WorkerPool.h"
+
+#include <include/cef_parser.h>
+#include <include/cef_resource_handler.h>
+#include <include/cef_resource_request_handler.h>
+#include <include/cef_response_filter.h>
+#include <include/cef_urlrequest.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace poe {
+
+namespace {
+
+/// Endpoints worth caching. poe.ninja price JSON changes slowly and is
+/// served stale while it refreshes; trade data follows the server's headers.
+constexpr CachedHostPolicy kCachedHosts[] = {
+    { "poe.ninja",           "/api/",      300, 3600 },
+    { "www.pathofexile.com", "/api/trade", 0,   0 },
+};
+
+constexpr size_t kMaxCachedBodyBytes = 16 * 1024 * 1024;    ///< Larger responses are passed through uncached
+
+std::string ToLower(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+bool HasValidator(const HttpCacheEntry& entry)
+{
+    return !entry.etag.empty() || !entry.lastModified.empty();
+}
+
+/**
+ * @brief Builds the freshness rules for a response, filling in host defaults.
+ */
+HttpCachePolicy BuildPolicy(CefRefPtr<CefResponse> response, const CachedHostPolicy& host)
+{
+    std::string cacheControl = ToLower(response->GetHeaderByName("Cache-Control").ToString());
+    HttpCachePolicy policy = HttpCache::ParseCacheControl(cacheControl);
+    
+    // Explicit no-cache wins over the host defaults
+    if (cacheControl.find("no-cache") != std::string::npos)
+    {
+        return policy;
+    }
+    
+    if (cacheControl.find("max-age") == std::string::npos)
+    {
+        policy.maxAge = host.defaultMaxAge;
+    }
+    
+    if (cacheControl.find("stale-while-revalidate") == std::string::npos)
+    {
+        policy.staleWhileRevalidate = host.defaultStaleWhileRevalidate;
+    }
+    
+    return policy;
+}
+
+/**
+ * @brief Copies the headers of a response that are worth replaying.
+ */
+void CollectHeaders(CefRefPtr<CefResponse> response, std::vector<std::pair<std::string, std::string>>& out)
+{
+    // The body is stored decoded, and cookies are never replayed
+    static constexpr std::string_view skippedHeaders[] = {
+        "connection", "content-encoding", "content-length", "keep-alive", "set-cookie", "transfer-encoding",
+    };
+    
+    CefResponse::HeaderMap headers;
+    response->GetHeaderMap(headers);
+    for (const auto& [name, value] : headers)
+    {
+        std::string headerName = name.ToString();
+        std::string lowerName = ToLower(headerName);
+        if (std::find(std::begin(skippedHeaders), std::end(skippedHeaders), lowerName) == std::end(skippedHeaders))
+        {
+            out.emplace_back(std::move(headerName), value.ToString());
+        }
+    }
+}
+
+/**
+ * @brief Describes a network response as an entry, whether or not it may be stored.
+ */
+void CopyResponse(const std::string& url, CefRefPtr<CefResponse> response, const CachedHostPolicy& host, HttpCacheEntry& entry)
+{
+    entry.url = url;
+    entry.status = response->GetStatus();
+    entry.statusText = response->GetStatusText().ToString();
+    entry.mimeType = response->GetMimeType().ToString();
+    entry.charset = response->GetCharset().ToString();
+    entry.etag = response->GetHeaderByName("ETag").ToString();
+    entry.lastModified = response->GetHeaderByName("Last-Modified").ToString();
+    entry.policy = BuildPolicy(response, host);
+    CollectHeaders(response, entry.headers);
+}
+
+/**
+ * @brief Checks whether an entry is worth storing.
+ */
+bool IsStorable(const HttpCacheEntry& entry)
+{
+    if (entry.status != 200 || entry.policy.noStore)
+    {
+        return false;
+    }
+    
+    // Without freshness or a validator the entry could never be used; with
+    // only a validator it is served after a conditional request answers 304
+    return entry.policy.maxAge + entry.policy.staleWhileRevalidate > 0 || HasValidator(entry);
+}
+
+/**
+ * @brief Builds a cache entry from a network response.
+ * @return False if the response must not or need not be stored.
+ */
+bool BuildEntry(const std::string& url, CefRefPtr<CefResponse> response, const CachedHostPolicy& host, HttpCacheEntry& entry)
+{
+    CopyResponse(url, response, host, entry);
+    return IsStorable(entry);
+}
+
+/**
+ * @brief Queues a response for storage on the worker pool.
+ */
+void StoreAsync(Application& app, std::shared_ptr<HttpCache> cache, HttpCacheEntry entry, std::string body)
+{
+    app.GetWorkerPool().Post([cache, entry = std::move(entry), body = std::move(body)]() mutable {
+        cache->Store(std::move(entry), std::move(body));
+    });
+}
+
+/**
+ * @class CacheResponseFilter
+ * @brief Passes a network response through unchanged while keeping a copy.
+ */
+class CacheResponseFilter : public CefResponseFilter {
+public:
+    CacheResponseFilter()
+        : m_overflow(false)
+    {
+    }
+    
+    bool InitFilter() override
+    {
+        return true;
+    }
+    
+    FilterStatus Filter(
+        void* data_in,
+        size_t data_in_size,
+        size_t& data_in_read,
+        void* data_out,
+        size_t data_out_size,
+        size_t& data_out_written) override
+    {
+        size_t copyAmount = std::min(data_in_size, data_out_size);
+        if (copyAmount > 0)
+        {
+            memcpy(data_out, data_in, copyAmount);
+            
+            if (!m_overflow && m_body.size() + copyAmount <= kMaxCachedBodyBytes)
+            {
+                m_body.append(static_cast<const char*>(data_in), copyAmount);
+            }
+            else
+            {
+                m_overflow = true;
+                m_body.clear();
+            }
+        }
+        
+        data_in_read = copyAmount;
+        data_out_written = copyAmount;
+        
+        // Ask to be called again while the output buffer could not take everything
+        return copyAmount < data_in_size ? RESPONSE_FILTER_NEED_MORE_DATA : RESPONSE_FILTER_DONE;
+    }
+    
+    /**
+     * @brief Takes the captured body.
+     * @param body Receives the body.
+     * @return False if the body exceeded the size limit.
+     */
+    bool TakeBody(std::string& body)
+    {
+        if (m_overflow)
+        {
+            return false;
+        }
+        
+        body = std::move(m_body);
+        return true;
+    }
+
+private:
+    IMPLEMENT_REFCOUNTING(CacheResponseFilter);
+    
+    std::string m_body;                             ///< Captured body
+    bool m_overflow;                                ///< Whether the body exceeded kMaxCachedBodyBytes
+};
+
+/**
+ * @class RevalidationClient
+ * @brief Refreshes an entry with a conditional request.
+ *
+ * Without a completion the request runs in the background for a stale
+ * entry. With one, a request is waiting on the outcome: the completion
+ * receives the response to serve, which is the refreshed entry after a
+ * 304 (body still on disk) or the new response with its body otherwise.
+ */
+class RevalidationClient : public CefURLRequestClient {
+public:
+    /// Receives the response to serve, or std::nullopt if the request failed
+    using Completion = std::function<void(std::optional<HttpCacheEntry> entry, std::shared_ptr<const std::string> body)>;
+    
+    RevalidationClient(
+        Application& app,
+        std::shared_ptr<HttpCache> cache,
+        HttpCacheEntry entry,
+        const CachedHostPolicy& host,
+        Completion completion = nullptr)
+        : m_app(app)
+        , m_cache(std::move(cache))
+        , m_entry(std::move(entry))
+        , m_host(host)
+        , m_completion(std::move(completion))
+        , m_overflow(false)
+    {
+    }
+    
+    /**
+     * @brief Sends the conditional request.
+     * @param requestContext Context to send it in, or nullptr for the global one.
+     * @param headers Headers of the original request, if one is waiting.
+     */
+    void Start(CefRefPtr<CefRequestContext> requestContext, CefRequest::HeaderMap headers = {})
+    {
+        headers.erase("If-None-Match");
+        headers.erase("If-Modified-Since");
+        if (!m_entry.etag.empty())
+        {
+            headers.emplace("If-None-Match", m_entry.etag);
+        }
+        if (!m_entry.lastModified.empty())
+        {
+            headers.emplace("If-Modified-Since", m_entry.lastModified);
+        }
+        
+        CefRefPtr<CefRequest> request = CefRequest::Create();
+        request->Set(m_entry.url, "GET", nullptr, headers);
+        request->SetFlags(UR_FLAG_SKIP_CACHE | UR_FLAG_ALLOW_STORED_CREDENTIALS);
+        
+        // Held until completion; released in OnRequestComplete to break the cycle
+        m_urlRequest = CefURLRequest::Create(request, this, requestContext);
+    }
+    
+    /**
+     * @brief Abandons the request; the completion is not called.
+     */
+    void Cancel()
+    {
+        m_completion = nullptr;
+        if (m_urlRequest)
+        {
+            m_urlRequest->Cancel();
+        }
+    }
+    
+    void OnRequestComplete(CefRefPtr<CefURLRequest> request) override
+    {
+        // Releasing m_urlRequest may drop the last reference to this client
+        CefRefPtr<RevalidationClient> self(this);
+        
+        std::optional<HttpCacheEntry> served;
+        std::shared_ptr<const std::string> body;
+        
+        CefRefPtr<CefResponse> response = request->GetResponse();
+        if (request->GetRequestStatus() == UR_SUCCESS && response)
+        {
+            if (response->GetStatus() == 304)
+            {
+                std::vector<std::pair<std::string, std::string>> headers;
+                CollectHeaders(response, headers);
+                served = m_cache->Refresh(m_entry.url, BuildPolicy(response, m_host), headers);
+            }
+            else if (!m_overflow)
+            {
+                HttpCacheEntry entry;
+                CopyResponse(m_entry.url, response, m_host, entry);
+                if (m_completion)
+                {
+                    body = std::make_shared<const std::string>(m_body);
+                }
+                
+                if (IsStorable(entry))
+                {
+                    StoreAsync(m_app, m_cache, entry, std::move(m_body));
+                }
+                else
+                {
+                    m_cache->Remove(m_entry.url);
+                }
+                
+                served = std::move(entry);
+            }
+        }
+        
+        if (!m_completion)
+        {
+            m_cache->EndRevalidation(m_entry.url);
+        }
+        
+        Completion completion = std::move(m_completion);
+        m_completion = nullptr;
+        m_urlRequest = nullptr;
+        
+        if (completion)
+        {
+            completion(std::move(served), std::move(body));
+        }
+    }
+    
+    void OnUploadProgress(CefRefPtr<CefURLRequest> request, int64 current, int64 total) override
+    {
+    }
+    
+    void OnDownloadProgress(CefRefPtr<CefURLRequest> request, int64 current, int64 total) override
+    {
+    }
+    
+    void OnDownloadData(CefRefPtr<CefURLRequest> request, const void* data, size_t data_length) override
+    {
+        if (m_overflow || m_body.size() + data_length > kMaxCachedBodyBytes)
+        {
+            m_overflow = true;
+            m_body.clear();
+            return;
+        }
+        
+        m_body.append(static_cast<const char*>(data), data_length);
+    }
+    
+    bool GetAuthCredentials(
+        bool isProxy,
+        const CefString& host,
+        int port,
+        const CefString& realm,
+        const CefString& scheme,
+        CefRefPtr<CefAuthCallback> callback) override
+    {
+        return false;
+    }
+
+private:
+    IMPLEMENT_REFCOUNTING(RevalidationClient);
+    
+    Application& m_app;                             ///< Reference to the main application
+    std::shared_ptr<HttpCache> m_cache;             ///< Response cache
+    HttpCacheEntry m_entry;                         ///< Entry being revalidated
+    const CachedHostPolicy& m_host;                 ///< Policy of the entry's host
+    Completion m_completion;                        ///< Waiting request's callback, if any
+    CefRefPtr<CefURLRequest> m_urlRequest;          ///< Request in flight
+    std::string m_body;                             ///< Body of a 200 response
+    bool m_overflow;                                ///< Whether the body exceeded kMaxCachedBodyBytes
+};
+
+/**
+ * @class CachedResourceHandler
+ * @brief Serves one cached response; the body is loaded on the worker pool.
+ *
+ * An expired entry that carries a validator is revalidated first, and the
+ * request is answered with whatever the server decided.
+ */
+class CachedResourceHandler : public CefResourceHandler {
+public:
+    /**
+     * @param requestContext Context for the conditional request, or nullptr for the global one.
+     * @param revalidate Whether the entry must be revalidated before it is served.
+     */
+    CachedResourceHandler(
+        Application& app,
+        std::shared_ptr<HttpCache> cache,
+        HttpCacheEntry entry,
+        const CachedHostPolicy& host,
+        CefRefPtr<CefRequestContext> requestContext,
+        bool revalidate)
+        : m_app(app)
+        , m_cache(std::move(cache))
+        , m_host(host)
+        , m_requestContext(std::move(requestContext))
+        , m_revalidate(revalidate)
+        , m_entry(std::move(entry))
+        , m_offset(0)
+    {
+    }
+    
+    bool Open(CefRefPtr<CefRequest> request, bool& handle_request, CefRefPtr<CefCallback> callback) override
+    {
+        handle_request = false;
+        
+        if (!m_revalidate)
+        {
+            LoadBody(callback);
+            return true;
+        }
+        
+        CefRefPtr<CachedResourceHandler> self(this);
+        m_client = new RevalidationClient(m_app, m_cache, m_entry, m_host,
+            [self, callback](std::optional<HttpCacheEntry> entry, std::shared_ptr<const std::string> body) {
+                self->m_client = nullptr;
+                if (!entry)
+                {
+                    callback->Cancel();
+                    return;
+                }
+                
+                bool revalidated = !body;
+                {
+                    std::lock_guard<std::mutex> lock(self->m_mutex);
+                    self->m_entry = std::move(*entry);
+                    self->m_body = std::move(body);
+                }
+                
+                // A 304 leaves the cached body in place
+                if (revalidated)
+                {
+                    self->LoadBody(callback);
+                }
+                else
+                {
+                    callback->Continue();
+                }
+            });
+        
+        CefRequest::HeaderMap headers;
+        request->GetHeaderMap(headers);
+        m_client->Start(m_requestContext, std::move(headers));
+        
+        return true;
+    }
+    
+    void GetResponseHeaders(CefRefPtr<CefResponse> response, int64& response_length, CefString& redirectUrl) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        CefResponse::HeaderMap headers;
+        for (const auto& [name, value] : m_entry.headers)
+        {
+            headers.emplace(name, value);
+        }
+        
+        response->SetHeaderMap(headers);
+        response->SetStatus(m_entry.status);
+        response->SetStatusText(m_entry.statusText);
+        response->SetMimeType(m_entry.mimeType);
+        response->SetCharset(m_entry.charset);
+        
+        response_length = m_body ? static_cast<int64>(m_body->size()) : 0;
+    }
+    
+    bool Skip(int64 bytes_to_skip, int64& bytes_skipped, CefRefPtr<CefResourceSkipCallback> callback) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_body)
+        {
+            bytes_skipped = 0;
+            return false;
+        }
+        
+        size_t skipAmount = std::min(static_cast<size_t>(bytes_to_skip), m_body->size() - m_offset);
+        m_offset += skipAmount;
+        bytes_skipped = static_cast<int64>(skipAmount);
+        return true;
+    }
+    
+    bool Read(void* data_out, int bytes_to_read, int& bytes_read, CefRefPtr<CefResourceReadCallback> callback) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_body || m_offset >= m_body->size())
+        {
+            bytes_read = 0;
+            return false;
+        }
+        
+        size_t readAmount = std::min(static_cast<size_t>(bytes_to_read), m_body->size() - m_offset);
+        memcpy(data_out, m_body->data() + m_offset, readAmount);
+        m_offset += readAmount;
+        bytes_read = static_cast<int>(readAmount);
+        return true;
+    }
+    
+    void Cancel() override
+    {
+        if (m_client)
+        {
+            m_client->Cancel();
+            m_client = nullptr;
+        }
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body.reset();
+    }
+
+private:
+    IMPLEMENT_REFCOUNTING(CachedResourceHandler);
+    
+    /**
+     * @brief Loads the cached body on the worker pool, then resumes the request.
+     */
+    void LoadBody(CefRefPtr<CefCallback> callback)
+    {
+        CefRefPtr<CachedResourceHandler> self(this);
+        m_app.GetWorkerPool().Post([self, callback]() {
+            HttpCacheEntry entry;
+            {
+                std::lock_guard<std::mutex> lock(self->m_mutex);
+                entry = self->m_entry;
+            }
+            
+            std::shared_ptr<const std::string> body = self->m_cache->LoadBody(entry);
+            if (!body)
+            {
+                // Blob vanished; forget the entry so the next request refetches
+                self->m_cache->Remove(entry.url);
+                callback->Cancel();
+                return;
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(self->m_mutex);
+                self->m_body = std::move(body);
+            }
+            callback->Continue();
+        });
+    }
+    
+    Application& m_app;                             ///< Reference to the main application
+    std::shared_ptr<HttpCache> m_cache;             ///< Response cache
+    const CachedHostPolicy& m_host;                 ///< Policy of the request's host
+    CefRefPtr<CefRequestContext> m_requestContext;  ///< Context for the conditional request
+    bool m_revalidate;                              ///< Whether to revalidate before serving
+    CefRefPtr<RevalidationClient> m_client;         ///< Conditional request in flight, if any
+    HttpCacheEntry m_entry;                         ///< Entry being served
+    std::shared_ptr<const std::string> m_body;      ///< Body, once loaded
+    std::mutex m_mutex;                             ///< Guards m_entry, m_body and m_offset
+    size_t m_offset;                                ///< Read position in m_body
+};
+
+/**
+ * @class CacheResourceRequestHandler
+ * @brief Per-request handler: answers from the cache or tees the network response into it.
+ */
+class CacheResourceRequestHandler : public CefResourceRequestHandler {
+public:
+    CacheResourceRequestHandler(Application& app, std::shared_ptr<HttpCache> cache, const CachedHostPolicy& host)
+        : m_app(app)
+        , m_cache(std::move(cache))
+        , m_host(host)
+    {
+    }
+    
+    CefRefPtr<CefResourceHandler> GetResourceHandler(
+        CefRefPtr<CefBrowser> browser,
+        CefRefPtr<CefFrame> frame,
+        CefRefPtr<CefRequest> request) override
+    {
+        std::string url = request->GetURL().ToString();
+        
+        // A forced reload skips the cache but still refreshes it
+        std::string requestCacheControl = ToLower(request->GetHeaderByName("Cache-Control").ToString());
+        if (requestCacheControl.find("no-cache") != std::string::npos ||
+            requestCacheControl.find("no-store") != std::string::npos)
+        {
+            return nullptr;
+        }
+        
+        std::optional<HttpCacheEntry> entry = m_cache->Find(url);
+        if (!entry)
+        {
+            return nullptr;
+        }
+        
+        CefRefPtr<CefRequestContext> requestContext = browser ? browser->GetHost()->GetRequestContext() : nullptr;
+        
+        // An expired entry is only worth keeping hold of if the server can confirm it
+        HttpCacheFreshness freshness = HttpCache::GetFreshness(*entry);
+        if (freshness == HttpCacheFreshness::Expired)
+        {
+            if (!HasValidator(*entry))
+            {
+                return nullptr;
+            }
+            
+            return new CachedResourceHandler(m_app, m_cache, std::move(*entry), m_host, requestContext, true);
+        }
+        
+        if (freshness == HttpCacheFreshness::Stale && m_cache->BeginRevalidation(url))
+        {
+            CefRefPtr<RevalidationClient> client = new RevalidationClient(m_app, m_cache, *entry, m_host);
+            client->Start(requestContext);
+        }
+        
+        return new CachedResourceHandler(m_app, m_cache, std::move(*entry), m_host, requestContext, false);
+    }
+    
+    CefRefPtr<CefResponseFilter> GetResourceResponseFilter(
+        CefRefPtr<CefBrowser> browser,
+        CefRefPtr<CefFrame> frame,
+        CefRefPtr<CefRequest> request,
+        CefRefPtr<CefResponse> response) override
+    {
+        // Only reached for network responses; cached ones come from our own handler
+        if (response->GetStatus() != 200)
+        {
+            return nullptr;
+        }
+        
+        m_filter = new CacheResponseFilter();
+        return m_filter;
+    }
+    
+    void OnResourceLoadComplete(
+        CefRefPtr<CefBrowser> browser,
+        CefRefPtr<CefFrame> frame,
+        CefRefPtr<CefRequest> request,
+        CefRefPtr<CefResponse> response,
+        URLRequestStatus status,
+        int64 received_content_length) override
+    {
+        if (!m_filter || status != UR_SUCCESS)
+        {
+            return;
+        }
+        
+        std::string body;
+        HttpCacheEntry entry;
+        if (m_filter->TakeBody(body) && BuildEntry(request->GetURL().ToString(), response, m_host, entry))
+        {
+            StoreAsync(m_app, m_cache, std::move(entry), std::move(body));
+        }
+        
+        m_filter = nullptr;
+    }
+
+private:
+    IMPLEMENT_REFCOUNTING(CacheResourceRequestHandler);
+    
+    Application& m_app;                             ///< Reference to the main application
+    std::shared_ptr<HttpCache> m_cache;             ///< Response cache
+    const CachedHostPolicy& m_host;                 ///< Policy of the request's host
+    CefRefPtr<CacheResponseFilter> m_filter;        ///< Filter capturing the network body, if any
+};
+
+} // namespace
+
+CachingRequestHandler::CachingRequestHandler(Application& app, std::shared_ptr<HttpCache> cache)
+    : m_app(app)
+    , m_cache(std::move(cache))
+{
+}
+
+CefRefPtr<CefResourceRequestHandler> CachingRequestHandler::GetResourceRequestHandler(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefRefPtr<CefRequest> request,
+    bool is_navigation,
+    bool is_download,
+    const CefString& request_initiator,
+    bool& disable_default_handling)
+{
+    if (is_download || request->GetMethod().ToString() != "GET")
+    {
+        return nullptr;
+    }
+    
+    const CachedHostPolicy* policy = FindPolicy(request->GetURL().ToString());
+    if (!policy)
+    {
+        return nullptr;
+    }
+    
+    return new CacheResourceRequestHandler(m_app, m_cache, *policy);
+}
+
+const CachedHostPolicy* CachingRequestHandler::FindPolicy(const std::string& url)
+{
+    CefURLParts parts;
+    if (!CefParseURL(url, parts) || CefString(&parts.scheme).ToString() != "https")
+    {
+        return nullptr;
+    }
+    
+    std::string host = CefString(&parts.host).ToString();
+    std::string path = CefString(&parts.path).ToString();
+    
+    for (const CachedHostPolicy& policy : kCachedHosts)
+    {
+        if (host == policy.host && std::string_view(path).substr(0, policy.pathPrefix.size()) == policy.pathPrefix)
+        {
+            return &policy;
+        }
+    }
+    
+    return nullptr;
+}
+
+} // namespace poe
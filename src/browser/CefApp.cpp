@@ -1,6 +1,7 @@
 #include "browser/CefApp.h"
 #include "browser/CefManager.h"
 #include <iostream>
+#include <string>
 
 namespace poe {
 
@@ -17,17 +18,8 @@ void CefApp::OnBeforeCommandLineProcessing(
     // Note: This is called on all processes (browser, renderer, etc.)
     if (process_type.empty())
     {
-        // This is the browser process
-        // Disable sandbox for simplicity
-        command_line->AppendSwitch("no-sandbox");
-        
-        // Disable GPU acceleration to reduce resource usage
-        command_line->AppendSwitch("disable-gpu");
-        command_line->AppendSwitch("disable-gpu-compositing");
-        
-        // Disable unnecessary features
-        command_line->AppendSwitch("disable-extensions");
-        command_line->AppendSwitch("disable-pinch");
+        // This is the browser process; switches come from the CEF configuration
+        m_cefManager.InitCommandLineArgs(command_line);
     }
 }
 
@@ -52,6 +44,22 @@ void CefApp::OnBeforeChildProcessLaunch(CefRefPtr<CefCommandLine> command_line)
     {
         std::cout << "Launching CEF child process: " << processType << std::endl;
     }
+    
+    // Children lower their own priority on start-up, see cef_subprocess.cpp
+    int priority = m_cefManager.GetConfig().backgroundProcessPriority;
+    if (priority > 0)
+    {
+        command_line->AppendSwitchWithValue("poe-process-priority", std::to_string(priority));
+    }
+    
+    // The process does not exist yet; listeners pick it up shortly after
+    m_cefManager.NotifyChildProcessLaunch();
+}
+
+void CefApp::OnScheduleMessagePumpWork(int64 delay_ms)
+{
+    // Called on any thread when external_message_pump is enabled
+    m_cefManager.ScheduleMessagePumpWork(delay_ms);
 }
 
 void CefApp::OnContextCreated(
@@ -3,22 +3,63 @@
 #include "browser/BrowserClient.h"
 #include "browser/RenderHandler.h"
 #include "browser/CefApp.h"
+#include "browser/CefMessagePump.h"
+#include "browser/CachingRequestHandler.h"
+#include "browser/HttpCache.h"
+#include "browser/MessageBridge.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
 #include "core/Settings.h"
+#include "core/StartupTimeline.h"
 
 #include <filesystem>
 #include <iostream>
+#include <string>
 
 namespace poe {
 
+namespace
+{
+
+/**
+ * @brief Fills the process limits left at their defaults with the low-footprint profile.
+ *
+ * The overlay only ever shows a handful of sites (trade, poe.ninja, the
+ * wiki), so two renderers and a 512 MB V8 heap are plenty, and its child
+ * processes should never compete with the game for CPU time.
+ * @param config The configuration to update.
+ */
+void ApplyLowFootprintProfile(CefManager::CefConfig& config)
+{
+    if (config.rendererProcessLimit <= 0)
+    {
+        config.rendererProcessLimit = 2;
+    }
+    if (config.v8HeapLimitMB <= 0)
+    {
+        config.v8HeapLimitMB = 512;
+    }
+    if (config.backgroundProcessPriority <= 0)
+    {
+        config.backgroundProcessPriority = 1;
+    }
+    config.processPerSite = true;
+}
+
+} // namespace
+
 CefManager::CefManager(Application& app, const CefConfig& config)
     : m_app(app)
     , m_config(config)
     , m_initialized(false)
     , m_running(false)
 {
-    Log(2, "CefManager created");
+    if (m_config.lowFootprint)
+    {
+        ApplyLowFootprintProfile(m_config);
+    }
+
+    Log(2, "CefManager created{}", m_config.lowFootprint ? " with the low-footprint profile" : "");
 }
 
 CefManager::~CefManager()
@@ -101,9 +142,6 @@ bool CefManager::Initialize()
         // Set log severity
         settings.log_severity = static_cast<cef_log_severity_t>(m_config.logSeverity);
         
-        // Set background process priority
-        settings.background_color = m_config.backgroundProcessPriority;
-        
         // Enable offscreen rendering
         settings.windowless_rendering_enabled = m_config.enableOffscreenRendering ? 1 : 0;
         
@@ -113,13 +151,31 @@ bool CefManager::Initialize()
         // Enable persistent preferences
         settings.persist_user_preferences = m_config.persistUserPreferences ? 1 : 0;
         
-        // Settings required for multi-process mode
+        // CEF runs on this thread; with the external pump it tells us when it
+        // needs work instead of being pumped once per update. The pump window
+        // must exist before CefInitialize, which already schedules work.
         settings.multi_threaded_message_loop = false;
         settings.external_message_pump = false;
         
+        if (m_config.externalMessagePump)
+        {
+            m_messagePump = std::make_unique<CefMessagePump>();
+            if (m_messagePump->Initialize())
+            {
+                settings.external_message_pump = true;
+            }
+            else
+            {
+                Log(3, "Failed to create CEF message pump window, falling back to per-update pumping");
+                m_messagePump.reset();
+            }
+        }
+        
         // Initialize CEF
-        Log(2, "Initializing CEF with process type: main");
+        Log(2, "Initializing CEF with process type: main (shared textures: {})",
+            m_config.enableSharedTextures);
         CefInitialize(mainArgs, settings, cefApp, nullptr);
+        StartupTimeline::Mark(StartupMilestone::CefInitialized);
         
         // Create browser handler
         m_browserHandler = std::make_unique<BrowserHandler>(m_app, *this);
@@ -127,6 +183,29 @@ bool CefManager::Initialize()
         // Create render handler
         m_renderHandler = std::make_unique<RenderHandler>(m_app, *this);
         
+        // Create the JS bridge before any browser can send it a query
+        m_messageBridge = std::make_unique<MessageBridge>(m_app);
+        
+        // Create the API response cache
+        if (m_config.enableHttpCache && !m_config.httpCachePath.empty())
+        {
+            m_httpCache = std::make_shared<HttpCache>(m_app);
+            if (m_httpCache->Initialize(m_config.httpCachePath,
+                    static_cast<uint64_t>(m_config.httpCacheMemoryMB) * 1024 * 1024,
+                    static_cast<uint64_t>(m_config.httpCacheDiskMB) * 1024 * 1024))
+            {
+                m_requestHandler = new CachingRequestHandler(m_app, m_httpCache);
+            }
+            else
+            {
+                Log(3, "HTTP cache unavailable, API requests will not be cached");
+                m_httpCache.reset();
+            }
+        }
+        
+        // The browser handler sees navigations; resource requests go on to the cache
+        m_browserHandler->SetResourceRequestHandler(m_requestHandler.get());
+        
         // Create browser client
         m_browserClient = std::make_unique<BrowserClient>(
             m_app, 
@@ -173,13 +252,38 @@ void CefManager::Shutdown()
         m_browsers.clear();
     }
 
+    // Let the pump deliver the close notifications while the handlers still exist
+    if (m_messagePump)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            CefDoMessageLoopWork();
+        }
+    }
+    
     // Release handlers
     m_browserHandler.reset();
     m_renderHandler.reset();
     m_browserClient.reset();
+    m_messageBridge.reset();
 
     // Shut down CEF
     CefShutdown();
+    
+    // CefShutdown may still schedule work; only now stop accepting it
+    if (m_messagePump)
+    {
+        m_messagePump->Shutdown();
+        m_messagePump.reset();
+    }
+    
+    // Persist the cache index once no more responses can arrive
+    m_requestHandler = nullptr;
+    if (m_httpCache)
+    {
+        m_httpCache->Shutdown();
+        m_httpCache.reset();
+    }
 
     m_initialized = false;
     Log(2, "CefManager shutdown complete");
@@ -213,6 +317,9 @@ CefRefPtr<CefBrowser> CefManager::CreateBrowser(
         {
             // Set up for offscreen rendering
             windowInfo.SetAsWindowless(parent);
+            
+            // Deliver frames as shared GPU textures instead of CPU buffers
+            windowInfo.shared_texture_enabled = m_config.enableSharedTextures;
         }
         else if (parent)
         {
@@ -286,14 +393,36 @@ void CefManager::ProcessEvents(bool blocking)
         return;
     }
 
+    // The external pump already runs CEF work when it is due
+    if (m_messagePump)
+    {
+        return;
+    }
+    
     // Process CEF events
     if (blocking)
     {
-        CefDoMessageLoopWork();
+        CefRunMessageLoop();
     }
     else
     {
-        CefRunMessageLoop();
+        CefDoMessageLoopWork();
+    }
+}
+
+void CefManager::ScheduleMessagePumpWork(int64_t delayMs)
+{
+    if (m_messagePump)
+    {
+        m_messagePump->ScheduleWork(delayMs);
+    }
+}
+
+void CefManager::NotifyChildProcessLaunch()
+{
+    if (m_childProcessLaunchCallback)
+    {
+        m_childProcessLaunchCallback();
     }
 }
 
@@ -307,14 +436,39 @@ void CefManager::InitCommandLineArgs(CefRefPtr<CefCommandLine> args)
     // Disable sandbox for simplicity
     args->AppendSwitch("no-sandbox");
     
-    // Disable GPU acceleration to reduce resource usage
-    args->AppendSwitch("disable-gpu");
-    args->AppendSwitch("disable-gpu-compositing");
+    // Disable GPU acceleration to reduce resource usage, unless frames are
+    // delivered as shared textures which requires GPU compositing
+    if (!m_config.enableSharedTextures)
+    {
+        args->AppendSwitch("disable-gpu");
+        args->AppendSwitch("disable-gpu-compositing");
+    }
     
     // Disable unnecessary features
     args->AppendSwitch("disable-extensions");
     args->AppendSwitch("disable-pinch");
     
+    // Process model: cap the renderer count and keep each site in one process
+    if (m_config.rendererProcessLimit > 0)
+    {
+        args->AppendSwitchWithValue("renderer-process-limit", std::to_string(m_config.rendererProcessLimit));
+    }
+    if (m_config.processPerSite)
+    {
+        args->AppendSwitch("process-per-site");
+    }
+    
+    // Bound the V8 heap; Chromium passes js-flags on to every renderer
+    if (m_config.v8HeapLimitMB > 0)
+    {
+        std::string jsFlags = "--max-old-space-size=" + std::to_string(m_config.v8HeapLimitMB);
+        if (args->HasSwitch("js-flags"))
+        {
+            jsFlags = args->GetSwitchValue("js-flags").ToString() + " " + jsFlags;
+        }
+        args->AppendSwitchWithValue("js-flags", jsFlags);
+    }
+    
     // Set process type for proper subprocess handling
     if (!args->HasSwitch("type"))
     {
@@ -329,29 +483,4 @@ void CefManager::InitCommandLineArgs(CefRefPtr<CefCommandLine> args)
     }
 }
 
-template<typename... Args>
-void CefManager::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try
-    {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "CefManager log error: " << e.what() << std::endl;
-    }
-}
-
 } // namespace poe
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "browser/CefMessagePump.h"
+
+#include <algorithm>
+#include <include/cef_app.h>
+
+namespace poe {
+
+namespace {
+
+// Posted by ScheduleWork; the delay travels in lParam
+constexpr UINT kScheduleWorkMessage = WM_APP + 1;
+
+constexpr UINT_PTR kWorkTimerId = 1;
+
+// Longest CEF may go without being pumped; matches cefclient's external pump
+constexpr int64_t kMaxTimerDelayMs = 1000 / 30;
+
+constexpr wchar_t kWindowClassName[] = L"PoEOverlayCefMessagePump";
+
+} // namespace
+
+CefMessagePump::CefMessagePump()
+    : m_window(nullptr)
+    , m_timerPending(false)
+    , m_isActive(false)
+    , m_reentrancyDetected(false)
+{
+}
+
+CefMessagePump::~CefMessagePump()
+{
+    Shutdown();
+}
+
+bool CefMessagePump::Initialize()
+{
+    if (m_window)
+    {
+        return true;
+    }
+    
+    HINSTANCE instance = GetModuleHandle(nullptr);
+    
+    WNDCLASSEXW windowClass = {};
+    windowClass.cbSize = sizeof(windowClass);
+    windowClass.lpfnWndProc = WindowProc;
+    windowClass.hInstance = instance;
+    windowClass.lpszClassName = kWindowClassName;
+    
+    // Registration fails harmlessly if a previous pump already registered the class
+    RegisterClassExW(&windowClass);
+    
+    HWND window = CreateWindowExW(0, kWindowClassName, L"", 0, 0, 0, 0, 0,
+        HWND_MESSAGE, nullptr, instance, nullptr);
+    if (!window)
+    {
+        return false;
+    }
+    
+    SetWindowLongPtrW(window, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+    m_window = window;
+    return true;
+}
+
+void CefMessagePump::Shutdown()
+{
+    if (!m_window)
+    {
+        return;
+    }
+    
+    KillTimer();
+    
+    HWND window = m_window.exchange(nullptr);
+    SetWindowLongPtrW(window, GWLP_USERDATA, 0);
+    DestroyWindow(window);
+}
+
+void CefMessagePump::ScheduleWork(int64_t delayMs)
+{
+    // May be called on any CEF thread; marshal to the UI thread
+    HWND window = m_window.load();
+    if (window)
+    {
+        PostMessageW(window, kScheduleWorkMessage, 0, static_cast<LPARAM>(delayMs));
+    }
+}
+
+LRESULT CALLBACK CefMessagePump::WindowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    auto* pump = reinterpret_cast<CefMessagePump*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+    if (pump)
+    {
+        switch (message)
+        {
+            case kScheduleWorkMessage:
+                pump->HandleScheduleWork(static_cast<int64_t>(lParam));
+                return 0;
+            
+            case WM_TIMER:
+                if (wParam == kWorkTimerId)
+                {
+                    pump->KillTimer();
+                    pump->DoWork();
+                    return 0;
+                }
+                break;
+        }
+    }
+    
+    return DefWindowProcW(hwnd, message, wParam, lParam);
+}
+
+void CefMessagePump::HandleScheduleWork(int64_t delayMs)
+{
+    if (delayMs <= 0)
+    {
+        // Run now rather than waiting for the timer
+        KillTimer();
+        DoWork();
+    }
+    else
+    {
+        SetTimer(delayMs);
+    }
+}
+
+void CefMessagePump::DoWork()
+{
+    if (PerformMessageLoopWork())
+    {
+        // CEF asked for work while it was already running; go again
+        PostMessageW(m_window, kScheduleWorkMessage, 0, 0);
+    }
+    else if (!m_timerPending)
+    {
+        // Keep CEF ticking even if it forgets to ask
+        SetTimer(kMaxTimerDelayMs);
+    }
+}
+
+bool CefMessagePump::PerformMessageLoopWork()
+{
+    if (m_isActive)
+    {
+        // CefDoMessageLoopWork() can pump Win32 messages and land back here
+        m_reentrancyDetected = true;
+        return false;
+    }
+    
+    m_reentrancyDetected = false;
+    
+    m_isActive = true;
+    CefDoMessageLoopWork();
+    m_isActive = false;
+    
+    return m_reentrancyDetected;
+}
+
+void CefMessagePump::SetTimer(int64_t delayMs)
+{
+    if (!m_window)
+    {
+        return;
+    }
+    
+    // USER_TIMER_MINIMUM is the floor; opting out of coalescing keeps the
+    // timer from drifting by up to a tick in the power-saving direction
+    UINT delay = static_cast<UINT>(std::clamp<int64_t>(delayMs, USER_TIMER_MINIMUM, kMaxTimerDelayMs));
+    m_timerPending = SetCoalescableTimer(m_window, kWorkTimerId, delay, nullptr, TIMERV_NO_COALESCING) != 0;
+}
+
+void CefMessagePump::KillTimer()
+{
+    if (m_timerPending)
+    {
+        ::KillTimer(m_window, kWorkTimerId);
+        m_timerPending = false;
+    }
+}
+
+} // namespace poe
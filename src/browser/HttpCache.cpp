@@ -0,0 +1,590 @@
+#include "browser/HttpCache.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <spdlog/fmt/fmt.h>
+
+namespace poe {
+
+namespace {
+
+constexpr int kIndexVersion = 1;                    ///< Bumped when the index layout changes
+constexpr int64_t kIndexSaveIntervalSeconds = 30;   ///< Minimum spacing of index writes while running
+
+std::string_view Trim(std::string_view value)
+{
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front())))
+    {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back())))
+    {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+        [](char x, char y) { return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y)); });
+}
+
+int64_t ParseSeconds(std::string_view value)
+{
+    int64_t seconds = 0;
+    auto result = std::from_chars(value.data(), value.data() + value.size(), seconds);
+    return result.ec == std::errc() && seconds > 0 ? seconds : 0;
+}
+
+} // namespace
+
+HttpCache::HttpCache(Application& app)
+    : m_app(app)
+    , m_memoryBudget(0)
+    , m_diskBudget(0)
+    , m_initialized(false)
+    , m_diskBytes(0)
+    , m_memoryBytes(0)
+    , m_lastIndexSave(0)
+{
+}
+
+HttpCache::~HttpCache()
+{
+    Shutdown();
+}
+
+bool HttpCache::Initialize(const std::filesystem::path& directory, uint64_t memoryBudget, uint64_t diskBudget)
+{
+    if (m_initialized)
+    {
+        return true;
+    }
+    
+    try
+    {
+        Log(2, "Initializing HttpCache");
+        
+        m_directory = directory;
+        m_memoryBudget = memoryBudget;
+        m_diskBudget = diskBudget;
+        std::filesystem::create_directories(m_directory / "blobs");
+        
+        LoadIndex();
+        m_lastIndexSave = Now();
+        m_initialized = true;
+        
+        Log(2, "HttpCache initialized with {} entries", static_cast<int>(m_entries.size()));
+        return true;
+    }
+    catch (const std::exception& ex)
+    {
+        m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "HttpCache");
+        return false;
+    }
+}
+
+void HttpCache::Shutdown()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+    
+    Log(2, "Shutting down HttpCache");
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SaveIndex();
+    
+    m_memory.clear();
+    m_memoryOrder.clear();
+    m_memoryBytes = 0;
+    m_initialized = false;
+}
+
+std::optional<HttpCacheEntry> HttpCache::Find(const std::string& url)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    auto it = m_entries.find(url);
+    if (it == m_entries.end())
+    {
+        return std::nullopt;
+    }
+    
+    it->second.lastUsed = Now();
+    return it->second;
+}
+
+std::shared_ptr<const std::string> HttpCache::LoadBody(const HttpCacheEntry& entry)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        auto it = m_memory.find(entry.bodyHash);
+        if (it != m_memory.end())
+        {
+            m_memoryOrder.splice(m_memoryOrder.begin(), m_memoryOrder, it->second.position);
+            return it->second.body;
+        }
+    }
+    
+    // Read the blob without holding the lock
+    std::ifstream file(GetBlobPath(entry.bodyHash), std::ios::binary);
+    if (!file)
+    {
+        return nullptr;
+    }
+    
+    std::string body(static_cast<size_t>(entry.bodySize), '\0');
+    if (!file.read(body.data(), static_cast<std::streamsize>(body.size())) || file.peek() != EOF)
+    {
+        Log(3, "Cache blob for {} is truncated or oversized", entry.url);
+        return nullptr;
+    }
+    
+    auto shared = std::make_shared<const std::string>(std::move(body));
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_blobRefs.count(entry.bodyHash) != 0)
+    {
+        Remember(entry.bodyHash, shared);
+    }
+    
+    return shared;
+}
+
+void HttpCache::Store(HttpCacheEntry entry, std::string body)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+    
+    int64_t now = Now();
+    entry.bodyHash = HashBody(body);
+    entry.bodySize = body.size();
+    entry.storedAt = now;
+    entry.lastUsed = now;
+    
+    bool blobExists;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        blobExists = m_blobRefs.count(entry.bodyHash) != 0;
+    }
+    
+    // Content-addressed: a body already on disk is never written twice
+    if (!blobExists)
+    {
+        std::filesystem::path blobPath = GetBlobPath(entry.bodyHash);
+        std::filesystem::path tempPath = blobPath;
+        tempPath += ".tmp";
+        
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.write(body.data(), static_cast<std::streamsize>(body.size())))
+            {
+                Log(3, "Failed to write cache blob for {}", entry.url);
+                return;
+            }
+        }
+        
+        std::error_code ec;
+        std::filesystem::rename(tempPath, blobPath, ec);
+        if (ec)
+        {
+            Log(3, "Failed to commit cache blob for {}: {}", entry.url, ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+    }
+    
+    auto shared = std::make_shared<const std::string>(std::move(body));
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    // Reference the new blob before releasing the old one, in case they are the same
+    uint32_t& refs = m_blobRefs[entry.bodyHash];
+    if (refs++ == 0)
+    {
+        m_diskBytes += entry.bodySize;
+    }
+    
+    auto existing = m_entries.find(entry.url);
+    if (existing != m_entries.end())
+    {
+        EraseEntry(existing);
+    }
+    
+    uint64_t hash = entry.bodyHash;
+    std::string url = entry.url;
+    m_entries.emplace(url, std::move(entry));
+    Remember(hash, std::move(shared));
+    EnforceDiskBudget();
+    
+    if (now - m_lastIndexSave >= kIndexSaveIntervalSeconds)
+    {
+        SaveIndex();
+    }
+    
+    Log(1, "Cached {}", url);
+}
+
+std::optional<HttpCacheEntry> HttpCache::Refresh(
+    const std::string& url,
+    const HttpCachePolicy& policy,
+    const std::vector<std::pair<std::string, std::string>>& headers)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    auto it = m_entries.find(url);
+    if (it == m_entries.end())
+    {
+        return std::nullopt;
+    }
+    
+    HttpCacheEntry& entry = it->second;
+    
+    // Headers sent with a 304 replace the stored ones of the same name
+    for (const auto& [name, value] : headers)
+    {
+        auto stored = std::find_if(entry.headers.begin(), entry.headers.end(),
+            [&name](const auto& header) { return EqualsIgnoreCase(header.first, name); });
+        if (stored != entry.headers.end())
+        {
+            stored->second = value;
+        }
+        else
+        {
+            entry.headers.emplace_back(name, value);
+        }
+        
+        if (EqualsIgnoreCase(name, "ETag"))
+        {
+            entry.etag = value;
+        }
+        else if (EqualsIgnoreCase(name, "Last-Modified"))
+        {
+            entry.lastModified = value;
+        }
+    }
+    
+    int64_t now = Now();
+    entry.policy = policy;
+    entry.storedAt = now;
+    entry.lastUsed = now;
+    
+    return entry;
+}
+
+void HttpCache::Remove(const std::string& url)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    auto it = m_entries.find(url);
+    if (it != m_entries.end())
+    {
+        EraseEntry(it);
+    }
+}
+
+bool HttpCache::BeginRevalidation(const std::string& url)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_revalidating.insert(url).second;
+}
+
+void HttpCache::EndRevalidation(const std::string& url)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_revalidating.erase(url);
+}
+
+HttpCacheFreshness HttpCache::GetFreshness(const HttpCacheEntry& entry)
+{
+    int64_t age = Now() - entry.storedAt;
+    
+    if (age < entry.policy.maxAge)
+    {
+        return HttpCacheFreshness::Fresh;
+    }
+    
+    if (age < entry.policy.maxAge + entry.policy.staleWhileRevalidate)
+    {
+        return HttpCacheFreshness::Stale;
+    }
+    
+    return HttpCacheFreshness::Expired;
+}
+
+HttpCachePolicy HttpCache::ParseCacheControl(std::string_view header)
+{
+    HttpCachePolicy policy;
+    bool noCache = false;
+    
+    while (!header.empty())
+    {
+        size_t separator = header.find(',');
+        std::string_view directive = Trim(header.substr(0, separator));
+        header = separator == std::string_view::npos ? std::string_view() : header.substr(separator + 1);
+        
+        size_t equals = directive.find('=');
+        std::string_view name = Trim(directive.substr(0, equals));
+        std::string_view value = equals == std::string_view::npos ? std::string_view() : Trim(directive.substr(equals + 1));
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+        {
+            value = value.substr(1, value.size() - 2);
+        }
+        
+        if (EqualsIgnoreCase(name, "no-store"))
+        {
+            policy.noStore = true;
+        }
+        else if (EqualsIgnoreCase(name, "no-cache"))
+        {
+            noCache = true;
+        }
+        else if (EqualsIgnoreCase(name, "max-age"))
+        {
+            policy.maxAge = ParseSeconds(value);
+        }
+        else if (EqualsIgnoreCase(name, "stale-while-revalidate"))
+        {
+            policy.staleWhileRevalidate = ParseSeconds(value);
+        }
+    }
+    
+    // no-cache allows storing but every use must be revalidated first
+    if (noCache)
+    {
+        policy.maxAge = 0;
+        policy.staleWhileRevalidate = 0;
+    }
+    
+    return policy;
+}
+
+int64_t HttpCache::Now()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t HttpCache::HashBody(std::string_view body)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : body)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::filesystem::path HttpCache::GetBlobPath(uint64_t hash) const
+{
+    return m_directory / "blobs" / fmt::format("{:016x}", hash);
+}
+
+void HttpCache::Remember(uint64_t hash, std::shared_ptr<const std::string> body)
+{
+    auto it = m_memory.find(hash);
+    if (it != m_memory.end())
+    {
+        m_memoryOrder.splice(m_memoryOrder.begin(), m_memoryOrder, it->second.position);
+        return;
+    }
+    
+    // Bodies larger than the whole budget are only ever served from disk
+    if (body->size() > m_memoryBudget)
+    {
+        return;
+    }
+    
+    m_memoryBytes += body->size();
+    m_memoryOrder.push_front(hash);
+    m_memory.emplace(hash, MemoryEntry{std::move(body), m_memoryOrder.begin()});
+    
+    while (m_memoryBytes > m_memoryBudget && !m_memoryOrder.empty())
+    {
+        auto victim = m_memory.find(m_memoryOrder.back());
+        m_memoryBytes -= victim->second.body->size();
+        m_memory.erase(victim);
+        m_memoryOrder.pop_back();
+    }
+}
+
+void HttpCache::EraseEntry(std::unordered_map<std::string, HttpCacheEntry>::iterator it)
+{
+    uint64_t hash = it->second.bodyHash;
+    uint64_t size = it->second.bodySize;
+    m_entries.erase(it);
+    
+    auto refs = m_blobRefs.find(hash);
+    if (refs == m_blobRefs.end() || --refs->second != 0)
+    {
+        return;
+    }
+    
+    m_blobRefs.erase(refs);
+    m_diskBytes -= size;
+    
+    std::error_code ec;
+    std::filesystem::remove(GetBlobPath(hash), ec);
+    
+    auto memory = m_memory.find(hash);
+    if (memory != m_memory.end())
+    {
+        m_memoryBytes -= memory->second.body->size();
+        m_memoryOrder.erase(memory->second.position);
+        m_memory.erase(memory);
+    }
+}
+
+void HttpCache::EnforceDiskBudget()
+{
+    if (m_diskBytes <= m_diskBudget)
+    {
+        return;
+    }
+    
+    std::vector<std::pair<int64_t, std::string>> byAge;
+    byAge.reserve(m_entries.size());
+    for (const auto& [url, entry] : m_entries)
+    {
+        byAge.emplace_back(entry.lastUsed, url);
+    }
+    std::sort(byAge.begin(), byAge.end());
+    
+    size_t evicted = 0;
+    for (const auto& [lastUsed, url] : byAge)
+    {
+        if (m_diskBytes <= m_diskBudget)
+        {
+            break;
+        }
+        
+        EraseEntry(m_entries.find(url));
+        ++evicted;
+    }
+    
+    Log(1, "Evicted {} cache entries to stay within the disk budget", static_cast<int>(evicted));
+}
+
+void HttpCache::LoadIndex()
+{
+    std::ifstream file(m_directory / "index.json");
+    if (!file)
+    {
+        return;
+    }
+    
+    nlohmann::json index = nlohmann::json::parse(file, nullptr, false);
+    if (index.is_discarded() || index.value("version", 0) != kIndexVersion)
+    {
+        Log(3, "Discarding unreadable HTTP cache index");
+        return;
+    }
+    
+    for (const auto& item : index.value("entries", nlohmann::json::array()))
+    {
+        HttpCacheEntry entry;
+        entry.url = item.value("url", "");
+        entry.status = item.value("status", 200);
+        entry.statusText = item.value("statusText", "");
+        entry.mimeType = item.value("mimeType", "");
+        entry.charset = item.value("charset", "");
+        entry.etag = item.value("etag", "");
+        entry.lastModified = item.value("lastModified", "");
+        entry.bodyHash = item.value("hash", uint64_t{0});
+        entry.bodySize = item.value("size", uint64_t{0});
+        entry.storedAt = item.value("storedAt", int64_t{0});
+        entry.lastUsed = item.value("lastUsed", int64_t{0});
+        entry.policy.maxAge = item.value("maxAge", int64_t{0});
+        entry.policy.staleWhileRevalidate = item.value("staleWhileRevalidate", int64_t{0});
+        
+        for (const auto& header : item.value("headers", nlohmann::json::array()))
+        {
+            entry.headers.emplace_back(header.value("name", ""), header.value("value", ""));
+        }
+        
+        // Skip entries whose blob was deleted behind our back
+        std::error_code ec;
+        if (entry.url.empty() || std::filesystem::file_size(GetBlobPath(entry.bodyHash), ec) != entry.bodySize || ec)
+        {
+            continue;
+        }
+        
+        if (m_blobRefs[entry.bodyHash]++ == 0)
+        {
+            m_diskBytes += entry.bodySize;
+        }
+        
+        std::string url = entry.url;
+        m_entries.emplace(std::move(url), std::move(entry));
+    }
+}
+
+void HttpCache::SaveIndex()
+{
+    nlohmann::json entries = nlohmann::json::array();
+    for (const auto& [url, entry] : m_entries)
+    {
+        nlohmann::json headers = nlohmann::json::array();
+        for (const auto& [name, value] : entry.headers)
+        {
+            headers.push_back({{"name", name}, {"value", value}});
+        }
+        
+        entries.push_back({
+            {"url", entry.url},
+            {"status", entry.status},
+            {"statusText", entry.statusText},
+            {"mimeType", entry.mimeType},
+            {"charset", entry.charset},
+            {"etag", entry.etag},
+            {"lastModified", entry.lastModified},
+            {"headers", std::move(headers)},
+            {"hash", entry.bodyHash},
+            {"size", entry.bodySize},
+            {"storedAt", entry.storedAt},
+            {"lastUsed", entry.lastUsed},
+            {"maxAge", entry.policy.maxAge},
+            {"staleWhileRevalidate", entry.policy.staleWhileRevalidate}
+        });
+    }
+    
+    nlohmann::json index = {{"version", kIndexVersion}, {"entries", std::move(entries)}};
+    
+    std::filesystem::path indexPath = m_directory / "index.json";
+    std::filesystem::path tempPath = m_directory / "index.json.tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        file << index.dump();
+        if (!file)
+        {
+            Log(3, "Failed to write HTTP cache index");
+            return;
+        }
+    }
+    
+    std::error_code ec;
+    std::filesystem::rename(tempPath, indexPath, ec);
+    if (ec)
+    {
+        Log(3, "Failed to commit HTTP cache index: {}", ec.message());
+        return;
+    }
+    
+    m_lastIndexSave = Now();
+}
+
+} // namespace poe
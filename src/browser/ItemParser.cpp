@@ -0,0 +1,211 @@
+#include "browser/ItemParser.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace poe {
+
+namespace {
+
+constexpr std::string_view kSectionSeparator = "--------";
+constexpr std::string_view kSuperiorPrefix = "Superior ";
+
+/// Printed rarity names, in ItemRarity order after Unknown
+constexpr std::array<std::pair<std::string_view, ItemRarity>, 7> kRarities = {{
+    { "Normal", ItemRarity::Normal },
+    { "Magic", ItemRarity::Magic },
+    { "Rare", ItemRarity::Rare },
+    { "Unique", ItemRarity::Unique },
+    { "Gem", ItemRarity::Gem },
+    { "Currency", ItemRarity::Currency },
+    { "Divination Card", ItemRarity::DivinationCard },
+}};
+
+/**
+ * @brief Splits off the next line, dropping a trailing '\r'.
+ */
+std::string_view NextLine(std::string_view& text)
+{
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+/**
+ * @brief Gets the value of a "key: value" line.
+ * @return True if the line starts with the key.
+ */
+bool MatchProperty(std::string_view line, std::string_view key, std::string_view& value)
+{
+    if (line.size() < key.size() + 2 || line.substr(0, key.size()) != key ||
+        line[key.size()] != ':' || line[key.size() + 1] != ' ')
+    {
+        return false;
+    }
+    value = line.substr(key.size() + 2);
+    return true;
+}
+
+/**
+ * @brief Reads the number a value starts with, e.g. 20 from "+20% (augmented)" or 1234 from "1,234/5,000".
+ */
+unsigned ParseLeadingNumber(std::string_view value)
+{
+    size_t i = 0;
+    if (i < value.size() && value[i] == '+')
+    {
+        ++i;
+    }
+
+    unsigned number = 0;
+    for (; i < value.size(); ++i)
+    {
+        char c = value[i];
+        if (c >= '0' && c <= '9')
+        {
+            number = (std::min)(number * 10 + static_cast<unsigned>(c - '0'), 0xFFFFu);
+        }
+        else if (c != ',')
+        {
+            break;
+        }
+    }
+    return number;
+}
+
+/**
+ * @brief Counts sockets and the largest linked group in a value like "R-G-B B".
+ */
+void ParseSockets(std::string_view value, ParsedItem& item)
+{
+    unsigned sockets = 0;
+    unsigned group = 0;
+    unsigned largest = 0;
+    for (char c : value)
+    {
+        if (c == ' ')
+        {
+            group = 0;
+        }
+        else if (c != '-')
+        {
+            ++sockets;
+            largest = (std::max)(largest, ++group);
+        }
+    }
+    item.sockets = static_cast<uint8_t>(sockets);
+    item.links = static_cast<uint8_t>(largest);
+}
+
+} // namespace
+
+bool ItemParser::Parse(std::string_view text, ParsedItem& item)
+{
+    item = ParsedItem();
+
+    // Header section: item class, rarity and the name lines
+    bool haveRarity = false;
+    std::string_view nameLines[2];
+    size_t nameLineCount = 0;
+    while (!text.empty())
+    {
+        std::string_view line = NextLine(text);
+        if (line == kSectionSeparator)
+        {
+            break;
+        }
+
+        std::string_view value;
+        if (MatchProperty(line, "Item Class", value))
+        {
+            item.itemClass = value;
+        }
+        else if (MatchProperty(line, "Rarity", value))
+        {
+            haveRarity = true;
+            auto rarity = std::find_if(kRarities.begin(), kRarities.end(),
+                [value](const auto& entry) { return entry.first == value; });
+            item.rarity = rarity != kRarities.end() ? rarity->second : ItemRarity::Unknown;
+        }
+        else if (haveRarity && !line.empty() && nameLineCount < 2)
+        {
+            nameLines[nameLineCount++] = line;
+        }
+    }
+
+    if (!haveRarity || nameLineCount == 0)
+    {
+        return false;
+    }
+
+    // Identified rares and uniques print their name above the base type
+    item.name = nameLines[0];
+    item.baseType = nameLines[nameLineCount - 1];
+    if (item.baseType.compare(0, kSuperiorPrefix.size(), kSuperiorPrefix) == 0)
+    {
+        item.baseType.erase(0, kSuperiorPrefix.size());
+        if (nameLineCount == 1)
+        {
+            item.name = item.baseType;
+        }
+    }
+
+    // Property sections; only the first "Level:" of a gem is its level, later ones are requirements
+    bool haveGemLevel = false;
+    while (!text.empty())
+    {
+        std::string_view line = NextLine(text);
+        std::string_view value;
+        if (MatchProperty(line, "Item Level", value))
+        {
+            item.itemLevel = static_cast<uint16_t>(ParseLeadingNumber(value));
+        }
+        else if (MatchProperty(line, "Stack Size", value))
+        {
+            item.stackSize = static_cast<uint16_t>(ParseLeadingNumber(value));
+        }
+        else if (MatchProperty(line, "Quality", value))
+        {
+            item.quality = static_cast<uint8_t>((std::min)(ParseLeadingNumber(value), 0xFFu));
+        }
+        else if (MatchProperty(line, "Sockets", value))
+        {
+            ParseSockets(value, item);
+        }
+        else if (item.rarity == ItemRarity::Gem && !haveGemLevel && MatchProperty(line, "Level", value))
+        {
+            item.gemLevel = static_cast<uint8_t>((std::min)(ParseLeadingNumber(value), 0xFFu));
+            haveGemLevel = true;
+        }
+        else if (line == "Corrupted")
+        {
+            item.corrupted = true;
+        }
+        else if (line == "Unidentified")
+        {
+            item.identified = false;
+        }
+    }
+
+    return true;
+}
+
+const char* ItemParser::RarityToString(ItemRarity rarity)
+{
+    for (const auto& entry : kRarities)
+    {
+        if (entry.second == rarity)
+        {
+            return entry.first.data();
+        }
+    }
+    return "Unknown";
+}
+
+} // namespace poe
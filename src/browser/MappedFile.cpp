@@ -0,0 +1,114 @@
+#include "browser/MappedFile.h"
+
+#include <utility>
+
+namespace poe {
+
+MappedFile::MappedFile()
+    : m_fileHandle(INVALID_HANDLE_VALUE)
+    , m_mappingHandle(nullptr)
+    , m_view(nullptr)
+    , m_size(0)
+    , m_charge(MemoryTag::Resources)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_fileHandle(std::exchange(other.m_fileHandle, INVALID_HANDLE_VALUE))
+    , m_mappingHandle(std::exchange(other.m_mappingHandle, nullptr))
+    , m_view(std::exchange(other.m_view, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_charge(std::move(other.m_charge))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        
+        m_fileHandle = std::exchange(other.m_fileHandle, INVALID_HANDLE_VALUE);
+        m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+        m_view = std::exchange(other.m_view, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_charge = std::move(other.m_charge);
+    }
+    
+    return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+    Close();
+    
+    m_fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(m_fileHandle, &fileSize) ||
+        static_cast<ULONGLONG>(fileSize.QuadPart) > SIZE_MAX)
+    {
+        Close();
+        return false;
+    }
+    
+    // A zero-length file cannot be mapped; serve it as an empty view
+    if (fileSize.QuadPart == 0)
+    {
+        return true;
+    }
+    
+    m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mappingHandle)
+    {
+        Close();
+        return false;
+    }
+    
+    m_view = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!m_view)
+    {
+        Close();
+        return false;
+    }
+    
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_charge.Set(m_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_view)
+    {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    
+    if (m_mappingHandle)
+    {
+        CloseHandle(m_mappingHandle);
+        m_mappingHandle = nullptr;
+    }
+    
+    if (m_fileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_fileHandle);
+        m_fileHandle = INVALID_HANDLE_VALUE;
+    }
+    
+    m_size = 0;
+    m_charge.Set(0);
+}
+
+} // namespace poe
@@ -0,0 +1,209 @@
+#include "browser/MessageBridge.h"
+#include "browser/BridgeProtocol.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+
+#include <algorithm>
+
+namespace poe {
+
+MessageBridge::MessageBridge(Application& app)
+    : m_app(app)
+    , m_router(CefMessageRouterBrowserSide::Create(bridge::GetRouterConfig()))
+    , m_nextBufferToken(1)
+{
+    m_router->AddHandler(this, false);
+    Log(2, "MessageBridge created");
+}
+
+MessageBridge::~MessageBridge()
+{
+    m_router->RemoveHandler(this);
+}
+
+void MessageBridge::RegisterMethod(const std::string& name, MethodHandler handler)
+{
+    m_methods[name] = std::move(handler);
+    Log(1, "Bridge method registered: {}", name);
+}
+
+void MessageBridge::UnregisterMethod(const std::string& name)
+{
+    m_methods.erase(name);
+}
+
+void MessageBridge::Publish(const std::string& topic, const nlohmann::json& value)
+{
+    std::string response;
+    for (const Subscription& subscription : m_subscriptions)
+    {
+        if (subscription.topic == topic)
+        {
+            // Serialized once, and only if someone listens
+            if (response.empty())
+            {
+                response = nlohmann::json{ { "value", value } }.dump();
+            }
+            subscription.callback->Success(response);
+        }
+    }
+}
+
+bool MessageBridge::OnProcessMessageReceived(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefProcessId source_process,
+    CefRefPtr<CefProcessMessage> message)
+{
+    return m_router->OnProcessMessageReceived(browser, frame, source_process, message);
+}
+
+void MessageBridge::OnBeforeClose(CefRefPtr<CefBrowser> browser)
+{
+    m_router->OnBeforeClose(browser);
+    DropSubscriptions(browser->GetIdentifier());
+}
+
+void MessageBridge::OnBeforeBrowse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame)
+{
+    m_router->OnBeforeBrowse(browser, frame);
+}
+
+void MessageBridge::OnRenderProcessTerminated(CefRefPtr<CefBrowser> browser)
+{
+    m_router->OnRenderProcessTerminated(browser);
+    DropSubscriptions(browser->GetIdentifier());
+}
+
+void MessageBridge::DropSubscriptions(int browserId)
+{
+    // The router cancels these too; this keeps Publish off dead callbacks regardless
+    m_subscriptions.erase(std::remove_if(m_subscriptions.begin(), m_subscriptions.end(),
+        [browserId](const Subscription& subscription) { return subscription.browserId == browserId; }),
+        m_subscriptions.end());
+}
+
+bool MessageBridge::OnQuery(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    int64 query_id,
+    const CefString& request,
+    bool persistent,
+    CefRefPtr<Callback> callback)
+{
+    nlohmann::json query = nlohmann::json::parse(request.ToString(), nullptr, false);
+    if (!query.is_object())
+    {
+        callback->Failure(-1, "Malformed bridge request");
+        return true;
+    }
+
+    // Persistent queries are subscriptions, answered by Publish until cancelled
+    if (persistent)
+    {
+        auto topic = query.find("subscribe");
+        if (topic == query.end() || !topic->is_string())
+        {
+            callback->Failure(-1, "Persistent queries must subscribe to a topic");
+            return true;
+        }
+
+        m_subscriptions.push_back({ query_id, browser->GetIdentifier(), topic->get<std::string>(), callback });
+        Log(1, "Bridge query {}: subscribed to {}", query_id, m_subscriptions.back().topic);
+        return true;
+    }
+
+    nlohmann::json response;
+    auto batch = query.find("batch");
+    if (batch != query.end() && batch->is_array())
+    {
+        // Every call of a batch is answered, in order, by one reply
+        nlohmann::json results = nlohmann::json::array();
+        for (const nlohmann::json& call : *batch)
+        {
+            BridgeReply reply = Dispatch(call);
+            results.push_back(EncodeReply(reply, frame));
+        }
+        Log(0, "Bridge query {}: batch of {}", query_id, results.size());
+        response["results"] = std::move(results);
+    }
+    else
+    {
+        BridgeReply reply = Dispatch(query);
+        response = EncodeReply(reply, frame);
+    }
+
+    callback->Success(response.dump());
+    return true;
+}
+
+void MessageBridge::OnQueryCanceled(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, int64 query_id)
+{
+    auto it = std::find_if(m_subscriptions.begin(), m_subscriptions.end(),
+        [query_id](const Subscription& subscription) { return subscription.queryId == query_id; });
+    if (it != m_subscriptions.end())
+    {
+        m_subscriptions.erase(it);
+    }
+}
+
+BridgeReply MessageBridge::Dispatch(const nlohmann::json& call)
+{
+    BridgeReply reply;
+
+    auto method = call.is_object() ? call.find("method") : call.end();
+    if (!call.is_object() || method == call.end() || !method->is_string())
+    {
+        reply.error = "Missing method";
+        return reply;
+    }
+
+    const std::string& name = method->get_ref<const std::string&>();
+    auto it = m_methods.find(name);
+    if (it == m_methods.end())
+    {
+        reply.error = "Unknown method: " + name;
+        return reply;
+    }
+
+    static const nlohmann::json kNoParams = nlohmann::json::object();
+    auto params = call.find("params");
+
+    try
+    {
+        return it->second(params != call.end() ? *params : kNoParams);
+    }
+    catch (const std::exception& ex)
+    {
+        m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "MessageBridge");
+        reply.error = ex.what();
+        return reply;
+    }
+}
+
+nlohmann::json MessageBridge::EncodeReply(BridgeReply& reply, CefRefPtr<CefFrame> frame)
+{
+    if (!reply.error.empty())
+    {
+        return { { "error", std::move(reply.error) } };
+    }
+
+    if (reply.buffer.empty())
+    {
+        return { { "value", std::move(reply.value) } };
+    }
+
+    // The bytes go out as a binary value ahead of the reply, so the
+    // renderer already holds them when the page asks for the token
+    int token = m_nextBufferToken++;
+    CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create(bridge::kBufferMessage);
+    CefRefPtr<CefListValue> args = message->GetArgumentList();
+    args->SetInt(0, token);
+    args->SetBinary(1, CefBinaryValue::Create(reply.buffer.data(), reply.buffer.size()));
+    frame->SendProcessMessage(PID_RENDERER, message);
+
+    reply.buffer.clear();
+    return { { "buffer", token } };
+}
+
+} // namespace poe
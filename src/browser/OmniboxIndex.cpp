@@ -0,0 +1,540 @@
+#include "browser/OmniboxIndex.h"
+
+#include <algorithm>
+
+namespace poe {
+
+namespace {
+
+// Per-field weights, in tenths
+constexpr int kNameWeight = 10;
+constexpr int kTitleWeight = 8;
+constexpr int kUrlWeight = 9;
+constexpr int kFolderWeight = 4;
+
+// Score of one term by where it matched in a field
+constexpr int kSubstringScore = 10;
+constexpr int kWordPrefixScore = 30;
+constexpr int kFieldPrefixScore = 50;
+
+constexpr int kBookmarkBonus = 30;
+constexpr int kVisitBonus = 3;
+constexpr uint32_t kMaxCountedVisits = 10;
+
+/**
+ * @brief Whether a byte is part of a word; non-ASCII bytes always are.
+ */
+bool IsWordChar(unsigned char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+/**
+ * @brief Packs up to three bytes and their count into a gram key.
+ */
+uint32_t MakeGram(std::string_view text, size_t position, size_t length)
+{
+    uint32_t gram = static_cast<uint32_t>(length) << 24;
+    for (size_t i = 0; i < length; ++i)
+    {
+        gram |= static_cast<uint32_t>(static_cast<unsigned char>(text[position + i])) << (16 - 8 * i);
+    }
+    return gram;
+}
+
+/**
+ * @brief Finds the best place a term occurs in a field.
+ * @return kFieldPrefixScore, kWordPrefixScore, kSubstringScore (if allowed) or 0.
+ */
+int MatchField(std::string_view field, std::string_view term, bool allowSubstring)
+{
+    int best = 0;
+    for (size_t pos = field.find(term); pos != std::string_view::npos; pos = field.find(term, pos + 1))
+    {
+        if (pos == 0)
+        {
+            return kFieldPrefixScore;
+        }
+
+        if (!IsWordChar(static_cast<unsigned char>(field[pos - 1])))
+        {
+            best = kWordPrefixScore;
+        }
+        else if (allowSubstring)
+        {
+            best = (std::max)(best, kSubstringScore);
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+OmniboxIndex::OmniboxIndex(size_t historyLimit)
+    : m_historyLimit(historyLimit)
+    , m_historyCount(0)
+    , m_visitClock(0)
+{
+}
+
+void OmniboxIndex::SetHistoryLimit(size_t historyLimit)
+{
+    m_historyLimit = historyLimit;
+    EnforceHistoryLimit();
+}
+
+void OmniboxIndex::AddBookmark(const Bookmark& bookmark)
+{
+    uint32_t id = GetOrCreateEntry(bookmark.url);
+    Entry& entry = m_entries[id];
+
+    UpdatePostings(id, false);
+
+    if (!entry.bookmarked && entry.visitCount > 0)
+    {
+        --m_historyCount;
+    }
+
+    entry.bookmarked = true;
+    entry.name = bookmark.name;
+    entry.folder = bookmark.folder;
+    entry.searchName = Normalize(bookmark.name);
+    entry.searchFolder = Normalize(bookmark.folder);
+
+    UpdatePostings(id, true);
+}
+
+void OmniboxIndex::RemoveBookmark(const std::string& url)
+{
+    auto it = m_urlIndex.find(NormalizeUrl(url));
+    if (it == m_urlIndex.end() || !m_entries[it->second].bookmarked)
+    {
+        return;
+    }
+
+    uint32_t id = it->second;
+    Entry& entry = m_entries[id];
+
+    if (entry.visitCount == 0)
+    {
+        RemoveEntry(id);
+        return;
+    }
+
+    // Keep the page as history
+    UpdatePostings(id, false);
+    entry.bookmarked = false;
+    entry.name.clear();
+    entry.folder.clear();
+    entry.searchName.clear();
+    entry.searchFolder.clear();
+    UpdatePostings(id, true);
+
+    ++m_historyCount;
+    EnforceHistoryLimit();
+}
+
+void OmniboxIndex::RecordVisit(const std::string& url)
+{
+    uint32_t id = GetOrCreateEntry(url);
+    Entry& entry = m_entries[id];
+
+    if (!entry.bookmarked && entry.visitCount == 0)
+    {
+        ++m_historyCount;
+    }
+
+    ++entry.visitCount;
+    entry.lastVisit = ++m_visitClock;
+
+    // Postings are keyed on text only, so a new entry still needs indexing
+    if (entry.visitCount == 1 && !entry.bookmarked)
+    {
+        UpdatePostings(id, true);
+    }
+
+    EnforceHistoryLimit();
+}
+
+void OmniboxIndex::UpdateTitle(const std::string& url, const std::string& title)
+{
+    auto it = m_urlIndex.find(NormalizeUrl(url));
+    if (it == m_urlIndex.end() || m_entries[it->second].pageTitle == title)
+    {
+        return;
+    }
+
+    uint32_t id = it->second;
+    Entry& entry = m_entries[id];
+
+    UpdatePostings(id, false);
+    entry.pageTitle = title;
+    entry.searchTitle = Normalize(title);
+    UpdatePostings(id, true);
+}
+
+void OmniboxIndex::ClearHistory()
+{
+    for (uint32_t id = 0; id < m_entries.size(); ++id)
+    {
+        Entry& entry = m_entries[id];
+        if (!entry.live)
+        {
+            continue;
+        }
+
+        if (!entry.bookmarked)
+        {
+            RemoveEntry(id);
+            continue;
+        }
+
+        UpdatePostings(id, false);
+        entry.pageTitle.clear();
+        entry.searchTitle.clear();
+        entry.visitCount = 0;
+        entry.lastVisit = 0;
+        UpdatePostings(id, true);
+    }
+}
+
+std::vector<OmniboxMatch> OmniboxIndex::Query(std::string_view text, size_t maxResults) const
+{
+    std::vector<OmniboxMatch> matches;
+    if (maxResults == 0)
+    {
+        return matches;
+    }
+
+    // Split into lowercased terms
+    std::string normalized = Normalize(text);
+    std::vector<std::string> terms;
+    size_t start = 0;
+    while (start < normalized.size())
+    {
+        size_t end = normalized.find_first_of(" \t", start);
+        if (end == std::string::npos)
+        {
+            end = normalized.size();
+        }
+        if (end > start)
+        {
+            terms.emplace_back(normalized, start, end - start);
+        }
+        start = end + 1;
+    }
+
+    if (terms.empty())
+    {
+        return matches;
+    }
+
+    // Every term must match, so the rarest gram of any term bounds the candidates
+    const std::vector<uint32_t>* candidates = nullptr;
+    for (const auto& term : terms)
+    {
+        std::vector<uint32_t> grams;
+        if (term.size() >= 3)
+        {
+            for (size_t i = 0; i + 3 <= term.size(); ++i)
+            {
+                grams.push_back(MakeGram(term, i, 3));
+            }
+        }
+        else if (IsWordChar(static_cast<unsigned char>(term[0])))
+        {
+            bool twoChars = term.size() == 2 && IsWordChar(static_cast<unsigned char>(term[1]));
+            grams.push_back(MakeGram(term, 0, twoChars ? 2 : 1));
+        }
+
+        for (uint32_t gram : grams)
+        {
+            auto it = m_postings.find(gram);
+            if (it == m_postings.end())
+            {
+                return matches;
+            }
+            if (!candidates || it->second.size() < candidates->size())
+            {
+                candidates = &it->second;
+            }
+        }
+    }
+
+    // Score the candidates; punctuation-only queries fall back to every entry
+    std::vector<std::pair<int, uint32_t>> scored;
+    auto consider = [&](uint32_t id) {
+        const Entry& entry = m_entries[id];
+        if (!entry.live)
+        {
+            return;
+        }
+
+        int score = ScoreEntry(entry, terms);
+        if (score > 0)
+        {
+            scored.emplace_back(score, id);
+        }
+    };
+
+    if (candidates)
+    {
+        for (uint32_t id : *candidates)
+        {
+            consider(id);
+        }
+    }
+    else
+    {
+        for (uint32_t id = 0; id < m_entries.size(); ++id)
+        {
+            consider(id);
+        }
+    }
+
+    // Higher score first, then the more recently visited
+    size_t count = (std::min)(maxResults, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + static_cast<std::ptrdiff_t>(count), scored.end(),
+        [this](const std::pair<int, uint32_t>& a, const std::pair<int, uint32_t>& b) {
+            if (a.first != b.first)
+            {
+                return a.first > b.first;
+            }
+            return m_entries[a.second].lastVisit > m_entries[b.second].lastVisit;
+        });
+
+    matches.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Entry& entry = m_entries[scored[i].second];
+
+        OmniboxMatch match;
+        match.title = !entry.name.empty() ? entry.name : !entry.pageTitle.empty() ? entry.pageTitle : entry.url;
+        match.url = entry.url;
+        match.folder = entry.folder;
+        match.bookmarked = entry.bookmarked;
+        match.score = scored[i].first;
+        matches.push_back(std::move(match));
+    }
+
+    return matches;
+}
+
+uint32_t OmniboxIndex::GetOrCreateEntry(const std::string& url)
+{
+    std::string key = NormalizeUrl(url);
+    auto it = m_urlIndex.find(key);
+    if (it != m_urlIndex.end())
+    {
+        return it->second;
+    }
+
+    uint32_t id;
+    if (!m_freeEntries.empty())
+    {
+        id = m_freeEntries.back();
+        m_freeEntries.pop_back();
+    }
+    else
+    {
+        id = static_cast<uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    Entry& entry = m_entries[id];
+    entry = Entry();
+    entry.url = url;
+    entry.searchUrl = key;
+    entry.live = true;
+
+    m_urlIndex.emplace(std::move(key), id);
+    return id;
+}
+
+void OmniboxIndex::RemoveEntry(uint32_t id)
+{
+    Entry& entry = m_entries[id];
+
+    UpdatePostings(id, false);
+    m_urlIndex.erase(entry.searchUrl);
+
+    if (!entry.bookmarked)
+    {
+        --m_historyCount;
+    }
+
+    // Release the strings; the slot is reused by the next new URL
+    entry = Entry();
+    m_freeEntries.push_back(id);
+}
+
+void OmniboxIndex::EnforceHistoryLimit()
+{
+    while (m_historyCount > m_historyLimit)
+    {
+        uint32_t oldest = 0;
+        uint64_t oldestVisit = UINT64_MAX;
+        for (uint32_t id = 0; id < m_entries.size(); ++id)
+        {
+            const Entry& entry = m_entries[id];
+            if (entry.live && !entry.bookmarked && entry.lastVisit < oldestVisit)
+            {
+                oldest = id;
+                oldestVisit = entry.lastVisit;
+            }
+        }
+
+        if (oldestVisit == UINT64_MAX)
+        {
+            m_historyCount = 0;
+            return;
+        }
+
+        RemoveEntry(oldest);
+    }
+}
+
+void OmniboxIndex::UpdatePostings(uint32_t id, bool add)
+{
+    const Entry& entry = m_entries[id];
+
+    std::vector<uint32_t> grams;
+    CollectGrams(entry.searchName, grams);
+    CollectGrams(entry.searchTitle, grams);
+    CollectGrams(entry.searchUrl, grams);
+    CollectGrams(entry.searchFolder, grams);
+
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    for (uint32_t gram : grams)
+    {
+        if (add)
+        {
+            auto& ids = m_postings[gram];
+            auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+            if (pos == ids.end() || *pos != id)
+            {
+                ids.insert(pos, id);
+            }
+            continue;
+        }
+
+        auto it = m_postings.find(gram);
+        if (it == m_postings.end())
+        {
+            continue;
+        }
+
+        auto& ids = it->second;
+        auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+        if (pos != ids.end() && *pos == id)
+        {
+            ids.erase(pos);
+        }
+        if (ids.empty())
+        {
+            m_postings.erase(it);
+        }
+    }
+}
+
+int OmniboxIndex::ScoreEntry(const Entry& entry, const std::vector<std::string>& terms) const
+{
+    int score = 0;
+    for (const auto& term : terms)
+    {
+        // Short terms only match word starts; "po" should not match "sport"
+        bool allowSubstring = term.size() >= 3;
+
+        int best = (std::max)({
+            MatchField(entry.searchName, term, allowSubstring) * kNameWeight,
+            MatchField(entry.searchTitle, term, allowSubstring) * kTitleWeight,
+            MatchField(entry.searchUrl, term, allowSubstring) * kUrlWeight,
+            MatchField(entry.searchFolder, term, allowSubstring) * kFolderWeight
+        });
+        if (best == 0)
+        {
+            return 0;
+        }
+
+        score += best / 10;
+    }
+
+    if (entry.bookmarked)
+    {
+        score += kBookmarkBonus;
+    }
+    score += static_cast<int>((std::min)(entry.visitCount, kMaxCountedVisits)) * kVisitBonus;
+
+    // Prefer the site root over deep links that match equally well
+    score -= static_cast<int>((std::min<size_t>)(entry.searchUrl.size(), 256) / 16);
+
+    return (std::max)(score, 1);
+}
+
+std::string OmniboxIndex::Normalize(std::string_view text)
+{
+    std::string result(text);
+    for (char& c : result)
+    {
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return result;
+}
+
+std::string OmniboxIndex::NormalizeUrl(std::string_view url)
+{
+    std::string result = Normalize(url);
+
+    for (std::string_view prefix : { std::string_view("https://"), std::string_view("http://") })
+    {
+        if (result.compare(0, prefix.size(), prefix) == 0)
+        {
+            result.erase(0, prefix.size());
+            break;
+        }
+    }
+
+    if (result.compare(0, 4, "www.") == 0)
+    {
+        result.erase(0, 4);
+    }
+
+    while (!result.empty() && result.back() == '/')
+    {
+        result.pop_back();
+    }
+
+    return result;
+}
+
+void OmniboxIndex::CollectGrams(std::string_view field, std::vector<uint32_t>& grams)
+{
+    for (size_t i = 0; i < field.size(); ++i)
+    {
+        if (i + 3 <= field.size())
+        {
+            grams.push_back(MakeGram(field, i, 3));
+        }
+
+        // Word starts also get one- and two-character grams for short queries
+        bool wordStart = IsWordChar(static_cast<unsigned char>(field[i])) &&
+                         (i == 0 || !IsWordChar(static_cast<unsigned char>(field[i - 1])));
+        if (!wordStart)
+        {
+            continue;
+        }
+
+        grams.push_back(MakeGram(field, i, 1));
+        if (i + 1 < field.size() && IsWordChar(static_cast<unsigned char>(field[i + 1])))
+        {
+            grams.push_back(MakeGram(field, i, 2));
+        }
+    }
+}
+
+} // namespace poe
@@ -0,0 +1,686 @@
+#include "browser/PriceChecker.h"
+#include "browser/CefManager.h"
+#include "browser/MessageBridge.h"
+#include "window/input_handler.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+#include "core/WorkerPool.h"
+
+#include <include/cef_parser.h>
+#include <include/cef_urlrequest.h>
+#include <iterator>
+#include <thread>
+
+namespace poe {
+
+/**
+ * @brief State of one price refresh, shared by its requests and the worker building the index.
+ */
+struct PriceRefreshState {
+    std::vector<std::string> bodies;                 ///< Response of each overview, empty if it failed
+    size_t pending = 0;                              ///< Overviews still in flight
+    std::vector<CefRefPtr<CefURLRequest>> requests;  ///< Requests in flight; cleared once all are done
+    std::filesystem::path path;                      ///< Index file to build
+    int slot = 0;                                    ///< Slot of that file
+    bool cancelled = false;                          ///< Whether the refresh was abandoned
+    std::shared_ptr<const PriceIndex> built;         ///< Built index, or null if the refresh failed
+    std::atomic<bool> done{false};                   ///< Whether the worker finished; publishes built
+};
+
+namespace {
+
+/// Bridge topic price check results are published to
+constexpr const char* kPriceCheckTopic = "priceCheck";
+
+/// How long the game gets to put the item on the clipboard
+constexpr std::chrono::milliseconds kClipboardTimeout(300);
+
+/// Spacing of clipboard polls while waiting for the game
+constexpr std::chrono::milliseconds kClipboardPollInterval(2);
+
+/// Another process may hold the clipboard open for a moment
+constexpr int kClipboardOpenAttempts = 10;
+
+/// Delay before retrying a refresh that produced no prices
+constexpr std::chrono::minutes kRefreshRetryDelay(5);
+
+/**
+ * @brief One poe.ninja overview: the API endpoint and the item type it lists.
+ */
+struct Overview {
+    const char* endpoint;
+    const char* type;
+};
+
+/// Overviews the index is built from
+constexpr Overview kOverviews[] = {
+    { "currencyoverview", "Currency" },
+    { "currencyoverview", "Fragment" },
+    { "itemoverview", "DivinationCard" },
+    { "itemoverview", "SkillGem" },
+    { "itemoverview", "UniqueWeapon" },
+    { "itemoverview", "UniqueArmour" },
+    { "itemoverview", "UniqueAccessory" },
+    { "itemoverview", "UniqueFlask" },
+    { "itemoverview", "UniqueJewel" },
+    { "itemoverview", "UniqueMap" },
+    { "itemoverview", "Oil" },
+    { "itemoverview", "Essence" },
+    { "itemoverview", "Fossil" },
+    { "itemoverview", "Resonator" },
+    { "itemoverview", "Scarab" },
+    { "itemoverview", "DeliriumOrb" },
+    { "itemoverview", "Incubator" },
+};
+
+int64_t UnixNow()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Makes the game copy the hovered item.
+ *
+ * Ctrl is only pressed and released here if the user is not already
+ * holding it for the hotkey.
+ * @return True if the keys were sent.
+ */
+bool SendCopyKeys()
+{
+    bool controlHeld = (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
+
+    INPUT inputs[4] = {};
+    UINT count = 0;
+    auto addKey = [&](WORD key, bool up) {
+        inputs[count].type = INPUT_KEYBOARD;
+        inputs[count].ki.wVk = key;
+        inputs[count].ki.dwFlags = up ? KEYEVENTF_KEYUP : 0;
+        ++count;
+    };
+
+    if (!controlHeld)
+    {
+        addKey(VK_CONTROL, false);
+    }
+    addKey('C', false);
+    addKey('C', true);
+    if (!controlHeld)
+    {
+        addKey(VK_CONTROL, true);
+    }
+
+    return SendInput(count, inputs, sizeof(INPUT)) == count;
+}
+
+/**
+ * @brief Reads the clipboard as UTF-8.
+ * @return True if the clipboard held text.
+ */
+bool ReadClipboardText(std::string& text)
+{
+    for (int attempt = 0; attempt < kClipboardOpenAttempts; ++attempt)
+    {
+        if (!OpenClipboard(nullptr))
+        {
+            std::this_thread::sleep_for(kClipboardPollInterval);
+            continue;
+        }
+
+        bool read = false;
+        HANDLE data = GetClipboardData(CF_UNICODETEXT);
+        if (const auto* wide = data ? static_cast<const wchar_t*>(GlobalLock(data)) : nullptr)
+        {
+            int size = WideCharToMultiByte(CP_UTF8, 0, wide, -1, nullptr, 0, nullptr, nullptr);
+            if (size > 0)
+            {
+                text.resize(static_cast<size_t>(size) - 1);
+                WideCharToMultiByte(CP_UTF8, 0, wide, -1, text.data(), size, nullptr, nullptr);
+                read = true;
+            }
+            GlobalUnlock(data);
+        }
+
+        CloseClipboard();
+        return read;
+    }
+    return false;
+}
+
+/**
+ * @brief Looks up an item under the name and variant poe.ninja prices it by.
+ */
+std::optional<PriceQuote> LookUp(const PriceIndex& index, const ParsedItem& item)
+{
+    switch (item.rarity)
+    {
+    case ItemRarity::Currency:
+    case ItemRarity::DivinationCard:
+    case ItemRarity::Normal:
+        return index.Find(item.baseType, 0);
+
+    case ItemRarity::Unique:
+        // Unidentified uniques only show their base, which several uniques share
+        if (!item.identified)
+        {
+            return std::nullopt;
+        }
+        return index.Find(item.name, PriceIndex::MakeVariant(item.links, 0, 0, false));
+
+    case ItemRarity::Gem:
+    {
+        // poe.ninja only lists common qualities; fall back to the quality-less price
+        auto quote = index.Find(item.name, PriceIndex::MakeVariant(0, item.gemLevel, item.quality, item.corrupted));
+        if (!quote && item.quality != 0)
+        {
+            quote = index.Find(item.name, PriceIndex::MakeVariant(0, item.gemLevel, 0, item.corrupted));
+        }
+        return quote;
+    }
+
+    default:
+        // Magic and rare items are priced by their mods, which poe.ninja does not cover
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief Adds the lines of one overview response to the index.
+ */
+void AddOverview(PriceIndexWriter& writer, const nlohmann::json& overview)
+{
+    auto lines = overview.find("lines");
+    if (lines == overview.end() || !lines->is_array())
+    {
+        return;
+    }
+
+    for (const nlohmann::json& line : *lines)
+    {
+        std::string name;
+        uint32_t variant = 0;
+        PriceQuote quote;
+        if (line.contains("currencyTypeName"))
+        {
+            name = line.value("currencyTypeName", std::string());
+            quote.chaosValue = line.value("chaosEquivalent", 0.0f);
+            auto receive = line.find("receive");
+            if (receive != line.end() && receive->is_object())
+            {
+                quote.listings = receive->value("listing_count", 0u);
+            }
+        }
+        else
+        {
+            name = line.value("name", std::string());
+            quote.chaosValue = line.value("chaosValue", 0.0f);
+            quote.divineValue = line.value("divineValue", 0.0f);
+            quote.listings = line.value("listingCount", 0u);
+            variant = PriceIndex::MakeVariant(line.value("links", 0u), line.value("gemLevel", 0u),
+                line.value("gemQuality", 0u), line.value("corrupted", false));
+        }
+
+        if (!name.empty() && quote.chaosValue > 0.0f)
+        {
+            writer.Add(name, variant, quote);
+        }
+    }
+}
+
+/**
+ * @brief Builds and opens the index once every overview has arrived. Runs on the worker pool.
+ */
+void BuildIndex(Application& app, PriceRefreshState& state)
+{
+    try
+    {
+        PriceIndexWriter writer;
+        for (const std::string& body : state.bodies)
+        {
+            nlohmann::json overview = nlohmann::json::parse(body, nullptr, false);
+            if (!overview.is_object())
+            {
+                continue;
+            }
+
+            try
+            {
+                AddOverview(writer, overview);
+            }
+            catch (const nlohmann::json::exception& ex)
+            {
+                LogTo(app.TryGetLogger(), 3, "Skipping malformed price overview: {}", ex.what());
+            }
+        }
+
+        if (writer.GetCount() == 0)
+        {
+            LogTo(app.TryGetLogger(), 3, "Price refresh returned no prices");
+        }
+        else if (!writer.Write(state.path, UnixNow()))
+        {
+            LogTo(app.TryGetLogger(), 3, "Failed to write price index {}", state.path.string());
+        }
+        else
+        {
+            auto index = std::make_shared<PriceIndex>();
+            if (index->Open(state.path))
+            {
+                state.built = std::move(index);
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "PriceChecker");
+    }
+
+    state.done.store(true, std::memory_order_release);
+}
+
+/**
+ * @class OverviewRequestClient
+ * @brief Collects one poe.ninja overview and starts the build after the last one.
+ */
+class OverviewRequestClient : public CefURLRequestClient {
+public:
+    OverviewRequestClient(Application& app, std::shared_ptr<PriceRefreshState> state, size_t index)
+        : m_app(app)
+        , m_state(std::move(state))
+        , m_index(index)
+    {
+    }
+
+    void OnRequestComplete(CefRefPtr<CefURLRequest> request) override
+    {
+        CefRefPtr<CefResponse> response = request->GetResponse();
+        if (request->GetRequestStatus() == UR_SUCCESS && response && response->GetStatus() == 200)
+        {
+            m_state->bodies[m_index] = std::move(m_body);
+        }
+
+        if (--m_state->pending > 0 || m_state->cancelled)
+        {
+            return;
+        }
+
+        // Every request is done; release them and build off the UI thread
+        m_state->requests.clear();
+        m_app.GetWorkerPool().Post([&app = m_app, state = m_state]() { BuildIndex(app, *state); });
+    }
+
+    void OnUploadProgress(CefRefPtr<CefURLRequest> request, int64 current, int64 total) override
+    {
+    }
+
+    void OnDownloadProgress(CefRefPtr<CefURLRequest> request, int64 current, int64 total) override
+    {
+    }
+
+    void OnDownloadData(CefRefPtr<CefURLRequest> request, const void* data, size_t data_length) override
+    {
+        m_body.append(static_cast<const char*>(data), data_length);
+    }
+
+    bool GetAuthCredentials(
+        bool isProxy,
+        const CefString& host,
+        int port,
+        const CefString& realm,
+        const CefString& scheme,
+        CefRefPtr<CefAuthCallback> callback) override
+    {
+        return false;
+    }
+
+private:
+    IMPLEMENT_REFCOUNTING(OverviewRequestClient);
+
+    Application& m_app;                                  ///< Reference to the main application
+    std::shared_ptr<PriceRefreshState> m_state;          ///< Refresh this overview belongs to
+    size_t m_index;                                      ///< Position of this overview in kOverviews
+    std::string m_body;                                  ///< Response body received so far
+};
+
+} // namespace
+
+PriceChecker::PriceChecker(Application& app, InputHandler& inputHandler, CefManager& cefManager,
+    const PriceCheckConfig& config)
+    : m_app(app)
+    , m_inputHandler(inputHandler)
+    , m_cefManager(cefManager)
+    , m_config(config)
+    , m_initialized(false)
+    , m_hotkeyId(-1)
+    , m_indexSlot(-1)
+{
+}
+
+PriceChecker::~PriceChecker()
+{
+    Shutdown();
+}
+
+bool PriceChecker::Initialize()
+{
+    if (m_initialized)
+    {
+        return true;
+    }
+
+    try
+    {
+        Log(2, "Initializing PriceChecker");
+
+        if (m_config.indexDirectory.empty())
+        {
+            m_config.indexDirectory = std::filesystem::temp_directory_path() / "PoEOverlay" / "prices";
+        }
+        std::error_code error;
+        std::filesystem::create_directories(m_config.indexDirectory, error);
+
+        // Prices from the last session work until the first refresh lands
+        std::shared_ptr<PriceIndex> newest;
+        for (int slot = 0; slot < 2; ++slot)
+        {
+            auto index = std::make_shared<PriceIndex>();
+            if (index->Open(GetIndexPath(slot)) && (!newest || index->GetBuiltAt() > newest->GetBuiltAt()))
+            {
+                newest = std::move(index);
+                m_indexSlot = slot;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        m_nextRefresh = now;
+        if (newest)
+        {
+            auto age = std::chrono::seconds(UnixNow() - newest->GetBuiltAt());
+            if (age < m_config.refreshInterval)
+            {
+                m_nextRefresh = now + (m_config.refreshInterval - age);
+            }
+            Log(2, "Loaded {} prices from {} minutes ago", newest->GetCount(),
+                std::chrono::duration_cast<std::chrono::minutes>(age).count());
+            m_index.store(std::move(newest), std::memory_order_release);
+        }
+
+        m_hotkeyId = m_inputHandler.RegisterHotkey(m_config.hotkeyModifiers, m_config.hotkeyKey,
+            "Price check", true, [this]() { OnHotkey(); });
+        if (m_hotkeyId < 0)
+        {
+            Log(3, "Price check hotkey {} unavailable",
+                InputHandler::HotkeyToString(m_config.hotkeyModifiers, m_config.hotkeyKey));
+        }
+
+        // Pages can also price pasted text: poe.call("priceCheck.lookup", {text})
+        if (MessageBridge* bridge = m_cefManager.GetMessageBridge())
+        {
+            bridge->RegisterMethod("priceCheck.lookup", [this](const nlohmann::json& params) {
+                BridgeReply reply;
+                PriceCheckResult result;
+                if (CheckItemText(params.value("text", std::string()), result))
+                {
+                    reply.value = ToJson(result);
+                }
+                else
+                {
+                    reply.error = "Not an item";
+                }
+                return reply;
+            });
+        }
+
+        m_initialized = true;
+        Log(2, "PriceChecker initialized");
+        return true;
+    }
+    catch (const std::exception& ex)
+    {
+        m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "PriceChecker");
+        return false;
+    }
+}
+
+void PriceChecker::Shutdown()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    Log(2, "Shutting down PriceChecker");
+
+    if (m_hotkeyId >= 0)
+    {
+        m_inputHandler.UnregisterHotkey(m_hotkeyId);
+        m_hotkeyId = -1;
+    }
+
+    if (MessageBridge* bridge = m_cefManager.GetMessageBridge())
+    {
+        bridge->UnregisterMethod("priceCheck.lookup");
+    }
+
+    // A build already queued finishes on its own; it only touches the shared state
+    if (m_refresh)
+    {
+        m_refresh->cancelled = true;
+        for (const auto& request : m_refresh->requests)
+        {
+            request->Cancel();
+        }
+        m_refresh->requests.clear();
+        m_refresh.reset();
+    }
+
+    if (m_check.valid())
+    {
+        m_check.wait();
+    }
+
+    m_index.store(nullptr, std::memory_order_release);
+    m_indexSlot = -1;
+    m_results.clear();
+
+    m_initialized = false;
+    Log(2, "PriceChecker shutdown complete");
+}
+
+void PriceChecker::Update()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    std::vector<PriceCheckResult> results;
+    {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        results.swap(m_results);
+    }
+
+    MessageBridge* bridge = m_cefManager.GetMessageBridge();
+    for (const PriceCheckResult& result : results)
+    {
+        Log(2, "Price check: {} -> {} ({:.1f} ms)", result.item.name,
+            result.found ? fmt::format("{:.1f}c", result.quote.chaosValue) : std::string("not listed"),
+            result.elapsedMs);
+        if (bridge)
+        {
+            bridge->Publish(kPriceCheckTopic, ToJson(result));
+        }
+    }
+
+    if (m_refresh)
+    {
+        if (m_refresh->done.load(std::memory_order_acquire))
+        {
+            FinishRefresh();
+        }
+    }
+    else if (std::chrono::steady_clock::now() >= m_nextRefresh)
+    {
+        StartRefresh();
+    }
+}
+
+bool PriceChecker::CheckItemText(const std::string& text, PriceCheckResult& result) const
+{
+    auto start = std::chrono::steady_clock::now();
+
+    result = PriceCheckResult();
+    if (!ItemParser::Parse(text, result.item))
+    {
+        return false;
+    }
+
+    if (std::shared_ptr<const PriceIndex> index = m_index.load(std::memory_order_acquire))
+    {
+        result.pricesFrom = index->GetBuiltAt();
+        if (auto quote = LookUp(*index, result.item))
+        {
+            result.found = true;
+            result.quote = *quote;
+        }
+    }
+
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+nlohmann::json PriceChecker::ToJson(const PriceCheckResult& result)
+{
+    const ParsedItem& item = result.item;
+    nlohmann::json json = {
+        { "name", item.name },
+        { "baseType", item.baseType },
+        { "itemClass", item.itemClass },
+        { "rarity", ItemParser::RarityToString(item.rarity) },
+        { "itemLevel", item.itemLevel },
+        { "stackSize", item.stackSize },
+        { "gemLevel", item.gemLevel },
+        { "quality", item.quality },
+        { "links", item.links },
+        { "corrupted", item.corrupted },
+        { "found", result.found },
+        { "pricesFrom", result.pricesFrom },
+        { "elapsedMs", result.elapsedMs }
+    };
+
+    if (result.found)
+    {
+        json["chaosValue"] = result.quote.chaosValue;
+        json["divineValue"] = result.quote.divineValue;
+        json["listings"] = result.quote.listings;
+        json["stackChaosValue"] = result.quote.chaosValue * (std::max)(item.stackSize, static_cast<uint16_t>(1));
+    }
+    return json;
+}
+
+void PriceChecker::OnHotkey()
+{
+    // Key repeat and impatient presses must not queue up copies
+    if (m_check.valid() && m_check.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+
+    auto pressedAt = std::chrono::steady_clock::now();
+    m_check = m_app.GetWorkerPool().Submit([this, pressedAt]() { RunClipboardCheck(pressedAt); });
+}
+
+void PriceChecker::RunClipboardCheck(std::chrono::steady_clock::time_point pressedAt)
+{
+    try
+    {
+        DWORD sequence = GetClipboardSequenceNumber();
+        if (!SendCopyKeys())
+        {
+            Log(3, "Failed to send the copy keys (Error code: {})", GetLastError());
+            return;
+        }
+
+        // The game copies asynchronously; nothing arrives if no item is under the cursor
+        while (GetClipboardSequenceNumber() == sequence)
+        {
+            if (std::chrono::steady_clock::now() - pressedAt >= kClipboardTimeout)
+            {
+                Log(1, "Price check: clipboard unchanged, no item under the cursor");
+                return;
+            }
+            std::this_thread::sleep_for(kClipboardPollInterval);
+        }
+
+        std::string text;
+        if (!ReadClipboardText(text))
+        {
+            Log(3, "Price check: failed to read the clipboard");
+            return;
+        }
+
+        PriceCheckResult result;
+        if (!CheckItemText(text, result))
+        {
+            Log(1, "Price check: clipboard does not hold an item");
+            return;
+        }
+        result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pressedAt).count();
+
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results.push_back(std::move(result));
+    }
+    catch (const std::exception& ex)
+    {
+        m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "PriceChecker");
+    }
+}
+
+void PriceChecker::StartRefresh()
+{
+    auto state = std::make_shared<PriceRefreshState>();
+    state->slot = m_indexSlot == 0 ? 1 : 0;
+    state->path = GetIndexPath(state->slot);
+    state->bodies.resize(std::size(kOverviews));
+    state->pending = std::size(kOverviews);
+
+    std::string league = CefURIEncode(m_config.league, false).ToString();
+    for (size_t i = 0; i < std::size(kOverviews); ++i)
+    {
+        CefRefPtr<CefRequest> request = CefRequest::Create();
+        request->SetURL(fmt::format("https://poe.ninja/api/data/{}?league={}&type={}",
+            kOverviews[i].endpoint, league, kOverviews[i].type));
+        request->SetMethod("GET");
+
+        // Each client holds the state until its request completes
+        state->requests.push_back(CefURLRequest::Create(request, new OverviewRequestClient(m_app, state, i), nullptr));
+    }
+
+    m_refresh = std::move(state);
+    Log(2, "Refreshing {} prices", m_config.league);
+}
+
+void PriceChecker::FinishRefresh()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (m_refresh->built)
+    {
+        Log(2, "Price index refreshed: {} items", m_refresh->built->GetCount());
+        m_index.store(std::move(m_refresh->built), std::memory_order_release);
+        m_indexSlot = m_refresh->slot;
+        m_nextRefresh = now + m_config.refreshInterval;
+    }
+    else
+    {
+        Log(3, "Price refresh failed; keeping the current prices");
+        m_nextRefresh = now + kRefreshRetryDelay;
+    }
+    m_refresh.reset();
+}
+
+std::filesystem::path PriceChecker::GetIndexPath(int slot) const
+{
+    return m_config.indexDirectory / (slot == 0 ? "prices.0.bin" : "prices.1.bin");
+}
+
+} // namespace poe
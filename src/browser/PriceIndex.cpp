@@ -0,0 +1,217 @@
+#include "browser/PriceIndex.h"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace poe {
+
+namespace {
+
+constexpr uint32_t kIndexMagic = 0x58494E50;  // "PNIX"
+constexpr uint32_t kIndexVersion = 1;
+constexpr uint32_t kMinBuckets = 16;
+
+/**
+ * @brief Fixed header at the start of every index file.
+ */
+struct IndexHeader {
+    uint32_t magic;         ///< kIndexMagic
+    uint32_t version;       ///< kIndexVersion
+    uint32_t bucketCount;   ///< Number of hash buckets, a power of two
+    uint32_t count;         ///< Number of items
+    uint32_t namesSize;     ///< Size of the name blob
+    uint32_t reserved;      ///< Always 0
+    int64_t builtAt;        ///< Unix time the prices were fetched
+};
+
+/**
+ * @brief One hash bucket.
+ */
+struct IndexEntry {
+    uint64_t key;           ///< PriceIndex::MakeKey, or 0 for an empty bucket
+    uint32_t variant;       ///< Variant of the item
+    uint32_t nameOffset;    ///< Offset of the name in the blob
+    uint32_t nameLength;    ///< Length of the name
+    float chaosValue;       ///< Price in Chaos Orbs
+    float divineValue;      ///< Price in Divine Orbs
+    uint32_t listings;      ///< Listings the price is based on
+};
+
+static_assert(sizeof(IndexHeader) == 32, "Index header layout is part of the file format");
+static_assert(sizeof(IndexEntry) == 32, "Index entry layout is part of the file format");
+
+} // namespace
+
+void PriceIndexWriter::Add(std::string_view name, uint32_t variant, const PriceQuote& quote)
+{
+    uint64_t key = PriceIndex::MakeKey(name, variant);
+    auto it = m_positions.find(key);
+    if (it == m_positions.end())
+    {
+        m_positions.emplace(key, m_items.size());
+        m_items.push_back({ key, variant, std::string(name), quote });
+        return;
+    }
+
+    // poe.ninja lists some items twice, e.g. relic and regular uniques
+    Item& existing = m_items[it->second];
+    if (existing.variant == variant && existing.name == name && quote.listings > existing.quote.listings)
+    {
+        existing.quote = quote;
+    }
+}
+
+bool PriceIndexWriter::Write(const std::filesystem::path& path, int64_t builtAt) const
+{
+    uint32_t bucketCount = kMinBuckets;
+    while (bucketCount < m_items.size() * 2)
+    {
+        bucketCount *= 2;
+    }
+
+    std::vector<IndexEntry> entries(bucketCount);
+    std::string names;
+    for (const Item& item : m_items)
+    {
+        uint32_t bucket = static_cast<uint32_t>(item.key) & (bucketCount - 1);
+        while (entries[bucket].key != 0)
+        {
+            bucket = (bucket + 1) & (bucketCount - 1);
+        }
+
+        IndexEntry& entry = entries[bucket];
+        entry.key = item.key;
+        entry.variant = item.variant;
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint32_t>(item.name.size());
+        entry.chaosValue = item.quote.chaosValue;
+        entry.divineValue = item.quote.divineValue;
+        entry.listings = item.quote.listings;
+        names += item.name;
+    }
+
+    IndexHeader header = {};
+    header.magic = kIndexMagic;
+    header.version = kIndexVersion;
+    header.bucketCount = bucketCount;
+    header.count = static_cast<uint32_t>(m_items.size());
+    header.namesSize = static_cast<uint32_t>(names.size());
+    header.builtAt = builtAt;
+
+    // Temp-and-rename, so a reader never maps half an index
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()),
+            static_cast<std::streamsize>(entries.size() * sizeof(IndexEntry)));
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+        if (!file)
+        {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    return !error;
+}
+
+bool PriceIndex::Open(const std::filesystem::path& path)
+{
+    m_entries = nullptr;
+    m_count = 0;
+    m_builtAt = 0;
+
+    if (!m_file.Open(path))
+    {
+        return false;
+    }
+
+    std::string_view view = m_file.GetView();
+    IndexHeader header = {};
+    if (view.size() < sizeof(header))
+    {
+        m_file.Close();
+        return false;
+    }
+    std::memcpy(&header, view.data(), sizeof(header));
+
+    bool valid = header.magic == kIndexMagic &&
+        header.version == kIndexVersion &&
+        header.bucketCount >= kMinBuckets &&
+        (header.bucketCount & (header.bucketCount - 1)) == 0 &&
+        header.count < header.bucketCount &&
+        view.size() == sizeof(header) + static_cast<uint64_t>(header.bucketCount) * sizeof(IndexEntry) + header.namesSize;
+    if (!valid)
+    {
+        m_file.Close();
+        return false;
+    }
+
+    m_entries = reinterpret_cast<const uint8_t*>(view.data()) + sizeof(header);
+    m_names = view.data() + sizeof(header) + static_cast<size_t>(header.bucketCount) * sizeof(IndexEntry);
+    m_namesSize = header.namesSize;
+    m_bucketMask = header.bucketCount - 1;
+    m_count = header.count;
+    m_builtAt = header.builtAt;
+    return true;
+}
+
+std::optional<PriceQuote> PriceIndex::Find(std::string_view name, uint32_t variant) const
+{
+    if (!m_entries)
+    {
+        return std::nullopt;
+    }
+
+    // The table is never full, so every probe ends at an empty bucket
+    uint64_t key = MakeKey(name, variant);
+    for (uint32_t bucket = static_cast<uint32_t>(key) & m_bucketMask;; bucket = (bucket + 1) & m_bucketMask)
+    {
+        const auto* entry = reinterpret_cast<const IndexEntry*>(m_entries + bucket * sizeof(IndexEntry));
+        if (entry->key == 0)
+        {
+            return std::nullopt;
+        }
+
+        // Names are compared as well, so a 64-bit collision cannot return the wrong price
+        if (entry->key == key && entry->variant == variant &&
+            entry->nameOffset <= m_namesSize && entry->nameLength <= m_namesSize - entry->nameOffset &&
+            std::string_view(m_names + entry->nameOffset, entry->nameLength) == name)
+        {
+            return PriceQuote{ entry->chaosValue, entry->divineValue, entry->listings };
+        }
+    }
+}
+
+uint32_t PriceIndex::MakeVariant(unsigned links, unsigned gemLevel, unsigned gemQuality, bool corrupted)
+{
+    return ((links >= 5 ? links : 0) & 0xFF) << 24 |
+        (gemLevel & 0xFF) << 16 |
+        (gemQuality & 0xFF) << 8 |
+        (corrupted ? 1u : 0u);
+}
+
+uint64_t PriceIndex::MakeKey(std::string_view name, uint32_t variant)
+{
+    // FNV-1a over the name, then the variant mixed in
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (char c : name)
+    {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+    }
+    hash ^= variant * 0x9E3779B97F4A7C15ull;
+    hash ^= hash >> 29;
+    return hash != 0 ? hash : 1;
+}
+
+} // namespace poe
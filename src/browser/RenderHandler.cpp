@@ -1,8 +1,13 @@
 #include "browser/RenderHandler.h"
 #include "browser/CefManager.h"
+#include "browser/BrowserView.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
+#include "core/TraceRing.h"
+#include "core/StartupTimeline.h"
 
+#include <cmath>
 #include <iostream>
 
 namespace poe {
@@ -46,6 +51,54 @@ void RenderHandler::Resize(CefRefPtr<CefBrowser> browser, int width, int height)
     browser->GetHost()->WasResized();
 }
 
+void RenderHandler::SetScaleFactor(CefRefPtr<CefBrowser> browser, float scaleFactor)
+{
+    if (!browser || scaleFactor <= 0.0f)
+    {
+        return;
+    }
+
+    int browserId = browser->GetIdentifier();
+    
+    {
+        std::lock_guard<std::mutex> lock(m_viewportsMutex);
+        
+        ViewportInfo& info = m_viewports[browserId];
+        if (info.scaleFactor == scaleFactor)
+        {
+            return;
+        }
+        
+        info.scaleFactor = scaleFactor;
+    }
+    
+    Log(2, "Browser {} scale factor set to {}", browserId, scaleFactor);
+    
+    // The DIP view size changes with the scale, so both notifications are needed
+    browser->GetHost()->NotifyScreenInfoChanged();
+    browser->GetHost()->WasResized();
+}
+
+void RenderHandler::RegisterView(int browserId, BrowserView* view)
+{
+    std::lock_guard<std::mutex> lock(m_viewsMutex);
+    m_views[browserId] = view;
+}
+
+void RenderHandler::UnregisterView(int browserId)
+{
+    std::lock_guard<std::mutex> lock(m_viewsMutex);
+    m_views.erase(browserId);
+}
+
+BrowserView* RenderHandler::FindView(int browserId)
+{
+    std::lock_guard<std::mutex> lock(m_viewsMutex);
+    
+    auto it = m_views.find(browserId);
+    return it != m_views.end() ? it->second : nullptr;
+}
+
 bool RenderHandler::GetViewportSize(int browserId, int& width, int& height)
 {
     std::lock_guard<std::mutex> lock(m_viewportsMutex);
@@ -61,6 +114,28 @@ bool RenderHandler::GetViewportSize(int browserId, int& width, int& height)
     return false;
 }
 
+bool RenderHandler::GetViewport(int browserId, ViewportInfo& info)
+{
+    std::lock_guard<std::mutex> lock(m_viewportsMutex);
+    
+    auto it = m_viewports.find(browserId);
+    if (it == m_viewports.end())
+    {
+        return false;
+    }
+    
+    info = it->second;
+    return true;
+}
+
+CefRect RenderHandler::GetViewRectInDips(const ViewportInfo& info)
+{
+    // Round up so the painted buffer always covers the surface
+    return CefRect(0, 0,
+        static_cast<int>(std::ceil(info.width / info.scaleFactor)),
+        static_cast<int>(std::ceil(info.height / info.scaleFactor)));
+}
+
 bool RenderHandler::GetRootScreenRect(CefRefPtr<CefBrowser> browser, CefRect& rect)
 {
     if (!browser)
@@ -68,10 +143,10 @@ bool RenderHandler::GetRootScreenRect(CefRefPtr<CefBrowser> browser, CefRect& re
         return false;
     }
 
-    int width = 0, height = 0;
-    if (GetViewportSize(browser->GetIdentifier(), width, height))
+    ViewportInfo info;
+    if (GetViewport(browser->GetIdentifier(), info))
     {
-        rect.Set(0, 0, width, height);
+        rect = GetViewRectInDips(info);
         return true;
     }
     
@@ -86,10 +161,10 @@ void RenderHandler::GetViewRect(CefRefPtr<CefBrowser> browser, CefRect& rect)
         return;
     }
 
-    int width = 800, height = 600;  // Default size
-    GetViewportSize(browser->GetIdentifier(), width, height);
+    ViewportInfo info;  // Default size
+    GetViewport(browser->GetIdentifier(), info);
     
-    rect.Set(0, 0, width, height);
+    rect = GetViewRectInDips(info);
 }
 
 bool RenderHandler::GetScreenPoint(
@@ -99,22 +174,31 @@ bool RenderHandler::GetScreenPoint(
     int& screenX,
     int& screenY)
 {
-    // In offscreen rendering, view coordinates are screen coordinates
-    screenX = viewX;
-    screenY = viewY;
+    // View coordinates are DIPs; the overlay's screen works in device pixels
+    ViewportInfo info;
+    if (browser)
+    {
+        GetViewport(browser->GetIdentifier(), info);
+    }
+    
+    screenX = static_cast<int>(std::lround(viewX * info.scaleFactor));
+    screenY = static_cast<int>(std::lround(viewY * info.scaleFactor));
     return true;
 }
 
 bool RenderHandler::GetScreenInfo(CefRefPtr<CefBrowser> browser, CefScreenInfo& screen_info)
 {
+    if (!browser)
+    {
+        return false;
+    }
+
     // Set up screen info for the browser
-    screen_info.device_scale_factor = 1.0f;
-    
-    // Get viewport size
-    int width = 0, height = 0;
-    if (GetViewportSize(browser->GetIdentifier(), width, height))
+    ViewportInfo info;
+    if (GetViewport(browser->GetIdentifier(), info))
     {
-        screen_info.rect.Set(0, 0, width, height);
+        screen_info.device_scale_factor = info.scaleFactor;
+        screen_info.rect = GetViewRectInDips(info);
         screen_info.available_rect = screen_info.rect;
         return true;
     }
@@ -159,10 +243,43 @@ void RenderHandler::OnPaint(
     int width,
     int height)
 {
-    // For simplicity, just pass the entire buffer to the callback
-    if (m_paintCallback)
+    ScopedPerfTimer timer(m_app.GetFrameProfiler(), PerfStage::CefPaint);
+    ScopedTraceEvent trace(m_app.GetTraceRing(), TraceEvent::CefPaint,
+        static_cast<int64_t>(type), static_cast<int64_t>(dirtyRects.size()));
+    StartupTimeline::Mark(StartupMilestone::FirstPaint);
+    
+    // Popups are painted into their own buffer; only the view is composited
+    if (type != PET_VIEW)
+    {
+        return;
+    }
+    
+    // Forward the dirty rectangles so the view only uploads what changed
+    if (BrowserView* view = FindView(browser->GetIdentifier()))
+    {
+        view->OnPaint(dirtyRects, buffer, width, height);
+    }
+}
+
+void RenderHandler::OnAcceleratedPaint(
+    CefRefPtr<CefBrowser> browser,
+    PaintElementType type,
+    const RectList& dirtyRects,
+    void* shared_handle)
+{
+    ScopedTraceEvent trace(m_app.GetTraceRing(), TraceEvent::CefAcceleratedPaint,
+        static_cast<int64_t>(type), static_cast<int64_t>(dirtyRects.size()));
+    StartupTimeline::Mark(StartupMilestone::FirstPaint);
+    
+    // Only called when shared textures are enabled on the window info
+    if (type != PET_VIEW)
+    {
+        return;
+    }
+    
+    if (BrowserView* view = FindView(browser->GetIdentifier()))
     {
-        m_paintCallback(browser, buffer, width, height, 0, 0);
+        view->OnAcceleratedPaint(static_cast<HANDLE>(shared_handle));
     }
 }
 
@@ -199,29 +316,4 @@ void RenderHandler::OnScrollOffsetChanged(CefRefPtr<CefBrowser> browser, double
     // No implementation needed
 }
 
-template<typename... Args>
-void RenderHandler::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try
-    {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "RenderHandler log error: " << e.what() << std::endl;
-    }
-}
-
 } // namespace poe
\ No newline at end of file
@@ -1,10 +1,21 @@
 #include "browser/ResourceHandler.h"
 #include "browser/CefManager.h"
+#include "browser/ResourceBundle.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
+#include "core/MemoryTracker.h"
+#include "core/Settings.h"
+#include "core/WorkerPool.h"
 
 #include <iostream>
 #include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <iterator>
+#include <utility>
 
 namespace poe {
 
@@ -13,6 +24,10 @@ ResourceHandler::ResourceHandler(Application& app, CefManager& cefManager)
     , m_cefManager(cefManager)
     , m_requestComplete(false)
 {
+    // Relative paths resolve against the working directory, like cef.resourcesPath
+    m_assetsRoot = std::filesystem::absolute(
+        m_app.GetSettings().Get<std::string>("browser.assetsPath", "Assets"));
+    
     Log(2, "ResourceHandler created");
 }
 
@@ -24,7 +39,14 @@ bool ResourceHandler::RegisterCustomScheme(const std::string& scheme)
     }
 
     Log(2, "Registering custom scheme: {}", scheme);
-    m_registeredSchemes[scheme] = true;
+    
+    // Kept sorted so requests can be matched without building a key string
+    auto it = std::lower_bound(m_registeredSchemes.begin(), m_registeredSchemes.end(), scheme);
+    if (it == m_registeredSchemes.end() || *it != scheme)
+    {
+        m_registeredSchemes.insert(it, scheme);
+    }
+    
     return true;
 }
 
@@ -33,49 +55,68 @@ bool ResourceHandler::Open(
     bool& handle_request,
     CefRefPtr<CefCallback> callback)
 {
-    // This method is called in CefRequestContextHandler::GetResourceHandler
-    // Process the request immediately
-    return ProcessRequest(request, callback);
-}
-
-bool ResourceHandler::ProcessRequest(
-    CefRefPtr<CefRequest> request,
-    CefRefPtr<CefCallback> callback)
-{
+    // Cancel immediately unless a route below claims the request
+    handle_request = true;
+    
     std::string url = request->GetURL().ToString();
     Log(1, "Processing resource request: {}", url);
     
     // Parse URL to get scheme and path
-    size_t schemeDelimiter = url.find("://");
-    if (schemeDelimiter == std::string::npos)
+    std::string_view urlView = url;
+    size_t schemeDelimiter = urlView.find("://");
+    if (schemeDelimiter == std::string_view::npos)
     {
         Log(3, "Invalid URL format: {}", url);
         return false;
     }
     
-    std::string scheme = url.substr(0, schemeDelimiter);
-    std::string path = url.substr(schemeDelimiter + 3);
+    std::string_view scheme = urlView.substr(0, schemeDelimiter);
+    std::string_view path = urlView.substr(schemeDelimiter + 3);
     
     // Check if we handle this scheme
-    if (m_registeredSchemes.find(scheme) != m_registeredSchemes.end())
+    if (std::binary_search(m_registeredSchemes.begin(), m_registeredSchemes.end(), scheme, std::less<>()))
     {
         // Handle custom scheme
-        if (HandleCustomScheme(request, scheme, path))
-        {
-            callback->Continue();
-            return true;
-        }
+        return HandleCustomScheme(scheme, path, callback, handle_request);
     }
     
     // We don't handle this request
     return false;
 }
 
+bool ResourceHandler::ProcessRequest(
+    CefRefPtr<CefRequest> request,
+    CefRefPtr<CefCallback> callback)
+{
+    // Legacy entry point; asynchronous routes continue the callback themselves
+    bool handleRequest = false;
+    if (!Open(request, handleRequest, callback))
+    {
+        return false;
+    }
+    
+    if (handleRequest)
+    {
+        callback->Continue();
+    }
+    
+    return true;
+}
+
 void ResourceHandler::GetResponseHeaders(
     CefRefPtr<CefResponse> response,
     int64& response_length,
     CefString& redirectUrl)
 {
+    // Collect the result of an asynchronous producer
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        if (m_pendingData)
+        {
+            m_resourceData = std::move(m_pendingData);
+        }
+    }
+    
     if (!m_resourceData)
     {
         response->SetStatus(404);
@@ -86,7 +127,13 @@ void ResourceHandler::GetResponseHeaders(
     
     response->SetStatus(200);
     response->SetStatusText("OK");
-    response->SetMimeType(m_resourceData->mimeType);
+    response->SetMimeType(std::string(m_resourceData->mimeType));
+    
+    // Ranges are served by CEF, not here: for a single-range request its
+    // loader takes the full length reported below, calls Skip() to the
+    // first byte, bounds the read and answers 206 with Content-Range itself.
+    // Slicing the data here as well would skip the range start twice.
+    response->SetHeaderByName("Accept-Ranges", "bytes", true);
     response_length = static_cast<int64>(m_resourceData->data.size());
 }
 
@@ -101,7 +148,8 @@ bool ResourceHandler::Skip(
         return false;
     }
     
-    // Skip bytes in the data
+    // CEF's range support lands here: moving the offset is all a byte
+    // range needs, the views and mappings are random access
     size_t skipAmount = static_cast<size_t>(bytes_to_skip);
     if (skipAmount > m_resourceData->data.size() - m_resourceData->offset)
     {
@@ -155,761 +203,162 @@ bool ResourceHandler::ReadResponse(
 void ResourceHandler::Cancel()
 {
     Log(2, "Resource request cancelled");
+    m_cancelled = true;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingData.reset();
+    }
     m_resourceData.reset();
     m_requestComplete = true;
 }
 
 bool ResourceHandler::HandleCustomScheme(
-    CefRefPtr<CefRequest> request,
-    const std::string& scheme,
-    const std::string& path)
+    std::string_view scheme,
+    std::string_view path,
+    CefRefPtr<CefCallback> callback,
+    bool& handleRequest)
 {
-    Log(1, "Handling custom scheme: {}://{}", scheme, path);
+    Log(1, "Handling custom scheme: {}://{}", std::string(scheme), std::string(path));
     
     // Handle "poe" scheme
-    if (scheme == "poe")
+    if (scheme != "poe")
+    {
+        return false;
+    }
+    
+    // Split off the query string without copying either half
+    std::string_view mainPath = path;
+    std::string_view queryParams;
+    size_t queryPos = path.find('?');
+    if (queryPos != std::string_view::npos)
+    {
+        mainPath = path.substr(0, queryPos);
+        queryParams = path.substr(queryPos + 1);
+    }
+    
+    // Static pages are served straight out of the compiled-in bundle
+    if (const BundledResource* resource = ResourceBundle::Find(mainPath))
     {
-        // Extract path components
-        std::string mainPath = path;
-        std::string queryParams;
-        size_t queryPos = path.find('?');
-        if (queryPos != std::string::npos) {
-            mainPath = path.substr(0, queryPos);
-            queryParams = path.substr(queryPos + 1);
+        m_resourceData = std::make_unique<ResourceData>();
+        m_resourceData->mimeType = resource->mimeType;
+        m_resourceData->data = resource->data;
+        m_resourceData->offset = 0;
+        
+        return true;
+    }
+    
+    // Generated pages, as a table sorted by path. Routes that touch the
+    // disk or take a fresh memory sample (a process-wide query) run on the
+    // worker pool so they cannot stall the IO thread.
+    static constexpr Route routes[] = {
+        { "error",      &ResourceHandler::HandleErrorPage, false },
+        { "perf",       &ResourceHandler::HandlePerfPage,  true },
+        { "perf/dump",  &ResourceHandler::HandlePerfPage,  true },
+        { "perf/reset", &ResourceHandler::HandlePerfPage,  true },
+        { "perf/trace", &ResourceHandler::HandlePerfPage,  true },
+    };
+    static constexpr Route assetsRoute = { "assets/", &ResourceHandler::HandleAssetRequest, true };
+    
+    const Route* route = nullptr;
+    auto it = std::lower_bound(std::begin(routes), std::end(routes), mainPath,
+        [](const Route& entry, std::string_view key) { return entry.path < key; });
+    if (it != std::end(routes) && it->path == mainPath)
+    {
+        route = &*it;
+    }
+    else if (mainPath.substr(0, assetsRoute.path.size()) == assetsRoute.path)
+    {
+        route = &assetsRoute;
+    }
+    
+    if (!route)
+    {
+        // Not handled
+        return false;
+    }
+    
+    if (!route->async)
+    {
+        m_resourceData = (this->*route->handler)(mainPath, queryParams);
+        return m_resourceData != nullptr;
+    }
+    
+    // The views point into the request URL, so the producer gets its own copies
+    RouteHandler handler = route->handler;
+    std::string ownedPath(mainPath);
+    std::string ownedQuery(queryParams);
+    StartAsync([this, handler, ownedPath = std::move(ownedPath), ownedQuery = std::move(ownedQuery)]() {
+        return (this->*handler)(ownedPath, ownedQuery);
+    }, callback);
+    
+    handleRequest = false;
+    return true;
+}
+
+void ResourceHandler::StartAsync(ResourceProducer producer, CefRefPtr<CefCallback> callback)
+{
+    // Hold a reference so the handler outlives a cancelled request's producer
+    CefRefPtr<ResourceHandler> self(this);
+    
+    m_app.GetWorkerPool().Post([self, producer = std::move(producer), callback]() {
+        std::unique_ptr<ResourceData> resourceData;
+        try
+        {
+            resourceData = producer();
+        }
+        catch (const std::exception& ex)
+        {
+            self->m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "ResourceHandler");
         }
         
-        // Handle special poe:// URLs
-        if (mainPath == "home" || mainPath == "")
+        if (self->m_cancelled)
         {
-            // Create resource data for home page
-            m_resourceData = std::make_unique<ResourceData>();
-            m_resourceData->mimeType = "text/html";
-            m_resourceData->data = R"(
-                <!DOCTYPE html>
-                <html>
-                <head>
-                    <title>PoEOverlay Home</title>
-                    <style>
-                        body {
-                            font-family: Arial, sans-serif;
-                            background-color: #2c3e50;
-                            color: #ecf0f1;
-                            margin: 0;
-                            padding: 20px;
-                        }
-                        h1 {
-                            color: #e74c3c;
-                        }
-                        .card {
-                            background-color: #34495e;
-                            border-radius: 5px;
-                            padding: 15px;
-                            margin-bottom: 20px;
-                            box-shadow: 0 4px 8px rgba(0,0,0,0.2);
-                        }
-                        a {
-                            color: #3498db;
-                            text-decoration: none;
-                        }
-                        a:hover {
-                            text-decoration: underline;
-                        }
-                        .quick-links {
-                            display: grid;
-                            grid-template-columns: repeat(auto-fill, minmax(200px, 1fr));
-                            gap: 10px;
-                        }
-                        .quick-link {
-                            padding: 10px;
-                            background-color: #2c3e50;
-                            border-radius: 4px;
-                            transition: background-color 0.2s;
-                        }
-                        .quick-link:hover {
-                            background-color: #243342;
-                        }
-                    </style>
-                </head>
-                <body>
-                    <h1>PoEOverlay</h1>
-                    <div class="card">
-                        <h2>Quick Links</h2>
-                        <div class="quick-links">
-                            <a href="https://www.pathofexile.com" class="quick-link">Official Website</a>
-                            <a href="https://www.pathofexile.com/trade" class="quick-link">Trade Site</a>
-                            <a href="https://www.pathofexile.com/forum" class="quick-link">Forums</a>
-                            <a href="https://poe.ninja" class="quick-link">poe.ninja</a>
-                            <a href="https://poedb.tw" class="quick-link">PoEDB</a>
-                            <a href="https://www.poewiki.net" class="quick-link">Wiki</a>
-                            <a href="https://www.craftofexile.com" class="quick-link">Craft of Exile</a>
-                            <a href="poe://bookmarks" class="quick-link">Bookmarks</a>
-                            <a href="poe://settings" class="quick-link">Settings</a>
-                        </div>
-                    </div>
-                    <div class="card">
-                        <h2>Recent Builds</h2>
-                        <div id="recent-builds">
-                            <p>Your recent build bookmarks will appear here.</p>
-                        </div>
-                    </div>
-                    <div class="card">
-                        <h2>Current League Info</h2>
-                        <div id="league-info">
-                            <p>Loading league information...</p>
-                        </div>
-                    </div>
-                    <script>
-                        // Simple script to populate the recent builds from local storage
-                        document.addEventListener('DOMContentLoaded', function() {
-                            // This would normally be populated from the application's bookmarks
-                            const recentBuildsEl = document.getElementById('recent-builds');
-                            
-                            // Example data - in a real implementation this would come from the app
-                            const recentBuilds = [
-                                { name: "Toxic Rain Pathfinder", url: "https://www.pathofexile.com/forum/view-thread/2866127" },
-                                { name: "Cyclone Slayer", url: "https://www.pathofexile.com/forum/view-thread/2839382" }
-                            ];
-                            
-                            if (recentBuilds.length > 0) {
-                                recentBuildsEl.innerHTML = '';
-                                const ul = document.createElement('ul');
-                                recentBuilds.forEach(build => {
-                                    const li = document.createElement('li');
-                                    const a = document.createElement('a');
-                                    a.href = build.url;
-                                    a.textContent = build.name;
-                                    li.appendChild(a);
-                                    ul.appendChild(li);
-                                });
-                                recentBuildsEl.appendChild(ul);
-                            }
-                            
-                            // Simulate fetching league info
-                            setTimeout(() => {
-                                document.getElementById('league-info').innerHTML = `
-                                    <p><strong>Current League:</strong> Affliction</p>
-                                    <p><strong>End Date:</strong> April 30, 2025</p>
-                                    <p><a href="https://www.pathofexile.com/forum/view-forum/leagues">League Details</a></p>
-                                `;
-                            }, 500);
-                        });
-                    </script>
-                </body>
-                </html>
-            )";
-            m_resourceData->offset = 0;
-            
-            return true;
+            return;
         }
-        else if (mainPath == "settings")
+        
+        bool produced = resourceData != nullptr;
         {
-            // Create resource data for settings page
-            m_resourceData = std::make_unique<ResourceData>();
-            m_resourceData->mimeType = "text/html";
-            m_resourceData->data = R"(
-                <!DOCTYPE html>
-                <html>
-                <head>
-                    <title>PoEOverlay Settings</title>
-                    <style>
-                        body {
-                            font-family: Arial, sans-serif;
-                            background-color: #2c3e50;
-                            color: #ecf0f1;
-                            margin: 0;
-                            padding: 20px;
-                        }
-                        h1 {
-                            color: #e74c3c;
-                        }
-                        .settings-group {
-                            background-color: #34495e;
-                            border-radius: 5px;
-                            padding: 15px;
-                            margin-bottom: 20px;
-                            box-shadow: 0 4px 8px rgba(0,0,0,0.2);
-                        }
-                        label {
-                            display: block;
-                            margin-bottom: 10px;
-                        }
-                        input, select {
-                            margin-left: 10px;
-                            background-color: #2c3e50;
-                            border: 1px solid #3498db;
-                            color: #ecf0f1;
-                            padding: 5px;
-                            border-radius: 3px;
-                        }
-                        button {
-                            background-color: #3498db;
-                            color: white;
-                            border: none;
-                            padding: 8px 16px;
-                            border-radius: 4px;
-                            cursor: pointer;
-                            transition: background-color 0.2s;
-                        }
-                        button:hover {
-                            background-color: #2980b9;
-                        }
-                        .hotkey-box {
-                            display: inline-block;
-                            padding: 5px 10px;
-                            background-color: #2c3e50;
-                            border: 1px solid #3498db;
-                            border-radius: 3px;
-                            margin-left: 10px;
-                            min-width: 80px;
-                            text-align: center;
-                        }
-                        .save-button {
-                            display: block;
-                            margin-top: 20px;
-                            padding: 10px 20px;
-                            background-color: #2ecc71;
-                        }
-                        .save-button:hover {
-                            background-color: #27ae60;
-                        }
-                        a {
-                            color: #3498db;
-                            text-decoration: none;
-                        }
-                        a:hover {
-                            text-decoration: underline;
-                        }
-                        .nav-link {
-                            margin-bottom: 20px;
-                        }
-                    </style>
-                </head>
-                <body>
-                    <div class="nav-link">
-                        <a href="poe://home">← Back to Home</a>
-                    </div>
-                    <h1>PoEOverlay Settings</h1>
-                    <div class="settings-group">
-                        <h2>General</h2>
-                        <label>
-                            Opacity:
-                            <input type="range" min="0.1" max="1.0" step="0.1" value="0.9" id="opacity-slider">
-                            <span id="opacity-value">0.9</span>
-                        </label>
-                        <label>
-                            Start with Windows:
-                            <input type="checkbox" id="start-with-windows">
-                        </label>
-                        <label>
-                            Home Page URL:
-                            <input type="text" value="poe://home" id="homepage-url" style="width: 250px;">
-                        </label>
-                        <label>
-                            Search Engine:
-                            <select id="search-engine">
-                                <option value="https://www.google.com/search?q={}">Google</option>
-                                <option value="https://www.bing.com/search?q={}">Bing</option>
-                                <option value="https://duckduckgo.com/?q={}">DuckDuckGo</option>
-                            </select>
-                        </label>
-                    </div>
-                    <div class="settings-group">
-                        <h2>Hotkeys</h2>
-                        <label>
-                            Toggle Overlay:
-                            <span class="hotkey-box" id="toggle-hotkey">Alt+B</span>
-                            <button id="change-toggle">Change</button>
-                        </label>
-                        <label>
-                            Toggle Interaction Mode:
-                            <span class="hotkey-box" id="interaction-hotkey">Alt+I</span>
-                            <button id="change-interaction">Change</button>
-                        </label>
-                    </div>
-                    <div class="settings-group">
-                        <h2>Performance</h2>
-                        <label>
-                            Suspend browser when hidden:
-                            <input type="checkbox" id="suspend-when-hidden" checked>
-                        </label>
-                        <label>
-                            Throttle rendering when game is active:
-                            <input type="checkbox" id="throttle-when-game-active" checked>
-                        </label>
-                    </div>
-                    <div class="settings-group">
-                        <h2>Privacy</h2>
-                        <label>
-                            Save browsing history:
-                            <input type="checkbox" id="save-history" checked>
-                        </label>
-                        <label>
-                            Save cookies between sessions:
-                            <input type="checkbox" id="save-cookies" checked>
-                        </label>
-                        <label>
-                            <button id="clear-data">Clear Browsing Data</button>
-                        </label>
-                    </div>
-                    <button class="save-button" id="save-settings">Save Settings</button>
-
-                    <script>
-                        // Simple script to handle settings UI interactions
-                        document.addEventListener('DOMContentLoaded', function() {
-                            // Handle opacity slider
-                            const opacitySlider = document.getElementById('opacity-slider');
-                            const opacityValue = document.getElementById('opacity-value');
-                            
-                            opacitySlider.addEventListener('input', function() {
-                                opacityValue.textContent = this.value;
-                            });
-                            
-                            // Mock hotkey change process
-                            const changeButtons = document.querySelectorAll('button[id^="change-"]');
-                            changeButtons.forEach(button => {
-                                button.addEventListener('click', function() {
-                                    const hotkeyId = this.id.replace('change-', '') + '-hotkey';
-                                    const hotkeyBox = document.getElementById(hotkeyId);
-                                    
-                                    hotkeyBox.textContent = 'Press a key...';
-                                    
-                                    // This would normally interface with the native app
-                                    setTimeout(() => {
-                                        hotkeyBox.textContent = hotkeyBox.textContent === 'Press a key...' 
-                                            ? (hotkeyId === 'toggle-hotkey' ? 'Alt+B' : 'Alt+I') 
-                                            : hotkeyBox.textContent;
-                                    }, 2000);
-                                });
-                            });
-                            
-                            // Mock save function
-                            document.getElementById('save-settings').addEventListener('click', function() {
-                                alert('Settings saved!');
-                                // In reality, this would send the settings to the native app
-                            });
-                            
-                            // Mock clear data
-                            document.getElementById('clear-data').addEventListener('click', function() {
-                                if (confirm('Are you sure you want to clear all browsing data?')) {
-                                    alert('Browsing data cleared!');
-                                }
-                            });
-                        });
-                    </script>
-                </body>
-                </html>
-            )";
-            m_resourceData->offset = 0;
-            
-            return true;
+            std::lock_guard<std::mutex> lock(self->m_pendingMutex);
+            self->m_pendingData = std::move(resourceData);
         }
-        else if (mainPath == "bookmarks")
+        
+        // CefCallback may be executed on any thread
+        if (produced)
         {
-            // Create resource data for bookmarks page
-            m_resourceData = std::make_unique<ResourceData>();
-            m_resourceData->mimeType = "text/html";
-            m_resourceData->data = R"(
-                <!DOCTYPE html>
-                <html>
-                <head>
-                    <title>PoEOverlay Bookmarks</title>
-                    <style>
-                        body {
-                            font-family: Arial, sans-serif;
-                            background-color: #2c3e50;
-                            color: #ecf0f1;
-                            margin: 0;
-                            padding: 20px;
-                        }
-                        h1 {
-                            color: #e74c3c;
-                        }
-                        .bookmark-folder {
-                            background-color: #34495e;
-                            border-radius: 5px;
-                            padding: 15px;
-                            margin-bottom: 20px;
-                            box-shadow: 0 4px 8px rgba(0,0,0,0.2);
-                        }
-                        .bookmark-list {
-                            list-style-type: none;
-                            padding: 0;
-                        }
-                        .bookmark-item {
-                            padding: 8px;
-                            border-bottom: 1px solid #2c3e50;
-                            display: flex;
-                            justify-content: space-between;
-                            align-items: center;
-                        }
-                        .bookmark-item:last-child {
-                            border-bottom: none;
-                        }
-                        a {
-                            color: #3498db;
-                            text-decoration: none;
-                        }
-                        a:hover {
-                            text-decoration: underline;
-                        }
-                        .add-button {
-                            display: inline-block;
-                            padding: 8px 16px;
-                            background-color: #2ecc71;
-                            color: white;
-                            border: none;
-                            border-radius: 4px;
-                            cursor: pointer;
-                            transition: background-color 0.2s;
-                        }
-                        .add-button:hover {
-                            background-color: #27ae60;
-                        }
-                        .action-buttons {
-                            display: flex;
-                            gap: 5px;
-                        }
-                        .action-button {
-                            background-color: #3498db;
-                            color: white;
-                            border: none;
-                            padding: 4px 8px;
-                            border-radius: 3px;
-                            cursor: pointer;
-                            font-size: 12px;
-                        }
-                        .action-button.delete {
-                            background-color: #e74c3c;
-                        }
-                        .action-button:hover {
-                            opacity: 0.8;
-                        }
-                        .nav-link {
-                            margin-bottom: 20px;
-                        }
-                        .bookmark-header {
-                            display: flex;
-                            justify-content: space-between;
-                            align-items: center;
-                        }
-                        .folder-actions {
-                            display: flex;
-                            gap: 5px;
-                        }
-                        #bookmark-form {
-                            display: none;
-                            background-color: #2c3e50;
-                            padding: 15px;
-                            border-radius: 5px;
-                            margin-bottom: 20px;
-                        }
-                        .form-group {
-                            margin-bottom: 10px;
-                        }
-                        .form-group label {
-                            display: block;
-                            margin-bottom: 5px;
-                        }
-                        .form-group input, .form-group select {
-                            width: 100%;
-                            padding: 8px;
-                            background-color: #34495e;
-                            border: 1px solid #3498db;
-                            color: #ecf0f1;
-                            border-radius: 3px;
-                        }
-                        .form-buttons {
-                            display: flex;
-                            gap: 10px;
-                            margin-top: 15px;
-                        }
-                    </style>
-                </head>
-                <body>
-                    <div class="nav-link">
-                        <a href="poe://home">← Back to Home</a>
-                    </div>
-                    <h1>Bookmarks</h1>
-                    <button class="add-button" id="show-add-form">Add Bookmark</button>
-                    
-                    <div id="bookmark-form">
-                        <div class="form-group">
-                            <label for="bookmark-name">Name:</label>
-                            <input type="text" id="bookmark-name" placeholder="Enter bookmark name">
-                        </div>
-                        <div class="form-group">
-                            <label for="bookmark-url">URL:</label>
-                            <input type="text" id="bookmark-url" placeholder="Enter URL">
-                        </div>
-                        <div class="form-group">
-                            <label for="bookmark-folder">Folder:</label>
-                            <select id="bookmark-folder">
-                                <option value="Builds">Builds</option>
-                                <option value="Tools">Tools</option>
-                                <option value="Official">Official</option>
-                                <option value="Custom">Custom</option>
-                            </select>
-                        </div>
-                        <div class="form-buttons">
-                            <button class="add-button" id="save-bookmark">Save</button>
-                            <button class="action-button" id="cancel-bookmark">Cancel</button>
-                        </div>
-                    </div>
-                    
-                    <div class="bookmark-folder" id="builds-folder">
-                        <div class="bookmark-header">
-                            <h2>Builds</h2>
-                            <div class="folder-actions">
-                                <button class="action-button" data-folder="Builds">Add to Folder</button>
-                            </div>
-                        </div>
-                        <ul class="bookmark-list" id="builds-list">
-                            <li class="bookmark-item">
-                                <a href="https://www.pathofexile.com/forum/view-thread/1147951">Enki's Arc Witch</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                            <li class="bookmark-item">
-                                <a href="https://www.pathofexile.com/forum/view-thread/2486771">Bleedbow Gladiator</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                        </ul>
-                    </div>
-                    
-                    <div class="bookmark-folder" id="tools-folder">
-                        <div class="bookmark-header">
-                            <h2>Tools</h2>
-                            <div class="folder-actions">
-                                <button class="action-button" data-folder="Tools">Add to Folder</button>
-                            </div>
-                        </div>
-                        <ul class="bookmark-list" id="tools-list">
-                            <li class="bookmark-item">
-                                <a href="https://www.pathofexile.com/trade">Official Trade Site</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                            <li class="bookmark-item">
-                                <a href="https://poe.ninja">poe.ninja</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                            <li class="bookmark-item">
-                                <a href="https://poedb.tw">PoEDB</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                            <li class="bookmark-item">
-                                <a href="https://www.craftofexile.com">Craft of Exile</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                        </ul>
-                    </div>
-                    
-                    <div class="bookmark-folder" id="official-folder">
-                        <div class="bookmark-header">
-                            <h2>Official</h2>
-                            <div class="folder-actions">
-                                <button class="action-button" data-folder="Official">Add to Folder</button>
-                            </div>
-                        </div>
-                        <ul class="bookmark-list" id="official-list">
-                            <li class="bookmark-item">
-                                <a href="https://www.pathofexile.com">Path of Exile</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                            <li class="bookmark-item">
-                                <a href="https://www.pathofexile.com/forum">PoE Forums</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                            <li class="bookmark-item">
-                                <a href="https://www.pathofexile.com/account/view-profile">My Profile</a>
-                                <div class="action-buttons">
-                                    <button class="action-button">Edit</button>
-                                    <button class="action-button delete">Delete</button>
-                                </div>
-                            </li>
-                        </ul>
-                    </div>
-
-                    <script>
-                        // Simple script to handle bookmark UI interactions
-                        document.addEventListener('DOMContentLoaded', function() {
-                            // Show/hide bookmark form
-                            const showFormButton = document.getElementById('show-add-form');
-                            const bookmarkForm = document.getElementById('bookmark-form');
-                            const saveBookmarkButton = document.getElementById('save-bookmark');
-                            const cancelBookmarkButton = document.getElementById('cancel-bookmark');
-                            
-                            showFormButton.addEventListener('click', function() {
-                                bookmarkForm.style.display = 'block';
-                                document.getElementById('bookmark-name').focus();
-                            });
-                            
-                            cancelBookmarkButton.addEventListener('click', function() {
-                                bookmarkForm.style.display = 'none';
-                                // Clear form fields
-                                document.getElementById('bookmark-name').value = '';
-                                document.getElementById('bookmark-url').value = '';
-                            });
-                            
-                            // Add folder buttons
-                            const folderButtons = document.querySelectorAll('[data-folder]');
-                            folderButtons.forEach(button => {
-                                button.addEventListener('click', function() {
-                                    const folder = this.getAttribute('data-folder');
-                                    document.getElementById('bookmark-folder').value = folder;
-                                    bookmarkForm.style.display = 'block';
-                                    document.getElementById('bookmark-name').focus();
-                                });
-                            });
-                            
-                            // Mock saving bookmark
-                            saveBookmarkButton.addEventListener('click', function() {
-                                const name = document.getElementById('bookmark-name').value.trim();
-                                const url = document.getElementById('bookmark-url').value.trim();
-                                const folder = document.getElementById('bookmark-folder').value;
-                                
-                                if (!name || !url) {
-                                    alert('Please enter both name and URL');
-                                    return;
-                                }
-                                
-                                // In a real implementation, this would add the bookmark to the app's storage
-                                alert(`Bookmark added: ${name} - ${url} (${folder})`);
-                                
-                                // Clear and hide form
-                                document.getElementById('bookmark-name').value = '';
-                                document.getElementById('bookmark-url').value = '';
-                                bookmarkForm.style.display = 'none';
-                                
-                                // In a real implementation, the page would refresh or update with the new bookmark
-                            });
-                            
-                            // Mock delete buttons
-                            const deleteButtons = document.querySelectorAll('.action-button.delete');
-                            deleteButtons.forEach(button => {
-                                button.addEventListener('click', function() {
-                                    const bookmarkItem = this.closest('.bookmark-item');
-                                    const bookmarkLink = bookmarkItem.querySelector('a');
-                                    
-                                    if (confirm(`Delete bookmark "${bookmarkLink.textContent}"?`)) {
-                                        // In a real implementation, this would remove the bookmark from storage
-                                        bookmarkItem.remove();
-                                    }
-                                });
-                            });
-                            
-                            // Mock edit buttons
-                            const editButtons = document.querySelectorAll('.action-button:not(.delete)');
-                            editButtons.forEach(button => {
-                                if (button.textContent === 'Edit') {
-                                    button.addEventListener('click', function() {
-                                        const bookmarkItem = this.closest('.bookmark-item');
-                                        const bookmarkLink = bookmarkItem.querySelector('a');
-                                        
-                                        // Populate form with bookmark data
-                                        document.getElementById('bookmark-name').value = bookmarkLink.textContent;
-                                        document.getElementById('bookmark-url').value = bookmarkLink.href;
-                                        
-                                        // Determine folder from parent element
-                                        const folderId = bookmarkItem.closest('.bookmark-folder').id;
-                                        let folder = 'Custom';
-                                        if (folderId === 'builds-folder') folder = 'Builds';
-                                        if (folderId === 'tools-folder') folder = 'Tools';
-                                        if (folderId === 'official-folder') folder = 'Official';
-                                        
-                                        document.getElementById('bookmark-folder').value = folder;
-                                        
-                                        // Show form
-                                        bookmarkForm.style.display = 'block';
-                                        document.getElementById('bookmark-name').focus();
-                                        
-                                        // In a real implementation, we'd mark this as an edit operation
-                                        // rather than an add operation
-                                    });
-                                }
-                            });
-                        });
-                    </script>
-                </body>
-                </html>
-            )";
-            m_resourceData->offset = 0;
-            
-            return true;
+            callback->Continue();
         }
-        else if (mainPath == "error")
+        else
         {
-            // Create resource data for error page
-            m_resourceData = std::make_unique<ResourceData>();
-            m_resourceData->mimeType = "text/html";
-            
-            // Parse error details from query string
-            std::string errorCode = "Unknown";
-            std::string errorMessage = "An unknown error occurred";
-            std::string errorUrl = "";
-            
-            if (!queryParams.empty()) {
-                // Very basic query param parsing - in a real implementation, use a proper parser
-                size_t codePos = queryParams.find("code=");
-                if (codePos != std::string::npos) {
-                    size_t codeEnd = queryParams.find('&', codePos);
-                    errorCode = queryParams.substr(codePos + 5, codeEnd == std::string::npos ? 
-                        std::string::npos : codeEnd - codePos - 5);
-                }
-                
-                size_t msgPos = queryParams.find("message=");
-                if (msgPos != std::string::npos) {
-                    size_t msgEnd = queryParams.find('&', msgPos);
-                    errorMessage = queryParams.substr(msgPos + 8, msgEnd == std::string::npos ? 
-                        std::string::npos : msgEnd - msgPos - 8);
-                    
-                    // Simple URL decoding for spaces
-                    size_t pos = 0;
-                    while ((pos = errorMessage.find("+", pos)) != std::string::npos) {
-                        errorMessage.replace(pos, 1, " ");
-                        pos++;
-                    }
-                }
-                
-                size_t urlPos = queryParams.find("url=");
-                if (urlPos != std::string::npos) {
-                    size_t urlEnd = queryParams.find('&', urlPos);
-                    errorUrl = queryParams.substr(urlPos + 4, urlEnd == std::string::npos ? 
-                        std::string::npos : urlEnd - urlPos - 4);
-                    
-                    // Simple URL decoding for spaces
-                    size_t pos = 0;
-                    while ((pos = errorUrl.find("+", pos)) != std::string::npos) {
-                        errorUrl.replace(pos, 1, " ");
-                        pos++;
-                    }
-                }
-            }
-            
-            // Generate the error page
-            m_resourceData->data = R"(
+            callback->Cancel();
+        }
+    });
+}
+
+std::unique_ptr<ResourceHandler::ResourceData> ResourceHandler::HandleErrorPage(
+    std::string_view mainPath,
+    std::string_view queryParams)
+{
+    // Create resource data for error page
+    auto resourceData = std::make_unique<ResourceData>();
+    resourceData->mimeType = "text/html";
+    
+    // Parse error details from query string
+    std::string errorCode = GetQueryParameter(queryParams, "code");
+    std::string errorMessage = GetQueryParameter(queryParams, "message");
+    std::string errorUrl = GetQueryParameter(queryParams, "url");
+    
+    if (errorCode.empty())
+    {
+        errorCode = "Unknown";
+    }
+    
+    if (errorMessage.empty())
+    {
+        errorMessage = "An unknown error occurred";
+    }
+    
+    // Generate the error page
+    resourceData->storage = R"(
                 <!DOCTYPE html>
                 <html>
                 <head>
@@ -981,15 +430,15 @@ bool ResourceHandler::HandleCustomScheme(
                         <div class="error-code">Error )" + errorCode + R"(</div>
                         <p>)" + errorMessage + R"(</p>
                         )";
-            
-            if (!errorUrl.empty()) {
-                m_resourceData->data += R"(
+    
+    if (!errorUrl.empty()) {
+        resourceData->storage += R"(
                         <p>Failed to load:</p>
                         <div class="error-url">)" + errorUrl + R"(</div>
                         )";
-            }
-            
-            m_resourceData->data += R"(
+    }
+    
+    resourceData->storage += R"(
                         <div class="buttons">
                             <a href=")" + (errorUrl.empty() ? "poe://home" : errorUrl) + R"(" class="button">Try Again</a>
                             <a href="poe://home" class="button">Go Home</a>
@@ -998,68 +447,208 @@ bool ResourceHandler::HandleCustomScheme(
                 </body>
                 </html>
             )";
-            
-            m_resourceData->offset = 0;
-            return true;
+    
+    resourceData->data = resourceData->storage;
+    resourceData->offset = 0;
+    return resourceData;
+}
+
+std::string ResourceHandler::GetQueryParameter(std::string_view query, std::string_view name)
+{
+    while (!query.empty())
+    {
+        size_t separator = query.find('&');
+        std::string_view pair = query.substr(0, separator);
+        query = separator == std::string_view::npos ? std::string_view() : query.substr(separator + 1);
+        
+        if (pair.size() > name.size() && pair[name.size()] == '=' && pair.substr(0, name.size()) == name)
+        {
+            // Simple URL decoding for spaces
+            std::string value(pair.substr(name.size() + 1));
+            std::replace(value.begin(), value.end(), '+', ' ');
+            return value;
         }
     }
     
-    // Not handled
-    return false;
+    return std::string();
 }
 
-std::string ResourceHandler::GetMimeType(const std::string& extension)
+std::unique_ptr<ResourceHandler::ResourceData> ResourceHandler::HandlePerfPage(
+    std::string_view mainPath,
+    std::string_view queryParams)
 {
-    // Common MIME types
-    if (extension == "html" || extension == "htm")
-        return "text/html";
-    else if (extension == "css")
-        return "text/css";
-    else if (extension == "js")
-        return "application/javascript";
-    else if (extension == "json")
-        return "application/json";
-    else if (extension == "png")
-        return "image/png";
-    else if (extension == "jpg" || extension == "jpeg")
-        return "image/jpeg";
-    else if (extension == "gif")
-        return "image/gif";
-    else if (extension == "svg")
-        return "image/svg+xml";
-    else if (extension == "ico")
-        return "image/x-icon";
-    else if (extension == "txt")
-        return "text/plain";
-    else if (extension == "xml")
-        return "application/xml";
-    else
-        return "application/octet-stream";
+    FrameProfiler& profiler = m_app.GetFrameProfiler();
+    MemoryTracker& memory = m_app.GetMemoryTracker();
+    std::string notice;
+    
+    if (mainPath == "perf/reset")
+    {
+        profiler.Reset();
+        memory.ResetPeaks();
+        notice = "Counters reset.";
+    }
+    else if (mainPath == "perf/dump")
+    {
+        // Write next to the log file so it ends up in bug reports with it
+        auto now = std::chrono::system_clock::now().time_since_epoch();
+        auto stamp = std::chrono::duration_cast<std::chrono::seconds>(now).count();
+        std::filesystem::path dumpPath = m_app.GetLogger().GetLogFilePath().parent_path() /
+            ("perf_" + std::to_string(stamp) + ".txt");
+        
+        notice = profiler.DumpToFile(dumpPath)
+            ? "Written to " + dumpPath.string()
+            : "Failed to write " + dumpPath.string();
+    }
+    else if (mainPath == "perf/trace")
+    {
+        // Chrome trace-event JSON; open it in chrome://tracing
+        std::filesystem::path tracePath = m_app.GetErrorHandler().DumpTrace("manual");
+        notice = tracePath.empty()
+            ? "Failed to write event trace."
+            : "Event trace written to " + tracePath.string();
+    }
+    
+    // The sampler thread only runs every few seconds; every perf route is
+    // async, so this runs on the worker pool
+    memory.Sample();
+    
+    auto resourceData = std::make_unique<ResourceData>();
+    resourceData->mimeType = "text/html";
+    resourceData->storage = R"(
+                <!DOCTYPE html>
+                <html>
+                <head>
+                    <title>PoEOverlay - Performance</title>
+                    <style>
+                        body {
+                            font-family: Arial, sans-serif;
+                            background-color: #2c3e50;
+                            color: #ecf0f1;
+                            margin: 0;
+                            padding: 20px;
+                        }
+                        h1 {
+                            color: #e74c3c;
+                        }
+                        .card {
+                            background-color: #34495e;
+                            border-radius: 5px;
+                            padding: 15px;
+                            margin-bottom: 20px;
+                            box-shadow: 0 4px 8px rgba(0,0,0,0.2);
+                        }
+                        pre {
+                            font-family: monospace;
+                            margin: 0;
+                        }
+                        a {
+                            color: #3498db;
+                            text-decoration: none;
+                            margin-right: 15px;
+                        }
+                        a:hover {
+                            text-decoration: underline;
+                        }
+                    </style>
+                </head>
+                <body>
+                    <h1>Frame Timings</h1>
+                    <div class="card">
+                        <pre>)" + profiler.FormatReport() + R"(</pre>
+                    </div>
+                    <h1>Memory</h1>
+                    <div class="card">
+                        <pre>)" + memory.FormatReport() + R"(</pre>
+                    </div>
+                    <p>)" + notice + R"(</p>
+                    <a href="poe://perf">Refresh</a>
+                    <a href="poe://perf/reset">Reset</a>
+                    <a href="poe://perf/dump">Dump to file</a>
+                    <a href="poe://perf/trace">Dump event trace</a>
+                    <a href="poe://home">Home</a>
+                </body>
+                </html>
+            )";
+    resourceData->data = resourceData->storage;
+    resourceData->offset = 0;
+    
+    return resourceData;
 }
 
-template<typename... Args>
-void ResourceHandler::Log(int level, const std::string& fmt, const Args&... args)
+std::unique_ptr<ResourceHandler::ResourceData> ResourceHandler::HandleAssetRequest(
+    std::string_view mainPath,
+    std::string_view queryParams)
 {
-    try
+    // Everything after "assets/"
+    std::string_view relativePath = mainPath.substr(7);
+    
+    std::error_code ec;
+    std::filesystem::path filePath = std::filesystem::weakly_canonical(m_assetsRoot / relativePath, ec);
+    if (ec)
     {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
+        Log(3, "Invalid asset path: {}", std::string(relativePath));
+        return nullptr;
+    }
+    
+    // Refuse anything that resolves outside the assets directory
+    std::filesystem::path rootPath = std::filesystem::weakly_canonical(m_assetsRoot, ec);
+    std::filesystem::path relative = filePath.lexically_relative(rootPath);
+    if (ec || relative.empty() || *relative.begin() == "..")
+    {
+        Log(3, "Asset path outside of assets directory: {}", std::string(relativePath));
+        return nullptr;
+    }
+    
+    auto resourceData = std::make_unique<ResourceData>();
+    if (!resourceData->file.Open(filePath))
+    {
+        Log(3, "Failed to map asset: {}", filePath.string());
+        return nullptr;
     }
-    catch (const std::exception& e)
+    
+    std::string extension = filePath.extension().string();
+    if (!extension.empty())
     {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "ResourceHandler log error: " << e.what() << std::endl;
+        extension.erase(0, 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
     }
+    
+    resourceData->mimeType = GetMimeType(extension);
+    resourceData->data = resourceData->file.GetView();
+    resourceData->offset = 0;
+    
+    Log(1, "Serving asset {} ({} bytes)", filePath.string(), resourceData->data.size());
+    return resourceData;
+}
+
+std::string_view ResourceHandler::GetMimeType(std::string_view extension)
+{
+    // Common MIME types, sorted by extension
+    static constexpr std::pair<std::string_view, std::string_view> mimeTypes[] = {
+        { "css",  "text/css" },
+        { "gif",  "image/gif" },
+        { "htm",  "text/html" },
+        { "html", "text/html" },
+        { "ico",  "image/x-icon" },
+        { "jpeg", "image/jpeg" },
+        { "jpg",  "image/jpeg" },
+        { "js",   "application/javascript" },
+        { "json", "application/json" },
+        { "png",  "image/png" },
+        { "svg",  "image/svg+xml" },
+        { "txt",  "text/plain" },
+        { "xml",  "application/xml" },
+    };
+    
+    auto it = std::lower_bound(std::begin(mimeTypes), std::end(mimeTypes), extension,
+        [](const auto& entry, std::string_view key) { return entry.first < key; });
+    if (it != std::end(mimeTypes) && it->first == extension)
+    {
+        return it->second;
+    }
+    
+    return "application/octet-stream";
 }
 
 } // namespace poe
\ No newline at end of file
@@ -1,10 +1,15 @@
 #include <Windows.h>
 #include <include/cef_app.h>
+#include <include/cef_v8.h>
+#include <include/wrapper/cef_message_router.h>
 #include <iostream>
+#include <unordered_map>
+#include "browser/BridgeProtocol.h"
 
 // Forward declarations
 CefRefPtr<CefApp> CreateRendererApp();
 CefRefPtr<CefApp> CreateOtherApp();
+void ApplyProcessPriority(CefRefPtr<CefCommandLine> command_line);
 
 /**
  * @brief CEF subprocess entry point.
@@ -29,6 +34,9 @@ int APIENTRY wWinMain(HINSTANCE hInstance,
     CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
     command_line->InitFromString(::GetCommandLineW());
 
+    // Step out of the game's way before doing any work
+    ApplyProcessPriority(command_line);
+
     // Determine the process type
     std::string process_type = command_line->GetSwitchValue("type");
     if (process_type == "renderer" || process_type == "zygote") {
@@ -43,40 +51,162 @@ int APIENTRY wWinMain(HINSTANCE hInstance,
     return CefExecuteProcess(main_args, app, nullptr);
 }
 
+/**
+ * @class BridgeBuffers
+ * @brief Binary bridge results waiting for the page to take them.
+ *
+ * The browser sends each payload as a bridge::kBufferMessage just before
+ * the query reply naming its token; TakeBuffer(token) then hands the bytes
+ * to the page as an ArrayBuffer that V8 adopts instead of copying.
+ */
+class BridgeBuffers : public CefV8Handler {
+public:
+    BridgeBuffers() {}
+
+    void Add(int browser_id, int token, CefRefPtr<CefBinaryValue> payload) {
+        m_buffers[browser_id][token] = payload;
+    }
+
+    void Clear(int browser_id) {
+        m_buffers.erase(browser_id);
+    }
+
+    // CefV8Handler methods:
+    bool Execute(const CefString& name,
+                 CefRefPtr<CefV8Value> object,
+                 const CefV8ValueList& arguments,
+                 CefRefPtr<CefV8Value>& retval,
+                 CefString& exception) override {
+        if (name != "TakeBuffer" || arguments.size() != 1 || !arguments[0]->IsInt()) {
+            exception = "TakeBuffer expects a token";
+            return true;
+        }
+
+        int browser_id = CefV8Context::GetCurrentContext()->GetBrowser()->GetIdentifier();
+        auto& pending = m_buffers[browser_id];
+        auto it = pending.find(arguments[0]->GetIntValue());
+        if (it == pending.end()) {
+            exception = "Unknown buffer token";
+            return true;
+        }
+
+        // One copy out of the IPC message; V8 takes ownership of the result
+        size_t size = it->second->GetSize();
+        uint8_t* data = new uint8_t[size];
+        it->second->GetData(data, size, 0);
+        pending.erase(it);
+
+        retval = CefV8Value::CreateArrayBuffer(data, size, new BufferRelease());
+        return true;
+    }
+
+private:
+    class BufferRelease : public CefV8ArrayBufferReleaseCallback {
+    public:
+        void ReleaseBuffer(void* buffer) override {
+            delete[] static_cast<uint8_t*>(buffer);
+        }
+
+    private:
+        IMPLEMENT_REFCOUNTING(BufferRelease);
+    };
+
+    std::unordered_map<int, std::unordered_map<int, CefRefPtr<CefBinaryValue>>> m_buffers;
+
+    IMPLEMENT_REFCOUNTING(BridgeBuffers);
+};
+
 /**
  * @class RendererApp
  * @brief CEF App implementation for renderer processes.
  */
 class RendererApp : public CefApp, public CefRenderProcessHandler {
 public:
-    RendererApp() {}
+    RendererApp() : m_buffers(new BridgeBuffers()) {}
 
     // CefApp methods:
     CefRefPtr<CefRenderProcessHandler> GetRenderProcessHandler() override { return this; }
 
     // CefRenderProcessHandler methods:
+    void OnWebKitInitialized() override {
+        // Install window.poeQuery and the poe.call/poe.batch wrappers around it
+        m_router = CefMessageRouterRendererSide::Create(poe::bridge::GetRouterConfig());
+        CefRegisterExtension("v8/poe", poe::bridge::kExtensionCode, m_buffers);
+    }
+
+    void OnBrowserDestroyed(CefRefPtr<CefBrowser> browser) override {
+        m_buffers->Clear(browser->GetIdentifier());
+    }
+
     void OnContextCreated(CefRefPtr<CefBrowser> browser,
                           CefRefPtr<CefFrame> frame,
                           CefRefPtr<CefV8Context> context) override {
-        // You can inject JavaScript code here if needed
+        m_router->OnContextCreated(browser, frame, context);
+    }
+
+    void OnContextReleased(CefRefPtr<CefBrowser> browser,
+                           CefRefPtr<CefFrame> frame,
+                           CefRefPtr<CefV8Context> context) override {
+        m_router->OnContextReleased(browser, frame, context);
+        if (frame->IsMain()) {
+            // Results the page never took die with it
+            m_buffers->Clear(browser->GetIdentifier());
+        }
     }
 
     bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
                                   CefRefPtr<CefFrame> frame,
                                   CefProcessId source_process,
                                   CefRefPtr<CefProcessMessage> message) override {
+        if (m_router->OnProcessMessageReceived(browser, frame, source_process, message)) {
+            return true;
+        }
+
         // Handle IPC messages from the browser process
         std::string message_name = message->GetName();
+        if (message_name == poe::bridge::kBufferMessage) {
+            CefRefPtr<CefListValue> args = message->GetArgumentList();
+            m_buffers->Add(browser->GetIdentifier(), args->GetInt(0), args->GetBinary(1));
+            return true;
+        }
         if (message_name == "ping") {
             // Send a pong response
             CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("pong");
             frame->SendProcessMessage(PID_BROWSER, response);
             return true;
         }
+        if (message_name == "poe.captureScroll") {
+            // Report the page scroll offset so a discarded view can restore it
+            int x = 0;
+            int y = 0;
+            CefRefPtr<CefV8Context> context = frame->GetV8Context();
+            if (context && context->Enter()) {
+                CefRefPtr<CefV8Value> window = context->GetGlobal();
+                x = GetNumber(window->GetValue("scrollX"));
+                y = GetNumber(window->GetValue("scrollY"));
+                context->Exit();
+            }
+
+            CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("poe.scrollPosition");
+            response->GetArgumentList()->SetInt(0, x);
+            response->GetArgumentList()->SetInt(1, y);
+            frame->SendProcessMessage(PID_BROWSER, response);
+            return true;
+        }
         return false;
     }
 
 private:
+    static int GetNumber(CefRefPtr<CefV8Value> value) {
+        if (!value || !(value->IsInt() || value->IsDouble())) {
+            return 0;
+        }
+        return static_cast<int>(value->GetDoubleValue());
+    }
+
+    CefRefPtr<CefMessageRouterRendererSide> m_router; ///< Renderer half of the JS bridge
+    CefRefPtr<BridgeBuffers> m_buffers;               ///< Binary bridge results not yet taken
+
     IMPLEMENT_REFCOUNTING(RendererApp);
 };
 
@@ -92,6 +222,26 @@ private:
     IMPLEMENT_REFCOUNTING(OtherApp);
 };
 
+/**
+ * @brief Lowers this process's scheduling class as the browser process asked.
+ *
+ * CefApp::OnBeforeChildProcessLaunch passes poe-process-priority: 1 for
+ * below-normal CPU priority, 2 for background mode, which also lowers I/O
+ * and memory priority.
+ */
+void ApplyProcessPriority(CefRefPtr<CefCommandLine> command_line) {
+    if (!command_line->HasSwitch("poe-process-priority")) {
+        return;
+    }
+
+    std::string value = command_line->GetSwitchValue("poe-process-priority");
+    if (value == "1") {
+        SetPriorityClass(GetCurrentProcess(), BELOW_NORMAL_PRIORITY_CLASS);
+    } else if (value == "2") {
+        SetPriorityClass(GetCurrentProcess(), PROCESS_MODE_BACKGROUND_BEGIN);
+    }
+}
+
 CefRefPtr<CefApp> CreateRendererApp() {
     return new RendererApp();
 }
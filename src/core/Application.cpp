@@ -3,40 +3,21 @@
 #include "core/Logger.h"
 #include "core/EventSystem.h"
 #include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
+#include "core/MemoryTracker.h"
+#include "core/WorkerPool.h"
+#include "core/TraceRing.h"
+#include "core/StartupGraph.h"
+#include "core/StartupTimeline.h"
 
-#include <stdexcept>
-#include <thread>
 #include <chrono>
 
 namespace poe {
 
-// Initialize static instance
-Application* Application::s_instance = nullptr;
-
-Application::Application(const std::string& appName)
-    : m_appName(appName)
-    , m_isRunning(false)
-    , m_exitCode(0)
-    , m_settings(nullptr)
-    , m_logger(nullptr)
-    , m_eventSystem(nullptr)
-    , m_errorHandler(nullptr)
-{
-    if (s_instance != nullptr) {
-        throw std::runtime_error("Application instance already exists");
-    }
-
-    s_instance = this;
-}
-
-Application::~Application()
-{
-    Shutdown();
-    s_instance = nullptr;
-}
-
 bool Application::Initialize()
 {
+    StartupTimeline::Mark(StartupMilestone::InitializeBegin);
+
     try {
         // Create all required subsystems
         if (!CreateSubsystems()) {
@@ -47,12 +28,45 @@ bool Application::Initialize()
         m_logger->Initialize();
         m_logger->Info("Application '{}' initializing...", m_appName);
 
-        // Initialize other subsystems
+        // Workers next: every Worker stage below runs on them
+        m_workerPool->Initialize();
+
+        // Reconfiguring the logger swaps its sinks, so do it before any stage can log concurrently
+        auto settingsStart = std::chrono::steady_clock::now();
         m_settings->Initialize();
-        m_eventSystem->Initialize();
-        m_errorHandler->Initialize();
+        m_logger->ApplySettings();
+        m_logger->Info("Settings loaded in {:.1f} ms", std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - settingsStart).count());
+
+        // Everything else runs as a graph, alongside the stages components registered
+        m_startupGraph->AddStage("trace", {}, StartupThread::Main, [this]() {
+            return m_traceRing->Initialize();
+        });
+        m_startupGraph->AddStage("events", {}, StartupThread::Main, [this]() {
+            return m_eventSystem->Initialize();
+        });
+        m_startupGraph->AddStage("errors", { "trace" }, StartupThread::Main, [this]() {
+            return m_errorHandler->Initialize();
+        });
+        m_startupGraph->AddStage("profiler", {}, StartupThread::Main, [this]() {
+            return m_frameProfiler->Initialize();
+        });
+        m_startupGraph->AddStage("memory", { "errors" }, StartupThread::Main, [this]() {
+            return m_memoryTracker->Initialize();
+        });
+
+        bool succeeded = m_startupGraph->Run();
+        m_startupGraph->LogBreakdown();
+        m_startupGraph.reset();
+
+        if (!succeeded) {
+            m_logger->Error("Application '{}' failed to start", m_appName);
+            return false;
+        }
 
-        m_logger->Info("Application '{}' initialized successfully", m_appName);
+        StartupTimeline::Mark(StartupMilestone::InitializeEnd);
+        m_logger->Info("Application '{}' initialized successfully in {:.1f} ms since launch", m_appName,
+            StartupTimeline::GetMilliseconds(StartupMilestone::InitializeEnd));
         return true;
     }
     catch (const std::exception& e) {
@@ -64,109 +78,4 @@ bool Application::Initialize()
     }
 }
 
-bool Application::CreateSubsystems()
-{
-    try {
-        // Create subsystems in order of dependency
-        m_settings = std::make_unique<Settings>(*this);
-        m_logger = std::make_unique<Logger>(*this);
-        m_eventSystem = std::make_unique<EventSystem>(*this);
-        m_errorHandler = std::make_unique<ErrorHandler>(*this);
-        
-        return true;
-    }
-    catch (const std::exception& e) {
-        // Cannot use logger here as it might not be initialized
-        // In a real application, you might want to output to stderr
-        std::cerr << "Failed to create subsystems: " << e.what() << std::endl;
-        return false;
-    }
-}
-
-int Application::Run()
-{
-    if (!m_isRunning.exchange(true)) {
-        m_logger->Info("Application '{}' starting main loop", m_appName);
-        
-        // Main application loop
-        while (m_isRunning.load()) {
-            // Process events
-            m_eventSystem->ProcessEvents();
-            
-            // Sleep to avoid high CPU usage in this simple implementation
-            // In a real application, this would be replaced with proper event waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-        
-        m_logger->Info("Application '{}' main loop ended", m_appName);
-    }
-    
-    return m_exitCode.load();
-}
-
-void Application::Shutdown()
-{
-    if (m_isRunning.exchange(false)) {
-        m_logger->Info("Application '{}' shutting down...", m_appName);
-        
-        // Shutdown subsystems in reverse order of creation
-        if (m_errorHandler) m_errorHandler->Shutdown();
-        if (m_eventSystem) m_eventSystem->Shutdown();
-        if (m_logger) m_logger->Shutdown();
-        if (m_settings) m_settings->Shutdown();
-        
-        // Clear subsystems
-        m_errorHandler.reset();
-        m_eventSystem.reset();
-        m_logger.reset();
-        m_settings.reset();
-    }
-}
-
-void Application::Quit(int exitCode)
-{
-    m_exitCode.store(exitCode);
-    m_isRunning.store(false);
-}
-
-Settings& Application::GetSettings() const
-{
-    if (!m_settings) {
-        throw std::runtime_error("Settings subsystem not initialized");
-    }
-    return *m_settings;
-}
-
-Logger& Application::GetLogger() const
-{
-    if (!m_logger) {
-        throw std::runtime_error("Logger subsystem not initialized");
-    }
-    return *m_logger;
-}
-
-EventSystem& Application::GetEventSystem() const
-{
-    if (!m_eventSystem) {
-        throw std::runtime_error("EventSystem subsystem not initialized");
-    }
-    return *m_eventSystem;
-}
-
-ErrorHandler& Application::GetErrorHandler() const
-{
-    if (!m_errorHandler) {
-        throw std::runtime_error("ErrorHandler subsystem not initialized");
-    }
-    return *m_errorHandler;
-}
-
-Application& Application::GetInstance()
-{
-    if (!s_instance) {
-        throw std::runtime_error("Application instance not created yet");
-    }
-    return *s_instance;
-}
-
-} // namespace poe
\ No newline at end of file
+} // namespace poe
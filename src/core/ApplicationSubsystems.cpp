@@ -0,0 +1,213 @@
+#include "core/Application.h"
+#include "core/Settings.h"
+#include "core/Logger.h"
+#include "core/EventSystem.h"
+#include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
+#include "core/MemoryTracker.h"
+#include "core/WorkerPool.h"
+#include "core/TraceRing.h"
+#include "core/StartupGraph.h"
+
+#include <iostream>
+#include <stdexcept>
+
+// Everything of Application except Initialize(), which lives in Application.cpp.
+// Builds that bring the subsystems up differently (the micro-benchmarks) link
+// this file with their own Initialize(), so subsystems are added here once.
+
+namespace poe {
+
+// Initialize static instance
+Application* Application::s_instance = nullptr;
+
+Application::Application(const std::string& appName)
+    : m_appName(appName)
+    , m_isRunning(false)
+    , m_exitCode(0)
+    , m_settings(nullptr)
+    , m_logger(nullptr)
+    , m_eventSystem(nullptr)
+    , m_errorHandler(nullptr)
+    , m_frameProfiler(nullptr)
+    , m_memoryTracker(nullptr)
+    , m_workerPool(nullptr)
+    , m_traceRing(nullptr)
+    , m_startupGraph(std::make_unique<StartupGraph>(*this))
+{
+    if (s_instance != nullptr) {
+        throw std::runtime_error("Application instance already exists");
+    }
+
+    s_instance = this;
+}
+
+Application::~Application()
+{
+    Shutdown();
+    s_instance = nullptr;
+}
+
+void Application::AddStartupStage(const std::string& name, std::vector<std::string> dependencies,
+                                  StartupThread thread, std::function<bool()> task)
+{
+    if (!m_startupGraph) {
+        throw std::logic_error("Startup stages must be added before Initialize()");
+    }
+    m_startupGraph->AddStage(name, std::move(dependencies), thread, std::move(task));
+}
+
+bool Application::CreateSubsystems()
+{
+    try {
+        // Create subsystems in order of dependency
+        m_settings = std::make_unique<Settings>(*this);
+        m_logger = std::make_unique<Logger>(*this);
+        m_eventSystem = std::make_unique<EventSystem>(*this);
+        m_errorHandler = std::make_unique<ErrorHandler>(*this);
+        m_frameProfiler = std::make_unique<FrameProfiler>(*this);
+        m_memoryTracker = std::make_unique<MemoryTracker>(*this);
+        m_workerPool = std::make_unique<WorkerPool>(*this);
+        m_traceRing = std::make_unique<TraceRing>(*this);
+        
+        return true;
+    }
+    catch (const std::exception& e) {
+        // Cannot use logger here as it might not be initialized
+        // In a real application, you might want to output to stderr
+        std::cerr << "Failed to create subsystems: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+int Application::Run()
+{
+    if (!m_isRunning.exchange(true)) {
+        m_logger->Info("Application '{}' starting main loop", m_appName);
+        
+        // Main application loop
+        while (m_isRunning.load()) {
+            // Process events
+            m_eventSystem->ProcessEvents();
+            
+            // Sleep until an event is published or Quit() is called
+            m_eventSystem->WaitForEvents();
+        }
+        
+        m_logger->Info("Application '{}' main loop ended", m_appName);
+    }
+    
+    return m_exitCode.load();
+}
+
+void Application::Shutdown()
+{
+    if (m_isRunning.exchange(false)) {
+        m_logger->Info("Application '{}' shutting down...", m_appName);
+        
+        // Shutdown subsystems in reverse order of creation
+        if (m_memoryTracker) m_memoryTracker->Shutdown();
+        if (m_workerPool) m_workerPool->Shutdown();
+        if (m_frameProfiler) m_frameProfiler->Shutdown();
+        if (m_errorHandler) m_errorHandler->Shutdown();
+        if (m_eventSystem) m_eventSystem->Shutdown();
+        if (m_traceRing) m_traceRing->Shutdown();
+        if (m_logger) m_logger->Shutdown();
+        if (m_settings) m_settings->Shutdown();
+        
+        // Clear subsystems
+        m_memoryTracker.reset();
+        m_workerPool.reset();
+        m_frameProfiler.reset();
+        m_errorHandler.reset();
+        m_eventSystem.reset();
+        m_traceRing.reset();
+        m_logger.reset();
+        m_settings.reset();
+    }
+}
+
+void Application::Quit(int exitCode)
+{
+    m_exitCode.store(exitCode);
+    m_isRunning.store(false);
+    
+    // Release Run() from its wait
+    if (m_eventSystem) {
+        m_eventSystem->Wake();
+    }
+}
+
+Settings& Application::GetSettings() const
+{
+    if (!m_settings) {
+        throw std::runtime_error("Settings subsystem not initialized");
+    }
+    return *m_settings;
+}
+
+Logger& Application::GetLogger() const
+{
+    if (!m_logger) {
+        throw std::runtime_error("Logger subsystem not initialized");
+    }
+    return *m_logger;
+}
+
+EventSystem& Application::GetEventSystem() const
+{
+    if (!m_eventSystem) {
+        throw std::runtime_error("EventSystem subsystem not initialized");
+    }
+    return *m_eventSystem;
+}
+
+ErrorHandler& Application::GetErrorHandler() const
+{
+    if (!m_errorHandler) {
+        throw std::runtime_error("ErrorHandler subsystem not initialized");
+    }
+    return *m_errorHandler;
+}
+
+FrameProfiler& Application::GetFrameProfiler() const
+{
+    if (!m_frameProfiler) {
+        throw std::runtime_error("FrameProfiler subsystem not initialized");
+    }
+    return *m_frameProfiler;
+}
+
+MemoryTracker& Application::GetMemoryTracker() const
+{
+    if (!m_memoryTracker) {
+        throw std::runtime_error("MemoryTracker subsystem not initialized");
+    }
+    return *m_memoryTracker;
+}
+
+WorkerPool& Application::GetWorkerPool() const
+{
+    if (!m_workerPool) {
+        throw std::runtime_error("WorkerPool subsystem not initialized");
+    }
+    return *m_workerPool;
+}
+
+TraceRing& Application::GetTraceRing() const
+{
+    if (!m_traceRing) {
+        throw std::runtime_error("TraceRing subsystem not initialized");
+    }
+    return *m_traceRing;
+}
+
+Application& Application::GetInstance()
+{
+    if (!s_instance) {
+        throw std::runtime_error("Application instance not created yet");
+    }
+    return *s_instance;
+}
+
+} // namespace poe
@@ -0,0 +1,352 @@
+#include "core/BinaryCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace poe {
+
+namespace {
+
+constexpr uint32_t kCacheMagic = 0x43454F50;  // "POEC"
+constexpr uint32_t kCacheVersion = 1;
+
+/**
+ * @brief Fixed header at the start of every cache file.
+ */
+struct CacheHeader {
+    uint32_t magic;             ///< kCacheMagic
+    uint32_t version;           ///< kCacheVersion
+    uint32_t schema;            ///< What the records hold
+    uint32_t fieldsPerRecord;   ///< Fields in every record
+    uint32_t recordCount;       ///< Number of records
+    uint32_t stringsSize;       ///< Size of the string blob
+    uint64_t sourceSize;        ///< Size of the source file when the cache was built
+    int64_t sourceTime;         ///< Modification time of the source file, in file clock ticks
+};
+
+/**
+ * @brief One encoded field.
+ */
+struct CacheField {
+    uint32_t type;              ///< CacheValueType
+    uint32_t length;            ///< String length; 0 for other types
+    uint64_t payload;           ///< Value bits, or string offset into the blob
+};
+
+static_assert(sizeof(CacheHeader) == 40, "Cache header layout is part of the file format");
+static_assert(sizeof(CacheField) == 16, "Cache field layout is part of the file format");
+
+/**
+ * @brief Reads the size and modification time of the source file.
+ * @return True if the file exists and both were read.
+ */
+bool GetSourceStamp(const std::filesystem::path& sourcePath, uint64_t& size, int64_t& time)
+{
+    std::error_code error;
+    size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, error));
+    if (error) {
+        return false;
+    }
+
+    auto writeTime = std::filesystem::last_write_time(sourcePath, error);
+    if (error) {
+        return false;
+    }
+
+    time = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+} // namespace
+
+BinaryCacheWriter::BinaryCacheWriter(uint32_t schema, uint32_t fieldsPerRecord)
+    : m_schema(schema)
+    , m_fieldsPerRecord(fieldsPerRecord)
+{
+}
+
+void BinaryCacheWriter::AddInt(int64_t value)
+{
+    uint64_t payload;
+    std::memcpy(&payload, &value, sizeof(payload));
+    AddField(CacheValueType::Int, payload);
+}
+
+void BinaryCacheWriter::AddDouble(double value)
+{
+    uint64_t payload;
+    std::memcpy(&payload, &value, sizeof(payload));
+    AddField(CacheValueType::Double, payload);
+}
+
+void BinaryCacheWriter::AddBool(bool value)
+{
+    AddField(CacheValueType::Bool, value ? 1 : 0);
+}
+
+void BinaryCacheWriter::AddString(std::string_view value)
+{
+    CacheField field = {};
+    field.type = static_cast<uint32_t>(CacheValueType::String);
+    field.length = static_cast<uint32_t>(value.size());
+    field.payload = m_strings.size();
+    m_strings.append(value);
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&field);
+    m_fields.insert(m_fields.end(), bytes, bytes + sizeof(field));
+}
+
+void BinaryCacheWriter::AddNone()
+{
+    AddField(CacheValueType::None, 0);
+}
+
+void BinaryCacheWriter::AddField(CacheValueType type, uint64_t payload)
+{
+    CacheField field = {};
+    field.type = static_cast<uint32_t>(type);
+    field.payload = payload;
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&field);
+    m_fields.insert(m_fields.end(), bytes, bytes + sizeof(field));
+}
+
+bool BinaryCacheWriter::WriteFile(const std::filesystem::path& path, const std::filesystem::path& sourcePath) const
+{
+    size_t fieldCount = m_fields.size() / sizeof(CacheField);
+    if (m_fieldsPerRecord == 0 || fieldCount % m_fieldsPerRecord != 0) {
+        return false; // Incomplete last record
+    }
+
+    CacheHeader header = {};
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.schema = m_schema;
+    header.fieldsPerRecord = m_fieldsPerRecord;
+    header.recordCount = static_cast<uint32_t>(fieldCount / m_fieldsPerRecord);
+    header.stringsSize = static_cast<uint32_t>(m_strings.size());
+    if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceTime)) {
+        return false;
+    }
+
+    // Same temp-and-rename dance as the JSON, so readers never see half a cache
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(m_fields.data()), static_cast<std::streamsize>(m_fields.size()));
+        file.write(m_strings.data(), static_cast<std::streamsize>(m_strings.size()));
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    return !error;
+}
+
+BinaryCacheReader::BinaryCacheReader()
+    : m_file(nullptr)
+    , m_mapping(nullptr)
+    , m_view(nullptr)
+    , m_size(0)
+    , m_recordCount(0)
+    , m_fieldsPerRecord(0)
+    , m_fields(nullptr)
+    , m_strings(nullptr)
+    , m_stringsSize(0)
+{
+}
+
+BinaryCacheReader::~BinaryCacheReader()
+{
+    Close();
+}
+
+bool BinaryCacheReader::Open(const std::filesystem::path& path, const std::filesystem::path& sourcePath,
+                             uint32_t schema, uint32_t fieldsPerRecord)
+{
+    Close();
+
+#ifdef _WIN32
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    if (!GetSourceStamp(sourcePath, sourceSize, sourceTime)) {
+        return false;
+    }
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    m_file = file;
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(CacheHeader))) {
+        Close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        Close();
+        return false;
+    }
+
+    m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_view) {
+        Close();
+        return false;
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    // Reject anything stale, foreign or truncated before handing out views
+    CacheHeader header;
+    std::memcpy(&header, m_view, sizeof(header));
+
+    uint64_t fieldsSize = static_cast<uint64_t>(header.recordCount) * header.fieldsPerRecord * sizeof(CacheField);
+    bool valid = header.magic == kCacheMagic &&
+                 header.version == kCacheVersion &&
+                 header.schema == schema &&
+                 header.fieldsPerRecord == fieldsPerRecord &&
+                 header.sourceSize == sourceSize &&
+                 header.sourceTime == sourceTime &&
+                 sizeof(CacheHeader) + fieldsSize + header.stringsSize == m_size;
+    if (!valid) {
+        Close();
+        return false;
+    }
+
+    m_recordCount = header.recordCount;
+    m_fieldsPerRecord = header.fieldsPerRecord;
+    m_fields = m_view + sizeof(CacheHeader);
+    m_strings = reinterpret_cast<const char*>(m_fields + fieldsSize);
+    m_stringsSize = header.stringsSize;
+    return true;
+#else
+    (void)path;
+    (void)sourcePath;
+    (void)schema;
+    (void)fieldsPerRecord;
+    return false;
+#endif
+}
+
+void BinaryCacheReader::Close()
+{
+#ifdef _WIN32
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+#endif
+
+    m_file = nullptr;
+    m_mapping = nullptr;
+    m_view = nullptr;
+    m_size = 0;
+    m_recordCount = 0;
+    m_fieldsPerRecord = 0;
+    m_fields = nullptr;
+    m_strings = nullptr;
+    m_stringsSize = 0;
+}
+
+const uint8_t* BinaryCacheReader::FieldAt(uint32_t record, uint32_t field) const
+{
+    if (record >= m_recordCount || field >= m_fieldsPerRecord) {
+        return nullptr;
+    }
+
+    return m_fields + (static_cast<size_t>(record) * m_fieldsPerRecord + field) * sizeof(CacheField);
+}
+
+CacheValueType BinaryCacheReader::GetType(uint32_t record, uint32_t field) const
+{
+    const uint8_t* encoded = FieldAt(record, field);
+    if (!encoded) {
+        return CacheValueType::None;
+    }
+
+    CacheField value;
+    std::memcpy(&value, encoded, sizeof(value));
+    return value.type <= static_cast<uint32_t>(CacheValueType::String)
+        ? static_cast<CacheValueType>(value.type)
+        : CacheValueType::None;
+}
+
+int64_t BinaryCacheReader::GetInt(uint32_t record, uint32_t field) const
+{
+    if (GetType(record, field) != CacheValueType::Int) {
+        return 0;
+    }
+
+    CacheField value;
+    std::memcpy(&value, FieldAt(record, field), sizeof(value));
+
+    int64_t result;
+    std::memcpy(&result, &value.payload, sizeof(result));
+    return result;
+}
+
+double BinaryCacheReader::GetDouble(uint32_t record, uint32_t field) const
+{
+    if (GetType(record, field) != CacheValueType::Double) {
+        return 0.0;
+    }
+
+    CacheField value;
+    std::memcpy(&value, FieldAt(record, field), sizeof(value));
+
+    double result;
+    std::memcpy(&result, &value.payload, sizeof(result));
+    return result;
+}
+
+bool BinaryCacheReader::GetBool(uint32_t record, uint32_t field) const
+{
+    if (GetType(record, field) != CacheValueType::Bool) {
+        return false;
+    }
+
+    CacheField value;
+    std::memcpy(&value, FieldAt(record, field), sizeof(value));
+    return value.payload != 0;
+}
+
+std::string_view BinaryCacheReader::GetString(uint32_t record, uint32_t field) const
+{
+    if (GetType(record, field) != CacheValueType::String) {
+        return std::string_view();
+    }
+
+    CacheField value;
+    std::memcpy(&value, FieldAt(record, field), sizeof(value));
+
+    // A corrupt offset yields an empty string rather than a read past the mapping
+    if (value.payload > m_stringsSize || value.length > m_stringsSize - value.payload) {
+        return std::string_view();
+    }
+
+    return std::string_view(m_strings + value.payload, value.length);
+}
+
+} // namespace poe
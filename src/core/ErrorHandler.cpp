@@ -1,13 +1,58 @@
 #include "core/ErrorHandler.h"
 #include "core/Application.h"
 #include "core/Logger.h"
+#include "core/TraceRing.h"
+#include "core/WorkerPool.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
 namespace poe {
 
+namespace {
+
+/// Reports of one (component, message) pair that may arrive back to back
+constexpr double kBurstReports = 5.0;
+
+/// Rate the burst allowance refills at once a pair is throttled
+constexpr double kReportsPerSecond = 1.0;
+
+/// Pairs tracked at most; the one seen longest ago makes room for a new one
+constexpr size_t kMaxTrackedErrors = 256;
+
+} // namespace
+
+#ifdef _WIN32
+namespace {
+
+LPTOP_LEVEL_EXCEPTION_FILTER g_previousCrashFilter = nullptr;
+
+/**
+ * @brief Saves the trace ring before the process dies, then defers to the previous filter.
+ */
+LONG WINAPI CrashFilter(EXCEPTION_POINTERS* exceptionInfo)
+{
+    // Best effort: the heap may be damaged, but the trace is worth the attempt
+    try {
+        Application::GetInstance().GetErrorHandler().DumpTrace("crash");
+    }
+    catch (...) {
+    }
+    
+    return g_previousCrashFilter ? g_previousCrashFilter(exceptionInfo) : EXCEPTION_CONTINUE_SEARCH;
+}
+
+} // namespace
+#endif
+
 ErrorHandler::ErrorHandler(Application& app)
     : m_app(app)
+    , m_dispatchScheduled(false)
     , m_nextCallbackId(1)
     , m_fatalRecoveryEnabled(false)
 {
@@ -22,45 +67,42 @@ bool ErrorHandler::Initialize()
 {
     m_app.GetLogger().Info("ErrorHandler initialized");
     
-    // Register default error handler that logs errors
+#ifdef _WIN32
+    g_previousCrashFilter = SetUnhandledExceptionFilter(CrashFilter);
+#endif
+    
+    // Register default error handler that logs errors, one line per report
     RegisterErrorCallback([this](const ErrorInfo& errorInfo) {
         Logger& logger = m_app.GetLogger();
         
+        std::string suffix;
+        if (!errorInfo.details.empty()) {
+            suffix = " (" + errorInfo.details + ")";
+        }
+        if (errorInfo.suppressedCount > 0) {
+            suffix += " [" + std::to_string(errorInfo.suppressedCount) + " identical reports suppressed]";
+        }
+        
         // Log based on severity
         switch (errorInfo.severity) {
             case ErrorSeverity::Info:
-                logger.Info("INFO [{}]: {}", errorInfo.component, errorInfo.message);
-                if (!errorInfo.details.empty()) {
-                    logger.Info("Details: {}", errorInfo.details);
-                }
+                logger.Info("INFO [{}]: {}{}", errorInfo.component, errorInfo.message, suffix);
                 break;
                 
             case ErrorSeverity::Warning:
-                logger.Warning("WARNING [{}]: {}", errorInfo.component, errorInfo.message);
-                if (!errorInfo.details.empty()) {
-                    logger.Warning("Details: {}", errorInfo.details);
-                }
+                logger.Warning("WARNING [{}]: {}{}", errorInfo.component, errorInfo.message, suffix);
                 break;
                 
             case ErrorSeverity::Error:
-                logger.Error("ERROR [{}]: {}", errorInfo.component, errorInfo.message);
-                if (!errorInfo.details.empty()) {
-                    logger.Error("Details: {}", errorInfo.details);
-                }
+                logger.Error("ERROR [{}]: {}{}", errorInfo.component, errorInfo.message, suffix);
                 break;
                 
             case ErrorSeverity::Critical:
-                logger.Critical("CRITICAL [{}]: {}", errorInfo.component, errorInfo.message);
-                if (!errorInfo.details.empty()) {
-                    logger.Critical("Details: {}", errorInfo.details);
-                }
+                logger.Critical("CRITICAL [{}]: {}{}", errorInfo.component, errorInfo.message, suffix);
                 break;
                 
             case ErrorSeverity::Fatal:
-                logger.Critical("FATAL [{}]: {}", errorInfo.component, errorInfo.message);
-                if (!errorInfo.details.empty()) {
-                    logger.Critical("Details: {}", errorInfo.details);
-                }
+                logger.Critical("FATAL [{}]: {}{}", errorInfo.component, errorInfo.message, suffix);
                 break;
         }
     });
@@ -70,10 +112,18 @@ bool ErrorHandler::Initialize()
 
 void ErrorHandler::Shutdown()
 {
+    // Deliver what is still queued while the callbacks are registered
+    Flush();
+    
     // Clear all callbacks
     std::lock_guard<std::mutex> lock(m_callbacksMutex);
     m_callbacks.clear();
     
+#ifdef _WIN32
+    SetUnhandledExceptionFilter(g_previousCrashFilter);
+    g_previousCrashFilter = nullptr;
+#endif
+    
     m_app.GetLogger().Info("ErrorHandler shutdown");
 }
 
@@ -91,7 +141,13 @@ void ErrorHandler::ReportError(
     errorInfo.details = details;
     errorInfo.exception = ex;
     
-    HandleError(errorInfo);
+    m_app.GetTraceRing().Emit(TraceEvent::ErrorReported, static_cast<int64_t>(severity));
+    
+    // Serious errors always get through, and before the process may go down
+    bool serious = severity >= ErrorSeverity::Critical;
+    if (!Admit(errorInfo, serious)) {
+        return;
+    }
     
     // Store as last error
     {
@@ -99,6 +155,22 @@ void ErrorHandler::ReportError(
         m_lastError = errorInfo;
     }
     
+    if (!serious) {
+        Enqueue(std::move(errorInfo));
+        return;
+    }
+    
+    // Earlier reports first, including a batch a worker is part-way through,
+    // so the log keeps its order
+    {
+        std::lock_guard<std::recursive_mutex> dispatchLock(m_dispatchMutex);
+        Flush();
+        HandleError(errorInfo);
+    }
+    
+    // Keep the events that led up to a serious error
+    DumpTrace(severity == ErrorSeverity::Fatal ? "fatal" : "critical");
+    
     // If it's a fatal error and recovery is not enabled, exit the application
     if (severity == ErrorSeverity::Fatal && !m_fatalRecoveryEnabled) {
         m_app.GetLogger().Critical("Fatal error, application will exit");
@@ -144,8 +216,118 @@ bool ErrorHandler::UnregisterErrorCallback(size_t callbackId)
     return false;
 }
 
+void ErrorHandler::Flush()
+{
+    std::lock_guard<std::recursive_mutex> dispatchLock(m_dispatchMutex);
+    
+    std::deque<ErrorInfo> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        pending.swap(m_pending);
+    }
+    
+    for (const ErrorInfo& errorInfo : pending) {
+        HandleError(errorInfo);
+    }
+}
+
+std::vector<ErrorCount> ErrorHandler::GetErrorCounts() const
+{
+    std::lock_guard<std::mutex> lock(m_errorStatesMutex);
+    
+    std::vector<ErrorCount> counts;
+    counts.reserve(m_errorStates.size());
+    for (const auto& pair : m_errorStates) {
+        counts.push_back(pair.second.counts);
+    }
+    return counts;
+}
+
+bool ErrorHandler::Admit(ErrorInfo& errorInfo, bool force)
+{
+    auto now = std::chrono::steady_clock::now();
+    std::string key = errorInfo.component + '\x1f' + errorInfo.message;
+    
+    std::lock_guard<std::mutex> lock(m_errorStatesMutex);
+    
+    auto it = m_errorStates.find(key);
+    if (it == m_errorStates.end()) {
+        if (m_errorStates.size() >= kMaxTrackedErrors) {
+            m_errorStates.erase(std::min_element(m_errorStates.begin(), m_errorStates.end(),
+                [](const auto& a, const auto& b) { return a.second.lastSeen < b.second.lastSeen; }));
+        }
+        
+        ErrorState state;
+        state.counts = { errorInfo.component, errorInfo.message, errorInfo.severity, 0, 0 };
+        state.tokens = kBurstReports;
+        state.pendingSuppressed = 0;
+        state.lastRefill = now;
+        it = m_errorStates.emplace(std::move(key), std::move(state)).first;
+    }
+    
+    ErrorState& state = it->second;
+    state.counts.severity = errorInfo.severity;
+    state.counts.count++;
+    state.lastSeen = now;
+    
+    std::chrono::duration<double> elapsed = now - state.lastRefill;
+    state.tokens = (std::min)(kBurstReports, state.tokens + elapsed.count() * kReportsPerSecond);
+    state.lastRefill = now;
+    
+    if (state.tokens < 1.0 && !force) {
+        state.counts.suppressed++;
+        state.pendingSuppressed++;
+        return false;
+    }
+    
+    state.tokens = (std::max)(0.0, state.tokens - 1.0);
+    errorInfo.suppressedCount = state.pendingSuppressed;
+    state.pendingSuppressed = 0;
+    return true;
+}
+
+void ErrorHandler::Enqueue(ErrorInfo errorInfo)
+{
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending.push_back(std::move(errorInfo));
+        schedule = !m_dispatchScheduled;
+        m_dispatchScheduled = true;
+    }
+    
+    // One task drains everything queued meanwhile; after the pool shut down it runs inline
+    if (schedule) {
+        m_app.GetWorkerPool().Post([this]() { DispatchPending(); });
+    }
+}
+
+void ErrorHandler::DispatchPending()
+{
+    while (true) {
+        // Taken before the swap so Flush cannot overtake a batch in flight
+        std::lock_guard<std::recursive_mutex> dispatchLock(m_dispatchMutex);
+        
+        std::deque<ErrorInfo> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            if (m_pending.empty()) {
+                m_dispatchScheduled = false;
+                return;
+            }
+            pending.swap(m_pending);
+        }
+        
+        for (const ErrorInfo& errorInfo : pending) {
+            HandleError(errorInfo);
+        }
+    }
+}
+
 void ErrorHandler::HandleError(const ErrorInfo& errorInfo)
 {
+    std::lock_guard<std::recursive_mutex> dispatchLock(m_dispatchMutex);
+    
     std::vector<CallbackEntry> callbacks;
     
     // Get a copy of the callbacks to avoid holding the lock during callback execution
@@ -178,4 +360,19 @@ void ErrorHandler::ClearLastError()
     m_lastError = ErrorInfo();
 }
 
+std::filesystem::path ErrorHandler::DumpTrace(const std::string& reason)
+{
+    // Write next to the log file so it ends up in bug reports with it
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    auto stamp = std::chrono::duration_cast<std::chrono::seconds>(now).count();
+    std::filesystem::path dumpPath = m_app.GetLogger().GetLogFilePath().parent_path() /
+        ("trace_" + reason + "_" + std::to_string(stamp) + ".json");
+    
+    if (!m_app.GetTraceRing().DumpToFile(dumpPath)) {
+        return std::filesystem::path();
+    }
+    
+    return dumpPath;
+}
+
 } // namespace poe
\ No newline at end of file
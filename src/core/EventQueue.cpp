@@ -0,0 +1,82 @@
+#include "core/EventQueue.h"
+#include "core/EventSystem.h"
+
+#include <utility>
+
+namespace poe {
+
+EventQueue::EventQueue()
+    : m_currentChunk(0)
+{
+}
+
+EventQueue::~EventQueue()
+{
+    Reset();
+}
+
+void EventQueue::Drain(EventSystem& system)
+{
+    // Destroy whatever was queued even if a dispatcher throws
+    struct ResetGuard {
+        EventQueue& queue;
+        ~ResetGuard() { queue.Reset(); }
+    } guard{*this};
+
+    for (const auto& entry : m_entries) {
+        entry.dispatch(system, *entry.event);
+    }
+}
+
+void EventQueue::Clear()
+{
+    Reset();
+}
+
+void EventQueue::Swap(EventQueue& other) noexcept
+{
+    m_chunks.swap(other.m_chunks);
+    std::swap(m_currentChunk, other.m_currentChunk);
+    m_entries.swap(other.m_entries);
+}
+
+void* EventQueue::Allocate(size_t size, size_t alignment)
+{
+    // Try the current chunk, then any later chunk left over from a previous burst
+    while (m_currentChunk < m_chunks.size()) {
+        Chunk& chunk = m_chunks[m_currentChunk];
+        size_t offset = (chunk.used + alignment - 1) & ~(alignment - 1);
+
+        if (offset + size <= chunk.capacity) {
+            chunk.used = offset + size;
+            return chunk.data.get() + offset;
+        }
+
+        ++m_currentChunk;
+    }
+
+    // Grow by one chunk, large enough for oversized events
+    Chunk chunk;
+    chunk.capacity = size + alignment > kChunkSize ? size + alignment : kChunkSize;
+    chunk.data = std::make_unique<std::byte[]>(chunk.capacity);
+    chunk.charge.Set(chunk.capacity);
+    m_chunks.push_back(std::move(chunk));
+    m_currentChunk = m_chunks.size() - 1;
+
+    return Allocate(size, alignment);
+}
+
+void EventQueue::Reset()
+{
+    for (const auto& entry : m_entries) {
+        entry.destroy(entry.event);
+    }
+    m_entries.clear();
+
+    for (auto& chunk : m_chunks) {
+        chunk.used = 0;
+    }
+    m_currentChunk = 0;
+}
+
+} // namespace poe
@@ -4,8 +4,21 @@
 
 namespace poe {
 
+namespace detail {
+
+EventTypeId AllocateEventTypeId()
+{
+    static std::atomic<EventTypeId> nextId{0};
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
 EventSystem::EventSystem(Application& app)
     : m_app(app)
+    , m_channels(std::make_shared<const ChannelTable>())
+    , m_processing(false)
+    , m_wakeRequested(false)
     , m_nextHandlerId(1)
 {
 }
@@ -25,73 +38,77 @@ void EventSystem::Shutdown()
 {
     // Clear all event handlers
     std::lock_guard<std::mutex> lock1(m_handlersMutex);
-    m_handlers.clear();
+    m_channels.store(std::make_shared<const ChannelTable>(), std::memory_order_release);
+    m_handlerChannels.clear();
 
     // Clear event queue
     std::lock_guard<std::mutex> lock2(m_queueMutex);
-    m_eventQueue.clear();
+    m_eventQueue.Clear();
+    m_processingQueue.Clear();
+    m_wakeHandler = nullptr;
 
     m_app.GetLogger().Info("EventSystem shutdown");
 }
 
 void EventSystem::ProcessEvents()
 {
-    // Get all pending events
-    std::vector<std::shared_ptr<Event>> pendingEvents;
+    // Handlers that call back into ProcessEvents pick up their events on the next pass
+    if (m_processing) {
+        return;
+    }
     
+    // Take the whole pending batch in one swap; the arena storage moves with it
     {
         std::lock_guard<std::mutex> lock(m_queueMutex);
-        if (m_eventQueue.empty()) {
+        if (m_eventQueue.Empty()) {
             return; // No events to process
         }
         
-        pendingEvents.swap(m_eventQueue);
+        m_eventQueue.Swap(m_processingQueue);
     }
     
-    // Process each event
-    for (const auto& event : pendingEvents) {
-        DispatchQueuedEvent(event);
+    // Dispatch each event through the dispatcher recorded for its concrete type
+    m_processing = true;
+    try {
+        m_processingQueue.Drain(*this);
+    }
+    catch (...) {
+        m_processing = false;
+        throw;
     }
+    m_processing = false;
 }
 
-void EventSystem::DispatchQueuedEvent(const std::shared_ptr<Event>& event)
+void EventSystem::WaitForEvents()
 {
-    if (!event) return;
-    
-    const auto typeName = event->GetTypeName();
-    
-    std::lock_guard<std::mutex> lock(m_handlersMutex);
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_queueCondition.wait(lock, [this]() { return !m_eventQueue.Empty() || m_wakeRequested; });
+    m_wakeRequested = false;
+}
+
+void EventSystem::Wake()
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_wakeRequested = true;
+    NotifyQueued();
+}
+
+void EventSystem::SetWakeHandler(std::function<void()> handler)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_wakeHandler = std::move(handler);
     
-    auto it = m_handlers.find(typeName);
-    if (it == m_handlers.end()) {
-        return; // No handlers for this event type
+    // Whatever is already queued should not wait for the next publication
+    if (m_wakeHandler && !m_eventQueue.Empty()) {
+        m_wakeHandler();
     }
-    
-    m_app.GetLogger().Debug("Dispatching event: {}", event->ToString());
-    
-    // Call each handler
-    for (const auto& entry : it->second) {
-        try {
-            // We need to perform a dynamic dispatch here since we don't know
-            // the concrete type of the event at compile time. For each registered
-            // handler type, we'll try to cast and dispatch.
-            
-            // This is not ideal and could be improved with a more type-safe
-            // approach, but it works for the basic event system.
-            
-            // This approach limits us to a predefined set of event types that
-            // we know about at compile time. In a real system, you might want
-            // to use a more flexible approach, possibly with a type registry.
-            
-            // For now, this stub just logs that we can't dispatch the event
-            m_app.GetLogger().Warning("Event dispatch mechanism not fully implemented for type: {}", typeName);
-        }
-        catch (const std::bad_any_cast&) {
-            m_app.GetLogger().Error("Failed to cast event handler for type: {}", typeName);
-        }
-        catch (const std::exception& e) {
-            m_app.GetLogger().Error("Exception in event handler for {}: {}", typeName, e.what());
-        }
+}
+
+void EventSystem::NotifyQueued()
+{
+    m_queueCondition.notify_one();
+    if (m_wakeHandler) {
+        m_wakeHandler();
     }
 }
 
@@ -99,15 +116,16 @@ bool EventSystem::Unsubscribe(size_t handlerId)
 {
     std::lock_guard<std::mutex> lock(m_handlersMutex);
     
-    // Search through all event types
-    for (auto& [typeName, handlers] : m_handlers) {
-        // Find and remove the handler with matching ID
-        for (auto it = handlers.begin(); it != handlers.end(); ++it) {
-            if (it->id == handlerId) {
-                handlers.erase(it);
-                m_app.GetLogger().Debug("Unsubscribed handler ID: {} from event: {}", handlerId, typeName);
-                return true;
-            }
+    // Look up the channel the handler was registered on
+    auto it = m_handlerChannels.find(handlerId);
+    if (it != m_handlerChannels.end()) {
+        const EventTypeId typeId = it->second;
+        m_handlerChannels.erase(it);
+        
+        auto table = m_channels.load(std::memory_order_acquire);
+        if (typeId < table->size() && (*table)[typeId] && (*table)[typeId]->Remove(handlerId)) {
+            m_app.GetLogger().Debug("Unsubscribed handler ID: {} from event type {}", handlerId, typeId);
+            return true;
         }
     }
     
@@ -0,0 +1,198 @@
+#include "core/FrameProfiler.h"
+#include "core/Application.h"
+#include "core/Logger.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+
+namespace poe {
+
+FrameProfiler::FrameProfiler(Application& app)
+    : m_app(app)
+    , m_startTime(std::chrono::steady_clock::now())
+{
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    Shutdown();
+}
+
+bool FrameProfiler::Initialize()
+{
+    Reset();
+    m_app.GetLogger().Debug("FrameProfiler initialized with {} stages", kStageCount);
+    return true;
+}
+
+void FrameProfiler::Shutdown()
+{
+}
+
+void FrameProfiler::Record(PerfStage stage, uint64_t microseconds)
+{
+    size_t stageIndex = static_cast<size_t>(stage);
+    if (stageIndex >= kStageCount) {
+        return;
+    }
+
+    StageHistogram& histogram = m_stages[stageIndex];
+    histogram.buckets[BucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.totalUs.fetch_add(microseconds, std::memory_order_relaxed);
+
+    uint64_t currentMax = histogram.maxUs.load(std::memory_order_relaxed);
+    while (microseconds > currentMax &&
+           !histogram.maxUs.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void FrameProfiler::MarkFrame()
+{
+    m_frameCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t FrameProfiler::GetFrameCount() const
+{
+    return m_frameCount.load(std::memory_order_relaxed);
+}
+
+std::vector<PerfStageStats> FrameProfiler::GetStats() const
+{
+    std::vector<PerfStageStats> result;
+    result.reserve(kStageCount);
+
+    for (size_t stageIndex = 0; stageIndex < kStageCount; ++stageIndex) {
+        const StageHistogram& histogram = m_stages[stageIndex];
+
+        PerfStageStats stats;
+        stats.name = GetStageName(static_cast<PerfStage>(stageIndex));
+        stats.maxUs = histogram.maxUs.load(std::memory_order_relaxed);
+
+        // Snapshot the buckets; concurrent samples may land while we read, which is fine for a report
+        std::array<uint32_t, kBucketCount> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        stats.count = total;
+        if (total > 0) {
+            stats.meanUs = static_cast<double>(histogram.totalUs.load(std::memory_order_relaxed)) /
+                           static_cast<double>(std::max<uint64_t>(histogram.count.load(std::memory_order_relaxed), 1));
+
+            // Walk the cumulative distribution once for all three percentiles
+            const double percentiles[] = { 0.50, 0.95, 0.99 };
+            uint64_t* outputs[] = { &stats.p50Us, &stats.p95Us, &stats.p99Us };
+            size_t next = 0;
+            uint64_t cumulative = 0;
+
+            for (size_t i = 0; i < kBucketCount && next < 3; ++i) {
+                cumulative += counts[i];
+                while (next < 3 && cumulative >= static_cast<uint64_t>(percentiles[next] * total + 0.5)) {
+                    *outputs[next] = std::min(BucketUpperBound(i), stats.maxUs);
+                    ++next;
+                }
+            }
+        }
+
+        result.push_back(stats);
+    }
+
+    return result;
+}
+
+std::string FrameProfiler::FormatReport() const
+{
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+    uint64_t frames = GetFrameCount();
+
+    std::string report = fmt::format("Frames: {} in {:.1f} s ({:.1f} fps)\n\n",
+        frames, elapsed, elapsed > 0.0 ? static_cast<double>(frames) / elapsed : 0.0);
+
+    report += fmt::format("{:<20} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+        "stage", "count", "mean us", "p50 us", "p95 us", "p99 us", "max us");
+
+    for (const auto& stats : GetStats()) {
+        report += fmt::format("{:<20} {:>10} {:>10.1f} {:>10} {:>10} {:>10} {:>10}\n",
+            stats.name, stats.count, stats.meanUs, stats.p50Us, stats.p95Us, stats.p99Us, stats.maxUs);
+    }
+
+    return report;
+}
+
+bool FrameProfiler::DumpToFile(const std::filesystem::path& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) {
+        m_app.GetLogger().Error("Failed to open profiler dump file: {}", path.string());
+        return false;
+    }
+
+    file << FormatReport();
+    if (!file) {
+        m_app.GetLogger().Error("Failed to write profiler dump file: {}", path.string());
+        return false;
+    }
+
+    m_app.GetLogger().Info("Frame profile written to {}", path.string());
+    return true;
+}
+
+void FrameProfiler::Reset()
+{
+    for (auto& histogram : m_stages) {
+        for (auto& bucket : histogram.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.totalUs.store(0, std::memory_order_relaxed);
+        histogram.maxUs.store(0, std::memory_order_relaxed);
+    }
+
+    m_frameCount.store(0, std::memory_order_relaxed);
+    m_startTime = std::chrono::steady_clock::now();
+}
+
+const char* FrameProfiler::GetStageName(PerfStage stage)
+{
+    switch (stage) {
+        case PerfStage::CefPaint:          return "CefPaint";
+        case PerfStage::BrowserViewPaint:  return "BrowserViewPaint";
+        case PerfStage::ContentUpload:     return "ContentUpload";
+        case PerfStage::CompositeRender:   return "CompositeRender";
+        case PerfStage::BorderRender:      return "BorderRender";
+        case PerfStage::CompositionCommit: return "CompositionCommit";
+        case PerfStage::HotkeyLatency:     return "HotkeyLatency";
+        default:                           return "Unknown";
+    }
+}
+
+size_t FrameProfiler::BucketIndex(uint64_t microseconds)
+{
+    if (microseconds < kLinearBuckets) {
+        return static_cast<size_t>(microseconds);
+    }
+
+    // Power-of-two range, then the top three bits below the leading one pick the sub-bucket
+    size_t exponent = static_cast<size_t>(std::bit_width(microseconds)) - 1;
+    size_t subBucket = static_cast<size_t>(microseconds >> (exponent - 3)) & (kSubBuckets - 1);
+    return kLinearBuckets + (exponent - 4) * kSubBuckets + subBucket;
+}
+
+uint64_t FrameProfiler::BucketUpperBound(size_t index)
+{
+    if (index < kLinearBuckets) {
+        return index;
+    }
+
+    size_t exponent = 4 + (index - kLinearBuckets) / kSubBuckets;
+    size_t subBucket = (index - kLinearBuckets) % kSubBuckets;
+    uint64_t width = uint64_t{1} << (exponent - 3);
+    return (kSubBuckets + subBucket) * width + (width - 1);
+}
+
+} // namespace poe
@@ -1,20 +1,57 @@
 #include "core/Logger.h"
 #include "core/Application.h"
+#include "core/Settings.h"
 
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/fmt/fmt.h>
 
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include <iostream>
 
 namespace poe {
 
+namespace {
+
+// Enough for a burst of startup logging without blocking or dropping
+constexpr size_t kDefaultQueueSize = 8192;
+
+// How long a message may wait in the file sink's buffer
+constexpr int kDefaultFlushIntervalSeconds = 1;
+
+/**
+ * @brief Maps the application log level (0-6) onto the spdlog level.
+ */
+spdlog::level::level_enum ToSpdlogLevel(int level)
+{
+    switch (level) {
+        case 0: return spdlog::level::trace;
+        case 1: return spdlog::level::debug;
+        case 2: return spdlog::level::info;
+        case 3: return spdlog::level::warn;
+        case 4: return spdlog::level::err;
+        case 5: return spdlog::level::critical;
+        case 6: return spdlog::level::off;
+        default: return spdlog::level::info;
+    }
+}
+
+} // namespace
+
 Logger::Logger(Application& app)
     : m_app(app)
     , m_logger(nullptr)
     , m_consoleLoggingEnabled(true)
+    , m_asyncEnabled(true)
+    , m_queueSize(kDefaultQueueSize)
+    , m_dropOnOverflow(false)
+    , m_level(2)
+    , m_activeLevel(6)
+    , m_queueCharge(MemoryTag::Logs)
 {
     // Set default log file path
     auto appDataPath = std::filesystem::temp_directory_path() / "PoEOverlay";
@@ -35,6 +72,9 @@ bool Logger::Initialize()
         // Create loggers
         CreateLoggers();
         
+        // Buffered sinks are flushed in the background; errors go out at once
+        spdlog::flush_every(std::chrono::seconds(kDefaultFlushIntervalSeconds));
+        
         Info("Logger initialized");
         return true;
     }
@@ -48,29 +88,40 @@ void Logger::Shutdown()
 {
     if (m_logger) {
         Info("Logger shutting down");
-        // This will flush and close all sinks
-        spdlog::drop_all();
+        m_logger->flush();
+        // Stops the periodic flusher, then drops and closes all sinks
+        m_activeLevel.store(6, std::memory_order_relaxed);
+        spdlog::shutdown();
         m_logger = nullptr;
     }
+    
+    // Joins the worker once it has written everything still queued
+    m_threadPool.reset();
+    m_queueCharge.Set(0);
+}
+
+void Logger::ApplySettings()
+{
+    auto& settings = m_app.GetSettings();
+    
+    bool async = settings.Get<bool>("logging.async", true);
+    size_t queueSize = static_cast<size_t>((std::max)(
+        settings.Get<int>("logging.queueSize", static_cast<int>(kDefaultQueueSize)), 64));
+    bool dropOnOverflow = settings.Get<std::string>("logging.overflowPolicy", "block") == "drop";
+    SetAsyncMode(async, queueSize, dropOnOverflow);
+    
+    int flushSeconds = (std::max)(settings.Get<int>("logging.flushIntervalSeconds", kDefaultFlushIntervalSeconds), 1);
+    if (flushSeconds != kDefaultFlushIntervalSeconds) {
+        spdlog::flush_every(std::chrono::seconds(flushSeconds));
+    }
 }
 
 void Logger::SetLevel(int level)
 {
+    m_level = level;
     if (m_logger) {
-        spdlog::level::level_enum spdlogLevel = spdlog::level::info;
-        
-        switch (level) {
-            case 0: spdlogLevel = spdlog::level::trace; break;
-            case 1: spdlogLevel = spdlog::level::debug; break;
-            case 2: spdlogLevel = spdlog::level::info; break;
-            case 3: spdlogLevel = spdlog::level::warn; break;
-            case 4: spdlogLevel = spdlog::level::err; break;
-            case 5: spdlogLevel = spdlog::level::critical; break;
-            case 6: spdlogLevel = spdlog::level::off; break;
-            default: spdlogLevel = spdlog::level::info; break;
-        }
-        
-        m_logger->set_level(spdlogLevel);
+        m_logger->set_level(ToSpdlogLevel(level));
+        m_activeLevel.store(level, std::memory_order_relaxed);
     }
 }
 
@@ -103,21 +154,38 @@ void Logger::EnableConsoleLogging(bool enable)
     }
 }
 
-template<typename... Args>
-void Logger::Log(int level, std::string_view fmt, const Args&... args)
+void Logger::SetAsyncMode(bool enable, size_t queueSize, bool dropOnOverflow)
+{
+    if (m_asyncEnabled == enable && m_queueSize == queueSize && m_dropOnOverflow == dropOnOverflow) {
+        return;
+    }
+    
+    // A different queue size needs a new pool; CreateLoggers builds it
+    if (m_queueSize != queueSize || !enable) {
+        if (m_logger) {
+            m_logger->flush();
+            spdlog::drop("poeoverlay");
+            m_logger = nullptr;
+        }
+        m_threadPool.reset();
+        m_queueCharge.Set(0);
+    }
+    
+    m_asyncEnabled = enable;
+    m_queueSize = queueSize;
+    m_dropOnOverflow = dropOnOverflow;
+    
+    CreateLoggers();
+}
+
+void Logger::Write(int level, fmt::string_view fmt, fmt::format_args args)
 {
     if (!m_logger) return;
     
     try {
-        switch (level) {
-            case 0: m_logger->trace(fmt, args...); break;
-            case 1: m_logger->debug(fmt, args...); break;
-            case 2: m_logger->info(fmt, args...); break;
-            case 3: m_logger->warn(fmt, args...); break;
-            case 4: m_logger->error(fmt, args...); break;
-            case 5: m_logger->critical(fmt, args...); break;
-            default: m_logger->info(fmt, args...); break;
-        }
+        fmt::memory_buffer buffer;
+        fmt::vformat_to(std::back_inserter(buffer), fmt, args);
+        m_logger->log(ToSpdlogLevel(level), spdlog::string_view_t(buffer.data(), buffer.size()));
     }
     catch (const std::exception& e) {
         std::cerr << "Logging error: " << e.what() << std::endl;
@@ -134,37 +202,59 @@ void Logger::CreateLoggers()
     // Create sinks
     std::vector<spdlog::sink_ptr> sinks;
     
-    // File sink (rotating, max 5MB per file, max 3 files)
-    auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-        m_logFilePath.string(), 5 * 1024 * 1024, 3);
-    sinks.push_back(file_sink);
-    
-    // Console sink if enabled
-    if (m_consoleLoggingEnabled) {
-        auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-        sinks.push_back(console_sink);
+    // With one worker thread draining the queue, the sinks never see two
+    // writers and can skip their own mutex
+    if (m_asyncEnabled) {
+        // File sink (rotating, max 5MB per file, max 3 files)
+        sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_st>(
+            m_logFilePath.string(), 5 * 1024 * 1024, 3));
+        
+        // Console sink if enabled
+        if (m_consoleLoggingEnabled) {
+            sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_st>());
+        }
+    }
+    else {
+        sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+            m_logFilePath.string(), 5 * 1024 * 1024, 3));
+        
+        if (m_consoleLoggingEnabled) {
+            sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+        }
     }
     
     // Create and register logger
-    m_logger = std::make_shared<spdlog::logger>("poeoverlay", sinks.begin(), sinks.end());
+    if (m_asyncEnabled) {
+        if (!m_threadPool) {
+            m_threadPool = std::make_shared<spdlog::details::thread_pool>(m_queueSize, 1);
+            m_queueCharge.Set(m_queueSize * sizeof(spdlog::details::async_msg));
+        }
+        
+        // Callers only format and enqueue; a full queue either waits for the
+        // worker or overwrites the oldest message
+        auto policy = m_dropOnOverflow
+            ? spdlog::async_overflow_policy::overrun_oldest
+            : spdlog::async_overflow_policy::block;
+        m_logger = std::make_shared<spdlog::async_logger>(
+            "poeoverlay", sinks.begin(), sinks.end(), m_threadPool, policy);
+    }
+    else {
+        m_logger = std::make_shared<spdlog::logger>("poeoverlay", sinks.begin(), sinks.end());
+    }
     spdlog::register_logger(m_logger);
     
     // Set log format
     m_logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%t] %v");
     
-    // Set default level (info)
-    m_logger->set_level(spdlog::level::info);
+    // Restore the current level (info unless SetLevel changed it)
+    m_logger->set_level(ToSpdlogLevel(m_level));
+    m_activeLevel.store(m_level, std::memory_order_relaxed);
+    
+    // Errors must reach the file even if the process dies right after
+    m_logger->flush_on(spdlog::level::err);
     
     // Set as default logger
     spdlog::set_default_logger(m_logger);
 }
 
-// Explicit template instantiations for common types
-template void Logger::Log(int, std::string_view);
-template void Logger::Log(int, std::string_view, const std::string&);
-template void Logger::Log(int, std::string_view, const char*);
-template void Logger::Log(int, std::string_view, int);
-template void Logger::Log(int, std::string_view, double);
-template void Logger::Log(int, std::string_view, bool);
-
 } // namespace poe
\ No newline at end of file
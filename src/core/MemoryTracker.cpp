@@ -0,0 +1,359 @@
+#include "core/MemoryTracker.h"
+#include "core/Application.h"
+#include "core/Logger.h"
+#include "core/Settings.h"
+#include "core/ErrorHandler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <spdlog/fmt/fmt.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <TlHelp32.h>
+#include <Psapi.h>
+#pragma comment(lib, "psapi.lib")
+#endif
+
+namespace poe {
+
+namespace {
+
+constexpr uint64_t kMegabyte = 1024 * 1024;
+
+/// Process-wide counters, so charging needs no MemoryTracker instance
+struct TagCounters {
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> peakBytes{0};
+    std::atomic<uint64_t> charges{0};
+};
+
+std::array<TagCounters, static_cast<size_t>(MemoryTag::Count)> g_counters;
+
+/// Budgets that apply unless settings say otherwise, in megabytes (0 for none)
+constexpr std::array<int, static_cast<size_t>(MemoryTag::Count)> kDefaultBudgetsMB = {
+    16,     // Events
+    32,     // Logs
+    256,    // Resources
+    192,    // FrameBuffers
+    256,    // GpuSurfaces
+};
+constexpr int kDefaultProcessBudgetMB = 1536;
+constexpr int kDefaultSampleIntervalMs = 5000;
+
+/// Lowercase first letter, so MemoryTag names double as settings keys
+std::string SettingsKey(const char* name)
+{
+    std::string key = std::string("memory.budgetMB.") + name;
+    key[16] = static_cast<char>(std::tolower(static_cast<unsigned char>(key[16])));
+    return key;
+}
+
+double ToMegabytes(uint64_t bytes)
+{
+    return static_cast<double>(bytes) / static_cast<double>(kMegabyte);
+}
+
+#ifdef _WIN32
+/// Reads one process's counters; false if it is gone or inaccessible
+bool ReadMemoryCounters(HANDLE process, ProcessMemoryStats& stats)
+{
+    PROCESS_MEMORY_COUNTERS_EX counters = {};
+    if (!GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+        return false;
+    }
+
+    stats.privateBytes = counters.PrivateUsage;
+    stats.workingSetBytes = counters.WorkingSetSize;
+    stats.peakWorkingSetBytes = counters.PeakWorkingSetSize;
+    return true;
+}
+
+/// Creation time of a process, to tell our children from a reused parent ID
+uint64_t GetCreationTime(HANDLE process)
+{
+    FILETIME creation, exitTime, kernel, user;
+    if (!GetProcessTimes(process, &creation, &exitTime, &kernel, &user)) {
+        return 0;
+    }
+    return (static_cast<uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+}
+
+std::string ToUtf8(const wchar_t* wide)
+{
+    std::string text;
+    int size = WideCharToMultiByte(CP_UTF8, 0, wide, -1, nullptr, 0, nullptr, nullptr);
+    if (size > 0) {
+        text.resize(static_cast<size_t>(size) - 1);
+        WideCharToMultiByte(CP_UTF8, 0, wide, -1, text.data(), size, nullptr, nullptr);
+    }
+    return text;
+}
+#endif
+
+} // namespace
+
+MemoryTracker::MemoryTracker(Application& app)
+    : m_app(app)
+    , m_processBudget(0)
+    , m_sampleInterval(kDefaultSampleIntervalMs)
+    , m_running(false)
+{
+}
+
+MemoryTracker::~MemoryTracker()
+{
+    Shutdown();
+}
+
+bool MemoryTracker::Initialize()
+{
+    Settings& settings = m_app.GetSettings();
+    for (size_t i = 0; i < kTagCount; ++i) {
+        int budgetMB = settings.Get<int>(SettingsKey(GetTagName(static_cast<MemoryTag>(i))), kDefaultBudgetsMB[i]);
+        m_budgets[i] = static_cast<uint64_t>((std::max)(budgetMB, 0)) * kMegabyte;
+    }
+    m_processBudget = static_cast<uint64_t>((std::max)(
+        settings.Get<int>("memory.budgetMB.processes", kDefaultProcessBudgetMB), 0)) * kMegabyte;
+    m_sampleInterval = std::chrono::milliseconds((std::max)(
+        settings.Get<int>("memory.sampleIntervalMs", kDefaultSampleIntervalMs), 250));
+
+    {
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        if (m_running) {
+            return true;
+        }
+        m_running = true;
+    }
+    m_samplerThread = std::thread(&MemoryTracker::SamplerThread, this);
+
+    m_app.GetLogger().Debug("MemoryTracker initialized, sampling every {} ms", m_sampleInterval.count());
+    return true;
+}
+
+void MemoryTracker::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+
+    m_threadCondition.notify_one();
+    if (m_samplerThread.joinable()) {
+        m_samplerThread.join();
+    }
+}
+
+void MemoryTracker::Charge(MemoryTag tag, size_t bytes) noexcept
+{
+    size_t index = static_cast<size_t>(tag);
+    if (index >= kTagCount) {
+        return;
+    }
+
+    TagCounters& counters = g_counters[index];
+    counters.charges.fetch_add(1, std::memory_order_relaxed);
+    uint64_t current = counters.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (current > peak &&
+           !counters.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryTracker::Release(MemoryTag tag, size_t bytes) noexcept
+{
+    size_t index = static_cast<size_t>(tag);
+    if (index >= kTagCount) {
+        return;
+    }
+
+    TagCounters& counters = g_counters[index];
+    counters.charges.fetch_sub(1, std::memory_order_relaxed);
+    counters.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+std::vector<MemoryTagStats> MemoryTracker::GetTagStats() const
+{
+    std::vector<MemoryTagStats> result;
+    result.reserve(kTagCount);
+
+    for (size_t i = 0; i < kTagCount; ++i) {
+        MemoryTagStats stats;
+        stats.name = GetTagName(static_cast<MemoryTag>(i));
+        stats.bytes = g_counters[i].bytes.load(std::memory_order_relaxed);
+        stats.peakBytes = g_counters[i].peakBytes.load(std::memory_order_relaxed);
+        stats.charges = g_counters[i].charges.load(std::memory_order_relaxed);
+        stats.budgetBytes = m_budgets[i];
+        result.push_back(stats);
+    }
+
+    return result;
+}
+
+std::vector<ProcessMemoryStats> MemoryTracker::GetProcessStats() const
+{
+    std::lock_guard<std::mutex> lock(m_sampleMutex);
+    return m_processes;
+}
+
+void MemoryTracker::Sample()
+{
+    auto processes = SampleProcesses();
+
+    uint64_t processBytes = 0;
+    for (const auto& process : processes) {
+        processBytes += process.privateBytes;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sampleMutex);
+    m_processes = std::move(processes);
+
+    auto tags = GetTagStats();
+    for (size_t i = 0; i < tags.size(); ++i) {
+        CheckBudget(i, tags[i].name, tags[i].bytes, tags[i].budgetBytes);
+    }
+    CheckBudget(kTagCount, "All processes", processBytes, m_processBudget);
+}
+
+std::string MemoryTracker::FormatReport() const
+{
+    std::string report = fmt::format("{:<20} {:>10} {:>10} {:>10} {:>10}\n",
+        "tag", "MB", "peak MB", "budget MB", "charges");
+
+    uint64_t trackedBytes = 0;
+    for (const auto& stats : GetTagStats()) {
+        trackedBytes += stats.bytes;
+        std::string budget = stats.budgetBytes ? fmt::format("{:.0f}", ToMegabytes(stats.budgetBytes)) : "-";
+        report += fmt::format("{:<20} {:>10.1f} {:>10.1f} {:>10} {:>10}{}\n",
+            stats.name, ToMegabytes(stats.bytes), ToMegabytes(stats.peakBytes), budget, stats.charges,
+            stats.budgetBytes && stats.bytes > stats.budgetBytes ? "  OVER BUDGET" : "");
+    }
+    report += fmt::format("{:<20} {:>10.1f}\n\n", "tracked", ToMegabytes(trackedBytes));
+
+    auto processes = GetProcessStats();
+    report += fmt::format("{:<8} {:<28} {:>12} {:>12} {:>12}\n",
+        "pid", "process", "private MB", "working MB", "peak WS MB");
+
+    uint64_t processBytes = 0;
+    for (const auto& process : processes) {
+        processBytes += process.privateBytes;
+        report += fmt::format("{:<8} {:<28} {:>12.1f} {:>12.1f} {:>12.1f}\n",
+            process.processId, process.self ? process.name + " (overlay)" : process.name,
+            ToMegabytes(process.privateBytes), ToMegabytes(process.workingSetBytes),
+            ToMegabytes(process.peakWorkingSetBytes));
+    }
+
+    std::string budget = m_processBudget ? fmt::format(" of {:.0f} MB budget", ToMegabytes(m_processBudget)) : "";
+    report += fmt::format("{:<37} {:>12.1f}{}\n", "total", ToMegabytes(processBytes), budget);
+    return report;
+}
+
+void MemoryTracker::ResetPeaks()
+{
+    for (auto& counters : g_counters) {
+        counters.peakBytes.store(counters.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag)
+{
+    switch (tag) {
+        case MemoryTag::Events:        return "Events";
+        case MemoryTag::Logs:          return "Logs";
+        case MemoryTag::Resources:     return "Resources";
+        case MemoryTag::FrameBuffers:  return "FrameBuffers";
+        case MemoryTag::GpuSurfaces:   return "GpuSurfaces";
+        default:                       return "Unknown";
+    }
+}
+
+void MemoryTracker::SamplerThread()
+{
+    std::unique_lock<std::mutex> lock(m_threadMutex);
+
+    while (m_running) {
+        lock.unlock();
+        Sample();
+        lock.lock();
+
+        m_threadCondition.wait_for(lock, m_sampleInterval, [this]() { return !m_running; });
+    }
+}
+
+std::vector<ProcessMemoryStats> MemoryTracker::SampleProcesses()
+{
+    std::vector<ProcessMemoryStats> processes;
+
+#ifdef _WIN32
+    DWORD selfId = GetCurrentProcessId();
+    uint64_t selfCreated = GetCreationTime(GetCurrentProcess());
+
+    ProcessMemoryStats self;
+    self.processId = selfId;
+    self.self = true;
+    wchar_t path[MAX_PATH];
+    DWORD length = GetModuleFileNameW(nullptr, path, MAX_PATH);
+    if (length > 0 && length < MAX_PATH) {
+        const wchar_t* name = wcsrchr(path, L'\\');
+        self.name = ToUtf8(name ? name + 1 : path);
+    }
+    if (ReadMemoryCounters(GetCurrentProcess(), self)) {
+        processes.push_back(std::move(self));
+    }
+
+    // CEF starts its renderer, GPU and utility processes as our direct children
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        return processes;
+    }
+
+    PROCESSENTRY32W entry = {};
+    entry.dwSize = sizeof(entry);
+    for (BOOL found = Process32FirstW(snapshot, &entry); found; found = Process32NextW(snapshot, &entry)) {
+        if (entry.th32ParentProcessID != selfId || entry.th32ProcessID == selfId) {
+            continue;
+        }
+
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, entry.th32ProcessID);
+        if (!process) {
+            continue;
+        }
+
+        // A process older than us only inherited a parent ID reused by us
+        ProcessMemoryStats child;
+        child.processId = entry.th32ProcessID;
+        child.name = ToUtf8(entry.szExeFile);
+        if (GetCreationTime(process) >= selfCreated && ReadMemoryCounters(process, child)) {
+            processes.push_back(std::move(child));
+        }
+        CloseHandle(process);
+    }
+
+    CloseHandle(snapshot);
+#endif
+
+    return processes;
+}
+
+void MemoryTracker::CheckBudget(size_t index, const char* name, uint64_t bytes, uint64_t budgetBytes)
+{
+    bool over = budgetBytes && bytes > budgetBytes;
+    if (over == m_overBudget[index]) {
+        return;
+    }
+
+    m_overBudget[index] = over;
+    if (over) {
+        m_app.GetErrorHandler().ReportError(ErrorSeverity::Warning,
+            fmt::format("{} over memory budget", name), "MemoryTracker",
+            fmt::format("{:.1f} MB of {:.0f} MB", ToMegabytes(bytes), ToMegabytes(budgetBytes)));
+    } else {
+        m_app.GetLogger().Info("{} back within memory budget ({:.1f} MB)", name, ToMegabytes(bytes));
+    }
+}
+
+} // namespace poe
@@ -1,14 +1,38 @@
 #include "core/Settings.h"
 #include "core/Application.h"
+#include "core/BinaryCache.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 
 namespace poe {
 
+namespace {
+
+// Binary cache of settings.json: one record per setting (key, value)
+constexpr uint32_t kSettingsCacheSchema = 1;
+constexpr uint32_t kSettingsCacheFields = 2;
+
+/**
+ * @brief Gets the path of the binary cache kept next to a settings file.
+ */
+std::filesystem::path GetCachePath(const std::filesystem::path& settingsPath)
+{
+    std::filesystem::path cachePath = settingsPath;
+    return cachePath.replace_extension(".cache");
+}
+
+} // namespace
+
 Settings::Settings(Application& app)
     : m_app(app)
     , m_dirty(false)
+    , m_snapshot(std::make_shared<const SettingsSnapshot>())
+    , m_nextCallbackId(1)
+    , m_savePending(false)
+    , m_saveThreadRunning(false)
+    , m_saveDelay(500)
 {
     // Set default settings file path
     auto appDataPath = std::filesystem::temp_directory_path() / "PoEOverlay";
@@ -28,10 +52,20 @@ bool Settings::Initialize()
         
         // Load settings from file or create defaults if file doesn't exist
         if (!Load()) {
-            CreateDefaultSettings();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                CreateDefaultSettings();
+            }
+            PublishSnapshot();
             Save();
         }
         
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_saveDelay = std::chrono::milliseconds((std::max)(Lookup("settings.saveDelayMs", 500), 0));
+        }
+        StartSaveThread();
+        
         return true;
     }
     catch (const std::exception& e) {
@@ -42,6 +76,8 @@ bool Settings::Initialize()
 
 void Settings::Shutdown()
 {
+    StopSaveThread();
+    
     // Save settings if they've been modified
     if (m_dirty) {
         Save();
@@ -56,39 +92,67 @@ bool Settings::HasSetting(const std::string& key) const
 
 bool Settings::RemoveSetting(const std::string& key)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    auto it = m_settings.find(key);
-    if (it != m_settings.end()) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_settings.find(key);
+        if (it == m_settings.end()) {
+            return false;
+        }
         m_settings.erase(it);
         m_dirty = true;
-        return true;
     }
-    return false;
+    
+    PublishSnapshot();
+    ScheduleSave();
+    return true;
 }
 
 bool Settings::Save()
 {
-    try {
+    // One writer at a time; the map lock is only held for the copy below
+    std::lock_guard<std::mutex> fileLock(m_fileMutex);
+    
+    std::unordered_map<std::string, std::any> settings;
+    std::filesystem::path filePath;
+    {
         std::lock_guard<std::mutex> lock(m_mutex);
-        
+        settings = m_settings;
+        filePath = m_settingsFilePath;
+        m_dirty = false;
+    }
+    
+    try {
         // Create directory if it doesn't exist
-        std::filesystem::create_directories(m_settingsFilePath.parent_path());
+        std::filesystem::create_directories(filePath.parent_path());
         
-        // Convert settings to JSON and write to file
-        auto json = SettingsToJson();
-        std::ofstream file(m_settingsFilePath);
+        // Write a temporary file and rename it over the old one, so a crash
+        // mid-write never leaves a truncated settings file behind
+        std::filesystem::path tempPath = filePath;
+        tempPath += ".tmp";
+        
+        std::ofstream file(tempPath, std::ios::out | std::ios::trunc);
         if (!file.is_open()) {
-            return false;
+            throw std::runtime_error("cannot open " + tempPath.string());
         }
         
-        file << json.dump(4); // Pretty print with 4-space indentation
+        file << SettingsToJson(settings).dump(4); // Pretty print with 4-space indentation
         file.close();
+        if (!file) {
+            throw std::runtime_error("cannot write " + tempPath.string());
+        }
         
-        m_dirty = false;
+        std::filesystem::rename(tempPath, filePath);
+        
+        // Stamped with the file just written, so the next start skips the parse
+        WriteCache(settings, filePath);
         return true;
     }
     catch (const std::exception& e) {
         std::cerr << "Failed to save settings: " << e.what() << std::endl;
+        
+        // Leave the change pending so the next save retries it
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_dirty = true;
         return false;
     }
 }
@@ -101,6 +165,12 @@ bool Settings::Load()
             return false;
         }
         
+        // The cache is current as long as the JSON has not been touched since
+        if (LoadCache()) {
+            PublishSnapshot();
+            return true;
+        }
+        
         // Read file into JSON
         std::ifstream file(m_settingsFilePath);
         if (!file.is_open()) {
@@ -112,10 +182,16 @@ bool Settings::Load()
         file.close();
         
         // Convert JSON to settings
-        std::lock_guard<std::mutex> lock(m_mutex);
-        JsonToSettings(json);
+        std::unordered_map<std::string, std::any> settings;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            JsonToSettings(json);
+            m_dirty = false;
+            settings = m_settings;
+        }
         
-        m_dirty = false;
+        PublishSnapshot();
+        WriteCache(settings, m_settingsFilePath);
         return true;
     }
     catch (const std::exception& e) {
@@ -126,10 +202,85 @@ bool Settings::Load()
 
 void Settings::Reset()
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_settings.clear();
-    CreateDefaultSettings();
-    m_dirty = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_settings.clear();
+        CreateDefaultSettings();
+        m_dirty = true;
+    }
+    
+    PublishSnapshot();
+    ScheduleSave();
+}
+
+size_t Settings::RegisterChangeCallback(const ChangeCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    
+    size_t callbackId = m_nextCallbackId++;
+    m_callbacks.push_back({callbackId, callback});
+    
+    return callbackId;
+}
+
+bool Settings::UnregisterChangeCallback(size_t callbackId)
+{
+    std::lock_guard<std::mutex> lock(m_callbacksMutex);
+    
+    for (auto it = m_callbacks.begin(); it != m_callbacks.end(); ++it) {
+        if (it->id == callbackId) {
+            m_callbacks.erase(it);
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void Settings::PublishSnapshot()
+{
+    std::shared_ptr<const SettingsSnapshot> published;
+    
+    // Build and store under the map lock so concurrent changes publish in order
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        auto snapshot = std::make_shared<SettingsSnapshot>();
+        const SettingsSnapshot defaults;
+        
+        snapshot->revision = m_snapshot.load(std::memory_order_relaxed)->revision + 1;
+        snapshot->windowX = Lookup("window.x", defaults.windowX);
+        snapshot->windowY = Lookup("window.y", defaults.windowY);
+        snapshot->windowWidth = Lookup("window.width", defaults.windowWidth);
+        snapshot->windowHeight = Lookup("window.height", defaults.windowHeight);
+        snapshot->windowOpacity = Lookup("window.opacity", defaults.windowOpacity);
+        snapshot->toggleHotkey = Lookup("hotkey.toggle", defaults.toggleHotkey);
+        snapshot->interactiveHotkey = Lookup("hotkey.interactive", defaults.interactiveHotkey);
+        snapshot->focusedFrameRate = Lookup("browser.focusedFrameRate", defaults.focusedFrameRate);
+        snapshot->idleFrameRate = Lookup("browser.idleFrameRate", defaults.idleFrameRate);
+        snapshot->hiddenFrameRate = Lookup("browser.hiddenFrameRate", defaults.hiddenFrameRate);
+        snapshot->suspendWhenHidden = Lookup("performance.suspendWhenHidden", defaults.suspendWhenHidden);
+        snapshot->throttleWhenGameActive = Lookup("performance.throttleWhenGameActive", defaults.throttleWhenGameActive);
+        
+        published = snapshot;
+        m_snapshot.store(std::move(snapshot), std::memory_order_release);
+    }
+    
+    // Copy callbacks to avoid holding lock during callbacks
+    std::vector<CallbackEntry> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_callbacksMutex);
+        callbacks = m_callbacks;
+    }
+    
+    for (const auto& entry : callbacks) {
+        try {
+            entry.callback(*published);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Exception in settings callback: " << e.what() << std::endl;
+        }
+    }
 }
 
 void Settings::SetSettingsFilePath(const std::filesystem::path& path)
@@ -143,13 +294,13 @@ const std::filesystem::path& Settings::GetSettingsFilePath() const
     return m_settingsFilePath;
 }
 
-nlohmann::json Settings::SettingsToJson() const
+nlohmann::json Settings::SettingsToJson(const std::unordered_map<std::string, std::any>& settings)
 {
     nlohmann::json json = nlohmann::json::object();
     
     // Convert settings to JSON
     // Note: This is limited to basic types that can be serialized to JSON
-    for (const auto& [key, value] : m_settings) {
+    for (const auto& [key, value] : settings) {
         if (value.type() == typeid(int)) {
             json[key] = std::any_cast<int>(value);
         }
@@ -193,22 +344,161 @@ void Settings::JsonToSettings(const nlohmann::json& json)
     }
 }
 
+bool Settings::LoadCache()
+{
+    BinaryCacheReader cache;
+    if (!cache.Open(GetCachePath(m_settingsFilePath), m_settingsFilePath, kSettingsCacheSchema, kSettingsCacheFields)) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_settings.clear();
+    
+    for (uint32_t i = 0; i < cache.GetRecordCount(); ++i) {
+        std::string key(cache.GetString(i, 0));
+        
+        switch (cache.GetType(i, 1)) {
+            case CacheValueType::Int:
+                m_settings[key] = static_cast<int>(cache.GetInt(i, 1));
+                break;
+            case CacheValueType::Double:
+                m_settings[key] = cache.GetDouble(i, 1);
+                break;
+            case CacheValueType::Bool:
+                m_settings[key] = cache.GetBool(i, 1);
+                break;
+            case CacheValueType::String:
+                m_settings[key] = std::string(cache.GetString(i, 1));
+                break;
+            default:
+                break;
+        }
+    }
+    
+    m_dirty = false;
+    return true;
+}
+
+void Settings::WriteCache(const std::unordered_map<std::string, std::any>& settings, const std::filesystem::path& filePath)
+{
+    BinaryCacheWriter cache(kSettingsCacheSchema, kSettingsCacheFields);
+    
+    // Same types SettingsToJson() persists; anything else is left to the JSON
+    for (const auto& [key, value] : settings) {
+        if (value.type() == typeid(int)) {
+            cache.AddString(key);
+            cache.AddInt(std::any_cast<int>(value));
+        }
+        else if (value.type() == typeid(double)) {
+            cache.AddString(key);
+            cache.AddDouble(std::any_cast<double>(value));
+        }
+        else if (value.type() == typeid(bool)) {
+            cache.AddString(key);
+            cache.AddBool(std::any_cast<bool>(value));
+        }
+        else if (value.type() == typeid(std::string)) {
+            cache.AddString(key);
+            cache.AddString(std::any_cast<const std::string&>(value));
+        }
+    }
+    
+    // A missing cache only costs a JSON parse at the next start
+    if (!cache.WriteFile(GetCachePath(filePath), filePath)) {
+        std::cerr << "Failed to write settings cache" << std::endl;
+    }
+}
+
+void Settings::ScheduleSave()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        if (!m_saveThreadRunning || m_savePending) {
+            return; // Not started yet, or already covered by the pending save
+        }
+        m_savePending = true;
+    }
+    m_saveCondition.notify_one();
+}
+
+void Settings::SaveThread()
+{
+    std::unique_lock<std::mutex> lock(m_saveMutex);
+    
+    while (m_saveThreadRunning) {
+        m_saveCondition.wait(lock, [this]() { return m_savePending || !m_saveThreadRunning; });
+        if (!m_savePending) {
+            continue;
+        }
+        
+        // Let the rest of a burst of changes land before writing; stopping cuts the wait short
+        m_saveCondition.wait_for(lock, m_saveDelay, [this]() { return !m_saveThreadRunning; });
+        
+        // Changes made from here on request a new save
+        m_savePending = false;
+        lock.unlock();
+        Save();
+        lock.lock();
+    }
+}
+
+void Settings::StartSaveThread()
+{
+    std::lock_guard<std::mutex> lock(m_saveMutex);
+    if (m_saveThreadRunning) {
+        return;
+    }
+    
+    m_saveThreadRunning = true;
+    m_saveThread = std::thread(&Settings::SaveThread, this);
+}
+
+void Settings::StopSaveThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        if (!m_saveThreadRunning) {
+            return;
+        }
+        m_saveThreadRunning = false;
+    }
+    
+    m_saveCondition.notify_one();
+    if (m_saveThread.joinable()) {
+        m_saveThread.join();
+    }
+}
+
 void Settings::CreateDefaultSettings()
 {
-    // Set default application settings
-    Set("window.width", 800);
-    Set("window.height", 600);
-    Set("window.x", 100);
-    Set("window.y", 100);
-    Set("window.opacity", 0.9);
-    Set("hotkey.toggle", "Alt+B");
-    Set("hotkey.interactive", "Alt+I");
-    Set("browser.homepage", "https://www.pathofexile.com");
-    Set("browser.searchEngine", "https://www.google.com/search?q=");
-    Set("browser.historyEnabled", true);
-    Set("browser.cookiesEnabled", true);
-    Set("performance.suspendWhenHidden", true);
-    Set("performance.throttleWhenGameActive", true);
+    // Set default application settings; strings are stored as std::string
+    // so they read back with Get<std::string>
+    m_settings["window.width"] = 800;
+    m_settings["window.height"] = 600;
+    m_settings["window.x"] = 100;
+    m_settings["window.y"] = 100;
+    m_settings["window.opacity"] = 0.9;
+    m_settings["hotkey.toggle"] = std::string("Alt+B");
+    m_settings["hotkey.interactive"] = std::string("Alt+I");
+    m_settings["input.lowLatencyHotkeys"] = false;
+    m_settings["browser.homepage"] = std::string("https://www.pathofexile.com");
+    m_settings["browser.searchEngine"] = std::string("https://www.google.com/search?q=");
+    m_settings["browser.historyEnabled"] = true;
+    m_settings["browser.cookiesEnabled"] = true;
+    m_settings["browser.gpuAcceleration"] = false;
+    m_settings["browser.lowFootprint"] = false;
+    m_settings["gameLog.path"] = std::string("C:/Program Files (x86)/Grinding Gear Games/Path of Exile/logs/Client.txt");
+    m_settings["performance.suspendWhenHidden"] = true;
+    m_settings["performance.throttleWhenGameActive"] = true;
+    m_settings["logging.async"] = true;
+    m_settings["logging.overflowPolicy"] = std::string("block");
+    m_settings["memory.sampleIntervalMs"] = 5000;
+    m_settings["memory.budgetMB.events"] = 16;
+    m_settings["memory.budgetMB.logs"] = 32;
+    m_settings["memory.budgetMB.resources"] = 256;
+    m_settings["memory.budgetMB.frameBuffers"] = 192;
+    m_settings["memory.budgetMB.gpuSurfaces"] = 256;
+    m_settings["memory.budgetMB.processes"] = 1536;
 }
 
 } // namespace poe
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include "core/StartupGraph.h"
+#include "core/Application.h"
+#include "core/Logger.h"
+#include "core/WorkerPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace poe {
+
+namespace {
+
+/**
+ * @brief Converts a steady-clock interval to fractional milliseconds.
+ */
+double ToMilliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+StartupGraph::StartupGraph(Application& app)
+    : m_app(app)
+    , m_finished(0)
+    , m_inFlight(0)
+    , m_failed(false)
+    , m_startTime(std::chrono::steady_clock::now())
+    , m_totalMs(0.0)
+{
+}
+
+void StartupGraph::AddStage(const std::string& name, std::vector<std::string> dependencies,
+                            StartupThread thread, Task task)
+{
+    Stage stage;
+    stage.name = name;
+    stage.dependencies = std::move(dependencies);
+    stage.thread = thread;
+    stage.task = std::move(task);
+    m_stages.push_back(std::move(stage));
+}
+
+bool StartupGraph::Run()
+{
+    // Resolve dependency names up front so a typo fails loudly rather than hanging
+    std::unordered_map<std::string, size_t> indices;
+    for (size_t i = 0; i < m_stages.size(); ++i) {
+        if (!indices.emplace(m_stages[i].name, i).second) {
+            throw std::runtime_error("Duplicate startup stage '" + m_stages[i].name + "'");
+        }
+    }
+
+    for (size_t i = 0; i < m_stages.size(); ++i) {
+        for (const auto& dependency : m_stages[i].dependencies) {
+            auto it = indices.find(dependency);
+            if (it == indices.end()) {
+                throw std::runtime_error("Startup stage '" + m_stages[i].name +
+                    "' depends on unknown stage '" + dependency + "'");
+            }
+            m_stages[it->second].dependents.push_back(i);
+            ++m_stages[i].pending;
+        }
+    }
+
+    m_startTime = std::chrono::steady_clock::now();
+    m_timings.reserve(m_stages.size());
+
+    std::vector<size_t> toPost;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (size_t i = 0; i < m_stages.size(); ++i) {
+        if (m_stages[i].pending == 0) {
+            Schedule(i, toPost);
+        }
+    }
+
+    while (m_finished < m_stages.size()) {
+        // Never post under the lock: a stopped pool runs the task inline
+        if (!toPost.empty()) {
+            lock.unlock();
+            Post(toPost);
+            toPost.clear();
+            lock.lock();
+            continue;
+        }
+
+        if (!m_mainReady.empty()) {
+            size_t index = m_mainReady.front();
+            m_mainReady.erase(m_mainReady.begin());
+
+            lock.unlock();
+            StageTiming timing = Execute(index);
+            lock.lock();
+
+            Complete(index, std::move(timing), toPost);
+            continue;
+        }
+
+        // Nothing ready and nothing running: the rest are waiting on each other
+        if (m_inFlight == 0) {
+            break;
+        }
+
+        m_condition.wait(lock);
+    }
+
+    m_totalMs = ToMilliseconds(std::chrono::steady_clock::now() - m_startTime);
+
+    if (m_finished < m_stages.size()) {
+        for (const auto& stage : m_stages) {
+            if (stage.pending > 0) {
+                m_app.GetLogger().Error("Startup stage '{}' is part of a dependency cycle", stage.name);
+            }
+        }
+        m_failed = true;
+    }
+
+    return !m_failed;
+}
+
+void StartupGraph::LogBreakdown() const
+{
+    Logger& logger = m_app.GetLogger();
+
+    double stageMs = 0.0;
+    for (const auto& timing : m_timings) {
+        stageMs += timing.durationMs;
+    }
+
+    logger.Info("Startup took {:.1f} ms for {} stages ({:.1f} ms of stage work, {:.2f}x overlap)",
+        m_totalMs, m_timings.size(), stageMs, m_totalMs > 0.0 ? stageMs / m_totalMs : 1.0);
+
+    std::vector<StageTiming> ordered = m_timings;
+    std::sort(ordered.begin(), ordered.end(), [](const StageTiming& a, const StageTiming& b) {
+        return a.startMs < b.startMs;
+    });
+
+    for (const auto& timing : ordered) {
+        logger.Info("  {:<24} +{:>7.1f} ms {:>7.1f} ms  {:<6}{}",
+            timing.name, timing.startMs, timing.durationMs,
+            timing.thread == StartupThread::Main ? "main" : "worker",
+            timing.skipped ? " skipped" : timing.succeeded ? "" : " FAILED");
+    }
+}
+
+StartupGraph::StageTiming StartupGraph::Execute(size_t index)
+{
+    const Stage& stage = m_stages[index];
+
+    StageTiming timing = { stage.name, stage.thread, 0.0, 0.0, false, false };
+    auto start = std::chrono::steady_clock::now();
+    timing.startMs = ToMilliseconds(start - m_startTime);
+
+    try {
+        timing.succeeded = stage.task();
+        if (!timing.succeeded) {
+            m_app.GetLogger().Error("Startup stage '{}' failed", stage.name);
+        }
+    }
+    catch (const std::exception& e) {
+        m_app.GetLogger().Error("Startup stage '{}' threw: {}", stage.name, e.what());
+    }
+
+    timing.durationMs = ToMilliseconds(std::chrono::steady_clock::now() - start);
+    return timing;
+}
+
+void StartupGraph::Complete(size_t index, StageTiming timing, std::vector<size_t>& toPost)
+{
+    bool succeeded = timing.succeeded;
+    m_timings.push_back(std::move(timing));
+    ++m_finished;
+
+    if (!succeeded) {
+        m_failed = true;
+    }
+
+    for (size_t dependent : m_stages[index].dependents) {
+        Stage& stage = m_stages[dependent];
+        if (!succeeded) {
+            stage.blocked = true;
+        }
+        if (--stage.pending == 0) {
+            Schedule(dependent, toPost);
+        }
+    }
+}
+
+void StartupGraph::Schedule(size_t index, std::vector<size_t>& toPost)
+{
+    Stage& stage = m_stages[index];
+
+    if (stage.blocked) {
+        double now = ToMilliseconds(std::chrono::steady_clock::now() - m_startTime);
+        Complete(index, { stage.name, stage.thread, now, 0.0, false, true }, toPost);
+        return;
+    }
+
+    if (stage.thread == StartupThread::Main) {
+        m_mainReady.push_back(index);
+        return;
+    }
+
+    ++m_inFlight;
+    toPost.push_back(index);
+}
+
+void StartupGraph::Post(const std::vector<size_t>& toPost)
+{
+    for (size_t index : toPost) {
+        m_app.GetWorkerPool().Post([this, index]() {
+            StageTiming timing = Execute(index);
+
+            // Notify under the lock: once the last stage is in, Run() may return and destroy the graph
+            std::vector<size_t> ready;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                Complete(index, std::move(timing), ready);
+                --m_inFlight;
+                m_condition.notify_one();
+            }
+
+            if (!ready.empty()) {
+                Post(ready);
+            }
+        });
+    }
+}
+
+} // namespace poe
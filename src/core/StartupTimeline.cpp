@@ -0,0 +1,91 @@
+#include "core/StartupTimeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <iterator>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace poe {
+
+namespace {
+
+constexpr size_t kMilestoneCount = static_cast<size_t>(StartupMilestone::Count);
+
+constexpr const char* kMilestoneNames[] = {
+    "initializeBegin",
+    "initializeEnd",
+    "cefInitialized",
+    "firstPaint",
+    "firstCommit",
+};
+
+static_assert(std::size(kMilestoneNames) == kMilestoneCount, "Every StartupMilestone needs a name");
+
+// Microseconds since process creation plus one; zero means not reached
+std::atomic<int64_t> g_marks[kMilestoneCount];
+
+/**
+ * @brief Gets the time since process creation in microseconds.
+ */
+int64_t ProcessAgeMicroseconds() noexcept
+{
+#ifdef _WIN32
+    // FILETIME ticks are 100 ns; creation time is fixed, so read it once
+    static const uint64_t creationTicks = []() {
+        FILETIME creation = {}, exitTime = {}, kernel = {}, user = {};
+        GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user);
+        return (static_cast<uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+    }();
+
+    FILETIME now = {};
+    GetSystemTimePreciseAsFileTime(&now);
+    uint64_t nowTicks = (static_cast<uint64_t>(now.dwHighDateTime) << 32) | now.dwLowDateTime;
+    return nowTicks > creationTicks ? static_cast<int64_t>((nowTicks - creationTicks) / 10) : 0;
+#else
+    // No portable creation time; measure from the first call instead
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+#endif
+}
+
+} // namespace
+
+void StartupTimeline::Mark(StartupMilestone milestone) noexcept
+{
+    size_t index = static_cast<size_t>(milestone);
+    if (index >= kMilestoneCount || g_marks[index].load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+
+    int64_t expected = 0;
+    g_marks[index].compare_exchange_strong(expected, ProcessAgeMicroseconds() + 1, std::memory_order_relaxed);
+}
+
+bool StartupTimeline::HasReached(StartupMilestone milestone) noexcept
+{
+    size_t index = static_cast<size_t>(milestone);
+    return index < kMilestoneCount && g_marks[index].load(std::memory_order_relaxed) != 0;
+}
+
+double StartupTimeline::GetMilliseconds(StartupMilestone milestone) noexcept
+{
+    size_t index = static_cast<size_t>(milestone);
+    int64_t mark = index < kMilestoneCount ? g_marks[index].load(std::memory_order_relaxed) : 0;
+    return mark != 0 ? static_cast<double>(mark - 1) / 1000.0 : -1.0;
+}
+
+double StartupTimeline::GetProcessAgeMilliseconds() noexcept
+{
+    return static_cast<double>(ProcessAgeMicroseconds()) / 1000.0;
+}
+
+const char* StartupTimeline::GetName(StartupMilestone milestone) noexcept
+{
+    size_t index = static_cast<size_t>(milestone);
+    return index < kMilestoneCount ? kMilestoneNames[index] : "unknown";
+}
+
+} // namespace poe
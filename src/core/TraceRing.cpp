@@ -0,0 +1,246 @@
+#include "core/TraceRing.h"
+#include "core/Application.h"
+#include "core/Logger.h"
+#include "core/Settings.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iterator>
+#include <spdlog/fmt/fmt.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <functional>
+#include <thread>
+#endif
+
+namespace poe {
+
+namespace {
+
+// About 400 KB; covers several seconds of busy input and paint traffic
+constexpr int kDefaultCapacity = 8192;
+
+/**
+ * @brief How an event is presented in the Chrome trace export.
+ */
+struct EventDescriptor {
+    const char* name;          ///< Event name
+    const char* argNames[3];   ///< Argument names; nullptr for unused arguments
+    int durationArg;           ///< Index of the argument holding a duration in us, or -1
+};
+
+constexpr EventDescriptor kEventDescriptors[] = {
+    { "EventPublished",      { "type", nullptr, nullptr },                  -1 },
+    { "EventDispatched",     { "type", "handlers", "durationUs" },           2 },
+    { "FocusChanged",        { "window", "processId", "previousProcessId" }, -1 },
+    { "InputStateChanged",   { "mode", "keyboard", "mouse" },               -1 },
+    { "CefPaint",            { "element", "dirtyRects", "durationUs" },      2 },
+    { "CefAcceleratedPaint", { "element", "dirtyRects", "durationUs" },      2 },
+    { "ErrorReported",       { "severity", nullptr, nullptr },              -1 },
+    { "HotkeyPressed",       { "hotkey", "virtualKey", "modifiers" },       -1 },
+    { "BrowserInputSent",    { "kind", "xOrKey", "y" },                     -1 },
+    { "ContentCommitted",    { "sharedTexture", "dirtyRects", nullptr },    -1 },
+};
+
+static_assert(std::size(kEventDescriptors) == static_cast<size_t>(TraceEvent::Count),
+    "Every TraceEvent needs a descriptor");
+
+/**
+ * @brief Gets the OS ID of the calling thread, cached per thread.
+ */
+uint32_t CurrentThreadId()
+{
+#ifdef _WIN32
+    thread_local uint32_t id = static_cast<uint32_t>(GetCurrentThreadId());
+#else
+    thread_local uint32_t id = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+    return id;
+}
+
+} // namespace
+
+TraceRing::TraceRing(Application& app)
+    : m_app(app)
+    , m_slotCharge(MemoryTag::Logs)
+    , m_mask(0)
+    , m_head(0)
+    , m_enabled(false)
+    , m_startTime(std::chrono::steady_clock::now())
+{
+}
+
+TraceRing::~TraceRing()
+{
+    Shutdown();
+}
+
+bool TraceRing::Initialize()
+{
+    if (m_slots) {
+        return true;
+    }
+
+    auto& settings = m_app.GetSettings();
+    int capacity = (std::max)(settings.Get<int>("trace.capacity", kDefaultCapacity), 64);
+
+    // A power of two turns the slot lookup into a mask
+    uint64_t size = std::bit_ceil(static_cast<uint64_t>(capacity));
+    m_slots = std::make_unique<Slot[]>(static_cast<size_t>(size));
+    m_slotCharge.Set(static_cast<size_t>(size) * sizeof(Slot));
+    m_mask = size - 1;
+    m_head.store(0, std::memory_order_relaxed);
+    m_startTime = std::chrono::steady_clock::now();
+
+    m_enabled.store(settings.Get<bool>("trace.enabled", true), std::memory_order_release);
+
+    m_app.GetLogger().Debug("TraceRing initialized with {} slots", size);
+    return true;
+}
+
+void TraceRing::Shutdown()
+{
+    // Emitters on other threads may still be running; the slots outlive them
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+void TraceRing::Emit(TraceEvent event, int64_t arg0, int64_t arg1, int64_t arg2)
+{
+    if (!m_enabled.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    uint64_t index = m_head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_slots[index & m_mask];
+
+    // Mark the slot busy before touching the record, publish it after
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.record.timestampUs = ToTimestampUs(std::chrono::steady_clock::now());
+    slot.record.threadId = CurrentThreadId();
+    slot.record.event = event;
+    slot.record.args[0] = arg0;
+    slot.record.args[1] = arg1;
+    slot.record.args[2] = arg2;
+
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+uint64_t TraceRing::ToTimestampUs(std::chrono::steady_clock::time_point time) const
+{
+    if (time <= m_startTime) {
+        return 0;
+    }
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(time - m_startTime).count());
+}
+
+std::vector<TraceRecord> TraceRing::Snapshot() const
+{
+    std::vector<TraceRecord> records;
+    if (!m_slots) {
+        return records;
+    }
+
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t capacity = m_mask + 1;
+    uint64_t first = head > capacity ? head - capacity : 0;
+    records.reserve(static_cast<size_t>(head - first));
+
+    for (uint64_t index = first; index < head; ++index) {
+        const Slot& slot = m_slots[index & m_mask];
+
+        // Skip slots that are mid-write or were lapped by a newer record
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != index + 1) {
+            continue;
+        }
+
+        TraceRecord record = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            records.push_back(record);
+        }
+    }
+
+    return records;
+}
+
+std::string TraceRing::ExportChromeTrace() const
+{
+    std::vector<TraceRecord> records = Snapshot();
+
+    std::string json;
+    json.reserve(records.size() * 128 + 256);
+    auto out = std::back_inserter(json);
+
+    fmt::format_to(out, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fmt::format_to(out, "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{{\"name\":\"{}\"}}}}",
+        m_app.GetAppName());
+
+    for (const auto& record : records) {
+        size_t eventIndex = static_cast<size_t>(record.event);
+        if (eventIndex >= std::size(kEventDescriptors)) {
+            continue;
+        }
+
+        const EventDescriptor& descriptor = kEventDescriptors[eventIndex];
+
+        // Durations are recorded at the end of the scope; Chrome wants the start
+        if (descriptor.durationArg >= 0) {
+            int64_t duration = (std::max<int64_t>)(record.args[descriptor.durationArg], 0);
+            uint64_t start = record.timestampUs - (std::min)(record.timestampUs, static_cast<uint64_t>(duration));
+            fmt::format_to(out, ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{},\"dur\":{},\"args\":{{",
+                descriptor.name, record.threadId, start, duration);
+        }
+        else {
+            fmt::format_to(out, ",\n{{\"name\":\"{}\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":{},\"ts\":{},\"args\":{{",
+                descriptor.name, record.threadId, record.timestampUs);
+        }
+
+        bool firstArg = true;
+        for (int i = 0; i < 3; ++i) {
+            if (!descriptor.argNames[i] || i == descriptor.durationArg) {
+                continue;
+            }
+            fmt::format_to(out, "{}\"{}\":{}", firstArg ? "" : ",", descriptor.argNames[i], record.args[i]);
+            firstArg = false;
+        }
+
+        json += "}}";
+    }
+
+    json += "\n]}\n";
+    return json;
+}
+
+bool TraceRing::DumpToFile(const std::filesystem::path& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) {
+        m_app.GetLogger().Error("Failed to open trace dump file: {}", path.string());
+        return false;
+    }
+
+    file << ExportChromeTrace();
+    if (!file) {
+        m_app.GetLogger().Error("Failed to write trace dump file: {}", path.string());
+        return false;
+    }
+
+    m_app.GetLogger().Info("Event trace written to {}", path.string());
+    return true;
+}
+
+const char* TraceRing::GetEventName(TraceEvent event)
+{
+    size_t eventIndex = static_cast<size_t>(event);
+    return eventIndex < std::size(kEventDescriptors) ? kEventDescriptors[eventIndex].name : "Unknown";
+}
+
+} // namespace poe
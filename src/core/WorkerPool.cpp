@@ -0,0 +1,103 @@
+#include "core/WorkerPool.h"
+#include "core/Application.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+
+#include <algorithm>
+
+namespace poe {
+
+WorkerPool::WorkerPool(Application& app)
+    : m_app(app)
+    , m_running(false)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    Shutdown();
+}
+
+bool WorkerPool::Initialize(size_t threadCount)
+{
+    if (m_running) {
+        return true;
+    }
+
+    if (threadCount == 0) {
+        // Leave one core for the render and CEF threads
+        size_t cores = std::thread::hardware_concurrency();
+        threadCount = std::clamp<size_t>(cores > 1 ? cores - 1 : 1, 1, 4);
+    }
+
+    m_running = true;
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&WorkerPool::WorkerThread, this);
+    }
+
+    m_app.GetLogger().Debug("WorkerPool initialized with {} threads", static_cast<int>(threadCount));
+    return true;
+}
+
+void WorkerPool::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+
+    m_condition.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+}
+
+void WorkerPool::Post(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_running) {
+            m_tasks.push_back(std::move(task));
+            m_condition.notify_one();
+            return;
+        }
+    }
+
+    // Not running: do the work on the caller rather than lose it
+    task();
+}
+
+void WorkerPool::WorkerThread()
+{
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return !m_running || !m_tasks.empty(); });
+
+            // Drain whatever is queued before exiting so futures are always satisfied
+            if (m_tasks.empty()) {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        try {
+            task();
+        }
+        catch (const std::exception& ex) {
+            m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "WorkerPool");
+        }
+    }
+}
+
+} // namespace poe
@@ -14,6 +14,12 @@
  */
 int main(int argc, char* argv[])
 {
+#ifdef _WIN32
+    // Render at each monitor's native resolution instead of being bitmap-stretched
+    // by DWM; must happen before any window is created
+    SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+#endif
+
     try {
         // Create the application instance
         poe::Application app("PoEOverlay");
@@ -1,14 +1,17 @@
 #include "process/focus_tracker.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/TraceRing.h"
 
 #include <iostream>
 
 namespace poe {
 
-FocusTracker::FocusTracker(Application& app)
+FocusTracker::FocusTracker(Application& app, WinEventHookService& hookService)
     : m_app(app)
+    , m_hookService(hookService)
     , m_initialized(false)
+    , m_hookSubscriptionId(0)
     , m_nextCallbackId(1)
 {
     // Initialize last focus info
@@ -26,7 +29,9 @@ FocusTracker::~FocusTracker()
 
 FocusTracker::FocusTracker(FocusTracker&& other) noexcept
     : m_app(other.m_app)
+    , m_hookService(other.m_hookService)
     , m_initialized(other.m_initialized)
+    , m_hookSubscriptionId(0)
     , m_nextCallbackId(other.m_nextCallbackId)
 {
     // Move focus info
@@ -37,6 +42,14 @@ FocusTracker::FocusTracker(FocusTracker&& other) noexcept
     std::lock_guard<std::mutex> callbackLock(other.m_callbacksMutex);
     m_callbacks = std::move(other.m_callbacks);
     
+    // Hook callbacks are bound to an instance; move the subscription over
+    if (other.m_hookSubscriptionId != 0)
+    {
+        m_hookService.Unsubscribe(other.m_hookSubscriptionId);
+        other.m_hookSubscriptionId = 0;
+        SubscribeToHookService();
+    }
+    
     // Reset the moved-from object
     other.m_initialized = false;
     other.m_nextCallbackId = 1;
@@ -65,6 +78,14 @@ FocusTracker& FocusTracker::operator=(FocusTracker&& other) noexcept
             m_callbacks = std::move(other.m_callbacks);
         }
         
+        // Hook callbacks are bound to an instance; move the subscription over
+        if (other.m_hookSubscriptionId != 0)
+        {
+            m_hookService.Unsubscribe(other.m_hookSubscriptionId);
+            other.m_hookSubscriptionId = 0;
+            SubscribeToHookService();
+        }
+        
         // Reset the moved-from object
         other.m_initialized = false;
         other.m_nextCallbackId = 1;
@@ -84,11 +105,15 @@ bool FocusTracker::Initialize()
     {
         Log(2, "Initializing FocusTracker");
         
+        m_initialized = true;
+        
+        // Receive foreground changes as they happen instead of polling
+        SubscribeToHookService();
+        
         // Get initial focus state
         HWND currentFocus = GetForegroundWindow();
         UpdateFocusInfo(currentFocus);
         
-        m_initialized = true;
         Log(2, "FocusTracker initialized successfully");
         return true;
     }
@@ -108,6 +133,12 @@ void FocusTracker::Shutdown()
     
     Log(2, "Shutting down FocusTracker");
     
+    if (m_hookSubscriptionId != 0)
+    {
+        m_hookService.Unsubscribe(m_hookSubscriptionId);
+        m_hookSubscriptionId = 0;
+    }
+    
     // Clear callbacks
     {
         std::lock_guard<std::mutex> lock(m_callbacksMutex);
@@ -160,11 +191,12 @@ bool FocusTracker::HasProcessFocus(DWORD processId) const
 
 void FocusTracker::Update()
 {
-    if (!m_initialized)
+    if (!m_initialized || m_hookService.IsActive())
     {
         return;
     }
     
+    // Polling fallback when the hooks could not be installed
     HWND currentFocus = GetForegroundWindow();
     UpdateFocusInfo(currentFocus);
 }
@@ -246,6 +278,14 @@ bool FocusTracker::UpdateFocusInfo(HWND currentWindow)
     return focusChanged;
 }
 
+void FocusTracker::SubscribeToHookService()
+{
+    m_hookSubscriptionId = m_hookService.Subscribe(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+        [this](const WinEventInfo& info) {
+            UpdateFocusInfo(info.windowHandle);
+        });
+}
+
 bool FocusTracker::GetWindowInfo(HWND windowHandle, std::wstring& title, DWORD& processId) const
 {
     if (!windowHandle || !IsWindow(windowHandle))
@@ -268,6 +308,10 @@ bool FocusTracker::GetWindowInfo(HWND windowHandle, std::wstring& title, DWORD&
 
 void FocusTracker::NotifyFocusChange(const FocusChangeInfo& info)
 {
+    m_app.GetTraceRing().Emit(TraceEvent::FocusChanged,
+        static_cast<int64_t>(reinterpret_cast<intptr_t>(info.currentWindow)),
+        info.currentProcessId, info.previousProcessId);
+    
     // Copy callbacks to avoid holding lock during callbacks
     std::vector<CallbackEntry> callbacks;
     {
@@ -289,29 +333,4 @@ void FocusTracker::NotifyFocusChange(const FocusChangeInfo& info)
     }
 }
 
-template<typename... Args>
-void FocusTracker::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try
-    {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "FocusTracker log error: " << e.what() << std::endl;
-    }
-}
-
 } // namespace poe
\ No newline at end of file
@@ -0,0 +1,645 @@
+#include "process/game_log_reader.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+#include "core/Settings.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace poe {
+
+namespace {
+
+/// Where the game writes its log unless the settings say otherwise
+constexpr const char* kDefaultLogPath = "C:/Program Files (x86)/Grinding Gear Games/Path of Exile/logs/Client.txt";
+
+/// An unfinished line longer than this is dropped rather than buffered further
+constexpr size_t kMaxLineLength = 1024 * 1024;
+
+/// Size of the buffer receiving FILE_NOTIFY_INFORMATION records
+constexpr DWORD kNotifyBufferSize = 16 * 1024;
+
+/// Length of the "YYYY/MM/DD HH:MM:SS" every game line starts with
+constexpr size_t kTimestampLength = 19;
+
+constexpr std::string_view kZonePrefix = ": You have entered ";
+constexpr std::string_view kWhisperFromPrefix = "@From ";
+constexpr std::string_view kWhisperToPrefix = "@To ";
+constexpr std::string_view kStashTabPrefix = " (stash tab \"";
+constexpr std::string_view kPositionPrefix = "\"; position: left ";
+constexpr std::string_view kTopPrefix = ", top ";
+
+/**
+ * @brief Whisper formats of the trade site: the greeting, and what separates item from price.
+ */
+struct TradeFormat {
+    std::string_view greeting;
+    std::string_view priceSeparator;
+};
+
+constexpr TradeFormat kTradeFormats[] = {
+    { "Hi, I would like to buy your ", " listed for " },  // Single items
+    { "Hi, I'd like to buy your ", " for my " },          // Bulk currency exchange
+};
+
+const char* ChannelName(ChatChannel channel)
+{
+    switch (channel)
+    {
+        case ChatChannel::WhisperFrom: return "whisper from";
+        case ChatChannel::WhisperTo:   return "whisper to";
+        case ChatChannel::Global:      return "global";
+        case ChatChannel::Trade:       return "trade";
+        case ChatChannel::Party:       return "party";
+        case ChatChannel::Guild:       return "guild";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Maps the character a channel message starts with to its channel.
+ * @return False if the character marks no channel.
+ */
+bool ChannelFromPrefix(char prefix, ChatChannel& channel)
+{
+    switch (prefix)
+    {
+        case '#': channel = ChatChannel::Global; return true;
+        case '$': channel = ChatChannel::Trade;  return true;
+        case '%': channel = ChatChannel::Party;  return true;
+        case '&': channel = ChatChannel::Guild;  return true;
+        default:  return false;
+    }
+}
+
+bool StartsWith(std::string_view text, std::string_view prefix)
+{
+    return text.size() >= prefix.size() && text.substr(0, prefix.size()) == prefix;
+}
+
+/**
+ * @brief Reads the number a value starts with.
+ */
+int ParseLeadingNumber(std::string_view value)
+{
+    int number = 0;
+    for (size_t i = 0; i < value.size() && value[i] >= '0' && value[i] <= '9' && number < 100000; ++i)
+    {
+        number = number * 10 + (value[i] - '0');
+    }
+    return number;
+}
+
+/**
+ * @brief Fills a TradeRequestEvent from a whisper in one of the trade site's formats.
+ * @return False if the message is not a trade whisper.
+ */
+bool ParseTradeWhisper(std::string_view message, TradeRequestEvent& request)
+{
+    for (const TradeFormat& format : kTradeFormats)
+    {
+        if (!StartsWith(message, format.greeting))
+        {
+            continue;
+        }
+        std::string_view rest = message.substr(format.greeting.size());
+
+        // Prices never contain " in ", so the league starts at the first one after the price
+        size_t priceStart = rest.find(format.priceSeparator);
+        size_t leagueStart = rest.find(" in ", priceStart != std::string_view::npos ? priceStart : 0);
+        if (leagueStart == std::string_view::npos)
+        {
+            return false;
+        }
+        request.item = rest.substr(0, (std::min)(priceStart, leagueStart));
+        if (priceStart != std::string_view::npos)
+        {
+            size_t priceOffset = priceStart + format.priceSeparator.size();
+            request.price = rest.substr(priceOffset, leagueStart - priceOffset);
+        }
+
+        // The league ends where the stash position starts, or at the end of the sentence
+        leagueStart += 4;
+        size_t leagueEnd = rest.find(kStashTabPrefix, leagueStart);
+        if (leagueEnd == std::string_view::npos)
+        {
+            leagueEnd = (std::min)(rest.find('.', leagueStart), rest.size());
+        }
+        request.league = rest.substr(leagueStart, leagueEnd - leagueStart);
+
+        // (stash tab "~price 5 chaos"; position: left 3, top 7)
+        if (leagueEnd < rest.size() && StartsWith(rest.substr(leagueEnd), kStashTabPrefix))
+        {
+            std::string_view stash = rest.substr(leagueEnd + kStashTabPrefix.size());
+            size_t tabEnd = stash.find(kPositionPrefix);
+            if (tabEnd != std::string_view::npos)
+            {
+                request.stashTab = stash.substr(0, tabEnd);
+                std::string_view position = stash.substr(tabEnd + kPositionPrefix.size());
+                request.left = ParseLeadingNumber(position);
+                size_t top = position.find(kTopPrefix);
+                if (top != std::string_view::npos)
+                {
+                    request.top = ParseLeadingNumber(position.substr(top + kTopPrefix.size()));
+                }
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+std::string ZoneChangedEvent::ToString() const
+{
+    return "ZoneChangedEvent(" + zone + ")";
+}
+
+std::string ChatMessageEvent::ToString() const
+{
+    return std::string("ChatMessageEvent(") + ChannelName(channel) + ", " + sender + ")";
+}
+
+std::string TradeRequestEvent::ToString() const
+{
+    return "TradeRequestEvent(" + std::string(incoming ? "from " : "to ") + player + ", " + item + ")";
+}
+
+GameLogReader::GameLogReader(Application& app, const GameLogConfig& config)
+    : m_app(app)
+    , m_config(config)
+    , m_initialized(false)
+    , m_stopEvent(nullptr)
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_directory(INVALID_HANDLE_VALUE)
+    , m_directoryOverlapped{}
+    , m_pendingSize(0)
+    , m_offset(0)
+    , m_savedOffset(0)
+    , m_hasIdentity(false)
+{
+}
+
+GameLogReader::~GameLogReader()
+{
+    Shutdown();
+}
+
+bool GameLogReader::Initialize()
+{
+    if (m_initialized)
+    {
+        return true;
+    }
+
+    try
+    {
+        Log(2, "Initializing GameLogReader");
+
+        if (m_config.logPath.empty())
+        {
+            m_config.logPath = m_app.GetSettings().Get<std::string>("gameLog.path", kDefaultLogPath);
+        }
+        if (m_config.offsetPath.empty())
+        {
+            m_config.offsetPath = std::filesystem::temp_directory_path() / "PoEOverlay" / "client_log.offset";
+        }
+        std::error_code error;
+        std::filesystem::create_directories(m_config.offsetPath.parent_path(), error);
+
+        m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!m_stopEvent)
+        {
+            Log(4, "Failed to create the stop event (error {})", static_cast<int>(GetLastError()));
+            return false;
+        }
+
+        m_readerThread = std::make_unique<std::thread>(&GameLogReader::ReaderThread, this);
+
+        m_initialized = true;
+        Log(2, "GameLogReader initialized, tailing {}", m_config.logPath.string());
+        return true;
+    }
+    catch (const std::exception& ex)
+    {
+        m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "GameLogReader");
+        return false;
+    }
+}
+
+void GameLogReader::Shutdown()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    Log(2, "Shutting down GameLogReader");
+
+    // The thread saves the offset on its way out
+    SetEvent(m_stopEvent);
+    if (m_readerThread && m_readerThread->joinable())
+    {
+        m_readerThread->join();
+    }
+    m_readerThread.reset();
+
+    CloseHandle(m_stopEvent);
+    m_stopEvent = nullptr;
+
+    m_initialized = false;
+    Log(2, "GameLogReader shutdown complete");
+}
+
+bool GameLogReader::ParseLine(std::string_view line)
+{
+    // 2024/01/15 12:34:56 123456789 cff945b9 [INFO Client 1234] message
+    if (line.size() <= kTimestampLength || line[4] != '/' || line[kTimestampLength] != ' ')
+    {
+        return false;
+    }
+
+    size_t tagEnd = line.find("] ", kTimestampLength);
+    if (tagEnd == std::string_view::npos)
+    {
+        return false;
+    }
+    std::string_view logTime = line.substr(0, kTimestampLength);
+    std::string_view message = line.substr(tagEnd + 2);
+
+    if (StartsWith(message, kZonePrefix) && message.back() == '.')
+    {
+        std::string_view zone = message.substr(kZonePrefix.size(), message.size() - kZonePrefix.size() - 1);
+        m_app.GetEventSystem().Publish(ZoneChangedEvent(std::string(zone), std::string(logTime)));
+        return true;
+    }
+
+    ChatChannel channel;
+    if (StartsWith(message, kWhisperFromPrefix))
+    {
+        channel = ChatChannel::WhisperFrom;
+        message.remove_prefix(kWhisperFromPrefix.size());
+    }
+    else if (StartsWith(message, kWhisperToPrefix))
+    {
+        channel = ChatChannel::WhisperTo;
+        message.remove_prefix(kWhisperToPrefix.size());
+    }
+    else if (!message.empty() && ChannelFromPrefix(message.front(), channel))
+    {
+        message.remove_prefix(1);
+    }
+    else
+    {
+        return false;
+    }
+
+    // "<GUILD> Name: text"; names cannot contain ':' or spaces
+    if (!message.empty() && message.front() == '<')
+    {
+        size_t guildEnd = message.find("> ");
+        if (guildEnd == std::string_view::npos)
+        {
+            return false;
+        }
+        message.remove_prefix(guildEnd + 2);
+    }
+
+    size_t nameEnd = message.find(": ");
+    if (nameEnd == std::string_view::npos || nameEnd == 0)
+    {
+        return false;
+    }
+    std::string_view sender = message.substr(0, nameEnd);
+    std::string_view text = message.substr(nameEnd + 2);
+
+    if (channel == ChatChannel::WhisperFrom || channel == ChatChannel::WhisperTo)
+    {
+        TradeRequestEvent request;
+        if (ParseTradeWhisper(text, request))
+        {
+            request.incoming = channel == ChatChannel::WhisperFrom;
+            request.player = sender;
+            request.logTime = logTime;
+            m_app.GetEventSystem().Publish(request);
+        }
+    }
+
+    m_app.GetEventSystem().Publish(ChatMessageEvent(channel, std::string(sender), std::string(text), std::string(logTime)));
+    return true;
+}
+
+void GameLogReader::ReaderThread()
+{
+    try
+    {
+        m_directoryOverlapped = {};
+        m_directoryOverlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        m_notifyBuffer.resize(kNotifyBufferSize);
+        m_nextSave = std::chrono::steady_clock::now() + m_config.saveInterval;
+
+        bool watching = WatchDirectory();
+        if (!watching)
+        {
+            Log(3, "Cannot watch {} (error {}), checking every {} ms",
+                m_config.logPath.parent_path().string(), static_cast<int>(GetLastError()),
+                static_cast<int>(m_config.pollInterval.count()));
+        }
+
+        if (OpenLog())
+        {
+            ReadAppended();
+        }
+
+        while (true)
+        {
+            HANDLE waitHandles[2] = { m_stopEvent, m_directoryOverlapped.hEvent };
+            DWORD result = WaitForMultipleObjects(watching ? 2 : 1, waitHandles, FALSE,
+                static_cast<DWORD>(m_config.pollInterval.count()));
+            if (result == WAIT_OBJECT_0)
+            {
+                break;
+            }
+
+            if (watching && result == WAIT_OBJECT_0 + 1)
+            {
+                // Zero bytes means the notifications overflowed; reading the log covers that too
+                DWORD bytes = 0;
+                if (GetOverlappedResult(m_directory, &m_directoryOverlapped, &bytes, FALSE) &&
+                    bytes > 0 && LogReplaced())
+                {
+                    Log(2, "{} was removed or renamed, reopening", m_config.logPath.filename().string());
+                    CloseLog();
+                }
+                watching = WatchDirectory();
+            }
+            else if (!watching)
+            {
+                // The directory may only exist once the game is installed
+                watching = WatchDirectory();
+            }
+
+            if (m_file != INVALID_HANDLE_VALUE || OpenLog())
+            {
+                ReadAppended();
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now >= m_nextSave)
+            {
+                SaveOffset();
+                m_nextSave = now + m_config.saveInterval;
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "GameLogReader");
+    }
+
+    if (m_directory != INVALID_HANDLE_VALUE)
+    {
+        // The notification writes into our buffer until the cancellation completes
+        DWORD bytes = 0;
+        if (CancelIoEx(m_directory, &m_directoryOverlapped) || GetLastError() != ERROR_NOT_FOUND)
+        {
+            GetOverlappedResult(m_directory, &m_directoryOverlapped, &bytes, TRUE);
+        }
+        CloseHandle(m_directory);
+        m_directory = INVALID_HANDLE_VALUE;
+    }
+    if (m_directoryOverlapped.hEvent)
+    {
+        CloseHandle(m_directoryOverlapped.hEvent);
+        m_directoryOverlapped.hEvent = nullptr;
+    }
+
+    SaveOffset();
+    CloseLog();
+}
+
+bool GameLogReader::OpenLog()
+{
+    m_file = CreateFileW(m_config.logPath.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    BY_HANDLE_FILE_INFORMATION info = {};
+    LARGE_INTEGER size = {};
+    if (!GetFileInformationByHandle(m_file, &info) || !GetFileSizeEx(m_file, &size))
+    {
+        Log(3, "Cannot query {} (error {})", m_config.logPath.string(), static_cast<int>(GetLastError()));
+        CloseLog();
+        return false;
+    }
+
+    FileIdentity identity;
+    identity.volumeSerial = info.dwVolumeSerialNumber;
+    identity.fileIndex = static_cast<uint64_t>(info.nFileIndexHigh) << 32 | info.nFileIndexLow;
+    uint64_t fileSize = static_cast<uint64_t>(size.QuadPart);
+
+    bool sameFile = m_hasIdentity &&
+        identity.volumeSerial == m_identity.volumeSerial && identity.fileIndex == m_identity.fileIndex;
+    if (sameFile)
+    {
+        // Reopened after a rename back; carry on, unfinished line included
+        return true;
+    }
+
+    uint64_t offset = 0;
+    FileIdentity savedIdentity;
+    uint64_t savedOffset = 0;
+    if (m_hasIdentity)
+    {
+        // A new log replaced the one we were reading; it is new, so read all of it
+        Log(2, "Reading new {} from the start", m_config.logPath.filename().string());
+    }
+    else if (LoadOffset(savedIdentity, savedOffset) &&
+        savedIdentity.volumeSerial == identity.volumeSerial && savedIdentity.fileIndex == identity.fileIndex)
+    {
+        offset = savedOffset;
+        Log(2, "Resuming {} at offset {} of {}", m_config.logPath.filename().string(), offset, fileSize);
+    }
+    else
+    {
+        // Skip the history of a log we have not read before
+        offset = fileSize;
+        Log(2, "Tailing {} from its end at {}", m_config.logPath.filename().string(), offset);
+    }
+
+    m_identity = identity;
+    m_hasIdentity = true;
+    m_pendingSize = 0;
+    m_offset.store(offset, std::memory_order_relaxed);
+    m_savedOffset = UINT64_MAX;
+    return true;
+}
+
+void GameLogReader::CloseLog()
+{
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+}
+
+void GameLogReader::ReadAppended()
+{
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(m_file, &size))
+    {
+        return;
+    }
+    uint64_t fileSize = static_cast<uint64_t>(size.QuadPart);
+
+    uint64_t offset = m_offset.load(std::memory_order_relaxed);
+    uint64_t readFrom = offset + m_pendingSize;
+    if (fileSize < readFrom)
+    {
+        Log(2, "{} shrank to {} bytes, reading it from the start", m_config.logPath.filename().string(), fileSize);
+        offset = 0;
+        readFrom = 0;
+        m_pendingSize = 0;
+    }
+
+    while (readFrom < fileSize && WaitForSingleObject(m_stopEvent, 0) != WAIT_OBJECT_0)
+    {
+        if (m_buffer.size() < m_pendingSize + m_config.readChunkSize)
+        {
+            m_buffer.resize(m_pendingSize + m_config.readChunkSize);
+        }
+
+        // A positioned read; the handle keeps no file pointer of ours
+        OVERLAPPED position = {};
+        position.Offset = static_cast<DWORD>(readFrom);
+        position.OffsetHigh = static_cast<DWORD>(readFrom >> 32);
+        DWORD toRead = static_cast<DWORD>((std::min)(static_cast<uint64_t>(m_config.readChunkSize), fileSize - readFrom));
+        DWORD bytesRead = 0;
+        if (!ReadFile(m_file, m_buffer.data() + m_pendingSize, toRead, &bytesRead, &position) || bytesRead == 0)
+        {
+            break;
+        }
+        readFrom += bytesRead;
+
+        // The unfinished line has no line break, so the scan starts at the new bytes
+        std::string_view data(m_buffer.data(), m_pendingSize + bytesRead);
+        size_t lineStart = 0;
+        for (size_t lineEnd = data.find('\n', m_pendingSize); lineEnd != std::string_view::npos;
+            lineEnd = data.find('\n', lineStart))
+        {
+            std::string_view line = data.substr(lineStart, lineEnd - lineStart);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+            ParseLine(line);
+            lineStart = lineEnd + 1;
+        }
+
+        offset += lineStart;
+        m_pendingSize = data.size() - lineStart;
+        if (m_pendingSize > kMaxLineLength)
+        {
+            Log(3, "Skipping a {} byte line at offset {}", m_pendingSize, offset);
+            offset += m_pendingSize;
+            m_pendingSize = 0;
+        }
+        else if (lineStart > 0 && m_pendingSize > 0)
+        {
+            std::memmove(m_buffer.data(), m_buffer.data() + lineStart, m_pendingSize);
+        }
+    }
+
+    m_offset.store(offset, std::memory_order_relaxed);
+}
+
+bool GameLogReader::WatchDirectory()
+{
+    if (m_directory == INVALID_HANDLE_VALUE)
+    {
+        m_directory = CreateFileW(m_config.logPath.parent_path().c_str(), FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (m_directory == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+    }
+
+    ResetEvent(m_directoryOverlapped.hEvent);
+    if (!ReadDirectoryChangesW(m_directory, m_notifyBuffer.data(), static_cast<DWORD>(m_notifyBuffer.size()), FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE,
+        nullptr, &m_directoryOverlapped, nullptr))
+    {
+        CloseHandle(m_directory);
+        m_directory = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    return true;
+}
+
+bool GameLogReader::LogReplaced() const
+{
+    std::wstring fileName = m_config.logPath.filename().wstring();
+
+    const uint8_t* record = m_notifyBuffer.data();
+    while (true)
+    {
+        const auto* notification = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+        bool removed = notification->Action == FILE_ACTION_REMOVED || notification->Action == FILE_ACTION_RENAMED_OLD_NAME;
+        if (removed && CompareStringOrdinal(notification->FileName, static_cast<int>(notification->FileNameLength / sizeof(WCHAR)),
+            fileName.c_str(), static_cast<int>(fileName.size()), TRUE) == CSTR_EQUAL)
+        {
+            return true;
+        }
+
+        if (notification->NextEntryOffset == 0)
+        {
+            return false;
+        }
+        record += notification->NextEntryOffset;
+    }
+}
+
+bool GameLogReader::LoadOffset(FileIdentity& identity, uint64_t& offset) const
+{
+    std::ifstream file(m_config.offsetPath);
+    return static_cast<bool>(file >> identity.volumeSerial >> identity.fileIndex >> offset);
+}
+
+void GameLogReader::SaveOffset()
+{
+    uint64_t offset = m_offset.load(std::memory_order_relaxed);
+    if (!m_hasIdentity || offset == m_savedOffset)
+    {
+        return;
+    }
+
+    // Temp-and-rename, so a crash mid-write cannot lose the position
+    std::filesystem::path tempPath = m_config.offsetPath;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::trunc);
+        file << m_identity.volumeSerial << ' ' << m_identity.fileIndex << ' ' << offset << '\n';
+        if (!file)
+        {
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_config.offsetPath, error);
+    if (!error)
+    {
+        m_savedOffset = offset;
+    }
+}
+
+} // namespace poe
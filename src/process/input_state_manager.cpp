@@ -3,6 +3,7 @@
 #include "process/focus_tracker.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/TraceRing.h"
 
 #include <iostream>
 
@@ -28,6 +29,7 @@ InputStateManager::InputStateManager(
     m_currentState.overlayHasFocus = false;
     m_currentState.mousePosition = {0, 0};
     m_currentState.timestamp = std::chrono::steady_clock::now();
+    m_packedState.store(Pack(m_currentState), std::memory_order_relaxed);
 }
 
 InputStateManager::~InputStateManager()
@@ -47,6 +49,7 @@ InputStateManager::InputStateManager(InputStateManager&& other) noexcept
     // Move state
     std::lock_guard<std::mutex> stateLock(other.m_stateMutex);
     m_currentState = other.m_currentState;
+    m_packedState.store(Pack(m_currentState), std::memory_order_release);
     
     // Move callbacks
     std::lock_guard<std::mutex> callbackLock(other.m_callbacksMutex);
@@ -74,8 +77,9 @@ InputStateManager& InputStateManager::operator=(InputStateManager&& other) noexc
         
         // Move state
         {
-            std::lock_guard<std::mutex> stateLock(other.m_stateMutex);
+            std::scoped_lock stateLock(other.m_stateMutex, m_stateMutex);
             m_currentState = other.m_currentState;
+            PublishState();
         }
         
         // Move callbacks
@@ -188,8 +192,7 @@ InputStateInfo InputStateManager::GetInputState() const
 
 InputMode InputStateManager::GetInputMode() const
 {
-    std::lock_guard<std::mutex> lock(m_stateMutex);
-    return m_currentState.mode;
+    return static_cast<InputMode>(m_packedState.load(std::memory_order_acquire).mode);
 }
 
 void InputStateManager::SetGameWindow(HWND gameWindowHandle)
@@ -312,31 +315,48 @@ bool InputStateManager::UnregisterStateCallback(size_t callbackId)
 
 bool InputStateManager::ShouldBlockInput() const
 {
-    std::lock_guard<std::mutex> lock(m_stateMutex);
+    PackedState state = m_packedState.load(std::memory_order_acquire);
     
     // Block input if keyboard or mouse is blocked
-    return m_currentState.keyboardState == InputState::Blocked ||
-           m_currentState.mouseState == InputState::Blocked;
+    return static_cast<InputState>(state.keyboardState) == InputState::Blocked ||
+           static_cast<InputState>(state.mouseState) == InputState::Blocked;
 }
 
 bool InputStateManager::ShouldPassthroughMouse() const
 {
-    std::lock_guard<std::mutex> lock(m_stateMutex);
+    PackedState state = m_packedState.load(std::memory_order_acquire);
+    InputMode mode = static_cast<InputMode>(state.mode);
     
     // Pass through mouse if in passthrough mode or if game has focus
-    return m_currentState.mouseState == InputState::Inactive ||
-           m_currentState.mode == InputMode::Passthrough ||
-           (m_currentState.mode == InputMode::GameFocused && m_currentState.gameHasFocus);
+    return static_cast<InputState>(state.mouseState) == InputState::Inactive ||
+           mode == InputMode::Passthrough ||
+           (mode == InputMode::GameFocused && (state.flags & kGameHasFocus));
 }
 
 bool InputStateManager::ShouldPassthroughKeyboard() const
 {
-    std::lock_guard<std::mutex> lock(m_stateMutex);
+    PackedState state = m_packedState.load(std::memory_order_acquire);
+    InputMode mode = static_cast<InputMode>(state.mode);
     
     // Pass through keyboard if in passthrough mode or if game has focus
-    return m_currentState.keyboardState == InputState::Inactive ||
-           m_currentState.mode == InputMode::Passthrough ||
-           (m_currentState.mode == InputMode::GameFocused && m_currentState.gameHasFocus);
+    return static_cast<InputState>(state.keyboardState) == InputState::Inactive ||
+           mode == InputMode::Passthrough ||
+           (mode == InputMode::GameFocused && (state.flags & kGameHasFocus));
+}
+
+InputStateManager::PackedState InputStateManager::Pack(const InputStateInfo& state)
+{
+    PackedState packed = {};
+    packed.mode = static_cast<uint8_t>(state.mode);
+    packed.keyboardState = static_cast<uint8_t>(state.keyboardState);
+    packed.mouseState = static_cast<uint8_t>(state.mouseState);
+    packed.flags = (state.gameHasFocus ? kGameHasFocus : 0) | (state.overlayHasFocus ? kOverlayHasFocus : 0);
+    return packed;
+}
+
+void InputStateManager::PublishState()
+{
+    m_packedState.store(Pack(m_currentState), std::memory_order_release);
 }
 
 void InputStateManager::UpdateInputState()
@@ -346,10 +366,12 @@ void InputStateManager::UpdateInputState()
         return;
     }
     
-    std::lock_guard<std::mutex> lock(m_stateMutex);
-    
-    // Get current focused window
+    // Query focus and cursor before locking, so FocusTracker's lock is never taken under ours
     HWND focusedWindow = m_focusTracker.GetFocusedWindow();
+    POINT mousePosition = {0, 0};
+    GetCursorPos(&mousePosition);
+    
+    std::lock_guard<std::mutex> lock(m_stateMutex);
     
     // Check if game window has focus
     m_currentState.gameHasFocus = (m_gameWindowHandle && focusedWindow == m_gameWindowHandle);
@@ -357,11 +379,11 @@ void InputStateManager::UpdateInputState()
     // Check if overlay window has focus
     m_currentState.overlayHasFocus = (m_overlayWindowHandle && focusedWindow == m_overlayWindowHandle);
     
-    // Get current mouse position
-    GetCursorPos(&m_currentState.mousePosition);
+    m_currentState.mousePosition = mousePosition;
     
     // Update timestamp
     m_currentState.timestamp = std::chrono::steady_clock::now();
+    PublishState();
 }
 
 void InputStateManager::ApplyInputMode()
@@ -422,10 +444,17 @@ void InputStateManager::ApplyInputMode()
             }
             break;
     }
+    
+    PublishState();
 }
 
 void InputStateManager::NotifyStateChange(const InputStateInfo& oldState, const InputStateInfo& newState)
 {
+    m_app.GetTraceRing().Emit(TraceEvent::InputStateChanged,
+        static_cast<int64_t>(newState.mode),
+        static_cast<int64_t>(newState.keyboardState),
+        static_cast<int64_t>(newState.mouseState));
+    
     // Copy callbacks to avoid holding lock during callbacks
     std::vector<CallbackEntry> callbacks;
     {
@@ -447,29 +476,4 @@ void InputStateManager::NotifyStateChange(const InputStateInfo& oldState, const
     }
 }
 
-template<typename... Args>
-void InputStateManager::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try
-    {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "InputStateManager log error: " << e.what() << std::endl;
-    }
-}
-
 } // namespace poe
\ No newline at end of file
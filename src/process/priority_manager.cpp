@@ -0,0 +1,407 @@
+#include "process/priority_manager.h"
+#include "process/focus_tracker.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+
+#include <TlHelp32.h>
+#include <algorithm>
+#include <climits>
+
+namespace poe {
+
+namespace
+{
+
+/// Access needed to read and change scheduling, and to notice the process has exited
+constexpr DWORD kManagedProcessAccess = PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE;
+
+/// How long after a launch notification to keep looking for the new child
+constexpr std::chrono::seconds kLaunchScanWindow(2);
+
+/// Spacing of child scans within that window
+constexpr std::chrono::milliseconds kLaunchScanInterval(100);
+
+const char* ProfileName(PriorityProfile profile)
+{
+    return profile == PriorityProfile::Background ? "background" : "foreground";
+}
+
+} // namespace
+
+PriorityManager::PriorityManager(Application& app, FocusTracker& focusTracker, const PriorityConfig& config)
+    : m_app(app)
+    , m_focusTracker(focusTracker)
+    , m_config(config)
+    , m_initialized(false)
+    , m_focusCallbackId(0)
+    , m_backgroundAffinity(0)
+    , m_profile(PriorityProfile::Foreground)
+    , m_gameProcessId(0)
+    , m_focusedProcessId(0)
+    , m_overlayInteractive(false)
+    , m_launchPending(false)
+{
+}
+
+PriorityManager::~PriorityManager()
+{
+    Shutdown();
+}
+
+bool PriorityManager::Initialize()
+{
+    if (m_initialized)
+    {
+        return true;
+    }
+
+    try
+    {
+        Log(2, "Initializing PriorityManager");
+
+        m_backgroundAffinity = ComputeBackgroundAffinity();
+
+        // Read the focus before taking our lock; the tracker's lock is never taken under ours
+        DWORD focusedProcessId = m_focusTracker.GetFocusedWindowProcessId();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_focusedProcessId = focusedProcessId;
+
+            // This process, plus any CEF children launched before we were created
+            AddProcess(GetCurrentProcessId());
+            ScanChildProcesses();
+
+            m_initialized = true;
+            UpdateProfile();
+        }
+
+        m_focusCallbackId = m_focusTracker.RegisterFocusCallback(
+            [this](const FocusChangeInfo& info) { OnFocusChanged(info); });
+
+        Log(2, "PriorityManager initialized (background affinity: {:#x})", m_backgroundAffinity);
+        return true;
+    }
+    catch (const std::exception& ex)
+    {
+        m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "PriorityManager");
+        return false;
+    }
+}
+
+void PriorityManager::Shutdown()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    Log(2, "Shutting down PriorityManager");
+
+    if (m_focusCallbackId != 0)
+    {
+        m_focusTracker.UnregisterFocusCallback(m_focusCallbackId);
+        m_focusCallbackId = 0;
+    }
+
+    // Leave every process the way we found it
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const ManagedProcess& process : m_processes)
+    {
+        if (m_profile != PriorityProfile::Foreground)
+        {
+            ApplyProfile(process, PriorityProfile::Foreground);
+        }
+        CloseHandle(process.handle);
+    }
+    m_processes.clear();
+    m_profile = PriorityProfile::Foreground;
+
+    m_initialized = false;
+    Log(2, "PriorityManager shutdown complete");
+}
+
+void PriorityManager::SetGameProcess(DWORD processId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_gameProcessId != processId)
+    {
+        m_gameProcessId = processId;
+        UpdateProfile();
+    }
+}
+
+void PriorityManager::SetOverlayInteractive(bool interactive)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_overlayInteractive != interactive)
+    {
+        m_overlayInteractive = interactive;
+        UpdateProfile();
+    }
+}
+
+void PriorityManager::NotifyChildProcessLaunch()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scanUntil = std::chrono::steady_clock::now() + kLaunchScanWindow;
+    m_launchPending = true;
+}
+
+void PriorityManager::Update()
+{
+    if (!m_initialized || !m_launchPending.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_nextScan)
+    {
+        return;
+    }
+    m_nextScan = now + kLaunchScanInterval;
+
+    // CEF may launch several children in a row, so keep looking for the whole window
+    ScanChildProcesses();
+    if (now >= m_scanUntil)
+    {
+        m_launchPending = false;
+    }
+}
+
+PriorityProfile PriorityManager::GetProfile() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_profile;
+}
+
+void PriorityManager::OnFocusChanged(const FocusChangeInfo& info)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_focusedProcessId = info.currentProcessId;
+    UpdateProfile();
+}
+
+void PriorityManager::UpdateProfile()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    bool gameFocused = m_gameProcessId != 0 && m_focusedProcessId == m_gameProcessId;
+    PriorityProfile wanted = (m_config.enabled && gameFocused && !m_overlayInteractive)
+        ? PriorityProfile::Background
+        : PriorityProfile::Foreground;
+    if (wanted == m_profile)
+    {
+        return;
+    }
+
+    m_profile = wanted;
+
+    // Apply to every process, dropping the children that have exited
+    auto it = m_processes.begin();
+    while (it != m_processes.end())
+    {
+        if (ApplyProfile(*it, m_profile))
+        {
+            ++it;
+        }
+        else
+        {
+            Log(1, "Managed process {} has exited", it->processId);
+            CloseHandle(it->handle);
+            it = m_processes.erase(it);
+        }
+    }
+
+    Log(2, "Applied {} priority profile to {} processes", ProfileName(m_profile), m_processes.size());
+}
+
+bool PriorityManager::AddProcess(DWORD processId)
+{
+    bool managed = std::any_of(m_processes.begin(), m_processes.end(),
+        [processId](const ManagedProcess& process) { return process.processId == processId; });
+    if (managed)
+    {
+        return false;
+    }
+
+    ManagedProcess process;
+    process.processId = processId;
+    process.handle = OpenProcess(kManagedProcessAccess, FALSE, processId);
+    if (!process.handle)
+    {
+        Log(3, "Cannot manage process {} (Error code: {})", processId, GetLastError());
+        return false;
+    }
+
+    // CEF children lower their own priority on start-up (see cef_subprocess.cpp),
+    // so what they report is already adjusted; they were launched at normal priority
+    DWORD_PTR systemAffinity = 0;
+    process.originalPriorityClass = processId == GetCurrentProcessId()
+        ? GetPriorityClass(process.handle)
+        : NORMAL_PRIORITY_CLASS;
+    if (!GetProcessAffinityMask(process.handle, &process.originalAffinity, &systemAffinity))
+    {
+        process.originalAffinity = 0;
+    }
+
+    // A child launched while the game has focus joins the current profile
+    if (m_profile != PriorityProfile::Foreground)
+    {
+        ApplyProfile(process, m_profile);
+    }
+
+    m_processes.push_back(process);
+    Log(1, "Managing process {} (priority class: {:#x})", processId, process.originalPriorityClass);
+    return true;
+}
+
+size_t PriorityManager::ScanChildProcesses()
+{
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE)
+    {
+        return 0;
+    }
+
+    size_t added = 0;
+    DWORD selfId = GetCurrentProcessId();
+
+    PROCESSENTRY32W entry = {};
+    entry.dwSize = sizeof(entry);
+    if (Process32FirstW(snapshot, &entry))
+    {
+        do
+        {
+            // Our PID cannot be reused while we run, so this only matches our own children
+            if (entry.th32ParentProcessID == selfId && AddProcess(entry.th32ProcessID))
+            {
+                ++added;
+            }
+        } while (Process32NextW(snapshot, &entry));
+    }
+
+    CloseHandle(snapshot);
+    return added;
+}
+
+bool PriorityManager::ApplyProfile(const ManagedProcess& process, PriorityProfile profile) const
+{
+    if (WaitForSingleObject(process.handle, 0) == WAIT_OBJECT_0)
+    {
+        return false;
+    }
+
+    bool background = profile == PriorityProfile::Background;
+
+    DWORD priorityClass = background ? m_config.backgroundPriorityClass : process.originalPriorityClass;
+    if (priorityClass != 0 && !SetPriorityClass(process.handle, priorityClass))
+    {
+        Log(3, "Failed to set priority class of process {} (Error code: {})", process.processId, GetLastError());
+    }
+
+    if (m_backgroundAffinity != 0 && process.originalAffinity != 0)
+    {
+        // Stay within the cores the process was allowed to begin with
+        DWORD_PTR affinity = process.originalAffinity;
+        if (background && (m_backgroundAffinity & process.originalAffinity) != 0)
+        {
+            affinity = m_backgroundAffinity & process.originalAffinity;
+        }
+        if (!SetProcessAffinityMask(process.handle, affinity))
+        {
+            Log(3, "Failed to set affinity of process {} (Error code: {})", process.processId, GetLastError());
+        }
+    }
+
+    if (m_config.powerThrottling)
+    {
+        // EcoQoS while in the background; the system decides again once in the foreground
+        PROCESS_POWER_THROTTLING_STATE throttling = {};
+        throttling.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+        throttling.ControlMask = background ? PROCESS_POWER_THROTTLING_EXECUTION_SPEED : 0;
+        throttling.StateMask = background ? PROCESS_POWER_THROTTLING_EXECUTION_SPEED : 0;
+        SetProcessInformation(process.handle, ProcessPowerThrottling, &throttling, sizeof(throttling));
+    }
+
+    return true;
+}
+
+DWORD_PTR PriorityManager::ComputeBackgroundAffinity() const
+{
+    DWORD_PTR processAffinity = 0;
+    DWORD_PTR systemAffinity = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processAffinity, &systemAffinity))
+    {
+        return 0;
+    }
+
+    if (m_config.backgroundAffinityMask != 0)
+    {
+        return m_config.backgroundAffinityMask & systemAffinity;
+    }
+
+    if (!m_config.efficiencyCoresOnly)
+    {
+        return 0;
+    }
+
+    // Hybrid CPUs report a lower efficiency class for their E-cores
+    ULONG length = 0;
+    GetSystemCpuSetInformation(nullptr, 0, &length, GetCurrentProcess(), 0);
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    std::vector<uint8_t> buffer(length);
+    if (!GetSystemCpuSetInformation(reinterpret_cast<PSYSTEM_CPU_SET_INFORMATION>(buffer.data()),
+            length, &length, GetCurrentProcess(), 0))
+    {
+        return 0;
+    }
+
+    // Affinity masks only cover processor group 0
+    BYTE lowestClass = UCHAR_MAX;
+    BYTE highestClass = 0;
+    DWORD_PTR efficientMask = 0;
+    for (ULONG offset = 0; offset < length;)
+    {
+        const auto* info = reinterpret_cast<const SYSTEM_CPU_SET_INFORMATION*>(buffer.data() + offset);
+        offset += info->Size;
+        if (info->Type != CpuSetInformation || info->CpuSet.Group != 0 ||
+            info->CpuSet.LogicalProcessorIndex >= sizeof(DWORD_PTR) * CHAR_BIT)
+        {
+            continue;
+        }
+
+        BYTE efficiencyClass = info->CpuSet.EfficiencyClass;
+        DWORD_PTR bit = static_cast<DWORD_PTR>(1) << info->CpuSet.LogicalProcessorIndex;
+        highestClass = (std::max)(highestClass, efficiencyClass);
+        if (efficiencyClass < lowestClass)
+        {
+            lowestClass = efficiencyClass;
+            efficientMask = bit;
+        }
+        else if (efficiencyClass == lowestClass)
+        {
+            efficientMask |= bit;
+        }
+    }
+
+    if (lowestClass >= highestClass)
+    {
+        Log(2, "No efficiency cores found, background affinity left unchanged");
+        return 0;
+    }
+
+    return efficientMask & systemAffinity;
+}
+
+} // namespace poe
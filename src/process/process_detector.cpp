@@ -8,12 +8,34 @@
 
 namespace poe {
 
+namespace {
+
+/**
+ * @brief Compares everything but the state flags of two process infos.
+ */
+bool SameWindow(const ProcessInfo& a, const ProcessInfo& b)
+{
+    return a.processId == b.processId &&
+        a.windowHandle == b.windowHandle &&
+        EqualRect(&a.windowRect, &b.windowRect) &&
+        a.name == b.name &&
+        a.windowTitle == b.windowTitle;
+}
+
+} // namespace
+
 ProcessDetector::ProcessDetector(Application& app)
     : m_app(app)
     , m_initialized(false)
     , m_running(false)
+    , m_snapshot(std::make_shared<const ProcessSnapshot>())
     , m_nextCallbackId(1)
     , m_monitorInterval(500) // 500ms default interval
+    , m_monitorThreadId(0)
+    , m_processHandle(nullptr)
+    , m_watchedProcessId(0)
+    , m_rescanPending(false)
+    , m_hooksActive(false)
 {
     // Initialize target process info with default values
     m_targetProcessInfo.processId = 0;
@@ -36,8 +58,14 @@ ProcessDetector::ProcessDetector(ProcessDetector&& other) noexcept
     , m_targetProcessName(std::move(other.m_targetProcessName))
     , m_targetWindowTitle(std::move(other.m_targetWindowTitle))
     , m_targetProcessInfo(other.m_targetProcessInfo)
+    , m_snapshot(other.m_snapshot.load())
     , m_nextCallbackId(other.m_nextCallbackId)
     , m_monitorInterval(other.m_monitorInterval)
+    , m_monitorThreadId(other.m_monitorThreadId.load())
+    , m_processHandle(other.m_processHandle)
+    , m_watchedProcessId(other.m_watchedProcessId)
+    , m_rescanPending(other.m_rescanPending.load())
+    , m_hooksActive(other.m_hooksActive)
 {
     // Move callbacks
     std::lock_guard<std::mutex> lock(other.m_callbacksMutex);
@@ -50,6 +78,9 @@ ProcessDetector::ProcessDetector(ProcessDetector&& other) noexcept
     other.m_initialized = false;
     other.m_running = false;
     other.m_nextCallbackId = 1;
+    other.m_monitorThreadId = 0;
+    other.m_processHandle = nullptr;
+    other.m_watchedProcessId = 0;
 }
 
 ProcessDetector& ProcessDetector::operator=(ProcessDetector&& other) noexcept
@@ -65,8 +96,14 @@ ProcessDetector& ProcessDetector::operator=(ProcessDetector&& other) noexcept
         m_targetProcessName = std::move(other.m_targetProcessName);
         m_targetWindowTitle = std::move(other.m_targetWindowTitle);
         m_targetProcessInfo = other.m_targetProcessInfo;
+        m_snapshot.store(other.m_snapshot.load());
         m_nextCallbackId = other.m_nextCallbackId;
         m_monitorInterval = other.m_monitorInterval;
+        m_monitorThreadId = other.m_monitorThreadId.load();
+        m_processHandle = other.m_processHandle;
+        m_watchedProcessId = other.m_watchedProcessId;
+        m_rescanPending = other.m_rescanPending.load();
+        m_hooksActive = other.m_hooksActive;
         
         // Move callbacks
         {
@@ -81,6 +118,9 @@ ProcessDetector& ProcessDetector::operator=(ProcessDetector&& other) noexcept
         other.m_initialized = false;
         other.m_running = false;
         other.m_nextCallbackId = 1;
+        other.m_monitorThreadId = 0;
+        other.m_processHandle = nullptr;
+        other.m_watchedProcessId = 0;
     }
     
     return *this;
@@ -97,11 +137,16 @@ bool ProcessDetector::Initialize()
     {
         Log(2, "Initializing ProcessDetector");
         
-        // Start monitoring thread if not already running
+        // Start monitoring thread if not already running, and wait until it
+        // can be woken so Shutdown never misses it
         if (!m_running)
         {
             m_running = true;
-            m_monitorThread = std::make_unique<std::thread>(&ProcessDetector::MonitorThread, this);
+            
+            std::promise<DWORD> started;
+            std::future<DWORD> threadId = started.get_future();
+            m_monitorThread = std::make_unique<std::thread>(&ProcessDetector::MonitorThread, this, std::ref(started));
+            m_monitorThreadId = threadId.get();
         }
         
         m_initialized = true;
@@ -129,14 +174,23 @@ void ProcessDetector::Shutdown()
     {
         m_running = false;
         
+        // Wake the thread out of its message wait
+        if (m_monitorThreadId != 0)
+        {
+            PostThreadMessageW(m_monitorThreadId, WM_QUIT, 0, 0);
+        }
+        
         if (m_monitorThread && m_monitorThread->joinable())
         {
             m_monitorThread->join();
         }
         
         m_monitorThread.reset();
+        m_monitorThreadId = 0;
     }
     
+    WatchProcess(0);
+    
     // Clear callbacks
     {
         std::lock_guard<std::mutex> lock(m_callbacksMutex);
@@ -149,6 +203,17 @@ void ProcessDetector::Shutdown()
 
 ProcessInfo ProcessDetector::FindProcess(const std::wstring& processName, const std::wstring& windowTitle)
 {
+    // The monitor keeps the target's state current; only other processes need a scan
+    if (m_running)
+    {
+        std::shared_ptr<const ProcessSnapshot> snapshot = GetSnapshot();
+        if ((!processName.empty() || !windowTitle.empty()) &&
+            processName == snapshot->targetProcessName && windowTitle == snapshot->targetWindowTitle)
+        {
+            return snapshot->info;
+        }
+    }
+    
     return UpdateProcessInfo(processName, windowTitle);
 }
 
@@ -213,27 +278,41 @@ void ProcessDetector::Update()
     
     std::lock_guard<std::mutex> lock(m_processMutex);
     
-    // Update target process info
-    ProcessInfo newInfo = UpdateProcessInfo(m_targetProcessName, m_targetWindowTitle);
+    // Refresh from the cached window when possible; only scan when it is gone
+    ProcessInfo newInfo = m_targetProcessInfo;
+    if (m_rescanPending.exchange(false) || !RefreshCachedState(newInfo))
+    {
+        newInfo = UpdateProcessInfo(m_targetProcessName, m_targetWindowTitle);
+    }
     
     // Check for state changes
-    if (newInfo.state != m_targetProcessInfo.state ||
+    bool stateChanged = newInfo.state != m_targetProcessInfo.state ||
         newInfo.hasFocus != m_targetProcessInfo.hasFocus ||
-        newInfo.isMinimized != m_targetProcessInfo.isMinimized)
+        newInfo.isMinimized != m_targetProcessInfo.isMinimized;
+    bool infoChanged = stateChanged || !SameWindow(newInfo, m_targetProcessInfo);
+    
+    m_targetProcessInfo = newInfo;
+    
+    // Readers only see a new snapshot when something they could observe changed
+    if (infoChanged)
     {
-        // Update stored info
-        m_targetProcessInfo = newInfo;
-        
-        // Notify callbacks about state change
-        NotifyStateChange(m_targetProcessInfo);
+        PublishSnapshot();
     }
-    else
+    
+    if (stateChanged)
     {
-        // Just update the info without notification
-        m_targetProcessInfo = newInfo;
+        // Notify callbacks about state change
+        NotifyStateChange(m_targetProcessInfo);
     }
 }
 
+std::shared_ptr<const ProcessSnapshot> ProcessDetector::Refresh()
+{
+    m_rescanPending = true;
+    Update();
+    return GetSnapshot();
+}
+
 void ProcessDetector::SetTargetProcess(const std::wstring& processName, const std::wstring& windowTitle)
 {
     std::lock_guard<std::mutex> lock(m_processMutex);
@@ -243,33 +322,281 @@ void ProcessDetector::SetTargetProcess(const std::wstring& processName, const st
     
     // Update info immediately
     m_targetProcessInfo = UpdateProcessInfo(processName, windowTitle);
+    PublishSnapshot();
+    
+    // Let the monitor thread pick up the new process handle
+    DWORD monitorThreadId = m_monitorThreadId.load();
+    if (monitorThreadId != 0)
+    {
+        PostThreadMessageW(monitorThreadId, WM_NULL, 0, 0);
+    }
     
     Log(2, "Set target process: '{}' with window title '{}'",
         std::string(processName.begin(), processName.end()),
         std::string(windowTitle.begin(), windowTitle.end()));
 }
 
-const ProcessInfo& ProcessDetector::GetTargetProcessInfo() const
+ProcessInfo ProcessDetector::GetTargetProcessInfo() const
 {
-    return m_targetProcessInfo;
+    return GetSnapshot()->info;
 }
 
-void ProcessDetector::MonitorThread()
+void ProcessDetector::PublishSnapshot()
+{
+    auto snapshot = std::make_shared<ProcessSnapshot>();
+    snapshot->revision = m_snapshot.load(std::memory_order_relaxed)->revision + 1;
+    snapshot->targetProcessName = m_targetProcessName;
+    snapshot->targetWindowTitle = m_targetWindowTitle;
+    snapshot->info = m_targetProcessInfo;
+    m_snapshot.store(std::move(snapshot), std::memory_order_release);
+}
+
+namespace {
+
+/// Detector owning the hooks installed on the current thread
+thread_local ProcessDetector* t_hookOwner = nullptr;
+
+} // namespace
+
+void ProcessDetector::MonitorThread(std::promise<DWORD>& started)
 {
     Log(2, "Process monitor thread started");
     
+    t_hookOwner = this;
+    
+    // Make sure the thread has a message queue before anyone posts to it
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    started.set_value(GetCurrentThreadId());
+    
+    // Out-of-context hooks are delivered through this thread's message queue
+    // (CREATE, DESTROY and SHOW are adjacent; SHOW catches windows created hidden)
+    const DWORD hookFlags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+    HWINEVENTHOOK lifetimeHook = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_SHOW,
+        nullptr, &ProcessDetector::WinEventProc, 0, 0, hookFlags);
+    HWINEVENTHOOK nameHook = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE,
+        nullptr, &ProcessDetector::WinEventProc, 0, 0, hookFlags);
+    HWINEVENTHOOK foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+        nullptr, &ProcessDetector::WinEventProc, 0, 0, hookFlags);
+    HWINEVENTHOOK minimizeHook = SetWinEventHook(EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND,
+        nullptr, &ProcessDetector::WinEventProc, 0, 0, hookFlags);
+    
+    m_hooksActive = lifetimeHook && nameHook && foregroundHook && minimizeHook;
+    if (m_hooksActive)
+    {
+        Log(2, "Process detection is event-driven");
+    }
+    else
+    {
+        Log(3, "Failed to install WinEvent hooks (error {}), falling back to polling every {} ms",
+            static_cast<int>(GetLastError()), static_cast<int>(m_monitorInterval.count()));
+    }
+    
+    // Initial scan
+    Update();
+    
     while (m_running)
     {
-        // Update process information
-        Update();
+        // The process handle is only opened and closed on this thread
+        {
+            std::lock_guard<std::mutex> lock(m_processMutex);
+            WatchProcess(m_targetProcessInfo.processId);
+        }
+        
+        HANDLE waitHandles[1] = { m_processHandle };
+        DWORD handleCount = m_processHandle ? 1 : 0;
+        DWORD timeout = m_hooksActive ? INFINITE : static_cast<DWORD>(m_monitorInterval.count());
+        
+        DWORD result = MsgWaitForMultipleObjects(handleCount, waitHandles, FALSE, timeout, QS_ALLINPUT);
+        
+        if (handleCount == 1 && result == WAIT_OBJECT_0)
+        {
+            // The game exited; the cached window is no longer valid
+            Log(2, "Target process {} exited", static_cast<int>(m_watchedProcessId));
+            WatchProcess(0);
+            m_rescanPending = true;
+        }
+        else if (result == WAIT_OBJECT_0 + handleCount)
+        {
+            // Deliver hook callbacks and any wake-up messages
+            while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_QUIT)
+                {
+                    m_running = false;
+                    break;
+                }
+                
+                DispatchMessageW(&msg);
+            }
+        }
+        else if (result == WAIT_TIMEOUT)
+        {
+            // Polling fallback
+            m_rescanPending = true;
+        }
         
-        // Sleep for monitoring interval
-        std::this_thread::sleep_for(m_monitorInterval);
+        if (m_running && m_rescanPending)
+        {
+            Update();
+        }
     }
     
+    if (minimizeHook) UnhookWinEvent(minimizeHook);
+    if (foregroundHook) UnhookWinEvent(foregroundHook);
+    if (nameHook) UnhookWinEvent(nameHook);
+    if (lifetimeHook) UnhookWinEvent(lifetimeHook);
+    m_hooksActive = false;
+    t_hookOwner = nullptr;
+    
     Log(2, "Process monitor thread stopped");
 }
 
+void CALLBACK ProcessDetector::WinEventProc(
+    HWINEVENTHOOK hook,
+    DWORD event,
+    HWND hwnd,
+    LONG idObject,
+    LONG idChild,
+    DWORD eventThread,
+    DWORD eventTime)
+{
+    // Only whole top-level windows are interesting; the create/destroy range is very noisy
+    if (!t_hookOwner || !hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF)
+    {
+        return;
+    }
+    
+    t_hookOwner->HandleWinEvent(event, hwnd);
+}
+
+void ProcessDetector::HandleWinEvent(DWORD event, HWND hwnd)
+{
+    HWND cachedWindow = GetSnapshot()->info.windowHandle;
+    
+    switch (event)
+    {
+        case EVENT_OBJECT_CREATE:
+        case EVENT_OBJECT_SHOW:
+        case EVENT_OBJECT_NAMECHANGE:
+            // A new, shown or renamed window can only matter while the game is not cached.
+            // The game creates its window hidden, and the scan only accepts visible windows,
+            // so the SHOW event is the one that normally finds it.
+            if (!cachedWindow && GetAncestor(hwnd, GA_ROOT) == hwnd)
+            {
+                std::lock_guard<std::mutex> lock(m_processMutex);
+                if (WindowMatchesTarget(hwnd))
+                {
+                    m_rescanPending = true;
+                }
+            }
+            break;
+            
+        case EVENT_OBJECT_DESTROY:
+            if (hwnd == cachedWindow)
+            {
+                m_rescanPending = true;
+            }
+            break;
+            
+        case EVENT_SYSTEM_FOREGROUND:
+        case EVENT_SYSTEM_MINIMIZESTART:
+        case EVENT_SYSTEM_MINIMIZEEND:
+            // Focus may move to or away from the game; refresh the cached state
+            if (cachedWindow)
+            {
+                Update();
+            }
+            else if (event == EVENT_SYSTEM_FOREGROUND)
+            {
+                // Safety net for a game window whose show event was missed:
+                // it is found at the latest when it is brought to the front
+                std::lock_guard<std::mutex> lock(m_processMutex);
+                if (WindowMatchesTarget(hwnd))
+                {
+                    m_rescanPending = true;
+                }
+            }
+            break;
+    }
+}
+
+bool ProcessDetector::WindowMatchesTarget(HWND hwnd) const
+{
+    if (!m_targetWindowTitle.empty())
+    {
+        wchar_t title[256] = { 0 };
+        GetWindowTextW(hwnd, title, sizeof(title) / sizeof(title[0]));
+        return wcsstr(title, m_targetWindowTitle.c_str()) != nullptr;
+    }
+    
+    if (!m_targetProcessName.empty())
+    {
+        DWORD processId = 0;
+        GetWindowThreadProcessId(hwnd, &processId);
+        
+        HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+        if (!hProcess)
+        {
+            return false;
+        }
+        
+        wchar_t path[MAX_PATH] = { 0 };
+        DWORD size = sizeof(path) / sizeof(path[0]);
+        bool matches = false;
+        
+        if (QueryFullProcessImageNameW(hProcess, 0, path, &size))
+        {
+            const wchar_t* fileName = wcsrchr(path, L'\\');
+            matches = _wcsicmp(fileName ? fileName + 1 : path, m_targetProcessName.c_str()) == 0;
+        }
+        
+        CloseHandle(hProcess);
+        return matches;
+    }
+    
+    return false;
+}
+
+bool ProcessDetector::RefreshCachedState(ProcessInfo& info) const
+{
+    if (!info.windowHandle || !IsWindow(info.windowHandle))
+    {
+        return false;
+    }
+    
+    info.hasFocus = (GetForegroundWindow() == info.windowHandle);
+    info.isMinimized = IsIconic(info.windowHandle);
+    GetWindowRect(info.windowHandle, &info.windowRect);
+    info.state = ProcessState::Running;
+    return true;
+}
+
+void ProcessDetector::WatchProcess(DWORD processId)
+{
+    if (processId == m_watchedProcessId && (processId == 0 || m_processHandle))
+    {
+        return;
+    }
+    
+    if (m_processHandle)
+    {
+        CloseHandle(m_processHandle);
+        m_processHandle = nullptr;
+    }
+    
+    m_watchedProcessId = processId;
+    
+    if (processId != 0)
+    {
+        m_processHandle = OpenProcess(SYNCHRONIZE, FALSE, processId);
+        if (!m_processHandle)
+        {
+            Log(3, "Unable to watch process {} for exit", static_cast<int>(processId));
+        }
+    }
+}
+
 ProcessInfo ProcessDetector::UpdateProcessInfo(const std::wstring& processName, const std::wstring& windowTitle)
 {
     ProcessInfo info;
@@ -450,29 +777,4 @@ void ProcessDetector::NotifyStateChange(const ProcessInfo& info)
     }
 }
 
-template<typename... Args>
-void ProcessDetector::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try
-    {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "ProcessDetector log error: " << e.what() << std::endl;
-    }
-}
-
 } // namespace poe
\ No newline at end of file
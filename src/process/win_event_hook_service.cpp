@@ -0,0 +1,238 @@
+#include "process/win_event_hook_service.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+
+#include <iostream>
+
+namespace poe {
+
+namespace {
+
+/// Service owning the hooks installed on the current thread
+thread_local WinEventHookService* t_hookService = nullptr;
+
+} // namespace
+
+WinEventHookService::WinEventHookService(Application& app)
+    : m_app(app)
+    , m_initialized(false)
+    , m_active(false)
+    , m_hookThreadId(0)
+    , m_subscriptions(std::make_shared<const SubscriptionList>())
+    , m_nextSubscriptionId(1)
+{
+}
+
+WinEventHookService::~WinEventHookService()
+{
+    Shutdown();
+}
+
+bool WinEventHookService::Initialize()
+{
+    if (m_initialized)
+    {
+        return true;
+    }
+    
+    try
+    {
+        Log(2, "Initializing WinEventHookService");
+        
+        // Start the hook thread and wait until it has tried to install the hooks
+        std::promise<DWORD> started;
+        std::future<DWORD> threadId = started.get_future();
+        
+        m_hookThread = std::make_unique<std::thread>(&WinEventHookService::HookThread, this, std::ref(started));
+        
+        m_hookThreadId = threadId.get();
+        
+        m_initialized = true;
+        Log(2, "WinEventHookService initialized successfully");
+        return true;
+    }
+    catch (const std::exception& ex)
+    {
+        m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "WinEventHookService");
+        return false;
+    }
+}
+
+void WinEventHookService::Shutdown()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+    
+    Log(2, "Shutting down WinEventHookService");
+    
+    if (m_hookThread && m_hookThread->joinable())
+    {
+        PostThreadMessageW(m_hookThreadId, WM_QUIT, 0, 0);
+        m_hookThread->join();
+    }
+    m_hookThread.reset();
+    m_hookThreadId = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+        m_subscriptions.store(std::make_shared<const SubscriptionList>());
+    }
+    
+    m_initialized = false;
+    Log(2, "WinEventHookService shutdown complete");
+}
+
+bool WinEventHookService::IsActive() const
+{
+    return m_active;
+}
+
+size_t WinEventHookService::Subscribe(DWORD eventMin, DWORD eventMax, const WinEventCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+    
+    size_t subscriptionId = m_nextSubscriptionId++;
+    
+    auto updated = std::make_shared<SubscriptionList>(*m_subscriptions.load());
+    updated->push_back({subscriptionId, eventMin, eventMax, callback});
+    m_subscriptions.store(std::move(updated));
+    
+    Log(1, "Registered window event subscription (ID: {})", subscriptionId);
+    return subscriptionId;
+}
+
+bool WinEventHookService::Unsubscribe(size_t subscriptionId)
+{
+    std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+    
+    auto current = m_subscriptions.load();
+    auto updated = std::make_shared<SubscriptionList>();
+    updated->reserve(current->size());
+    
+    for (const auto& entry : *current)
+    {
+        if (entry.id != subscriptionId)
+        {
+            updated->push_back(entry);
+        }
+    }
+    
+    if (updated->size() == current->size())
+    {
+        return false;
+    }
+    
+    m_subscriptions.store(std::move(updated));
+    Log(1, "Unregistered window event subscription (ID: {})", subscriptionId);
+    return true;
+}
+
+void WinEventHookService::HookThread(std::promise<DWORD>& started)
+{
+    t_hookService = this;
+    
+    // Create the message queue before Shutdown can post to it
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    
+    // Out-of-context hooks are delivered through this thread's message queue.
+    // Our own process is not skipped: focus moving to the overlay must be seen too.
+    const DWORD hookFlags = WINEVENT_OUTOFCONTEXT;
+    HWINEVENTHOOK hooks[] = {
+        SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+            nullptr, &WinEventHookService::WinEventProc, 0, 0, hookFlags),
+        SetWinEventHook(EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND,
+            nullptr, &WinEventHookService::WinEventProc, 0, 0, hookFlags),
+        SetWinEventHook(EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY,
+            nullptr, &WinEventHookService::WinEventProc, 0, 0, hookFlags),
+        SetWinEventHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE,
+            nullptr, &WinEventHookService::WinEventProc, 0, 0, hookFlags),
+    };
+    
+    bool allInstalled = true;
+    for (HWINEVENTHOOK hook : hooks)
+    {
+        allInstalled = allInstalled && hook != nullptr;
+    }
+    
+    if (allInstalled)
+    {
+        m_active = true;
+        Log(2, "Window event hooks installed");
+    }
+    else
+    {
+        Log(3, "Failed to install window event hooks (error {}), trackers will poll",
+            static_cast<int>(GetLastError()));
+    }
+    
+    // Report back only now, so IsActive() is settled when Initialize returns
+    started.set_value(GetCurrentThreadId());
+    
+    // Pump until Shutdown posts WM_QUIT; hook callbacks are dispatched from here
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0)
+    {
+        DispatchMessageW(&msg);
+    }
+    
+    m_active = false;
+    for (HWINEVENTHOOK hook : hooks)
+    {
+        if (hook)
+        {
+            UnhookWinEvent(hook);
+        }
+    }
+    
+    t_hookService = nullptr;
+}
+
+void CALLBACK WinEventHookService::WinEventProc(
+    HWINEVENTHOOK hook,
+    DWORD event,
+    HWND hwnd,
+    LONG idObject,
+    LONG idChild,
+    DWORD eventThread,
+    DWORD eventTime)
+{
+    // Location changes fire for carets, cursors and child controls; only whole windows matter
+    if (!t_hookService || !hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF)
+    {
+        return;
+    }
+    
+    WinEventInfo info;
+    info.event = event;
+    info.windowHandle = hwnd;
+    info.eventTime = eventTime;
+    
+    t_hookService->Dispatch(info);
+}
+
+void WinEventHookService::Dispatch(const WinEventInfo& info)
+{
+    // Lock-free snapshot; subscribers may (un)subscribe from inside a callback
+    auto subscriptions = m_subscriptions.load();
+    
+    for (const auto& entry : *subscriptions)
+    {
+        if (info.event < entry.eventMin || info.event > entry.eventMax)
+        {
+            continue;
+        }
+        
+        try
+        {
+            entry.callback(info);
+        }
+        catch (const std::exception& ex)
+        {
+            m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "WinEventHookService");
+        }
+    }
+}
+
+} // namespace poe
@@ -6,9 +6,12 @@
 
 namespace poe {
 
-WindowStateTracker::WindowStateTracker(Application& app)
+WindowStateTracker::WindowStateTracker(Application& app, WinEventHookService& hookService)
     : m_app(app)
+    , m_hookService(hookService)
     , m_initialized(false)
+    , m_hookSubscriptionId(0)
+    , m_foregroundWindow(nullptr)
     , m_nextCallbackId(1)
 {
 }
@@ -20,7 +23,10 @@ WindowStateTracker::~WindowStateTracker()
 
 WindowStateTracker::WindowStateTracker(WindowStateTracker&& other) noexcept
     : m_app(other.m_app)
+    , m_hookService(other.m_hookService)
     , m_initialized(other.m_initialized)
+    , m_hookSubscriptionId(0)
+    , m_foregroundWindow(other.m_foregroundWindow)
     , m_nextCallbackId(other.m_nextCallbackId)
 {
     // Move window states
@@ -31,6 +37,14 @@ WindowStateTracker::WindowStateTracker(WindowStateTracker&& other) noexcept
     std::lock_guard<std::mutex> callbackLock(other.m_callbacksMutex);
     m_callbacks = std::move(other.m_callbacks);
     
+    // Hook callbacks are bound to an instance; move the subscription over
+    if (other.m_hookSubscriptionId != 0)
+    {
+        m_hookService.Unsubscribe(other.m_hookSubscriptionId);
+        other.m_hookSubscriptionId = 0;
+        SubscribeToHookService();
+    }
+    
     // Reset the moved-from object
     other.m_initialized = false;
     other.m_nextCallbackId = 1;
@@ -46,6 +60,7 @@ WindowStateTracker& WindowStateTracker::operator=(WindowStateTracker&& other) no
         // Move members
         m_initialized = other.m_initialized;
         m_nextCallbackId = other.m_nextCallbackId;
+        m_foregroundWindow = other.m_foregroundWindow;
         
         // Move window states
         {
@@ -59,6 +74,14 @@ WindowStateTracker& WindowStateTracker::operator=(WindowStateTracker&& other) no
             m_callbacks = std::move(other.m_callbacks);
         }
         
+        // Hook callbacks are bound to an instance; move the subscription over
+        if (other.m_hookSubscriptionId != 0)
+        {
+            m_hookService.Unsubscribe(other.m_hookSubscriptionId);
+            other.m_hookSubscriptionId = 0;
+            SubscribeToHookService();
+        }
+        
         // Reset the moved-from object
         other.m_initialized = false;
         other.m_nextCallbackId = 1;
@@ -79,6 +102,11 @@ bool WindowStateTracker::Initialize()
         Log(2, "Initializing WindowStateTracker");
         
         m_initialized = true;
+        m_foregroundWindow = GetForegroundWindow();
+        
+        // Receive moves, resizes, focus and minimize changes as they happen
+        SubscribeToHookService();
+        
         Log(2, "WindowStateTracker initialized successfully");
         return true;
     }
@@ -98,6 +126,12 @@ void WindowStateTracker::Shutdown()
     
     Log(2, "Shutting down WindowStateTracker");
     
+    if (m_hookSubscriptionId != 0)
+    {
+        m_hookService.Unsubscribe(m_hookSubscriptionId);
+        m_hookSubscriptionId = 0;
+    }
+    
     // Clear tracked windows
     {
         std::lock_guard<std::mutex> lock(m_windowStatesMutex);
@@ -210,11 +244,12 @@ bool WindowStateTracker::IsWindowTracked(HWND handle) const
 
 void WindowStateTracker::Update()
 {
-    if (!m_initialized)
+    if (!m_initialized || m_hookService.IsActive())
     {
         return;
     }
     
+    // Polling fallback when the hooks could not be installed.
     // Get copy of tracked windows to avoid holding lock during updates
     std::vector<HWND> windows;
     {
@@ -312,6 +347,35 @@ bool WindowStateTracker::UpdateWindowState(HWND handle)
     return true;
 }
 
+void WindowStateTracker::OnWinEvent(const WinEventInfo& info)
+{
+    if (info.event == EVENT_SYSTEM_FOREGROUND)
+    {
+        // Focus moved: only the window losing it and the one gaining it change
+        HWND previous = m_foregroundWindow;
+        m_foregroundWindow = info.windowHandle;
+        
+        if (previous && previous != info.windowHandle && IsWindowTracked(previous))
+        {
+            UpdateWindowState(previous);
+        }
+    }
+    
+    // Location, minimize/restore, destroy and focus gain all refer to the event's window
+    if (IsWindowTracked(info.windowHandle))
+    {
+        UpdateWindowState(info.windowHandle);
+    }
+}
+
+void WindowStateTracker::SubscribeToHookService()
+{
+    m_hookSubscriptionId = m_hookService.Subscribe(EVENT_SYSTEM_FOREGROUND, EVENT_OBJECT_LOCATIONCHANGE,
+        [this](const WinEventInfo& info) {
+            OnWinEvent(info);
+        });
+}
+
 WindowStateInfo WindowStateTracker::GetWindowInfo(HWND handle) const
 {
     WindowStateInfo info;
@@ -388,29 +452,4 @@ void WindowStateTracker::NotifyStateChange(const WindowStateInfo& oldInfo, const
     }
 }
 
-template<typename... Args>
-void WindowStateTracker::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try
-    {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level)
-        {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "WindowStateTracker log error: " << e.what() << std::endl;
-    }
-}
-
 } // namespace poe
\ No newline at end of file
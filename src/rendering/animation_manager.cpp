@@ -6,103 +6,33 @@
 
 namespace poe {
 
-//-----------------------------------------------------------------------------
-// Animation implementation
-//-----------------------------------------------------------------------------
-
-Animation::Animation(const std::string& name, uint32_t durationMs)
-    : m_name(name)
-    , m_durationMs(durationMs)
-    , m_running(false)
-    , m_progress(0.0f)
-{
-}
-
-void Animation::Start()
-{
-    m_startTime = std::chrono::steady_clock::now();
-    m_running = true;
-    m_progress = 0.0f;
-    
-    // Update the initial value
-    UpdateValue();
-}
+namespace {
 
-void Animation::Stop()
+/**
+ * @brief Maps linear progress onto an easing curve.
+ * @param easing The curve.
+ * @param t Progress (0.0-1.0).
+ * @return Eased progress (0.0-1.0).
+ */
+float Ease(Easing easing, float t)
 {
-    m_running = false;
-}
-
-bool Animation::Update()
-{
-    if (!m_running) {
-        return false;
+    switch (easing) {
+        case Easing::EaseOut:
+            return t * (2.0f - t);
+        case Easing::EaseInOut:
+            return t * t * (3.0f - 2.0f * t);
+        case Easing::Linear:
+            break;
     }
-    
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_startTime).count();
-    
-    // Calculate progress
-    if (m_durationMs <= 0) {
-        m_progress = 1.0f;
-    } else {
-        m_progress = static_cast<float>(elapsed) / static_cast<float>(m_durationMs);
-    }
-    
-    // Clamp progress to 0.0-1.0
-    m_progress = (m_progress < 0.0f) ? 0.0f : (m_progress > 1.0f) ? 1.0f : m_progress;
-    
-    // Update the animated value
-    UpdateValue();
-    
-    // Check if animation has finished
-    if (m_progress >= 1.0f) {
-        m_running = false;
-        
-        // Call the completion callback if set
-        if (m_completionCallback) {
-            m_completionCallback();
-        }
-        
-        return false;
-    }
-    
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-// FloatAnimation implementation
-//-----------------------------------------------------------------------------
 
-FloatAnimation::FloatAnimation(
-    const std::string& name,
-    uint32_t durationMs,
-    float startValue,
-    float endValue,
-    std::function<void(float)> valueCallback
-)
-    : Animation(name, durationMs)
-    , m_startValue(startValue)
-    , m_endValue(endValue)
-    , m_currentValue(startValue)
-    , m_valueCallback(valueCallback)
-{
+    return t;
 }
 
-void FloatAnimation::UpdateValue()
-{
-    // Calculate the current value based on progress
-    m_currentValue = m_startValue + (m_endValue - m_startValue) * m_progress;
-    
-    // Call the value callback
-    if (m_valueCallback) {
-        m_valueCallback(m_currentValue);
-    }
-}
+/// Low handle bits holding the slot index plus one; the rest hold the slot's generation
+constexpr uint32_t kSlotIndexBits = 20;
+constexpr uint32_t kSlotIndexMask = (1u << kSlotIndexBits) - 1;
 
-//-----------------------------------------------------------------------------
-// AnimationManager implementation
-//-----------------------------------------------------------------------------
+} // namespace
 
 AnimationManager::AnimationManager(Application& app)
     : m_app(app)
@@ -115,13 +45,15 @@ AnimationManager::~AnimationManager()
     Shutdown();
 }
 
-bool AnimationManager::Initialize()
+bool AnimationManager::Initialize(IDCompositionDevice* compositionDevice)
 {
     if (m_initialized) {
         return true;
     }
-    
-    Log(2, "Animation Manager initialized");
+
+    m_compositionDevice = compositionDevice;
+
+    Log(2, "Animation Manager initialized{}", m_compositionDevice ? " with composition animations" : "");
     m_initialized = true;
     return true;
 }
@@ -131,130 +63,233 @@ void AnimationManager::Shutdown()
     if (!m_initialized) {
         return;
     }
-    
+
     StopAllAnimations();
-    m_animations.clear();
-    m_activeAnimations.clear();
-    
+
+    m_startValues.clear();
+    m_endValues.clear();
+    m_currentValues.clear();
+    m_durationsMs.clear();
+    m_easings.clear();
+    m_flags.clear();
+    m_startTimes.clear();
+    m_valueCallbacks.clear();
+    m_completionCallbacks.clear();
+    m_bindings.clear();
+    m_freeSlots.clear();
+    m_active.clear();
+    m_completed.clear();
+    m_compositionDevice.Reset();
+
+    // Generations outlive the pool so handles from before the shutdown stay dead
+    for (uint32_t& generation : m_generations) {
+        ++generation;
+    }
+
     m_initialized = false;
     Log(2, "Animation Manager shutdown");
 }
 
 void AnimationManager::Update()
 {
-    if (!m_initialized) {
+    if (!m_initialized || m_active.empty()) {
         return;
     }
-    
-    // Update all active animations
-    auto it = m_activeAnimations.begin();
-    while (it != m_activeAnimations.end()) {
-        auto& animation = *it;
-        
-        if (animation->Update()) {
-            // Animation is still running, move to next
-            ++it;
+
+    auto now = std::chrono::steady_clock::now();
+    m_completed.clear();
+
+    // Step every running slot; finished ones are swapped out of the running list
+    for (size_t i = 0; i < m_active.size();) {
+        uint32_t index = m_active[i];
+        float progress = GetProgress(index, now);
+
+        if (!(m_flags[index] & kSlotComposition)) {
+            m_currentValues[index] = Evaluate(index, progress);
+            if (m_valueCallbacks[index]) {
+                m_valueCallbacks[index](m_currentValues[index]);
+            }
+        }
+
+        if (progress >= 1.0f) {
+            m_currentValues[index] = m_endValues[index];
+            m_flags[index] &= ~kSlotRunning;
+            m_active[i] = m_active.back();
+            m_active.pop_back();
+            m_completed.push_back(MakeHandle(index));
         } else {
-            // Animation has finished, remove from active list
-            it = m_activeAnimations.erase(it);
+            ++i;
+        }
+    }
+
+    // Completion callbacks may start, destroy or create animations, so they
+    // run once the loop is done, and a slot reused meanwhile is skipped
+    for (AnimationHandle handle : m_completed) {
+        uint32_t index = 0;
+        if (FindSlot(handle, index) && m_completionCallbacks[index]) {
+            m_completionCallbacks[index]();
         }
     }
 }
 
-std::shared_ptr<FloatAnimation> AnimationManager::CreateFloatAnimation(
-    const std::string& name,
+bool AnimationManager::HasActiveAnimations() const
+{
+    return std::any_of(m_active.begin(), m_active.end(),
+        [this](uint32_t index) { return !(m_flags[index] & kSlotComposition); });
+}
+
+DWORD AnimationManager::GetTimeToNextCompletion() const
+{
+    auto now = std::chrono::steady_clock::now();
+
+    DWORD next = INFINITE;
+    for (uint32_t index : m_active) {
+        if (!(m_flags[index] & kSlotComposition)) {
+            continue;
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_startTimes[index]).count();
+        DWORD remaining = elapsed >= static_cast<int64_t>(m_durationsMs[index])
+            ? 0 : static_cast<DWORD>(m_durationsMs[index] - elapsed);
+        next = (std::min)(next, remaining);
+    }
+
+    return next;
+}
+
+AnimationManager::AnimationHandle AnimationManager::CreateFloatAnimation(
     uint32_t durationMs,
     float startValue,
     float endValue,
-    std::function<void(float)> valueCallback
+    std::function<void(float)> valueCallback,
+    Easing easing
 )
 {
     if (!m_initialized) {
         Log(3, "Cannot create animation, manager not initialized");
-        return nullptr;
-    }
-    
-    // Check if animation with this name already exists
-    auto existingAnim = m_animations.find(name);
-    if (existingAnim != m_animations.end()) {
-        // Stop existing animation
-        existingAnim->second->Stop();
-        
-        // If it's active, remove it from active list
-        auto activeIt = std::find(m_activeAnimations.begin(), m_activeAnimations.end(), existingAnim->second);
-        if (activeIt != m_activeAnimations.end()) {
-            m_activeAnimations.erase(activeIt);
-        }
-        
-        // Remove from animations map
-        m_animations.erase(existingAnim);
-    }
-    
-    // Create new animation
-    auto animation = std::make_shared<FloatAnimation>(
-        name,
-        durationMs,
-        startValue,
-        endValue,
-        valueCallback
-    );
-    
-    // Add to animations map
-    m_animations[name] = animation;
-    
-    Log(1, "Created float animation: {}", name);
-    return animation;
+        return kInvalidHandle;
+    }
+
+    uint32_t index = AllocateSlot();
+    m_startValues[index] = startValue;
+    m_endValues[index] = endValue;
+    m_currentValues[index] = startValue;
+    m_durationsMs[index] = durationMs;
+    m_easings[index] = easing;
+    m_flags[index] = kSlotInUse;
+    m_valueCallbacks[index] = std::move(valueCallback);
+
+    Log(1, "Created float animation in slot {}", index);
+    return MakeHandle(index);
 }
 
-bool AnimationManager::StartAnimation(const std::string& name)
+AnimationManager::AnimationHandle AnimationManager::CreateCompositionAnimation(
+    uint32_t durationMs,
+    float startValue,
+    float endValue,
+    CompositionProperty property,
+    const CompositionTarget& target,
+    Easing easing
+)
 {
-    if (!m_initialized) {
+    if (!m_initialized || !m_compositionDevice) {
+        return kInvalidHandle;
+    }
+
+    uint32_t index = AllocateSlot();
+    m_startValues[index] = startValue;
+    m_endValues[index] = endValue;
+    m_currentValues[index] = startValue;
+    m_durationsMs[index] = durationMs;
+    m_easings[index] = easing;
+    m_flags[index] = kSlotInUse | kSlotComposition;
+    m_bindings[index].property = property;
+    m_bindings[index].target = target;
+
+    Log(1, "Created composition animation in slot {}", index);
+    return MakeHandle(index);
+}
+
+void AnimationManager::DestroyAnimation(AnimationHandle handle)
+{
+    uint32_t index = 0;
+    if (!FindSlot(handle, index)) {
+        return;
+    }
+
+    Deactivate(index);
+    m_flags[index] = 0;
+    m_valueCallbacks[index] = nullptr;
+    m_completionCallbacks[index] = nullptr;
+    m_bindings[index] = {};
+
+    // Handles to this slot die here, before the slot is handed out again
+    ++m_generations[index];
+    m_freeSlots.push_back(index);
+}
+
+void AnimationManager::SetCompletionCallback(AnimationHandle handle, std::function<void()> callback)
+{
+    uint32_t index = 0;
+    if (FindSlot(handle, index)) {
+        m_completionCallbacks[index] = std::move(callback);
+    }
+}
+
+bool AnimationManager::StartAnimation(AnimationHandle handle)
+{
+    uint32_t index = 0;
+    if (!FindSlot(handle, index)) {
         return false;
     }
-    
-    auto it = m_animations.find(name);
-    if (it == m_animations.end()) {
-        Log(3, "Cannot start animation, not found: {}", name);
+
+    Play(index);
+    return true;
+}
+
+bool AnimationManager::StartAnimation(AnimationHandle handle, float startValue, float endValue)
+{
+    uint32_t index = 0;
+    if (!FindSlot(handle, index)) {
         return false;
     }
-    
-    auto& animation = it->second;
-    
-    // Start the animation
-    animation->Start();
-    
-    // Add to active animations if not already there
-    auto activeIt = std::find(m_activeAnimations.begin(), m_activeAnimations.end(), animation);
-    if (activeIt == m_activeAnimations.end()) {
-        m_activeAnimations.push_back(animation);
-    }
-    
-    Log(1, "Started animation: {}", name);
+
+    m_startValues[index] = startValue;
+    m_endValues[index] = endValue;
+    Play(index);
     return true;
 }
 
-bool AnimationManager::StopAnimation(const std::string& name)
+bool AnimationManager::RetargetAnimation(AnimationHandle handle, float endValue)
 {
-    if (!m_initialized) {
+    uint32_t index = 0;
+    if (!FindSlot(handle, index)) {
         return false;
     }
-    
-    auto it = m_animations.find(name);
-    if (it == m_animations.end()) {
+
+    m_startValues[index] = GetCurrentValue(handle);
+    m_endValues[index] = endValue;
+    Play(index);
+    return true;
+}
+
+bool AnimationManager::StopAnimation(AnimationHandle handle)
+{
+    uint32_t index = 0;
+    if (!FindSlot(handle, index) || !(m_flags[index] & kSlotRunning)) {
         return false;
     }
-    
-    auto& animation = it->second;
-    
-    // Stop the animation
-    animation->Stop();
-    
-    // Remove from active animations
-    auto activeIt = std::find(m_activeAnimations.begin(), m_activeAnimations.end(), animation);
-    if (activeIt != m_activeAnimations.end()) {
-        m_activeAnimations.erase(activeIt);
-    }
-    
+
+    float value = GetCurrentValue(handle);
+    m_currentValues[index] = value;
+    Deactivate(index);
+
+    // The compositor would otherwise keep running the curve to its end
+    if (m_flags[index] & kSlotComposition) {
+        ApplyComposition(index, nullptr, value);
+        m_compositionDevice->Commit();
+    }
+
     return true;
 }
 
@@ -263,50 +298,223 @@ void AnimationManager::StopAllAnimations()
     if (!m_initialized) {
         return;
     }
-    
-    // Stop all animations
-    for (auto& pair : m_animations) {
-        pair.second->Stop();
+
+    while (!m_active.empty()) {
+        StopAnimation(MakeHandle(m_active.back()));
     }
-    
-    // Clear active animations
-    m_activeAnimations.clear();
 }
 
-std::shared_ptr<Animation> AnimationManager::GetAnimation(const std::string& name)
+bool AnimationManager::IsRunning(AnimationHandle handle) const
 {
-    if (!m_initialized) {
-        return nullptr;
+    uint32_t index = 0;
+    return FindSlot(handle, index) && (m_flags[index] & kSlotRunning);
+}
+
+float AnimationManager::GetCurrentValue(AnimationHandle handle) const
+{
+    uint32_t index = 0;
+    if (!FindSlot(handle, index)) {
+        return 0.0f;
+    }
+
+    // CPU slots hold the value of their last step; curves are evaluated now
+    if ((m_flags[index] & kSlotComposition) && (m_flags[index] & kSlotRunning)) {
+        return Evaluate(index, GetProgress(index, std::chrono::steady_clock::now()));
+    }
+
+    return m_currentValues[index];
+}
+
+float AnimationManager::GetEndValue(AnimationHandle handle) const
+{
+    uint32_t index = 0;
+    return FindSlot(handle, index) ? m_endValues[index] : 0.0f;
+}
+
+bool AnimationManager::IsCompositionDriven(AnimationHandle handle) const
+{
+    uint32_t index = 0;
+    return FindSlot(handle, index) && (m_flags[index] & kSlotComposition);
+}
+
+uint32_t AnimationManager::AllocateSlot()
+{
+    if (!m_freeSlots.empty()) {
+        uint32_t index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return index;
     }
-    
-    auto it = m_animations.find(name);
-    if (it == m_animations.end()) {
-        return nullptr;
+
+    uint32_t index = static_cast<uint32_t>(m_flags.size());
+    if (index >= m_generations.size()) {
+        m_generations.push_back(0);
     }
-    
-    return it->second;
+    m_startValues.push_back(0.0f);
+    m_endValues.push_back(0.0f);
+    m_currentValues.push_back(0.0f);
+    m_durationsMs.push_back(0);
+    m_easings.push_back(Easing::Linear);
+    m_flags.push_back(0);
+    m_startTimes.emplace_back();
+    m_valueCallbacks.emplace_back();
+    m_completionCallbacks.emplace_back();
+    m_bindings.emplace_back();
+    return index;
 }
 
-template<typename... Args>
-void AnimationManager::Log(int level, const std::string& fmt, const Args&... args)
+AnimationManager::AnimationHandle AnimationManager::MakeHandle(uint32_t index) const
 {
-    try {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level) {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
+    return (m_generations[index] << kSlotIndexBits) | (index + 1);
+}
+
+bool AnimationManager::FindSlot(AnimationHandle handle, uint32_t& index) const
+{
+    uint32_t slot = handle & kSlotIndexMask;
+    if (slot == 0 || slot > m_flags.size()) {
+        return false;
+    }
+
+    index = slot - 1;
+    return (m_flags[index] & kSlotInUse) != 0 && MakeHandle(index) == handle;
+}
+
+float AnimationManager::GetProgress(uint32_t index, std::chrono::steady_clock::time_point now) const
+{
+    if (m_durationsMs[index] == 0) {
+        return 1.0f;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_startTimes[index]).count();
+    float progress = static_cast<float>(elapsed) / static_cast<float>(m_durationsMs[index]);
+    return (std::clamp)(progress, 0.0f, 1.0f);
+}
+
+float AnimationManager::Evaluate(uint32_t index, float progress) const
+{
+    return m_startValues[index] + (m_endValues[index] - m_startValues[index]) * Ease(m_easings[index], progress);
+}
+
+void AnimationManager::Play(uint32_t index)
+{
+    m_startTimes[index] = std::chrono::steady_clock::now();
+    m_currentValues[index] = m_startValues[index];
+
+    if (!(m_flags[index] & kSlotRunning)) {
+        m_flags[index] |= kSlotRunning;
+        m_active.push_back(index);
+    }
+
+    // Apply the initial value
+    if (m_flags[index] & kSlotComposition) {
+        SubmitCurve(index);
+    } else if (m_valueCallbacks[index]) {
+        m_valueCallbacks[index](m_startValues[index]);
+    }
+}
+
+void AnimationManager::Deactivate(uint32_t index)
+{
+    if (!(m_flags[index] & kSlotRunning)) {
+        return;
+    }
+
+    m_flags[index] &= ~kSlotRunning;
+    auto it = std::find(m_active.begin(), m_active.end(), index);
+    if (it != m_active.end()) {
+        *it = m_active.back();
+        m_active.pop_back();
+    }
+}
+
+void AnimationManager::SubmitCurve(uint32_t index)
+{
+    if (!m_compositionDevice) {
+        return;
+    }
+
+    float startValue = m_startValues[index];
+    float endValue = m_endValues[index];
+    uint32_t durationMs = m_durationsMs[index];
+
+    HRESULT hr = E_FAIL;
+    Microsoft::WRL::ComPtr<IDCompositionAnimation> curve;
+
+    if (durationMs > 0 && SUCCEEDED(m_compositionDevice->CreateAnimation(&curve))) {
+        // DirectComposition curves are cubics in seconds; every easing is a
+        // polynomial in t / duration, so its coefficients carry over exactly
+        double duration = durationMs / 1000.0;
+        double delta = endValue - startValue;
+        float linear = 0.0f;
+        float quadratic = 0.0f;
+        float cubic = 0.0f;
+
+        switch (m_easings[index]) {
+            case Easing::Linear:
+                linear = static_cast<float>(delta / duration);
+                break;
+            case Easing::EaseOut:
+                linear = static_cast<float>(2.0 * delta / duration);
+                quadratic = static_cast<float>(-delta / (duration * duration));
+                break;
+            case Easing::EaseInOut:
+                quadratic = static_cast<float>(3.0 * delta / (duration * duration));
+                cubic = static_cast<float>(-2.0 * delta / (duration * duration * duration));
+                break;
         }
+
+        hr = curve->AddCubic(0.0, startValue, linear, quadratic, cubic);
+        if (SUCCEEDED(hr)) {
+            hr = curve->End(duration, endValue);
+        }
+        if (SUCCEEDED(hr)) {
+            hr = ApplyComposition(index, curve.Get(), endValue);
+        }
+    }
+
+    // Jump straight to the end value if the curve could not be submitted
+    if (FAILED(hr)) {
+        ApplyComposition(index, nullptr, endValue);
     }
-    catch (const std::exception& e) {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "AnimationManager log error: " << e.what() << std::endl;
+
+    m_compositionDevice->Commit();
+}
+
+HRESULT AnimationManager::ApplyComposition(uint32_t index, IDCompositionAnimation* animation, float value)
+{
+    const CompositionTarget& target = m_bindings[index].target;
+
+    switch (m_bindings[index].property) {
+        case CompositionProperty::Opacity:
+            if (!target.effect) {
+                return E_POINTER;
+            }
+            return animation ? target.effect->SetOpacity(animation) : target.effect->SetOpacity(value);
+
+        case CompositionProperty::OffsetX:
+            if (!target.visual) {
+                return E_POINTER;
+            }
+            return animation ? target.visual->SetOffsetX(animation) : target.visual->SetOffsetX(value);
+
+        case CompositionProperty::OffsetY:
+            if (!target.visual) {
+                return E_POINTER;
+            }
+            return animation ? target.visual->SetOffsetY(animation) : target.visual->SetOffsetY(value);
+
+        case CompositionProperty::Scale: {
+            if (!target.scale) {
+                return E_POINTER;
+            }
+            HRESULT hr = animation ? target.scale->SetScaleX(animation) : target.scale->SetScaleX(value);
+            if (SUCCEEDED(hr)) {
+                hr = animation ? target.scale->SetScaleY(animation) : target.scale->SetScaleY(value);
+            }
+            return hr;
+        }
     }
+
+    return E_INVALIDARG;
 }
 
-} // namespace poe
\ No newline at end of file
+} // namespace poe
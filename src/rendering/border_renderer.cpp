@@ -2,15 +2,18 @@
 #include "window/overlay_window.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
 
 namespace poe {
 
 BorderRenderer::BorderRenderer(Application& app, OverlayWindow& overlayWindow)
     : m_app(app)
     , m_overlayWindow(overlayWindow)
+    , m_brushGeneration(0)
     , m_initialized(false)
     , m_width(0)
     , m_height(0)
+    , m_contentDirty(true)
 {
     Log(2, "BorderRenderer created");
 }
@@ -20,7 +23,7 @@ BorderRenderer::~BorderRenderer()
     Shutdown();
 }
 
-bool BorderRenderer::Initialize()
+bool BorderRenderer::Initialize(ID2D1Factory* factory)
 {
     if (m_initialized) {
         return true;
@@ -33,18 +36,25 @@ bool BorderRenderer::Initialize()
         m_width = clientRect.right - clientRect.left;
         m_height = clientRect.bottom - clientRect.top;
 
-        // Create Direct2D factory
-        HRESULT hr = D2D1CreateFactory(
-            D2D1_FACTORY_TYPE_SINGLE_THREADED,
-            m_d2dFactory.GetAddressOf()
-        );
-
-        if (FAILED(hr)) {
-            Log(4, "Failed to create Direct2D factory: 0x{:X}", hr);
-            return false;
+        if (factory) {
+            // Share the compositor's factory so the geometries can draw on its targets
+            m_d2dFactory = factory;
+        } else {
+            // Create Direct2D factory
+            HRESULT hr = D2D1CreateFactory(
+                D2D1_FACTORY_TYPE_SINGLE_THREADED,
+                m_d2dFactory.GetAddressOf()
+            );
+
+            if (FAILED(hr)) {
+                Log(4, "Failed to create Direct2D factory: 0x{:X}", hr);
+                return false;
+            }
         }
 
         m_initialized = true;
+        BuildGeometry();
+
         Log(2, "BorderRenderer initialized successfully");
         return true;
     }
@@ -61,27 +71,35 @@ void BorderRenderer::Shutdown()
     }
 
     ReleaseDeviceResources();
+    m_borderGeometry.Reset();
+    m_shadowGeometry.Reset();
     m_d2dFactory.Reset();
 
     m_initialized = false;
     Log(2, "BorderRenderer shutdown");
 }
 
-void BorderRenderer::Render(ID2D1RenderTarget* rt, float opacity)
+void BorderRenderer::Render(ID2D1RenderTarget* rt, uint64_t deviceGeneration, float opacity)
 {
-    if (!m_initialized || !rt) {
+    if (!m_initialized || !rt || !m_borderGeometry) {
         return;
     }
 
-    // Create resources if needed
+    ScopedPerfTimer timer(m_app.GetFrameProfiler(), PerfStage::BorderRender);
+
+    // Brushes belong to the device that created them; a recreated target
+    // can come back at the address of the lost one
+    if (m_borderBrush && deviceGeneration != m_brushGeneration) {
+        ReleaseDeviceResources();
+    }
+
+    // Create resources if needed; opacity is applied per draw, not baked into the color
     if (!m_borderBrush || !m_shadowBrush) {
         HRESULT hr;
 
         // Create border brush
-        D2D1::ColorF borderColor = m_style.color;
-        borderColor.a *= opacity; // Apply opacity
         hr = rt->CreateSolidColorBrush(
-            borderColor,
+            m_style.color,
             m_borderBrush.GetAddressOf()
         );
 
@@ -91,64 +109,32 @@ void BorderRenderer::Render(ID2D1RenderTarget* rt, float opacity)
         }
 
         // Create shadow brush
-        D2D1::ColorF shadowColor = m_style.shadowColor;
-        shadowColor.a *= opacity; // Apply opacity
         hr = rt->CreateSolidColorBrush(
-            shadowColor,
+            m_style.shadowColor,
             m_shadowBrush.GetAddressOf()
         );
 
         if (FAILED(hr)) {
             Log(4, "Failed to create shadow brush: 0x{:X}", hr);
+            m_borderBrush.Reset();
             return;
         }
-    }
 
-    // Begin drawing
-    rt->BeginDraw();
-
-    // Set transform to identity
-    rt->SetTransform(D2D1::Matrix3x2F::Identity());
+        m_brushGeneration = deviceGeneration;
+    }
 
-    // Create border rectangle with rounded corners
-    D2D1_ROUNDED_RECT borderRect = {
-        D2D1::RectF(
-            m_style.thickness / 2,
-            m_style.thickness / 2,
-            m_width - m_style.thickness / 2,
-            m_height - m_style.thickness / 2
-        ),
-        m_style.cornerRadius,
-        m_style.cornerRadius
-    };
+    m_borderBrush->SetOpacity(opacity);
+    m_shadowBrush->SetOpacity(opacity);
 
     // Draw shadow first if enabled
-    if (m_style.drawShadow) {
-        // Create shadow rectangle (slightly larger and offset)
-        D2D1_ROUNDED_RECT shadowRect = {
-            D2D1::RectF(
-                m_style.thickness / 2 + m_style.shadowOffset,
-                m_style.thickness / 2 + m_style.shadowOffset,
-                m_width - m_style.thickness / 2 + m_style.shadowOffset,
-                m_height - m_style.thickness / 2 + m_style.shadowOffset
-            ),
-            m_style.cornerRadius,
-            m_style.cornerRadius
-        };
-
-        // Draw shadow
-        rt->DrawRoundedRectangle(shadowRect, m_shadowBrush.Get(), m_style.thickness);
+    if (m_style.drawShadow && m_shadowGeometry) {
+        rt->DrawGeometry(m_shadowGeometry.Get(), m_shadowBrush.Get(), m_style.thickness);
     }
 
     // Draw border
-    rt->DrawRoundedRectangle(borderRect, m_borderBrush.Get(), m_style.thickness);
+    rt->DrawGeometry(m_borderGeometry.Get(), m_borderBrush.Get(), m_style.thickness);
 
-    // End drawing
-    HRESULT hr = rt->EndDraw();
-    if (FAILED(hr)) {
-        Log(4, "Failed to end drawing: 0x{:X}", hr);
-        ReleaseDeviceResources();
-    }
+    m_contentDirty = false;
 }
 
 void BorderRenderer::Resize(int width, int height)
@@ -160,8 +146,8 @@ void BorderRenderer::Resize(int width, int height)
     m_width = width;
     m_height = height;
 
-    // Release device resources to be recreated with new size
-    ReleaseDeviceResources();
+    // Brushes do not depend on the size; only the shapes change
+    BuildGeometry();
 }
 
 void BorderRenderer::SetStyle(const BorderStyle& style)
@@ -172,17 +158,49 @@ void BorderRenderer::SetStyle(const BorderStyle& style)
 
     m_style = style;
 
-    // Release device resources to be recreated with new style
+    // Colors are baked into the brushes, shapes into the geometries
     ReleaseDeviceResources();
+    BuildGeometry();
 }
 
-bool BorderRenderer::CreateDeviceResources()
+bool BorderRenderer::BuildGeometry()
 {
-    if (!m_initialized) {
+    m_borderGeometry.Reset();
+    m_shadowGeometry.Reset();
+    m_contentDirty = true;
+
+    if (!m_d2dFactory || m_width <= 0 || m_height <= 0) {
         return false;
     }
 
-    // Resources will be created on-demand in Render
+    // Create border rectangle with rounded corners, inset so the stroke stays inside
+    const float inset = m_style.thickness / 2;
+    D2D1_ROUNDED_RECT borderRect = {
+        D2D1::RectF(inset, inset, m_width - inset, m_height - inset),
+        m_style.cornerRadius,
+        m_style.cornerRadius
+    };
+
+    HRESULT hr = m_d2dFactory->CreateRoundedRectangleGeometry(borderRect, m_borderGeometry.GetAddressOf());
+    if (FAILED(hr)) {
+        Log(4, "Failed to create border geometry: 0x{:X}", hr);
+        return false;
+    }
+
+    if (m_style.drawShadow) {
+        // Create shadow rectangle (offset)
+        D2D1_ROUNDED_RECT shadowRect = borderRect;
+        shadowRect.rect.left += m_style.shadowOffset;
+        shadowRect.rect.top += m_style.shadowOffset;
+        shadowRect.rect.right += m_style.shadowOffset;
+        shadowRect.rect.bottom += m_style.shadowOffset;
+
+        hr = m_d2dFactory->CreateRoundedRectangleGeometry(shadowRect, m_shadowGeometry.GetAddressOf());
+        if (FAILED(hr)) {
+            Log(3, "Failed to create border shadow geometry: 0x{:X}", hr);
+        }
+    }
+
     return true;
 }
 
@@ -190,28 +208,8 @@ void BorderRenderer::ReleaseDeviceResources()
 {
     m_borderBrush.Reset();
     m_shadowBrush.Reset();
-}
-
-template<typename... Args>
-void BorderRenderer::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level) {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e) {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "BorderRenderer log error: " << e.what() << std::endl;
-    }
+    m_brushGeneration = 0;
+    m_contentDirty = true;
 }
 
 } // namespace poe
\ No newline at end of file
@@ -3,24 +3,37 @@
 #include "rendering/animation_manager.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
+#include "core/StartupTimeline.h"
 
 namespace poe {
 
-CompositeRenderer::CompositeRenderer(Application& app, OverlayWindow& overlayWindow)
+CompositeRenderer::CompositeRenderer(Application& app, OverlayWindow& overlayWindow, GraphicsDevice& device)
     : m_app(app)
     , m_overlayWindow(overlayWindow)
+    , m_device(device)
+    , m_deviceCallbackId(0)
     , m_animationManager(nullptr)
+    , m_frameMailbox(nullptr)
     , m_initialized(false)
     , m_width(0)
     , m_height(0)
     , m_opacity(1.0f)
     , m_showBorder(false)
+    , m_panelsDirty(false)
+    , m_deviceLost(false)
+    , m_nextPanelId(1)
+    , m_recoveryGeneration(0)
 {
+    m_deviceCallbackId = m_device.RegisterDeviceCallback([this](GraphicsDeviceEvent event) {
+        OnDeviceEvent(event);
+    });
     Log(2, "CompositeRenderer created");
 }
 
 CompositeRenderer::~CompositeRenderer()
 {
+    m_device.UnregisterDeviceCallback(m_deviceCallbackId);
     Shutdown();
 }
 
@@ -38,32 +51,26 @@ bool CompositeRenderer::Initialize()
         m_height = clientRect.bottom - clientRect.top;
 
         // Create overlay renderer
-        m_overlayRenderer = std::make_unique<OverlayRenderer>(m_app, m_overlayWindow);
+        m_overlayRenderer = std::make_unique<OverlayRenderer>(m_app, m_overlayWindow, m_device);
         if (!m_overlayRenderer->Initialize()) {
             Log(4, "Failed to initialize overlay renderer");
             return false;
         }
 
-        // Create border renderer
+        // Create border renderer; its geometries must come from the factory
+        // of the device context the overlay renderer rasterizes them with
         m_borderRenderer = std::make_unique<BorderRenderer>(m_app, m_overlayWindow);
-        if (!m_borderRenderer->Initialize()) {
+        if (!m_borderRenderer->Initialize(m_overlayRenderer->GetD2DFactory())) {
             Log(4, "Failed to initialize border renderer");
             return false;
         }
 
-        // Create Direct2D factory
-        HRESULT hr = D2D1CreateFactory(
-            D2D1_FACTORY_TYPE_SINGLE_THREADED,
-            m_d2dFactory.GetAddressOf()
-        );
-
-        if (FAILED(hr)) {
-            Log(4, "Failed to create Direct2D factory: 0x{:X}", hr);
-            return false;
-        }
-
-        // Create render target
-        if (!CreateRenderTarget()) {
+        // Panels live in their own subtree between the content and the border
+        m_zOrderManager = std::make_unique<ZOrderManager>(
+            m_app, Microsoft::WRL::ComPtr<IDCompositionDevice>(m_overlayRenderer->GetCompositionDevice()));
+        if (!m_zOrderManager->Initialize() ||
+            !m_overlayRenderer->AttachVisual(m_zOrderManager->GetRootVisual().Get())) {
+            Log(4, "Failed to initialize panel tree");
             return false;
         }
 
@@ -79,112 +86,114 @@ bool CompositeRenderer::Initialize()
 
 void CompositeRenderer::Shutdown()
 {
+    // Records kept across a device loss go as well
+    m_deviceLost = false;
     if (!m_initialized) {
+        m_panels.clear();
         return;
     }
 
-    ReleaseRenderTarget();
-    
+    ReleasePipeline();
+    m_panels.clear();
+    Log(2, "CompositeRenderer shutdown");
+}
+
+void CompositeRenderer::ReleasePipeline()
+{
     if (m_borderRenderer) {
         m_borderRenderer->Shutdown();
         m_borderRenderer.reset();
     }
     
+    // Panel surfaces must go before the device that created them
+    for (auto& pair : m_panels) {
+        ReleasePanelResources(pair.second);
+    }
+    if (m_zOrderManager) {
+        if (m_overlayRenderer) {
+            m_overlayRenderer->DetachVisual(m_zOrderManager->GetRootVisual().Get());
+        }
+        m_zOrderManager->Shutdown();
+        m_zOrderManager.reset();
+    }
+    
     if (m_overlayRenderer) {
         m_overlayRenderer->Shutdown();
         m_overlayRenderer.reset();
     }
     
-    m_d2dFactory.Reset();
-
     m_initialized = false;
-    Log(2, "CompositeRenderer shutdown");
 }
 
-bool CompositeRenderer::CreateRenderTarget()
+void CompositeRenderer::Render()
 {
-    if (!m_initialized || !m_d2dFactory || m_width <= 0 || m_height <= 0) {
-        return false;
+    // One check per frame instead of a failure, log line and retry per draw call
+    m_device.CheckDevice();
+
+    // Rebuild once per device generation; a failed rebuild waits for the next one
+    if (!m_initialized) {
+        if (m_deviceLost && m_device.IsAvailable() && m_device.GetGeneration() != m_recoveryGeneration) {
+            RecoverDevice();
+        }
+        return;
     }
 
-    try {
-        // Release existing render target if any
-        ReleaseRenderTarget();
-
-        // Create HWND render target properties
-        D2D1_HWND_RENDER_TARGET_PROPERTIES hwndProps = D2D1::HwndRenderTargetProperties(
-            m_overlayWindow.GetHandle(),
-            D2D1::SizeU(m_width, m_height),
-            D2D1_PRESENT_OPTIONS_NONE
-        );
-
-        // Create render target properties
-        D2D1_RENDER_TARGET_PROPERTIES rtProps = D2D1::RenderTargetProperties(
-            D2D1_RENDER_TARGET_TYPE_DEFAULT,
-            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
-            96.0f, 96.0f,
-            D2D1_RENDER_TARGET_USAGE_NONE,
-            D2D1_FEATURE_LEVEL_DEFAULT
-        );
-
-        // Create render target
-        Microsoft::WRL::ComPtr<ID2D1HwndRenderTarget> hwndRT;
-        HRESULT hr = m_d2dFactory->CreateHwndRenderTarget(
-            rtProps,
-            hwndProps,
-            &hwndRT
-        );
+    FrameProfiler& profiler = m_app.GetFrameProfiler();
+    ScopedPerfTimer timer(profiler, PerfStage::CompositeRender);
+    profiler.MarkFrame();
 
-        if (FAILED(hr)) {
-            Log(4, "Failed to create HWND render target: 0x{:X}", hr);
-            return false;
+    // Upload the newest browser frame, if one arrived since the last render
+    if (m_frameMailbox && m_overlayRenderer) {
+        if (const FrameBuffer* frame = m_frameMailbox->Acquire()) {
+            m_overlayRenderer->UpdateContent(frame->pixels.data(), frame->width, frame->height, frame->dirtyRects);
         }
+    }
 
-        // Store as ID2D1RenderTarget
-        m_renderTarget = hwndRT;
+    // Update overlay renderer
+    if (m_overlayRenderer) {
+        m_overlayRenderer->Render();
+    }
 
-        Log(1, "Render target created successfully");
-        return true;
+    // Redraw the border only after its shape or style changed; showing and
+    // fading it is the border visual's opacity, with no Direct2D work
+    bool borderDrawn = false;
+    if (m_borderRenderer && m_overlayRenderer && m_borderRenderer->IsContentDirty()) {
+        borderDrawn = m_overlayRenderer->RasterizeBorder(*m_borderRenderer);
     }
-    catch (const std::exception& e) {
-        m_app.GetErrorHandler().ReportException(e, ErrorSeverity::Error, "CompositeRenderer");
-        return false;
+
+    // Panel content, the border, tree changes and transforms all land in one commit
+    bool panelsDrawn = UpdatePanels();
+    if (m_zOrderManager && (panelsDrawn || borderDrawn || m_panelsDirty || m_zOrderManager->HasPendingChanges())) {
+        ScopedPerfTimer commitTimer(profiler, PerfStage::CompositionCommit);
+        if (!m_zOrderManager->HasPendingChanges()) {
+            m_overlayRenderer->GetCompositionDevice()->Commit();
+        } else {
+            m_zOrderManager->Commit();
+        }
+        m_panelsDirty = false;
+        
+        if (panelsDrawn) {
+            StartupTimeline::Mark(StartupMilestone::FirstCommit);
+        }
     }
 }
 
-void CompositeRenderer::ReleaseRenderTarget()
+bool CompositeRenderer::UpdateContent(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects)
 {
-    m_renderTarget.Reset();
+    if (!m_initialized || !m_overlayRenderer) {
+        return false;
+    }
+
+    return m_overlayRenderer->UpdateContent(buffer, width, height, dirtyRects);
 }
 
-void CompositeRenderer::Render()
+bool CompositeRenderer::UpdateSharedContent(HANDLE sharedHandle)
 {
-    if (!m_initialized) {
-        return;
-    }
-
-    // Update overlay renderer
-    if (m_overlayRenderer) {
-        m_overlayRenderer->Render();
+    if (!m_initialized || !m_overlayRenderer) {
+        return false;
     }
 
-    // Draw border if needed using Direct2D
-    if (m_showBorder && m_borderRenderer && m_renderTarget) {
-        m_renderTarget->BeginDraw();
-        
-        // Clear the background (transparent)
-        m_renderTarget->Clear(D2D1::ColorF(0, 0, 0, 0));
-        
-        // Render border
-        m_borderRenderer->Render(m_renderTarget.Get(), m_opacity);
-        
-        HRESULT hr = m_renderTarget->EndDraw();
-        if (FAILED(hr)) {
-            Log(4, "Failed to end drawing: 0x{:X}", hr);
-            ReleaseRenderTarget();
-            CreateRenderTarget(); // Try to recover
-        }
-    }
+    return m_overlayRenderer->PresentSharedTexture(sharedHandle);
 }
 
 void CompositeRenderer::Resize(int width, int height)
@@ -201,39 +210,31 @@ void CompositeRenderer::Resize(int width, int height)
         m_overlayRenderer->Resize(width, height);
     }
 
-    // Resize border renderer
+    // Resize border renderer; it is rasterized again on the next render
     if (m_borderRenderer) {
         m_borderRenderer->Resize(width, height);
     }
-
-    // Recreate render target
-    CreateRenderTarget();
 }
 
 void CompositeRenderer::SetOpacity(float opacity)
 {
     // Clamp opacity to valid range
     opacity = (opacity < 0.0f) ? 0.0f : (opacity > 1.0f) ? 1.0f : opacity;
+    m_opacity = opacity;
     
-    if (m_opacity != opacity) {
-        m_opacity = opacity;
-        
-        // Update overlay renderer opacity
-        if (m_overlayRenderer) {
-            m_overlayRenderer->SetOpacity(opacity, false);
-        }
+    // Always forwarded: a static value also replaces a running composition fade
+    if (m_overlayRenderer) {
+        m_overlayRenderer->SetOpacity(opacity);
     }
 }
 
 void CompositeRenderer::ShowBorder(bool show)
 {
-    if (m_showBorder != show) {
-        m_showBorder = show;
-        
-        // Update overlay renderer
-        if (m_overlayRenderer) {
-            m_overlayRenderer->ShowBorders(show);
-        }
+    m_showBorder = show;
+    
+    // Always forwarded, for the same reason as SetOpacity()
+    if (m_overlayRenderer) {
+        m_overlayRenderer->ShowBorders(show);
     }
 }
 
@@ -245,26 +246,317 @@ void CompositeRenderer::SetPosition(int x, int y)
     }
 }
 
-template<typename... Args>
-void CompositeRenderer::Log(int level, const std::string& fmt, const Args&... args)
+CompositeRenderer::PanelId CompositeRenderer::CreatePanel(FrameMailbox* frameMailbox, const RECT& bounds, int zOrder)
 {
-    try {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level) {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
+    if (!m_initialized && !m_deviceLost) {
+        return kInvalidPanel;
+    }
+
+    if (bounds.right <= bounds.left || bounds.bottom <= bounds.top) {
+        Log(3, "Cannot create panel with empty bounds");
+        return kInvalidPanel;
+    }
+
+    Panel panel;
+    panel.frameMailbox = frameMailbox;
+    panel.bounds = bounds;
+    panel.zOrder = zOrder;
+
+    // Without a device the record waits for the rebuild
+    if (m_initialized && !CreatePanelResources(panel)) {
+        return kInvalidPanel;
+    }
+
+    PanelId id = m_nextPanelId++;
+    m_panels.emplace(id, std::move(panel));
+    UpdatePanelHitRects();
+    m_overlayWindow.RequestFrame();
+
+    Log(1, "Created panel {} at [{},{},{},{}]", id, bounds.left, bounds.top, bounds.right, bounds.bottom);
+    return id;
+}
+
+void CompositeRenderer::DestroyPanel(PanelId panel)
+{
+    auto it = m_panels.find(panel);
+    if (it == m_panels.end()) {
+        return;
+    }
+
+    if (m_zOrderManager && it->second.visualHandle != ZOrderManager::kInvalidHandle) {
+        m_zOrderManager->RemoveVisual(it->second.visualHandle);
+    }
+    ReleasePanelResources(it->second);
+    m_panels.erase(it);
+    UpdatePanelHitRects();
+    m_overlayWindow.RequestFrame();
+
+    Log(1, "Destroyed panel {}", panel);
+}
+
+bool CompositeRenderer::CreatePanelResources(Panel& panel)
+{
+    int width = panel.bounds.right - panel.bounds.left;
+    int height = panel.bounds.bottom - panel.bounds.top;
+
+    IDCompositionDevice* device = m_overlayRenderer->GetCompositionDevice();
+
+    ZOrderManager::VisualHandle handle = m_zOrderManager->CreateVisual(ZOrderManager::LayerType::UI, panel.zOrder);
+    if (handle == ZOrderManager::kInvalidHandle) {
+        return false;
+    }
+
+    Microsoft::WRL::ComPtr<IDCompositionVisual> visual = m_zOrderManager->GetVisual(handle);
+    auto surface = std::make_unique<ContentSurface>(m_app);
+    if (!surface->Initialize(device, m_overlayRenderer->GetD3DDevice(), width, height)) {
+        m_zOrderManager->RemoveVisual(handle);
+        return false;
+    }
+
+    // Clip to the panel so content painted past its size never shows
+    Microsoft::WRL::ComPtr<IDCompositionRectangleClip> clip;
+    HRESULT hr = device->CreateRectangleClip(&clip);
+    if (SUCCEEDED(hr)) {
+        clip->SetLeft(0.0f);
+        clip->SetTop(0.0f);
+        clip->SetRight(static_cast<float>(width));
+        clip->SetBottom(static_cast<float>(height));
+        hr = visual->SetClip(clip.Get());
+    }
+    if (SUCCEEDED(hr)) {
+        hr = visual->SetContent(surface->GetSurface());
+    }
+    if (FAILED(hr)) {
+        Log(4, "Failed to set up panel visual: 0x{:X}", hr);
+        m_zOrderManager->RemoveVisual(handle);
+        return false;
+    }
+
+    visual->SetOffsetX(static_cast<float>(panel.bounds.left));
+    visual->SetOffsetY(static_cast<float>(panel.bounds.top));
+    if (!panel.visible) {
+        m_zOrderManager->SetVisualVisibility(handle, false);
+    }
+
+    panel.visualHandle = handle;
+    panel.visual = std::move(visual);
+    panel.clip = std::move(clip);
+    panel.surface = std::move(surface);
+    return true;
+}
+
+void CompositeRenderer::ReleasePanelResources(Panel& panel)
+{
+    if (panel.surface) {
+        panel.surface->Shutdown();
+        panel.surface.reset();
+    }
+
+    panel.visualHandle = ZOrderManager::kInvalidHandle;
+    panel.visual.Reset();
+    panel.clip.Reset();
+    panel.sharedTexture.Reset();
+    panel.sharedHandle = nullptr;
+}
+
+bool CompositeRenderer::SetPanelPosition(PanelId panel, int x, int y)
+{
+    auto it = m_panels.find(panel);
+    if (it == m_panels.end()) {
+        return false;
+    }
+
+    RECT& bounds = it->second.bounds;
+    if (bounds.left == x && bounds.top == y) {
+        return true;
+    }
+
+    OffsetRect(&bounds, x - bounds.left, y - bounds.top);
+    if (it->second.visual) {
+        it->second.visual->SetOffsetX(static_cast<float>(x));
+        it->second.visual->SetOffsetY(static_cast<float>(y));
+        m_panelsDirty = true;
+    }
+
+
+    UpdatePanelHitRects();
+    m_overlayWindow.RequestFrame();
+    return true;
+}
+
+bool CompositeRenderer::SetPanelBounds(PanelId panel, const RECT& bounds)
+{
+    auto it = m_panels.find(panel);
+    if (it == m_panels.end()) {
+        return false;
+    }
+
+    Panel& target = it->second;
+    int width = bounds.right - bounds.left;
+    int height = bounds.bottom - bounds.top;
+
+    if (width != target.bounds.right - target.bounds.left ||
+        height != target.bounds.bottom - target.bounds.top) {
+        // A panel without a surface gets one of the new size on the rebuild
+        if (target.surface && !target.surface->Resize(width, height)) {
+            return false;
         }
+
+        if (target.clip) {
+            target.clip->SetRight(static_cast<float>(width));
+            target.clip->SetBottom(static_cast<float>(height));
+        }
+
+        // Size is in place; the move below does the rest
+        target.bounds.right = target.bounds.left + width;
+        target.bounds.bottom = target.bounds.top + height;
+        m_panelsDirty = true;
+        UpdatePanelHitRects();
     }
-    catch (const std::exception& e) {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "CompositeRenderer log error: " << e.what() << std::endl;
+
+    return SetPanelPosition(panel, bounds.left, bounds.top);
+}
+
+bool CompositeRenderer::SetPanelVisible(PanelId panel, bool visible)
+{
+    auto it = m_panels.find(panel);
+    if (it == m_panels.end()) {
+        return false;
+    }
+
+    if (it->second.visualHandle != ZOrderManager::kInvalidHandle) {
+        m_zOrderManager->SetVisualVisibility(it->second.visualHandle, visible);
+    }
+    it->second.visible = visible;
+    UpdatePanelHitRects();
+    m_overlayWindow.RequestFrame();
+    return true;
+}
+
+bool CompositeRenderer::SetPanelZOrder(PanelId panel, int zOrder)
+{
+    auto it = m_panels.find(panel);
+    if (it == m_panels.end()) {
+        return false;
+    }
+
+    if (it->second.visualHandle != ZOrderManager::kInvalidHandle) {
+        m_zOrderManager->SetVisualZOrder(it->second.visualHandle, ZOrderManager::LayerType::UI, zOrder);
     }
+    it->second.zOrder = zOrder;
+    m_overlayWindow.RequestFrame();
+    return true;
+}
+
+void CompositeRenderer::UpdatePanelSharedContent(PanelId panel, HANDLE sharedHandle)
+{
+    auto it = m_panels.find(panel);
+    if (it == m_panels.end() || !it->second.surface || !sharedHandle) {
+        return;
+    }
+
+    Panel& target = it->second;
+
+    ScopedPerfTimer timer(m_app.GetFrameProfiler(), PerfStage::ContentUpload);
+
+    // CEF cycles through a small pool of textures, so only reopen on change
+    if (sharedHandle != target.sharedHandle || !target.sharedTexture) {
+        target.sharedTexture.Reset();
+        target.sharedHandle = nullptr;
+
+        HRESULT hr = m_overlayRenderer->GetD3DDevice()->OpenSharedResource(sharedHandle, IID_PPV_ARGS(&target.sharedTexture));
+        if (FAILED(hr)) {
+            Log(4, "Failed to open panel shared texture: 0x{:X}", hr);
+            return;
+        }
+
+        target.sharedHandle = sharedHandle;
+    }
+
+    if (target.surface->CopyFrom(target.sharedTexture.Get())) {
+        m_panelsDirty = true;
+        m_overlayWindow.RequestFrame();
+    }
+}
+
+void CompositeRenderer::OnDeviceEvent(GraphicsDeviceEvent event)
+{
+    if (event != GraphicsDeviceEvent::Lost || !m_initialized) {
+        return;
+    }
+
+    // Everything below the window hangs off the lost device; panels keep
+    // their records and get new surfaces on the rebuild
+    m_deviceLost = true;
+    ReleasePipeline();
+    m_overlayWindow.RequestFrame();
+}
+
+bool CompositeRenderer::RecoverDevice()
+{
+    m_recoveryGeneration = m_device.GetGeneration();
+    if (!Initialize()) {
+        Log(4, "Failed to rebuild renderer after device loss");
+        return false;
+    }
+
+    // Initialize() picked up the window size; the rest of the state is reapplied
+    m_overlayRenderer->SetOpacity(m_opacity);
+    m_overlayRenderer->ShowBorders(m_showBorder);
+
+    size_t restored = 0;
+    for (auto& pair : m_panels) {
+        if (CreatePanelResources(pair.second)) {
+            restored++;
+        } else {
+            Log(3, "Failed to rebuild panel {} after device loss", pair.first);
+        }
+    }
+    m_panelsDirty = true;
+    UpdatePanelHitRects();
+
+    m_deviceLost = false;
+    Log(2, "Renderer rebuilt after device loss ({} of {} panels restored)", restored, m_panels.size());
+
+    if (m_deviceRecreatedCallback) {
+        m_deviceRecreatedCallback();
+    }
+    m_overlayWindow.RequestFrame();
+    return true;
+}
+
+void CompositeRenderer::UpdatePanelHitRects()
+{
+    std::vector<RECT> rects;
+    rects.reserve(m_panels.size());
+    for (const auto& pair : m_panels) {
+        if (pair.second.visible) {
+            rects.push_back(pair.second.bounds);
+        }
+    }
+
+    // Panels capture the mouse over their whole rectangle, transparent pixels included
+    m_overlayWindow.SetHitTestRects(rects);
+}
+
+bool CompositeRenderer::UpdatePanels()
+{
+    bool anyDrawn = false;
+
+    for (auto& pair : m_panels) {
+        Panel& panel = pair.second;
+        if (!panel.frameMailbox || !panel.surface) {
+            continue;
+        }
+
+        if (const FrameBuffer* frame = panel.frameMailbox->Acquire()) {
+            bool drawn = false;
+            panel.surface->Update(frame->pixels.data(), frame->width, frame->height, frame->dirtyRects, drawn);
+            anyDrawn = anyDrawn || drawn;
+        }
+    }
+
+    return anyDrawn;
 }
 
 } // namespace poe
\ No newline at end of file
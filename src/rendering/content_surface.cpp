@@ -0,0 +1,210 @@
+#include "rendering/content_surface.h"
+#include "core/Logger.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace poe {
+
+ContentSurface::ContentSurface(Application& app)
+    : m_app(app)
+    , m_width(0)
+    , m_height(0)
+    , m_contentWidth(0)
+    , m_contentHeight(0)
+    , m_memoryCharge(MemoryTag::GpuSurfaces)
+{
+}
+
+bool ContentSurface::Initialize(IDCompositionDevice* dcompDevice, ID3D11Device* d3dDevice, int width, int height)
+{
+    if (!dcompDevice || !d3dDevice || width <= 0 || height <= 0) {
+        Log(4, "Invalid parameters for content surface: {}x{}", width, height);
+        return false;
+    }
+
+    d3dDevice->GetImmediateContext(&m_d3dContext);
+
+    // A virtual surface only backs the tiles that have been drawn, and
+    // resizing it keeps the existing tiles instead of reallocating
+    HRESULT hr = dcompDevice->CreateVirtualSurface(
+        static_cast<UINT>(width),
+        static_cast<UINT>(height),
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        DXGI_ALPHA_MODE_PREMULTIPLIED,
+        &m_surface
+    );
+
+    if (FAILED(hr)) {
+        Log(4, "Failed to create content surface: 0x{:X}", hr);
+        m_d3dContext.Reset();
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_contentWidth = 0;
+    m_contentHeight = 0;
+    m_memoryCharge.Set(static_cast<size_t>(width) * height * 4);
+    return true;
+}
+
+void ContentSurface::Shutdown()
+{
+    m_surface.Reset();
+    m_d3dContext.Reset();
+    m_width = 0;
+    m_height = 0;
+    m_contentWidth = 0;
+    m_contentHeight = 0;
+    m_memoryCharge.Set(0);
+}
+
+bool ContentSurface::Update(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects, bool& drawn)
+{
+    drawn = false;
+
+    if (!m_surface || !buffer || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    const UINT rowPitch = static_cast<UINT>(width) * 4;
+    const auto* pixels = static_cast<const uint8_t*>(buffer);
+    const int visibleWidth = std::min(width, m_width);
+    const int visibleHeight = std::min(height, m_height);
+
+    // A size change invalidates the whole surface, so upload everything once
+    RECT fullRect = { 0, 0, visibleWidth, visibleHeight };
+    bool fullUpload = SetContentSize(width, height);
+    const RECT* rects = fullUpload ? &fullRect : dirtyRects.data();
+    size_t rectCount = fullUpload ? 1 : dirtyRects.size();
+
+    // Each dirty rect is its own update: only those tiles are touched
+    for (size_t i = 0; i < rectCount; ++i) {
+        RECT update = {
+            std::max(rects[i].left, 0L),
+            std::max(rects[i].top, 0L),
+            std::min(rects[i].right, static_cast<LONG>(visibleWidth)),
+            std::min(rects[i].bottom, static_cast<LONG>(visibleHeight))
+        };
+        if (update.right <= update.left || update.bottom <= update.top) {
+            continue;
+        }
+
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+        POINT offset = {};
+        if (!BeginDraw(update, texture, offset)) {
+            return false;
+        }
+
+        // DirectComposition hands out a region of an atlas; write at its offset
+        D3D11_BOX box = {};
+        box.left = static_cast<UINT>(offset.x);
+        box.top = static_cast<UINT>(offset.y);
+        box.right = static_cast<UINT>(offset.x + (update.right - update.left));
+        box.bottom = static_cast<UINT>(offset.y + (update.bottom - update.top));
+        box.front = 0;
+        box.back = 1;
+
+        // Source pointer addresses the top-left pixel of the update
+        const uint8_t* source = pixels + update.top * rowPitch + update.left * 4;
+        m_d3dContext->UpdateSubresource(texture.Get(), 0, &box, source, rowPitch, 0);
+
+        m_surface->EndDraw();
+        drawn = true;
+    }
+
+    return true;
+}
+
+bool ContentSurface::CopyFrom(ID3D11Texture2D* source)
+{
+    if (!m_surface || !source) {
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    source->GetDesc(&textureDesc);
+
+    SetContentSize(static_cast<int>(textureDesc.Width), static_cast<int>(textureDesc.Height));
+
+    RECT update = { 0, 0,
+        std::min(static_cast<LONG>(textureDesc.Width), static_cast<LONG>(m_width)),
+        std::min(static_cast<LONG>(textureDesc.Height), static_cast<LONG>(m_height)) };
+
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+    POINT offset = {};
+    if (!BeginDraw(update, texture, offset)) {
+        return false;
+    }
+
+    // GPU-side copy into the surface; no pixels travel through system memory
+    D3D11_BOX sourceBox = { 0, 0, 0, static_cast<UINT>(update.right), static_cast<UINT>(update.bottom), 1 };
+    m_d3dContext->CopySubresourceRegion(texture.Get(), 0, offset.x, offset.y, 0, source, 0, &sourceBox);
+
+    m_surface->EndDraw();
+    return true;
+}
+
+bool ContentSurface::Resize(int width, int height)
+{
+    if (!m_surface || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    if (width == m_width && height == m_height) {
+        return true;
+    }
+
+    // Keeps the tiles that still fit and drops the rest
+    HRESULT hr = m_surface->Resize(static_cast<UINT>(width), static_cast<UINT>(height));
+    if (FAILED(hr)) {
+        Log(4, "Failed to resize content surface: 0x{:X}", hr);
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_memoryCharge.Set(static_cast<size_t>(width) * height * 4);
+    return true;
+}
+
+bool ContentSurface::SetContentSize(int width, int height)
+{
+    if (width == m_contentWidth && height == m_contentHeight) {
+        return false;
+    }
+
+    bool shrunk = width < m_contentWidth || height < m_contentHeight;
+    m_contentWidth = width;
+    m_contentHeight = height;
+
+    // Release the tiles the smaller content no longer covers
+    if (shrunk) {
+        RECT valid = { 0, 0, std::min(width, m_width), std::min(height, m_height) };
+        m_surface->Trim(&valid, 1);
+    }
+
+    return true;
+}
+
+bool ContentSurface::BeginDraw(const RECT& updateRect, Microsoft::WRL::ComPtr<ID3D11Texture2D>& texture, POINT& offset)
+{
+    Microsoft::WRL::ComPtr<IDXGISurface> dxgiSurface;
+    HRESULT hr = m_surface->BeginDraw(&updateRect, IID_PPV_ARGS(&dxgiSurface), &offset);
+    if (FAILED(hr)) {
+        Log(4, "Failed to begin drawing content surface: 0x{:X}", hr);
+        return false;
+    }
+
+    hr = dxgiSurface.As(&texture);
+    if (FAILED(hr)) {
+        Log(4, "Content surface is not a D3D11 texture: 0x{:X}", hr);
+        m_surface->EndDraw();
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace poe
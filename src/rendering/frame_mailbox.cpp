@@ -0,0 +1,138 @@
+#include "rendering/frame_mailbox.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace poe {
+
+FrameMailbox::FrameMailbox()
+    : m_slot(1)
+    , m_backIndex(0)
+    , m_staleAll{ true, true, true }
+    , m_sequence(0)
+    , m_width(0)
+    , m_height(0)
+    , m_frontIndex(2)
+    , m_droppedFrames(0)
+    , m_pixelCharge(MemoryTag::FrameBuffers)
+{
+}
+
+void FrameMailbox::Publish(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects)
+{
+    if (!buffer || width <= 0 || height <= 0) {
+        return;
+    }
+
+    const size_t rowPitch = static_cast<size_t>(width) * 4;
+    const auto* source = static_cast<const uint8_t*>(buffer);
+
+    // A size change invalidates every buffer and any outstanding damage
+    bool resized = m_width != width || m_height != height;
+    if (resized) {
+        m_width = width;
+        m_height = height;
+        m_staleAll = { true, true, true };
+        for (auto& stale : m_staleRects) {
+            stale.clear();
+        }
+        m_carriedRects.clear();
+    }
+
+    FrameBuffer& frame = m_buffers[m_backIndex];
+    if (frame.width != width || frame.height != height) {
+        frame.pixels.resize(rowPitch * height);
+        frame.width = width;
+        frame.height = height;
+        m_staleAll[m_backIndex] = true;
+
+        m_pixelCharge.Set(m_buffers[0].pixels.capacity() + m_buffers[1].pixels.capacity() +
+            m_buffers[2].pixels.capacity());
+    }
+
+    // Bring this buffer up to date: what it missed while away, plus the new damage
+    if (m_staleAll[m_backIndex]) {
+        std::memcpy(frame.pixels.data(), source, rowPitch * height);
+    } else {
+        MergeRects(m_staleRects[m_backIndex], dirtyRects);
+
+        for (const auto& rect : m_staleRects[m_backIndex]) {
+            const size_t offset = static_cast<size_t>(rect.left) * 4;
+            const size_t bytes = static_cast<size_t>(rect.right - rect.left) * 4;
+
+            for (LONG y = rect.top; y < rect.bottom; ++y) {
+                const size_t row = static_cast<size_t>(y) * rowPitch + offset;
+                std::memcpy(frame.pixels.data() + row, source + row, bytes);
+            }
+        }
+    }
+
+    m_staleAll[m_backIndex] = false;
+    m_staleRects[m_backIndex].clear();
+
+    // The other two buffers now lag behind by this frame's damage
+    for (uint32_t i = 0; i < m_buffers.size(); ++i) {
+        if (i != m_backIndex && !m_staleAll[i]) {
+            MergeRects(m_staleRects[i], dirtyRects);
+        }
+    }
+
+    // Damage reported to the consumer covers every frame since the last one it is known to have seen
+    if (resized) {
+        frame.dirtyRects.assign(1, RECT{ 0, 0, width, height });
+    } else {
+        frame.dirtyRects = m_carriedRects;
+        MergeRects(frame.dirtyRects, dirtyRects);
+    }
+    frame.sequence = ++m_sequence;
+
+    // Keep a private copy; once published, the consumer may own the buffer
+    m_publishedRects = frame.dirtyRects;
+
+    uint32_t previous = m_slot.exchange(m_backIndex | kFreshBit, std::memory_order_acq_rel);
+    m_backIndex = previous & kIndexMask;
+
+    if (previous & kFreshBit) {
+        // The previous frame was never consumed, so its damage rides along with the next one
+        m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        m_carriedRects.swap(m_publishedRects);
+    } else if (resized) {
+        // The consumer took the previous frame, but this one replaced everything
+        m_carriedRects.assign(1, RECT{ 0, 0, width, height });
+    } else {
+        // The consumer took the previous frame; only this frame's damage is outstanding
+        m_carriedRects = dirtyRects;
+    }
+}
+
+const FrameBuffer* FrameMailbox::Acquire()
+{
+    if (!(m_slot.load(std::memory_order_acquire) & kFreshBit)) {
+        return nullptr;
+    }
+
+    uint32_t previous = m_slot.exchange(m_frontIndex, std::memory_order_acq_rel);
+    m_frontIndex = previous & kIndexMask;
+    return &m_buffers[m_frontIndex];
+}
+
+void FrameMailbox::MergeRects(std::vector<RECT>& target, const std::vector<RECT>& rects)
+{
+    target.insert(target.end(), rects.begin(), rects.end());
+
+    if (target.size() <= kMaxDirtyRects) {
+        return;
+    }
+
+    RECT bounds = target.front();
+    for (const auto& rect : target) {
+        bounds.left = std::min(bounds.left, rect.left);
+        bounds.top = std::min(bounds.top, rect.top);
+        bounds.right = std::max(bounds.right, rect.right);
+        bounds.bottom = std::max(bounds.bottom, rect.bottom);
+    }
+
+    target.assign(1, bounds);
+}
+
+} // namespace poe
@@ -0,0 +1,197 @@
+#include "rendering/graphics_device.h"
+#include "core/Logger.h"
+#include "core/ErrorHandler.h"
+
+#include <algorithm>
+
+// DirectX libraries
+#pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "d2d1.lib")
+#pragma comment(lib, "dcomp.lib")
+
+namespace poe {
+
+namespace {
+
+/// Spacing of creation attempts while the devices stay unavailable
+constexpr std::chrono::seconds kRecreateInterval(1);
+
+} // namespace
+
+GraphicsDevice::GraphicsDevice(Application& app)
+    : m_app(app)
+    , m_nextCallbackId(1)
+    , m_generation(0)
+    , m_lost(false)
+{
+}
+
+GraphicsDevice::~GraphicsDevice()
+{
+    Shutdown();
+}
+
+bool GraphicsDevice::Create()
+{
+    if (IsAvailable()) {
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    HRESULT hr;
+
+    // Create D3D11 device
+    D3D_FEATURE_LEVEL featureLevels[] = { D3D_FEATURE_LEVEL_11_0 };
+    UINT creationFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+
+    #ifdef _DEBUG
+    creationFlags |= D3D11_CREATE_DEVICE_DEBUG;
+    #endif
+
+    hr = D3D11CreateDevice(
+        nullptr,                      // Default adapter
+        D3D_DRIVER_TYPE_HARDWARE,     // Hardware driver
+        nullptr,                      // No software driver
+        creationFlags,                // Flags
+        featureLevels,                // Feature levels
+        ARRAYSIZE(featureLevels),     // Number of feature levels
+        D3D11_SDK_VERSION,            // SDK version
+        &m_d3dDevice,                 // Output device
+        nullptr,                      // Output feature level
+        &m_d3dContext                 // Output context
+    );
+
+    if (FAILED(hr)) {
+        Log(4, "Failed to create D3D11 device: 0x{:X}", hr);
+        ReleaseDevices();
+        return false;
+    }
+
+    // Get DXGI device
+    hr = m_d3dDevice.As(&m_dxgiDevice);
+    if (FAILED(hr)) {
+        Log(4, "Failed to get DXGI device: 0x{:X}", hr);
+        ReleaseDevices();
+        return false;
+    }
+
+    // Create DirectComposition device
+    hr = DCompositionCreateDevice(m_dxgiDevice.Get(), IID_PPV_ARGS(&m_dcompDevice));
+    if (FAILED(hr)) {
+        Log(4, "Failed to create DirectComposition device: 0x{:X}", hr);
+        ReleaseDevices();
+        return false;
+    }
+
+    // Direct2D on the same device draws the border straight into composition
+    // surfaces; without it the border visual just stays empty
+    hr = S_OK;
+    if (!m_d2dFactory) {
+        hr = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, IID_PPV_ARGS(&m_d2dFactory));
+    }
+    if (SUCCEEDED(hr)) {
+        hr = m_d2dFactory->CreateDevice(m_dxgiDevice.Get(), &m_d2dDevice);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = m_d2dDevice->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, &m_d2dContext);
+    }
+    if (FAILED(hr)) {
+        Log(3, "Direct2D unavailable, borders will not be drawn: 0x{:X}", hr);
+        m_d2dContext.Reset();
+        m_d2dDevice.Reset();
+    }
+
+    m_generation++;
+    m_lost = false;
+    Log(2, "Graphics devices created in {:.1f} ms (generation {})", std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count(), m_generation);
+    return true;
+}
+
+void GraphicsDevice::Shutdown()
+{
+    ReleaseDevices();
+    m_d2dFactory.Reset();
+    m_callbacks.clear();
+}
+
+bool GraphicsDevice::CheckDevice()
+{
+    if (m_d3dDevice) {
+        HRESULT reason = m_d3dDevice->GetDeviceRemovedReason();
+        if (SUCCEEDED(reason)) {
+            return true;
+        }
+
+        // Everyone lets go of the old device before the new one is made
+        m_app.GetErrorHandler().ReportError(ErrorSeverity::Warning, "Graphics device lost, recreating it",
+            "GraphicsDevice", fmt::format("Reason: 0x{:X}", static_cast<unsigned long>(reason)));
+        m_lost = true;
+        Broadcast(GraphicsDeviceEvent::Lost);
+        ReleaseDevices();
+        m_nextRecreateAttempt = std::chrono::steady_clock::now();
+    }
+
+    // Only a lost device is recreated here; the first creation is the owner's
+    if (!m_lost) {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_nextRecreateAttempt) {
+        return false;
+    }
+    m_nextRecreateAttempt = now + kRecreateInterval;
+
+    if (!Create()) {
+        return false;
+    }
+
+    Broadcast(GraphicsDeviceEvent::Recreated);
+    return true;
+}
+
+size_t GraphicsDevice::RegisterDeviceCallback(const DeviceCallback& callback)
+{
+    size_t callbackId = m_nextCallbackId++;
+    m_callbacks.push_back({callbackId, callback});
+    return callbackId;
+}
+
+bool GraphicsDevice::UnregisterDeviceCallback(size_t callbackId)
+{
+    auto it = std::find_if(m_callbacks.begin(), m_callbacks.end(),
+        [callbackId](const CallbackEntry& entry) { return entry.id == callbackId; });
+    if (it == m_callbacks.end()) {
+        return false;
+    }
+
+    m_callbacks.erase(it);
+    return true;
+}
+
+void GraphicsDevice::ReleaseDevices()
+{
+    m_d2dContext.Reset();
+    m_d2dDevice.Reset();
+    m_dcompDevice.Reset();
+    m_dxgiDevice.Reset();
+    m_d3dContext.Reset();
+    m_d3dDevice.Reset();
+}
+
+void GraphicsDevice::Broadcast(GraphicsDeviceEvent event)
+{
+    // A copy, so callbacks may unregister; one that destroys another renderer
+    // (and with it that renderer's registration) must not reach it afterwards
+    std::vector<CallbackEntry> callbacks = m_callbacks;
+    for (const auto& entry : callbacks) {
+        bool registered = std::any_of(m_callbacks.begin(), m_callbacks.end(),
+            [&entry](const CallbackEntry& current) { return current.id == entry.id; });
+        if (registered) {
+            entry.callback(event);
+        }
+    }
+}
+
+} // namespace poe
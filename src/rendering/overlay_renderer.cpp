@@ -1,34 +1,44 @@
 #include "rendering/overlay_renderer.h"
 #include "window/overlay_window.h"
+#include "rendering/border_renderer.h"
+#include "rendering/content_surface.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/FrameProfiler.h"
+#include "core/StartupTimeline.h"
+#include "core/TraceRing.h"
 
+#include <algorithm>
 #include <stdexcept>
-#include <chrono>
-
-// DirectX libraries
-#pragma comment(lib, "d3d11.lib")
-#pragma comment(lib, "dcomp.lib")
-#pragma comment(lib, "dxgi.lib")
+#include <cstdint>
 
 namespace poe {
 
-OverlayRenderer::OverlayRenderer(Application& app, OverlayWindow& overlayWindow)
+OverlayRenderer::OverlayRenderer(Application& app, OverlayWindow& overlayWindow, GraphicsDevice& device)
     : m_app(app)
     , m_overlayWindow(overlayWindow)
+    , m_device(device)
+    , m_deviceCallbackId(0)
+    , m_deviceGeneration(0)
+    , m_needsRebuild(false)
     , m_initialized(false)
     , m_currentOpacity(1.0f)
-    , m_targetOpacity(1.0f)
     , m_showBorders(false)
     , m_width(0)
     , m_height(0)
+    , m_sharedHandle(nullptr)
     , m_mouseNearBorder(false)
+    , m_borderSurfaceCharge(MemoryTag::GpuSurfaces)
 {
+    m_deviceCallbackId = m_device.RegisterDeviceCallback([this](GraphicsDeviceEvent event) {
+        OnDeviceEvent(event);
+    });
     Log(2, "OverlayRenderer created");
 }
 
 OverlayRenderer::~OverlayRenderer()
 {
+    m_device.UnregisterDeviceCallback(m_deviceCallbackId);
     Shutdown();
 }
 
@@ -45,29 +55,38 @@ bool OverlayRenderer::Initialize()
         m_width = clientRect.right - clientRect.left;
         m_height = clientRect.bottom - clientRect.top;
 
-        // Create DirectX resources
-        if (!CreateDeviceResources()) {
+        // Create the devices, unless GraphicsDevice::Create() already did
+        if (!m_device.Create()) {
             Log(4, "Failed to create device resources");
             return false;
         }
 
+        m_d3dDevice = m_device.GetD3DDevice();
+        m_dcompDevice = m_device.GetCompositionDevice();
+        m_d2dContext = m_device.GetD2DContext();
+        m_deviceGeneration = m_device.GetGeneration();
+
         // Create rendering resources
         if (!CreateRenderResources()) {
             Log(4, "Failed to create render resources");
+            ReleaseResources();
             return false;
         }
 
         // Setup composition
         if (!SetupComposition()) {
             Log(4, "Failed to setup composition");
+            ReleaseResources();
             return false;
         }
 
         m_initialized = true;
+        m_needsRebuild = false;
         Log(2, "OverlayRenderer initialized successfully");
         return true;
     }
     catch (const std::exception& e) {
+        ReleaseResources();
         m_app.GetErrorHandler().ReportException(e, ErrorSeverity::Error, "OverlayRenderer");
         return false;
     }
@@ -75,111 +94,70 @@ bool OverlayRenderer::Initialize()
 
 void OverlayRenderer::Shutdown()
 {
+    m_needsRebuild = false;
     if (!m_initialized) {
         return;
     }
 
+    ReleaseResources();
+    m_initialized = false;
+    Log(2, "OverlayRenderer shutdown");
+}
+
+void OverlayRenderer::ReleaseResources()
+{
     // Release resources in reverse order of creation
+    m_borderSurface.Reset();
+    m_borderSurfaceCharge.Set(0);
+    m_d2dContext.Reset();
+    m_borderEffect.Reset();
+    m_contentEffect.Reset();
     m_borderVisual.Reset();
     m_contentVisual.Reset();
     m_rootVisual.Reset();
     m_dcompTarget.Reset();
     m_dcompDevice.Reset();
-    m_swapChain.Reset();
-    m_dxgiFactory.Reset();
-    m_dxgiDevice.Reset();
-    m_d3dContext.Reset();
+    m_sharedTexture.Reset();
+    m_sharedHandle = nullptr;
+    if (m_content) {
+        m_content->Shutdown();
+        m_content.reset();
+    }
     m_d3dDevice.Reset();
-
-    m_initialized = false;
-    Log(2, "OverlayRenderer shutdown");
 }
 
-bool OverlayRenderer::CreateDeviceResources()
+void OverlayRenderer::OnDeviceEvent(GraphicsDeviceEvent event)
 {
-    HRESULT hr;
-
-    // Create D3D11 device
-    D3D_FEATURE_LEVEL featureLevels[] = { D3D_FEATURE_LEVEL_11_0 };
-    UINT creationFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-
-    #ifdef _DEBUG
-    creationFlags |= D3D11_CREATE_DEVICE_DEBUG;
-    #endif
-
-    hr = D3D11CreateDevice(
-        nullptr,                      // Default adapter
-        D3D_DRIVER_TYPE_HARDWARE,     // Hardware driver
-        nullptr,                      // No software driver
-        creationFlags,                // Flags
-        featureLevels,                // Feature levels
-        ARRAYSIZE(featureLevels),     // Number of feature levels
-        D3D11_SDK_VERSION,            // SDK version
-        &m_d3dDevice,                 // Output device
-        nullptr,                      // Output feature level
-        &m_d3dContext                 // Output context
-    );
-
-    if (FAILED(hr)) {
-        Log(4, "Failed to create D3D11 device: 0x{:X}", hr);
-        return false;
-    }
-
-    // Get DXGI device
-    hr = m_d3dDevice.As(&m_dxgiDevice);
-    if (FAILED(hr)) {
-        Log(4, "Failed to get DXGI device: 0x{:X}", hr);
-        return false;
-    }
-
-    // Create DXGI factory
-    hr = CreateDXGIFactory2(0, IID_PPV_ARGS(&m_dxgiFactory));
-    if (FAILED(hr)) {
-        Log(4, "Failed to create DXGI factory: 0x{:X}", hr);
-        return false;
-    }
-
-    // Create DirectComposition device
-    hr = DCompositionCreateDevice(m_dxgiDevice.Get(), IID_PPV_ARGS(&m_dcompDevice));
-    if (FAILED(hr)) {
-        Log(4, "Failed to create DirectComposition device: 0x{:X}", hr);
-        return false;
+    switch (event) {
+        case GraphicsDeviceEvent::Lost:
+            // Nothing created on the old device may outlive it, but the
+            // rebuild waits for a device that works
+            if (m_initialized) {
+                ReleaseResources();
+                m_initialized = false;
+                m_needsRebuild = true;
+                Log(2, "OverlayRenderer released device resources");
+            }
+            break;
+
+        case GraphicsDeviceEvent::Recreated:
+            if (m_needsRebuild) {
+                m_overlayWindow.RequestFrame();
+            }
+            break;
     }
-
-    Log(1, "Device resources created successfully");
-    return true;
 }
 
 bool OverlayRenderer::CreateRenderResources()
 {
     if (m_width <= 0 || m_height <= 0) {
-        Log(4, "Invalid dimensions for swap chain: {}x{}", m_width, m_height);
+        Log(4, "Invalid dimensions for content surface: {}x{}", m_width, m_height);
         return false;
     }
 
-    HRESULT hr;
-
-    // Create swap chain
-    DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
-    swapChainDesc.Width = m_width;
-    swapChainDesc.Height = m_height;
-    swapChainDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-    swapChainDesc.SampleDesc.Count = 1;
-    swapChainDesc.SampleDesc.Quality = 0;
-    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDesc.BufferCount = 2;
-    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
-    swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
-
-    hr = m_dxgiFactory->CreateSwapChainForComposition(
-        m_d3dDevice.Get(),
-        &swapChainDesc,
-        nullptr,
-        &m_swapChain
-    );
-
-    if (FAILED(hr)) {
-        Log(4, "Failed to create swap chain: 0x{:X}", hr);
+    m_content = std::make_unique<ContentSurface>(m_app);
+    if (!m_content->Initialize(m_dcompDevice.Get(), m_d3dDevice.Get(), m_width, m_height)) {
+        m_content.reset();
         return false;
     }
 
@@ -224,15 +202,28 @@ bool OverlayRenderer::SetupComposition()
         return false;
     }
 
-    // Set swap chain on content visual
-    hr = m_contentVisual->SetContent(m_swapChain.Get());
+    // Set content surface on content visual
+    hr = m_contentVisual->SetContent(m_content->GetSurface());
     if (FAILED(hr)) {
         Log(4, "Failed to set content on visual: 0x{:X}", hr);
         return false;
     }
 
+    // Opacity lives on effect groups so it can be driven by composition animations
+    hr = m_dcompDevice->CreateEffectGroup(&m_contentEffect);
+    if (SUCCEEDED(hr)) {
+        hr = m_dcompDevice->CreateEffectGroup(&m_borderEffect);
+    }
+    if (FAILED(hr)) {
+        Log(4, "Failed to create effect groups: 0x{:X}", hr);
+        return false;
+    }
+
     // Set opacity
-    hr = m_contentVisual->SetOpacity(m_currentOpacity);
+    hr = m_contentEffect->SetOpacity(m_currentOpacity);
+    if (SUCCEEDED(hr)) {
+        hr = m_contentVisual->SetEffect(m_contentEffect.Get());
+    }
     if (FAILED(hr)) {
         Log(4, "Failed to set opacity: 0x{:X}", hr);
         return false;
@@ -252,8 +243,11 @@ bool OverlayRenderer::SetupComposition()
         return false;
     }
     
-    // Set border opacity to 0 (hidden by default)
-    hr = m_borderVisual->SetOpacity(0.0f);
+    // Hidden unless it was shown before a rebuild
+    hr = m_borderEffect->SetOpacity(m_showBorders ? kBorderOpacity : 0.0f);
+    if (SUCCEEDED(hr)) {
+        hr = m_borderVisual->SetEffect(m_borderEffect.Get());
+    }
     if (FAILED(hr)) {
         Log(4, "Failed to set border opacity: 0x{:X}", hr);
         return false;
@@ -277,7 +271,7 @@ bool OverlayRenderer::SetupComposition()
     return true;
 }
 
-void OverlayRenderer::SetOpacity(float opacity, bool animate)
+void OverlayRenderer::SetOpacity(float opacity)
 {
     if (!m_initialized) {
         return;
@@ -286,46 +280,108 @@ void OverlayRenderer::SetOpacity(float opacity, bool animate)
     // Clamp to valid range
     opacity = (opacity < 0.0f) ? 0.0f : (opacity > 1.0f) ? 1.0f : opacity;
 
-    if (m_targetOpacity == opacity) {
-        return; // No change needed
-    }
+    // Always apply: a static value also replaces a composition animation
+    // that left the effect somewhere other than m_currentOpacity
+    m_currentOpacity = opacity;
+    m_contentEffect->SetOpacity(opacity);
 
-    m_targetOpacity = opacity;
+    ScopedPerfTimer timer(m_app.GetFrameProfiler(), PerfStage::CompositionCommit);
+    m_dcompDevice->Commit();
+}
 
-    if (!animate) {
-        // Apply immediately
-        m_currentOpacity = opacity;
-        m_contentVisual->SetOpacity(opacity);
-        m_dcompDevice->Commit();
+void OverlayRenderer::Render()
+{
+    // Rebuild once per device generation; a tree that fails to build on a
+    // device is not retried every frame, only on the next recreation
+    if (m_needsRebuild && m_device.IsAvailable() && m_device.GetGeneration() != m_deviceGeneration) {
+        if (Initialize()) {
+            Log(2, "OverlayRenderer rebuilt after device loss");
+        } else {
+            Log(4, "Failed to rebuild renderer after device loss");
+        }
+    }
+
+    if (!m_initialized) {
         return;
     }
 
-    // Animation handled in Render() method
-    // The opacity will be gradually changed in the render loop
+    // Fades run as composition animations on DWM's clock, so there is
+    // nothing to step here; DirectComposition presents the window
 }
 
-void OverlayRenderer::Render()
+bool OverlayRenderer::UpdateContent(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects)
 {
-    if (!m_initialized) {
-        return;
+    if (!m_initialized || !buffer || width <= 0 || height <= 0 || dirtyRects.empty()) {
+        return false;
     }
 
-    // Update opacity animation if needed
-    if (m_currentOpacity != m_targetOpacity) {
-        const float opacityStep = 0.05f;
-        
-        if (m_currentOpacity < m_targetOpacity) {
-            m_currentOpacity = std::min(m_currentOpacity + opacityStep, m_targetOpacity);
-        } else {
-            m_currentOpacity = std::max(m_currentOpacity - opacityStep, m_targetOpacity);
+    ScopedPerfTimer timer(m_app.GetFrameProfiler(), PerfStage::ContentUpload);
+
+    bool drawn = false;
+    if (!m_content->Update(buffer, width, height, dirtyRects, drawn)) {
+        return false;
+    }
+
+    if (!drawn) {
+        return true;
+    }
+
+    ScopedPerfTimer commitTimer(m_app.GetFrameProfiler(), PerfStage::CompositionCommit);
+    HRESULT hr = m_dcompDevice->Commit();
+    if (FAILED(hr)) {
+        Log(4, "Failed to commit content: 0x{:X}", hr);
+        return false;
+    }
+
+    m_app.GetTraceRing().Emit(TraceEvent::ContentCommitted, 0, static_cast<int64_t>(dirtyRects.size()));
+    StartupTimeline::Mark(StartupMilestone::FirstCommit);
+
+    // After the commit, so the scan never delays the frame it describes
+    m_overlayWindow.UpdateHitTestContent(buffer, width, height, dirtyRects);
+    return true;
+}
+
+bool OverlayRenderer::PresentSharedTexture(HANDLE sharedHandle)
+{
+    if (!m_initialized || !sharedHandle) {
+        return false;
+    }
+
+    ScopedPerfTimer timer(m_app.GetFrameProfiler(), PerfStage::ContentUpload);
+
+    HRESULT hr;
+
+    // CEF cycles through a small pool of textures, so only reopen on change
+    if (sharedHandle != m_sharedHandle || !m_sharedTexture) {
+        m_sharedTexture.Reset();
+        m_sharedHandle = nullptr;
+
+        hr = m_d3dDevice->OpenSharedResource(sharedHandle, IID_PPV_ARGS(&m_sharedTexture));
+        if (FAILED(hr)) {
+            Log(4, "Failed to open shared texture: 0x{:X}", hr);
+            return false;
         }
-        
-        m_contentVisual->SetOpacity(m_currentOpacity);
-        m_dcompDevice->Commit();
+
+        m_sharedHandle = sharedHandle;
     }
 
-    // Render logic goes here
-    // For now we just rely on DirectComposition to present the window
+    if (!m_content->CopyFrom(m_sharedTexture.Get())) {
+        return false;
+    }
+
+    ScopedPerfTimer commitTimer(m_app.GetFrameProfiler(), PerfStage::CompositionCommit);
+    hr = m_dcompDevice->Commit();
+    if (FAILED(hr)) {
+        Log(4, "Failed to present shared texture: 0x{:X}", hr);
+        return false;
+    }
+
+    m_app.GetTraceRing().Emit(TraceEvent::ContentCommitted, 1);
+    StartupTimeline::Mark(StartupMilestone::FirstCommit);
+
+    // GPU content cannot be scanned for transparency; all of it takes the mouse
+    m_overlayWindow.UpdateHitTestContent(m_content->GetWidth(), m_content->GetHeight());
+    return true;
 }
 
 void OverlayRenderer::Resize(int width, int height)
@@ -337,44 +393,47 @@ void OverlayRenderer::Resize(int width, int height)
     m_width = width;
     m_height = height;
 
-    // Release swap chain
-    m_contentVisual->SetContent(nullptr);
-    m_swapChain.Reset();
-
-    // Recreate swap chain with new size
-    DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
-    swapChainDesc.Width = width;
-    swapChainDesc.Height = height;
-    swapChainDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-    swapChainDesc.SampleDesc.Count = 1;
-    swapChainDesc.SampleDesc.Quality = 0;
-    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDesc.BufferCount = 2;
-    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
-    swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
-
-    HRESULT hr = m_dxgiFactory->CreateSwapChainForComposition(
-        m_d3dDevice.Get(),
-        &swapChainDesc,
-        nullptr,
-        &m_swapChain
-    );
+    // The border surface is sized to the window; it is rebuilt on the next rasterization
+    m_borderVisual->SetContent(nullptr);
+    m_borderSurface.Reset();
+    m_borderSurfaceCharge.Set(0);
 
-    if (FAILED(hr)) {
-        Log(4, "Failed to resize swap chain: 0x{:X}", hr);
+    // Resizing the virtual surface keeps the tiles that still fit and
+    // drops the rest; there is no backing store to reallocate
+    if (!m_content->Resize(width, height)) {
         return;
     }
 
-    // Set swap chain on content visual
-    hr = m_contentVisual->SetContent(m_swapChain.Get());
+    // Commit changes
+    m_dcompDevice->Commit();
+    Log(1, "Resized renderer to {}x{}", width, height);
+}
+
+bool OverlayRenderer::AttachVisual(IDCompositionVisual* visual)
+{
+    if (!m_initialized || !visual) {
+        return false;
+    }
+
+    // Directly above the main content, so the border stays on top
+    HRESULT hr = m_rootVisual->AddVisual(visual, TRUE, m_contentVisual.Get());
     if (FAILED(hr)) {
-        Log(4, "Failed to set content on visual after resize: 0x{:X}", hr);
+        Log(4, "Failed to attach visual: 0x{:X}", hr);
+        return false;
+    }
+
+    m_dcompDevice->Commit();
+    return true;
+}
+
+void OverlayRenderer::DetachVisual(IDCompositionVisual* visual)
+{
+    if (!m_initialized || !visual) {
         return;
     }
 
-    // Commit changes
+    m_rootVisual->RemoveVisual(visual);
     m_dcompDevice->Commit();
-    Log(1, "Resized renderer to {}x{}", width, height);
 }
 
 void OverlayRenderer::ShowBorders(bool show)
@@ -386,8 +445,8 @@ void OverlayRenderer::ShowBorders(bool show)
     m_showBorders = show;
     
     // Set border opacity based on visibility
-    float borderOpacity = show ? 0.7f : 0.0f;
-    m_borderVisual->SetOpacity(borderOpacity);
+    float borderOpacity = show ? kBorderOpacity : 0.0f;
+    m_borderEffect->SetOpacity(borderOpacity);
     
     // Commit changes
     m_dcompDevice->Commit();
@@ -398,6 +457,74 @@ void OverlayRenderer::ShowBorders(bool show)
     }
 }
 
+bool OverlayRenderer::RasterizeBorder(BorderRenderer& border)
+{
+    if (!m_initialized || !m_d2dContext || m_width <= 0 || m_height <= 0) {
+        return false;
+    }
+
+    HRESULT hr;
+
+    if (!m_borderSurface) {
+        hr = m_dcompDevice->CreateSurface(
+            static_cast<UINT>(m_width),
+            static_cast<UINT>(m_height),
+            DXGI_FORMAT_B8G8R8A8_UNORM,
+            DXGI_ALPHA_MODE_PREMULTIPLIED,
+            &m_borderSurface
+        );
+
+        if (FAILED(hr)) {
+            Log(4, "Failed to create border surface: 0x{:X}", hr);
+            return false;
+        }
+        m_borderSurfaceCharge.Set(static_cast<size_t>(m_width) * m_height * 4);
+    }
+
+    // DirectComposition hands out a region of an atlas; draw at its offset
+    Microsoft::WRL::ComPtr<IDXGISurface> dxgiSurface;
+    POINT offset = {};
+    hr = m_borderSurface->BeginDraw(nullptr, IID_PPV_ARGS(&dxgiSurface), &offset);
+    if (FAILED(hr)) {
+        Log(4, "Failed to begin drawing border surface: 0x{:X}", hr);
+        m_borderSurface.Reset();
+        m_borderSurfaceCharge.Set(0);
+        return false;
+    }
+
+    D2D1_BITMAP_PROPERTIES1 bitmapProps = D2D1::BitmapProperties1(
+        D2D1_BITMAP_OPTIONS_TARGET | D2D1_BITMAP_OPTIONS_CANNOT_DRAW,
+        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+    );
+
+    Microsoft::WRL::ComPtr<ID2D1Bitmap1> targetBitmap;
+    hr = m_d2dContext->CreateBitmapFromDxgiSurface(dxgiSurface.Get(), &bitmapProps, &targetBitmap);
+    if (SUCCEEDED(hr)) {
+        m_d2dContext->SetTarget(targetBitmap.Get());
+        m_d2dContext->BeginDraw();
+        m_d2dContext->SetTransform(D2D1::Matrix3x2F::Translation(
+            static_cast<float>(offset.x), static_cast<float>(offset.y)));
+        m_d2dContext->Clear(D2D1::ColorF(0, 0, 0, 0));
+
+        border.Render(m_d2dContext.Get(), m_deviceGeneration);
+
+        hr = m_d2dContext->EndDraw();
+        m_d2dContext->SetTarget(nullptr);
+    }
+
+    m_borderSurface->EndDraw();
+
+    if (FAILED(hr)) {
+        Log(4, "Failed to rasterize border: 0x{:X}", hr);
+        border.ReleaseDeviceResources();
+        return false;
+    }
+
+    // The caller commits, together with the rest of the frame
+    m_borderVisual->SetContent(m_borderSurface.Get());
+    return true;
+}
+
 void OverlayRenderer::UpdatePosition(int x, int y)
 {
     if (!m_initialized) {
@@ -412,26 +539,4 @@ void OverlayRenderer::UpdatePosition(int x, int y)
     m_dcompDevice->Commit();
 }
 
-template<typename... Args>
-void OverlayRenderer::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level) {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e) {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "OverlayRenderer log error: " << e.what() << std::endl;
-    }
-}
-
 } // namespace poe
\ No newline at end of file
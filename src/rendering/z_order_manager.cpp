@@ -3,6 +3,7 @@
 #include "core/ErrorHandler.h"
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace poe {
@@ -10,8 +11,10 @@ namespace poe {
 ZOrderManager::ZOrderManager(Application& app, Microsoft::WRL::ComPtr<IDCompositionDevice> dcompDevice)
     : m_app(app)
     , m_dcompDevice(dcompDevice)
+    , m_nextHandle(kInvalidHandle + 1)
     , m_initialized(false)
-    , m_treeNeedsRebuild(false)
+    , m_orderDirty(false)
+    , m_pendingChanges(false)
 {
     Log(2, "ZOrderManager created");
 }
@@ -58,165 +61,137 @@ void ZOrderManager::Shutdown()
 
     // Clear all visuals
     m_visuals.clear();
+    m_handleIndex.clear();
+    m_detached.clear();
     m_rootVisual.Reset();
+    m_orderDirty = false;
+    m_pendingChanges = false;
 
     m_initialized = false;
     Log(2, "ZOrderManager shutdown");
 }
 
-Microsoft::WRL::ComPtr<IDCompositionVisual> ZOrderManager::CreateVisual(
-    const std::string& name,
-    LayerType layerType,
-    int zOrder)
+ZOrderManager::VisualHandle ZOrderManager::CreateVisual(LayerType layerType, int zOrder)
 {
     if (!m_initialized) {
         Log(4, "Cannot create visual: ZOrderManager not initialized");
-        return nullptr;
+        return kInvalidHandle;
     }
 
     try {
-        // Check if visual with this name already exists
-        auto it = m_visuals.find(name);
-        if (it != m_visuals.end()) {
-            Log(3, "Visual '{}' already exists, returning existing visual", name);
-            return it->second.visual;
-        }
-
         // Create the visual
         Microsoft::WRL::ComPtr<IDCompositionVisual> visual;
         HRESULT hr = m_dcompDevice->CreateVisual(&visual);
         if (FAILED(hr)) {
-            Log(4, "Failed to create visual '{}': 0x{:X}", name, hr);
-            return nullptr;
+            Log(4, "Failed to create visual: 0x{:X}", hr);
+            return kInvalidHandle;
         }
 
-        // Add to our map
-        VisualInfo info;
-        info.visual = visual;
-        info.layerType = layerType;
-        info.zOrder = zOrder;
-        info.visible = true;
+        VisualHandle handle = Insert(visual, layerType, zOrder);
 
-        m_visuals[name] = info;
-        m_treeNeedsRebuild = true;
+        Log(1, "Created visual {} with layer type {} and Z-order {}", 
+            handle, static_cast<int>(layerType), zOrder);
 
-        Log(1, "Created visual '{}' with layer type {} and Z-order {}", 
-            name, static_cast<int>(layerType), zOrder);
-
-        return visual;
+        return handle;
     }
     catch (const std::exception& e) {
         m_app.GetErrorHandler().ReportException(e, ErrorSeverity::Error, "ZOrderManager");
-        return nullptr;
+        return kInvalidHandle;
     }
 }
 
-bool ZOrderManager::AddVisual(
-    const std::string& name,
+ZOrderManager::VisualHandle ZOrderManager::AddVisual(
     Microsoft::WRL::ComPtr<IDCompositionVisual> visual,
     LayerType layerType,
     int zOrder)
 {
     if (!m_initialized) {
         Log(4, "Cannot add visual: ZOrderManager not initialized");
-        return false;
+        return kInvalidHandle;
     }
 
     if (!visual) {
-        Log(4, "Cannot add visual '{}': Visual is null", name);
-        return false;
+        Log(4, "Cannot add visual: Visual is null");
+        return kInvalidHandle;
     }
 
     try {
-        // Check if visual with this name already exists
-        auto it = m_visuals.find(name);
-        if (it != m_visuals.end()) {
-            Log(3, "Visual '{}' already exists, replacing", name);
-            it->second.visual = visual;
-            it->second.layerType = layerType;
-            it->second.zOrder = zOrder;
-        } else {
-            // Add to our map
-            VisualInfo info;
-            info.visual = visual;
-            info.layerType = layerType;
-            info.zOrder = zOrder;
-            info.visible = true;
-
-            m_visuals[name] = info;
-        }
+        VisualHandle handle = Insert(visual, layerType, zOrder);
 
-        m_treeNeedsRebuild = true;
+        Log(1, "Added visual {} with layer type {} and Z-order {}", 
+            handle, static_cast<int>(layerType), zOrder);
 
-        Log(1, "Added visual '{}' with layer type {} and Z-order {}", 
-            name, static_cast<int>(layerType), zOrder);
-
-        return true;
+        return handle;
     }
     catch (const std::exception& e) {
         m_app.GetErrorHandler().ReportException(e, ErrorSeverity::Error, "ZOrderManager");
-        return false;
+        return kInvalidHandle;
     }
 }
 
-bool ZOrderManager::RemoveVisual(const std::string& name)
+bool ZOrderManager::RemoveVisual(VisualHandle handle)
 {
     if (!m_initialized) {
         return false;
     }
 
-    auto it = m_visuals.find(name);
-    if (it == m_visuals.end()) {
-        Log(3, "Cannot remove visual '{}': Not found", name);
+    const VisualInfo* info = Find(handle);
+    if (!info) {
+        Log(3, "Cannot remove visual {}: Not found", handle);
         return false;
     }
 
-    m_visuals.erase(it);
-    m_treeNeedsRebuild = true;
+    // Detaching from the root waits for the next commit
+    if (info->inTree) {
+        m_detached.push_back(info->visual);
+    }
+
+    // Erasing keeps the array sorted; only later entries shift
+    uint32_t index = m_handleIndex[handle];
+    m_visuals.erase(m_visuals.begin() + index);
+    m_handleIndex[handle] = kNoIndex;
+    for (uint32_t i = index; i < m_visuals.size(); ++i) {
+        m_handleIndex[m_visuals[i].handle] = i;
+    }
+    m_pendingChanges = true;
 
-    Log(1, "Removed visual '{}'", name);
+    Log(1, "Removed visual {}", handle);
     return true;
 }
 
-Microsoft::WRL::ComPtr<IDCompositionVisual> ZOrderManager::GetVisual(const std::string& name)
+Microsoft::WRL::ComPtr<IDCompositionVisual> ZOrderManager::GetVisual(VisualHandle handle) const
 {
     if (!m_initialized) {
         return nullptr;
     }
 
-    auto it = m_visuals.find(name);
-    if (it == m_visuals.end()) {
-        return nullptr;
-    }
-
-    return it->second.visual;
+    const VisualInfo* info = Find(handle);
+    return info ? info->visual : nullptr;
 }
 
-bool ZOrderManager::SetVisualVisibility(const std::string& name, bool visible)
+bool ZOrderManager::SetVisualVisibility(VisualHandle handle, bool visible)
 {
     if (!m_initialized) {
         return false;
     }
 
-    auto it = m_visuals.find(name);
-    if (it == m_visuals.end()) {
-        Log(3, "Cannot set visibility for visual '{}': Not found", name);
+    VisualInfo* info = Find(handle);
+    if (!info) {
+        Log(3, "Cannot set visibility for visual {}: Not found", handle);
         return false;
     }
 
-    if (it->second.visible != visible) {
-        it->second.visible = visible;
-        it->second.visual->SetOpacity(visible ? 1.0f : 0.0f);
-        m_treeNeedsRebuild = true;
-
-        Log(1, "Set visibility of visual '{}' to {}", name, visible ? "visible" : "hidden");
+    if (info->visible != visible) {
+        info->visible = visible;
+        info->dirty = true;
+        m_pendingChanges = true;
     }
 
     return true;
 }
 
 bool ZOrderManager::SetVisualZOrder(
-    const std::string& name,
+    VisualHandle handle,
     LayerType layerType,
     int zOrder)
 {
@@ -224,19 +199,19 @@ bool ZOrderManager::SetVisualZOrder(
         return false;
     }
 
-    auto it = m_visuals.find(name);
-    if (it == m_visuals.end()) {
-        Log(3, "Cannot set Z-order for visual '{}': Not found", name);
+    VisualInfo* info = Find(handle);
+    if (!info) {
+        Log(3, "Cannot set Z-order for visual {}: Not found", handle);
         return false;
     }
 
-    if (it->second.layerType != layerType || it->second.zOrder != zOrder) {
-        it->second.layerType = layerType;
-        it->second.zOrder = zOrder;
-        m_treeNeedsRebuild = true;
-
-        Log(1, "Set Z-order of visual '{}' to layer type {} and Z-order {}", 
-            name, static_cast<int>(layerType), zOrder);
+    if (info->layerType != layerType || info->zOrder != zOrder) {
+        info->layerType = layerType;
+        info->layerBase = GetLayerBaseZOrder(layerType);
+        info->zOrder = zOrder;
+        info->dirty = true;
+        m_orderDirty = true;
+        m_pendingChanges = true;
     }
 
     return true;
@@ -248,12 +223,13 @@ bool ZOrderManager::Commit()
         return false;
     }
 
+    if (!m_pendingChanges) {
+        return true;
+    }
+
     try {
-        // Rebuild the composition tree if needed
-        if (m_treeNeedsRebuild) {
-            RebuildTree();
-            m_treeNeedsRebuild = false;
-        }
+        PatchTree();
+        m_pendingChanges = false;
 
         // Commit changes
         HRESULT hr = m_dcompDevice->Commit();
@@ -270,50 +246,130 @@ bool ZOrderManager::Commit()
     }
 }
 
-void ZOrderManager::RebuildTree()
+ZOrderManager::VisualHandle ZOrderManager::Insert(
+    Microsoft::WRL::ComPtr<IDCompositionVisual> visual,
+    LayerType layerType,
+    int zOrder)
+{
+    VisualInfo info;
+    info.visual = visual;
+    info.handle = m_nextHandle++;
+    info.layerType = layerType;
+    info.layerBase = GetLayerBaseZOrder(layerType);
+    info.zOrder = zOrder;
+    info.visible = true;
+    info.inTree = false;
+    info.dirty = true;
+
+    // Appending on top is the common case and keeps the array sorted
+    if (!m_visuals.empty() && SortsBefore(info, m_visuals.back())) {
+        m_orderDirty = true;
+    }
+
+    m_handleIndex.resize(info.handle + 1, kNoIndex);
+    m_handleIndex[info.handle] = static_cast<uint32_t>(m_visuals.size());
+    m_visuals.push_back(std::move(info));
+    m_pendingChanges = true;
+
+    return m_visuals.back().handle;
+}
+
+ZOrderManager::VisualInfo* ZOrderManager::Find(VisualHandle handle)
+{
+    if (handle >= m_handleIndex.size() || m_handleIndex[handle] == kNoIndex) {
+        return nullptr;
+    }
+
+    return &m_visuals[m_handleIndex[handle]];
+}
+
+const ZOrderManager::VisualInfo* ZOrderManager::Find(VisualHandle handle) const
 {
-    if (!m_initialized || !m_rootVisual) {
+    if (handle >= m_handleIndex.size() || m_handleIndex[handle] == kNoIndex) {
+        return nullptr;
+    }
+
+    return &m_visuals[m_handleIndex[handle]];
+}
+
+bool ZOrderManager::SortsBefore(const VisualInfo& a, const VisualInfo& b)
+{
+    if (a.layerBase != b.layerBase) {
+        return a.layerBase < b.layerBase; // Sort by layer type first
+    }
+
+    if (a.zOrder != b.zOrder) {
+        return a.zOrder < b.zOrder; // Then by Z-order within layer
+    }
+
+    return a.handle < b.handle; // Then by creation, for a stable order
+}
+
+void ZOrderManager::SortVisuals()
+{
+    std::sort(m_visuals.begin(), m_visuals.end(), &ZOrderManager::SortsBefore);
+
+    for (uint32_t i = 0; i < m_visuals.size(); ++i) {
+        m_handleIndex[m_visuals[i].handle] = i;
+    }
+
+    m_orderDirty = false;
+}
+
+void ZOrderManager::PatchTree()
+{
+    if (!m_rootVisual) {
         return;
     }
 
-    try {
-        // Remove all visuals from the root
-        m_rootVisual->RemoveAllVisuals();
-
-        // Sort visuals by layer type and Z-order
-        std::vector<std::pair<std::string, VisualInfo*>> sortedVisuals;
-        for (auto& pair : m_visuals) {
-            if (pair.second.visible) {
-                sortedVisuals.push_back({ pair.first, &pair.second });
-            }
+    // Detach removed visuals
+    for (const auto& visual : m_detached) {
+        m_rootVisual->RemoveVisual(visual.Get());
+    }
+    size_t changed = m_detached.size();
+    m_detached.clear();
+
+    // Detach visuals that are hidden or about to move
+    for (auto& info : m_visuals) {
+        if (info.dirty && info.inTree) {
+            m_rootVisual->RemoveVisual(info.visual.Get());
+            info.inTree = false;
         }
+    }
+
+    if (m_orderDirty) {
+        SortVisuals();
+    }
 
-        std::sort(sortedVisuals.begin(), sortedVisuals.end(), 
-            [this](const auto& a, const auto& b) {
-                int aBase = GetLayerBaseZOrder(a.second->layerType);
-                int bBase = GetLayerBaseZOrder(b.second->layerType);
-                
-                if (aBase != bBase) {
-                    return aBase < bBase; // Sort by layer type first
+    // Walk bottom to top, inserting each changed visual right above the
+    // nearest attached visual below it; untouched visuals stay where they are
+    IDCompositionVisual* below = nullptr;
+    for (auto& info : m_visuals) {
+        if (info.dirty) {
+            info.dirty = false;
+            ++changed;
+
+            if (info.visible) {
+                HRESULT hr = below
+                    ? m_rootVisual->AddVisual(info.visual.Get(), TRUE, below)
+                    : m_rootVisual->AddVisual(info.visual.Get(), FALSE, nullptr);
+                if (SUCCEEDED(hr)) {
+                    info.inTree = true;
+                } else {
+                    Log(4, "Failed to attach visual {}: 0x{:X}", info.handle, hr);
                 }
-                
-                return a.second->zOrder < b.second->zOrder; // Then by Z-order within layer
             }
-        );
-
-        // Add visuals to the root in order (lower Z-order first)
-        for (const auto& pair : sortedVisuals) {
-            m_rootVisual->AddVisual(pair.second->visual.Get(), FALSE, nullptr);
         }
 
-        Log(1, "Rebuilt composition tree with {} visible visuals", sortedVisuals.size());
-    }
-    catch (const std::exception& e) {
-        m_app.GetErrorHandler().ReportException(e, ErrorSeverity::Error, "ZOrderManager");
+        if (info.inTree) {
+            below = info.visual.Get();
+        }
     }
+
+    Log(0, "Patched composition tree: {} of {} visuals changed", changed, m_visuals.size());
 }
 
-int ZOrderManager::GetLayerBaseZOrder(LayerType layerType) const
+int ZOrderManager::GetLayerBaseZOrder(LayerType layerType)
 {
     switch (layerType) {
         case LayerType::Background: return 0;
@@ -327,26 +383,4 @@ int ZOrderManager::GetLayerBaseZOrder(LayerType layerType) const
     }
 }
 
-template<typename... Args>
-void ZOrderManager::Log(int level, const std::string& fmt, const Args&... args)
-{
-    try {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level) {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e) {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "ZOrderManager log error: " << e.what() << std::endl;
-    }
-}
-
 } // namespace poe
\ No newline at end of file
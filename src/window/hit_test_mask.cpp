@@ -0,0 +1,200 @@
+/**
+ * @file hit_test_mask.cpp
+ * @brief Implementation of the HitTestMask class
+ */
+
+ #include "window/hit_test_mask.h"
+ #include <algorithm>
+ #include <cstring>
+
+ namespace poe {
+
+ bool HitTestMask::Update(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects) {
+     if (!buffer || width <= 0 || height <= 0) {
+         return false;
+     }
+
+     bool changed = false;
+     bool resized = width != m_width || height != m_height;
+     if (resized) {
+         m_width = width;
+         m_height = height;
+         m_columns = (width + kCellSize - 1) / kCellSize;
+         m_rows = (height + kCellSize - 1) / kCellSize;
+         m_cells.assign(static_cast<size_t>(m_columns) * m_rows, 0);
+         changed = true;
+     }
+
+     const uint8_t* pixels = static_cast<const uint8_t*>(buffer);
+     auto scan = [&](const RECT& rect) {
+         int firstColumn = (std::max)(0, static_cast<int>(rect.left)) / kCellSize;
+         int firstRow = (std::max)(0, static_cast<int>(rect.top)) / kCellSize;
+         int lastColumn = ((std::min)(width, static_cast<int>(rect.right)) + kCellSize - 1) / kCellSize;
+         int lastRow = ((std::min)(height, static_cast<int>(rect.bottom)) + kCellSize - 1) / kCellSize;
+
+         for (int row = firstRow; row < lastRow; ++row) {
+             for (int column = firstColumn; column < lastColumn; ++column) {
+                 changed = ScanCell(pixels, column, row) || changed;
+             }
+         }
+     };
+
+     if (resized) {
+         scan({ 0, 0, width, height });
+     } else {
+         for (const RECT& rect : dirtyRects) {
+             scan(rect);
+         }
+     }
+
+     return changed;
+ }
+
+ bool HitTestMask::Fill(int width, int height) {
+     if (width <= 0 || height <= 0) {
+         return false;
+     }
+
+     bool changed = width != m_width || height != m_height;
+     if (changed) {
+         m_width = width;
+         m_height = height;
+         m_columns = (width + kCellSize - 1) / kCellSize;
+         m_rows = (height + kCellSize - 1) / kCellSize;
+     } else {
+         changed = std::find(m_cells.begin(), m_cells.end(), 0) != m_cells.end();
+     }
+
+     m_cells.assign(static_cast<size_t>(m_columns) * m_rows, 1);
+     return changed;
+ }
+
+ bool HitTestMask::SetRects(const std::vector<RECT>& rects) {
+     bool same = rects.size() == m_rects.size() &&
+         std::equal(rects.begin(), rects.end(), m_rects.begin(),
+             [](const RECT& a, const RECT& b) { return EqualRect(&a, &b) != FALSE; });
+     if (same) {
+         return false;
+     }
+
+     m_rects = rects;
+     return true;
+ }
+
+ bool HitTestMask::Contains(int x, int y) const {
+     POINT point = { x, y };
+     for (const RECT& rect : m_rects) {
+         if (PtInRect(&rect, point)) {
+             return true;
+         }
+     }
+
+     if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+         return false;
+     }
+     return m_cells[static_cast<size_t>(y / kCellSize) * m_columns + x / kCellSize] != 0;
+ }
+
+ HRGN HitTestMask::CreateRegion(std::span<const RECT> extra) const {
+     std::vector<RECT> rects;
+     std::vector<RECT> runs;
+     size_t bandStart = 0;   // First rectangle of the band the previous row belongs to
+     size_t bandCount = 0;   // Runs in that band; 0 if the previous row was empty
+
+     for (int row = 0; row < m_rows; ++row) {
+         LONG top = row * kCellSize;
+         LONG bottom = (std::min)(top + kCellSize, static_cast<LONG>(m_height));
+         const uint8_t* cells = m_cells.data() + static_cast<size_t>(row) * m_columns;
+
+         // Runs of solid cells in this row
+         runs.clear();
+         for (int column = 0; column < m_columns;) {
+             if (!cells[column]) {
+                 ++column;
+                 continue;
+             }
+             int start = column;
+             while (column < m_columns && cells[column]) {
+                 ++column;
+             }
+             LONG right = (std::min)(static_cast<LONG>(column * kCellSize), static_cast<LONG>(m_width));
+             runs.push_back({ start * kCellSize, top, right, bottom });
+         }
+
+         // Same runs as the row above: grow that band instead of adding rectangles
+         bool sameAsBand = !runs.empty() && runs.size() == bandCount &&
+             std::equal(runs.begin(), runs.end(), rects.begin() + bandStart,
+                 [](const RECT& a, const RECT& b) { return a.left == b.left && a.right == b.right; });
+         if (sameAsBand) {
+             for (size_t i = 0; i < bandCount; ++i) {
+                 rects[bandStart + i].bottom = bottom;
+             }
+         } else {
+             bandStart = rects.size();
+             bandCount = runs.size();
+             rects.insert(rects.end(), runs.begin(), runs.end());
+         }
+     }
+
+     for (const RECT& rect : m_rects) {
+         if (!IsRectEmpty(&rect)) {
+             rects.push_back(rect);
+         }
+     }
+     for (const RECT& rect : extra) {
+         if (!IsRectEmpty(&rect)) {
+             rects.push_back(rect);
+         }
+     }
+
+     if (rects.empty()) {
+         return CreateRectRgn(0, 0, 0, 0);
+     }
+
+     // One ExtCreateRegion call instead of a CombineRgn per rectangle
+     RECT bounds = rects.front();
+     for (const RECT& rect : rects) {
+         UnionRect(&bounds, &bounds, &rect);
+     }
+
+     DWORD rectBytes = static_cast<DWORD>(rects.size() * sizeof(RECT));
+     std::vector<uint8_t> data(sizeof(RGNDATAHEADER) + rectBytes);
+     RGNDATAHEADER header = {};
+     header.dwSize = sizeof(RGNDATAHEADER);
+     header.iType = RDH_RECTANGLES;
+     header.nCount = static_cast<DWORD>(rects.size());
+     header.nRgnSize = rectBytes;
+     header.rcBound = bounds;
+     std::memcpy(data.data(), &header, sizeof(header));
+     std::memcpy(data.data() + sizeof(header), rects.data(), rectBytes);
+
+     return ExtCreateRegion(nullptr, static_cast<DWORD>(data.size()), reinterpret_cast<const RGNDATA*>(data.data()));
+ }
+
+ bool HitTestMask::ScanCell(const uint8_t* pixels, int column, int row) {
+     int left = column * kCellSize;
+     int top = row * kCellSize;
+     int right = (std::min)(left + kCellSize, m_width);
+     int bottom = (std::min)(top + kCellSize, m_height);
+
+     // Stop at the first visible pixel; most solid cells end on the first row
+     uint8_t solid = 0;
+     for (int y = top; y < bottom && !solid; ++y) {
+         const uint8_t* alpha = pixels + (static_cast<size_t>(y) * m_width + left) * 4 + 3;
+         for (int x = left; x < right; ++x, alpha += 4) {
+             if (*alpha) {
+                 solid = 1;
+                 break;
+             }
+         }
+     }
+
+     uint8_t& cell = m_cells[static_cast<size_t>(row) * m_columns + column];
+     if (cell == solid) {
+         return false;
+     }
+     cell = solid;
+     return true;
+ }
+
+ } // namespace poe
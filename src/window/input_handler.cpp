@@ -4,96 +4,147 @@
  */
 
  #include "window/input_handler.h"
+ #include <algorithm>
  #include <sstream>
  #include "core/Logger.h"
  #include "core/ErrorHandler.h"
- 
+ #include "core/FrameProfiler.h"
+ #include "core/Settings.h"
+ #include "core/TraceRing.h"
+
  namespace poe {
- 
+
+ namespace {
+
+ /// Window class of the input thread's message-only window
+ constexpr wchar_t kRawInputWindowClass[] = L"PoEOverlayRawInput";
+
+ /// Modifier flags that take part in matching
+ constexpr UINT kModifierMask = MOD_ALT | MOD_CONTROL | MOD_SHIFT | MOD_WIN;
+
+ /// Input handler owning the input thread this runs on
+ thread_local InputHandler* t_inputHandler = nullptr;
+
+ /**
+  * @brief Map a raw keyboard report onto a side-specific virtual key
+  *
+  * Raw Input reports VK_SHIFT, VK_CONTROL and VK_MENU for both sides; telling
+  * them apart keeps a modifier held while its twin on the other side is released.
+  */
+ UINT ToSidedKey(const RAWKEYBOARD& keyboard) {
+     bool extended = (keyboard.Flags & RI_KEY_E0) != 0;
+     switch (keyboard.VKey) {
+         case VK_SHIFT:   return keyboard.MakeCode == 0x36 ? VK_RSHIFT : VK_LSHIFT;
+         case VK_CONTROL: return extended ? VK_RCONTROL : VK_LCONTROL;
+         case VK_MENU:    return extended ? VK_RMENU : VK_LMENU;
+         default:         return keyboard.VKey;
+     }
+ }
+
+ /**
+  * @brief Get the MOD_* flag a side-specific key stands for, or 0
+  */
+ UINT ModifierForKey(UINT key) {
+     switch (key) {
+         case VK_LSHIFT:   case VK_RSHIFT:   return MOD_SHIFT;
+         case VK_LCONTROL: case VK_RCONTROL: return MOD_CONTROL;
+         case VK_LMENU:    case VK_RMENU:    return MOD_ALT;
+         case VK_LWIN:     case VK_RWIN:     return MOD_WIN;
+         default:                            return 0;
+     }
+ }
+
+ } // namespace
+
+ std::string HotkeyEvent::ToString() const {
+     return "HotkeyEvent(" + InputHandler::HotkeyToString(modifiers, virtualKey) +
+         ", ID: " + std::to_string(hotkeyId) + ")";
+ }
+
  InputHandler::InputHandler(Application& app, HWND hwnd)
-     : m_app(app), m_hwnd(hwnd), m_nextHotkeyId(1) {
+     : m_app(app), m_hwnd(hwnd), m_nextHotkeyId(1), m_inputThreadId(0), m_lowLatencyActive(false),
+       m_hotkeyLookup(std::make_shared<const HotkeyLookup>()), m_hotkeyEventSubscription(0) {
+
+     // Events from the input thread are dispatched wherever the event system is processed
+     m_hotkeyEventSubscription = m_app.GetEventSystem().Subscribe<HotkeyEvent>(
+         [this](const HotkeyEvent& event) { OnHotkeyEvent(event); });
+
      m_app.GetLogger().Info("InputHandler initialized");
+
+     if (m_app.GetSettings().Get<bool>("input.lowLatencyHotkeys", false)) {
+         EnableLowLatencyInput(true);
+     }
  }
- 
+
  InputHandler::~InputHandler() {
-     // Unregister all global hotkeys
-     for (const auto& pair : m_hotkeys) {
-         if (pair.second.hotkey.global) {
-             UnregisterHotKey(m_hwnd, pair.first);
-         }
+     // Stop the input thread first; its registration refers to this instance
+     if (m_inputThread) {
+         PostThreadMessageW(m_inputThreadId, WM_QUIT, 0, 0);
+         m_inputThread->join();
+         m_inputThread.reset();
      }
- }
- 
- InputHandler::InputHandler(InputHandler&& other) noexcept
-     : m_hwnd(other.m_hwnd),
-       m_nextHotkeyId(other.m_nextHotkeyId),
-       m_hotkeys(std::move(other.m_hotkeys)) {
-     
-     other.m_hwnd = nullptr;
-     other.m_nextHotkeyId = 1;
- }
- 
- InputHandler& InputHandler::operator=(InputHandler&& other) noexcept {
-     if (this != &other) {
-         // Clean up existing hotkeys
-         for (const auto& pair : m_hotkeys) {
-             if (pair.second.hotkey.global) {
-                 UnregisterHotKey(m_hwnd, pair.first);
-             }
+
+     m_app.GetEventSystem().Unsubscribe(m_hotkeyEventSubscription);
+
+     // Unregister all global hotkeys
+     for (const Hotkey& hotkey : m_hotkeys) {
+         if (hotkey.global) {
+             UnregisterHotKey(m_hwnd, hotkey.id);
          }
-         
-         m_hwnd = other.m_hwnd;
-         m_nextHotkeyId = other.m_nextHotkeyId;
-         m_hotkeys = std::move(other.m_hotkeys);
-         
-         other.m_hwnd = nullptr;
-         other.m_nextHotkeyId = 1;
      }
-     return *this;
  }
- 
+
  int InputHandler::RegisterHotkey(
      UINT modifiers,
      UINT virtualKey,
      const std::string& description,
      bool global,
      std::function<void()> callback) {
-     
+
      try {
          // Generate a new ID for the hotkey
          int id = GenerateHotkeyId();
-         
-         // Create the hotkey data
-         HotkeyData data;
-         data.hotkey.id = id;
-         data.hotkey.modifiers = modifiers;
-         data.hotkey.virtualKey = virtualKey;
-         data.hotkey.description = description;
-         data.hotkey.global = global;
-         data.callback = std::move(callback);
-         
-         // Register the hotkey with the system if it's global
-         if (global) {
+
+         // Create the hotkey; the display name is formatted here so logging and UI never have to
+         Hotkey hotkey;
+         hotkey.id = id;
+         hotkey.modifiers = modifiers;
+         hotkey.virtualKey = virtualKey;
+         hotkey.description = description;
+         hotkey.global = global;
+         hotkey.displayName = HotkeyToString(modifiers, virtualKey);
+
+         // Register the hotkey with the system if it's global; the input thread matches it otherwise
+         if (global && !m_inputThread) {
              if (!RegisterHotKey(m_hwnd, id, modifiers, virtualKey)) {
                  DWORD error = GetLastError();
-                 m_app.GetLogger().Error("Failed to register global hotkey: {} (Error code: {})", 
-                     HotkeyToString(modifiers, virtualKey), error);
-                 
+                 m_app.GetLogger().Error("Failed to register global hotkey: {} (Error code: {})",
+                     hotkey.displayName, error);
+
                  // Check for common errors
                  if (error == ERROR_HOTKEY_ALREADY_REGISTERED) {
                      m_app.GetLogger().Warning("Hotkey already registered by another application");
                  }
-                 
+
                  return -1;
              }
          }
-         
-         // Add the hotkey to our map
-         m_hotkeys[id] = std::move(data);
-         
-         m_app.GetLogger().Info("Registered hotkey: {} (ID: {}, Global: {})", 
-             HotkeyToString(modifiers, virtualKey), id, global ? "Yes" : "No");
-         
+
+         // Insert in ID order, keeping the callback at the same position
+         auto it = std::lower_bound(m_hotkeys.begin(), m_hotkeys.end(), id,
+             [](const Hotkey& entry, int value) { return entry.id < value; });
+         auto index = it - m_hotkeys.begin();
+         it = m_hotkeys.insert(it, std::move(hotkey));
+         m_callbacks.insert(m_callbacks.begin() + index,
+             std::make_shared<const std::function<void()>>(std::move(callback)));
+         RebuildIdIndex();
+         if (global) {
+             RebuildHotkeyLookup();
+         }
+
+         m_app.GetLogger().Info("Registered hotkey: {} (ID: {}, Global: {})",
+             it->displayName, id, global ? "Yes" : "No");
+
          return id;
      }
      catch (const std::exception& ex) {
@@ -101,107 +152,168 @@
          return -1;
      }
  }
- 
+
  bool InputHandler::UnregisterHotkey(int id) {
-     auto it = m_hotkeys.find(id);
-     if (it == m_hotkeys.end()) {
+     int index = FindIndex(id);
+     if (index < 0) {
          return false;
      }
-     
+
      // Unregister the hotkey with the system if it's global
-     if (it->second.hotkey.global) {
+     bool global = m_hotkeys[index].global;
+     if (global && !m_inputThread) {
          if (!UnregisterHotKey(m_hwnd, id)) {
              return false;
          }
      }
-     
-     // Remove the hotkey from our map
-     m_hotkeys.erase(it);
-     
+
+     // Remove the hotkey; a callback that is running right now keeps its own reference
+     m_hotkeys.erase(m_hotkeys.begin() + index);
+     m_callbacks.erase(m_callbacks.begin() + index);
+     RebuildIdIndex();
+     if (global) {
+         RebuildHotkeyLookup();
+     }
+
      return true;
  }
- 
+
+ bool InputHandler::EnableLowLatencyInput(bool enable) {
+     if (enable == (m_inputThread != nullptr)) {
+         return IsLowLatencyInputActive();
+     }
+
+     try {
+         if (enable) {
+             // Start the input thread and wait until it has tried to register for Raw Input
+             std::promise<DWORD> started;
+             std::future<DWORD> threadId = started.get_future();
+
+             m_inputThread = std::make_unique<std::thread>(&InputHandler::InputThread, this, std::ref(started));
+             m_inputThreadId = threadId.get();
+
+             if (!m_lowLatencyActive.load(std::memory_order_acquire)) {
+                 m_inputThread->join();
+                 m_inputThread.reset();
+                 m_inputThreadId = 0;
+                 m_app.GetLogger().Warning("Low-latency input unavailable, global hotkeys stay on RegisterHotKey");
+                 return false;
+             }
+
+             // The input thread matches global hotkeys now; keep them from firing twice
+             for (const Hotkey& hotkey : m_hotkeys) {
+                 if (hotkey.global) {
+                     UnregisterHotKey(m_hwnd, hotkey.id);
+                 }
+             }
+
+             m_app.GetLogger().Info("Low-latency input enabled");
+             return true;
+         }
+
+         PostThreadMessageW(m_inputThreadId, WM_QUIT, 0, 0);
+         m_inputThread->join();
+         m_inputThread.reset();
+         m_inputThreadId = 0;
+
+         // Back to the system registrations
+         for (const Hotkey& hotkey : m_hotkeys) {
+             if (hotkey.global && !RegisterHotKey(m_hwnd, hotkey.id, hotkey.modifiers, hotkey.virtualKey)) {
+                 m_app.GetLogger().Error("Failed to re-register global hotkey: {} (Error code: {})",
+                     hotkey.displayName, GetLastError());
+             }
+         }
+
+         m_app.GetLogger().Info("Low-latency input disabled");
+         return false;
+     }
+     catch (const std::exception& ex) {
+         m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "InputHandler");
+         return IsLowLatencyInputActive();
+     }
+ }
+
  bool InputHandler::HandleMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
      try {
          switch (uMsg) {
              case WM_HOTKEY: {
                  // Handle global hotkey
                  int id = static_cast<int>(wParam);
-                 auto it = m_hotkeys.find(id);
-                 if (it != m_hotkeys.end()) {
-                     m_app.GetLogger().Debug("Global hotkey triggered: {} (ID: {})", 
-                         HotkeyToString(it->second.hotkey.modifiers, it->second.hotkey.virtualKey), id);
-                     
+                 int index = FindIndex(id);
+                 if (index >= 0) {
+                     m_app.GetLogger().Debug("Global hotkey triggered: {} (ID: {})",
+                         m_hotkeys[index].displayName, id);
+
                      // Call the associated callback
-                     if (it->second.callback) {
-                         it->second.callback();
+                     auto callback = m_callbacks[index];
+                     if (*callback) {
+                         (*callback)();
                      }
                      return true;
                  }
                  break;
              }
-             
-         case WM_KEYDOWN:
-         case WM_SYSKEYDOWN: {
-             // Handle non-global hotkeys
-             UINT virtualKey = static_cast<UINT>(wParam);
-             
-             // Check for modifier keys
-             UINT modifiers = 0;
-             if (IsKeyPressed(VK_CONTROL)) modifiers |= MOD_CONTROL;
-             if (IsKeyPressed(VK_SHIFT)) modifiers |= MOD_SHIFT;
-             if (IsKeyPressed(VK_MENU)) modifiers |= MOD_ALT;
-             if (IsKeyPressed(VK_LWIN) || IsKeyPressed(VK_RWIN)) modifiers |= MOD_WIN;
-             
-             // Check if any of our non-global hotkeys match
-             for (const auto& pair : m_hotkeys) {
-                 const HotkeyData& data = pair.second;
-                 if (!data.hotkey.global &&
-                     data.hotkey.virtualKey == virtualKey &&
-                     data.hotkey.modifiers == modifiers) {
-                     
-                     // Call the associated callback
-                     if (data.callback) {
-                         data.callback();
+
+             case WM_KEYDOWN:
+             case WM_SYSKEYDOWN: {
+                 // Handle non-global hotkeys
+                 UINT virtualKey = static_cast<UINT>(wParam);
+
+                 // Check for modifier keys
+                 UINT modifiers = 0;
+                 if (IsKeyPressed(VK_CONTROL)) modifiers |= MOD_CONTROL;
+                 if (IsKeyPressed(VK_SHIFT)) modifiers |= MOD_SHIFT;
+                 if (IsKeyPressed(VK_MENU)) modifiers |= MOD_ALT;
+                 if (IsKeyPressed(VK_LWIN) || IsKeyPressed(VK_RWIN)) modifiers |= MOD_WIN;
+
+                 // Check if any of our non-global hotkeys match
+                 for (size_t i = 0; i < m_hotkeys.size(); ++i) {
+                     const Hotkey& hotkey = m_hotkeys[i];
+                     if (!hotkey.global &&
+                         hotkey.virtualKey == virtualKey &&
+                         hotkey.modifiers == modifiers) {
+
+                         // Call the associated callback
+                         auto callback = m_callbacks[i];
+                         if (*callback) {
+                             (*callback)();
+                         }
+                         return true;
                      }
-                     return true;
                  }
+                 break;
              }
-             break;
          }
      }
-     
+     catch (const std::exception& ex) {
+         m_app.GetErrorHandler().ReportException(ex, ErrorSeverity::Error, "InputHandler");
+     }
+
      return false;
  }
- 
- std::vector<InputHandler::Hotkey> InputHandler::GetHotkeys() const {
-     std::vector<Hotkey> hotkeys;
-     hotkeys.reserve(m_hotkeys.size());
-     
-     for (const auto& pair : m_hotkeys) {
-         hotkeys.push_back(pair.second.hotkey);
-     }
-     
-     return hotkeys;
+
+ const InputHandler::Hotkey* InputHandler::FindHotkey(int id) const {
+     int index = FindIndex(id);
+     return index >= 0 ? &m_hotkeys[index] : nullptr;
  }
- 
+
  bool InputHandler::IsKeyPressed(UINT virtualKey) {
      return (GetAsyncKeyState(virtualKey) & 0x8000) != 0;
  }
- 
+
  std::string InputHandler::HotkeyToString(UINT modifiers, UINT virtualKey) {
      std::stringstream ss;
-     
+
      // Add modifiers
      if (modifiers & MOD_CONTROL) ss << "Ctrl+";
      if (modifiers & MOD_SHIFT) ss << "Shift+";
      if (modifiers & MOD_ALT) ss << "Alt+";
      if (modifiers & MOD_WIN) ss << "Win+";
-     
+
      // Add the virtual key name
      char keyName[256] = {0};
      UINT scanCode = MapVirtualKeyW(virtualKey, MAPVK_VK_TO_VSC);
-     
+
      // Handle special keys
      switch (virtualKey) {
          case VK_LEFT: case VK_RIGHT: case VK_UP: case VK_DOWN:
@@ -212,20 +324,192 @@
              scanCode |= 0x100;  // Set extended bit
              break;
      }
-     
+
      GetKeyNameTextA(scanCode << 16, keyName, sizeof(keyName));
      ss << keyName;
-     
+
      return ss.str();
  }
- 
+
  int InputHandler::GenerateHotkeyId() const {
-     // Find the next available ID
+     // Reuse the lowest free ID, which keeps m_indexById as small as the number of hotkeys
      int id = m_nextHotkeyId;
-     while (m_hotkeys.find(id) != m_hotkeys.end()) {
+     while (FindIndex(id) >= 0) {
          id++;
      }
      return id;
  }
- 
- } // namespace poe
\ No newline at end of file
+
+ int InputHandler::FindIndex(int id) const {
+     if (id < 0 || static_cast<size_t>(id) >= m_indexById.size()) {
+         return -1;
+     }
+     return static_cast<int>(m_indexById[id]) - 1;
+ }
+
+ void InputHandler::RebuildIdIndex() {
+     // m_hotkeys is sorted by ID, so the last entry has the largest one
+     m_indexById.assign(m_hotkeys.empty() ? 0 : static_cast<size_t>(m_hotkeys.back().id) + 1, 0);
+     for (size_t i = 0; i < m_hotkeys.size(); ++i) {
+         m_indexById[m_hotkeys[i].id] = static_cast<uint32_t>(i + 1);
+     }
+ }
+
+ uint32_t InputHandler::MakeLookupKey(UINT modifiers, UINT virtualKey) {
+     return ((modifiers & kModifierMask) << 16) | (virtualKey & 0xFFFF);
+ }
+
+ void InputHandler::RebuildHotkeyLookup() {
+     auto lookup = std::make_shared<HotkeyLookup>();
+     for (const Hotkey& hotkey : m_hotkeys) {
+         if (hotkey.global) {
+             lookup->push_back({ MakeLookupKey(hotkey.modifiers, hotkey.virtualKey), hotkey.id });
+         }
+     }
+
+     std::sort(lookup->begin(), lookup->end(),
+         [](const HotkeyLookupEntry& a, const HotkeyLookupEntry& b) { return a.key < b.key; });
+
+     m_hotkeyLookup.store(std::move(lookup), std::memory_order_release);
+ }
+
+ void InputHandler::InputThread(std::promise<DWORD>& started) {
+     t_inputHandler = this;
+
+     // Key presses are handled in microseconds; running ahead of the render and CEF threads is cheap
+     SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+
+     // Create the message queue before anyone can post to it
+     MSG msg;
+     PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+
+     HINSTANCE instance = GetModuleHandleW(nullptr);
+     WNDCLASSEXW windowClass = {};
+     windowClass.cbSize = sizeof(windowClass);
+     windowClass.lpfnWndProc = &InputHandler::RawInputWindowProc;
+     windowClass.hInstance = instance;
+     windowClass.lpszClassName = kRawInputWindowClass;
+     RegisterClassExW(&windowClass);  // Fails harmlessly if the class exists from an earlier run
+
+     HWND window = CreateWindowExW(0, kRawInputWindowClass, L"", 0, 0, 0, 0, 0,
+         HWND_MESSAGE, nullptr, instance, nullptr);
+
+     // INPUTSINK delivers keyboard input while the game, not the overlay, has focus
+     RAWINPUTDEVICE device = {};
+     device.usUsagePage = 0x01;  // Generic desktop
+     device.usUsage = 0x06;      // Keyboard
+     device.dwFlags = RIDEV_INPUTSINK;
+     device.hwndTarget = window;
+
+     bool registered = window && RegisterRawInputDevices(&device, 1, sizeof(device));
+     if (!registered) {
+         m_app.GetLogger().Error("Failed to register for raw keyboard input (Error code: {})", GetLastError());
+     }
+     else {
+         // Modifiers already held will not be reported again until released
+         m_keysDown.reset();
+         for (UINT key : { VK_LSHIFT, VK_RSHIFT, VK_LCONTROL, VK_RCONTROL, VK_LMENU, VK_RMENU, VK_LWIN, VK_RWIN }) {
+             m_keysDown[key] = IsKeyPressed(key);
+         }
+     }
+
+     // Report back only now, so IsLowLatencyInputActive() is settled when EnableLowLatencyInput returns
+     m_lowLatencyActive.store(registered, std::memory_order_release);
+     started.set_value(GetCurrentThreadId());
+
+     // Pump until WM_QUIT; WM_INPUT is dispatched to the window procedure from here
+     if (registered) {
+         while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+             DispatchMessageW(&msg);
+         }
+
+         device.dwFlags = RIDEV_REMOVE;
+         device.hwndTarget = nullptr;
+         RegisterRawInputDevices(&device, 1, sizeof(device));
+     }
+
+     m_lowLatencyActive.store(false, std::memory_order_release);
+     if (window) {
+         DestroyWindow(window);
+     }
+
+     t_inputHandler = nullptr;
+ }
+
+ LRESULT CALLBACK InputHandler::RawInputWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
+     if (uMsg == WM_INPUT && t_inputHandler) {
+         // Stamp first, so the measured latency covers everything after the message arrived
+         auto receivedAt = std::chrono::steady_clock::now();
+
+         RAWINPUT input;
+         UINT size = sizeof(input);
+         if (GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam), RID_INPUT, &input, &size,
+                             sizeof(RAWINPUTHEADER)) != static_cast<UINT>(-1) &&
+             input.header.dwType == RIM_TYPEKEYBOARD) {
+             t_inputHandler->OnRawKeyboard(input.data.keyboard, receivedAt);
+         }
+     }
+
+     // WM_INPUT must reach DefWindowProc so the system can release the input data
+     return DefWindowProcW(hwnd, uMsg, wParam, lParam);
+ }
+
+ void InputHandler::OnRawKeyboard(const RAWKEYBOARD& keyboard, std::chrono::steady_clock::time_point receivedAt) {
+     // 0xFF marks the fake keys of escaped sequences
+     if (keyboard.VKey == 0 || keyboard.VKey >= 0xFF) {
+         return;
+     }
+
+     UINT key = ToSidedKey(keyboard);
+     bool down = (keyboard.Flags & RI_KEY_BREAK) == 0;
+     bool wasDown = m_keysDown[key];
+     m_keysDown[key] = down;
+
+     // Only the first press counts: releases and auto-repeat never fire a hotkey, nor do modifiers alone
+     if (!down || wasDown || ModifierForKey(key) != 0) {
+         return;
+     }
+
+     UINT modifiers = 0;
+     if (m_keysDown[VK_LSHIFT] || m_keysDown[VK_RSHIFT]) modifiers |= MOD_SHIFT;
+     if (m_keysDown[VK_LCONTROL] || m_keysDown[VK_RCONTROL]) modifiers |= MOD_CONTROL;
+     if (m_keysDown[VK_LMENU] || m_keysDown[VK_RMENU]) modifiers |= MOD_ALT;
+     if (m_keysDown[VK_LWIN] || m_keysDown[VK_RWIN]) modifiers |= MOD_WIN;
+
+     uint32_t lookupKey = MakeLookupKey(modifiers, key);
+     auto lookup = m_hotkeyLookup.load(std::memory_order_acquire);
+     auto it = std::lower_bound(lookup->begin(), lookup->end(), lookupKey,
+         [](const HotkeyLookupEntry& entry, uint32_t value) { return entry.key < value; });
+     if (it == lookup->end() || it->key != lookupKey) {
+         return;
+     }
+
+     m_app.GetTraceRing().Emit(TraceEvent::HotkeyPressed, it->id, static_cast<int64_t>(key), static_cast<int64_t>(modifiers));
+     m_app.GetEventSystem().Publish(HotkeyEvent(m_hwnd, it->id, modifiers, key, receivedAt));
+ }
+
+ void InputHandler::OnHotkeyEvent(const HotkeyEvent& event) {
+     if (event.window != m_hwnd) {
+         return;
+     }
+
+     // The hotkey may have been unregistered while the event was queued
+     int index = FindIndex(event.hotkeyId);
+     if (index < 0) {
+         return;
+     }
+
+     auto latency = std::chrono::steady_clock::now() - event.pressedAt;
+     m_app.GetFrameProfiler().Record(PerfStage::HotkeyLatency, static_cast<uint64_t>(
+         std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+
+     m_app.GetLogger().Debug("Low-latency hotkey triggered: {} (ID: {})",
+         m_hotkeys[index].displayName, event.hotkeyId);
+
+     auto callback = m_callbacks[index];
+     if (*callback) {
+         (*callback)();
+     }
+ }
+
+ } // namespace poe
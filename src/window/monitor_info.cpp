@@ -5,11 +5,49 @@
 
  #include "window/monitor_info.h"
  #include <ShellScalingApi.h>
+ #include <algorithm>
+ #include <atomic>
+ #include <mutex>
  
  #pragma comment(lib, "Shcore.lib")
  
  namespace poe {
  
+ namespace {
+ 
+ // Cached topology shared by every caller; refreshed on display changes
+ std::mutex g_topologyMutex;
+ std::vector<MonitorInfo> g_monitors;
+ bool g_topologyValid = false;
+ std::atomic<uint32_t> g_topologyRevision{0};
+ 
+ std::vector<MonitorInfo> EnumerateMonitors() {
+     std::vector<MonitorInfo> monitors;
+     
+     // Enumerate all monitors
+     EnumDisplayMonitors(
+         nullptr, nullptr,
+         [](HMONITOR hMonitor, HDC, LPRECT, LPARAM lParam) -> BOOL {
+             auto* monitors = reinterpret_cast<std::vector<MonitorInfo>*>(lParam);
+             monitors->emplace_back(hMonitor);
+             return TRUE;
+         },
+         reinterpret_cast<LPARAM>(&monitors)
+     );
+     
+     return monitors;
+ }
+ 
+ // Caller holds g_topologyMutex
+ void EnsureTopology() {
+     if (!g_topologyValid) {
+         g_monitors = EnumerateMonitors();
+         g_topologyValid = true;
+     }
+ }
+ 
+ } // namespace
+ 
  MonitorInfo::MonitorInfo(HMONITOR monitor) : m_monitor(monitor) {
      MONITORINFOEXW monitorInfo = {};
      monitorInfo.cbSize = sizeof(MONITORINFOEXW);
@@ -45,21 +83,46 @@
      return m_scaleFactor;
  }
  
+ HMONITOR MonitorInfo::GetHandle() const {
+     return m_monitor;
+ }
+ 
  std::vector<MonitorInfo> GetAllMonitors() {
-     std::vector<MonitorInfo> monitors;
+     std::lock_guard<std::mutex> lock(g_topologyMutex);
+     EnsureTopology();
+     return g_monitors;
+ }
+ 
+ uint32_t RefreshMonitorTopology() {
+     // Enumerate outside the lock; it calls into the window manager
+     std::vector<MonitorInfo> monitors = EnumerateMonitors();
      
-     // Enumerate all monitors
-     EnumDisplayMonitors(
-         nullptr, nullptr,
-         [](HMONITOR hMonitor, HDC, LPRECT, LPARAM lParam) -> BOOL {
-             auto* monitors = reinterpret_cast<std::vector<MonitorInfo>*>(lParam);
-             monitors->emplace_back(hMonitor);
-             return TRUE;
-         },
-         reinterpret_cast<LPARAM>(&monitors)
-     );
+     std::lock_guard<std::mutex> lock(g_topologyMutex);
+     g_monitors = std::move(monitors);
+     g_topologyValid = true;
+     return ++g_topologyRevision;
+ }
+ 
+ uint32_t GetMonitorTopologyRevision() {
+     return g_topologyRevision.load();
+ }
+ 
+ MonitorInfo GetMonitorForWindow(HWND window) {
+     HMONITOR monitor = MonitorFromWindow(window, MONITOR_DEFAULTTONEAREST);
      
-     return monitors;
+     {
+         std::lock_guard<std::mutex> lock(g_topologyMutex);
+         EnsureTopology();
+         
+         auto it = std::find_if(g_monitors.begin(), g_monitors.end(),
+             [monitor](const MonitorInfo& info) { return info.GetHandle() == monitor; });
+         if (it != g_monitors.end()) {
+             return *it;
+         }
+     }
+     
+     // A monitor the cache has not seen yet; the display change is still in flight
+     return MonitorInfo(monitor);
  }
  
  } // namespace poe
\ No newline at end of file
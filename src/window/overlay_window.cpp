@@ -1,5 +1,6 @@
 #include "window/overlay_window.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <windowsx.h>
@@ -7,7 +8,10 @@
 #include <dwmapi.h>
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
+#include "core/WorkerPool.h"
+#include "rendering/graphics_device.h"
 #include "rendering/overlay_renderer.h"
+#include "rendering/composite_renderer.h"
 #include "rendering/animation_manager.h"
 
 #pragma comment(lib, "dwmapi.lib")
@@ -21,9 +25,18 @@ static constexpr wchar_t WINDOW_CLASS_NAME[] = L"PoEOverlayWindowClass";
 // Custom window messages
 enum {
     WM_UPDATE_BORDER = WM_USER + 100,
-    WM_CHECK_MOUSE_POSITION
+    WM_CHECK_MOUSE_POSITION,
+    WM_REQUEST_FRAME
 };
 
+// Mouse position polling timer, only armed while the overlay is visible
+
+// Frame interval used while active when DWM composition is unavailable
+static constexpr DWORD FALLBACK_FRAME_INTERVAL_MS = 16;
+
+// Width of the edge strip that always captures the mouse and drags the window
+static constexpr int EDGE_HANDLE_WIDTH = 10;
+
 // Register the window class for the application
 static bool RegisterWindowClass(HINSTANCE hInstance) {
     WNDCLASSEXW wcex = {};
@@ -64,6 +77,7 @@ OverlayWindow::~OverlayWindow() {
     // Clean up renderer and animation manager first
     m_renderer.reset();
     m_animationManager.reset();
+    m_graphicsDevice.reset();
     
     if (m_windowHandle) {
         DestroyWindow(m_windowHandle);
@@ -81,12 +95,25 @@ OverlayWindow::OverlayWindow(OverlayWindow&& other) noexcept
       m_opacity(other.m_opacity),
       m_bounds(other.m_bounds),
       m_eventCallback(std::move(other.m_eventCallback)),
+      m_monitor(other.m_monitor),
+      m_scaleFactor(other.m_scaleFactor),
+      m_scaleFactorCallback(std::move(other.m_scaleFactorCallback)),
       m_mouseTracking(other.m_mouseTracking),
+      m_ncMouseTracking(other.m_ncMouseTracking),
       m_mouseNearEdge(other.m_mouseNearEdge),
       m_lastMousePos(other.m_lastMousePos),
+      m_clientRect(other.m_clientRect),
+      m_graphicsDevice(std::move(other.m_graphicsDevice)),
       m_renderer(std::move(other.m_renderer)),
       m_animationManager(std::move(other.m_animationManager)),
-      m_compositionEnabled(other.m_compositionEnabled) {
+      m_animationDeviceGeneration(other.m_animationDeviceGeneration),
+      m_opacityAnimation(other.m_opacityAnimation),
+      m_borderAnimation(other.m_borderAnimation),
+      m_hideWhenFaded(other.m_hideWhenFaded),
+      m_compositionEnabled(other.m_compositionEnabled),
+      m_framePending(other.m_framePending.load()),
+      m_hitTestMask(std::move(other.m_hitTestMask)),
+      m_hitRegionDirty(other.m_hitRegionDirty) {
     
     other.m_windowHandle = nullptr;
 }
@@ -105,12 +132,25 @@ OverlayWindow& OverlayWindow::operator=(OverlayWindow&& other) noexcept {
         m_opacity = other.m_opacity;
         m_bounds = other.m_bounds;
         m_eventCallback = std::move(other.m_eventCallback);
+        m_monitor = other.m_monitor;
+        m_scaleFactor = other.m_scaleFactor;
+        m_scaleFactorCallback = std::move(other.m_scaleFactorCallback);
         m_mouseTracking = other.m_mouseTracking;
+        m_ncMouseTracking = other.m_ncMouseTracking;
         m_mouseNearEdge = other.m_mouseNearEdge;
         m_lastMousePos = other.m_lastMousePos;
+        m_clientRect = other.m_clientRect;
+        m_graphicsDevice = std::move(other.m_graphicsDevice);
         m_renderer = std::move(other.m_renderer);
         m_animationManager = std::move(other.m_animationManager);
+        m_animationDeviceGeneration = other.m_animationDeviceGeneration;
+        m_opacityAnimation = other.m_opacityAnimation;
+        m_borderAnimation = other.m_borderAnimation;
+        m_hideWhenFaded = other.m_hideWhenFaded;
         m_compositionEnabled = other.m_compositionEnabled;
+        m_framePending = other.m_framePending.load();
+        m_hitTestMask = std::move(other.m_hitTestMask);
+        m_hitRegionDirty = other.m_hitRegionDirty;
         
         other.m_windowHandle = nullptr;
     }
@@ -125,6 +165,14 @@ bool OverlayWindow::Create() {
     try {
         Log(2, "Creating overlay window with title '{}'", std::string(m_config.title.begin(), m_config.title.end()));
         
+        // Device creation needs no window; overlap it with CreateWindowExW. The renderer
+        // stays out of m_renderer until joined so window messages never reach it early.
+        m_graphicsDevice = std::make_unique<GraphicsDevice>(m_app);
+        auto renderer = std::make_unique<CompositeRenderer>(m_app, *this, *m_graphicsDevice);
+        auto devicesCreated = m_app.GetWorkerPool().Submit([device = m_graphicsDevice.get()]() {
+            return device->Create();
+        });
+        
         // Create the window
         m_windowHandle = CreateWindowExW(
             WS_EX_LAYERED | WS_EX_TOPMOST | WS_EX_NOACTIVATE,
@@ -139,6 +187,10 @@ bool OverlayWindow::Create() {
             this                        // Pass 'this' pointer as user data
         );
 
+        if (!devicesCreated.get()) {
+            Log(3, "Early device creation failed, retrying during renderer initialization");
+        }
+
         if (!m_windowHandle) {
             DWORD error = GetLastError();
             m_app.GetErrorHandler().ReportError(
@@ -150,8 +202,11 @@ bool OverlayWindow::Create() {
             return false;
         }
 
+        // Pick up the DPI of the monitor we were created on
+        UpdateMonitor();
+
         // Create renderer
-        m_renderer = std::make_unique<OverlayRenderer>(m_app, *this);
+        m_renderer = std::move(renderer);
         if (!m_renderer->Initialize()) {
             m_app.GetErrorHandler().ReportError(
                 ErrorSeverity::Error,
@@ -163,7 +218,7 @@ bool OverlayWindow::Create() {
 
         // Create animation manager
         m_animationManager = std::make_unique<AnimationManager>(m_app);
-        if (!m_animationManager->Initialize()) {
+        if (!m_animationManager->Initialize(m_renderer->GetCompositionDevice())) {
             m_app.GetErrorHandler().ReportError(
                 ErrorSeverity::Error,
                 "Failed to initialize animation manager",
@@ -173,7 +228,9 @@ bool OverlayWindow::Create() {
         }
 
         // Setup animations
+        m_renderer->SetAnimationManager(m_animationManager.get());
         SetupAnimations();
+        m_animationDeviceGeneration = m_renderer->GetDeviceGeneration();
 
         // Initialize DirectComposition for better rendering
         if (!InitializeComposition()) {
@@ -189,16 +246,8 @@ bool OverlayWindow::Create() {
         // Set initial visibility
         SetVisible(m_config.showOnStartup);
 
-        // Setup mouse tracking
-        TRACKMOUSEEVENT tme = {};
-        tme.cbSize = sizeof(TRACKMOUSEEVENT);
-        tme.dwFlags = TME_LEAVE | TME_HOVER;
-        tme.hwndTrack = m_windowHandle;
-        tme.dwHoverTime = HOVER_DEFAULT;
-        m_mouseTracking = TrackMouseEvent(&tme) != FALSE;
-
-        // Set a timer to periodically check mouse position for border highlighting
-        SetTimer(m_windowHandle, 1, 100, nullptr);
+        // Mouse tracking is armed by the first WM_MOUSEMOVE / WM_NCMOUSEMOVE
+        GetClientRect(m_windowHandle, &m_clientRect);
 
         return true;
     }
@@ -213,65 +262,149 @@ void OverlayWindow::SetupAnimations() {
         return;
     }
 
-    // Create opacity animation
-    m_animationManager->CreateFloatAnimation(
-        "opacity",
-        300, // 300ms duration
-        m_opacity,
-        m_opacity,
-        [this](float value) {
-            m_opacity = value;
+    // Each fade is created once here; AnimateOpacity() and AnimateBorders()
+    // only retarget it, so hover and show/hide never allocate
+    if (m_renderer && m_animationManager->SupportsCompositionAnimations()) {
+        CompositionTarget contentTarget;
+        contentTarget.effect = m_renderer->GetContentEffect();
+        m_opacityAnimation = m_animationManager->CreateCompositionAnimation(
+            300, // 300ms duration
+            m_opacity,
+            m_opacity,
+            CompositionProperty::Opacity,
+            contentTarget
+        );
+
+        CompositionTarget borderTarget;
+        borderTarget.effect = m_renderer->GetBorderEffect();
+        m_borderAnimation = m_animationManager->CreateCompositionAnimation(
+            200, // 200ms duration
+            0.0f,
+            0.0f,
+            CompositionProperty::Opacity,
+            borderTarget
+        );
+    }
+
+    if (m_opacityAnimation != AnimationManager::kInvalidHandle) {
+        // DWM runs the curve; we only hear back once it has finished
+        m_animationManager->SetCompletionCallback(m_opacityAnimation, [this]() {
+            float target = m_animationManager->GetEndValue(m_opacityAnimation);
+            m_opacity = target;
+
+            // Settle on a static value so the compositor can drop the curve
             if (m_renderer) {
-                m_renderer->SetOpacity(value, false);
-            } else {
-                // Fallback to basic layered window opacity
-                SetLayeredWindowAttributes(m_windowHandle, 0, static_cast<BYTE>(value * 255), LWA_ALPHA);
+                m_renderer->SetOpacity(target);
             }
-        }
-    );
-
-    // Create border animation
-    m_animationManager->CreateFloatAnimation(
-        "border",
-        200, // 200ms duration
-        0.0f,
-        1.0f,
-        [this](float value) {
+
+            // Hide window completely when opacity reaches 0
+            if (m_hideWhenFaded && target < 0.01f && m_visible) {
+                ShowWindow(m_windowHandle, SW_HIDE);
+                m_visible = false;
+            }
+        });
+    } else {
+        // CPU fallback, stepped by Update()
+        m_opacityAnimation = m_animationManager->CreateFloatAnimation(
+            300, // 300ms duration
+            m_opacity,
+            m_opacity,
+            [this](float value) {
+                m_opacity = value;
+                if (m_renderer) {
+                    m_renderer->SetOpacity(value);
+                } else {
+                    // Fallback to basic layered window opacity
+                    SetLayeredWindowAttributes(m_windowHandle, 0, static_cast<BYTE>(value * 255), LWA_ALPHA);
+                }
+
+                // Hide window completely when opacity reaches 0
+                if (m_hideWhenFaded && value < 0.01f && m_visible) {
+                    ShowWindow(m_windowHandle, SW_HIDE);
+                    m_visible = false;
+                }
+            }
+        );
+    }
+
+    if (m_borderAnimation != AnimationManager::kInvalidHandle) {
+        // Every hover change restarts the fade, so the latest state is the one that lands
+        m_animationManager->SetCompletionCallback(m_borderAnimation, [this]() {
             if (m_renderer) {
-                m_renderer->ShowBorders(value > 0.01f);
+                m_renderer->ShowBorder(m_mouseNearEdge);
             }
-        }
-    );
+        });
+    } else {
+        // CPU fallback, stepped by Update()
+        m_borderAnimation = m_animationManager->CreateFloatAnimation(
+            200, // 200ms duration
+            0.0f,
+            0.0f,
+            [this](float value) {
+                if (m_renderer) {
+                    m_renderer->ShowBorder(value > 0.01f);
+                }
+            }
+        );
+    }
+}
+
+void OverlayWindow::SyncAnimationsWithDevice() {
+    uint64_t generation = m_renderer ? m_renderer->GetDeviceGeneration() : 0;
+    if (!m_animationManager || generation == m_animationDeviceGeneration) {
+        return;
+    }
+
+    // The fades are bound to effect groups of the old tree and keep its
+    // device alive; drop them now and set them up again once rebuilt
+    m_animationManager->Shutdown();
+    m_opacityAnimation = AnimationManager::kInvalidHandle;
+    m_borderAnimation = AnimationManager::kInvalidHandle;
+    m_animationDeviceGeneration = generation;
+    if (generation == 0) {
+        return;
+    }
+
+    m_animationManager->Initialize(m_renderer->GetCompositionDevice());
+    SetupAnimations();
+
+    // A fade cut short by the loss settles where the window last was
+    m_renderer->SetOpacity(m_opacity);
+    Log(2, "Animations rebound to device generation {}", generation);
+}
+
+void OverlayWindow::AnimateOpacity(float target, bool hideWhenDone) {
+    m_hideWhenFaded = hideWhenDone;
+
+    // Retarget from wherever a running fade has got to; otherwise start from
+    // m_opacity, which SetOpacity()/SetVisible() may have set directly
+    if (m_animationManager->IsRunning(m_opacityAnimation)) {
+        m_animationManager->RetargetAnimation(m_opacityAnimation, target);
+    } else {
+        m_animationManager->StartAnimation(m_opacityAnimation, m_opacity, target);
+    }
+}
+
+void OverlayWindow::AnimateBorders(bool show) {
+    if (!m_renderer) {
+        return;
+    }
+
+    if (!m_animationManager || m_borderAnimation == AnimationManager::kInvalidHandle) {
+        m_renderer->ShowBorder(show);
+        return;
+    }
+
+    // Same animation every time; it picks up from whatever the border shows now
+    float visibleValue = m_animationManager->IsCompositionDriven(m_borderAnimation) ? OverlayRenderer::kBorderOpacity : 1.0f;
+    m_animationManager->RetargetAnimation(m_borderAnimation, show ? visibleValue : 0.0f);
 }
 
 void OverlayWindow::SetVisible(bool visible, bool animate) {
     if (m_windowHandle && m_visible != visible) {
         if (animate && m_animationManager) {
             // Create or update the opacity animation
-            auto opacityAnim = m_animationManager->CreateFloatAnimation(
-                "opacity",
-                300, // 300ms duration
-                m_opacity,
-                visible ? m_config.opacity : 0.0f,
-                [this](float value) {
-                    m_opacity = value;
-                    if (m_renderer) {
-                        m_renderer->SetOpacity(value, false);
-                    } else {
-                        // Fallback to basic layered window opacity
-                        SetLayeredWindowAttributes(m_windowHandle, 0, static_cast<BYTE>(value * 255), LWA_ALPHA);
-                    }
-                    
-                    // Hide window completely when opacity reaches 0
-                    if (value < 0.01f && m_visible) {
-                        ShowWindow(m_windowHandle, SW_HIDE);
-                        m_visible = false;
-                    }
-                }
-            );
-            
-            // Start the animation
-            m_animationManager->StartAnimation("opacity");
+            AnimateOpacity(visible ? m_config.opacity : 0.0f, !visible);
             
             // If showing, make the window visible immediately
             if (visible && !m_visible) {
@@ -286,12 +419,14 @@ void OverlayWindow::SetVisible(bool visible, bool animate) {
             // Set opacity directly
             m_opacity = visible ? m_config.opacity : 0.0f;
             if (m_renderer) {
-                m_renderer->SetOpacity(m_opacity, false);
+                m_renderer->SetOpacity(m_opacity);
             } else {
                 SetLayeredWindowAttributes(m_windowHandle, 0, static_cast<BYTE>(m_opacity * 255), LWA_ALPHA);
             }
         }
         
+        RequestFrame();
+        
         Log(2, "Overlay visibility set to {}", visible ? "visible" : "hidden");
     }
 }
@@ -319,29 +454,13 @@ void OverlayWindow::SetOpacity(float opacity, bool animate) {
     if (m_opacity != opacity && m_windowHandle) {
         if (animate && m_animationManager) {
             // Create or update the opacity animation
-            auto opacityAnim = m_animationManager->CreateFloatAnimation(
-                "opacity",
-                300, // 300ms duration
-                m_opacity,
-                opacity,
-                [this](float value) {
-                    m_opacity = value;
-                    if (m_renderer) {
-                        m_renderer->SetOpacity(value, false);
-                    } else {
-                        // Fallback to basic layered window opacity
-                        SetLayeredWindowAttributes(m_windowHandle, 0, static_cast<BYTE>(value * 255), LWA_ALPHA);
-                    }
-                }
-            );
-            
-            // Start the animation
-            m_animationManager->StartAnimation("opacity");
+            AnimateOpacity(opacity, false);
         } else {
             m_opacity = opacity;
+            RequestFrame();
             
             if (m_renderer) {
-                m_renderer->SetOpacity(opacity, false);
+                m_renderer->SetOpacity(opacity);
             } else {
                 // Fallback to basic layered window opacity
                 SetLayeredWindowAttributes(m_windowHandle, 0, static_cast<BYTE>(opacity * 255), LWA_ALPHA);
@@ -366,8 +485,9 @@ void OverlayWindow::SetBounds(int x, int y, int width, int height, bool repaint)
         // Update renderer if available
         if (m_renderer) {
             m_renderer->Resize(width, height);
-            m_renderer->UpdatePosition(x, y);
+            m_renderer->SetPosition(x, y);
         }
+        RequestFrame();
     }
 }
 
@@ -379,6 +499,37 @@ void OverlayWindow::SetEventCallback(WindowEventCallback callback) {
     m_eventCallback = std::move(callback);
 }
 
+void OverlayWindow::SetScaleFactorCallback(ScaleFactorCallback callback) {
+    m_scaleFactorCallback = std::move(callback);
+}
+
+float OverlayWindow::GetScaleFactor() const {
+    return m_scaleFactor;
+}
+
+void OverlayWindow::UpdateMonitor() {
+    if (!m_windowHandle) {
+        return;
+    }
+    
+    MonitorInfo monitor = GetMonitorForWindow(m_windowHandle);
+    if (monitor.GetHandle() == m_monitor && monitor.GetScaleFactor() == m_scaleFactor) {
+        return;
+    }
+    
+    m_monitor = monitor.GetHandle();
+    
+    if (monitor.GetScaleFactor() != m_scaleFactor) {
+        m_scaleFactor = monitor.GetScaleFactor();
+        Log(2, "Overlay moved to a monitor with scale factor {}", m_scaleFactor);
+        
+        if (m_scaleFactorCallback) {
+            m_scaleFactorCallback(m_scaleFactor);
+        }
+        RequestFrame();
+    }
+}
+
 HWND OverlayWindow::GetHandle() const {
     return m_windowHandle;
 }
@@ -430,17 +581,84 @@ bool OverlayWindow::AlignWithGameWindow(HWND gameWindowHandle) {
 }
 
 void OverlayWindow::Update() {
-    // Update animations
-    if (m_animationManager) {
+    // Notice a lost device before anything draws on it
+    if (m_graphicsDevice) {
+        m_graphicsDevice->CheckDevice();
+        SyncAnimationsWithDevice();
+    }
+    
+    // Step animations only while any are running; the last step still renders.
+    // Composition animations need a call only once they are due to complete.
+    bool animating = m_animationManager && m_animationManager->HasActiveAnimations();
+    if (animating || (m_animationManager && m_animationManager->GetTimeToNextCompletion() == 0)) {
         m_animationManager->Update();
     }
     
-    // Update border highlight based on mouse position
-    UpdateBorderHighlight();
+    // Border highlight is driven by mouse messages, nothing to poll here
+    bool framePending = m_framePending.exchange(false);
     
-    // Render the overlay
-    if (m_renderer) {
+    // Content or panels changed shape since the last frame
+    if (m_hitRegionDirty) {
+        ApplyHitRegion();
+    }
+    
+    // Render the overlay only if something changed
+    if (m_renderer && (animating || framePending)) {
         m_renderer->Render();
+        SyncAnimationsWithDevice();
+    }
+}
+
+void OverlayWindow::RequestFrame() {
+    // Only the first request after a frame needs to wake the loop
+    if (!m_framePending.exchange(true) && m_windowHandle) {
+        PostMessageW(m_windowHandle, WM_REQUEST_FRAME, 0, 0);
+    }
+}
+
+bool OverlayWindow::IsFrameActive() const {
+    return m_framePending.load() ||
+           (m_animationManager && m_animationManager->HasActiveAnimations());
+}
+
+void OverlayWindow::WaitForNextFrame(DWORD idleTimeoutMs, std::span<const HANDLE> wakeHandles) {
+    DWORD handleCount = static_cast<DWORD>(wakeHandles.size());
+    
+    if (IsFrameActive()) {
+        // Pace active frames on the compositor's clock
+        if (!m_compositionEnabled || FAILED(DwmFlush())) {
+            MsgWaitForMultipleObjectsEx(handleCount, wakeHandles.data(), FALLBACK_FRAME_INTERVAL_MS,
+                QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        }
+        return;
+    }
+    
+    // Idle: sleep until input, a posted frame request, the timeout, or a
+    // composition animation completing (its callback runs from Update())
+    if (m_animationManager) {
+        idleTimeoutMs = (std::min)(idleTimeoutMs, m_animationManager->GetTimeToNextCompletion());
+    }
+    MsgWaitForMultipleObjectsEx(handleCount, wakeHandles.data(), idleTimeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+}
+
+void OverlayWindow::UpdateHitTestContent(const void* buffer, int width, int height, const std::vector<RECT>& dirtyRects) {
+    if (m_hitTestMask.Update(buffer, width, height, dirtyRects)) {
+        m_hitRegionDirty = true;
+        RequestFrame();
+    }
+}
+
+void OverlayWindow::UpdateHitTestContent(int width, int height) {
+    if (m_hitTestMask.Fill(width, height)) {
+        m_hitRegionDirty = true;
+        RequestFrame();
+    }
+}
+
+void OverlayWindow::SetHitTestRects(const std::vector<RECT>& rects) {
+    if (m_hitTestMask.SetRects(rects)) {
+        m_hitRegionDirty = true;
+        RequestFrame();
     }
 }
 
@@ -449,9 +667,8 @@ bool OverlayWindow::IsMouseNearEdge(int x, int y, int threshold) const {
         return false;
     }
     
-    RECT rect;
-    GetClientRect(m_windowHandle, &rect);
-    
+    // Cached on WM_SIZE; this runs for every hit test and mouse move
+    const RECT& rect = m_clientRect;
     return x <= threshold || y <= threshold || 
            x >= rect.right - threshold || y >= rect.bottom - threshold;
 }
@@ -503,27 +720,6 @@ bool OverlayWindow::InitializeComposition() {
     }
 }
 
-template<typename... Args>
-void OverlayWindow::Log(int level, const std::string& fmt, const Args&... args) {
-    try {
-        auto& logger = m_app.GetLogger();
-        
-        switch (level) {
-            case 0: logger.Trace(fmt, args...); break;
-            case 1: logger.Debug(fmt, args...); break;
-            case 2: logger.Info(fmt, args...); break;
-            case 3: logger.Warning(fmt, args...); break;
-            case 4: logger.Error(fmt, args...); break;
-            case 5: logger.Critical(fmt, args...); break;
-            default: logger.Info(fmt, args...); break;
-        }
-    }
-    catch (const std::exception& e) {
-        // Fallback to stderr if logger is unavailable
-        std::cerr << "OverlayWindow log error: " << e.what() << std::endl;
-    }
-}
-
 void OverlayWindow::ApplyOverlayStyles() {
     if (!m_windowHandle) {
         return;
@@ -555,86 +751,66 @@ void OverlayWindow::UpdateClickThrough() {
         return;
     }
 
+    // In interactive mode the window region decides which pixels take the mouse.
+    // Full click-through still needs WS_EX_TRANSPARENT: an empty region would
+    // also hide the content. The bit affects hit testing only, so no frame
+    // change (and no DWM frame recomputation) is needed.
     LONG exStyle = GetWindowLongW(m_windowHandle, GWL_EXSTYLE);
-    
-    if (m_mode == WindowMode::ClickThrough) {
-        // Enable click-through by adding WS_EX_TRANSPARENT
-        exStyle |= WS_EX_TRANSPARENT;
-    } else {
-        // Disable click-through by removing WS_EX_TRANSPARENT
-        exStyle &= ~WS_EX_TRANSPARENT;
+    LONG wanted = m_mode == WindowMode::ClickThrough ? (exStyle | WS_EX_TRANSPARENT) : (exStyle & ~WS_EX_TRANSPARENT);
+    if (wanted != exStyle) {
+        SetWindowLongW(m_windowHandle, GWL_EXSTYLE, wanted);
     }
-    
-    SetWindowLongW(m_windowHandle, GWL_EXSTYLE, exStyle);
-    
-    // Update window to apply the style change
-    SetWindowPos(m_windowHandle, nullptr, 0, 0, 0, 0, 
-                  SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
 }
 
-void OverlayWindow::UpdateBorderHighlight() {
-    if (!m_windowHandle || !m_renderer) {
+void OverlayWindow::ApplyHitRegion() {
+    m_hitRegionDirty = false;
+    if (!m_windowHandle) {
         return;
     }
     
-    // Get current mouse position
-    POINT pt;
-    GetCursorPos(&pt);
-    ScreenToClient(m_windowHandle, &pt);
+    const RECT& client = m_clientRect;
     
-    // Check if mouse is inside window client area
-    RECT rect;
-    GetClientRect(m_windowHandle, &rect);
-    bool mouseInWindow = PtInRect(&rect, pt);
+    // The edge strip stays hit-testable as the drag handle and hover area for the border
+    RECT edges[] = {
+        { client.left, client.top, client.right, client.top + EDGE_HANDLE_WIDTH },
+        { client.left, client.bottom - EDGE_HANDLE_WIDTH, client.right, client.bottom },
+        { client.left, client.top, client.left + EDGE_HANDLE_WIDTH, client.bottom },
+        { client.right - EDGE_HANDLE_WIDTH, client.top, client.right, client.bottom }
+    };
     
-    if (mouseInWindow) {
-        // Check if mouse is near the edge
-        bool nearEdge = IsMouseNearEdge(pt.x, pt.y);
-        
-        if (nearEdge != m_mouseNearEdge) {
-            m_mouseNearEdge = nearEdge;
-            
-            // Show/hide border based on mouse position
-            if (m_animationManager) {
-                auto borderAnim = m_animationManager->CreateFloatAnimation(
-                    "border",
-                    200, // 200ms duration
-                    nearEdge ? 0.0f : 1.0f, // Start value
-                    nearEdge ? 1.0f : 0.0f, // End value
-                    [this](float value) {
-                        if (m_renderer) {
-                            m_renderer->ShowBorders(value > 0.01f);
-                        }
-                    }
-                );
-                
-                m_animationManager->StartAnimation("border");
-            } else {
-                m_renderer->ShowBorders(nearEdge);
-            }
-        }
-    } else if (m_mouseNearEdge) {
-        // Mouse left window, hide borders
-        m_mouseNearEdge = false;
-        
-        if (m_animationManager) {
-            auto borderAnim = m_animationManager->CreateFloatAnimation(
-                "border",
-                200, // 200ms duration
-                1.0f, // Start value
-                0.0f, // End value
-                [this](float value) {
-                    if (m_renderer) {
-                        m_renderer->ShowBorders(value > 0.01f);
-                    }
-                }
-            );
-            
-            m_animationManager->StartAnimation("border");
-        } else {
-            m_renderer->ShowBorders(false);
-        }
+    HRGN region = m_hitTestMask.CreateRegion(edges);
+    if (!region) {
+        Log(3, "Failed to build the hit-test region");
+        return;
+    }
+    
+    // The system owns the region once SetWindowRgn succeeds
+    if (!SetWindowRgn(m_windowHandle, region, FALSE)) {
+        DeleteObject(region);
+        Log(3, "Failed to set the hit-test region (Error code: {})", GetLastError());
+    }
+}
+
+void OverlayWindow::UpdateBorderHighlight(bool nearEdge) {
+    if (nearEdge == m_mouseNearEdge || !m_renderer) {
+        return;
+    }
+    
+    m_mouseNearEdge = nearEdge;
+    AnimateBorders(nearEdge);
+}
+
+void OverlayWindow::TrackMouseLeave(bool nonClient) {
+    bool& tracking = nonClient ? m_ncMouseTracking : m_mouseTracking;
+    if (tracking) {
+        return;
     }
+    
+    TRACKMOUSEEVENT tme = {};
+    tme.cbSize = sizeof(TRACKMOUSEEVENT);
+    tme.dwFlags = nonClient ? (TME_LEAVE | TME_NONCLIENT) : TME_LEAVE;
+    tme.hwndTrack = m_windowHandle;
+    tracking = TrackMouseEvent(&tme) != FALSE;
 }
 
 LRESULT CALLBACK OverlayWindow::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
@@ -669,68 +845,96 @@ LRESULT CALLBACK OverlayWindow::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam,
             return 0;
             
         case WM_NCHITTEST:
-            // Make the entire window draggable
+            // Only the window region gets here; its edge strip drags the window,
+            // the content and panels take clicks themselves
+            if (window) {
+                POINT pt = { GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
+                ScreenToClient(hwnd, &pt);
+                return window->IsMouseNearEdge(pt.x, pt.y, EDGE_HANDLE_WIDTH) ? HTCAPTION : HTCLIENT;
+            }
             return HTCAPTION;
             
         case WM_MOUSEMOVE:
             if (window) {
-                // Track mouse position for border highlighting
                 window->m_lastMousePos.x = GET_X_LPARAM(lParam);
                 window->m_lastMousePos.y = GET_Y_LPARAM(lParam);
                 
-                // Trigger border update
-                if (!window->m_mouseTracking) {
-                    TRACKMOUSEEVENT tme = {};
-                    tme.cbSize = sizeof(TRACKMOUSEEVENT);
-                    tme.dwFlags = TME_LEAVE | TME_HOVER;
-                    tme.hwndTrack = hwnd;
-                    tme.dwHoverTime = HOVER_DEFAULT;
-                    window->m_mouseTracking = TrackMouseEvent(&tme) != FALSE;
-                }
+                window->TrackMouseLeave(false);
+                window->UpdateBorderHighlight(window->IsMouseNearEdge(window->m_lastMousePos.x, window->m_lastMousePos.y));
+            }
+            break;
+            
+        case WM_NCMOUSEMOVE:
+            // The edge strip is HTCAPTION, so moves over it arrive here in screen coordinates
+            if (window) {
+                POINT pt = { GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
+                ScreenToClient(hwnd, &pt);
+                window->m_lastMousePos = pt;
+                
+                window->TrackMouseLeave(true);
+                window->UpdateBorderHighlight(window->IsMouseNearEdge(pt.x, pt.y));
             }
             break;
             
         case WM_MOUSELEAVE:
+            // Also sent when moving onto the edge strip; the WM_NCMOUSEMOVE that
+            // follows retargets the fade straight back
             if (window) {
                 window->m_mouseTracking = false;
-                
-                // Mouse left window, hide borders
-                if (window->m_mouseNearEdge && window->m_renderer) {
-                    window->m_mouseNearEdge = false;
-                    
-                    if (window->m_animationManager) {
-                        auto borderAnim = window->m_animationManager->CreateFloatAnimation(
-                            "border",
-                            200, // 200ms duration
-                            1.0f, // Start value
-                            0.0f, // End value
-                            [window](float value) {
-                                if (window->m_renderer) {
-                                    window->m_renderer->ShowBorders(value > 0.01f);
-                                }
-                            }
-                        );
-                        
-                        window->m_animationManager->StartAnimation("border");
-                    } else {
-                        window->m_renderer->ShowBorders(false);
-                    }
-                }
+                window->UpdateBorderHighlight(false);
+            }
+            break;
+            
+        case WM_NCMOUSELEAVE:
+            if (window) {
+                window->m_ncMouseTracking = false;
+                window->UpdateBorderHighlight(false);
+            }
+            break;
+            
+        case WM_REQUEST_FRAME:
+            // Only wakes the frame loop; the pending flag is already set
+            return 0;
+            
+        case WM_DISPLAYCHANGE:
+            // Monitors were added, removed or changed resolution
+            RefreshMonitorTopology();
+            if (window) {
+                window->UpdateMonitor();
             }
             break;
             
-        case WM_TIMER:
-            if (window && wParam == 1) {
-                // Timer for checking mouse position
-                window->UpdateBorderHighlight();
+        case WM_DPICHANGED:
+            RefreshMonitorTopology();
+            if (window) {
+                // Take the suggested rect so the overlay keeps its physical size;
+                // the resulting WM_SIZE resizes the content surface to native resolution
+                const RECT* suggested = reinterpret_cast<const RECT*>(lParam);
+                SetWindowPos(hwnd, nullptr, suggested->left, suggested->top,
+                    suggested->right - suggested->left, suggested->bottom - suggested->top,
+                    SWP_NOZORDER | SWP_NOACTIVATE);
+                window->UpdateMonitor();
+            }
+            return 0;
+            
+        case WM_MOVE:
+            // Cheap when the monitor is unchanged: no enumeration, no reallocation
+            if (window) {
+                window->UpdateMonitor();
             }
             break;
             
         case WM_SIZE:
-            if (window && window->m_renderer) {
+            if (window) {
                 UINT width = LOWORD(lParam);
                 UINT height = HIWORD(lParam);
-                window->m_renderer->Resize(width, height);
+                SetRect(&window->m_clientRect, 0, 0, static_cast<int>(width), static_cast<int>(height));
+                window->m_hitRegionDirty = true;
+                
+                if (window->m_renderer) {
+                    window->m_renderer->Resize(width, height);
+                    window->RequestFrame();
+                }
             }
             break;
     }
@@ -6,13 +6,25 @@
  #include "window/window_manager.h"
  #include <algorithm>
  #include <chrono>
- #include <thread>
  #include "core/Logger.h"
  #include "core/ErrorHandler.h"
  #include "core/EventSystem.h"
  
  namespace poe {
  
+ namespace {
+ 
+ /// How often an idle loop wakes to look for (or validate) the game window
+ constexpr DWORD GAME_CHECK_INTERVAL_MS = 1000;
+ 
+ /// Poll interval for following the game window when its hook is unavailable
+ constexpr DWORD GAME_POLL_INTERVAL_MS = 10;
+ 
+ /// Manager that installed the game window hook on this thread
+ thread_local WindowManager* t_hookedManager = nullptr;
+ 
+ } // namespace
+ 
  WindowManager::WindowManager(
      Application& app,
      const WindowManagerConfig& config,
@@ -21,12 +33,20 @@
        m_config(config),
        m_overlayWindow(app, windowConfig) {
      
+     // Lets the message wait in Run() wake up for published events
+     m_eventsQueued = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+     
      m_app.GetLogger().Info("WindowManager created");
  }
  
  WindowManager::~WindowManager() {
      m_running = false;
      DetachFromGame();
+     
+     if (m_eventsQueued) {
+         m_app.GetEventSystem().SetWakeHandler(nullptr);
+         CloseHandle(m_eventsQueued);
+     }
  }
  
  bool WindowManager::Initialize() {
@@ -68,6 +88,13 @@
  int WindowManager::Run() {
      m_running = true;
  
+     EventSystem& events = m_app.GetEventSystem();
+     if (m_eventsQueued) {
+         HANDLE eventsQueued = m_eventsQueued;
+         events.SetWakeHandler([eventsQueued]() { SetEvent(eventsQueued); });
+     }
+     m_nextGameSearch = std::chrono::steady_clock::now();
+ 
      // Main message loop
      while (m_running) {
          // Process window messages
@@ -75,6 +102,11 @@
              break;  // Exit loop if ProcessMessages returns false (WM_QUIT)
          }
  
+         // Dispatch events published since the last pass, e.g. hotkeys from the input thread
+         events.ProcessEvents();
+ 
+         DWORD idleTimeoutMs = GAME_CHECK_INTERVAL_MS;
+ 
          // Check game window status and update overlay position if needed
          if (m_gameWindowHandle) {
              if (!IsGameWindowValid()) {
@@ -84,30 +116,46 @@
                  } else {
                      DetachFromGame();  // Just detach from the game
                  }
-             } else if (m_config.followGameWindow) {
+             } else if (m_config.followGameWindow && (m_gameWindowMoved || !m_gameWindowHook)) {
+                 m_gameWindowMoved = false;
                  UpdateOverlayPosition();
              }
          } else if (m_config.autoAttachToGame) {
-             // Try to find the game window periodically
-             static auto lastCheck = std::chrono::steady_clock::now();
-             auto now = std::chrono::steady_clock::now();
-             
-             if (now - lastCheck > std::chrono::seconds(1)) {
-                 HWND gameWindow = FindGameWindow();
-                 if (gameWindow) {
-                     AttachToGame(gameWindow);
-                 }
-                 lastCheck = now;
-             }
+             // Nothing signals the game window appearing; look for it on a schedule
+             idleTimeoutMs = SearchForGameWindow();
          }
  
-         // Yield to other threads to avoid high CPU usage
-         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+         // Step animations and render only if something changed
+         m_overlayWindow.Update();
+ 
+         // Sleep until input, a frame request, CEF work, a game window event or a
+         // published event; without the hook, fall back to polling the game window position
+         bool pollGameWindow = m_gameWindowHandle && m_config.followGameWindow && !m_gameWindowHook;
+         HANDLE wakeHandles[] = { m_eventsQueued };
+         m_overlayWindow.WaitForNextFrame(pollGameWindow ? GAME_POLL_INTERVAL_MS : idleTimeoutMs,
+             std::span<const HANDLE>(wakeHandles, m_eventsQueued ? 1 : 0));
      }
  
+     events.SetWakeHandler(nullptr);
      return 0;
  }
  
+ DWORD WindowManager::SearchForGameWindow() {
+     auto now = std::chrono::steady_clock::now();
+     if (now >= m_nextGameSearch) {
+         HWND gameWindow = FindGameWindow();
+         if (gameWindow) {
+             AttachToGame(gameWindow);
+             return GAME_CHECK_INTERVAL_MS;
+         }
+         m_nextGameSearch = now + std::chrono::milliseconds(GAME_CHECK_INTERVAL_MS);
+     }
+ 
+     // Round up so the wait does not end just short of the deadline
+     auto remaining = std::chrono::ceil<std::chrono::milliseconds>(m_nextGameSearch - now);
+     return static_cast<DWORD>(remaining.count());
+ }
+ 
  HWND WindowManager::FindGameWindow() const {
      // Find window by class name and/or title
      return FindWindowW(
@@ -131,6 +179,21 @@
      m_app.GetLogger().Info("Attached to game window: '{}'", 
                             std::string(windowTitle, windowTitle + wcslen(windowTitle)));
      
+     // Get notified when the game window moves, resizes or closes
+     if (m_gameWindowHook) {
+         UnhookWinEvent(m_gameWindowHook);
+     }
+     DWORD processId = 0;
+     DWORD threadId = GetWindowThreadProcessId(gameWindowHandle, &processId);
+     t_hookedManager = this;
+     m_gameWindowHook = SetWinEventHook(
+         EVENT_OBJECT_DESTROY, EVENT_OBJECT_LOCATIONCHANGE,
+         nullptr, &WindowManager::GameWindowEventProc,
+         processId, threadId, WINEVENT_OUTOFCONTEXT);
+     if (!m_gameWindowHook) {
+         m_app.GetLogger().Warning("Failed to hook game window events, polling its position instead");
+     }
+     
      // Align the overlay with the game window
      UpdateOverlayPosition();
      
@@ -138,7 +201,32 @@
  }
  
  void WindowManager::DetachFromGame() {
+     if (m_gameWindowHook) {
+         UnhookWinEvent(m_gameWindowHook);
+         m_gameWindowHook = nullptr;
+     }
      m_gameWindowHandle = nullptr;
+     m_gameWindowMoved = false;
+ }
+ 
+ void CALLBACK WindowManager::GameWindowEventProc(
+     HWINEVENTHOOK hook,
+     DWORD event,
+     HWND hwnd,
+     LONG idObject,
+     LONG idChild,
+     DWORD eventThread,
+     DWORD eventTime) {
+     WindowManager* manager = t_hookedManager;
+     if (!manager || hwnd != manager->m_gameWindowHandle ||
+         idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+         return;
+     }
+ 
+     // Destruction is picked up by the validity check on this same wake-up
+     if (event == EVENT_OBJECT_LOCATIONCHANGE) {
+         manager->m_gameWindowMoved = true;
+     }
  }
  
  bool WindowManager::IsAttachedToGame() const {